@@ -10,6 +10,7 @@ SPDX-License-Identifier: GPL-3.0-or-later
 #cmakedefine01 ENABLE_LARGEFILE
 #cmakedefine01 ENABLE_ZSTD
 #cmakedefine01 ENABLE_CJSON
+#cmakedefine01 ENABLE_PCRE2
 #cmakedefine01 ENABLE_ALIAS
 #cmakedefine01 ENABLE_BUFLIST
 #cmakedefine01 ENABLE_CHARSET
@@ -50,6 +51,9 @@ SPDX-License-Identifier: GPL-3.0-or-later
 #cmakedefine HAVE_MALLOC_H
 #cmakedefine HAVE_MALLOC_TRIM
 #cmakedefine HAVE_HTONLL
+#cmakedefine HAVE_CLOCK_MONOTONIC
+#cmakedefine HAVE_EPOLL
+#cmakedefine HAVE_POSIX_SPAWN
 #cmakedefine HAVE_EAT_NEWLINE_GLITCH
 #cmakedefine HAVE_ASPELL_VERSION_STRING
 #cmakedefine HAVE_GUILE_GMP_MEMORY_FUNCTIONS
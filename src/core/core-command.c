@@ -2083,6 +2083,12 @@ COMMAND_CALLBACK(debug)
         return WEECHAT_RC_OK;
     }
 
+    if (string_strcmp (argv[1], "config") == 0)
+    {
+        debug_config_files ();
+        return WEECHAT_RC_OK;
+    }
+
     if (string_strcmp (argv[1], "cursor") == 0)
     {
         if (gui_cursor_debug)
@@ -2126,7 +2132,43 @@ COMMAND_CALLBACK(debug)
 
     if (string_strcmp (argv[1], "hooks") == 0)
     {
-        if (argc > 2)
+        if ((argc > 2) && (string_strcmp (argv[2], "profile") == 0))
+        {
+            if (argc > 3)
+            {
+                if (string_strcmp (argv[3], "enable") == 0)
+                {
+                    hook_profile_enabled = 1;
+                    gui_chat_printf (NULL,
+                                     _("Profiling of hooks enabled"));
+                    return WEECHAT_RC_OK;
+                }
+                if (string_strcmp (argv[3], "disable") == 0)
+                {
+                    hook_profile_enabled = 0;
+                    hook_profile_reset ();
+                    gui_chat_printf (NULL,
+                                     _("Profiling of hooks disabled"));
+                    return WEECHAT_RC_OK;
+                }
+                if (string_strcmp (argv[3], "reset") == 0)
+                {
+                    hook_profile_reset ();
+                    gui_chat_printf (NULL,
+                                     _("Profiling data of hooks reset"));
+                    return WEECHAT_RC_OK;
+                }
+                if ((string_strcmp (argv[3], "calls") != 0)
+                    && (string_strcmp (argv[3], "total") != 0)
+                    && (string_strcmp (argv[3], "avg") != 0)
+                    && (string_strcmp (argv[3], "max") != 0))
+                {
+                    COMMAND_ERROR;
+                }
+            }
+            debug_hooks_profile ((argc > 3) ? argv[3] : NULL);
+        }
+        else if (argc > 2)
         {
             debug_hooks_plugin_types (
                 argv[2],
@@ -2159,6 +2201,58 @@ COMMAND_CALLBACK(debug)
         return WEECHAT_RC_OK;
     }
 
+    if (string_strcmp (argv[1], "loop") == 0)
+    {
+        if (argc > 2)
+        {
+            if (string_strcmp (argv[2], "enable") == 0)
+            {
+                debug_loop_enabled = 1;
+                gui_chat_printf (NULL, _("Debug enabled for main loop"));
+                return WEECHAT_RC_OK;
+            }
+            if (string_strcmp (argv[2], "disable") == 0)
+            {
+                debug_loop_enabled = 0;
+                gui_chat_printf (NULL, _("Debug disabled for main loop"));
+                return WEECHAT_RC_OK;
+            }
+            if (string_strcmp (argv[2], "reset") == 0)
+            {
+                debug_loop_reset ();
+                gui_chat_printf (NULL, _("Main loop stats reset"));
+                return WEECHAT_RC_OK;
+            }
+            if (string_strcmp (argv[2], "stall") == 0)
+            {
+                COMMAND_MIN_ARGS(4, "loop stall");
+                if (!util_parse_delay (argv[3], 1, &threshold))
+                    COMMAND_ERROR;
+                if (threshold > 0)
+                {
+                    str_threshold = util_get_microseconds_string (threshold);
+                    debug_loop_stall = threshold;
+                    gui_chat_printf (
+                        NULL,
+                        _("Debug enabled for main loop stalls "
+                          "(threshold: %s)"),
+                        (str_threshold) ? str_threshold : "?");
+                    free (str_threshold);
+                }
+                else
+                {
+                    debug_loop_stall = 0;
+                    gui_chat_printf (NULL,
+                                     _("Debug disabled for main loop stalls"));
+                }
+                return WEECHAT_RC_OK;
+            }
+            COMMAND_ERROR;
+        }
+        debug_loop_display ();
+        return WEECHAT_RC_OK;
+    }
+
     if (string_strcmp (argv[1], "memory") == 0)
     {
         debug_memory ();
@@ -8908,9 +9002,12 @@ command_init (void)
            " || set <plugin> <level>"
            " || dump [<plugin>]"
            " || hooks [<plugin_mask> [<hook_type>...]]"
-           " || buffer|certs|color|dirs|infolists|key|libs|memory|tags|"
+           " || hooks profile [enable|disable|reset|calls|total|avg|max]"
+           " || buffer|certs|color|config|dirs|infolists|key|libs|memory|tags|"
            "term|url|windows"
            " || callbacks <duration>[<unit>]"
+           " || loop [enable|disable|reset]"
+           " || loop stall <duration>[<unit>]"
            " || mouse|cursor [verbose]"
            " || hdata [free]"
            " || time <command>"
@@ -8927,6 +9024,14 @@ command_init (void)
                "detailed info about hooks created by the plugin)"),
             N_("plugin_mask: plugin mask, \"*\" for all plugins"),
             N_("hook_type: hook type"),
+            N_("raw[profile]: display time spent in hook callbacks, sorted by "
+               "total time (default) or the given key (calls, total, avg, "
+               "max); the histogram counts the last 16 calls taking less than "
+               "1ms, 10ms, 100ms and more:"),
+            N_("> raw[enable]: enable profiling of hook callbacks"),
+            N_("> raw[disable]: disable profiling of hook callbacks and free "
+               "profiling data"),
+            N_("> raw[reset]: reset (free) profiling data of all hooks"),
             N_("raw[buffer]: dump buffer content with hexadecimal values in WeeChat "
                "log file"),
             N_("raw[callbacks]: write hook and bar item callbacks that took more than "
@@ -8939,6 +9044,8 @@ command_init (void)
             N_("> raw[h]: hours"),
             N_("raw[certs]: display number of loaded trusted certificate authorities"),
             N_("raw[color]: display infos about current color pairs"),
+            N_("raw[config]: display number of lines, size and time of last "
+               "read of configuration files"),
             N_("raw[cursor]: toggle debug for cursor mode"),
             N_("raw[dirs]: display directories"),
             N_("raw[hdata]: display infos about hdata (with free: remove all hdata "
@@ -8947,6 +9054,18 @@ command_init (void)
             N_("raw[key]: enable keyboard and mouse debug: display raw codes, "
                "expanded key name and associated command (\"q\" to quit this mode)"),
             N_("raw[libs]: display infos about external libraries used"),
+            N_("raw[loop]: display time spent in each phase of main loop "
+               "(timers, refresh of screen, fd hooks, processes, signals, "
+               "wait for activity on fd), with an histogram, and lateness of "
+               "timers:"),
+            N_("> raw[enable]: enable stats of main loop"),
+            N_("> raw[disable]: disable stats of main loop"),
+            N_("> raw[reset]: reset stats of main loop"),
+            N_("> raw[stall]: write in WeeChat log file the iterations of main "
+               "loop that took more than \"duration\" (time waiting for "
+               "activity on fd is ignored), with the slowest hook callback "
+               "(0 = disable), optional unit is the same as for "
+               "raw[callbacks]"),
             N_("raw[memory]: display infos about memory usage"),
             N_("raw[mouse]: toggle debug for mouse"),
             N_("raw[tags]: display tags for lines"),
@@ -8966,6 +9085,9 @@ command_init (void)
             AI("  /debug mouse verbose"),
             AI("  /debug time /filter toggle"),
             AI("  /debug hooks * process connect url"),
+            AI("  /debug hooks profile enable"),
+            AI("  /debug hooks profile max"),
+            AI("  /debug loop stall 100ms"),
             AI("  /debug unicode ${chars:${\\u26C0}-${\\u26CF}}")),
         "list"
         " || set %(plugins_names)|" PLUGIN_CORE
@@ -8974,13 +9096,16 @@ command_init (void)
         " || callbacks"
         " || certs"
         " || color"
+        " || config"
         " || cursor verbose"
         " || dirs"
         " || hdata free"
-        " || hooks %(plugins_names)|" PLUGIN_CORE " %(hook_types)|%*"
+        " || hooks profile|%(plugins_names)|" PLUGIN_CORE
+        " enable|disable|reset|calls|total|avg|max|%(hook_types)|%*"
         " || infolists"
         " || key"
         " || libs"
+        " || loop enable|disable|reset|stall"
         " || memory"
         " || mouse verbose"
         " || tags"
@@ -32,7 +32,9 @@
 #include <unistd.h>
 #include <stdarg.h>
 #include <string.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <errno.h>
 
 #include "weechat.h"
@@ -46,6 +48,7 @@
 #include "core-infolist.h"
 #include "core-log.h"
 #include "core-string.h"
+#include "core-utf8.h"
 #include "core-util.h"
 #include "core-version.h"
 #include "../gui/gui-color.h"
@@ -56,6 +59,11 @@
 struct t_config_file *config_files = NULL;
 struct t_config_file *last_config_file = NULL;
 
+/* section being written by a write callback (to check what is written) */
+struct t_config_section *config_file_write_section = NULL;
+int config_file_write_section_options = 0;
+int config_file_write_section_others = 0;
+
 char *config_option_type_string[CONFIG_NUM_OPTION_TYPES] =
 { N_("boolean"), N_("integer"), N_("string"), N_("color"), N_("enum") };
 char *config_boolean_true[] = { "on", "yes", "y", "true", "t", "1", NULL };
@@ -243,6 +251,27 @@ config_file_new (struct t_weechat_plugin *plugin, const char *name,
         new_config_file->callback_reload_data = callback_reload_data;
         new_config_file->sections = NULL;
         new_config_file->last_section = NULL;
+        new_config_file->hash_sections = hashtable_new (
+            32,
+            WEECHAT_HASHTABLE_STRING,
+            WEECHAT_HASHTABLE_POINTER,
+            NULL, NULL);
+        if (!new_config_file->hash_sections)
+        {
+            free (new_config_file->name);
+            free (new_config_file->filename);
+            free (new_config_file);
+            return NULL;
+        }
+        new_config_file->generation = 0;
+        new_config_file->generation_written = -1;
+        new_config_file->written_inode = 0;
+        new_config_file->written_size = 0;
+        new_config_file->written_mtime = 0;
+        new_config_file->read_count = 0;
+        new_config_file->read_lines = 0;
+        new_config_file->read_size = 0;
+        new_config_file->read_time = 0;
 
         config_file_config_insert (new_config_file);
     }
@@ -274,6 +303,7 @@ config_file_set_version (struct t_config_file *config_file,
         return 0;
 
     config_file->version = version;
+    config_file->generation++;
 
     config_file->callback_update = callback_update;
     config_file->callback_update_pointer = callback_update_pointer;
@@ -427,6 +457,17 @@ config_file_new_section (struct t_config_file *config_file, const char *name,
             free (new_section);
             return NULL;
         }
+        new_section->hash_options = hashtable_new (
+            32,
+            WEECHAT_HASHTABLE_STRING,
+            WEECHAT_HASHTABLE_POINTER,
+            NULL, NULL);
+        if (!new_section->hash_options)
+        {
+            free (new_section->name);
+            free (new_section);
+            return NULL;
+        }
         new_section->user_can_add_options = user_can_add_options;
         new_section->user_can_delete_options = user_can_delete_options;
         new_section->callback_read = callback_read;
@@ -446,6 +487,8 @@ config_file_new_section (struct t_config_file *config_file, const char *name,
         new_section->callback_delete_option_data = callback_delete_option_data;
         new_section->options = NULL;
         new_section->last_option = NULL;
+        new_section->generation = 0;
+        new_section->generation_written = -1;
 
         new_section->prev_section = config_file->last_section;
         new_section->next_section = NULL;
@@ -454,6 +497,10 @@ config_file_new_section (struct t_config_file *config_file, const char *name,
         else
             config_file->sections = new_section;
         config_file->last_section = new_section;
+
+        hashtable_set (config_file->hash_sections, new_section->name,
+                       new_section);
+        config_file->generation++;
     }
 
     return new_section;
@@ -469,20 +516,10 @@ struct t_config_section *
 config_file_search_section (struct t_config_file *config_file,
                             const char *name)
 {
-    struct t_config_section *ptr_section;
-
     if (!config_file || !name)
         return NULL;
 
-    for (ptr_section = config_file->sections; ptr_section;
-         ptr_section = ptr_section->next_section)
-    {
-        if (strcmp (ptr_section->name, name) == 0)
-            return ptr_section;
-    }
-
-    /* section not found */
-    return NULL;
+    return hashtable_get (config_file->hash_sections, name);
 }
 
 /*
@@ -508,6 +545,18 @@ config_file_option_full_name (struct t_config_option *option)
     return option_full_name;
 }
 
+/*
+ * Mark the section of an option as changed (added, modified or removed
+ * option), so that the configuration file is written on next save.
+ */
+
+void
+config_file_option_changed (struct t_config_option *option)
+{
+    if (option && option->section)
+        (option->section)->generation++;
+}
+
 /*
  * Execute hook_config for modified option.
  */
@@ -627,6 +676,8 @@ config_file_option_insert_in_section (struct t_config_option *option)
         (option->section)->options = option;
         (option->section)->last_option = option;
     }
+
+    hashtable_set ((option->section)->hash_options, option->name, option);
 }
 
 /*
@@ -980,6 +1031,7 @@ config_file_new_option (struct t_config_file *config_file,
             new_option->next_option = NULL;
         }
 
+        config_file_option_changed (new_option);
         config_file_hook_config_exec (new_option);
     }
 
@@ -1013,37 +1065,22 @@ config_file_search_option (struct t_config_file *config_file,
 {
     struct t_config_section *ptr_section;
     struct t_config_option *ptr_option;
-    int rc;
 
     if (!option_name)
         return NULL;
 
     if (section)
-    {
-        for (ptr_option = section->last_option; ptr_option;
-             ptr_option = ptr_option->prev_option)
-        {
-            rc = strcmp (ptr_option->name, option_name);
-            if (rc == 0)
-                return ptr_option;
-            else if (rc < 0)
-                break;
-        }
-    }
-    else if (config_file)
+        return hashtable_get (section->hash_options, option_name);
+
+    if (config_file)
     {
         for (ptr_section = config_file->sections; ptr_section;
              ptr_section = ptr_section->next_section)
         {
-            for (ptr_option = ptr_section->last_option; ptr_option;
-                 ptr_option = ptr_option->prev_option)
-            {
-                rc = strcmp (ptr_option->name, option_name);
-                if (rc == 0)
-                    return ptr_option;
-                else if (rc < 0)
-                    break;
-            }
+            ptr_option = hashtable_get (ptr_section->hash_options,
+                                        option_name);
+            if (ptr_option)
+                return ptr_option;
         }
     }
 
@@ -1067,7 +1104,6 @@ config_file_search_section_option (struct t_config_file *config_file,
 {
     struct t_config_section *ptr_section;
     struct t_config_option *ptr_option;
-    int rc;
 
     *section_found = NULL;
     *option_found = NULL;
@@ -1077,18 +1113,11 @@ config_file_search_section_option (struct t_config_file *config_file,
 
     if (section)
     {
-        for (ptr_option = section->last_option; ptr_option;
-             ptr_option = ptr_option->prev_option)
+        ptr_option = hashtable_get (section->hash_options, option_name);
+        if (ptr_option)
         {
-            rc = strcmp (ptr_option->name, option_name);
-            if (rc == 0)
-            {
-                *section_found = section;
-                *option_found = ptr_option;
-                return;
-            }
-            else if (rc < 0)
-                break;
+            *section_found = section;
+            *option_found = ptr_option;
         }
     }
     else if (config_file)
@@ -1096,18 +1125,13 @@ config_file_search_section_option (struct t_config_file *config_file,
         for (ptr_section = config_file->sections; ptr_section;
              ptr_section = ptr_section->next_section)
         {
-            for (ptr_option = ptr_section->last_option; ptr_option;
-                 ptr_option = ptr_option->prev_option)
+            ptr_option = hashtable_get (ptr_section->hash_options,
+                                        option_name);
+            if (ptr_option)
             {
-                rc = strcmp (ptr_option->name, option_name);
-                if (rc == 0)
-                {
-                    *section_found = ptr_section;
-                    *option_found = ptr_option;
-                    return;
-                }
-                else if (rc < 0)
-                    break;
+                *section_found = ptr_section;
+                *option_found = ptr_option;
+                return;
             }
         }
     }
@@ -1410,6 +1434,7 @@ config_file_option_reset (struct t_config_option *option, int run_callback)
                 option->callback_change_data,
                 option);
         }
+        config_file_option_changed (option);
         config_file_hook_config_exec (option);
     }
 
@@ -1716,6 +1741,7 @@ config_file_option_set (struct t_config_option *option, const char *value,
                 option->callback_change_data,
                 option);
         }
+        config_file_option_changed (option);
         config_file_hook_config_exec (option);
     }
 
@@ -1873,6 +1899,7 @@ config_file_option_set_null (struct t_config_option *option, int run_callback)
                 option->callback_change_data,
                 option);
         }
+        config_file_option_changed (option);
         config_file_hook_config_exec (option);
     }
 
@@ -2168,6 +2195,7 @@ config_file_option_set_default (struct t_config_option *option,
                 option->callback_change_data,
                 option);
         }
+        config_file_option_changed (option);
         config_file_hook_config_exec (option);
     }
 
@@ -2282,6 +2310,7 @@ config_file_option_rename (struct t_config_option *option,
                 (option->section)->options = option->next_option;
             if (option->section->last_option == option)
                 (option->section)->last_option = option->prev_option;
+            hashtable_remove ((option->section)->hash_options, option->name);
         }
 
         /* rename option */
@@ -2321,6 +2350,7 @@ config_file_option_rename (struct t_config_option *option,
     free (full_old_name);
     free (full_new_name);
 
+    config_file_option_changed (option);
     config_file_hook_config_exec (option);
 }
 
@@ -3037,6 +3067,14 @@ config_file_write_option (struct t_config_file *config_file,
     if (!config_file || !config_file->file || !option)
         return 0;
 
+    if (config_file_write_section)
+    {
+        if (option->section == config_file_write_section)
+            config_file_write_section_options++;
+        else
+            config_file_write_section_others++;
+    }
+
     rc = 1;
 
     if (option->value)
@@ -3107,6 +3145,13 @@ config_file_write_line (struct t_config_file *config_file,
     if (!config_file || !option_name)
         return 0;
 
+    if (config_file_write_section
+        && ((value && value[0])
+            || (strcmp (option_name, config_file_write_section->name) != 0)))
+    {
+        config_file_write_section_others++;
+    }
+
     if (value && value[0])
     {
         weechat_va_format (value);
@@ -3128,6 +3173,122 @@ config_file_write_line (struct t_config_file *config_file,
                             option_name));
 }
 
+/*
+ * Call the write callback of a section.
+ *
+ * Lines written by the callback are checked: if the callback writes only the
+ * options of the section (like the default write does), the section is
+ * marked as written, otherwise the section is always considered as changed
+ * (its content does not come from options only).
+ *
+ * Return:
+ *   WEECHAT_CONFIG_WRITE_OK: OK
+ *   WEECHAT_CONFIG_WRITE_ERROR: error
+ *   WEECHAT_CONFIG_WRITE_MEMORY_ERROR: not enough memory
+ */
+
+int
+config_file_write_section_cb (struct t_config_file *config_file,
+                              struct t_config_section *section,
+                              int default_options)
+{
+    int rc;
+
+    config_file_write_section = section;
+    config_file_write_section_options = 0;
+    config_file_write_section_others = 0;
+
+    if (default_options)
+    {
+        rc = (section->callback_write_default) (
+            section->callback_write_default_pointer,
+            section->callback_write_default_data,
+            config_file,
+            section->name);
+    }
+    else
+    {
+        rc = (section->callback_write) (
+            section->callback_write_pointer,
+            section->callback_write_data,
+            config_file,
+            section->name);
+    }
+
+    section->generation_written =
+        ((config_file_write_section_others == 0)
+         && (config_file_write_section_options
+             == section->hash_options->items_count)) ?
+        section->generation : -1;
+
+    config_file_write_section = NULL;
+
+    return rc;
+}
+
+/*
+ * Check if a configuration file must be written: if a section or an option
+ * has changed since last write, or if the file on disk has changed.
+ *
+ * Return:
+ *   1: file must be written
+ *   0: file is unchanged (no need to write it)
+ */
+
+int
+config_file_need_write (struct t_config_file *config_file,
+                        const char *filename)
+{
+    struct t_config_section *ptr_section;
+    struct stat st;
+
+    if (config_file->generation != config_file->generation_written)
+        return 1;
+
+    for (ptr_section = config_file->sections; ptr_section;
+         ptr_section = ptr_section->next_section)
+    {
+        if ((ptr_section->generation_written < 0)
+            || (ptr_section->generation != ptr_section->generation_written))
+        {
+            return 1;
+        }
+    }
+
+    if ((stat (filename, &st) != 0)
+        || (st.st_ino != config_file->written_inode)
+        || (st.st_size != config_file->written_size)
+        || (st.st_mtime != config_file->written_mtime))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Mark a configuration file as written: the generation and the file on disk
+ * are saved, to skip next write if nothing changes.
+ */
+
+void
+config_file_set_written (struct t_config_file *config_file,
+                         const char *filename)
+{
+    struct stat st;
+
+    if (stat (filename, &st) != 0)
+    {
+        config_file->generation_written = -1;
+        return;
+    }
+
+    config_file->generation_written = config_file->generation;
+    config_file->written_inode = st.st_ino;
+    config_file->written_size = st.st_size;
+    config_file->written_mtime = st.st_mtime;
+}
+
 /*
  * Write a configuration file (this function must not be called directly).
  *
@@ -3143,13 +3304,15 @@ config_file_write_internal (struct t_config_file *config_file,
 {
     int rc;
     long file_perms;
-    char *filename, *filename2, resolved_path[PATH_MAX];
+    char *filename, *filename2, resolved_path[PATH_MAX], *buffer;
     struct t_config_section *ptr_section;
     struct t_config_option *ptr_option;
 
     if (!config_file)
         return WEECHAT_CONFIG_WRITE_ERROR;
 
+    buffer = NULL;
+
     /* build filename */
     if (string_asprintf (&filename,
                          "%s%s%s",
@@ -3185,6 +3348,17 @@ config_file_write_internal (struct t_config_file *config_file,
         }
     }
 
+    /* nothing has changed since last write: don't write the file again */
+    if (!default_options && !config_file_need_write (config_file, filename))
+    {
+        free (filename);
+        free (filename2);
+        return WEECHAT_CONFIG_WRITE_OK;
+    }
+
+    /* the file is marked as written only if this write succeeds */
+    config_file->generation_written = -1;
+
     log_printf (_("Writing configuration file %s%s%s"),
                 config_file->filename,
                 (default_options) ? " " : "",
@@ -3201,6 +3375,14 @@ config_file_write_internal (struct t_config_file *config_file,
         goto error;
     }
 
+    /* use a large buffer, so that the file is written with few system calls */
+    buffer = malloc (CONFIG_FILE_WRITE_BUFFER_SIZE);
+    if (buffer)
+    {
+        setvbuf (config_file->file, buffer, _IOFBF,
+                 CONFIG_FILE_WRITE_BUFFER_SIZE);
+    }
+
     /* write header with name of config file and WeeChat version */
     if (!string_fprintf (
             config_file->file,
@@ -3236,22 +3418,13 @@ config_file_write_internal (struct t_config_file *config_file,
          ptr_section = ptr_section->next_section)
     {
         /* call write callback if defined for section */
-        if (default_options && ptr_section->callback_write_default)
+        if ((default_options && ptr_section->callback_write_default)
+            || (!default_options && ptr_section->callback_write))
         {
-            if ((ptr_section->callback_write_default) (
-                    ptr_section->callback_write_default_pointer,
-                    ptr_section->callback_write_default_data,
+            if (config_file_write_section_cb (
                     config_file,
-                    ptr_section->name) != WEECHAT_CONFIG_WRITE_OK)
-                goto error;
-        }
-        else if (!default_options && ptr_section->callback_write)
-        {
-            if ((ptr_section->callback_write) (
-                    ptr_section->callback_write_pointer,
-                    ptr_section->callback_write_data,
-                    config_file,
-                    ptr_section->name) != WEECHAT_CONFIG_WRITE_OK)
+                    ptr_section,
+                    default_options) != WEECHAT_CONFIG_WRITE_OK)
                 goto error;
         }
         else
@@ -3266,7 +3439,11 @@ config_file_write_internal (struct t_config_file *config_file,
                 if (!config_file_write_option (config_file, ptr_option))
                     goto error;
             }
+            ptr_section->generation_written = ptr_section->generation;
         }
+        /* default options are not the current content of section */
+        if (default_options)
+            ptr_section->generation_written = -1;
     }
 
     if (fflush (config_file->file) != 0)
@@ -3292,6 +3469,7 @@ config_file_write_internal (struct t_config_file *config_file,
     /* close temp file */
     fclose (config_file->file);
     config_file->file = NULL;
+    free (buffer);
 
     /* update file mode */
     if (!util_parse_long (CONFIG_STRING(config_look_config_permissions), 8, &file_perms))
@@ -3310,12 +3488,24 @@ config_file_write_internal (struct t_config_file *config_file,
     /* rename temp file to target file */
     rc = rename (filename2, filename);
 
+    if (rc == 0)
+    {
+        if (default_options)
+            config_file->generation_written = -1;
+        else
+            config_file_set_written (config_file, filename);
+    }
+
     free (filename);
     free (filename2);
 
     return (rc == 0) ? WEECHAT_CONFIG_WRITE_OK : WEECHAT_CONFIG_WRITE_ERROR;
 
 no_changes:
+    if (default_options)
+        config_file->generation_written = -1;
+    else
+        config_file_set_written (config_file, filename);
     rc = WEECHAT_CONFIG_WRITE_OK;
     goto end;
 
@@ -3335,6 +3525,7 @@ end:
         fclose (config_file->file);
         config_file->file = NULL;
     }
+    free (buffer);
     unlink (filename2);
     free (filename);
     free (filename2);
@@ -3570,9 +3761,88 @@ config_file_update_data_read (struct t_config_file *config_file,
     hashtable_free (data_read);
 }
 
+/*
+ * Load content of a configuration file in memory: the whole file is read in
+ * an allocated buffer, ending with '\0', so that lines can be tokenized in
+ * place.
+ *
+ * The file is not mapped in memory (with mmap): if it was truncated by
+ * another process while it is mapped, any access to the content would raise
+ * SIGBUS.
+ *
+ * Return pointer to content, NULL if error or if the file is empty.
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+config_file_load (int fd, size_t *size)
+{
+    struct stat st;
+    char *content, *content2;
+    size_t length, allocated;
+    ssize_t num_read;
+
+    if (!size)
+        return NULL;
+
+    *size = 0;
+
+    if (fstat (fd, &st) != 0)
+        return NULL;
+
+    /* read the whole file in a buffer */
+    allocated = (st.st_size > 0) ? (size_t)st.st_size + 1 : 4096;
+    content = malloc (allocated);
+    if (!content)
+        return NULL;
+    length = 0;
+    while (1)
+    {
+        if (length + 1 >= allocated)
+        {
+            allocated *= 2;
+            content2 = realloc (content, allocated);
+            if (!content2)
+            {
+                free (content);
+                return NULL;
+            }
+            content = content2;
+        }
+        num_read = read (fd, content + length, allocated - length - 1);
+        if (num_read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            free (content);
+            return NULL;
+        }
+        if (num_read == 0)
+            break;
+        length += (size_t)num_read;
+    }
+    if (length == 0)
+    {
+        free (content);
+        return NULL;
+    }
+    content[length] = '\0';
+
+    *size = length;
+
+    return content;
+}
+
 /*
  * Read a configuration file (this function must not be called directly).
  *
+ * The file is loaded in memory (see function config_file_load) and lines
+ * are tokenized in place: section, option and value are pointers in the
+ * line, so that only values actually stored in options are allocated.
+ * A copy is made only if the line must be converted to internal charset
+ * or if data can be changed by the update callback.
+ *
  * Return:
  *   WEECHAT_CONFIG_READ_OK: OK
  *   WEECHAT_CONFIG_READ_MEMORY_ERROR: not enough memory
@@ -3582,15 +3852,22 @@ config_file_update_data_read (struct t_config_file *config_file,
 int
 config_file_read_internal (struct t_config_file *config_file, int reload)
 {
-    int line_number, rc, length, version, warning_update_displayed;
-    char *filename, *section, *option, *value;
+    int fd, line_number, rc, length, version, warning_update_displayed;
+    int update;
+    char *filename, *content, *ptr_content, *section, *option, *value;
+    char *line, *line_alloc, *section_alloc, *option_alloc;
+    char *value_alloc, *ptr_line, *pos, *pos2, *pos_option_end;
+    char *pos_value_end, char_value_end;
+    size_t size;
     struct t_config_section *ptr_section;
     struct t_config_option *ptr_option;
-    char line[16384], *ptr_line, *ptr_line2, *pos, *pos2;
+    struct timeval time_start, time_end;
 
     if (!config_file)
         return WEECHAT_CONFIG_READ_FILE_NOT_FOUND;
 
+    gettimeofday (&time_start, NULL);
+
     config_file->version_read = 1;
     warning_update_displayed = 0;
 
@@ -3613,8 +3890,8 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
     }
 
     /* read config file */
-    config_file->file = fopen (filename, "r");
-    if (!config_file->file)
+    fd = open (filename, O_RDONLY);
+    if (fd < 0)
     {
         gui_chat_printf (NULL,
                          _("%sWARNING: failed to read configuration file "
@@ -3631,6 +3908,8 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
         free (filename);
         return WEECHAT_CONFIG_READ_FILE_NOT_FOUND;
     }
+    content = config_file_load (fd, &size);
+    close (fd);
 
     if (!reload)
         log_printf (_("Reading configuration file %s"), config_file->filename);
@@ -3638,36 +3917,53 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
     /* read all lines */
     ptr_section = NULL;
     line_number = 0;
-    while (!feof (config_file->file))
+    ptr_content = content;
+    while (ptr_content && (ptr_content < content + size))
     {
         line_number++;
 
+        line_alloc = NULL;
+        section_alloc = NULL;
+        option_alloc = NULL;
+        value_alloc = NULL;
         option = NULL;
         value = NULL;
+        pos_option_end = NULL;
+        pos_value_end = NULL;
+        char_value_end = '\0';
 
-        ptr_line = fgets (line, sizeof (line) - 1, config_file->file);
-        if (!ptr_line)
-            goto end_line;
+        /* end the line with '\0' */
+        line = ptr_content;
+        pos = memchr (ptr_content, '\n', content + size - ptr_content);
+        if (pos)
+        {
+            pos[0] = '\0';
+            ptr_content = pos + 1;
+        }
+        else
+        {
+            /* last line without newline (the content ends with '\0') */
+            ptr_content = content + size;
+        }
 
         /* encode line to internal charset */
-        ptr_line2 = string_iconv_to_internal (NULL, ptr_line);
-        if (ptr_line2)
+        if (!local_utf8)
         {
-            snprintf (line, sizeof (line), "%s", ptr_line2);
-            free (ptr_line2);
+            line_alloc = string_iconv_to_internal (NULL, line);
+            if (line_alloc)
+                line = line_alloc;
         }
 
+        ptr_line = line;
+
         /* skip spaces */
         while (ptr_line[0] == ' ')
         {
             ptr_line++;
         }
 
-        /* remove CR/LF */
+        /* remove CR */
         pos = strchr (ptr_line, '\r');
-        if (pos)
-            pos[0] = '\0';
-        pos = strchr (ptr_line, '\n');
         if (pos)
             pos[0] = '\0';
 
@@ -3689,13 +3985,25 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
             }
             else
             {
-                section = string_strndup (ptr_line + 1, pos - ptr_line - 1);
+                pos[0] = '\0';
+                section = ptr_line + 1;
+                /* the update callback can rename the section: use a copy */
+                update = (config_file->callback_update
+                          && (config_file->version_read < config_file->version));
+                if (update)
+                {
+                    section_alloc = strdup (section);
+                    section = section_alloc;
+                }
                 if (section)
                 {
-                    config_file_update_data_read (config_file, filename,
-                                                  section, NULL, NULL,
-                                                  &section, NULL, NULL,
-                                                  &warning_update_displayed);
+                    config_file_update_data_read (
+                        config_file, filename,
+                        section, NULL, NULL,
+                        (update) ? &section_alloc : NULL, NULL, NULL,
+                        &warning_update_displayed);
+                    if (update)
+                        section = section_alloc;
                     ptr_section = config_file_search_section (config_file,
                                                               section);
                     if (!ptr_section)
@@ -3707,7 +4015,6 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
                             gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
                             filename, line_number, section);
                     }
-                    free (section);
                 }
             }
             goto end_line;
@@ -3717,6 +4024,7 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
         if (ptr_line[0] == '\\')
             ptr_line++;
 
+        option = ptr_line;
         pos = strstr (ptr_line, " =");
         if (pos)
         {
@@ -3726,43 +4034,14 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
             {
                 pos2--;
             }
-            option = string_strndup (ptr_line, pos2 + 1 - ptr_line);
+            pos_option_end = pos2 + 1;
             /* skip spaces after '=' */
             pos += 2;
             while (pos[0] == ' ')
             {
                 pos++;
             }
-            if (strcmp (pos, WEECHAT_CONFIG_OPTION_NULL) != 0)
-            {
-                length = strlen (pos);
-                if (length > 1)
-                {
-                    /* remove simple or double quotes and spaces at the end */
-                    pos2 = pos + length - 1;
-                    while ((pos2 > pos) && (pos2[0] == ' '))
-                    {
-                        pos2--;
-                    }
-                    if (((pos[0] == '\'') && (pos2[0] == '\''))
-                        || ((pos[0] == '"') && (pos2[0] == '"')))
-                    {
-                        value = string_strndup (pos + 1, pos2 - pos - 1);
-                    }
-                    else
-                    {
-                        value = string_strndup (pos, pos2 + 1 - pos);
-                    }
-                }
-                else
-                {
-                    value = strdup (pos);
-                }
-            }
-        }
-        else
-        {
-            option = strdup (ptr_line);
+            pos_option_end[0] = '\0';
         }
 
         if (!ptr_section && (strcmp (option, CONFIG_VERSION_OPTION) == 0))
@@ -3770,6 +4049,8 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
             version = config_file_parse_version (pos);
             if (version < 0)
             {
+                if (pos_option_end)
+                    pos_option_end[0] = ' ';
                 gui_chat_printf (
                     NULL,
                     _("%sError: %s, line %d: invalid config "
@@ -3779,8 +4060,7 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
                     filename, line_number,
                     line);
                 config_file_backup (filename);
-                free (option);
-                free (value);
+                free (line_alloc);
                 goto end_file;
             }
             else
@@ -3798,8 +4078,7 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
                         config_file->version_read,
                         config_file->version);
                     config_file_backup (filename);
-                    free (option);
-                    free (value);
+                    free (line_alloc);
                     goto end_file;
                 }
             }
@@ -3808,6 +4087,8 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
 
         if (!ptr_section)
         {
+            if (pos_option_end)
+                pos_option_end[0] = ' ';
             gui_chat_printf (NULL,
                              _("%sWarning: %s, line %d: "
                                "ignoring option outside section: %s"),
@@ -3817,10 +4098,55 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
             goto end_line;
         }
 
+        if (pos && (strcmp (pos, WEECHAT_CONFIG_OPTION_NULL) != 0))
+        {
+            value = pos;
+            length = strlen (pos);
+            if (length > 1)
+            {
+                /* remove simple or double quotes and spaces at the end */
+                pos2 = pos + length - 1;
+                while ((pos2 > pos) && (pos2[0] == ' '))
+                {
+                    pos2--;
+                }
+                if (((pos[0] == '\'') && (pos2[0] == '\''))
+                    || ((pos[0] == '"') && (pos2[0] == '"')))
+                {
+                    /* a single quote followed by spaces is not a value */
+                    value = (pos2 > pos) ? pos + 1 : NULL;
+                    pos_value_end = pos2;
+                }
+                else
+                {
+                    pos_value_end = pos2 + 1;
+                }
+                char_value_end = pos_value_end[0];
+                pos_value_end[0] = '\0';
+            }
+        }
+
+        /* the update callback can change option and value: use copies */
+        update = (config_file->callback_update
+                  && (config_file->version_read < config_file->version));
+        if (update)
+        {
+            option_alloc = strdup (option);
+            value_alloc = (value) ? strdup (value) : NULL;
+            option = option_alloc;
+            value = value_alloc;
+        }
         config_file_update_data_read (config_file, filename,
                                       ptr_section->name, option, value,
-                                      NULL, &option, &value,
+                                      NULL,
+                                      (update) ? &option_alloc : NULL,
+                                      (update) ? &value_alloc : NULL,
                                       &warning_update_displayed);
+        if (update)
+        {
+            option = option_alloc;
+            value = value_alloc;
+        }
 
         /* option has been ignored by the update callback? */
         if (!option || !option[0])
@@ -3863,6 +4189,12 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
             }
         }
 
+        /* restore chars replaced by '\0', to display the whole line */
+        if (pos_option_end)
+            pos_option_end[0] = ' ';
+        if (pos_value_end)
+            pos_value_end[0] = char_value_end;
+
         switch (rc)
         {
             case WEECHAT_CONFIG_OPTION_SET_OPTION_NOT_FOUND:
@@ -3888,15 +4220,22 @@ config_file_read_internal (struct t_config_file *config_file, int reload)
         }
 
     end_line:
-        free (option);
-        free (value);
+        free (line_alloc);
+        free (section_alloc);
+        free (option_alloc);
+        free (value_alloc);
     }
 
 end_file:
-    fclose (config_file->file);
-    config_file->file = NULL;
+    free (content);
     free (filename);
 
+    gettimeofday (&time_end, NULL);
+    config_file->read_count++;
+    config_file->read_lines = line_number;
+    config_file->read_size = (long long)size;
+    config_file->read_time = util_timeval_diff (&time_start, &time_end);
+
     return WEECHAT_CONFIG_READ_OK;
 }
 
@@ -4008,6 +4347,14 @@ config_file_option_free (struct t_config_option *option, int run_callback)
 
     ptr_section = option->section;
 
+    /* remove option from index of section (before its name is freed) */
+    if (ptr_section
+        && (hashtable_get (ptr_section->hash_options, option->name) == option))
+    {
+        hashtable_remove (ptr_section->hash_options, option->name);
+    }
+    config_file_option_changed (option);
+
     /* free data */
     config_file_option_free_data (option);
 
@@ -4070,6 +4417,9 @@ config_file_section_free (struct t_config_section *section)
 
     /* free data */
     config_file_section_free_options (section);
+    hashtable_remove (ptr_config->hash_sections, section->name);
+    hashtable_free (section->hash_options);
+    ptr_config->generation++;
     free (section->name);
     free (section->callback_read_data);
     free (section->callback_write_data);
@@ -4113,6 +4463,7 @@ config_file_free (struct t_config_file *config_file)
     {
         config_file_section_free (config_file->sections);
     }
+    hashtable_free (config_file->hash_sections);
     free (config_file->name);
     free (config_file->filename);
 
@@ -4202,6 +4553,13 @@ config_file_hdata_config_file_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_config_file, callback_reload_data, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_config_file, sections, POINTER, 0, NULL, "config_section");
         HDATA_VAR(struct t_config_file, last_section, POINTER, 0, NULL, "config_section");
+        HDATA_VAR(struct t_config_file, hash_sections, HASHTABLE, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, generation, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, generation_written, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, read_count, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, read_lines, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, read_size, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_file, read_time, LONGLONG, 0, NULL, NULL);
         HDATA_VAR(struct t_config_file, prev_config, POINTER, 0, NULL, hdata_name);
         HDATA_VAR(struct t_config_file, next_config, POINTER, 0, NULL, hdata_name);
         HDATA_LIST(config_files, WEECHAT_HDATA_LIST_CHECK_POINTERS);
@@ -4249,6 +4607,9 @@ config_file_hdata_config_section_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_config_section, callback_delete_option_data, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_config_section, options, POINTER, 0, NULL, "config_option");
         HDATA_VAR(struct t_config_section, last_option, POINTER, 0, NULL, "config_option");
+        HDATA_VAR(struct t_config_section, hash_options, HASHTABLE, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_section, generation, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_config_section, generation_written, LONGLONG, 0, NULL, NULL);
         HDATA_VAR(struct t_config_section, prev_section, POINTER, 0, NULL, hdata_name);
         HDATA_VAR(struct t_config_section, next_section, POINTER, 0, NULL, hdata_name);
     }
@@ -4517,6 +4878,13 @@ config_file_print_log (void)
         log_printf ("  callback_reload_data . : %p", ptr_config_file->callback_reload_data);
         log_printf ("  sections . . . . . . . : %p", ptr_config_file->sections);
         log_printf ("  last_section . . . . . : %p", ptr_config_file->last_section);
+        log_printf ("  hash_sections. . . . . : %p", ptr_config_file->hash_sections);
+        log_printf ("  generation . . . . . . : %lld", ptr_config_file->generation);
+        log_printf ("  generation_written . . : %lld", ptr_config_file->generation_written);
+        log_printf ("  read_count . . . . . . : %d", ptr_config_file->read_count);
+        log_printf ("  read_lines . . . . . . : %d", ptr_config_file->read_lines);
+        log_printf ("  read_size. . . . . . . : %lld", ptr_config_file->read_size);
+        log_printf ("  read_time. . . . . . . : %lld", ptr_config_file->read_time);
         log_printf ("  prev_config. . . . . . : %p", ptr_config_file->prev_config);
         log_printf ("  next_config. . . . . . : %p", ptr_config_file->next_config);
 
@@ -4544,6 +4912,9 @@ config_file_print_log (void)
             log_printf ("      callback_delete_option_data . : %p", ptr_section->callback_delete_option_data);
             log_printf ("      options . . . . . . . . . . . : %p", ptr_section->options);
             log_printf ("      last_option . . . . . . . . . : %p", ptr_section->last_option);
+            log_printf ("      hash_options. . . . . . . . . : %p", ptr_section->hash_options);
+            log_printf ("      generation. . . . . . . . . . : %lld", ptr_section->generation);
+            log_printf ("      generation_written. . . . . . : %lld", ptr_section->generation_written);
             log_printf ("      prev_section. . . . . . . . . : %p", ptr_section->prev_section);
             log_printf ("      next_section. . . . . . . . . : %p", ptr_section->next_section);
 
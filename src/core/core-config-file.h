@@ -24,9 +24,14 @@
 #define WEECHAT_CONFIG_FILE_H
 
 #include <stdio.h>
+#include <time.h>
+#include <sys/types.h>
 
 #define CONFIG_VERSION_OPTION  "config_version"
 
+/* size of buffer used to write a configuration file */
+#define CONFIG_FILE_WRITE_BUFFER_SIZE (256 * 1024)
+
 #define CONFIG_PRIORITY_DEFAULT 1000
 
 #define CONFIG_BOOLEAN(option) (*((int *)((option)->value)))
@@ -79,6 +84,19 @@ struct t_config_file
     void *callback_reload_data;            /* data sent to callback         */
     struct t_config_section *sections;     /* config sections               */
     struct t_config_section *last_section; /* last config section           */
+    struct t_hashtable *hash_sections;     /* sections indexed by name      */
+    long long generation;                  /* incremented when a section is */
+                                           /* added/removed or version set  */
+    long long generation_written;          /* generation on last write      */
+                                           /* (-1 if never written)         */
+    ino_t written_inode;                   /* inode of file on last write   */
+    off_t written_size;                    /* size of file on last write    */
+    time_t written_mtime;                  /* mtime of file on last write   */
+    int read_count;                        /* number of reads of file       */
+    int read_lines;                        /* lines parsed on last read     */
+    long long read_size;                   /* bytes parsed on last read     */
+    long long read_time;                   /* duration of last read (in     */
+                                           /* microseconds)                 */
     struct t_config_file *prev_config;     /* link to previous config file  */
     struct t_config_file *next_config;     /* link to next config file      */
 };
@@ -131,6 +149,13 @@ struct t_config_section
     void *callback_delete_option_data;     /* data sent to delete callback  */
     struct t_config_option *options;       /* options in section            */
     struct t_config_option *last_option;   /* last option in section        */
+    struct t_hashtable *hash_options;      /* options indexed by name       */
+    long long generation;                  /* incremented when an option is */
+                                           /* added/changed/removed         */
+    long long generation_written;          /* generation on last write      */
+                                           /* (-1 if never written or if    */
+                                           /* content written by callback   */
+                                           /* is not only options)          */
     struct t_config_section *prev_section; /* link to previous section      */
     struct t_config_section *next_section; /* link to next section          */
 };
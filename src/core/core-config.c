@@ -335,11 +335,13 @@ struct t_config_option *config_history_max_visited_buffers = NULL;
 
 /* config, network section */
 
+struct t_config_option *config_network_connection_threads = NULL;
 struct t_config_option *config_network_connection_timeout = NULL;
 struct t_config_option *config_network_gnutls_ca_system = NULL;
 struct t_config_option *config_network_gnutls_ca_user = NULL;
 struct t_config_option *config_network_gnutls_handshake_timeout = NULL;
 struct t_config_option *config_network_proxy_curl = NULL;
+struct t_config_option *config_network_url_max_host_connections = NULL;
 
 /* config, plugin section */
 
@@ -365,10 +367,12 @@ int config_length_prefix_same_nick_middle = 0;
 struct t_hook *config_day_change_timer = NULL;
 int config_day_change_old_day = -1;
 int config_emphasized_attributes = 0;
-regex_t *config_highlight_disable_regex = NULL;
-regex_t *config_highlight_regex = NULL;
+struct t_string_regex *config_highlight_disable_regex = NULL;
+struct t_string_regex *config_highlight_regex = NULL;
+struct t_string_highlight *config_highlight_words_compiled = NULL;
 char ***config_highlight_tags = NULL;
 int config_num_highlight_tags = 0;
+struct t_gui_line_tags_compiled *config_highlight_tags_compiled = NULL;
 char **config_plugin_extensions = NULL;
 int config_num_plugin_extensions = 0;
 char config_tab_spaces[TAB_MAX_WIDTH + 1];
@@ -1005,6 +1009,24 @@ config_change_emphasized_attributes (const void *pointer, void *data,
     gui_window_ask_refresh (1);
 }
 
+/*
+ * Callback for changes on option "weechat.look.highlight".
+ */
+
+void
+config_change_highlight (const void *pointer, void *data,
+                         struct t_config_option *option)
+{
+    /* make C compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) option;
+
+    string_highlight_free (config_highlight_words_compiled);
+    config_highlight_words_compiled = string_highlight_compile_option (
+        CONFIG_STRING(config_look_highlight));
+}
+
 /*
  * Callback for changes on option "weechat.look.highlight_disable_regex".
  */
@@ -1020,7 +1042,7 @@ config_change_highlight_disable_regex (const void *pointer, void *data,
 
     if (config_highlight_disable_regex)
     {
-        regfree (config_highlight_disable_regex);
+        string_regex_free (config_highlight_disable_regex);
         free (config_highlight_disable_regex);
         config_highlight_disable_regex = NULL;
     }
@@ -1031,9 +1053,9 @@ config_change_highlight_disable_regex (const void *pointer, void *data,
         config_highlight_disable_regex = malloc (sizeof (*config_highlight_disable_regex));
         if (config_highlight_disable_regex)
         {
-            if (string_regcomp (config_highlight_disable_regex,
-                                CONFIG_STRING(config_look_highlight_disable_regex),
-                                REG_EXTENDED | REG_ICASE) != 0)
+            if (string_regex_compile (config_highlight_disable_regex,
+                                      CONFIG_STRING(config_look_highlight_disable_regex),
+                                      REG_EXTENDED | REG_ICASE) != 0)
             {
                 free (config_highlight_disable_regex);
                 config_highlight_disable_regex = NULL;
@@ -1057,7 +1079,7 @@ config_change_highlight_regex (const void *pointer, void *data,
 
     if (config_highlight_regex)
     {
-        regfree (config_highlight_regex);
+        string_regex_free (config_highlight_regex);
         free (config_highlight_regex);
         config_highlight_regex = NULL;
     }
@@ -1068,9 +1090,9 @@ config_change_highlight_regex (const void *pointer, void *data,
         config_highlight_regex = malloc (sizeof (*config_highlight_regex));
         if (config_highlight_regex)
         {
-            if (string_regcomp (config_highlight_regex,
-                                CONFIG_STRING(config_look_highlight_regex),
-                                REG_EXTENDED | REG_ICASE) != 0)
+            if (string_regex_compile (config_highlight_regex,
+                                      CONFIG_STRING(config_look_highlight_regex),
+                                      REG_EXTENDED | REG_ICASE) != 0)
             {
                 free (config_highlight_regex);
                 config_highlight_regex = NULL;
@@ -1097,6 +1119,11 @@ config_change_highlight_tags (const void *pointer, void *data,
         string_free_split_tags (config_highlight_tags);
         config_highlight_tags = NULL;
     }
+    if (config_highlight_tags_compiled)
+    {
+        gui_line_tags_compiled_free (config_highlight_tags_compiled);
+        config_highlight_tags_compiled = NULL;
+    }
     config_num_highlight_tags = 0;
 
     if (CONFIG_STRING(config_look_highlight_tags)
@@ -1105,6 +1132,8 @@ config_change_highlight_tags (const void *pointer, void *data,
         config_highlight_tags = string_split_tags (
             CONFIG_STRING(config_look_highlight_tags),
             &config_num_highlight_tags);
+        config_highlight_tags_compiled = gui_line_tags_compile (
+            config_num_highlight_tags, config_highlight_tags);
     }
 }
 
@@ -3705,7 +3734,9 @@ config_weechat_init_options (void)
                "case-sensitive), words may begin or end with \"*\" for partial "
                "match; example: \"test,(?-i)*toto*,flash*\""),
             NULL, 0, 0, "", NULL, 0,
-            NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+            NULL, NULL, NULL,
+            &config_change_highlight, NULL, NULL,
+            NULL, NULL, NULL);
         config_look_highlight_disable_regex = config_file_new_option (
             weechat_config_file, weechat_config_section_look,
             "highlight_disable_regex", "string",
@@ -5377,11 +5408,23 @@ config_weechat_init_options (void)
         NULL, NULL, NULL);
     if (weechat_config_section_network)
     {
+        config_network_connection_threads = config_file_new_option (
+            weechat_config_file, weechat_config_section_network,
+            "connection_threads", "integer",
+            N_("maximum number of threads used to resolve addresses and "
+               "connect to remote hosts in background; threads are started "
+               "when needed and shared by all connections; if all threads "
+               "are blocked (for example by a slow name resolution), new "
+               "connections use a child process; "
+               "0 = use a child process for each connection (connections "
+               "through a proxy always use a child process)"),
+            NULL, 0, 64, "8", NULL, 0,
+            NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
         config_network_connection_timeout = config_file_new_option (
             weechat_config_file, weechat_config_section_network,
             "connection_timeout", "integer",
             N_("timeout (in seconds) for connection to a remote host (made in a "
-               "child process)"),
+               "thread or a child process)"),
             NULL, 1, INT_MAX, "60", NULL, 0,
             NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
         config_network_gnutls_ca_system = config_file_new_option (
@@ -5421,6 +5464,15 @@ config_weechat_init_options (void)
             &config_check_proxy_curl, NULL, NULL,
             NULL, NULL, NULL,
             NULL, NULL, NULL);
+        config_network_url_max_host_connections = config_file_new_option (
+            weechat_config_file, weechat_config_section_network,
+            "url_max_host_connections", "integer",
+            N_("maximum number of simultaneous connections to the same host "
+               "for URL transfers made by function hook_url (other transfers "
+               "are queued, connections are kept alive and reused); "
+               "0 = no limit"),
+            NULL, 0, 1000, "4", NULL, 0,
+            NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
     }
 
     /* plugin */
@@ -5646,6 +5698,8 @@ config_weechat_init (void)
                                               &config_day_change_timer_cb,
                                               NULL, NULL);
     }
+    if (!config_highlight_words_compiled)
+        config_change_highlight (NULL, NULL, NULL);
     if (!config_highlight_disable_regex)
         config_change_highlight_disable_regex (NULL, NULL, NULL);
     if (!config_highlight_regex)
@@ -5713,16 +5767,19 @@ config_weechat_free (void)
 {
     config_file_free (weechat_config_file);
 
+    string_highlight_free (config_highlight_words_compiled);
+    config_highlight_words_compiled = NULL;
+
     if (config_highlight_disable_regex)
     {
-        regfree (config_highlight_disable_regex);
+        string_regex_free (config_highlight_disable_regex);
         free (config_highlight_disable_regex);
         config_highlight_disable_regex = NULL;
     }
 
     if (config_highlight_regex)
     {
-        regfree (config_highlight_regex);
+        string_regex_free (config_highlight_regex);
         free (config_highlight_regex);
         config_highlight_regex = NULL;
     }
@@ -5732,6 +5789,11 @@ config_weechat_free (void)
         string_free_split_tags (config_highlight_tags);
         config_highlight_tags = NULL;
     }
+    if (config_highlight_tags_compiled)
+    {
+        gui_line_tags_compiled_free (config_highlight_tags_compiled);
+        config_highlight_tags_compiled = NULL;
+    }
     config_num_highlight_tags = 0;
 
     if (config_plugin_extensions)
@@ -29,6 +29,9 @@
 #include "core-config-file.h"
 
 struct t_gui_buffer;
+struct t_gui_line_tags_compiled;
+struct t_string_highlight;
+struct t_string_regex;
 
 #define WEECHAT_CONFIG_NAME "weechat"
 #define WEECHAT_CONFIG_PRIO_NAME "110000|weechat"
@@ -378,11 +381,13 @@ extern struct t_config_option *config_history_max_buffer_lines_number;
 extern struct t_config_option *config_history_max_commands;
 extern struct t_config_option *config_history_max_visited_buffers;
 
+extern struct t_config_option *config_network_connection_threads;
 extern struct t_config_option *config_network_connection_timeout;
 extern struct t_config_option *config_network_gnutls_ca_system;
 extern struct t_config_option *config_network_gnutls_ca_user;
 extern struct t_config_option *config_network_gnutls_handshake_timeout;
 extern struct t_config_option *config_network_proxy_curl;
+extern struct t_config_option *config_network_url_max_host_connections;
 
 extern struct t_config_option *config_plugin_autoload;
 extern struct t_config_option *config_plugin_extension;
@@ -399,10 +404,12 @@ extern int config_length_nick_prefix_suffix;
 extern int config_length_prefix_same_nick;
 extern int config_length_prefix_same_nick_middle;
 extern int config_emphasized_attributes;
-extern regex_t *config_highlight_disable_regex;
-extern regex_t *config_highlight_regex;
+extern struct t_string_regex *config_highlight_disable_regex;
+extern struct t_string_regex *config_highlight_regex;
+extern struct t_string_highlight *config_highlight_words_compiled;
 extern char ***config_highlight_tags;
 extern int config_num_highlight_tags;
+extern struct t_gui_line_tags_compiled *config_highlight_tags_compiled;
 extern char **config_plugin_extensions;
 extern int config_num_plugin_extensions;
 extern char config_tab_spaces[];
@@ -39,18 +39,25 @@
 #include <gcrypt.h>
 #include <curl/curl.h>
 #include <zlib.h>
+
 #ifdef HAVE_ZSTD
 #include <zstd.h>
 #endif
 #ifdef HAVE_CJSON
 #include <cjson/cJSON.h>
 #endif
+#ifdef HAVE_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
 
 #include <gnutls/gnutls.h>
 
 #include "weechat.h"
 #include "core-backtrace.h"
+#include "core-arraylist.h"
 #include "core-config-file.h"
+#include "core-debug.h"
 #include "core-hashtable.h"
 #include "core-hdata.h"
 #include "core-hook.h"
@@ -72,6 +79,7 @@
 #include "../gui/gui-hotlist.h"
 #include "../gui/gui-key.h"
 #include "../gui/gui-layout.h"
+#include "../gui/gui-line.h"
 #include "../gui/gui-main.h"
 #include "../gui/gui-window.h"
 #include "../plugins/plugin.h"
@@ -89,6 +97,27 @@ int debug_dump_active = 0;
 long long debug_long_callbacks = 0;    /* callbacks taking more than        */
                                        /* N microseconds will be traced     */
 
+int debug_loop_enabled = 0;            /* 1 if main loop stats are enabled  */
+long long debug_loop_stall = 0;        /* iterations of main loop taking    */
+                                       /* more than N microseconds are      */
+                                       /* traced                            */
+long long debug_loop_iterations = 0;   /* number of iterations measured     */
+long long debug_loop_stalls = 0;       /* number of stalls detected         */
+struct t_debug_loop_stats debug_loop_stats[DEBUG_LOOP_NUM_STATS];
+char *debug_loop_stats_name[DEBUG_LOOP_NUM_STATS] =
+{ "timer", "refresh", "fd", "process", "signal", "wait",
+  "iteration", "timer_lateness" };
+long long debug_loop_bucket_limit[DEBUG_LOOP_NUM_BUCKETS - 1] =
+{ 100LL, 1000LL, 10000LL, 100000LL, 1000000LL };
+
+/* current iteration of main loop */
+int debug_loop_started = 0;            /* 1 if iteration is measured        */
+struct timeval debug_loop_time_mark;   /* end time of last phase measured   */
+long long debug_loop_phase_time[DEBUG_LOOP_NUM_PHASES]; /* time by phase    */
+struct t_hook *debug_loop_slowest_hook = NULL; /* slowest callback          */
+int debug_loop_slowest_hook_type = 0;  /* type of slowest hook              */
+long long debug_loop_slowest_hook_time = 0; /* time of slowest callback     */
+
 
 /*
  * Display build information on stdout.
@@ -132,6 +161,7 @@ debug_build_info (void)
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_MAN);
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_NCURSES);
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_NLS);
+    DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_PCRE2);
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_PERL);
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_PHP);
     DEBUG_DISPLAY_BUILD_OPTION_BOOL(ENABLE_PYTHON);
@@ -359,6 +389,9 @@ debug_windows_tree (void)
 void
 debug_memory (void)
 {
+    int lines, chunks;
+    unsigned long long size, size_unused, size_unpacked;
+
 #ifdef HAVE_MALLINFO2
     struct mallinfo2 info;
 
@@ -400,6 +433,22 @@ debug_memory (void)
                        "found)"));
 #endif /* HAVE_MALLINFO */
 #endif /* HAVE_MALLINFO2 */
+
+    gui_line_arena_get_memory (&lines, &chunks, &size, &size_unused,
+                               &size_unpacked);
+    gui_chat_printf (NULL, "");
+    gui_chat_printf (NULL, _("Memory used by lines in buffers:"));
+    gui_chat_printf (NULL, "  lines   :%10d", lines);
+    gui_chat_printf (NULL, "  chunks  :%10d", chunks);
+    gui_chat_printf (NULL, "  size    :%10llu", size);
+    gui_chat_printf (NULL,
+                     _("  unused  :%10llu (allocated in chunks, not used "
+                       "yet)"),
+                     size_unused);
+    gui_chat_printf (NULL,
+                     _("  saved   :%10lld (estimate, compared to one "
+                       "allocation per line field)"),
+                     (long long)size_unpacked - (long long)size);
 }
 
 /*
@@ -535,6 +584,13 @@ debug_hooks (void)
     }
     gui_chat_printf (NULL, "%17s------", "---------");
     gui_chat_printf (NULL, "%17s:%5d", "total", hooks_count_total);
+    gui_chat_printf (NULL, "");
+    gui_chat_printf (NULL,
+                     "fd hooks: backend: %s, fd in epoll: %d, "
+                     "fd in poll: %d",
+                     hook_fd_get_backend (),
+                     hook_fd_count_epoll,
+                     hook_fd_count_poll);
 }
 
 /*
@@ -656,6 +712,504 @@ debug_hooks_plugin_types (const char *plugin_mask, const char **hook_types)
     string_dyn_free (result_type, 1);
 }
 
+/*
+ * Compare two hooks using profiling data (for /debug hooks profile), data is
+ * the sort key: "calls", "total", "avg" or "max".
+ *
+ * Return:
+ *   < 0: hook1 is more expensive than hook2
+ *     0: hook1 and hook2 have same cost
+ *   > 0: hook1 is less expensive than hook2
+ */
+
+int
+debug_hooks_profile_cmp_cb (void *data, struct t_arraylist *arraylist,
+                            void *pointer1, void *pointer2)
+{
+    struct t_hook *ptr_hook1, *ptr_hook2;
+    const char *sort;
+    long long value1, value2;
+
+    /* make C compiler happy */
+    (void) arraylist;
+
+    sort = (const char *)data;
+    ptr_hook1 = (struct t_hook *)pointer1;
+    ptr_hook2 = (struct t_hook *)pointer2;
+
+    if (strcmp (sort, "calls") == 0)
+    {
+        value1 = ptr_hook1->profile->calls;
+        value2 = ptr_hook2->profile->calls;
+    }
+    else if (strcmp (sort, "avg") == 0)
+    {
+        value1 = ptr_hook1->profile->time_total / ptr_hook1->profile->calls;
+        value2 = ptr_hook2->profile->time_total / ptr_hook2->profile->calls;
+    }
+    else if (strcmp (sort, "max") == 0)
+    {
+        value1 = ptr_hook1->profile->time_max;
+        value2 = ptr_hook2->profile->time_max;
+    }
+    else
+    {
+        value1 = ptr_hook1->profile->time_total;
+        value2 = ptr_hook2->profile->time_total;
+    }
+
+    if (value1 > value2)
+        return -1;
+    if (value1 < value2)
+        return 1;
+    return 0;
+}
+
+/*
+ * Display profiling data of hooks, sorted by "sort" key: "calls", "total"
+ * (default), "avg" or "max".
+ *
+ * For each hook the last execution times are displayed as an histogram with
+ * 4 buckets: < 1ms, < 10ms, < 100ms and >= 100ms.
+ */
+
+void
+debug_hooks_profile (const char *sort)
+{
+    struct t_arraylist *list;
+    struct t_hook *ptr_hook;
+    char *desc;
+    int i, j, type, count, histogram[4];
+    long long time_last;
+
+    if (!sort)
+        sort = "total";
+
+    list = arraylist_new (64, 1, 1,
+                          &debug_hooks_profile_cmp_cb, (void *)sort,
+                          NULL, NULL);
+    if (!list)
+        return;
+
+    for (type = 0; type < HOOK_NUM_TYPES; type++)
+    {
+        for (ptr_hook = weechat_hooks[type]; ptr_hook;
+             ptr_hook = ptr_hook->next_hook)
+        {
+            if (!ptr_hook->deleted && ptr_hook->profile
+                && (ptr_hook->profile->calls > 0))
+                arraylist_add (list, ptr_hook);
+        }
+    }
+
+    gui_chat_printf (NULL, "");
+    gui_chat_printf (NULL,
+                     "hooks profile (%s, sort: %s, times in microseconds):",
+                     (hook_profile_enabled) ? "enabled" : "disabled",
+                     sort);
+
+    count = arraylist_size (list);
+    if (count == 0)
+    {
+        gui_chat_printf (NULL, "  (no data)");
+        arraylist_free (list);
+        return;
+    }
+
+    gui_chat_printf (NULL,
+                     "  %10s %14s %10s %10s  %-20s %s",
+                     "calls", "total", "avg", "max",
+                     "last (<1/10/100ms,+)", "hook");
+    for (i = 0; i < count; i++)
+    {
+        ptr_hook = (struct t_hook *)arraylist_get (list, i);
+        memset (histogram, 0, sizeof (histogram));
+        for (j = 0; j < HOOK_PROFILE_NUM_LAST; j++)
+        {
+            if (j >= ptr_hook->profile->calls)
+                break;
+            time_last = ptr_hook->profile->time_last[j];
+            if (time_last < 1000)
+                histogram[0]++;
+            else if (time_last < 10000)
+                histogram[1]++;
+            else if (time_last < 100000)
+                histogram[2]++;
+            else
+                histogram[3]++;
+        }
+        desc = hook_get_description (ptr_hook);
+        gui_chat_printf (NULL,
+                         "  %10lld %14lld %10lld %10lld  %3d/%3d/%3d/%3d"
+                         "      %s %s%s%s%s: %s",
+                         ptr_hook->profile->calls,
+                         ptr_hook->profile->time_total,
+                         ptr_hook->profile->time_total / ptr_hook->profile->calls,
+                         ptr_hook->profile->time_max,
+                         histogram[0], histogram[1], histogram[2], histogram[3],
+                         hook_type_string[ptr_hook->type],
+                         plugin_get_name (ptr_hook->plugin),
+                         (ptr_hook->subplugin) ? "(" : "",
+                         (ptr_hook->subplugin) ? ptr_hook->subplugin : "",
+                         (ptr_hook->subplugin) ? ")" : "",
+                         (desc) ? desc : "-");
+        free (desc);
+    }
+
+    arraylist_free (list);
+}
+
+/*
+ * Add a value (in microseconds) in main loop stats.
+ */
+
+void
+debug_loop_stats_add (struct t_debug_loop_stats *stats, long long time)
+{
+    int i;
+
+    if (time < 0)
+        time = 0;
+
+    stats->count++;
+    stats->time_total += time;
+    if (time > stats->time_max)
+        stats->time_max = time;
+
+    for (i = 0; i < DEBUG_LOOP_NUM_BUCKETS - 1; i++)
+    {
+        if (time < debug_loop_bucket_limit[i])
+            break;
+    }
+    stats->histogram[i]++;
+}
+
+/*
+ * Start measure of an iteration of main loop.
+ *
+ * Function must be called only if DEBUG_LOOP_ACTIVE is true.
+ */
+
+void
+debug_loop_start (void)
+{
+    util_timeval_monotonic (&debug_loop_time_mark);
+    memset (debug_loop_phase_time, 0, sizeof (debug_loop_phase_time));
+    debug_loop_slowest_hook = NULL;
+    debug_loop_slowest_hook_type = 0;
+    debug_loop_slowest_hook_time = 0;
+    debug_loop_started = 1;
+}
+
+/*
+ * Mark the end of a phase in current iteration of main loop: time elapsed
+ * since the end of previous phase is added to this phase.
+ *
+ * Function must be called only if DEBUG_LOOP_ACTIVE is true.
+ */
+
+void
+debug_loop_mark (enum t_debug_loop_stat phase)
+{
+    struct timeval now;
+
+    if (!debug_loop_started)
+        return;
+
+    util_timeval_monotonic (&now);
+    debug_loop_phase_time[phase] += util_timeval_diff (&debug_loop_time_mark,
+                                                       &now);
+    debug_loop_time_mark = now;
+}
+
+/*
+ * Record time of a hook callback executed in current iteration of main loop,
+ * to find the slowest one if the iteration is a stall.
+ */
+
+void
+debug_loop_add_callback (struct t_hook *hook, long long time)
+{
+    if (!debug_loop_started || (time <= debug_loop_slowest_hook_time))
+        return;
+
+    debug_loop_slowest_hook = hook;
+    debug_loop_slowest_hook_type = hook->type;
+    debug_loop_slowest_hook_time = time;
+}
+
+/*
+ * Record lateness of a timer: delay between the scheduled date and the
+ * execution of timer (in microseconds).
+ */
+
+void
+debug_loop_add_timer_lateness (long long time)
+{
+    if (!debug_loop_enabled)
+        return;
+
+    debug_loop_stats_add (&debug_loop_stats[DEBUG_LOOP_STAT_TIMER_LATENESS],
+                          time);
+}
+
+/*
+ * Write a main loop stall in WeeChat log file, with the time spent in each
+ * phase and the slowest hook callback.
+ */
+
+void
+debug_loop_log_stall (long long time)
+{
+    char *str_time, *str_time_hook, *desc;
+    int valid;
+
+    str_time = util_get_microseconds_string ((unsigned long long)time);
+
+    if (!debug_loop_slowest_hook)
+    {
+        log_printf (
+            _("debug: main loop stall: time elapsed: %s (timer: %lld, "
+              "refresh: %lld, fd: %lld, process: %lld, signal: %lld), "
+              "no hook callback"),
+            str_time,
+            debug_loop_phase_time[DEBUG_LOOP_PHASE_TIMER],
+            debug_loop_phase_time[DEBUG_LOOP_PHASE_REFRESH],
+            debug_loop_phase_time[DEBUG_LOOP_PHASE_FD],
+            debug_loop_phase_time[DEBUG_LOOP_PHASE_PROCESS],
+            debug_loop_phase_time[DEBUG_LOOP_PHASE_SIGNAL]);
+        free (str_time);
+        return;
+    }
+
+    /* the slowest hook may have been removed since its execution */
+    valid = hook_valid (debug_loop_slowest_hook);
+    desc = (valid) ? hook_get_description (debug_loop_slowest_hook) : NULL;
+    str_time_hook = util_get_microseconds_string (
+        (unsigned long long)debug_loop_slowest_hook_time);
+
+    log_printf (
+        _("debug: main loop stall: time elapsed: %s (timer: %lld, "
+          "refresh: %lld, fd: %lld, process: %lld, signal: %lld), "
+          "slowest callback: hook %s (%s), plugin: %s, subplugin: %s, "
+          "time elapsed: %s"),
+        str_time,
+        debug_loop_phase_time[DEBUG_LOOP_PHASE_TIMER],
+        debug_loop_phase_time[DEBUG_LOOP_PHASE_REFRESH],
+        debug_loop_phase_time[DEBUG_LOOP_PHASE_FD],
+        debug_loop_phase_time[DEBUG_LOOP_PHASE_PROCESS],
+        debug_loop_phase_time[DEBUG_LOOP_PHASE_SIGNAL],
+        hook_type_string[debug_loop_slowest_hook_type],
+        (desc) ? desc : ((valid) ? "-" : "removed"),
+        (valid) ? plugin_get_name (debug_loop_slowest_hook->plugin) : "-",
+        (valid && debug_loop_slowest_hook->subplugin) ?
+        debug_loop_slowest_hook->subplugin : "-",
+        (str_time_hook) ? str_time_hook : "?");
+
+    free (desc);
+    free (str_time_hook);
+    free (str_time);
+}
+
+/*
+ * End measure of an iteration of main loop: add time of phases in stats
+ * and write a message in log file if the iteration took more than the stall
+ * threshold (time waiting for activity on fd is ignored).
+ *
+ * Function must be called only if DEBUG_LOOP_ACTIVE is true.
+ */
+
+void
+debug_loop_end (void)
+{
+    long long time;
+    int i;
+
+    if (!debug_loop_started)
+        return;
+
+    debug_loop_started = 0;
+
+    time = 0;
+    for (i = 0; i < DEBUG_LOOP_NUM_PHASES; i++)
+    {
+        if (i != DEBUG_LOOP_PHASE_WAIT)
+            time += debug_loop_phase_time[i];
+    }
+
+    if (debug_loop_enabled)
+    {
+        debug_loop_iterations++;
+        for (i = 0; i < DEBUG_LOOP_NUM_PHASES; i++)
+        {
+            debug_loop_stats_add (&debug_loop_stats[i],
+                                  debug_loop_phase_time[i]);
+        }
+        debug_loop_stats_add (&debug_loop_stats[DEBUG_LOOP_STAT_ITERATION],
+                              time);
+    }
+
+    if ((debug_loop_stall > 0) && (time >= debug_loop_stall))
+    {
+        debug_loop_stalls++;
+        debug_loop_log_stall (time);
+    }
+
+    debug_loop_slowest_hook = NULL;
+}
+
+/*
+ * Reset main loop stats.
+ */
+
+void
+debug_loop_reset (void)
+{
+    memset (debug_loop_stats, 0, sizeof (debug_loop_stats));
+    debug_loop_iterations = 0;
+    debug_loop_stalls = 0;
+}
+
+/*
+ * Add a main loop stat in result of info "weechat_loop".
+ *
+ * If filter is set, only the value of stat with this name is set in result,
+ * otherwise "name=value" is added in result.
+ */
+
+void
+debug_loop_info_add (char **result, const char *filter,
+                     const char *name, long long value)
+{
+    char str_value[192];
+
+    if (filter && filter[0])
+    {
+        if (strcmp (filter, name) != 0)
+            return;
+        snprintf (str_value, sizeof (str_value), "%lld", value);
+        string_dyn_copy (result, str_value);
+        return;
+    }
+
+    snprintf (str_value, sizeof (str_value),
+              "%s%s=%lld",
+              ((*result)[0]) ? "," : "",
+              name,
+              value);
+    string_dyn_concat (result, str_value, -1);
+}
+
+/*
+ * Return main loop stats as a string, for info "weechat_loop".
+ *
+ * If name is NULL or empty, all stats are returned as a comma-separated list
+ * of "name=value", otherwise only the value of this stat is returned (NULL
+ * if the stat is not found).
+ *
+ * Names of stats are "enabled", "stall", "iterations", "stalls" and for each
+ * phase (timer, refresh, fd, process, signal, wait, iteration,
+ * timer_lateness): "<phase>_count", "<phase>_total", "<phase>_avg" and
+ * "<phase>_max" (times are in microseconds).
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+debug_loop_get_info (const char *name)
+{
+    char **result, str_name[128];
+    int i;
+
+    result = string_dyn_alloc (1024);
+    if (!result)
+        return NULL;
+
+    debug_loop_info_add (result, name, "enabled", debug_loop_enabled);
+    debug_loop_info_add (result, name, "stall", debug_loop_stall);
+    debug_loop_info_add (result, name, "iterations", debug_loop_iterations);
+    debug_loop_info_add (result, name, "stalls", debug_loop_stalls);
+
+    for (i = 0; i < DEBUG_LOOP_NUM_STATS; i++)
+    {
+        snprintf (str_name, sizeof (str_name),
+                  "%s_count", debug_loop_stats_name[i]);
+        debug_loop_info_add (result, name, str_name,
+                             debug_loop_stats[i].count);
+        snprintf (str_name, sizeof (str_name),
+                  "%s_total", debug_loop_stats_name[i]);
+        debug_loop_info_add (result, name, str_name,
+                             debug_loop_stats[i].time_total);
+        snprintf (str_name, sizeof (str_name),
+                  "%s_avg", debug_loop_stats_name[i]);
+        debug_loop_info_add (result, name, str_name,
+                             (debug_loop_stats[i].count > 0) ?
+                             debug_loop_stats[i].time_total
+                             / debug_loop_stats[i].count : 0);
+        snprintf (str_name, sizeof (str_name),
+                  "%s_max", debug_loop_stats_name[i]);
+        debug_loop_info_add (result, name, str_name,
+                             debug_loop_stats[i].time_max);
+    }
+
+    if (name && name[0] && !(*result)[0])
+    {
+        string_dyn_free (result, 1);
+        return NULL;
+    }
+
+    return string_dyn_free (result, 0);
+}
+
+/*
+ * Display main loop stats.
+ */
+
+void
+debug_loop_display (void)
+{
+    char *str_stall;
+    int i;
+
+    str_stall = (debug_loop_stall > 0) ?
+        util_get_microseconds_string ((unsigned long long)debug_loop_stall) :
+        NULL;
+
+    gui_chat_printf (NULL, "");
+    gui_chat_printf (NULL,
+                     "main loop (%s, stall threshold: %s, iterations: %lld, "
+                     "stalls: %lld, times in microseconds):",
+                     (debug_loop_enabled) ? "enabled" : "disabled",
+                     (str_stall) ? str_stall : "-",
+                     debug_loop_iterations,
+                     debug_loop_stalls);
+    free (str_stall);
+
+    gui_chat_printf (NULL,
+                     "  %-15s %10s %14s %10s %10s  %s",
+                     "", "count", "total", "avg", "max",
+                     "<100us/<1ms/<10ms/<100ms/<1s/>=1s");
+    for (i = 0; i < DEBUG_LOOP_NUM_STATS; i++)
+    {
+        gui_chat_printf (NULL,
+                         "  %-15s %10lld %14lld %10lld %10lld  "
+                         "%lld/%lld/%lld/%lld/%lld/%lld",
+                         debug_loop_stats_name[i],
+                         debug_loop_stats[i].count,
+                         debug_loop_stats[i].time_total,
+                         (debug_loop_stats[i].count > 0) ?
+                         debug_loop_stats[i].time_total
+                         / debug_loop_stats[i].count : 0,
+                         debug_loop_stats[i].time_max,
+                         debug_loop_stats[i].histogram[0],
+                         debug_loop_stats[i].histogram[1],
+                         debug_loop_stats[i].histogram[2],
+                         debug_loop_stats[i].histogram[3],
+                         debug_loop_stats[i].histogram[4],
+                         debug_loop_stats[i].histogram[5]);
+    }
+}
+
 /*
  * Display a list of infolists in memory.
  */
@@ -764,6 +1318,9 @@ debug_libs_cb (const void *pointer, void *data,
     const char *version_gnutls = GNUTLS_VERSION;
     const char *version_libcurl = LIBCURL_VERSION;
     const char *version_zlib = ZLIB_VERSION;
+#ifdef HAVE_PCRE2
+    uint32_t pcre2_jit;
+#endif
 
     /* make C compiler happy */
     (void) pointer;
@@ -817,6 +1374,18 @@ debug_libs_cb (const void *pointer, void *data,
     gui_chat_printf (NULL, "    cJSON: %s", _("not available"));
 #endif /* HAVE_CJSON */
 
+    /* display PCRE2 version */
+#ifdef HAVE_PCRE2
+    if (pcre2_config (PCRE2_CONFIG_JIT, &pcre2_jit) != 0)
+        pcre2_jit = 0;
+    gui_chat_printf (NULL, "    pcre2: %d.%d (JIT: %s)",
+                     PCRE2_MAJOR,
+                     PCRE2_MINOR,
+                     (pcre2_jit) ? _("yes") : _("no"));
+#else
+    gui_chat_printf (NULL, "    pcre2: %s", _("not available"));
+#endif /* HAVE_PCRE2 */
+
     return WEECHAT_RC_OK;
 }
 
@@ -856,6 +1425,48 @@ debug_directories (void)
     gui_chat_printf (NULL, "  locale: %s", LOCALEDIR);
 }
 
+/*
+ * Display stats about last read of configuration files (useful to measure
+ * time spent to read configuration files on startup).
+ */
+
+void
+debug_config_files (void)
+{
+    struct t_config_file *ptr_config;
+    long long total_size, total_time;
+    int total_lines;
+
+    gui_chat_printf (NULL, "");
+    gui_chat_printf (NULL,
+                     "configuration files (last read, times in microseconds):");
+    gui_chat_printf (NULL,
+                     "  %6s %10s %12s %10s  %s",
+                     "reads", "lines", "bytes", "time", "file");
+
+    total_lines = 0;
+    total_size = 0;
+    total_time = 0;
+    for (ptr_config = config_files; ptr_config;
+         ptr_config = ptr_config->next_config)
+    {
+        gui_chat_printf (NULL,
+                         "  %6d %10d %12lld %10lld  %s",
+                         ptr_config->read_count,
+                         ptr_config->read_lines,
+                         ptr_config->read_size,
+                         ptr_config->read_time,
+                         ptr_config->filename);
+        total_lines += ptr_config->read_lines;
+        total_size += ptr_config->read_size;
+        total_time += ptr_config->read_time;
+    }
+
+    gui_chat_printf (NULL,
+                     "  %6s %10d %12lld %10lld  %s",
+                     "", total_lines, total_size, total_time, "(total)");
+}
+
 /*
  * Display time elapsed between two times.
  *
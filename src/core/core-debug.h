@@ -25,8 +25,48 @@
 #include <sys/time.h>
 
 struct t_gui_window_tree;
+struct t_hook;
+
+/* main loop instrumentation is active (stats or stall detection enabled) */
+#define DEBUG_LOOP_ACTIVE (debug_loop_enabled || (debug_loop_stall > 0))
+
+/* buckets: < 100us, < 1ms, < 10ms, < 100ms, < 1s, >= 1s */
+#define DEBUG_LOOP_NUM_BUCKETS 6
+
+enum t_debug_loop_stat
+{
+    /* phases of main loop */
+    DEBUG_LOOP_PHASE_TIMER = 0,        /* execution of timers               */
+    DEBUG_LOOP_PHASE_REFRESH,          /* refresh of screen                 */
+    DEBUG_LOOP_PHASE_FD,               /* callbacks of fd hooks             */
+    DEBUG_LOOP_PHASE_PROCESS,          /* run of processes (fork)           */
+    DEBUG_LOOP_PHASE_SIGNAL,           /* handle of signals received        */
+    DEBUG_LOOP_PHASE_WAIT,             /* wait for activity on fd (idle)    */
+    /* number of phases */
+    DEBUG_LOOP_NUM_PHASES,
+    /* other stats */
+    DEBUG_LOOP_STAT_ITERATION = DEBUG_LOOP_NUM_PHASES, /* iteration (no wait)*/
+    DEBUG_LOOP_STAT_TIMER_LATENESS,    /* delay between scheduled date of   */
+                                       /* timer and its execution           */
+    /* number of stats */
+    DEBUG_LOOP_NUM_STATS,
+};
+
+struct t_debug_loop_stats
+{
+    long long count;                   /* number of values                  */
+    long long time_total;              /* sum of values (in microseconds)   */
+    long long time_max;                /* max value (in microseconds)       */
+    long long histogram[DEBUG_LOOP_NUM_BUCKETS]; /* number of values by     */
+                                                 /* bucket                  */
+};
 
 extern long long debug_long_callbacks;
+extern int debug_loop_enabled;
+extern long long debug_loop_stall;
+extern long long debug_loop_iterations;
+extern long long debug_loop_stalls;
+extern struct t_debug_loop_stats debug_loop_stats[];
 
 extern void debug_build_info (void);
 extern void debug_sigsegv_cb (int signo);
@@ -34,10 +74,20 @@ extern void debug_windows_tree (void);
 extern void debug_memory (void);
 extern void debug_hdata (void);
 extern void debug_hooks (void);
+extern void debug_hooks_profile (const char *sort);
 extern void debug_hooks_plugin_types (const char *plugin_name,
                                       const char **hook_types);
+extern void debug_loop_start (void);
+extern void debug_loop_mark (enum t_debug_loop_stat phase);
+extern void debug_loop_add_callback (struct t_hook *hook, long long time);
+extern void debug_loop_add_timer_lateness (long long time);
+extern void debug_loop_end (void);
+extern void debug_loop_reset (void);
+extern char *debug_loop_get_info (const char *name);
+extern void debug_loop_display (void);
 extern void debug_infolists (void);
 extern void debug_directories (void);
+extern void debug_config_files (void);
 extern void debug_display_time_elapsed (struct timeval *time1,
                                         struct timeval *time2,
                                         const char *message,
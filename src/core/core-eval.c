@@ -91,8 +91,19 @@ char *eval_range_chars[][2] =
     { NULL,     NULL },
 };
 
+const char *eval_no_replace_prefix_list_std[] =
+{ "if:", "raw:", "raw_hl:", NULL };
+const char *eval_no_replace_prefix_list_col[] =
+{ "raw:", "raw_hl:", NULL };
+
+struct t_hashtable *eval_hashtable_compiled = NULL; /* compiled expressions */
+struct t_eval_compiled *eval_compiled_first = NULL; /* most recently used   */
+struct t_eval_compiled *eval_compiled_last = NULL;  /* least recently used  */
+
 char *eval_replace_vars (const char *expr,
                          struct t_eval_context *eval_context);
+char *eval_replace_vars_cached (const char *expr,
+                                struct t_eval_context *eval_context);
 char *eval_expression_condition (const char *expr,
                                  struct t_eval_context *eval_context);
 
@@ -1228,6 +1239,7 @@ eval_hdata_get_value (struct t_hdata *hdata, void *pointer, const char *path,
     const char *ptr_value, *hdata_name, *ptr_var_name, *pos, *pos_open_paren;
     int type, debug_id;
     struct t_hashtable *hashtable;
+    struct t_hdata_path *ptr_path;
 
     EVAL_DEBUG_MSG(1, "eval_hdata_get_value(\"%s\", 0x%lx, \"%s\")",
                    (hdata) ? hdata->name : "(null)",
@@ -1255,6 +1267,20 @@ eval_hdata_get_value (struct t_hdata *hdata, void *pointer, const char *path,
     if (!hdata)
         goto end;
 
+    /*
+     * without debug, use the compiled path (kept in cache of hdata), so that
+     * names of variables are not searched again in hdata
+     */
+    if (eval_context->debug_level == 0)
+    {
+        ptr_path = hdata_path_get_cached (hdata, path);
+        if (ptr_path)
+        {
+            value = hdata_path_get_value (ptr_path, pointer);
+            goto end;
+        }
+    }
+
     /*
      * look for name of hdata, for example in "window.buffer.full_name", the
      * hdata name is "window"
@@ -1746,7 +1772,7 @@ eval_replace_vars_cb (void *data,
                 if (!tmp)
                     goto end;
                 hashtable_remove (eval_context->extra_vars, text);
-                value = eval_replace_vars (tmp, eval_context);
+                value = eval_replace_vars_cached (tmp, eval_context);
                 hashtable_set (eval_context->extra_vars, text, tmp);
                 free (tmp);
                 goto end;
@@ -2093,8 +2119,6 @@ end:
 char *
 eval_replace_vars (const char *expr, struct t_eval_context *eval_context)
 {
-    const char *no_replace_prefix_list_std[] = { "if:", "raw:", "raw_hl:", NULL };
-    const char *no_replace_prefix_list_col[] = { "raw:", "raw_hl:", NULL };
     char *result;
     int debug_id;
 
@@ -2110,7 +2134,7 @@ eval_replace_vars (const char *expr, struct t_eval_context *eval_context)
             eval_context->suffix,
             (eval_context->syntax_highlight) ? 0 : 1,
             (eval_context->syntax_highlight) ?
-            no_replace_prefix_list_col : no_replace_prefix_list_std,
+            eval_no_replace_prefix_list_col : eval_no_replace_prefix_list_std,
             &eval_replace_vars_cb,
             eval_context,
             NULL);
@@ -2497,12 +2521,799 @@ end:
     return value;
 }
 
+/*
+ * Create a new node of compiled expression.
+ *
+ * Return pointer to new node, NULL if error.
+ */
+
+struct t_eval_node *
+eval_node_new (enum t_eval_node_type type, const char *text, int length)
+{
+    struct t_eval_node *new_node;
+
+    new_node = calloc (1, sizeof (*new_node));
+    if (!new_node)
+        return NULL;
+
+    new_node->type = type;
+    if (text)
+    {
+        new_node->text = string_strndup (text, length);
+        if (!new_node->text)
+        {
+            free (new_node);
+            return NULL;
+        }
+        new_node->length = length;
+    }
+
+    return new_node;
+}
+
+/*
+ * Free a node of compiled expression and its children.
+ */
+
+void
+eval_node_free (struct t_eval_node *node)
+{
+    int i;
+
+    if (!node)
+        return;
+
+    for (i = 0; i < node->count; i++)
+    {
+        eval_node_free (node->children[i]);
+    }
+    free (node->children);
+    free (node->text);
+
+    free (node);
+}
+
+/*
+ * Add a child to a node of compiled expression.
+ *
+ * If the child can not be added, it is freed.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+eval_node_add_child (struct t_eval_node *node, struct t_eval_node *child)
+{
+    struct t_eval_node **new_children;
+
+    if (!child)
+        return 0;
+
+    new_children = realloc (node->children,
+                            (node->count + 1) * sizeof (*new_children));
+    if (!new_children)
+    {
+        eval_node_free (child);
+        return 0;
+    }
+    node->children = new_children;
+    node->children[node->count] = child;
+    node->count++;
+
+    return 1;
+}
+
+/*
+ * Add a text node (if text is not empty) to a node of compiled expression
+ * and reset the text.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+eval_node_add_text (struct t_eval_node *node, char **text)
+{
+    int rc;
+
+    if (!(*text)[0])
+        return 1;
+
+    rc = eval_node_add_child (
+        node,
+        eval_node_new (EVAL_NODE_TEXT, *text, strlen (*text)));
+    string_dyn_copy (text, NULL);
+
+    return rc;
+}
+
+/*
+ * Compile a string with variables to replace: the string is split into
+ * texts and variables, the same way function string_replace_with_callback
+ * does (with escape of prefix allowed).
+ *
+ * Return pointer to node of type EVAL_NODE_REPLACE, NULL if error.
+ */
+
+struct t_eval_node *
+eval_compile_replace_vars (const char *string,
+                           struct t_eval_context *eval_context)
+{
+    struct t_eval_node *node, *ptr_var;
+    const char *pos_end_name;
+    char **text, str[2];
+    int index_string, sub_count, sub_level, replace, i;
+
+    node = eval_node_new (EVAL_NODE_REPLACE, string, strlen (string));
+    if (!node)
+        return NULL;
+
+    text = string_dyn_alloc (64);
+    if (!text)
+        goto error;
+
+    index_string = 0;
+    while (string[index_string])
+    {
+        if ((string[index_string] == '\\')
+            && (string[index_string + 1] == eval_context->prefix[0]))
+        {
+            index_string++;
+            str[0] = string[index_string++];
+            str[1] = '\0';
+            string_dyn_concat (text, str, -1);
+        }
+        else if (strncmp (string + index_string, eval_context->prefix,
+                          eval_context->length_prefix) == 0)
+        {
+            sub_count = 0;
+            sub_level = 0;
+            pos_end_name = string + index_string + eval_context->length_prefix;
+            while (pos_end_name[0])
+            {
+                if (strncmp (pos_end_name, eval_context->suffix,
+                             eval_context->length_suffix) == 0)
+                {
+                    if (sub_level == 0)
+                        break;
+                    sub_level--;
+                }
+                if ((pos_end_name[0] == '\\')
+                    && (pos_end_name[1] == eval_context->prefix[0]))
+                {
+                    pos_end_name++;
+                }
+                else if (strncmp (pos_end_name, eval_context->prefix,
+                                  eval_context->length_prefix) == 0)
+                {
+                    sub_count++;
+                    sub_level++;
+                }
+                pos_end_name++;
+            }
+            if (!eval_node_add_text (node, text))
+                goto error;
+            ptr_var = eval_node_new (
+                EVAL_NODE_VARIABLE,
+                string + index_string + eval_context->length_prefix,
+                pos_end_name - (string + index_string + eval_context->length_prefix));
+            if (!eval_node_add_child (node, ptr_var))
+                goto error;
+            ptr_var->offset = index_string;
+            ptr_var->has_suffix = (pos_end_name[0]) ? 1 : 0;
+            if (sub_count > 0)
+            {
+                replace = 1;
+                for (i = 0; eval_no_replace_prefix_list_std[i]; i++)
+                {
+                    if (strncmp (ptr_var->text,
+                                 eval_no_replace_prefix_list_std[i],
+                                 strlen (eval_no_replace_prefix_list_std[i])) == 0)
+                    {
+                        replace = 0;
+                        break;
+                    }
+                }
+                if (replace
+                    && !eval_node_add_child (
+                        ptr_var,
+                        eval_compile_replace_vars (ptr_var->text,
+                                                   eval_context)))
+                {
+                    goto error;
+                }
+            }
+            index_string = pos_end_name - string;
+            if (pos_end_name[0])
+                index_string += eval_context->length_suffix;
+        }
+        else
+        {
+            str[0] = string[index_string++];
+            str[1] = '\0';
+            string_dyn_concat (text, str, -1);
+        }
+    }
+
+    if (!eval_node_add_text (node, text))
+        goto error;
+
+    string_dyn_free (text, 1);
+
+    return node;
+
+error:
+    string_dyn_free (text, 1);
+    eval_node_free (node);
+    return NULL;
+}
+
+/*
+ * Compile a condition: the condition is split into logical operators,
+ * comparisons and texts with variables to replace, the same way function
+ * eval_expression_condition does.
+ *
+ * Return pointer to root node, NULL if error.
+ */
+
+struct t_eval_node *
+eval_compile_condition (const char *expr, struct t_eval_context *eval_context)
+{
+    struct t_eval_node *node;
+    int logic, comp, level;
+    const char *pos, *pos_end;
+    char *expr2, *sub_expr;
+
+    node = NULL;
+    expr2 = NULL;
+
+    /* skip spaces at beginning of string */
+    while (expr[0] == ' ')
+    {
+        expr++;
+    }
+    if (!expr[0])
+        return eval_node_new (EVAL_NODE_TEXT, "", 0);
+
+    /* skip spaces at end of string */
+    pos_end = expr + strlen (expr) - 1;
+    while ((pos_end > expr) && (pos_end[0] == ' '))
+    {
+        pos_end--;
+    }
+
+    expr2 = string_strndup (expr, pos_end + 1 - expr);
+    if (!expr2)
+        return NULL;
+
+    /* logical operator: compile the two sub-expressions */
+    for (logic = 0; logic < EVAL_NUM_LOGICAL_OPS; logic++)
+    {
+        pos = eval_strstr_level (expr2, eval_logical_ops[logic], eval_context,
+                                 "(", ")", 0);
+        if (pos > expr2)
+        {
+            pos_end = pos - 1;
+            while ((pos_end > expr2) && (pos_end[0] == ' '))
+            {
+                pos_end--;
+            }
+            sub_expr = string_strndup (expr2, pos_end + 1 - expr2);
+            if (!sub_expr)
+                goto error;
+            pos += strlen (eval_logical_ops[logic]);
+            while (pos[0] == ' ')
+            {
+                pos++;
+            }
+            node = eval_node_new (EVAL_NODE_LOGICAL_OP, NULL, 0);
+            if (node)
+            {
+                node->op = logic;
+                if (eval_node_add_child (
+                        node, eval_compile_condition (sub_expr, eval_context)))
+                {
+                    eval_node_add_child (
+                        node, eval_compile_condition (pos, eval_context));
+                }
+            }
+            free (sub_expr);
+            if (!node || (node->count != 2))
+                goto error;
+            goto end;
+        }
+    }
+
+    /* comparison: compile the two sub-expressions */
+    for (comp = 0; comp < EVAL_NUM_COMPARISONS; comp++)
+    {
+        pos = eval_strstr_level (expr2, eval_comparisons[comp], eval_context,
+                                 "(", ")", 0);
+        if (pos >= expr2)
+        {
+            if (pos > expr2)
+            {
+                pos_end = pos - 1;
+                while ((pos_end > expr2) && (pos_end[0] == ' '))
+                {
+                    pos_end--;
+                }
+                sub_expr = string_strndup (expr2, pos_end + 1 - expr2);
+            }
+            else
+            {
+                sub_expr = strdup ("");
+            }
+            if (!sub_expr)
+                goto error;
+            pos += strlen (eval_comparisons[comp]);
+            while (pos[0] == ' ')
+            {
+                pos++;
+            }
+            node = eval_node_new (EVAL_NODE_COMPARISON, NULL, 0);
+            if (node)
+            {
+                node->op = comp;
+                if ((comp == EVAL_COMPARE_REGEX_MATCHING)
+                    || (comp == EVAL_COMPARE_REGEX_NOT_MATCHING))
+                {
+                    /* for regex: just replace vars in both expressions */
+                    if (eval_node_add_child (
+                            node,
+                            eval_compile_replace_vars (sub_expr, eval_context)))
+                    {
+                        eval_node_add_child (
+                            node,
+                            eval_compile_replace_vars (pos, eval_context));
+                    }
+                }
+                else
+                {
+                    if (eval_node_add_child (
+                            node,
+                            eval_compile_condition (sub_expr, eval_context)))
+                    {
+                        eval_node_add_child (
+                            node,
+                            eval_compile_condition (pos, eval_context));
+                    }
+                }
+            }
+            free (sub_expr);
+            if (!node || (node->count != 2))
+                goto error;
+            goto end;
+        }
+    }
+
+    /*
+     * sub-expression between parentheses: if there is nothing around
+     * parentheses, the value is the value of sub-expression, otherwise the
+     * value of sub-expression is inserted in the string, which is evaluated
+     * again (so it can not be compiled)
+     */
+    if (expr2[0] == '(')
+    {
+        level = 0;
+        pos = expr2 + 1;
+        while (pos[0])
+        {
+            if (pos[0] == '(')
+                level++;
+            else if (pos[0] == ')')
+            {
+                if (level == 0)
+                    break;
+                level--;
+            }
+            pos++;
+        }
+        if (pos[0] != ')')
+        {
+            /* closing parenthesis not found */
+            node = eval_node_new (EVAL_NODE_NULL, NULL, 0);
+        }
+        else if (pos[1])
+        {
+            node = eval_node_new (EVAL_NODE_CONDITION, expr2, strlen (expr2));
+        }
+        else
+        {
+            sub_expr = string_strndup (expr2 + 1, pos - expr2 - 1);
+            if (!sub_expr)
+                goto error;
+            node = eval_compile_condition (sub_expr, eval_context);
+            free (sub_expr);
+        }
+        goto end;
+    }
+
+    /* no logical operator neither comparison: just replace variables */
+    node = eval_compile_replace_vars (expr2, eval_context);
+    goto end;
+
+error:
+    eval_node_free (node);
+    node = NULL;
+
+end:
+    free (expr2);
+    return node;
+}
+
+/*
+ * Evaluate a compiled string with variables to replace (node of type
+ * EVAL_NODE_REPLACE), without check on recursion.
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+eval_node_replace (struct t_eval_node *node,
+                   struct t_eval_context *eval_context)
+{
+    struct t_eval_node *ptr_child;
+    char **result, *key, *value, str[2];
+    const char *ptr_key;
+    int i;
+
+    result = string_dyn_alloc (node->length + 1);
+    if (!result)
+        return NULL;
+
+    for (i = 0; i < node->count; i++)
+    {
+        ptr_child = node->children[i];
+        if (ptr_child->type == EVAL_NODE_TEXT)
+        {
+            string_dyn_concat (result, ptr_child->text, -1);
+            continue;
+        }
+        key = NULL;
+        if (ptr_child->count > 0)
+        {
+            key = eval_node_replace (ptr_child->children[0], eval_context);
+            ptr_key = key;
+        }
+        else
+        {
+            ptr_key = ptr_child->text;
+        }
+        value = eval_replace_vars_cb (
+            eval_context,
+            eval_context->prefix,
+            (ptr_key) ? ptr_key : "",
+            (ptr_child->has_suffix) ? eval_context->suffix : "");
+        free (key);
+        if (!value)
+        {
+            /*
+             * variable not replaced: keep first char of prefix and replace
+             * variables in the rest of string, starting after this char
+             */
+            str[0] = node->text[ptr_child->offset];
+            str[1] = '\0';
+            string_dyn_concat (result, str, -1);
+            value = string_replace_with_callback (
+                node->text + ptr_child->offset + 1,
+                eval_context->prefix,
+                eval_context->suffix,
+                1,
+                eval_no_replace_prefix_list_std,
+                &eval_replace_vars_cb,
+                eval_context,
+                NULL);
+            if (value)
+                string_dyn_concat (result, value, -1);
+            free (value);
+            break;
+        }
+        if (value[0])
+            string_dyn_concat (result, value, -1);
+        free (value);
+    }
+
+    return string_dyn_free (result, 0);
+}
+
+/*
+ * Evaluate a compiled string with variables to replace (same as function
+ * eval_replace_vars).
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+eval_node_replace_vars (struct t_eval_node *node,
+                        struct t_eval_context *eval_context)
+{
+    char *result;
+
+    eval_context->recursion_count++;
+
+    result = (eval_context->recursion_count < EVAL_RECURSION_MAX) ?
+        eval_node_replace (node, eval_context) : strdup ("");
+
+    eval_context->recursion_count--;
+
+    return result;
+}
+
+/*
+ * Evaluate a compiled condition (same as function eval_expression_condition).
+ *
+ * Note: result must be freed after use (if not NULL).
+ */
+
+char *
+eval_node_condition (struct t_eval_node *node,
+                     struct t_eval_context *eval_context)
+{
+    char *value, *value2, *result;
+    int rc;
+
+    switch (node->type)
+    {
+        case EVAL_NODE_TEXT:
+            return strdup (node->text);
+        case EVAL_NODE_REPLACE:
+            return eval_node_replace_vars (node, eval_context);
+        case EVAL_NODE_CONDITION:
+            return eval_expression_condition (node->text, eval_context);
+        case EVAL_NODE_LOGICAL_OP:
+            value = eval_node_condition (node->children[0], eval_context);
+            rc = eval_is_true (value);
+            free (value);
+            /*
+             * if rc == 0 with "&&" or rc == 1 with "||", no need to
+             * evaluate second sub-expression
+             */
+            if ((rc && (node->op == EVAL_LOGICAL_OP_AND))
+                || (!rc && (node->op == EVAL_LOGICAL_OP_OR)))
+            {
+                value = eval_node_condition (node->children[1], eval_context);
+                rc = eval_is_true (value);
+                free (value);
+            }
+            return strdup ((rc) ? EVAL_STR_TRUE : EVAL_STR_FALSE);
+        case EVAL_NODE_COMPARISON:
+            value = eval_node_condition (node->children[0], eval_context);
+            value2 = eval_node_condition (node->children[1], eval_context);
+            result = eval_compare (value, node->op, value2, eval_context);
+            free (value);
+            free (value2);
+            return result;
+        case EVAL_NODE_NULL:
+        case EVAL_NODE_VARIABLE:
+        case EVAL_NUM_NODE_TYPES:
+            break;
+    }
+
+    return NULL;
+}
+
+/*
+ * Free a compiled expression and remove it from cache.
+ */
+
+void
+eval_compiled_free (struct t_eval_compiled *compiled)
+{
+    if (!compiled)
+        return;
+
+    hashtable_remove (eval_hashtable_compiled, compiled->key);
+
+    if (compiled->prev_compiled)
+        (compiled->prev_compiled)->next_compiled = compiled->next_compiled;
+    if (compiled->next_compiled)
+        (compiled->next_compiled)->prev_compiled = compiled->prev_compiled;
+    if (eval_compiled_first == compiled)
+        eval_compiled_first = compiled->next_compiled;
+    if (eval_compiled_last == compiled)
+        eval_compiled_last = compiled->prev_compiled;
+
+    free (compiled->key);
+    eval_node_free (compiled->node);
+
+    free (compiled);
+}
+
+/*
+ * Get compiled expression from cache, compile it if it is not yet in cache.
+ *
+ * The cache is indexed by the type of expression (condition or not), the
+ * prefix, the suffix and the expression itself. It keeps at most
+ * EVAL_CACHE_MAX_SIZE compiled expressions: when it is full, the least
+ * recently used expression (which is not being evaluated) is removed.
+ *
+ * Return pointer to compiled expression, NULL if error.
+ */
+
+struct t_eval_compiled *
+eval_compiled_get (const char *expr, int condition,
+                   struct t_eval_context *eval_context)
+{
+    struct t_eval_compiled *ptr_compiled;
+    struct t_eval_node *node;
+    char *key;
+    int length_expr;
+
+    if (!eval_hashtable_compiled)
+    {
+        eval_hashtable_compiled = hashtable_new (64,
+                                                 WEECHAT_HASHTABLE_STRING,
+                                                 WEECHAT_HASHTABLE_POINTER,
+                                                 NULL,
+                                                 NULL);
+        if (!eval_hashtable_compiled)
+            return NULL;
+    }
+
+    /* key: "c" or "r" + prefix + "\x01" + suffix + "\x01" + expression */
+    length_expr = strlen (expr);
+    key = malloc (1 + eval_context->length_prefix + 1
+                  + eval_context->length_suffix + 1 + length_expr + 1);
+    if (!key)
+        return NULL;
+    key[0] = (condition) ? 'c' : 'r';
+    memcpy (key + 1, eval_context->prefix, eval_context->length_prefix);
+    key[1 + eval_context->length_prefix] = '\x01';
+    memcpy (key + 1 + eval_context->length_prefix + 1,
+            eval_context->suffix, eval_context->length_suffix);
+    key[1 + eval_context->length_prefix + 1 + eval_context->length_suffix] = '\x01';
+    memcpy (key + 1 + eval_context->length_prefix + 1
+            + eval_context->length_suffix + 1,
+            expr, length_expr + 1);
+
+    ptr_compiled = hashtable_get (eval_hashtable_compiled, key);
+    if (ptr_compiled)
+    {
+        free (key);
+        /* move compiled expression at beginning of list */
+        if (ptr_compiled != eval_compiled_first)
+        {
+            (ptr_compiled->prev_compiled)->next_compiled = ptr_compiled->next_compiled;
+            if (ptr_compiled->next_compiled)
+                (ptr_compiled->next_compiled)->prev_compiled = ptr_compiled->prev_compiled;
+            else
+                eval_compiled_last = ptr_compiled->prev_compiled;
+            ptr_compiled->prev_compiled = NULL;
+            ptr_compiled->next_compiled = eval_compiled_first;
+            eval_compiled_first->prev_compiled = ptr_compiled;
+            eval_compiled_first = ptr_compiled;
+        }
+        return ptr_compiled;
+    }
+
+    /* remove the least recently used expression if cache is full */
+    if (eval_hashtable_compiled->items_count >= EVAL_CACHE_MAX_SIZE)
+    {
+        ptr_compiled = eval_compiled_last;
+        while (ptr_compiled && (ptr_compiled->used > 0))
+        {
+            ptr_compiled = ptr_compiled->prev_compiled;
+        }
+        if (!ptr_compiled)
+        {
+            free (key);
+            return NULL;
+        }
+        eval_compiled_free (ptr_compiled);
+    }
+
+    node = (condition) ?
+        eval_compile_condition (expr, eval_context) :
+        eval_compile_replace_vars (expr, eval_context);
+    if (!node)
+    {
+        free (key);
+        return NULL;
+    }
+
+    ptr_compiled = malloc (sizeof (*ptr_compiled));
+    if (!ptr_compiled)
+    {
+        free (key);
+        eval_node_free (node);
+        return NULL;
+    }
+    ptr_compiled->key = key;
+    ptr_compiled->node = node;
+    ptr_compiled->used = 0;
+    ptr_compiled->prev_compiled = NULL;
+    ptr_compiled->next_compiled = eval_compiled_first;
+    if (eval_compiled_first)
+        eval_compiled_first->prev_compiled = ptr_compiled;
+    else
+        eval_compiled_last = ptr_compiled;
+    eval_compiled_first = ptr_compiled;
+
+    if (!hashtable_set (eval_hashtable_compiled, key, ptr_compiled))
+    {
+        eval_compiled_free (ptr_compiled);
+        return NULL;
+    }
+
+    return ptr_compiled;
+}
+
+/*
+ * Replace variables in a string, using the compiled string kept in cache
+ * (the string is compiled on first use).
+ *
+ * With debug or syntax highlighting, the string is not compiled (function
+ * eval_replace_vars is called).
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+eval_replace_vars_cached (const char *expr,
+                          struct t_eval_context *eval_context)
+{
+    struct t_eval_compiled *ptr_compiled;
+    char *result;
+
+    if ((eval_context->debug_level > 0) || eval_context->syntax_highlight)
+        return eval_replace_vars (expr, eval_context);
+
+    ptr_compiled = eval_compiled_get (expr, 0, eval_context);
+    if (!ptr_compiled)
+        return eval_replace_vars (expr, eval_context);
+
+    ptr_compiled->used++;
+    result = eval_node_replace_vars (ptr_compiled->node, eval_context);
+    ptr_compiled->used--;
+
+    return result;
+}
+
+/*
+ * Evaluate a condition, using the compiled condition kept in cache
+ * (the condition is compiled on first use).
+ *
+ * With debug or syntax highlighting, the condition is not compiled (function
+ * eval_expression_condition is called).
+ *
+ * Note: result must be freed after use (if not NULL).
+ */
+
+char *
+eval_expression_condition_cached (const char *expr,
+                                  struct t_eval_context *eval_context)
+{
+    struct t_eval_compiled *ptr_compiled;
+    char *result;
+
+    if ((eval_context->debug_level > 0) || eval_context->syntax_highlight)
+        return eval_expression_condition (expr, eval_context);
+
+    ptr_compiled = eval_compiled_get (expr, 1, eval_context);
+    if (!ptr_compiled)
+        return eval_expression_condition (expr, eval_context);
+
+    ptr_compiled->used++;
+    result = eval_node_condition (ptr_compiled->node, eval_context);
+    ptr_compiled->used--;
+
+    return result;
+}
+
 /*
  * Replace text in a string using a regular expression and replacement text.
  *
  * The argument "regex" is a pointer to a regex compiled with WeeChat function
  * string_regcomp (or function regcomp).
  *
+ * The argument "string_regex" is a pointer to a regex compiled with WeeChat
+ * function string_regex_compile or string_regex_new (PCRE2 is used if
+ * possible); if set, it is used instead of "regex".
+ *
  * The argument "replace" is evaluated and can contain any valid expression,
  * and these ones:
  *   ${re:0} .. ${re:99}  match 0 to 99 (0 is whole match, 1 .. 99 are groups
@@ -2522,7 +3333,8 @@ end:
  */
 
 char *
-eval_replace_regex (const char *string, regex_t *regex, const char *replace,
+eval_replace_regex (const char *string, regex_t *regex,
+                    struct t_string_regex *string_regex, const char *replace,
                     struct t_eval_context *eval_context)
 {
     char *result, *result2, *str_replace;
@@ -2532,10 +3344,11 @@ eval_replace_regex (const char *string, regex_t *regex, const char *replace,
 
     result = NULL;
 
-    EVAL_DEBUG_MSG(1, "eval_replace_regex(\"%s\", 0x%lx, \"%s\")",
-                   string, (unsigned long)regex, replace);
+    EVAL_DEBUG_MSG(1, "eval_replace_regex(\"%s\", 0x%lx, 0x%lx, \"%s\")",
+                   string, (unsigned long)regex, (unsigned long)string_regex,
+                   replace);
 
-    if (!string || !regex || !replace)
+    if (!string || (!regex && !string_regex) || !replace)
         goto end;
 
     result = strdup (string);
@@ -2557,7 +3370,10 @@ eval_replace_regex (const char *string, regex_t *regex, const char *replace,
             eval_regex.match[i].rm_so = -1;
         }
 
-        rc = regexec (regex, result + start_offset, 100, eval_regex.match, 0);
+        rc = (string_regex) ?
+            string_regex_exec (string_regex, result + start_offset, 100,
+                               eval_regex.match, 0) :
+            regexec (regex, result + start_offset, 100, eval_regex.match, 0);
 
         /* no match found: exit the loop */
         if ((rc != 0) || (eval_regex.match[0].rm_so < 0))
@@ -2591,7 +3407,7 @@ eval_replace_regex (const char *string, regex_t *regex, const char *replace,
 
         eval_regex.result = result;
 
-        str_replace = eval_replace_vars (replace, eval_context);
+        str_replace = eval_replace_vars_cached (replace, eval_context);
 
         length_replace = (str_replace) ? strlen (str_replace) : 0;
 
@@ -2691,6 +3507,7 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
     const char *ptr_value, *regex_replace;
     struct t_gui_window *window;
     regex_t *regex;
+    struct t_string_regex *string_regex;
 
     if (!expr)
         return NULL;
@@ -2700,6 +3517,7 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
     pointers_allocated = 0;
     regex_allocated = 0;
     regex = NULL;
+    string_regex = NULL;
     regex_replace = NULL;
     ptr_window_added = 0;
     ptr_buffer_added = 0;
@@ -2707,6 +3525,8 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
     if (pointers)
     {
         regex = (regex_t *)hashtable_get (pointers, "regex");
+        string_regex = (struct t_string_regex *)hashtable_get (pointers,
+                                                               "string_regex");
     }
     else
     {
@@ -2801,17 +3621,10 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
         ptr_value = hashtable_get (options, "regex");
         if (ptr_value)
         {
-            regex = malloc (sizeof (*regex));
-            if (string_regcomp (regex, ptr_value,
-                                REG_EXTENDED | REG_ICASE) == 0)
-            {
-                regex_allocated = 1;
-            }
-            else
-            {
-                free (regex);
-                regex = NULL;
-            }
+            regex = NULL;
+            string_regex = string_regex_new (ptr_value,
+                                             REG_EXTENDED | REG_ICASE);
+            regex_allocated = 1;
         }
 
         /* check for regex replacement (evaluated later) */
@@ -2839,23 +3652,23 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
     if (condition)
     {
         /* evaluate as condition (return a boolean: "0" or "1") */
-        value = eval_expression_condition (expr, eval_context);
+        value = eval_expression_condition_cached (expr, eval_context);
         rc = eval_is_true (value);
         free (value);
         value = strdup ((rc) ? EVAL_STR_TRUE : EVAL_STR_FALSE);
     }
     else
     {
-        if (regex && regex_replace)
+        if ((regex || string_regex) && regex_replace)
         {
             /* replace with regex */
-            value = eval_replace_regex (expr, regex, regex_replace,
-                                        eval_context);
+            value = eval_replace_regex (expr, regex, string_regex,
+                                        regex_replace, eval_context);
         }
         else
         {
             /* only replace variables in expression */
-            value = eval_replace_vars (expr, eval_context);
+            value = eval_replace_vars_cached (expr, eval_context);
         }
     }
 
@@ -2871,10 +3684,10 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
             hashtable_remove (pointers, "buffer");
     }
     hashtable_free (user_vars);
-    if (regex && regex_allocated)
+    if (string_regex && regex_allocated)
     {
-        regfree (regex);
-        free (regex);
+        string_regex_free (string_regex);
+        free (string_regex);
     }
 
     EVAL_DEBUG_RESULT(1, value);
@@ -2886,3 +3699,21 @@ eval_expression (const char *expr, struct t_hashtable *pointers,
 
     return value;
 }
+
+/*
+ * Free all compiled expressions kept in cache.
+ */
+
+void
+eval_end (void)
+{
+    while (eval_compiled_first)
+    {
+        eval_compiled_free (eval_compiled_first);
+    }
+    if (eval_hashtable_compiled)
+    {
+        hashtable_free (eval_hashtable_compiled);
+        eval_hashtable_compiled = NULL;
+    }
+}
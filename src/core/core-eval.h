@@ -32,6 +32,8 @@
 
 #define EVAL_RECURSION_MAX  32
 
+#define EVAL_CACHE_MAX_SIZE 256
+
 #define EVAL_RANGE_DIGIT    "0123456789"
 #define EVAL_RANGE_XDIGIT   EVAL_RANGE_DIGIT "abcdefABCDEF"
 #define EVAL_RANGE_LOWER    "abcdefghijklmnopqrstuvwxyz"
@@ -75,6 +77,40 @@ enum t_eval_comparison
     EVAL_NUM_COMPARISONS,
 };
 
+enum t_eval_node_type
+{
+    EVAL_NODE_NULL = 0,                /* invalid condition (NULL value)    */
+    EVAL_NODE_TEXT,                    /* text (no variable)                */
+    EVAL_NODE_VARIABLE,                /* variable: ${...}                  */
+    EVAL_NODE_REPLACE,                 /* text and variables to replace     */
+    EVAL_NODE_LOGICAL_OP,              /* logical operator: "&&" or "||"    */
+    EVAL_NODE_COMPARISON,              /* comparison: "==", "=~", ...       */
+    EVAL_NODE_CONDITION,               /* condition evaluated as string     */
+    /* number of node types */
+    EVAL_NUM_NODE_TYPES,
+};
+
+struct t_eval_node
+{
+    enum t_eval_node_type type;        /* type of node                      */
+    char *text;                        /* text of node (see below)          */
+    int length;                        /* length of text                    */
+    int offset;                        /* variable: offset in parent text   */
+    int has_suffix;                    /* variable: 1 if suffix was found   */
+    int op;                            /* logical operator or comparison    */
+    int count;                         /* number of children                */
+    struct t_eval_node **children;     /* children nodes                    */
+};
+
+struct t_eval_compiled
+{
+    char *key;                         /* key in cache (type + expression)  */
+    struct t_eval_node *node;          /* root node                         */
+    int used;                          /* > 0 if being evaluated            */
+    struct t_eval_compiled *prev_compiled; /* link to prev. (more recent)   */
+    struct t_eval_compiled *next_compiled; /* link to next (less recent)    */
+};
+
 struct t_eval_regex
 {
     const char *result;
@@ -103,10 +139,15 @@ struct t_eval_context
     char **debug_output;               /* string with debug output          */
 };
 
+extern struct t_hashtable *eval_hashtable_compiled;
+extern struct t_eval_compiled *eval_compiled_first;
+extern struct t_eval_compiled *eval_compiled_last;
+
 extern int eval_is_true (const char *value);
 extern char *eval_expression (const char *expr,
                               struct t_hashtable *pointers,
                               struct t_hashtable *extra_vars,
                               struct t_hashtable *options);
+extern void eval_end (void);
 
 #endif /* WEECHAT_EVAL_H */
@@ -27,8 +27,11 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
 
 #include "weechat.h"
 #include "core-hashtable.h"
@@ -63,6 +66,44 @@
  */
 #define HASHTABLE_MIN_SIZE 8
 
+/*
+ * Compact backend: number of entries allocated for a size of "indices"
+ * (max load factor is 2/3, so that a probe sequence always ends quickly
+ * on a free slot).
+ */
+#define HASHTABLE_COMPACT_CAPACITY(__size) (((__size) * 2) / 3)
+
+/*
+ * Compact backend: shrink the arrays when the number of items falls below
+ * size / HASHTABLE_COMPACT_SHRINK_FACTOR; after a rebuild the load factor
+ * is at most 1/3, so the gap with the shrink threshold prevents a
+ * grow/shrink loop when adding/removing a single item.
+ */
+#define HASHTABLE_COMPACT_SHRINK_FACTOR 12
+
+/* compact backend: values for slots of "indices" */
+#define HASHTABLE_COMPACT_SLOT_FREE    -1
+#define HASHTABLE_COMPACT_SLOT_REMOVED -2
+
+/* constants for hash of keys (same as in wyhash) */
+#define HASHTABLE_HASH_SECRET0 0xa0761d6478bd642fULL
+#define HASHTABLE_HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define HASHTABLE_HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+
+
+/* callback and data for hashtable_map_string */
+struct t_hashtable_map_string_data
+{
+    t_hashtable_map_string *callback_map;
+    void *callback_map_data;
+};
+
+/*
+ * random seed for hash of keys, set when the first hashtable is created:
+ * the hashes (and thus the collisions) can not be predicted from outside,
+ * which prevents collision flooding with keys received from the network
+ */
+unsigned long long hashtable_seed = 0;
 
 char *hashtable_type_string[HASHTABLE_NUM_TYPES] =
 { WEECHAT_HASHTABLE_INTEGER,
@@ -121,6 +162,184 @@ hashtable_hash_key_djb2 (const char *string)
     return hash;
 }
 
+/*
+ * Initialize the random seed used to hash keys (if not already done).
+ */
+
+void
+hashtable_init_seed (void)
+{
+    FILE *file;
+    struct timeval tv;
+    uint64_t seed;
+    size_t num_read;
+
+    if (hashtable_seed)
+        return;
+
+    seed = 0;
+    file = fopen ("/dev/urandom", "rb");
+    if (file)
+    {
+        num_read = fread (&seed, 1, sizeof (seed), file);
+        fclose (file);
+        if (num_read != sizeof (seed))
+            seed = 0;
+    }
+    if (!seed)
+    {
+        /* fallback: mix current time, PID and an address */
+        gettimeofday (&tv, NULL);
+        seed = ((uint64_t)tv.tv_sec << 32) ^ (uint64_t)tv.tv_usec
+            ^ ((uint64_t)getpid () << 16) ^ (uint64_t)(uintptr_t)&seed;
+    }
+
+    /* the seed must never be 0 (it means "not initialized") */
+    hashtable_seed = (seed) ? seed : HASHTABLE_HASH_SECRET2;
+}
+
+/*
+ * Multiply two 64-bit integers and mix the 128-bit result into a 64-bit
+ * integer.
+ */
+
+uint64_t
+hashtable_hash_mix (uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t result;
+
+    result = (__uint128_t)a * b;
+    return (uint64_t)result ^ (uint64_t)(result >> 64);
+#else
+    uint64_t a_high, a_low, b_high, b_low, low_low, high_low, low_high;
+    uint64_t high_high, low, high, carry;
+
+    a_high = a >> 32;
+    a_low = (uint32_t)a;
+    b_high = b >> 32;
+    b_low = (uint32_t)b;
+    high_high = a_high * b_high;
+    high_low = a_high * b_low;
+    low_high = a_low * b_high;
+    low_low = a_low * b_low;
+    low = low_low + (high_low << 32);
+    carry = (low < low_low) ? 1 : 0;
+    high = high_high + (high_low >> 32) + carry;
+    low_low = low;
+    low += (low_high << 32);
+    carry = (low < low_low) ? 1 : 0;
+    high += (low_high >> 32) + carry;
+    return low ^ high;
+#endif
+}
+
+/*
+ * Read 8 bytes (unaligned) as a 64-bit integer.
+ */
+
+uint64_t
+hashtable_hash_read64 (const unsigned char *ptr)
+{
+    uint64_t value;
+
+    memcpy (&value, ptr, sizeof (value));
+    return value;
+}
+
+/*
+ * Read 4 bytes (unaligned) as a 64-bit integer.
+ */
+
+uint64_t
+hashtable_hash_read32 (const unsigned char *ptr)
+{
+    uint32_t value;
+
+    memcpy (&value, ptr, sizeof (value));
+    return value;
+}
+
+/*
+ * Hash a string with the random seed (function derived from wyhash): the
+ * string is read 8 or 16 bytes at a time, and its length is computed with
+ * strlen (which is vectorized in the C library).
+ *
+ * Return the hash of the string.
+ */
+
+unsigned long long
+hashtable_hash_key_string (const char *string)
+{
+    const unsigned char *ptr;
+    uint64_t seed, a, b;
+    size_t length, remaining;
+
+    if (!string)
+        return 0ULL;
+
+    length = strlen (string);
+    ptr = (const unsigned char *)string;
+    seed = hashtable_seed ^ hashtable_hash_mix (
+        hashtable_seed ^ HASHTABLE_HASH_SECRET0, HASHTABLE_HASH_SECRET1);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            a = (hashtable_hash_read32 (ptr) << 32)
+                | hashtable_hash_read32 (ptr + ((length >> 3) << 2));
+            b = (hashtable_hash_read32 (ptr + length - 4) << 32)
+                | hashtable_hash_read32 (ptr + length - 4 - ((length >> 3) << 2));
+        }
+        else if (length > 0)
+        {
+            a = ((uint64_t)ptr[0] << 16) | ((uint64_t)ptr[length >> 1] << 8)
+                | (uint64_t)ptr[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        remaining = length;
+        while (remaining > 16)
+        {
+            seed = hashtable_hash_mix (
+                hashtable_hash_read64 (ptr) ^ HASHTABLE_HASH_SECRET1,
+                hashtable_hash_read64 (ptr + 8) ^ seed);
+            ptr += 16;
+            remaining -= 16;
+        }
+        a = hashtable_hash_read64 (ptr + remaining - 16);
+        b = hashtable_hash_read64 (ptr + remaining - 8);
+    }
+
+    return hashtable_hash_mix (
+        hashtable_hash_mix (a ^ HASHTABLE_HASH_SECRET1, b ^ seed)
+        ^ HASHTABLE_HASH_SECRET0 ^ (uint64_t)length,
+        seed ^ HASHTABLE_HASH_SECRET1);
+}
+
+/*
+ * Hash an integer (or a pointer) with the random seed, so that all bits
+ * of the integer have an effect on the low bits of the hash (pointers are
+ * aligned, so their low bits are often zero).
+ *
+ * Return the hash of the integer.
+ */
+
+unsigned long long
+hashtable_hash_key_integer (unsigned long long value)
+{
+    return hashtable_hash_mix ((uint64_t)value ^ hashtable_seed,
+                               HASHTABLE_HASH_SECRET0);
+}
+
 /*
  * Hash a key (default callback).
  *
@@ -134,23 +353,23 @@ hashtable_hash_key_default_cb (struct t_hashtable *hashtable, const void *key)
     {
         case HASHTABLE_INTEGER:
             if (key)
-                return (unsigned long long)(*((int *)key));
+                return hashtable_hash_key_integer ((unsigned long long)(*((int *)key)));
             break;
         case HASHTABLE_STRING:
             if (key)
-                return hashtable_hash_key_djb2 ((const char *)key);
+                return hashtable_hash_key_string ((const char *)key);
             break;
         case HASHTABLE_POINTER:
-            return (unsigned long long)((unsigned long)((void *)key));
+            return hashtable_hash_key_integer ((unsigned long long)((unsigned long)((void *)key)));
         case HASHTABLE_BUFFER:
             break;
         case HASHTABLE_TIME:
             if (key)
-                return (unsigned long long)(*((time_t *)key));
+                return hashtable_hash_key_integer ((unsigned long long)(*((time_t *)key)));
             break;
         case HASHTABLE_LONGLONG:
             if (key)
-                return (unsigned long long)(*((long long *)key));
+                return hashtable_hash_key_integer ((unsigned long long)(*((long long *)key)));
             break;
         case HASHTABLE_NUM_TYPES:
             break;
@@ -224,23 +443,65 @@ hashtable_keycmp_default_cb (struct t_hashtable *hashtable,
 }
 
 /*
- * Create a new hashtable.
+ * Compute size of "indices" for a compact hashtable with "count" entries:
+ * a power of 2 so that load factor is at most 1/3 (room is left to add as
+ * many items before the next rebuild).
+ */
+
+int
+hashtable_compact_get_size (int count)
+{
+    int size;
+
+    size = HASHTABLE_MIN_SIZE;
+    while (size < count * 3)
+    {
+        size *= 2;
+    }
+
+    return size;
+}
+
+/*
+ * Allocate arrays "entries" and "indices" of a compact hashtable (in a
+ * single block of memory).
  *
- * The size is NOT a limit for number of items in hashtable, and it is only
- * an *initial* size: it is the size of the internal array used to store
- * hashed keys, and the array is grown or shrunk automatically (see
- * hashtable_rehash) as items are added or removed, to keep the average
- * length of the linked lists low regardless of how many items end up in
- * the hashtable, down to a minimum of HASHTABLE_MIN_SIZE buckets.
+ * Return pointer to entries, NULL if error.
+ */
+
+struct t_hashtable_entry *
+hashtable_compact_alloc (int size, int **indices, int *entries_size)
+{
+    struct t_hashtable_entry *entries;
+    int i, capacity;
+
+    capacity = HASHTABLE_COMPACT_CAPACITY(size);
+    entries = malloc ((capacity * sizeof (*entries)) + (size * sizeof (int)));
+    if (!entries)
+        return NULL;
+
+    *indices = (int *)(entries + capacity);
+    for (i = 0; i < size; i++)
+    {
+        (*indices)[i] = HASHTABLE_COMPACT_SLOT_FREE;
+    }
+    *entries_size = capacity;
+
+    return entries;
+}
+
+/*
+ * Create a new hashtable with the given backend.
  *
  * Return pointer to new hashtable, NULL if error.
  */
 
 struct t_hashtable *
-hashtable_new (int size,
-               const char *type_keys, const char *type_values,
-               t_hashtable_hash_key *callback_hash_key,
-               t_hashtable_keycmp *callback_keycmp)
+hashtable_new_with_backend (enum t_hashtable_backend backend,
+                            int size,
+                            const char *type_keys, const char *type_values,
+                            t_hashtable_hash_key *callback_hash_key,
+                            t_hashtable_keycmp *callback_keycmp)
 {
     struct t_hashtable *new_hashtable;
     int i, type_keys_int, type_values_int;
@@ -259,22 +520,52 @@ hashtable_new (int size,
     if ((type_keys_int == HASHTABLE_BUFFER) && (!callback_hash_key || !callback_keycmp))
         return NULL;
 
+    hashtable_init_seed ();
+
     new_hashtable = malloc (sizeof (*new_hashtable));
     if (new_hashtable)
     {
-        new_hashtable->size = size;
+        new_hashtable->backend = backend;
         new_hashtable->type_keys = type_keys_int;
         new_hashtable->type_values = type_values_int;
-        new_hashtable->htable = malloc (size * sizeof (*(new_hashtable->htable)));
+        new_hashtable->htable = NULL;
+        new_hashtable->indices = NULL;
+        new_hashtable->entries = NULL;
+        new_hashtable->entries_count = 0;
+        new_hashtable->entries_size = 0;
+        new_hashtable->iterating = 0;
         new_hashtable->keys_values = NULL;
-        if (!new_hashtable->htable)
+        if (backend == HASHTABLE_BACKEND_COMPACT)
         {
-            free (new_hashtable);
-            return NULL;
+            /* size of indices must be a power of 2 */
+            new_hashtable->size = HASHTABLE_MIN_SIZE;
+            while (new_hashtable->size < size)
+            {
+                new_hashtable->size *= 2;
+            }
+            new_hashtable->entries = hashtable_compact_alloc (
+                new_hashtable->size,
+                &new_hashtable->indices,
+                &new_hashtable->entries_size);
+            if (!new_hashtable->entries)
+            {
+                free (new_hashtable);
+                return NULL;
+            }
         }
-        for (i = 0; i < size; i++)
+        else
         {
-            new_hashtable->htable[i] = NULL;
+            new_hashtable->size = size;
+            new_hashtable->htable = malloc (size * sizeof (*(new_hashtable->htable)));
+            if (!new_hashtable->htable)
+            {
+                free (new_hashtable);
+                return NULL;
+            }
+            for (i = 0; i < size; i++)
+            {
+                new_hashtable->htable[i] = NULL;
+            }
         }
         new_hashtable->items_count = 0;
         new_hashtable->oldest_item = NULL;
@@ -291,6 +582,55 @@ hashtable_new (int size,
     return new_hashtable;
 }
 
+/*
+ * Create a new hashtable.
+ *
+ * The size is NOT a limit for number of items in hashtable, and it is only
+ * an *initial* size: it is the size of the internal array used to store
+ * hashed keys, and the array is grown or shrunk automatically (see
+ * hashtable_rehash) as items are added or removed, to keep the average
+ * length of the linked lists low regardless of how many items end up in
+ * the hashtable, down to a minimum of HASHTABLE_MIN_SIZE buckets.
+ *
+ * Return pointer to new hashtable, NULL if error.
+ */
+
+struct t_hashtable *
+hashtable_new (int size,
+               const char *type_keys, const char *type_values,
+               t_hashtable_hash_key *callback_hash_key,
+               t_hashtable_keycmp *callback_keycmp)
+{
+    return hashtable_new_with_backend (HASHTABLE_BACKEND_CHAINED,
+                                       size, type_keys, type_values,
+                                       callback_hash_key, callback_keycmp);
+}
+
+/*
+ * Create a new compact hashtable (open addressing, see core-hashtable.h).
+ *
+ * The API is the same as hashtable created with hashtable_new, but items
+ * are stored in a flat array (by order of creation), and small keys are
+ * stored inside the entries: this uses less memory and less allocations,
+ * which is faster for short-lived hashtables with few items and for
+ * lookups in large hashtables.
+ *
+ * The size is an initial size, rounded up to a power of 2.
+ *
+ * Return pointer to new hashtable, NULL if error.
+ */
+
+struct t_hashtable *
+hashtable_new_compact (int size,
+                       const char *type_keys, const char *type_values,
+                       t_hashtable_hash_key *callback_hash_key,
+                       t_hashtable_keycmp *callback_keycmp)
+{
+    return hashtable_new_with_backend (HASHTABLE_BACKEND_COMPACT,
+                                       size, type_keys, type_values,
+                                       callback_hash_key, callback_keycmp);
+}
+
 /*
  * Allocate space for a key or value.
  */
@@ -462,7 +802,8 @@ hashtable_rehash (struct t_hashtable *hashtable, int new_size)
         {
             ptr_next_item = ptr_item->next_item;
 
-            hash = hashtable->callback_hash_key (hashtable, ptr_item->key) % new_size;
+            /* the hash of key is stored in item: no need to hash it again */
+            hash = ptr_item->hash % new_size;
 
             /* find sorted position for item in its new bucket */
             pos_item = NULL;
@@ -492,6 +833,256 @@ hashtable_rehash (struct t_hashtable *hashtable, int new_size)
     hashtable->size = new_size;
 }
 
+/*
+ * Search for a key in a compact hashtable.
+ *
+ * If slot is not NULL, it is set with the slot of key in "indices" if the
+ * key is found, otherwise with the slot where the key can be added.
+ *
+ * Return index of entry in "entries", -1 if key is not found.
+ */
+
+int
+hashtable_compact_search (struct t_hashtable *hashtable,
+                          const void *key, unsigned long long hash,
+                          int *slot)
+{
+    struct t_hashtable_entry *ptr_entry;
+    unsigned long long mask, perturb, i;
+    int index, free_slot;
+
+    mask = (unsigned long long)(hashtable->size - 1);
+    perturb = hash;
+    i = hash & mask;
+    free_slot = -1;
+
+    /*
+     * there is always at least one free slot (max load factor is 2/3),
+     * and the probe sequence visits all slots, so this loop ends
+     */
+    while (1)
+    {
+        index = hashtable->indices[i];
+        if (index == HASHTABLE_COMPACT_SLOT_FREE)
+        {
+            if (slot)
+                *slot = (free_slot >= 0) ? free_slot : (int)i;
+            return -1;
+        }
+        if (index == HASHTABLE_COMPACT_SLOT_REMOVED)
+        {
+            if (free_slot < 0)
+                free_slot = (int)i;
+        }
+        else
+        {
+            ptr_entry = &hashtable->entries[index];
+            if ((ptr_entry->hash == hash)
+                && (hashtable->callback_keycmp (hashtable, key, ptr_entry->key) == 0))
+            {
+                if (slot)
+                    *slot = (int)i;
+                return index;
+            }
+        }
+        perturb >>= 5;
+        i = ((i * 5) + 1 + perturb) & mask;
+    }
+}
+
+/*
+ * Rebuild arrays of a compact hashtable, with a size computed for "count"
+ * entries.
+ *
+ * Removed entries are dropped, except if hashtable_map is running: in this
+ * case the entries keep their index (only the size changes), so that the
+ * iteration can continue safely.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+hashtable_compact_rebuild (struct t_hashtable *hashtable, int count)
+{
+    struct t_hashtable_entry *new_entries, *ptr_entry;
+    unsigned long long mask, perturb, slot;
+    int *new_indices, new_size, new_entries_size, keep_removed, i, j;
+
+    keep_removed = (hashtable->iterating > 0);
+    if (keep_removed && (count < hashtable->entries_count + 1))
+        count = hashtable->entries_count + 1;
+
+    new_size = hashtable_compact_get_size (count);
+    new_entries = hashtable_compact_alloc (new_size, &new_indices,
+                                           &new_entries_size);
+    if (!new_entries)
+        return 0;
+
+    mask = (unsigned long long)(new_size - 1);
+    j = 0;
+    for (i = 0; i < hashtable->entries_count; i++)
+    {
+        ptr_entry = &hashtable->entries[i];
+        if (!keep_removed && (ptr_entry->flags & HASHTABLE_ENTRY_REMOVED))
+            continue;
+        new_entries[j] = *ptr_entry;
+        if (new_entries[j].flags & HASHTABLE_ENTRY_KEY_INLINE)
+            new_entries[j].key = new_entries[j].key_inline.data;
+        if (!(new_entries[j].flags & HASHTABLE_ENTRY_REMOVED))
+        {
+            perturb = new_entries[j].hash;
+            slot = perturb & mask;
+            while (new_indices[slot] != HASHTABLE_COMPACT_SLOT_FREE)
+            {
+                perturb >>= 5;
+                slot = ((slot * 5) + 1 + perturb) & mask;
+            }
+            new_indices[slot] = j;
+        }
+        j++;
+    }
+
+    free (hashtable->entries);
+    hashtable->entries = new_entries;
+    hashtable->indices = new_indices;
+    hashtable->entries_count = j;
+    hashtable->entries_size = new_entries_size;
+    hashtable->size = new_size;
+
+    return 1;
+}
+
+/*
+ * Set key of a new entry in a compact hashtable: the key is stored inside
+ * the entry if it is small enough (and if there is no callback to free
+ * keys), otherwise it is allocated.
+ */
+
+void
+hashtable_compact_set_key (struct t_hashtable *hashtable,
+                           struct t_hashtable_entry *entry,
+                           const void *key, int key_size)
+{
+    int length;
+
+    length = 0;
+    if (key && !hashtable->callback_free_key)
+    {
+        switch (hashtable->type_keys)
+        {
+            case HASHTABLE_INTEGER:
+                length = sizeof (int);
+                break;
+            case HASHTABLE_STRING:
+                length = strlen ((const char *)key) + 1;
+                break;
+            case HASHTABLE_POINTER:
+                break;
+            case HASHTABLE_BUFFER:
+                length = key_size;
+                break;
+            case HASHTABLE_TIME:
+                length = sizeof (time_t);
+                break;
+            case HASHTABLE_LONGLONG:
+                length = sizeof (long long);
+                break;
+            case HASHTABLE_NUM_TYPES:
+                break;
+        }
+    }
+
+    if ((length > 0) && (length <= HASHTABLE_KEY_INLINE_SIZE))
+    {
+        memcpy (entry->key_inline.data, key, length);
+        entry->key = entry->key_inline.data;
+        entry->key_size = length;
+        entry->flags |= HASHTABLE_ENTRY_KEY_INLINE;
+    }
+    else
+    {
+        hashtable_alloc_type (hashtable->type_keys,
+                              key, key_size,
+                              &entry->key, &entry->key_size);
+    }
+}
+
+/*
+ * Set value for a key in a compact hashtable.
+ *
+ * Return pointer to entry created/updated, NULL if error.
+ */
+
+struct t_hashtable_entry *
+hashtable_compact_set (struct t_hashtable *hashtable,
+                       const void *key, int key_size,
+                       const void *value, int value_size)
+{
+    unsigned long long hash;
+    struct t_hashtable_entry *ptr_entry;
+    int index, slot;
+
+    hash = hashtable->callback_hash_key (hashtable, key);
+    index = hashtable_compact_search (hashtable, key, hash, &slot);
+
+    /* replace value if item is already in hashtable */
+    if (index >= 0)
+    {
+        ptr_entry = &hashtable->entries[index];
+        hashtable_free_value (hashtable, (struct t_hashtable_item *)ptr_entry);
+        hashtable_alloc_type (hashtable->type_values,
+                              value, value_size,
+                              &ptr_entry->value, &ptr_entry->value_size);
+        return ptr_entry;
+    }
+
+    /* grow the arrays (or drop removed entries) if they are full */
+    if (hashtable->entries_count >= hashtable->entries_size)
+    {
+        if (!hashtable_compact_rebuild (hashtable, hashtable->items_count + 1))
+            return NULL;
+        hashtable_compact_search (hashtable, key, hash, &slot);
+    }
+
+    /* add entry */
+    ptr_entry = &hashtable->entries[hashtable->entries_count];
+    ptr_entry->flags = 0;
+    ptr_entry->hash = hash;
+    hashtable_compact_set_key (hashtable, ptr_entry, key, key_size);
+    hashtable_alloc_type (hashtable->type_values,
+                          value, value_size,
+                          &ptr_entry->value, &ptr_entry->value_size);
+    hashtable->indices[slot] = hashtable->entries_count;
+    hashtable->entries_count++;
+    hashtable->items_count++;
+
+    return ptr_entry;
+}
+
+/*
+ * Remove an entry from a compact hashtable.
+ */
+
+void
+hashtable_compact_remove_entry (struct t_hashtable *hashtable,
+                                struct t_hashtable_entry *entry)
+{
+    /* free key and value */
+    hashtable_free_value (hashtable, (struct t_hashtable_item *)entry);
+    if (!(entry->flags & HASHTABLE_ENTRY_KEY_INLINE))
+        hashtable_free_key (hashtable, (struct t_hashtable_item *)entry);
+
+    entry->key = NULL;
+    entry->key_size = 0;
+    entry->value = NULL;
+    entry->value_size = 0;
+    entry->flags = HASHTABLE_ENTRY_REMOVED;
+
+    hashtable->items_count--;
+}
+
 /*
  * Set value for a key in hashtable.
  *
@@ -505,7 +1096,7 @@ hashtable_set_with_size (struct t_hashtable *hashtable,
                          const void *key, int key_size,
                          const void *value, int value_size)
 {
-    unsigned long long hash;
+    unsigned long long hash_key, hash;
     struct t_hashtable_item *ptr_item, *pos_item, *new_item;
 
     if (!hashtable
@@ -515,8 +1106,15 @@ hashtable_set_with_size (struct t_hashtable *hashtable,
         return NULL;
     }
 
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        return (struct t_hashtable_item *)hashtable_compact_set (
+            hashtable, key, key_size, value, value_size);
+    }
+
     /* search position for item in hashtable */
-    hash = hashtable->callback_hash_key (hashtable, key) % hashtable->size;
+    hash_key = hashtable->callback_hash_key (hashtable, key);
+    hash = hash_key % hashtable->size;
     pos_item = NULL;
     for (ptr_item = hashtable->htable[hash];
          ptr_item
@@ -545,6 +1143,7 @@ hashtable_set_with_size (struct t_hashtable *hashtable,
     hashtable_alloc_type (hashtable->type_keys,
                           key, key_size,
                           &new_item->key, &new_item->key_size);
+    new_item->hash = hash_key;
     hashtable_alloc_type (hashtable->type_values,
                           value, value_size,
                           &new_item->value, &new_item->value_size);
@@ -607,7 +1206,8 @@ hashtable_set (struct t_hashtable *hashtable,
  * Search for an item in hashtable.
  *
  * If hash is non NULL, then set it with hash value of key (even if key is
- * not found).
+ * not found); for a compact hashtable, this is the slot of key in array
+ * "indices".
  */
 
 struct t_hashtable_item *
@@ -616,23 +1216,38 @@ hashtable_get_item (struct t_hashtable *hashtable, const void *key,
 {
     unsigned long long key_hash;
     struct t_hashtable_item *ptr_item;
+    int index, slot;
 
     if (!hashtable)
         return NULL;
 
-    key_hash = hashtable->callback_hash_key (hashtable, key) % hashtable->size;
-    if (hash)
-        *hash = key_hash;
-    for (ptr_item = hashtable->htable[key_hash];
-         ptr_item && hashtable->callback_keycmp (hashtable, key, ptr_item->key) > 0;
-         ptr_item = ptr_item->next_item)
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
     {
+        index = hashtable_compact_search (
+            hashtable, key, hashtable->callback_hash_key (hashtable, key),
+            &slot);
+        if (hash)
+            *hash = (unsigned long long)slot;
+        return (index >= 0) ?
+            (struct t_hashtable_item *)&hashtable->entries[index] : NULL;
     }
 
-    if (ptr_item
-        && (hashtable->callback_keycmp (hashtable, key, ptr_item->key) == 0))
+    key_hash = hashtable->callback_hash_key (hashtable, key);
+    if (hash)
+        *hash = key_hash % hashtable->size;
+
+    /*
+     * compare the hash stored in items first: keys are compared only if
+     * the hash is the same
+     */
+    for (ptr_item = hashtable->htable[key_hash % hashtable->size]; ptr_item;
+         ptr_item = ptr_item->next_item)
     {
-        return ptr_item;
+        if ((ptr_item->hash == key_hash)
+            && (hashtable->callback_keycmp (hashtable, key, ptr_item->key) == 0))
+        {
+            return ptr_item;
+        }
     }
 
     return NULL;
@@ -718,10 +1333,34 @@ hashtable_map (struct t_hashtable *hashtable,
                void *callback_map_data)
 {
     struct t_hashtable_item *ptr_item, *ptr_next_created_item;
+    struct t_hashtable_entry *ptr_entry;
+    int i;
 
     if (!hashtable)
         return;
 
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        /*
+         * entries keep their index while iterating (even if the callback
+         * adds or removes items), but the array may be reallocated, so the
+         * entry is read again on each iteration
+         */
+        hashtable->iterating++;
+        for (i = 0; i < hashtable->entries_count; i++)
+        {
+            ptr_entry = &hashtable->entries[i];
+            if (ptr_entry->flags & HASHTABLE_ENTRY_REMOVED)
+                continue;
+            (void) (callback_map) (callback_map_data,
+                                   hashtable,
+                                   ptr_entry->key,
+                                   ptr_entry->value);
+        }
+        hashtable->iterating--;
+        return;
+    }
+
     ptr_item = hashtable->oldest_item;
     while (ptr_item)
     {
@@ -736,6 +1375,37 @@ hashtable_map (struct t_hashtable *hashtable,
     }
 }
 
+/*
+ * Call a function with key and value converted to strings (callback called
+ * for each variable in hashtable).
+ */
+
+void
+hashtable_map_string_cb (void *data,
+                         struct t_hashtable *hashtable,
+                         const void *key, const void *value)
+{
+    struct t_hashtable_map_string_data *map_string_data;
+    const char *str_key, *str_value;
+    char *key2, *value2;
+
+    map_string_data = (struct t_hashtable_map_string_data *)data;
+
+    str_key = hashtable_to_string (hashtable->type_keys, key);
+    key2 = (str_key) ? strdup (str_key) : NULL;
+
+    str_value = hashtable_to_string (hashtable->type_values, value);
+    value2 = (str_value) ? strdup (str_value) : NULL;
+
+    (void) (map_string_data->callback_map) (map_string_data->callback_map_data,
+                                            hashtable,
+                                            key2,
+                                            value2);
+
+    free (key2);
+    free (value2);
+}
+
 /*
  * Call a function on all hashtable entries (sends keys and values as strings).
  */
@@ -745,36 +1415,15 @@ hashtable_map_string (struct t_hashtable *hashtable,
                       t_hashtable_map_string *callback_map,
                       void *callback_map_data)
 {
-    struct t_hashtable_item *ptr_item, *ptr_next_created_item;
-    const char *str_key, *str_value;
-    char *key, *value;
+    struct t_hashtable_map_string_data map_string_data;
 
     if (!hashtable)
         return;
 
-    ptr_item = hashtable->oldest_item;
-    while (ptr_item)
-    {
-        ptr_next_created_item = ptr_item->next_created_item;
-
-        str_key = hashtable_to_string (hashtable->type_keys,
-                                       ptr_item->key);
-        key = (str_key) ? strdup (str_key) : NULL;
-
-        str_value = hashtable_to_string (hashtable->type_values,
-                                         ptr_item->value);
-        value = (str_value) ? strdup (str_value) : NULL;
+    map_string_data.callback_map = callback_map;
+    map_string_data.callback_map_data = callback_map_data;
 
-        (void) (callback_map) (callback_map_data,
-                               hashtable,
-                               key,
-                               value);
-
-        free (key);
-        free (value);
-
-        ptr_item = ptr_next_created_item;
-    }
+    hashtable_map (hashtable, &hashtable_map_string_cb, &map_string_data);
 }
 
 /*
@@ -811,11 +1460,13 @@ hashtable_dup (struct t_hashtable *hashtable)
     if (!hashtable)
         return NULL;
 
-    new_hashtable = hashtable_new (hashtable->size,
-                                   hashtable_type_string[hashtable->type_keys],
-                                   hashtable_type_string[hashtable->type_values],
-                                   hashtable->callback_hash_key,
-                                   hashtable->callback_keycmp);
+    new_hashtable = hashtable_new_with_backend (
+        hashtable->backend,
+        hashtable->size,
+        hashtable_type_string[hashtable->type_keys],
+        hashtable_type_string[hashtable->type_values],
+        hashtable->callback_hash_key,
+        hashtable->callback_keycmp);
     if (new_hashtable)
     {
         new_hashtable->callback_free_key = hashtable->callback_free_key;
@@ -1170,6 +1821,71 @@ hashtable_set_pointer (struct t_hashtable *hashtable, const char *property,
         hashtable->callback_free_value = pointer;
 }
 
+/*
+ * Add key and value of a hashtable item in an infolist.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+hashtable_add_item_to_infolist (struct t_hashtable *hashtable,
+                                struct t_hashtable_item *item,
+                                struct t_infolist_item *infolist_item,
+                                const char *prefix,
+                                int item_number)
+{
+    char option_name[128], value[128];
+
+    snprintf (option_name, sizeof (option_name),
+              "%s_name_%05d", prefix, item_number);
+    if (!infolist_new_var_string (infolist_item, option_name,
+                                  hashtable_to_string (hashtable->type_keys,
+                                                       item->key)))
+        return 0;
+    snprintf (option_name, sizeof (option_name),
+              "%s_value_%05d", prefix, item_number);
+    switch (hashtable->type_values)
+    {
+        case HASHTABLE_INTEGER:
+            if (!infolist_new_var_integer (infolist_item, option_name,
+                                           *((int *)item->value)))
+                return 0;
+            break;
+        case HASHTABLE_STRING:
+            if (!infolist_new_var_string (infolist_item, option_name,
+                                          (const char *)item->value))
+                return 0;
+            break;
+        case HASHTABLE_POINTER:
+            if (!infolist_new_var_pointer (infolist_item, option_name,
+                                           item->value))
+                return 0;
+            break;
+        case HASHTABLE_BUFFER:
+            if (!infolist_new_var_buffer (infolist_item, option_name,
+                                          item->value,
+                                          item->value_size))
+                return 0;
+            break;
+        case HASHTABLE_TIME:
+            if (!infolist_new_var_time (infolist_item, option_name,
+                                        *((time_t *)item->value)))
+                return 0;
+            break;
+        case HASHTABLE_LONGLONG:
+            snprintf (value, sizeof (value),
+                      "%lld", *((long long *)item->value));
+            if (!infolist_new_var_string (infolist_item, option_name, value))
+                return 0;
+            break;
+        case HASHTABLE_NUM_TYPES:
+            break;
+    }
+    return 1;
+}
+
 /*
  * Add hashtable keys and values in an infolist.
  *
@@ -1183,62 +1899,37 @@ hashtable_add_to_infolist (struct t_hashtable *hashtable,
                            struct t_infolist_item *infolist_item,
                            const char *prefix)
 {
-    int item_number;
+    int i, item_number;
     struct t_hashtable_item *ptr_item;
-    char option_name[128], value[128];
 
     if (!hashtable || !infolist_item || !prefix)
         return 0;
 
     item_number = 0;
+
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        for (i = 0; i < hashtable->entries_count; i++)
+        {
+            if (hashtable->entries[i].flags & HASHTABLE_ENTRY_REMOVED)
+                continue;
+            if (!hashtable_add_item_to_infolist (
+                    hashtable,
+                    (struct t_hashtable_item *)&hashtable->entries[i],
+                    infolist_item, prefix, item_number))
+                return 0;
+            item_number++;
+        }
+        return 1;
+    }
+
     ptr_item = hashtable->oldest_item;
     while (ptr_item)
     {
-        snprintf (option_name, sizeof (option_name),
-                  "%s_name_%05d", prefix, item_number);
-        if (!infolist_new_var_string (infolist_item, option_name,
-                                      hashtable_to_string (hashtable->type_keys,
-                                                           ptr_item->key)))
+        if (!hashtable_add_item_to_infolist (hashtable, ptr_item,
+                                             infolist_item, prefix,
+                                             item_number))
             return 0;
-        snprintf (option_name, sizeof (option_name),
-                  "%s_value_%05d", prefix, item_number);
-        switch (hashtable->type_values)
-        {
-            case HASHTABLE_INTEGER:
-                if (!infolist_new_var_integer (infolist_item, option_name,
-                                               *((int *)ptr_item->value)))
-                    return 0;
-                break;
-            case HASHTABLE_STRING:
-                if (!infolist_new_var_string (infolist_item, option_name,
-                                              (const char *)ptr_item->value))
-                    return 0;
-                break;
-            case HASHTABLE_POINTER:
-                if (!infolist_new_var_pointer (infolist_item, option_name,
-                                               ptr_item->value))
-                    return 0;
-                break;
-            case HASHTABLE_BUFFER:
-                if (!infolist_new_var_buffer (infolist_item, option_name,
-                                              ptr_item->value,
-                                              ptr_item->value_size))
-                    return 0;
-                break;
-            case HASHTABLE_TIME:
-                if (!infolist_new_var_time (infolist_item, option_name,
-                                            *((time_t *)ptr_item->value)))
-                    return 0;
-                break;
-            case HASHTABLE_LONGLONG:
-                snprintf (value, sizeof (value),
-                          "%lld", *((long long *)ptr_item->value));
-                if (!infolist_new_var_string (infolist_item, option_name, value))
-                    return 0;
-                break;
-            case HASHTABLE_NUM_TYPES:
-                break;
-        }
         item_number++;
         ptr_item = ptr_item->next_created_item;
     }
@@ -1390,11 +2081,32 @@ hashtable_remove (struct t_hashtable *hashtable, const void *key)
 {
     struct t_hashtable_item *ptr_item;
     unsigned long long hash;
-    int new_size;
+    int new_size, index, slot;
 
     if (!hashtable || !key)
         return;
 
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        index = hashtable_compact_search (
+            hashtable, key, hashtable->callback_hash_key (hashtable, key),
+            &slot);
+        if (index < 0)
+            return;
+        hashtable_compact_remove_entry (hashtable,
+                                        &hashtable->entries[index]);
+        hashtable->indices[slot] = HASHTABLE_COMPACT_SLOT_REMOVED;
+
+        /* shrink the arrays if there are too few items */
+        if ((hashtable->iterating == 0)
+            && (hashtable->size > HASHTABLE_MIN_SIZE)
+            && (hashtable->items_count * HASHTABLE_COMPACT_SHRINK_FACTOR < hashtable->size))
+        {
+            hashtable_compact_rebuild (hashtable, hashtable->items_count);
+        }
+        return;
+    }
+
     ptr_item = hashtable_get_item (hashtable, key, &hash);
     if (ptr_item)
     {
@@ -1428,6 +2140,22 @@ hashtable_remove_all (struct t_hashtable *hashtable)
     if (!hashtable)
         return;
 
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        for (i = 0; i < hashtable->entries_count; i++)
+        {
+            if (!(hashtable->entries[i].flags & HASHTABLE_ENTRY_REMOVED))
+                hashtable_compact_remove_entry (hashtable,
+                                                &hashtable->entries[i]);
+        }
+        for (i = 0; i < hashtable->size; i++)
+        {
+            hashtable->indices[i] = HASHTABLE_COMPACT_SLOT_FREE;
+        }
+        hashtable->entries_count = 0;
+        return;
+    }
+
     for (i = 0; i < hashtable->size; i++)
     {
         while (hashtable->htable[i])
@@ -1449,10 +2177,70 @@ hashtable_free (struct t_hashtable *hashtable)
 
     hashtable_remove_all (hashtable);
     free (hashtable->htable);
+    free (hashtable->entries);
     free (hashtable->keys_values);
     free (hashtable);
 }
 
+/*
+ * Print key and value of a hashtable item in WeeChat log file.
+ */
+
+void
+hashtable_print_log_item (struct t_hashtable *hashtable,
+                          struct t_hashtable_item *item)
+{
+    switch (hashtable->type_keys)
+    {
+        case HASHTABLE_INTEGER:
+            log_printf ("      key (integer). . . : %d", *((int *)item->key));
+            break;
+        case HASHTABLE_STRING:
+            log_printf ("      key (string) . . . : '%s'", (char *)item->key);
+            break;
+        case HASHTABLE_POINTER:
+            log_printf ("      key (pointer). . . : %p", item->key);
+            break;
+        case HASHTABLE_BUFFER:
+            log_printf ("      key (buffer) . . . : %p", item->key);
+            break;
+        case HASHTABLE_TIME:
+            log_printf ("      key (time) . . . . : %lld", (long long)(*((time_t *)item->key)));
+            break;
+        case HASHTABLE_LONGLONG:
+            log_printf ("      key (long long). . : %lld", *((long long *)item->key));
+            break;
+        case HASHTABLE_NUM_TYPES:
+            break;
+    }
+    log_printf ("      key_size . . . . . : %d", item->key_size);
+    switch (hashtable->type_values)
+    {
+        case HASHTABLE_INTEGER:
+            log_printf ("      value (integer). . : %d", *((int *)item->value));
+            break;
+        case HASHTABLE_STRING:
+            log_printf ("      value (string) . . : '%s'", (char *)item->value);
+            break;
+        case HASHTABLE_POINTER:
+            log_printf ("      value (pointer). . : %p", item->value);
+            break;
+        case HASHTABLE_BUFFER:
+            log_printf ("      value (buffer) . . : %p", item->value);
+            break;
+        case HASHTABLE_TIME:
+            log_printf ("      value (time) . . . : %lld", (long long)(*((time_t *)item->value)));
+            break;
+        case HASHTABLE_LONGLONG:
+            log_printf ("      value (long long). : %lld", *((long long *)item->value));
+            break;
+        case HASHTABLE_NUM_TYPES:
+            break;
+    }
+    log_printf ("      value_size . . . . : %d", item->value_size);
+    log_printf ("      hash . . . . . . . : %llu", item->hash);
+}
+
 /*
  * Print hashtable in WeeChat log file (usually for crash dump).
  */
@@ -1461,15 +2249,25 @@ void
 hashtable_print_log (struct t_hashtable *hashtable, const char *name)
 {
     struct t_hashtable_item *ptr_item;
+    struct t_hashtable_entry *ptr_entry;
     int i;
 
     log_printf ("");
     log_printf ("[hashtable %s (addr:%p)]", name, hashtable);
+    log_printf ("  backend. . . . . . . . : %d (%s)",
+                hashtable->backend,
+                (hashtable->backend == HASHTABLE_BACKEND_COMPACT) ?
+                "compact" : "chained");
     log_printf ("  size . . . . . . . . . : %d", hashtable->size);
     log_printf ("  htable . . . . . . . . : %p", hashtable->htable);
     log_printf ("  items_count. . . . . . : %d", hashtable->items_count);
     log_printf ("  oldest_item. . . . . . : %p", hashtable->oldest_item);
     log_printf ("  newest_item. . . . . . : %p", hashtable->newest_item);
+    log_printf ("  indices. . . . . . . . : %p", hashtable->indices);
+    log_printf ("  entries. . . . . . . . : %p", hashtable->entries);
+    log_printf ("  entries_count. . . . . : %d", hashtable->entries_count);
+    log_printf ("  entries_size . . . . . : %d", hashtable->entries_size);
+    log_printf ("  iterating. . . . . . . : %d", hashtable->iterating);
     log_printf ("  type_keys. . . . . . . : %d (%s)",
                 hashtable->type_keys,
                 hashtable_type_string[hashtable->type_keys]);
@@ -1482,6 +2280,27 @@ hashtable_print_log (struct t_hashtable *hashtable, const char *name)
     log_printf ("  callback_free_value. . : %p", hashtable->callback_free_value);
     log_printf ("  keys_values. . . . . . : '%s'", hashtable->keys_values);
 
+    if (hashtable->backend == HASHTABLE_BACKEND_COMPACT)
+    {
+        for (i = 0; i < hashtable->size; i++)
+        {
+            if (hashtable->indices[i] != HASHTABLE_COMPACT_SLOT_FREE)
+                log_printf ("  indices[%06d]. . . . : %d", i, hashtable->indices[i]);
+        }
+        for (i = 0; i < hashtable->entries_count; i++)
+        {
+            ptr_entry = &hashtable->entries[i];
+            log_printf ("    [entry %d (addr:%p)]", i, ptr_entry);
+            log_printf ("      flags. . . . . . . : %d", ptr_entry->flags);
+            if (!(ptr_entry->flags & HASHTABLE_ENTRY_REMOVED))
+            {
+                hashtable_print_log_item (hashtable,
+                                          (struct t_hashtable_item *)ptr_entry);
+            }
+        }
+        return;
+    }
+
     for (i = 0; i < hashtable->size; i++)
     {
         log_printf ("  htable[%06d] . . . . : %p", i, hashtable->htable[i]);
@@ -1489,54 +2308,7 @@ hashtable_print_log (struct t_hashtable *hashtable, const char *name)
              ptr_item = ptr_item->next_item)
         {
             log_printf ("    [item %p]", hashtable->htable);
-            switch (hashtable->type_keys)
-            {
-                case HASHTABLE_INTEGER:
-                    log_printf ("      key (integer). . . : %d", *((int *)ptr_item->key));
-                    break;
-                case HASHTABLE_STRING:
-                    log_printf ("      key (string) . . . : '%s'", (char *)ptr_item->key);
-                    break;
-                case HASHTABLE_POINTER:
-                    log_printf ("      key (pointer). . . : %p", ptr_item->key);
-                    break;
-                case HASHTABLE_BUFFER:
-                    log_printf ("      key (buffer) . . . : %p", ptr_item->key);
-                    break;
-                case HASHTABLE_TIME:
-                    log_printf ("      key (time) . . . . : %lld", (long long)(*((time_t *)ptr_item->key)));
-                    break;
-                case HASHTABLE_LONGLONG:
-                    log_printf ("      key (long long). . : %lld", *((long long *)ptr_item->key));
-                    break;
-                case HASHTABLE_NUM_TYPES:
-                    break;
-            }
-            log_printf ("      key_size . . . . . : %d", ptr_item->key_size);
-            switch (hashtable->type_values)
-            {
-                case HASHTABLE_INTEGER:
-                    log_printf ("      value (integer). . : %d", *((int *)ptr_item->value));
-                    break;
-                case HASHTABLE_STRING:
-                    log_printf ("      value (string) . . : '%s'", (char *)ptr_item->value);
-                    break;
-                case HASHTABLE_POINTER:
-                    log_printf ("      value (pointer). . : %p", ptr_item->value);
-                    break;
-                case HASHTABLE_BUFFER:
-                    log_printf ("      value (buffer) . . : %p", ptr_item->value);
-                    break;
-                case HASHTABLE_TIME:
-                    log_printf ("      value (time) . . . : %lld", (long long)(*((time_t *)ptr_item->value)));
-                    break;
-                case HASHTABLE_LONGLONG:
-                    log_printf ("      value (long long). : %lld", *((long long *)ptr_item->value));
-                    break;
-                case HASHTABLE_NUM_TYPES:
-                    break;
-            }
-            log_printf ("      value_size . . . . : %d", ptr_item->value_size);
+            hashtable_print_log_item (hashtable, ptr_item);
             log_printf ("      prev_item. . . . . : %p", ptr_item->prev_item);
             log_printf ("      next_item. . . . . : %p", ptr_item->next_item);
             log_printf ("      prev_created_item. : %p", ptr_item->prev_created_item);
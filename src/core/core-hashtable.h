@@ -98,6 +98,29 @@ typedef void (t_hashtable_map_string)(void *data,
  * +-----+
  * |   7 | --> "weechat"
  * +-----+
+ *
+ * A hashtable can also use the "compact" backend (see hashtable_new_compact),
+ * with open addressing: all entries are stored in a flat array "entries",
+ * by order of creation, and the array "indices" (size is a power of 2) maps
+ * hashed keys to the index of entry in "entries". Small keys are stored
+ * inside the entry itself, so that adding an item does not allocate memory
+ * (except for values and large keys), and the hashtable does not keep any
+ * linked list.
+ *
+ * Example with the same 6 items in a compact hashtable with size 16 (slots
+ * of "indices" not listed here are free):
+ *
+ *   indices: 1 -> 2, 4 -> 5, 5 -> 0, 7 -> 4, 10 -> 1, 12 -> 3
+ *
+ *   entries:
+ *   +-----------+---------+--------+--------------+--------+----------+
+ *   | "weechat" | "light" | "fast" | "extensible" | "chat" | "client" |
+ *   +-----------+---------+--------+--------------+--------+----------+
+ *         0          1        2           3           4         5
+ *
+ * A removed entry stays in the array (with flag HASHTABLE_ENTRY_REMOVED) and
+ * its slot in "indices" is marked as removed, until the arrays are rebuilt
+ * when the hashtable grows or shrinks.
  */
 
 enum t_hashtable_type
@@ -112,12 +135,28 @@ enum t_hashtable_type
     HASHTABLE_NUM_TYPES,
 };
 
+enum t_hashtable_backend
+{
+    HASHTABLE_BACKEND_CHAINED = 0,      /* linked lists (default)           */
+    HASHTABLE_BACKEND_COMPACT,          /* open addressing, flat array      */
+    /* number of hashtable backends */
+    HASHTABLE_NUM_BACKENDS,
+};
+
+#define HASHTABLE_KEY_INLINE_SIZE 16
+
+/* flags for entries of compact hashtable */
+#define HASHTABLE_ENTRY_KEY_INLINE (1 << 0)
+#define HASHTABLE_ENTRY_REMOVED    (1 << 1)
+
 struct t_hashtable_item
 {
     void *key;                          /* item key                         */
     int key_size;                       /* size of key (in bytes)           */
     void *value;                        /* pointer to value                 */
     int value_size;                     /* size of value (in bytes)         */
+    unsigned long long hash;            /* hash of key (not reduced to the  */
+                                        /* size of hashtable)               */
     struct t_hashtable_item *prev_item; /* link to previous item            */
     struct t_hashtable_item *next_item; /* link to next item                */
     /* previous/next item by order of creation in the hashtable */
@@ -126,8 +165,32 @@ struct t_hashtable_item
 
 };
 
+/*
+ * Entry of a compact hashtable: the first fields are the same as in
+ * struct t_hashtable_item, so that a pointer to an entry can be returned
+ * as item by functions hashtable_set_with_size and hashtable_get_item
+ * (only fields key, key_size, value, value_size and hash can then be used,
+ * and the pointer is valid only until next item is added or removed).
+ */
+
+struct t_hashtable_entry
+{
+    void *key;                          /* item key                         */
+    int key_size;                       /* size of key (in bytes)           */
+    void *value;                        /* pointer to value                 */
+    int value_size;                     /* size of value (in bytes)         */
+    unsigned long long hash;            /* hash of key                      */
+    int flags;                          /* HASHTABLE_ENTRY_xxx              */
+    union
+    {
+        char data[HASHTABLE_KEY_INLINE_SIZE]; /* small key stored inline    */
+        long long align;                /* align data for int/time/etc.     */
+    } key_inline;
+};
+
 struct t_hashtable
 {
+    enum t_hashtable_backend backend;  /* chained or compact                */
     int size;                          /* hashtable size (grows/shrinks     */
                                        /* automatically)                    */
     struct t_hashtable_item **htable;  /* table to map hashes with linked   */
@@ -136,6 +199,15 @@ struct t_hashtable
     struct t_hashtable_item *oldest_item; /* oldest item in hashtable       */
     struct t_hashtable_item *newest_item; /* newest item in hashtable       */
 
+    /* compact backend */
+    int *indices;                      /* open addressing: index in entries */
+                                       /* (-1 = free, -2 = removed)         */
+    struct t_hashtable_entry *entries; /* entries by order of creation      */
+    int entries_count;                 /* number of entries used (with the  */
+                                       /* removed ones)                     */
+    int entries_size;                  /* number of entries allocated       */
+    int iterating;                     /* > 0 if hashtable_map is running   */
+
     /* type for keys and values */
     enum t_hashtable_type type_keys;   /* type for keys: int/str/pointer    */
     enum t_hashtable_type type_values; /* type for values: int/str/pointer  */
@@ -151,12 +223,21 @@ struct t_hashtable
                                        /* never asked)                      */
 };
 
+extern unsigned long long hashtable_seed;
+
 extern unsigned long long hashtable_hash_key_djb2 (const char *string);
+extern unsigned long long hashtable_hash_key_string (const char *string);
+extern unsigned long long hashtable_hash_key_integer (unsigned long long value);
 extern struct t_hashtable *hashtable_new (int size,
                                           const char *type_keys,
                                           const char *type_values,
                                           t_hashtable_hash_key *hash_key_cb,
                                           t_hashtable_keycmp *keycmp_cb);
+extern struct t_hashtable *hashtable_new_compact (int size,
+                                                  const char *type_keys,
+                                                  const char *type_values,
+                                                  t_hashtable_hash_key *hash_key_cb,
+                                                  t_hashtable_keycmp *keycmp_cb);
 extern struct t_hashtable_item *hashtable_set_with_size (struct t_hashtable *hashtable,
                                                          const void *key,
                                                          int key_size,
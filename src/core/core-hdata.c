@@ -45,6 +45,9 @@ char *hdata_type_string[WEECHAT_NUM_HDATA_TYPES] =
 { "other", "char", "integer", "long", "longlong", "string", "pointer", "time",
   "hashtable", "shared_string" };
 
+/* changed when a hdata or variable is added/freed (invalidates cached paths) */
+long long hdata_generation = 0;
+
 
 /*
  * Free a hdata variable.
@@ -122,6 +125,7 @@ hdata_new (struct t_weechat_plugin *plugin, const char *hdata_name,
                                               NULL,
                                               NULL);
         new_hdata->hash_list->callback_free_value = &hdata_free_list_cb;
+        new_hdata->hash_path = NULL;
         hashtable_set (weechat_hdata, hdata_name, new_hdata);
         new_hdata->create_allowed = create_allowed;
         new_hdata->delete_allowed = delete_allowed;
@@ -169,6 +173,7 @@ hdata_new_var (struct t_hdata *hdata, const char *name, int offset, int type,
         var->hdata_name = (hdata_name && hdata_name[0]) ?
             strdup (hdata_name) : NULL;
         hashtable_set (hdata->hash_var, name, var);
+        hdata_generation++;
     }
 }
 
@@ -1225,6 +1230,398 @@ end:
     return rc;
 }
 
+/*
+ * Compile a path of variables in hdata, for example "buffer.name" with hdata
+ * "window": the names of variables are resolved only once, and the compiled
+ * path is then used to read the value in many objects (with functions
+ * hdata_path_get_var and hdata_path_get_value), without any lookup of name.
+ *
+ * Each variable of path can have an index: "NNN|name". All variables except
+ * the last one must be pointers with a hdata. If the last variable is a
+ * hashtable, it can be followed by a key ("a.b.key") or a property of
+ * hashtable ("a.b.keys()").
+ *
+ * Return pointer to compiled path, NULL if error (for example if a variable
+ * is not found).
+ *
+ * Note: result must be freed after use with function hdata_path_free
+ * (and before the hdata are freed).
+ */
+
+struct t_hdata_path *
+hdata_path_compile (struct t_hdata *hdata, const char *path)
+{
+    struct t_hdata_path *new_path;
+    struct t_hdata_path_var *new_vars, *ptr_var;
+    struct t_hdata_var *var;
+    const char *ptr_path, *pos, *pos_open_paren, *ptr_name;
+    char *name;
+    int index;
+
+    if (!hdata || !path || !path[0])
+        return NULL;
+
+    new_path = calloc (1, sizeof (*new_path));
+    if (!new_path)
+        return NULL;
+
+    new_path->path = strdup (path);
+    if (!new_path->path)
+        goto error;
+    new_path->generation = hdata_generation;
+
+    ptr_path = path;
+    while (1)
+    {
+        pos = strchr (ptr_path, '.');
+        name = (pos > ptr_path) ?
+            string_strndup (ptr_path, pos - ptr_path) : strdup (ptr_path);
+        if (!name)
+            goto error;
+        hdata_get_index_and_name (name, &index, &ptr_name);
+        var = hashtable_get (hdata->hash_var, ptr_name);
+        free (name);
+        if (!var || (var->offset < 0))
+            goto error;
+
+        new_vars = realloc (new_path->vars,
+                            (new_path->vars_count + 1) * sizeof (*new_vars));
+        if (!new_vars)
+            goto error;
+        new_path->vars = new_vars;
+        ptr_var = &(new_path->vars[new_path->vars_count]);
+        new_path->vars_count++;
+        ptr_var->offset = var->offset;
+        ptr_var->type = var->type;
+        ptr_var->array = (var->array_size && (index >= 0)) ? 1 : 0;
+        ptr_var->array_pointer = var->array_pointer;
+        ptr_var->index = index;
+
+        if (!pos)
+            break;
+
+        /* pointer with hdata: go on with the hdata and remaining path */
+        if ((var->type == WEECHAT_HDATA_POINTER) && var->hdata_name)
+        {
+            hdata = hook_hdata_get (NULL, var->hdata_name);
+            if (!hdata)
+                goto error;
+            ptr_path = pos + 1;
+            continue;
+        }
+
+        /* hashtable: the remaining path is a key or a property */
+        if (var->type == WEECHAT_HDATA_HASHTABLE)
+        {
+            pos_open_paren = strchr (pos, '(');
+            if (pos_open_paren
+                && (pos_open_paren > pos + 1)
+                && (pos_open_paren[1] == ')'))
+            {
+                new_path->hashtable_key = string_strndup (
+                    pos + 1, pos_open_paren - pos - 1);
+                new_path->hashtable_property = 1;
+            }
+            else
+            {
+                new_path->hashtable_key = strdup (pos + 1);
+            }
+            if (!new_path->hashtable_key)
+                goto error;
+        }
+
+        /* other types: the remaining path is ignored */
+        break;
+    }
+
+    return new_path;
+
+error:
+    hdata_path_free (new_path);
+    return NULL;
+}
+
+/*
+ * Free a compiled path in cache of hdata.
+ */
+
+void
+hdata_free_path_cb (struct t_hashtable *hashtable, const void *key,
+                    void *value)
+{
+    /* make C compiler happy */
+    (void) hashtable;
+    (void) key;
+
+    hdata_path_free ((struct t_hdata_path *)value);
+}
+
+/*
+ * Get a compiled path from cache of hdata, compile it if it is not yet in
+ * cache (or if hdata have changed since it was compiled).
+ *
+ * Return pointer to compiled path, NULL if error.
+ *
+ * Note: result must NOT be freed.
+ */
+
+struct t_hdata_path *
+hdata_path_get_cached (struct t_hdata *hdata, const char *path)
+{
+    struct t_hdata_path *ptr_path;
+
+    if (!hdata || !path)
+        return NULL;
+
+    if (!hdata->hash_path)
+    {
+        hdata->hash_path = hashtable_new (32,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          WEECHAT_HASHTABLE_POINTER,
+                                          NULL,
+                                          NULL);
+        if (!hdata->hash_path)
+            return NULL;
+        hdata->hash_path->callback_free_value = &hdata_free_path_cb;
+    }
+
+    ptr_path = hashtable_get (hdata->hash_path, path);
+    if (ptr_path && (ptr_path->generation == hdata_generation))
+        return ptr_path;
+
+    if (!ptr_path
+        && (hdata->hash_path->items_count >= HDATA_PATH_CACHE_SIZE))
+    {
+        hashtable_remove_all (hdata->hash_path);
+    }
+
+    ptr_path = hdata_path_compile (hdata, path);
+    if (!ptr_path)
+    {
+        hashtable_remove (hdata->hash_path, path);
+        return NULL;
+    }
+    if (!hashtable_set (hdata->hash_path, path, ptr_path))
+    {
+        hdata_path_free (ptr_path);
+        return NULL;
+    }
+
+    return ptr_path;
+}
+
+/*
+ * Get pointer to content of a variable of compiled path in an object
+ * (item of array if the variable has an index).
+ */
+
+void *
+hdata_path_var_get (struct t_hdata_path_var *var, void *pointer)
+{
+    void *ptr_array;
+    int size;
+
+    if (!var->array)
+        return pointer + var->offset;
+
+    if (var->array_pointer)
+    {
+        ptr_array = *((void **)(pointer + var->offset));
+        if (!ptr_array)
+            return NULL;
+    }
+    else
+    {
+        ptr_array = pointer + var->offset;
+    }
+
+    switch (var->type)
+    {
+        case WEECHAT_HDATA_CHAR:
+            size = sizeof (char);
+            break;
+        case WEECHAT_HDATA_INTEGER:
+            size = sizeof (int);
+            break;
+        case WEECHAT_HDATA_LONG:
+            size = sizeof (long);
+            break;
+        case WEECHAT_HDATA_LONGLONG:
+            size = sizeof (long long);
+            break;
+        case WEECHAT_HDATA_TIME:
+            size = sizeof (time_t);
+            break;
+        default:
+            size = sizeof (void *);
+            break;
+    }
+
+    return ptr_array + (var->index * size);
+}
+
+/*
+ * Get pointer to content of the last variable of a compiled path, starting
+ * with an object (same as function hdata_get_var, with a path).
+ *
+ * Return NULL if a pointer in path is NULL.
+ */
+
+void *
+hdata_path_get_var (struct t_hdata_path *path, void *pointer)
+{
+    void *ptr_value;
+    int i;
+
+    if (!path || !pointer)
+        return NULL;
+
+    for (i = 0; i < path->vars_count - 1; i++)
+    {
+        ptr_value = hdata_path_var_get (&(path->vars[i]), pointer);
+        pointer = (ptr_value) ? *((void **)ptr_value) : NULL;
+        if (!pointer)
+            return NULL;
+    }
+
+    return hdata_path_var_get (&(path->vars[path->vars_count - 1]), pointer);
+}
+
+/*
+ * Get value of the last variable of a compiled path, starting with an object,
+ * as string (same format as evaluation of hdata in expressions).
+ *
+ * If a pointer in path is NULL, an empty string is returned.
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+hdata_path_get_value (struct t_hdata_path *path, void *pointer)
+{
+    struct t_hdata_path_var *ptr_var;
+    struct t_hashtable *hashtable;
+    void *ptr_value;
+    const char *ptr_string;
+    char str_value[128];
+    int i;
+
+    if (!path)
+        return NULL;
+
+    for (i = 0; i < path->vars_count - 1; i++)
+    {
+        if (!pointer)
+            break;
+        ptr_value = hdata_path_var_get (&(path->vars[i]), pointer);
+        pointer = (ptr_value) ? *((void **)ptr_value) : NULL;
+    }
+    if (!pointer)
+        return strdup ("");
+
+    ptr_var = &(path->vars[path->vars_count - 1]);
+    ptr_value = hdata_path_var_get (ptr_var, pointer);
+
+    switch (ptr_var->type)
+    {
+        case WEECHAT_HDATA_CHAR:
+            snprintf (str_value, sizeof (str_value),
+                      "%c", (ptr_value) ? *((char *)ptr_value) : '\0');
+            return strdup (str_value);
+        case WEECHAT_HDATA_INTEGER:
+            snprintf (str_value, sizeof (str_value),
+                      "%d", (ptr_value) ? *((int *)ptr_value) : 0);
+            return strdup (str_value);
+        case WEECHAT_HDATA_LONG:
+            snprintf (str_value, sizeof (str_value),
+                      "%ld", (ptr_value) ? *((long *)ptr_value) : 0L);
+            return strdup (str_value);
+        case WEECHAT_HDATA_LONGLONG:
+            snprintf (str_value, sizeof (str_value),
+                      "%lld", (ptr_value) ? *((long long *)ptr_value) : 0LL);
+            return strdup (str_value);
+        case WEECHAT_HDATA_STRING:
+        case WEECHAT_HDATA_SHARED_STRING:
+            /* we cannot index a static array of strings */
+            if (!ptr_value || (ptr_var->array && !ptr_var->array_pointer))
+                return NULL;
+            ptr_string = *((char **)ptr_value);
+            return (ptr_string) ? strdup (ptr_string) : NULL;
+        case WEECHAT_HDATA_POINTER:
+            snprintf (str_value, sizeof (str_value),
+                      "0x%lx",
+                      (unsigned long)((ptr_value) ? *((void **)ptr_value) : NULL));
+            return strdup (str_value);
+        case WEECHAT_HDATA_TIME:
+            snprintf (str_value, sizeof (str_value),
+                      "%lld",
+                      (long long)((ptr_value) ? *((time_t *)ptr_value) : 0));
+            return strdup (str_value);
+        case WEECHAT_HDATA_HASHTABLE:
+            hashtable = (ptr_value) ?
+                *((struct t_hashtable **)ptr_value) : NULL;
+            if (!path->hashtable_key)
+            {
+                snprintf (str_value, sizeof (str_value),
+                          "0x%lx", (unsigned long)hashtable);
+                return strdup (str_value);
+            }
+            if (path->hashtable_property)
+            {
+                ptr_string = hashtable_get_string (hashtable,
+                                                   path->hashtable_key);
+                return (ptr_string) ? strdup (ptr_string) : NULL;
+            }
+            ptr_value = hashtable_get (hashtable, path->hashtable_key);
+            if (!ptr_value)
+                return NULL;
+            switch (hashtable->type_values)
+            {
+                case HASHTABLE_INTEGER:
+                    snprintf (str_value, sizeof (str_value),
+                              "%d", *((int *)ptr_value));
+                    return strdup (str_value);
+                case HASHTABLE_STRING:
+                    return strdup (ptr_value);
+                case HASHTABLE_POINTER:
+                case HASHTABLE_BUFFER:
+                    snprintf (str_value, sizeof (str_value),
+                              "0x%lx", (unsigned long)ptr_value);
+                    return strdup (str_value);
+                case HASHTABLE_TIME:
+                    snprintf (str_value, sizeof (str_value),
+                              "%lld", (long long)(*((time_t *)ptr_value)));
+                    return strdup (str_value);
+                case HASHTABLE_LONGLONG:
+                    snprintf (str_value, sizeof (str_value),
+                              "%lld", (long long)(*((long long *)ptr_value)));
+                    return strdup (str_value);
+                case HASHTABLE_NUM_TYPES:
+                    break;
+            }
+            break;
+    }
+
+    return NULL;
+}
+
+/*
+ * Free a compiled path.
+ */
+
+void
+hdata_path_free (struct t_hdata_path *path)
+{
+    if (!path)
+        return;
+
+    free (path->path);
+    free (path->vars);
+    free (path->hashtable_key);
+
+    free (path);
+}
+
 /*
  * Set value for a variable in hdata.
  *
@@ -1421,9 +1818,12 @@ hdata_free (struct t_hdata *hdata)
     free (hdata->var_prev);
     free (hdata->var_next);
     hashtable_free (hdata->hash_list);
+    hashtable_free (hdata->hash_path);
     free (hdata->name);
 
     free (hdata);
+
+    hdata_generation++;
 }
 
 /*
@@ -1517,6 +1917,9 @@ hdata_print_log_map_cb (void *data, struct t_hashtable *hashtable,
     log_printf ("  hash_list. . . . . . . : %p (hashtable: '%s')",
                 ptr_hdata->hash_list,
                 hashtable_get_string (ptr_hdata->hash_list, "keys_values"));
+    log_printf ("  hash_path. . . . . . . : %p (hashtable: '%s')",
+                ptr_hdata->hash_path,
+                hashtable_get_string (ptr_hdata->hash_path, "keys"));
     log_printf ("  create_allowed . . . . : %d", (int)ptr_hdata->create_allowed);
     log_printf ("  delete_allowed . . . . : %d", (int)ptr_hdata->delete_allowed);
     log_printf ("  callback_update. . . . : %p", ptr_hdata->callback_update);
@@ -36,6 +36,9 @@
     hdata_new_var (hdata, __name, offsetof (__struct, __field),         \
                    WEECHAT_HDATA_##__type, __update_allowed,            \
                    __array_size, __hdata_name)
+/* max number of compiled paths kept in cache of each hdata */
+#define HDATA_PATH_CACHE_SIZE 256
+
 /* create a hdata list */
 #define HDATA_LIST(__name, __flags)                                     \
     hdata_new_list (hdata, #__name, &(__name), __flags);
@@ -51,6 +54,28 @@ struct t_hdata_var
     char *hdata_name;                  /* hdata name                        */
 };
 
+struct t_hdata_path_var
+{
+    int offset;                        /* offset of variable                */
+    char type;                         /* type of variable                  */
+    char array;                        /* 1 if an item of array is read     */
+    char array_pointer;                /* pointer to dynamically allocated  */
+                                       /* array?                            */
+    int index;                         /* index in array (if array == 1)    */
+};
+
+struct t_hdata_path
+{
+    char *path;                        /* path (for example: "a.b.c")       */
+    int vars_count;                    /* number of variables in path       */
+    struct t_hdata_path_var *vars;     /* variables (offset, type, index)   */
+    char *hashtable_key;               /* key in hashtable (if last var is  */
+                                       /* a hashtable followed by a key)    */
+    char hashtable_property;           /* 1 if key is a property of         */
+                                       /* hashtable: "name()"               */
+    long long generation;              /* hdata generation at compile time  */
+};
+
 struct t_hdata_list
 {
     void *pointer;                     /* list pointer                      */
@@ -69,6 +94,7 @@ struct t_hdata
     struct t_hashtable *hash_var;      /* hash with type & offset of vars   */
     struct t_hashtable *hash_list;     /* hashtable with pointers on lists  */
                                        /* (used to search objects)          */
+    struct t_hashtable *hash_path;     /* compiled paths (cache)            */
 
     char create_allowed;               /* create allowed?                   */
     char delete_allowed;               /* delete allowed?                   */
@@ -86,6 +112,7 @@ struct t_hdata
 extern struct t_hashtable *weechat_hdata;
 
 extern char *hdata_type_string[];
+extern long long hdata_generation;
 
 extern struct t_hdata *hdata_new (struct t_weechat_plugin *plugin,
                                   const char *hdata_name, const char *var_prev,
@@ -146,6 +173,13 @@ extern struct t_hashtable *hdata_hashtable (struct t_hdata *hdata,
 extern int hdata_compare (struct t_hdata *hdata, void *pointer1,
                           void *pointer2, const char *name,
                           int case_sensitive);
+extern struct t_hdata_path *hdata_path_compile (struct t_hdata *hdata,
+                                               const char *path);
+extern struct t_hdata_path *hdata_path_get_cached (struct t_hdata *hdata,
+                                                  const char *path);
+extern void *hdata_path_get_var (struct t_hdata_path *path, void *pointer);
+extern char *hdata_path_get_value (struct t_hdata_path *path, void *pointer);
+extern void hdata_path_free (struct t_hdata_path *path);
 extern int hdata_set (struct t_hdata *hdata, void *pointer, const char *name,
                       const char *value);
 extern int hdata_update (struct t_hdata *hdata, void *pointer,
@@ -60,10 +60,13 @@ int real_delete_pending = 0;           /* 1 if some hooks must be deleted   */
 
 int hook_socketpair_ok = 0;            /* 1 if socketpair() is OK           */
 
+int hook_profile_enabled = 0;          /* 1 if callbacks are profiled       */
+
 /* hook callbacks */
 t_callback_hook *hook_callback_add[HOOK_NUM_TYPES] =
-{ NULL, NULL, NULL, &hook_fd_add_cb, NULL, NULL, NULL, NULL, NULL, NULL,
-  NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+{ &hook_command_add_cb, NULL, &hook_timer_add_cb, &hook_fd_add_cb, NULL,
+  NULL, NULL, &hook_print_add_cb, &hook_signal_add_cb, NULL, NULL, NULL,
+  &hook_modifier_add_cb, NULL, NULL, NULL, NULL, NULL, NULL };
 t_callback_hook *hook_callback_remove[HOOK_NUM_TYPES] =
 { NULL, NULL, NULL, &hook_fd_remove_cb, NULL, NULL, NULL, NULL, NULL, NULL,
   NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
@@ -411,6 +414,7 @@ hook_init_data (struct t_hook *hook, struct t_weechat_plugin *plugin,
     hook->priority = priority;
     hook->callback_pointer = callback_pointer;
     hook->callback_data = callback_data;
+    hook->profile = NULL;
     hook->hook_data = NULL;
 
     if (weechat_debug_core >= 2)
@@ -492,9 +496,10 @@ hook_callback_start (struct t_hook *hook, struct t_hook_exec_cb *hook_exec_cb)
     else
         hook->running = 1;
 
-    if (debug_long_callbacks > 0)
+    if ((debug_long_callbacks > 0) || hook_profile_enabled
+        || (debug_loop_stall > 0))
     {
-        gettimeofday (&hook_exec_cb->start_time, NULL);
+        util_timeval_monotonic (&hook_exec_cb->start_time);
     }
     else
     {
@@ -519,11 +524,35 @@ hook_callback_end (struct t_hook *hook, struct t_hook_exec_cb *hook_exec_cb)
     else
         hook->running = 0;
 
-    if ((debug_long_callbacks > 0)
-        && (hook_exec_cb->start_time.tv_sec > 0))
+    if (hook_exec_cb->start_time.tv_sec == 0)
+        return;
+
+    util_timeval_monotonic (&end_time);
+    time_diff = util_timeval_diff (&hook_exec_cb->start_time, &end_time);
+    if (time_diff < 0)
+        time_diff = 0;
+
+    if (hook_profile_enabled)
+    {
+        if (!hook->profile)
+            hook->profile = calloc (1, sizeof (*hook->profile));
+        if (hook->profile)
+        {
+            hook->profile->calls++;
+            hook->profile->time_total += time_diff;
+            if (time_diff > hook->profile->time_max)
+                hook->profile->time_max = time_diff;
+            hook->profile->time_last[hook->profile->time_last_index] = time_diff;
+            hook->profile->time_last_index =
+                (hook->profile->time_last_index + 1) % HOOK_PROFILE_NUM_LAST;
+        }
+    }
+
+    if (debug_loop_stall > 0)
+        debug_loop_add_callback (hook, time_diff);
+
+    if (debug_long_callbacks > 0)
     {
-        gettimeofday (&end_time, NULL);
-        time_diff = util_timeval_diff (&hook_exec_cb->start_time, &end_time);
         if (time_diff >= debug_long_callbacks)
         {
             str_diff = util_get_microseconds_string ((unsigned long long)time_diff);
@@ -540,6 +569,31 @@ hook_callback_end (struct t_hook *hook, struct t_hook_exec_cb *hook_exec_cb)
     }
 }
 
+/*
+ * Reset profiling data of all hooks (data is freed and allocated again on
+ * next call of callbacks if profiling is enabled).
+ */
+
+void
+hook_profile_reset (void)
+{
+    int type;
+    struct t_hook *ptr_hook;
+
+    for (type = 0; type < HOOK_NUM_TYPES; type++)
+    {
+        for (ptr_hook = weechat_hooks[type]; ptr_hook;
+             ptr_hook = ptr_hook->next_hook)
+        {
+            if (ptr_hook->profile)
+            {
+                free (ptr_hook->profile);
+                ptr_hook->profile = NULL;
+            }
+        }
+    }
+}
+
 /*
  * Return description of hook.
  *
@@ -722,6 +776,11 @@ unhook (struct t_hook *hook)
         free (hook->callback_data);
         hook->callback_data = NULL;
     }
+    if (hook->profile)
+    {
+        free (hook->profile);
+        hook->profile = NULL;
+    }
 
     /* remove hook from list (if there's no hook exec pending) */
     if (hook_exec_recursion == 0)
@@ -815,6 +874,7 @@ hook_hdata_hook_cb (const void *pointer, void *data, const char *hdata_name)
         HDATA_VAR(struct t_hook, priority, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook, callback_pointer, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook, callback_data, POINTER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook, profile, POINTER, 0, NULL, "hook_profile");
         HDATA_VAR(struct t_hook, hook_data, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook, prev_hook, POINTER, 0, NULL, hdata_name);
         HDATA_VAR(struct t_hook, next_hook, POINTER, 0, NULL, hdata_name);
@@ -832,6 +892,32 @@ hook_hdata_hook_cb (const void *pointer, void *data, const char *hdata_name)
     return hdata;
 }
 
+/*
+ * Return hdata for profiling data of hook.
+ */
+
+struct t_hdata *
+hook_hdata_hook_profile_cb (const void *pointer, void *data,
+                            const char *hdata_name)
+{
+    struct t_hdata *hdata;
+
+    /* make C compiler happy */
+    (void) pointer;
+    (void) data;
+
+    hdata = hdata_new (NULL, hdata_name, NULL, NULL, 0, 0, NULL, NULL);
+    if (hdata)
+    {
+        HDATA_VAR(struct t_hook_profile, calls, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_profile, time_total, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_profile, time_max, LONGLONG, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_profile, time_last, LONGLONG, 0, "16", NULL);
+        HDATA_VAR(struct t_hook_profile, time_last_index, INTEGER, 0, NULL, NULL);
+    }
+    return hdata;
+}
+
 /*
  * Add a hook in an infolist.
  *
@@ -1002,6 +1088,13 @@ hook_print_log (void)
             log_printf ("  priority. . . . . . . . : %d", ptr_hook->priority);
             log_printf ("  callback_pointer. . . . : %p", ptr_hook->callback_pointer);
             log_printf ("  callback_data . . . . . : %p", ptr_hook->callback_data);
+            log_printf ("  profile . . . . . . . . : %p", ptr_hook->profile);
+            if (ptr_hook->profile)
+            {
+                log_printf ("    calls . . . . . . . . : %lld", ptr_hook->profile->calls);
+                log_printf ("    time_total. . . . . . : %lld", ptr_hook->profile->time_total);
+                log_printf ("    time_max. . . . . . . : %lld", ptr_hook->profile->time_max);
+            }
             if (ptr_hook->deleted)
                 continue;
 
@@ -87,6 +87,19 @@ enum t_hook_type
  */
 #define HOOK_PRIORITY_DEFAULT   1000
 
+/* number of last execution times kept for each hook (when profiling) */
+#define HOOK_PROFILE_NUM_LAST     16
+
+struct t_hook_profile
+{
+    long long calls;                   /* number of calls of callback       */
+    long long time_total;              /* total time in callback (in µs)    */
+    long long time_max;                /* max time in callback (in µs)      */
+    long long time_last[HOOK_PROFILE_NUM_LAST];
+                                       /* last times in callback (in µs)    */
+    int time_last_index;               /* index of next time in array above */
+};
+
 typedef void (t_callback_hook)(struct t_hook *hook);
 typedef char *(t_callback_hook_get_desc)(struct t_hook *hook);
 typedef int (t_callback_hook_infolist)(struct t_infolist_item *item,
@@ -108,6 +121,9 @@ struct t_hook
     const void *callback_pointer;      /* pointer sent to callback          */
     void *callback_data;               /* data sent to callback             */
 
+    struct t_hook_profile *profile;    /* profiling data (allocated only   */
+                                       /* if hook_profile_enabled == 1)     */
+
     /* hook data (depends on hook type) */
     void *hook_data;                   /* hook specific data                */
     struct t_hook *prev_hook;          /* link to previous hook             */
@@ -129,6 +145,7 @@ extern int hooks_count[];
 extern int hooks_count_total;
 extern int hook_socketpair_ok;
 extern long long hook_debug_long_callbacks;
+extern int hook_profile_enabled;
 
 /* hook functions */
 
@@ -145,6 +162,7 @@ extern void hook_callback_start (struct t_hook *hook,
                                  struct t_hook_exec_cb *hook_exec_cb);
 extern void hook_callback_end (struct t_hook *hook,
                                struct t_hook_exec_cb *hook_exec_cb);
+extern void hook_profile_reset (void);
 extern char *hook_get_description (struct t_hook *hook);
 extern void hook_set (struct t_hook *hook, const char *property,
                       const char *value);
@@ -156,6 +174,9 @@ extern void unhook_all (void);
 extern struct t_hdata *hook_hdata_hook_cb (const void *pointer,
                                            void *data,
                                            const char *hdata_name);
+extern struct t_hdata *hook_hdata_hook_profile_cb (const void *pointer,
+                                                   void *data,
+                                                   const char *hdata_name);
 extern int hook_add_to_infolist (struct t_infolist *infolist,
                                  struct t_hook *hook,
                                  const char *arguments);
@@ -31,6 +31,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -42,6 +43,7 @@
 #include <resolv.h>
 #include <errno.h>
 #include <gcrypt.h>
+#include <pthread.h>
 #include <sys/time.h>
 #if defined(__OpenBSD__)
 #include <sys/uio.h>
@@ -71,6 +73,29 @@ int network_num_certs = 0;        /* number of certs loaded (system + user) */
 
 gnutls_certificate_credentials_t gnutls_xcred; /* GnuTLS client credentials */
 
+/* pool of threads used to connect (see network_connect_with_thread) */
+struct t_network_connect_job
+{
+    struct t_hook hook;                /* copy of hook used by thread       */
+    struct t_hook_connect hook_connect; /* copy of connect data (address,   */
+                                       /* port, ...) + socket once connected*/
+    int refcount;                      /* 2 = used by hook and thread       */
+    int cancelled;                     /* 1 if hook has been removed        */
+    struct t_network_connect_job *next_job; /* link to next job in queue    */
+};
+
+pthread_mutex_t network_connect_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t network_connect_cond = PTHREAD_COND_INITIALIZER;
+struct t_network_connect_job *network_connect_jobs = NULL;
+struct t_network_connect_job *last_network_connect_job = NULL;
+int network_connect_jobs_count = 0;    /* number of jobs in queue           */
+int network_connect_threads = 0;       /* number of threads running         */
+int network_connect_threads_idle = 0;  /* number of threads waiting a job   */
+int network_connect_threads_max = 0;   /* max threads (option)              */
+int network_connect_threads_stop = 0;  /* 1 if threads must exit            */
+struct timeval network_connect_threads_last_activity = { 0, 0 };
+                                       /* last job started/done by threads  */
+
 
 /*
  * Initialize gcrypt.
@@ -304,6 +329,8 @@ network_end (void)
         }
         network_init_gnutls_ok = 0;
     }
+
+    network_connect_threads_end ();
 }
 
 /*
@@ -790,11 +817,152 @@ network_pass_proxy (const char *proxy, int sock, const char *address, int port)
     return rc;
 }
 
+/*
+ * Free a connect job.
+ *
+ * Note: mutex network_connect_mutex must be locked (or no thread running).
+ */
+
+void
+network_connect_job_free (struct t_network_connect_job *job)
+{
+    if (!job)
+        return;
+
+    if (job->hook_connect.sock != -1)
+        close (job->hook_connect.sock);
+    if (job->hook_connect.child_write != -1)
+        close (job->hook_connect.child_write);
+    free (job->hook_connect.address);
+    free (job->hook_connect.local_hostname);
+
+    free (job);
+}
+
+/*
+ * Release a reference on a connect job, free the job if it is not used any
+ * more by the hook and the thread.
+ *
+ * Note: mutex network_connect_mutex must be locked.
+ */
+
+void
+network_connect_job_unref (struct t_network_connect_job *job)
+{
+    job->refcount--;
+    if (job->refcount <= 0)
+        network_connect_job_free (job);
+}
+
+/*
+ * Cancel a connect job (called when the connect hook is removed).
+ *
+ * The thread may still be connecting: it stops as soon as possible and the
+ * socket (if connected) is closed when the job is freed.
+ */
+
+void
+network_connect_job_cancel (struct t_network_connect_job *job)
+{
+    if (!job)
+        return;
+
+    pthread_mutex_lock (&network_connect_mutex);
+    job->cancelled = 1;
+    network_connect_job_unref (job);
+    pthread_mutex_unlock (&network_connect_mutex);
+}
+
+/*
+ * Check if a connect job has been cancelled.
+ *
+ * Return:
+ *   1: job cancelled
+ *   0: job not cancelled
+ */
+
+int
+network_connect_job_is_cancelled (struct t_network_connect_job *job)
+{
+    int cancelled;
+
+    pthread_mutex_lock (&network_connect_mutex);
+    cancelled = job->cancelled;
+    pthread_mutex_unlock (&network_connect_mutex);
+
+    return cancelled;
+}
+
+/*
+ * Take the socket connected by the thread of a connect job: the socket is
+ * not closed any more when the job is freed.
+ *
+ * Return the socket, -1 if no socket is connected.
+ */
+
+int
+network_connect_job_take_sock (struct t_network_connect_job *job)
+{
+    int sock;
+
+    pthread_mutex_lock (&network_connect_mutex);
+    sock = job->hook_connect.sock;
+    job->hook_connect.sock = -1;
+    pthread_mutex_unlock (&network_connect_mutex);
+
+    return sock;
+}
+
+/*
+ * Create a socket with flag "close-on-exec", so that it is not inherited by
+ * processes executed with hook_process (the socket may be created in a thread
+ * while the main thread runs a process).
+ *
+ * Return the socket, -1 if error.
+ */
+
+int
+network_socket (int domain, int type, int protocol)
+{
+    int sock;
+
+#ifdef SOCK_CLOEXEC
+    sock = socket (domain, type | SOCK_CLOEXEC, protocol);
+#else
+    sock = socket (domain, type, protocol);
+    if (sock >= 0)
+        fcntl (sock, F_SETFD, FD_CLOEXEC);
+#endif /* SOCK_CLOEXEC */
+
+    return sock;
+}
+
+/*
+ * Create a pipe with flag "close-on-exec" on both ends.
+ *
+ * Return:
+ *    0: OK
+ *   -1: error
+ */
+
+int
+network_pipe (int fds[2])
+{
+    if (pipe (fds) < 0)
+        return -1;
+
+    fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl (fds[1], F_SETFD, FD_CLOEXEC);
+
+    return 0;
+}
+
 /*
  * Connect to a remote host and wait for connection if socket is non blocking.
  *
  * WARNING: this function is blocking, it must be called only in a forked
- * process.
+ * process or in a thread of the pool (then job is not NULL and the wait is
+ * interrupted if the job is cancelled).
  *
  * Return:
  *   1: OK
@@ -802,7 +970,8 @@ network_pass_proxy (const char *proxy, int sock, const char *address, int port)
  */
 
 int
-network_connect (int sock, const struct sockaddr *addr, socklen_t addrlen)
+network_connect (int sock, const struct sockaddr *addr, socklen_t addrlen,
+                 struct t_network_connect_job *job)
 {
     struct pollfd poll_fd;
     int ready, value;
@@ -824,9 +993,11 @@ network_connect (int sock, const struct sockaddr *addr, socklen_t addrlen)
         poll_fd.fd = sock;
         poll_fd.events = POLLOUT;
         poll_fd.revents = 0;
-        ready = poll (&poll_fd, 1, -1);
+        ready = poll (&poll_fd, 1, (job) ? 100 : -1);
         if (ready < 0)
             break;
+        if ((ready == 0) && job && network_connect_job_is_cancelled (job))
+            break;
         if (ready > 0)
         {
             len = sizeof (value);
@@ -900,21 +1071,21 @@ network_connect_to (const char *proxy, struct sockaddr *address,
         }
 
         /* connect and pass address to proxy */
-        sock = socket (proxy_addrinfo->ai_family, SOCK_STREAM, 0);
+        sock = network_socket (proxy_addrinfo->ai_family, SOCK_STREAM, 0);
         if (sock == -1)
             goto error;
         if (!network_connect (sock, proxy_addrinfo->ai_addr,
-                              proxy_addrinfo->ai_addrlen))
+                              proxy_addrinfo->ai_addrlen, NULL))
             goto error;
         if (!network_pass_proxy (proxy, sock, ip, port))
             goto error;
     }
     else
     {
-        sock = socket (address->sa_family, SOCK_STREAM, 0);
+        sock = network_socket (address->sa_family, SOCK_STREAM, 0);
         if (sock == -1)
             goto error;
-        if (!network_connect (sock, address, address_length))
+        if (!network_connect (sock, address, address_length, NULL))
             goto error;
     }
 
@@ -932,7 +1103,10 @@ error:
 }
 
 /*
- * Connect to peer in a child process.
+ * Connect to peer in a child process, or in a thread of the pool if
+ * connect_job is set in hook (then hook_connect is the copy of hook stored
+ * in the job, and the socket is kept in the job instead of being sent to
+ * the parent process).
  */
 
 void
@@ -961,6 +1135,7 @@ network_connect_child (struct t_hook *hook_connect)
     int num_groups, tmp_num_groups, num_hosts, tmp_host;
     struct addrinfo **res_reorder;
     int last_af;
+    unsigned int seed;
     struct timeval tv_time;
 
     res_local = NULL;
@@ -974,7 +1149,8 @@ network_connect_child (struct t_hook *hook_connect)
     ptr_address = NULL;
 
     gettimeofday (&tv_time, NULL);
-    srand ((tv_time.tv_sec * tv_time.tv_usec) ^ getpid ());
+    seed = (tv_time.tv_sec * tv_time.tv_usec) ^ getpid ()
+        ^ (unsigned int)((uintptr_t)hook_connect);
 
     ptr_proxy = NULL;
     if (HOOK_CONNECT(hook_connect, proxy)
@@ -1202,7 +1378,7 @@ network_connect_child (struct t_hook *hook_connect)
             if (tmp_num_groups >= retry)
             {
                 /* shuffle while adding */
-                rand_num = tmp_host + (rand () % ((i + 1) - tmp_host));
+                rand_num = tmp_host + (rand_r (&seed) % ((i + 1) - tmp_host));
                 if (rand_num == i)
                     res_reorder[i++] = ptr_res;
                 else
@@ -1233,7 +1409,7 @@ network_connect_child (struct t_hook *hook_connect)
             if (tmp_num_groups < retry)
             {
                 /* shuffle while adding */
-                rand_num = tmp_host + (rand () % ((i + 1) - tmp_host));
+                rand_num = tmp_host + (rand_r (&seed) % ((i + 1) - tmp_host));
                 if (rand_num == i)
                     res_reorder[i++] = ptr_res;
                 else
@@ -1267,12 +1443,12 @@ network_connect_child (struct t_hook *hook_connect)
     {
         ptr_res = res_reorder[i];
 
-        if (hook_socketpair_ok)
+        if (hook_socketpair_ok || HOOK_CONNECT(hook_connect, connect_job))
         {
             /* create a socket */
-            sock = socket (ptr_res->ai_family,
-                           ptr_res->ai_socktype,
-                           ptr_res->ai_protocol);
+            sock = network_socket (ptr_res->ai_family,
+                                   ptr_res->ai_socktype,
+                                   ptr_res->ai_protocol);
         }
         else
         {
@@ -1347,7 +1523,8 @@ network_connect_child (struct t_hook *hook_connect)
         }
 
         /* connect to peer */
-        if (network_connect (sock, ptr_res->ai_addr, ptr_res->ai_addrlen))
+        if (network_connect (sock, ptr_res->ai_addr, ptr_res->ai_addrlen,
+                             HOOK_CONNECT(hook_connect, connect_job)))
         {
             status_str[0] = '0' + WEECHAT_HOOK_CONNECT_OK;
             rc = getnameinfo (ptr_res->ai_addr, ptr_res->ai_addrlen,
@@ -1407,7 +1584,11 @@ network_connect_child (struct t_hook *hook_connect)
         }
 
         /* send the socket to the parent process */
-        if (hook_socketpair_ok)
+        if (HOOK_CONNECT(hook_connect, connect_job))
+        {
+            /* in a thread: socket is kept in job and taken by main thread */
+        }
+        else if (hook_socketpair_ok)
         {
             memset (&msg, 0, sizeof (msg));
             msg.msg_control = msg_buf;
@@ -1515,8 +1696,9 @@ network_connect_gnutls_handshake_fd_cb (const void *pointer, void *data,
             || (((flags & HOOK_FD_FLAG_WRITE) == HOOK_FD_FLAG_WRITE)
                 && (direction != 1)))
         {
-            HOOK_FD(HOOK_CONNECT(hook_connect, handshake_hook_fd), flags) =
-                (direction) ? HOOK_FD_FLAG_WRITE: HOOK_FD_FLAG_READ;
+            hook_fd_set_flags (HOOK_CONNECT(hook_connect, handshake_hook_fd),
+                               (direction) ?
+                               HOOK_FD_FLAG_WRITE : HOOK_FD_FLAG_READ);
         }
     }
     else if (rc != GNUTLS_E_SUCCESS)
@@ -1638,7 +1820,13 @@ network_connect_child_read_cb (const void *pointer, void *data, int fd)
                 }
             }
 
-            if (hook_socketpair_ok)
+            if (HOOK_CONNECT(hook_connect, connect_job))
+            {
+                /* get the socket connected by the thread */
+                sock = network_connect_job_take_sock (
+                    HOOK_CONNECT(hook_connect, connect_job));
+            }
+            else if (hook_socketpair_ok)
             {
                 /* receive the socket from the child process */
                 memset (&msg, 0, sizeof (msg));
@@ -1797,7 +1985,291 @@ network_connect_child_read_cb (const void *pointer, void *data, int fd)
 }
 
 /*
- * Connect with fork (called by hook_connect() only!).
+ * Add the timer (for timeout) and the fd hook to read the connection
+ * progress sent by child process or thread.
+ */
+
+void
+network_connect_hook_child (struct t_hook *hook_connect)
+{
+    HOOK_CONNECT(hook_connect, hook_child_timer) = hook_timer (hook_connect->plugin,
+                                                               CONFIG_INTEGER(config_network_connection_timeout) * 1000,
+                                                               0, 1,
+                                                               &network_connect_child_timer_cb,
+                                                               hook_connect,
+                                                               NULL);
+    HOOK_CONNECT(hook_connect, hook_fd) = hook_fd (hook_connect->plugin,
+                                                   HOOK_CONNECT(hook_connect, child_read),
+                                                   1, 0, 0,
+                                                   &network_connect_child_read_cb,
+                                                   hook_connect, NULL);
+}
+
+/*
+ * Thread of the connect pool: run connect jobs from the queue, one after
+ * another.
+ *
+ * The thread exits when there are more threads running than the max allowed
+ * (option weechat.network.connection_threads), or when the pool is stopped.
+ */
+
+void *
+network_connect_thread_run (void *arg)
+{
+    struct t_network_connect_job *job;
+
+    /* make C compiler happy */
+    (void) arg;
+
+    pthread_mutex_lock (&network_connect_mutex);
+
+    while (!network_connect_threads_stop)
+    {
+        /* too many threads (option has been decreased) */
+        if (network_connect_threads > network_connect_threads_max)
+            break;
+        if (!network_connect_jobs)
+        {
+            network_connect_threads_idle++;
+            pthread_cond_wait (&network_connect_cond, &network_connect_mutex);
+            network_connect_threads_idle--;
+            continue;
+        }
+
+        /* remove first job from queue */
+        job = network_connect_jobs;
+        network_connect_jobs = job->next_job;
+        if (!network_connect_jobs)
+            last_network_connect_job = NULL;
+        network_connect_jobs_count--;
+        util_timeval_monotonic (&network_connect_threads_last_activity);
+
+        if (!job->cancelled)
+        {
+            pthread_mutex_unlock (&network_connect_mutex);
+            network_connect_child (&(job->hook));
+            pthread_mutex_lock (&network_connect_mutex);
+        }
+
+        /* close pipe: main thread reads end of file if nothing was sent */
+        close (job->hook_connect.child_write);
+        job->hook_connect.child_write = -1;
+
+        network_connect_job_unref (job);
+        util_timeval_monotonic (&network_connect_threads_last_activity);
+    }
+
+    network_connect_threads--;
+
+    /* wake up another thread for the jobs still in queue */
+    if (network_connect_jobs)
+        pthread_cond_signal (&network_connect_cond);
+
+    pthread_mutex_unlock (&network_connect_mutex);
+
+    return NULL;
+}
+
+/*
+ * Check if the pool of connect threads is stuck: no thread is available for
+ * a new job and no job has been started or completed by threads for
+ * NETWORK_CONNECT_THREADS_STUCK_DELAY seconds.
+ *
+ * A thread blocked in getaddrinfo() or connect() can not be cancelled (unlike
+ * a child process which is killed when the hook is removed), so the pool can
+ * be full of threads blocked for a long time.
+ *
+ * Note: mutex network_connect_mutex must be locked.
+ *
+ * Return:
+ *   1: pool of threads is stuck
+ *   0: pool of threads is OK
+ */
+
+int
+network_connect_threads_stuck (void)
+{
+    struct timeval tv_now;
+
+    if ((network_connect_jobs_count < network_connect_threads_idle)
+        || (network_connect_threads < network_connect_threads_max))
+    {
+        return 0;
+    }
+
+    util_timeval_monotonic (&tv_now);
+
+    return (util_timeval_diff (&network_connect_threads_last_activity,
+                               &tv_now) >=
+            NETWORK_CONNECT_THREADS_STUCK_DELAY * 1000000LL) ? 1 : 0;
+}
+
+/*
+ * Connect in a thread of the pool (called by network_connect_with_fork()
+ * only!).
+ *
+ * A copy of connect data is queued and processed by the first available
+ * thread; a new thread is started if all threads are busy and the max
+ * number of threads is not reached.
+ *
+ * Return:
+ *   1: connection is in progress in a thread
+ *   0: pool not used (disabled, proxy, pool stuck or error): caller must fork
+ */
+
+int
+network_connect_with_thread (struct t_hook *hook_connect)
+{
+    struct t_network_connect_job *job;
+    pthread_t thread_id;
+    pthread_attr_t attr;
+    int child_pipe[2], threads_max, rc;
+
+    threads_max = CONFIG_INTEGER(config_network_connection_threads);
+    if (threads_max <= 0)
+        return 0;
+
+    /* proxy options are read in config: connect with a child process */
+    if (HOOK_CONNECT(hook_connect, proxy)
+        && HOOK_CONNECT(hook_connect, proxy)[0])
+    {
+        return 0;
+    }
+
+    job = calloc (1, sizeof (*job));
+    if (!job)
+        return 0;
+    if (network_pipe (child_pipe) < 0)
+    {
+        free (job);
+        return 0;
+    }
+
+    job->hook.hook_data = &(job->hook_connect);
+    job->hook_connect.address = strdup (HOOK_CONNECT(hook_connect, address));
+    job->hook_connect.port = HOOK_CONNECT(hook_connect, port);
+    job->hook_connect.ipv6 = HOOK_CONNECT(hook_connect, ipv6);
+    job->hook_connect.sock = -1;
+    job->hook_connect.retry = HOOK_CONNECT(hook_connect, retry);
+    job->hook_connect.local_hostname = (HOOK_CONNECT(hook_connect, local_hostname)) ?
+        strdup (HOOK_CONNECT(hook_connect, local_hostname)) : NULL;
+    job->hook_connect.child_read = -1;
+    job->hook_connect.child_write = child_pipe[1];
+    job->hook_connect.child_recv = -1;
+    job->hook_connect.child_send = -1;
+    job->hook_connect.connect_job = job;
+    job->refcount = 2;
+    if (!job->hook_connect.address)
+    {
+        close (child_pipe[0]);
+        network_connect_job_free (job);
+        return 0;
+    }
+
+    pthread_mutex_lock (&network_connect_mutex);
+
+    if (network_connect_threads_stop)
+    {
+        pthread_mutex_unlock (&network_connect_mutex);
+        close (child_pipe[0]);
+        network_connect_job_free (job);
+        return 0;
+    }
+
+    network_connect_threads_max = threads_max;
+
+    /* all threads are blocked: connect with a child process */
+    if (network_connect_threads_stuck ())
+    {
+        pthread_mutex_unlock (&network_connect_mutex);
+        close (child_pipe[0]);
+        network_connect_job_free (job);
+        return 0;
+    }
+
+    /* start a new thread if all threads are busy */
+    if ((network_connect_jobs_count >= network_connect_threads_idle)
+        && (network_connect_threads < network_connect_threads_max))
+    {
+        pthread_attr_init (&attr);
+        pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+        rc = pthread_create (&thread_id, &attr,
+                             &network_connect_thread_run, NULL);
+        pthread_attr_destroy (&attr);
+        if (rc == 0)
+        {
+            network_connect_threads++;
+            util_timeval_monotonic (&network_connect_threads_last_activity);
+        }
+        else if (network_connect_threads == 0)
+        {
+            pthread_mutex_unlock (&network_connect_mutex);
+            close (child_pipe[0]);
+            network_connect_job_free (job);
+            return 0;
+        }
+    }
+
+    /* add job to queue */
+    if (last_network_connect_job)
+        last_network_connect_job->next_job = job;
+    else
+        network_connect_jobs = job;
+    last_network_connect_job = job;
+    network_connect_jobs_count++;
+
+    /* wake up all threads if some must exit (option has been decreased) */
+    if (network_connect_threads > network_connect_threads_max)
+        pthread_cond_broadcast (&network_connect_cond);
+    else
+        pthread_cond_signal (&network_connect_cond);
+
+    pthread_mutex_unlock (&network_connect_mutex);
+
+    HOOK_CONNECT(hook_connect, child_read) = child_pipe[0];
+    HOOK_CONNECT(hook_connect, connect_job) = job;
+
+    network_connect_hook_child (hook_connect);
+
+    return 1;
+}
+
+/*
+ * Stop the pool of connect threads (called on exit).
+ *
+ * Jobs still in queue are freed, running threads exit after their current
+ * job.
+ */
+
+void
+network_connect_threads_end (void)
+{
+    struct t_network_connect_job *ptr_job, *next_job;
+
+    pthread_mutex_lock (&network_connect_mutex);
+
+    network_connect_threads_stop = 1;
+
+    ptr_job = network_connect_jobs;
+    while (ptr_job)
+    {
+        next_job = ptr_job->next_job;
+        /* release the reference of the thread */
+        network_connect_job_unref (ptr_job);
+        ptr_job = next_job;
+    }
+    network_connect_jobs = NULL;
+    last_network_connect_job = NULL;
+    network_connect_jobs_count = 0;
+
+    pthread_cond_broadcast (&network_connect_cond);
+
+    pthread_mutex_unlock (&network_connect_mutex);
+}
+
+/*
+ * Connect in a thread of the pool, or with fork if the pool is disabled or
+ * can not be used (called by hook_connect() only!).
  */
 
 void
@@ -1859,8 +2331,11 @@ network_connect_with_fork (struct t_hook *hook_connect)
                                   (gnutls_transport_ptr_t) ((unsigned long) HOOK_CONNECT(hook_connect, sock)));
     }
 
+    if (network_connect_with_thread (hook_connect))
+        return;
+
     /* create pipe for child process */
-    if (pipe (child_pipe) < 0)
+    if (network_pipe (child_pipe) < 0)
     {
         (void) (HOOK_CONNECT(hook_connect, callback))
             (hook_connect->callback_pointer,
@@ -1893,8 +2368,8 @@ network_connect_with_fork (struct t_hook *hook_connect)
     {
         for (i = 0; i < HOOK_CONNECT_MAX_SOCKETS; i++)
         {
-            HOOK_CONNECT(hook_connect, sock_v4[i]) = socket (AF_INET, SOCK_STREAM, 0);
-            HOOK_CONNECT(hook_connect, sock_v6[i]) = socket (AF_INET6, SOCK_STREAM, 0);
+            HOOK_CONNECT(hook_connect, sock_v4[i]) = network_socket (AF_INET, SOCK_STREAM, 0);
+            HOOK_CONNECT(hook_connect, sock_v6[i]) = network_socket (AF_INET6, SOCK_STREAM, 0);
         }
     }
 
@@ -1931,15 +2406,5 @@ network_connect_with_fork (struct t_hook *hook_connect)
         close (HOOK_CONNECT(hook_connect, child_send));
         HOOK_CONNECT(hook_connect, child_send) = -1;
     }
-    HOOK_CONNECT(hook_connect, hook_child_timer) = hook_timer (hook_connect->plugin,
-                                                               CONFIG_INTEGER(config_network_connection_timeout) * 1000,
-                                                               0, 1,
-                                                               &network_connect_child_timer_cb,
-                                                               hook_connect,
-                                                               NULL);
-    HOOK_CONNECT(hook_connect, hook_fd) = hook_fd (hook_connect->plugin,
-                                                   HOOK_CONNECT(hook_connect, child_read),
-                                                   1, 0, 0,
-                                                   &network_connect_child_read_cb,
-                                                   hook_connect, NULL);
+    network_connect_hook_child (hook_connect);
 }
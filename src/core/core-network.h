@@ -24,8 +24,18 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 
 struct t_hook;
+struct t_network_connect_job;
+
+/*
+ * delay (in seconds) after which the pool of connect threads is considered
+ * stuck if all threads are busy and no job has been started or completed
+ * (for example threads blocked in getaddrinfo): new connections are then
+ * made with a child process
+ */
+#define NETWORK_CONNECT_THREADS_STUCK_DELAY 5
 
 struct t_network_socks4
 {
@@ -49,6 +59,9 @@ extern int network_init_gnutls_ok;
 extern int network_num_certs_system;
 extern int network_num_certs_user;
 extern int network_num_certs;
+extern int network_connect_threads;
+extern int network_connect_threads_idle;
+extern struct timeval network_connect_threads_last_activity;
 
 extern void network_init_gcrypt (void);
 extern void network_load_ca_files (int force_display);
@@ -57,8 +70,11 @@ extern void network_init_gnutls (void);
 extern void network_end (void);
 extern int network_pass_proxy (const char *proxy, int sock,
                                const char *address, int port);
+extern void network_connect_job_cancel (struct t_network_connect_job *job);
 extern int network_connect_to (const char *proxy, struct sockaddr *address,
                                socklen_t address_length);
+extern int network_connect_threads_stuck (void);
+extern void network_connect_threads_end (void);
 extern void network_connect_with_fork (struct t_hook *hook_connect);
 
 #endif /* WEECHAT_NETWORK_H */
@@ -41,6 +41,11 @@
 #include <iconv.h>
 #endif
 
+#ifdef HAVE_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
 #ifndef ICONV_CONST
   #ifdef ICONV_2ARG_IS_CONST
     #define ICONV_CONST const
@@ -67,7 +72,22 @@
                     c - '0')
 #define MIN3(a, b, c) ((a) < (b) ? ((a) < (c) ? (a) : (c)) : ((b) < (c) ? (b) : (c)))
 
+#ifdef HAVE_PCRE2
+struct t_string_regex_pcre2
+{
+    pcre2_code *code;                  /* regex compiled by PCRE2           */
+    pcre2_match_data *match_data;      /* data for matches                  */
+    int positions;                     /* 1 if match positions are the same */
+                                       /* as with POSIX regex               */
+    int nosub;                         /* 1 if compiled with REG_NOSUB      */
+};
+#endif /* HAVE_PCRE2 */
+
 struct t_hashtable *string_hashtable_shared = NULL;
+string_shared_id_t string_shared_next_id = 1;
+struct t_hashtable *string_hashtable_highlight = NULL;
+struct t_string_highlight *string_highlight_first = NULL;
+struct t_string_highlight *string_highlight_last = NULL;
 int string_concat_index = 0;
 char **string_concat_buffer[STRING_NUM_CONCAT_BUFFERS];
 
@@ -1072,9 +1092,10 @@ string_match (const char *string, const char *mask, int case_sensitive)
             }
             while (1)
             {
+                /* next occurrence may overlap the current one */
                 pos_word2 = (case_sensitive) ?
-                    strstr (pos_word + length_word, word) :
-                    string_strcasestr (pos_word + length_word, word);
+                    strstr (utf8_next_char (pos_word), word) :
+                    string_strcasestr (utf8_next_char (pos_word), word);
                 if (!pos_word2)
                     break;
                 pos_word = pos_word2;
@@ -1742,6 +1763,334 @@ string_regex_flags (const char *regex, int default_flags, int *flags)
     return ptr_regex;
 }
 
+/*
+ * Convert a POSIX extended regular expression to a PCRE2 pattern, with the
+ * same syntax and semantics.
+ *
+ * The regular expression can not be converted (NULL is returned) if it is
+ * not an extended regular expression (flag REG_EXTENDED), or if it uses
+ * constructs with different meaning in PCRE2: collating elements and
+ * equivalence classes in brackets ("[.x.]", "[=x=]"), consecutive
+ * quantifiers (like "a*?"), intervals without minimum ("{,n}"), groups
+ * starting with "(?" and unknown escaped letters.
+ *
+ * If "positions" is not NULL, it is set to 1 if match positions (including
+ * groups) are the same with PCRE2 and POSIX: this is not the case with
+ * alternations and quantified groups, because POSIX returns the leftmost
+ * longest match while PCRE2 returns the first match found.
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+string_regex_to_pcre2 (const char *regex, int flags, int *positions)
+{
+    char **result;
+    const char *ptr_regex, *pos;
+    int quantifier, group_end;
+
+    if (positions)
+        *positions = 1;
+
+    if (!regex || !(flags & REG_EXTENDED))
+        return NULL;
+
+    result = string_dyn_alloc (strlen (regex) * 2 + 1);
+    if (!result)
+        return NULL;
+
+    quantifier = 0;
+    group_end = 0;
+    ptr_regex = regex;
+    while (ptr_regex[0])
+    {
+        switch (ptr_regex[0])
+        {
+            case '\\':
+                if (!ptr_regex[1])
+                    goto error;
+                if (strchr (".[]{}()*+?|^$\\/wWsSbB123456789", ptr_regex[1]))
+                    string_dyn_concat (result, ptr_regex, 2);
+                else if (ptr_regex[1] == '<')
+                    string_dyn_concat (result, "\\b(?=\\w)", -1);
+                else if (ptr_regex[1] == '>')
+                    string_dyn_concat (result, "\\b(?<=\\w)", -1);
+                else if (ptr_regex[1] == '`')
+                    string_dyn_concat (result, "\\A", -1);
+                else if (ptr_regex[1] == '\'')
+                    string_dyn_concat (result, "\\z", -1);
+                else if (isalnum ((unsigned char)ptr_regex[1])
+                         || ((unsigned char)ptr_regex[1] >= 0x80))
+                    goto error;
+                else
+                    string_dyn_concat (result, ptr_regex, 2);
+                ptr_regex += 2;
+                quantifier = 0;
+                group_end = 0;
+                break;
+            case '[':
+                string_dyn_concat (result, "[", 1);
+                ptr_regex++;
+                if (ptr_regex[0] == '^')
+                {
+                    string_dyn_concat (result, "^", 1);
+                    /* with REG_NEWLINE, "[^...]" does not match a newline */
+                    if (flags & REG_NEWLINE)
+                        string_dyn_concat (result, "\\n", -1);
+                    ptr_regex++;
+                }
+                if (ptr_regex[0] == ']')
+                {
+                    string_dyn_concat (result, "\\]", -1);
+                    ptr_regex++;
+                }
+                while (ptr_regex[0] && (ptr_regex[0] != ']'))
+                {
+                    if ((ptr_regex[0] == '[') && (ptr_regex[1] == ':'))
+                    {
+                        pos = strstr (ptr_regex + 2, ":]");
+                        if (!pos)
+                            goto error;
+                        string_dyn_concat (result, ptr_regex,
+                                           pos + 2 - ptr_regex);
+                        ptr_regex = pos + 2;
+                    }
+                    else if ((ptr_regex[0] == '[')
+                             && ((ptr_regex[1] == '=') || (ptr_regex[1] == '.')))
+                    {
+                        goto error;
+                    }
+                    else
+                    {
+                        /* backslash and "[" are literal chars in POSIX */
+                        if ((ptr_regex[0] == '\\') || (ptr_regex[0] == '['))
+                            string_dyn_concat (result, "\\", 1);
+                        string_dyn_concat (result, ptr_regex, 1);
+                        ptr_regex++;
+                    }
+                }
+                if (!ptr_regex[0])
+                    goto error;
+                string_dyn_concat (result, "]", 1);
+                ptr_regex++;
+                quantifier = 0;
+                group_end = 0;
+                break;
+            case '{':
+                /* an interval is a quantifier, otherwise "{" is literal */
+                if (ptr_regex[1] == ',')
+                    goto error;
+                pos = ptr_regex + 1;
+                while (isdigit ((unsigned char)pos[0]))
+                {
+                    pos++;
+                }
+                if ((pos > ptr_regex + 1) && (pos[0] == ','))
+                {
+                    pos++;
+                    while (isdigit ((unsigned char)pos[0]))
+                    {
+                        pos++;
+                    }
+                }
+                if ((pos == ptr_regex + 1) || (pos[0] != '}'))
+                {
+                    string_dyn_concat (result, "\\{", -1);
+                    ptr_regex++;
+                    quantifier = 0;
+                    group_end = 0;
+                    break;
+                }
+                if (quantifier)
+                    goto error;
+                if (group_end && positions)
+                    *positions = 0;
+                string_dyn_concat (result, ptr_regex, pos + 1 - ptr_regex);
+                ptr_regex = pos + 1;
+                quantifier = 1;
+                group_end = 0;
+                break;
+            case '*':
+            case '+':
+            case '?':
+                if (quantifier)
+                    goto error;
+                if (group_end && positions)
+                    *positions = 0;
+                string_dyn_concat (result, ptr_regex, 1);
+                ptr_regex++;
+                quantifier = 1;
+                group_end = 0;
+                break;
+            case '(':
+                if (ptr_regex[1] == '?')
+                    goto error;
+                string_dyn_concat (result, ptr_regex, 1);
+                ptr_regex++;
+                quantifier = 0;
+                group_end = 0;
+                break;
+            case ')':
+                string_dyn_concat (result, ptr_regex, 1);
+                ptr_regex++;
+                quantifier = 0;
+                group_end = 1;
+                break;
+            case '|':
+                if (positions)
+                    *positions = 0;
+                string_dyn_concat (result, ptr_regex, 1);
+                ptr_regex++;
+                quantifier = 0;
+                group_end = 0;
+                break;
+            default:
+                string_dyn_concat (result, ptr_regex, 1);
+                ptr_regex++;
+                quantifier = 0;
+                group_end = 0;
+                break;
+        }
+    }
+
+    return string_dyn_free (result, 0);
+
+error:
+    string_dyn_free (result, 1);
+    return NULL;
+}
+
+#ifdef HAVE_PCRE2
+/*
+ * Compile a PCRE2 regex (with JIT if available) for a POSIX extended regex.
+ *
+ * Return pointer to PCRE2 regex, NULL if the regex can not be converted or
+ * compiled with PCRE2 (then the POSIX regex is used).
+ */
+
+struct t_string_regex_pcre2 *
+string_regex_pcre2_compile (const char *regex, int flags)
+{
+    struct t_string_regex_pcre2 *new_regex_pcre2;
+    pcre2_code *code;
+    pcre2_match_data *match_data;
+    PCRE2_SIZE error_offset;
+    uint32_t options;
+    char *pattern;
+    int error_code, positions;
+
+    pattern = string_regex_to_pcre2 (regex, flags, &positions);
+    if (!pattern)
+        return NULL;
+
+    options = PCRE2_UTF | PCRE2_UCP;
+#ifdef PCRE2_MATCH_INVALID_UTF
+    options |= PCRE2_MATCH_INVALID_UTF;
+#endif
+    if (flags & REG_ICASE)
+        options |= PCRE2_CASELESS;
+    if (flags & REG_NEWLINE)
+        options |= PCRE2_MULTILINE;
+    else
+        options |= PCRE2_DOTALL | PCRE2_DOLLAR_ENDONLY;
+    if (flags & REG_NOSUB)
+        options |= PCRE2_NO_AUTO_CAPTURE;
+
+    code = pcre2_compile ((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED, options,
+                          &error_code, &error_offset, NULL);
+    free (pattern);
+    if (!code)
+        return NULL;
+
+    /* JIT is optional: the interpreter is used if it fails */
+    (void) pcre2_jit_compile (code, PCRE2_JIT_COMPLETE);
+
+    match_data = pcre2_match_data_create_from_pattern (code, NULL);
+    new_regex_pcre2 = malloc (sizeof (*new_regex_pcre2));
+    if (!match_data || !new_regex_pcre2)
+    {
+        pcre2_match_data_free (match_data);
+        pcre2_code_free (code);
+        free (new_regex_pcre2);
+        return NULL;
+    }
+
+    new_regex_pcre2->code = code;
+    new_regex_pcre2->match_data = match_data;
+    new_regex_pcre2->positions = positions;
+    new_regex_pcre2->nosub = (flags & REG_NOSUB) ? 1 : 0;
+
+    return new_regex_pcre2;
+}
+
+/*
+ * Execute a PCRE2 regex, with same arguments and return code as function
+ * regexec.
+ *
+ * Return -1 if PCRE2 returned an error (the POSIX regex must be used).
+ */
+
+int
+string_regex_pcre2_exec (struct t_string_regex_pcre2 *regex_pcre2,
+                         const char *string, size_t nmatch,
+                         regmatch_t *pmatch, int eflags)
+{
+    PCRE2_SIZE *ovector;
+    uint32_t options;
+    size_t i;
+    int rc;
+
+    options = 0;
+    if (eflags & REG_NOTBOL)
+        options |= PCRE2_NOTBOL;
+    if (eflags & REG_NOTEOL)
+        options |= PCRE2_NOTEOL;
+
+    rc = pcre2_match (regex_pcre2->code, (PCRE2_SPTR)string,
+                      PCRE2_ZERO_TERMINATED, 0, options,
+                      regex_pcre2->match_data, NULL);
+    if (rc == PCRE2_ERROR_NOMATCH)
+        return REG_NOMATCH;
+    if (rc <= 0)
+        return -1;
+
+    if (pmatch && !regex_pcre2->nosub)
+    {
+        ovector = pcre2_get_ovector_pointer (regex_pcre2->match_data);
+        for (i = 0; i < nmatch; i++)
+        {
+            if ((i < (size_t)rc) && (ovector[i * 2] != PCRE2_UNSET))
+            {
+                pmatch[i].rm_so = ovector[i * 2];
+                pmatch[i].rm_eo = ovector[(i * 2) + 1];
+            }
+            else
+            {
+                pmatch[i].rm_so = -1;
+                pmatch[i].rm_eo = -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Free a PCRE2 regex.
+ */
+
+void
+string_regex_pcre2_free (struct t_string_regex_pcre2 *regex_pcre2)
+{
+    if (!regex_pcre2)
+        return;
+
+    pcre2_match_data_free (regex_pcre2->match_data);
+    pcre2_code_free (regex_pcre2->code);
+    free (regex_pcre2);
+}
+#endif /* HAVE_PCRE2 */
+
 /*
  * Compile a regex using optional flags at beginning of string (for format of
  * flags in regex, see string_regex_flags()).
@@ -1770,34 +2119,377 @@ string_regcomp (void *preg, const char *regex, int default_flags)
 }
 
 /*
- * Check if a string has a highlight (using list of words to highlight).
+ * Compile a regex which is kept and executed many times (for example in
+ * filters or highlight options), using optional flags at beginning of string
+ * (for format of flags in regex, see string_regex_flags()).
+ *
+ * The POSIX regex is always compiled. If WeeChat is built with PCRE2, the
+ * regex is also compiled with PCRE2 (with JIT if available) and used by
+ * function string_regex_exec when possible.
  *
  * Return:
- *   1: string has a highlight
- *   0: string has no highlight
+ *   0: successful compilation
+ *   other value: compilation failed (error can be read with function
+ *                regerror on field "regex")
+ *
+ * Note: regex must be freed with string_regex_free after use.
  */
 
 int
-string_has_highlight (const char *string, const char *highlight_words)
+string_regex_compile (struct t_string_regex *regex, const char *pattern,
+                      int default_flags)
 {
-    const char *match, *match_pre, *match_post, *msg_pos;
-    char *msg, *highlight, *pos, *pos_end;
-    int end, length, startswith, endswith, wildcard_start, wildcard_end, flags;
+    const char *ptr_regex;
+    int flags, rc;
 
-    if (!string || !string[0] || !highlight_words || !highlight_words[0])
-        return 0;
+    if (!regex)
+        return -1;
+
+    regex->pcre2 = NULL;
+
+    if (!pattern)
+        return -1;
+
+    ptr_regex = string_regex_flags (pattern, default_flags, &flags);
+    if (!ptr_regex || !ptr_regex[0])
+        ptr_regex = "^";
+
+    rc = regcomp (&(regex->regex), ptr_regex, flags);
+
+#ifdef HAVE_PCRE2
+    if (rc == 0)
+        regex->pcre2 = string_regex_pcre2_compile (ptr_regex, flags);
+#endif /* HAVE_PCRE2 */
+
+    return rc;
+}
+
+/*
+ * Execute a regex compiled with string_regex_compile (same arguments and
+ * return code as function regexec, REG_NOMATCH is returned if regex or
+ * string is NULL).
+ *
+ * If the regex was compiled with PCRE2, it is used when possible: if match
+ * positions are asked and could be different with PCRE2, or in case of
+ * error, the POSIX regex is used.
+ */
+
+int
+string_regex_exec (struct t_string_regex *regex, const char *string,
+                   size_t nmatch, regmatch_t *pmatch, int eflags)
+{
+#ifdef HAVE_PCRE2
+    int rc;
+#endif /* HAVE_PCRE2 */
+
+    if (!regex || !string)
+        return REG_NOMATCH;
+
+#ifdef HAVE_PCRE2
+    if (regex->pcre2
+        && ((nmatch == 0) || !pmatch || regex->pcre2->nosub
+            || regex->pcre2->positions))
+    {
+        rc = string_regex_pcre2_exec (regex->pcre2, string, nmatch, pmatch,
+                                      eflags);
+        if (rc >= 0)
+            return rc;
+    }
+#endif /* HAVE_PCRE2 */
+
+    return regexec (&(regex->regex), string, nmatch, pmatch, eflags);
+}
+
+/*
+ * Free data in a regex compiled with string_regex_compile (the structure
+ * itself is not freed).
+ */
+
+void
+string_regex_free (struct t_string_regex *regex)
+{
+    if (!regex)
+        return;
+
+#ifdef HAVE_PCRE2
+    string_regex_pcre2_free (regex->pcre2);
+#endif /* HAVE_PCRE2 */
+    regex->pcre2 = NULL;
+
+    regfree (&(regex->regex));
+}
+
+/*
+ * Allocate and compile a regex with function string_regex_compile.
+ *
+ * Return pointer to compiled regex, NULL if error.
+ *
+ * Note: result must be freed with string_regex_free then free after use.
+ */
+
+struct t_string_regex *
+string_regex_new (const char *pattern, int default_flags)
+{
+    struct t_string_regex *new_regex;
+
+    if (!pattern)
+        return NULL;
 
-    msg = strdup (string);
-    if (!msg)
+    new_regex = malloc (sizeof (*new_regex));
+    if (!new_regex)
+        return NULL;
+
+    if (string_regex_compile (new_regex, pattern, default_flags) != 0)
+    {
+        free (new_regex);
+        return NULL;
+    }
+
+    return new_regex;
+}
+
+/*
+ * Check if a string matches a regex compiled with string_regex_compile or
+ * string_regex_new.
+ *
+ * Return:
+ *   1: string matches regex
+ *   0: string does not match regex
+ */
+
+int
+string_regex_match (struct t_string_regex *regex, const char *string)
+{
+    return (string_regex_exec (regex, string, 0, NULL, 0) == 0) ? 1 : 0;
+}
+
+/*
+ * Convert a string to lower case for highlight (case-insensitive): each
+ * char is converted like in function string_charcasecmp.
+ *
+ * Return the number of bytes written in "result" (at most 4 bytes, without
+ * final '\0').
+ */
+
+int
+string_highlight_fold_char (const char *string, char *result)
+{
+    if (!((unsigned char)string[0] & 0x80))
+    {
+        result[0] = ((string[0] >= 'A') && (string[0] <= 'Z')) ?
+            string[0] + ('a' - 'A') : string[0];
+        return 1;
+    }
+
+    return utf8_int_string (towlower (utf8_char_int (string)), result);
+}
+
+/*
+ * Convert a string to lower case for highlight (case-insensitive).
+ *
+ * Note: result must be freed after use.
+ */
+
+char *
+string_highlight_fold (const char *string)
+{
+    char **result, utf_char[16];
+    int length;
+
+    result = string_dyn_alloc (strlen (string) + 1);
+    if (!result)
+        return NULL;
+
+    while (string[0])
+    {
+        length = string_highlight_fold_char (string, utf_char);
+        string_dyn_concat (result, utf_char, length);
+        string = utf8_next_char (string);
+    }
+
+    return string_dyn_free (result, 0);
+}
+
+/*
+ * Build the automaton (Aho-Corasick, with all transitions computed) for
+ * the words which have case "highlight_case".
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+string_highlight_automaton_build (struct t_string_highlight *highlight,
+                                  int highlight_case,
+                                  char **patterns, int *cases)
+{
+    struct t_string_highlight_automaton *automaton;
+    const unsigned char *ptr_pattern;
+    int i, max_states, num_classes, state, next_state, byte_class;
+    int *failure, *queue, queue_start, queue_end;
+
+    automaton = &(highlight->automaton[highlight_case]);
+
+    /* compute classes of bytes used in words (class 0 = other bytes) */
+    num_classes = 1;
+    max_states = 1;
+    for (i = 0; i < highlight->num_words; i++)
+    {
+        if (cases[i] != highlight_case)
+            continue;
+        for (ptr_pattern = (const unsigned char *)patterns[i]; ptr_pattern[0];
+             ptr_pattern++)
+        {
+            if (!automaton->byte_class[ptr_pattern[0]])
+                automaton->byte_class[ptr_pattern[0]] = num_classes++;
+            max_states++;
+        }
+    }
+
+    /* no words with this case? */
+    if (max_states == 1)
+        return 1;
+
+    automaton->num_classes = num_classes;
+    automaton->transitions = malloc (max_states * num_classes *
+                                     sizeof (automaton->transitions[0]));
+    automaton->words = malloc (max_states * sizeof (automaton->words[0]));
+    automaton->output = malloc (max_states * sizeof (automaton->output[0]));
+    failure = malloc (max_states * sizeof (failure[0]));
+    queue = malloc (max_states * sizeof (queue[0]));
+    if (!automaton->transitions || !automaton->words || !automaton->output
+        || !failure || !queue)
+    {
+        free (failure);
+        free (queue);
         return 0;
+    }
+    for (i = 0; i < max_states * num_classes; i++)
+    {
+        automaton->transitions[i] = -1;
+    }
+    for (i = 0; i < max_states; i++)
+    {
+        automaton->words[i] = -1;
+        automaton->output[i] = -1;
+    }
+
+    /* build the trie with all words */
+    automaton->num_states = 1;
+    for (i = 0; i < highlight->num_words; i++)
+    {
+        if (cases[i] != highlight_case)
+            continue;
+        state = 0;
+        for (ptr_pattern = (const unsigned char *)patterns[i]; ptr_pattern[0];
+             ptr_pattern++)
+        {
+            byte_class = automaton->byte_class[ptr_pattern[0]];
+            next_state = automaton->transitions[(state * num_classes)
+                                                + byte_class];
+            if (next_state < 0)
+            {
+                next_state = automaton->num_states++;
+                automaton->transitions[(state * num_classes) + byte_class] =
+                    next_state;
+            }
+            state = next_state;
+        }
+        highlight->words[i].next_word = automaton->words[state];
+        automaton->words[state] = i;
+    }
+
+    /*
+     * compute failure links (breadth-first) and replace missing transitions
+     * by the transitions of the failure state
+     */
+    queue_start = 0;
+    queue_end = 0;
+    for (byte_class = 0; byte_class < num_classes; byte_class++)
+    {
+        next_state = automaton->transitions[byte_class];
+        if (next_state < 0)
+        {
+            automaton->transitions[byte_class] = 0;
+        }
+        else
+        {
+            failure[next_state] = 0;
+            queue[queue_end++] = next_state;
+        }
+    }
+    while (queue_start < queue_end)
+    {
+        state = queue[queue_start++];
+        automaton->output[state] = (automaton->words[failure[state]] >= 0) ?
+            failure[state] : automaton->output[failure[state]];
+        for (byte_class = 0; byte_class < num_classes; byte_class++)
+        {
+            next_state = automaton->transitions[(state * num_classes)
+                                                + byte_class];
+            if (next_state < 0)
+            {
+                automaton->transitions[(state * num_classes) + byte_class] =
+                    automaton->transitions[(failure[state] * num_classes)
+                                           + byte_class];
+            }
+            else
+            {
+                failure[next_state] = automaton->transitions[
+                    (failure[state] * num_classes) + byte_class];
+                queue[queue_end++] = next_state;
+            }
+        }
+    }
+
+    free (failure);
+    free (queue);
+
+    return 1;
+}
+
+/*
+ * Compile a list of words to highlight (comma-separated, with optional
+ * flags and wildcards, see function string_has_highlight) to automatons
+ * which find all words in a single pass on a string (a single word is
+ * searched directly, without automaton).
+ *
+ * Note: result must be freed after use with function string_highlight_free.
+ */
+
+struct t_string_highlight *
+string_highlight_compile (const char *highlight_words)
+{
+    struct t_string_highlight *new_highlight;
+    char *highlight, *pos, *pos_end, **patterns;
+    int *cases, end, length, wildcard_start, wildcard_end, flags, max_words;
+    int i, rc;
+
+    if (!highlight_words)
+        return NULL;
+
+    new_highlight = calloc (1, sizeof (*new_highlight));
+    if (!new_highlight)
+        return NULL;
 
     highlight = strdup (highlight_words);
-    if (!highlight)
+    max_words = 1;
+    for (pos = highlight; pos && pos[0]; pos++)
     {
-        free (msg);
-        return 0;
+        if (pos[0] == ',')
+            max_words++;
+    }
+    new_highlight->words = malloc (max_words * sizeof (new_highlight->words[0]));
+    patterns = calloc (max_words, sizeof (*patterns));
+    cases = malloc (max_words * sizeof (*cases));
+    if (!highlight || !new_highlight->words || !patterns || !cases)
+    {
+        rc = 0;
+        goto end;
     }
 
+    rc = 1;
     pos = highlight;
     end = 0;
     while (!end)
@@ -1811,16 +2503,11 @@ string_has_highlight (const char *string, const char *highlight_words)
             pos_end = strchr (pos, '\0');
             end = 1;
         }
-        /* error parsing string! */
-        if (!pos_end)
-        {
-            free (msg);
-            free (highlight);
-            return 0;
-        }
 
         length = pos_end - pos;
         pos_end[0] = '\0';
+        wildcard_start = 0;
+        wildcard_end = 0;
         if (length > 0)
         {
             if ((wildcard_start = (pos[0] == '*')))
@@ -1837,43 +2524,433 @@ string_has_highlight (const char *string, const char *highlight_words)
 
         if (length > 0)
         {
-            msg_pos = msg;
-            while (1)
-            {
-                match = (flags & REG_ICASE) ?
-                    string_strcasestr (msg_pos, pos) : strstr (msg_pos, pos);
-                if (!match)
-                    break;
-                match_pre = utf8_prev_char (msg, match);
-                if (!match_pre)
-                    match_pre = match - 1;
-                match_post = match + length;
-                startswith = ((match == msg) || (!string_is_word_char_highlight (match_pre)));
-                endswith = ((!match_post[0]) || (!string_is_word_char_highlight (match_post)));
-                if ((wildcard_start && wildcard_end) ||
-                    (!wildcard_start && !wildcard_end &&
-                     startswith && endswith) ||
-                    (wildcard_start && endswith) ||
-                    (wildcard_end && startswith))
-                {
-                    /* highlight found! */
-                    free (msg);
-                    free (highlight);
-                    return 1;
-                }
-                msg_pos = match_post;
-            }
+            i = new_highlight->num_words;
+            new_highlight->words[i].length = utf8_strlen (pos);
+            new_highlight->words[i].wildcard_start = wildcard_start;
+            new_highlight->words[i].wildcard_end = wildcard_end;
+            new_highlight->words[i].next_word = -1;
+            if (flags & REG_ICASE)
+            {
+                cases[i] = STRING_HIGHLIGHT_CASE_INSENSITIVE;
+                patterns[i] = string_highlight_fold (pos);
+            }
+            else
+            {
+                cases[i] = STRING_HIGHLIGHT_CASE_SENSITIVE;
+                patterns[i] = strdup (pos);
+            }
+            if (!patterns[i])
+            {
+                rc = 0;
+                goto end;
+            }
+            if (new_highlight->words[i].length > new_highlight->max_length)
+                new_highlight->max_length = new_highlight->words[i].length;
+            new_highlight->num_words++;
+        }
+
+        if (!end)
+            pos = pos_end + 1;
+    }
+
+    /* a single word is searched directly in strings (no automaton) */
+    if (new_highlight->num_words == 1)
+    {
+        new_highlight->word = patterns[0];
+        new_highlight->word_case = cases[0];
+        patterns[0] = NULL;
+        goto end;
+    }
+
+    for (i = 0; i < STRING_HIGHLIGHT_NUM_CASES; i++)
+    {
+        if (!string_highlight_automaton_build (new_highlight, i,
+                                               patterns, cases))
+        {
+            rc = 0;
+            goto end;
+        }
+    }
+
+end:
+    if (patterns)
+    {
+        for (i = 0; i < max_words; i++)
+        {
+            free (patterns[i]);
+        }
+        free (patterns);
+    }
+    free (cases);
+    free (highlight);
+    if (!rc)
+    {
+        string_highlight_free (new_highlight);
+        return NULL;
+    }
+    return new_highlight;
+}
+
+/*
+ * Check if a word found in a string is a highlight: the word must be
+ * surrounded by chars which are not "word chars" (unless the word has
+ * a wildcard at beginning or end).
+ *
+ * Return:
+ *   1: word is a highlight
+ *   0: word is not a highlight
+ */
+
+int
+string_highlight_match_word (struct t_string_highlight_word *word,
+                             const char *string,
+                             const char *match, const char *match_end)
+{
+    const char *match_pre;
+    int startswith, endswith;
+
+    if (word->wildcard_start && word->wildcard_end)
+        return 1;
+
+    match_pre = utf8_prev_char (string, match);
+    if (!match_pre)
+        match_pre = match - 1;
+    startswith = ((match == string)
+                  || (!string_is_word_char_highlight (match_pre)));
+    endswith = ((!match_end[0])
+                || (!string_is_word_char_highlight (match_end)));
+
+    return ((!word->wildcard_start && !word->wildcard_end
+             && startswith && endswith)
+            || (word->wildcard_start && endswith)
+            || (word->wildcard_end && startswith)) ? 1 : 0;
+}
+
+/*
+ * Check if a string has a highlight using a single word compiled with
+ * function string_highlight_compile.
+ *
+ * Return:
+ *   1: string has a highlight
+ *   0: string has no highlight
+ */
+
+int
+string_highlight_match_single (struct t_string_highlight *highlight,
+                               const char *string)
+{
+    const char *ptr_match, *ptr_match_end;
+    int length_word;
+
+    length_word = strlen (highlight->word);
+
+    ptr_match = string;
+    while (ptr_match && ptr_match[0])
+    {
+        if (highlight->word_case == STRING_HIGHLIGHT_CASE_INSENSITIVE)
+        {
+            ptr_match = string_strcasestr (ptr_match, highlight->word);
+            if (!ptr_match)
+                break;
+            ptr_match_end = utf8_add_offset (ptr_match,
+                                             highlight->words[0].length);
+        }
+        else
+        {
+            ptr_match = strstr (ptr_match, highlight->word);
+            if (!ptr_match)
+                break;
+            ptr_match_end = ptr_match + length_word;
+        }
+        if (string_highlight_match_word (&(highlight->words[0]), string,
+                                         ptr_match, ptr_match_end))
+        {
+            return 1;
+        }
+        ptr_match = utf8_next_char (ptr_match);
+    }
+
+    return 0;
+}
+
+/*
+ * Check if a string has a highlight using words compiled with function
+ * string_highlight_compile.
+ *
+ * The string is read only once: each char is converted to lower case and
+ * sent to the case-insensitive automaton, and sent as-is to the
+ * case-sensitive automaton.
+ *
+ * Return:
+ *   1: string has a highlight
+ *   0: string has no highlight
+ */
+
+int
+string_highlight_match (struct t_string_highlight *highlight,
+                        const char *string)
+{
+    struct t_string_highlight_automaton *automaton;
+    const char *ptr_string, *ptr_next;
+    char utf_char[16];
+    int offsets_static[256], *offsets, ring_size, index_char, state[2];
+    int i, j, length, ptr_state, ptr_word, index_start, rc;
+
+    if (!highlight || !string || !string[0] || (highlight->num_words == 0))
+        return 0;
+
+    if (highlight->word)
+        return string_highlight_match_single (highlight, string);
+
+    /* offsets of the last chars read (to find the beginning of words) */
+    ring_size = highlight->max_length + 1;
+    if (ring_size <= (int)(sizeof (offsets_static) / sizeof (offsets_static[0])))
+    {
+        offsets = offsets_static;
+    }
+    else
+    {
+        offsets = malloc (ring_size * sizeof (offsets[0]));
+        if (!offsets)
+            return 0;
+    }
+
+    rc = 0;
+    state[0] = 0;
+    state[1] = 0;
+    index_char = 0;
+    ptr_string = string;
+    while (ptr_string[0])
+    {
+        offsets[index_char % ring_size] = ptr_string - string;
+        ptr_next = utf8_next_char (ptr_string);
+        index_char++;
+        for (i = 0; i < STRING_HIGHLIGHT_NUM_CASES; i++)
+        {
+            automaton = &(highlight->automaton[i]);
+            if (automaton->num_states == 0)
+                continue;
+            if (i == STRING_HIGHLIGHT_CASE_INSENSITIVE)
+            {
+                length = string_highlight_fold_char (ptr_string, utf_char);
+                for (j = 0; j < length; j++)
+                {
+                    state[i] = automaton->transitions[
+                        (state[i] * automaton->num_classes)
+                        + automaton->byte_class[(unsigned char)utf_char[j]]];
+                }
+            }
+            else
+            {
+                for (j = 0; j < ptr_next - ptr_string; j++)
+                {
+                    state[i] = automaton->transitions[
+                        (state[i] * automaton->num_classes)
+                        + automaton->byte_class[(unsigned char)ptr_string[j]]];
+                }
+            }
+            /* check all words ending here */
+            ptr_state = (automaton->words[state[i]] >= 0) ?
+                state[i] : automaton->output[state[i]];
+            while (ptr_state >= 0)
+            {
+                for (ptr_word = automaton->words[ptr_state]; ptr_word >= 0;
+                     ptr_word = highlight->words[ptr_word].next_word)
+                {
+                    index_start = index_char - highlight->words[ptr_word].length;
+                    if ((index_start >= 0)
+                        && string_highlight_match_word (
+                            &(highlight->words[ptr_word]),
+                            string,
+                            string + offsets[index_start % ring_size],
+                            ptr_next))
+                    {
+                        rc = 1;
+                        goto end;
+                    }
+                }
+                ptr_state = automaton->output[ptr_state];
+            }
+        }
+        ptr_string = ptr_next;
+    }
+
+end:
+    if (offsets != offsets_static)
+        free (offsets);
+
+    return rc;
+}
+
+/*
+ * Free compiled highlight words.
+ */
+
+void
+string_highlight_free (struct t_string_highlight *highlight)
+{
+    int i;
+
+    if (!highlight)
+        return;
+
+    for (i = 0; i < STRING_HIGHLIGHT_NUM_CASES; i++)
+    {
+        free (highlight->automaton[i].transitions);
+        free (highlight->automaton[i].words);
+        free (highlight->automaton[i].output);
+    }
+    free (highlight->words);
+    free (highlight->word);
+    free (highlight->key);
+
+    free (highlight);
+}
+
+/*
+ * Free compiled highlight words and remove them from cache.
+ */
+
+void
+string_highlight_cache_free (struct t_string_highlight *highlight)
+{
+    if (!highlight)
+        return;
+
+    hashtable_remove (string_hashtable_highlight, highlight->key);
+
+    if (highlight->prev_highlight)
+        (highlight->prev_highlight)->next_highlight = highlight->next_highlight;
+    if (highlight->next_highlight)
+        (highlight->next_highlight)->prev_highlight = highlight->prev_highlight;
+    if (string_highlight_first == highlight)
+        string_highlight_first = highlight->next_highlight;
+    if (string_highlight_last == highlight)
+        string_highlight_last = highlight->prev_highlight;
+
+    string_highlight_free (highlight);
+}
+
+/*
+ * Get compiled highlight words from cache, compile them if they are not yet
+ * in cache.
+ *
+ * The cache keeps at most STRING_HIGHLIGHT_CACHE_SIZE compiled lists: when
+ * it is full, the least recently used list is removed.
+ *
+ * Return pointer to compiled highlight words, NULL if error.
+ */
+
+struct t_string_highlight *
+string_highlight_get (const char *highlight_words)
+{
+    struct t_string_highlight *ptr_highlight;
+
+    if (!string_hashtable_highlight)
+    {
+        string_hashtable_highlight = hashtable_new (
+            32,
+            WEECHAT_HASHTABLE_STRING,
+            WEECHAT_HASHTABLE_POINTER,
+            NULL, NULL);
+        if (!string_hashtable_highlight)
+            return NULL;
+    }
+
+    ptr_highlight = hashtable_get (string_hashtable_highlight,
+                                   highlight_words);
+    if (ptr_highlight)
+    {
+        /* move compiled words at beginning of list */
+        if (ptr_highlight != string_highlight_first)
+        {
+            (ptr_highlight->prev_highlight)->next_highlight = ptr_highlight->next_highlight;
+            if (ptr_highlight->next_highlight)
+                (ptr_highlight->next_highlight)->prev_highlight = ptr_highlight->prev_highlight;
+            else
+                string_highlight_last = ptr_highlight->prev_highlight;
+            ptr_highlight->prev_highlight = NULL;
+            ptr_highlight->next_highlight = string_highlight_first;
+            string_highlight_first->prev_highlight = ptr_highlight;
+            string_highlight_first = ptr_highlight;
         }
+        return ptr_highlight;
+    }
 
-        if (!end)
-            pos = pos_end + 1;
+    /* remove the least recently used words if cache is full */
+    if (string_hashtable_highlight->items_count >= STRING_HIGHLIGHT_CACHE_SIZE)
+        string_highlight_cache_free (string_highlight_last);
+
+    ptr_highlight = string_highlight_compile (highlight_words);
+    if (!ptr_highlight)
+        return NULL;
+
+    ptr_highlight->key = strdup (highlight_words);
+    if (!ptr_highlight->key)
+    {
+        string_highlight_free (ptr_highlight);
+        return NULL;
     }
+    ptr_highlight->prev_highlight = NULL;
+    ptr_highlight->next_highlight = string_highlight_first;
+    if (string_highlight_first)
+        string_highlight_first->prev_highlight = ptr_highlight;
+    else
+        string_highlight_last = ptr_highlight;
+    string_highlight_first = ptr_highlight;
 
-    free (msg);
-    free (highlight);
+    if (!hashtable_set (string_hashtable_highlight,
+                        highlight_words, ptr_highlight))
+    {
+        string_highlight_cache_free (ptr_highlight);
+        return NULL;
+    }
 
-    /* no highlight found */
-    return 0;
+    return ptr_highlight;
+}
+
+/*
+ * Compile a list of words to highlight set in an option (or a buffer
+ * property), so that the compiled words are kept by the owner of the list
+ * and compiled again only when the list changes.
+ *
+ * Words with local variables ("$var") depend on the buffer: they are not
+ * compiled here (NULL is returned) and the cache is used on each check.
+ *
+ * Note: result must be freed after use with function string_highlight_free.
+ */
+
+struct t_string_highlight *
+string_highlight_compile_option (const char *highlight_words)
+{
+    if (!highlight_words || !highlight_words[0]
+        || strchr (highlight_words, '$'))
+    {
+        return NULL;
+    }
+
+    return string_highlight_compile (highlight_words);
+}
+
+/*
+ * Check if a string has a highlight (using list of words to highlight).
+ *
+ * The list of words is compiled on first use and kept in a cache, so that
+ * all words are searched in a single pass on the string.
+ *
+ * Return:
+ *   1: string has a highlight
+ *   0: string has no highlight
+ */
+
+int
+string_has_highlight (const char *string, const char *highlight_words)
+{
+    if (!string || !string[0] || !highlight_words || !highlight_words[0])
+        return 0;
+
+    return string_highlight_match (string_highlight_get (highlight_words),
+                                   string);
 }
 
 /*
@@ -1882,7 +2959,8 @@ string_has_highlight (const char *string, const char *highlight_words)
  */
 
 int
-string_has_highlight_regex_compiled (const char *string, regex_t *regex)
+string_has_highlight_regex_compiled (const char *string,
+                                     struct t_string_regex *regex)
 {
     int rc, startswith, endswith;
     regmatch_t regex_match;
@@ -1893,7 +2971,7 @@ string_has_highlight_regex_compiled (const char *string, regex_t *regex)
 
     while (string && string[0])
     {
-        rc = regexec (regex, string,  1, &regex_match, 0);
+        rc = string_regex_exec (regex, string,  1, &regex_match, 0);
 
         /*
          * no match found: exit the loop (if rm_eo == 0, it is an empty match
@@ -1933,22 +3011,409 @@ string_has_highlight_regex_compiled (const char *string, regex_t *regex)
 int
 string_has_highlight_regex (const char *string, const char *regex)
 {
-    regex_t reg;
+    struct t_string_regex reg;
     int rc;
 
     if (!string || !regex || !regex[0])
         return 0;
 
-    if (string_regcomp (&reg, regex, REG_EXTENDED | REG_ICASE) != 0)
+    /* regex used only once: not compiled with PCRE2 */
+    if (string_regcomp (&(reg.regex), regex, REG_EXTENDED | REG_ICASE) != 0)
         return 0;
+    reg.pcre2 = NULL;
 
     rc = string_has_highlight_regex_compiled (string, &reg);
 
-    regfree (&reg);
+    regfree (&(reg.regex));
+
+    return rc;
+}
+
+/*
+ * Convert a string to lower case for a compiled mask (case-insensitive),
+ * like function string_highlight_fold.
+ *
+ * The result is written in "buffer" if it is large enough, otherwise it is
+ * allocated (and must be freed after use if it is different from "buffer").
+ *
+ * Return the string in lower case, NULL if error.
+ */
+
+char *
+string_mask_fold (const char *string, char *buffer, int size, int *length)
+{
+    const char *ptr_string;
+    int pos;
+
+    pos = 0;
+    ptr_string = string;
+    while (ptr_string[0])
+    {
+        if (pos + 4 >= size)
+        {
+            buffer = string_highlight_fold (string);
+            *length = (buffer) ? (int)strlen (buffer) : 0;
+            return buffer;
+        }
+        if (!((unsigned char)ptr_string[0] & 0x80))
+        {
+            buffer[pos++] = ((ptr_string[0] >= 'A') && (ptr_string[0] <= 'Z')) ?
+                ptr_string[0] + ('a' - 'A') : ptr_string[0];
+            ptr_string++;
+        }
+        else
+        {
+            pos += string_highlight_fold_char (ptr_string, buffer + pos);
+            ptr_string = utf8_next_char (ptr_string);
+        }
+    }
+    buffer[pos] = '\0';
+    *length = pos;
+
+    return buffer;
+}
+
+/*
+ * Compile a mask for function string_mask_match: the mask is split on
+ * wildcards ("*") once, so that matching a string does not parse the mask
+ * again.
+ *
+ * The same strings are matched as with function string_match.
+ *
+ * Return pointer to compiled mask, NULL if error or if mask is NULL or empty
+ * (a NULL mask never matches).
+ *
+ * Note: result must be freed with string_mask_free after use.
+ */
+
+struct t_string_mask *
+string_mask_compile (const char *mask, int case_sensitive)
+{
+    struct t_string_mask *new_mask;
+    char *ptr_mask;
+    int length, num_words;
+
+    if (!mask || !mask[0])
+        return NULL;
+
+    new_mask = calloc (1, sizeof (*new_mask));
+    if (!new_mask)
+        return NULL;
+
+    new_mask->case_sensitive = (case_sensitive) ? 1 : 0;
+    new_mask->mask = (case_sensitive) ?
+        strdup (mask) : string_highlight_fold (mask);
+    if (!new_mask->mask)
+        goto error;
+
+    length = strlen (new_mask->mask);
+    new_mask->wildcard_start = (new_mask->mask[0] == '*') ? 1 : 0;
+    new_mask->wildcard_end = (new_mask->mask[length - 1] == '*') ? 1 : 0;
+
+    /* count words between wildcards */
+    num_words = 0;
+    for (ptr_mask = new_mask->mask; ptr_mask[0]; ptr_mask++)
+    {
+        if ((ptr_mask[0] != '*')
+            && ((ptr_mask == new_mask->mask) || (ptr_mask[-1] == '*')))
+        {
+            num_words++;
+        }
+    }
+
+    new_mask->words = malloc ((num_words + 1) * sizeof (*new_mask->words));
+    new_mask->length_words = malloc ((num_words + 1)
+                                     * sizeof (*new_mask->length_words));
+    if (!new_mask->words || !new_mask->length_words)
+        goto error;
+
+    /* split words (wildcards are replaced by '\0') */
+    for (ptr_mask = new_mask->mask; ptr_mask[0]; ptr_mask++)
+    {
+        if (ptr_mask[0] == '*')
+        {
+            ptr_mask[0] = '\0';
+            continue;
+        }
+        if ((ptr_mask == new_mask->mask) || (ptr_mask[-1] == '\0'))
+        {
+            new_mask->words[new_mask->num_words] = ptr_mask;
+            new_mask->length_words[new_mask->num_words] =
+                strcspn (ptr_mask, "*");
+            new_mask->num_words++;
+        }
+    }
+    new_mask->words[new_mask->num_words] = NULL;
+    new_mask->length_words[new_mask->num_words] = 0;
+
+    if (new_mask->num_words == 0)
+        new_mask->type = STRING_MASK_TYPE_ANY;
+    else if (new_mask->num_words > 1)
+        new_mask->type = STRING_MASK_TYPE_GENERAL;
+    else if (!new_mask->wildcard_start && !new_mask->wildcard_end)
+        new_mask->type = STRING_MASK_TYPE_LITERAL;
+    else if (!new_mask->wildcard_start)
+        new_mask->type = STRING_MASK_TYPE_PREFIX;
+    else if (!new_mask->wildcard_end)
+        new_mask->type = STRING_MASK_TYPE_SUFFIX;
+    else
+        new_mask->type = STRING_MASK_TYPE_GENERAL;
+
+    return new_mask;
+
+error:
+    string_mask_free (new_mask);
+    return NULL;
+}
+
+/*
+ * Check if a string matches a compiled mask, the string must be in lower
+ * case if the mask is case insensitive.
+ *
+ * Return:
+ *   1: string matches mask
+ *   0: string does not match mask
+ */
+
+int
+string_mask_match_string (struct t_string_mask *mask, const char *string,
+                          int length)
+{
+    const char *ptr_string, *ptr_end, *pos;
+    int i, first, last, length_word;
+
+    switch (mask->type)
+    {
+        case STRING_MASK_TYPE_ANY:
+            return 1;
+        case STRING_MASK_TYPE_LITERAL:
+            return ((length == mask->length_words[0])
+                    && (memcmp (string, mask->words[0], length) == 0)) ? 1 : 0;
+        case STRING_MASK_TYPE_PREFIX:
+            return ((length >= mask->length_words[0])
+                    && (memcmp (string, mask->words[0],
+                                mask->length_words[0]) == 0)) ? 1 : 0;
+        case STRING_MASK_TYPE_SUFFIX:
+            return ((length >= mask->length_words[0])
+                    && (memcmp (string + length - mask->length_words[0],
+                                mask->words[0],
+                                mask->length_words[0]) == 0)) ? 1 : 0;
+        case STRING_MASK_TYPE_GENERAL:
+            ptr_string = string;
+            ptr_end = string + length;
+            first = 0;
+            last = mask->num_words;
+            /* first word must be at beginning of string */
+            if (!mask->wildcard_start)
+            {
+                length_word = mask->length_words[0];
+                if ((length < length_word)
+                    || (memcmp (string, mask->words[0], length_word) != 0))
+                {
+                    return 0;
+                }
+                ptr_string += length_word;
+                first++;
+            }
+            /* last word must be at end of string (after the first word) */
+            if (!mask->wildcard_end)
+            {
+                last--;
+                length_word = mask->length_words[last];
+                if ((ptr_end - ptr_string < length_word)
+                    || (memcmp (ptr_end - length_word, mask->words[last],
+                                length_word) != 0))
+                {
+                    return 0;
+                }
+                ptr_end -= length_word;
+            }
+            /* other words are searched in order (leftmost match) */
+            for (i = first; i < last; i++)
+            {
+                pos = strstr (ptr_string, mask->words[i]);
+                if (!pos || (pos + mask->length_words[i] > ptr_end))
+                    return 0;
+                ptr_string = pos + mask->length_words[i];
+            }
+            return 1;
+        case STRING_NUM_MASK_TYPES:
+            break;
+    }
+
+    return 0;
+}
+
+/*
+ * Check if a string matches a mask compiled with string_mask_compile.
+ *
+ * Return:
+ *   1: string matches mask
+ *   0: string does not match mask
+ */
+
+int
+string_mask_match (struct t_string_mask *mask, const char *string)
+{
+    char buffer[STRING_MASK_FOLD_BUFFER_SIZE], *string_lower;
+    int length, rc;
+
+    if (!mask || !string)
+        return 0;
+
+    if (mask->type == STRING_MASK_TYPE_ANY)
+        return 1;
+
+    if (mask->case_sensitive)
+        return string_mask_match_string (mask, string, strlen (string));
+
+    string_lower = string_mask_fold (string, buffer, sizeof (buffer), &length);
+    if (!string_lower)
+        return 0;
+
+    rc = string_mask_match_string (mask, string_lower, length);
+
+    if (string_lower != buffer)
+        free (string_lower);
 
     return rc;
 }
 
+/*
+ * Free a compiled mask.
+ */
+
+void
+string_mask_free (struct t_string_mask *mask)
+{
+    if (!mask)
+        return;
+
+    free (mask->mask);
+    free (mask->words);
+    free (mask->length_words);
+    free (mask);
+}
+
+/*
+ * Compile a list of masks for function string_mask_list_match: negative
+ * masks are allowed with "!mask" (see function string_match_list).
+ *
+ * Empty masks are ignored (they never match).
+ *
+ * Return NULL-terminated array of compiled masks, NULL if error.
+ *
+ * Note: result must be freed with string_mask_list_free after use.
+ */
+
+struct t_string_mask **
+string_mask_list_compile (const char **masks, int case_sensitive)
+{
+    struct t_string_mask **new_masks, *ptr_mask;
+    int i, count, negative;
+
+    if (!masks)
+        return NULL;
+
+    count = 0;
+    while (masks[count])
+    {
+        count++;
+    }
+
+    new_masks = malloc ((count + 1) * sizeof (*new_masks));
+    if (!new_masks)
+        return NULL;
+
+    count = 0;
+    for (i = 0; masks[i]; i++)
+    {
+        negative = (masks[i][0] == '!') ? 1 : 0;
+        ptr_mask = string_mask_compile (masks[i] + negative, case_sensitive);
+        if (!ptr_mask)
+            continue;
+        ptr_mask->negative = negative;
+        new_masks[count++] = ptr_mask;
+    }
+    new_masks[count] = NULL;
+
+    return new_masks;
+}
+
+/*
+ * Check if a string matches a list of masks compiled with
+ * string_mask_list_compile.
+ *
+ * Return:
+ *   1: string matches list of masks
+ *   0: string does not match list of masks
+ */
+
+int
+string_mask_list_match (struct t_string_mask **masks, const char *string)
+{
+    char buffer[STRING_MASK_FOLD_BUFFER_SIZE], *string_lower;
+    int i, length, match;
+
+    if (!masks || !masks[0] || !string)
+        return 0;
+
+    /* all masks in list have the same case sensitivity */
+    if (masks[0]->case_sensitive)
+    {
+        string_lower = NULL;
+        length = strlen (string);
+    }
+    else
+    {
+        string_lower = string_mask_fold (string, buffer, sizeof (buffer),
+                                         &length);
+        if (!string_lower)
+            return 0;
+    }
+
+    match = 0;
+
+    for (i = 0; masks[i]; i++)
+    {
+        if (string_mask_match_string (masks[i],
+                                      (string_lower) ? string_lower : string,
+                                      length))
+        {
+            if (masks[i]->negative)
+            {
+                match = 0;
+                break;
+            }
+            match = 1;
+        }
+    }
+
+    if (string_lower && (string_lower != buffer))
+        free (string_lower);
+
+    return match;
+}
+
+/*
+ * Free a list of compiled masks.
+ */
+
+void
+string_mask_list_free (struct t_string_mask **masks)
+{
+    int i;
+
+    if (!masks)
+        return;
+
+    for (i = 0; masks[i]; i++)
+    {
+        string_mask_free (masks[i]);
+    }
+    free (masks);
+}
+
 /*
  * Replace a string by new one in a string.
  *
@@ -4507,9 +5972,10 @@ string_get_priority_and_name (const char *string,
 
 /*
  * Hash a shared string.
- * The string starts after the reference count, which is skipped.
+ * The string starts after the header (reference count and id), which is
+ * skipped.
  *
- * Return the hash of the shared string (variant of djb2).
+ * Return the hash of the shared string.
  */
 
 unsigned long long
@@ -4519,12 +5985,13 @@ string_shared_hash_key (struct t_hashtable *hashtable,
     /* make C compiler happy */
     (void) hashtable;
 
-    return hashtable_hash_key_djb2 (((const char *)key) + sizeof (string_shared_count_t));
+    return hashtable_hash_key_string (((const char *)key) + sizeof (struct t_string_shared_header));
 }
 
 /*
  * Compare two shared strings.
- * Each string starts after the reference count, which is skipped.
+ * Each string starts after the header (reference count and id), which is
+ * skipped.
  *
  * Return:
  *   < 0: key1 < key2
@@ -4539,8 +6006,8 @@ string_shared_keycmp (struct t_hashtable *hashtable,
     /* make C compiler happy */
     (void) hashtable;
 
-    return strcmp (((const char *)key1) + sizeof (string_shared_count_t),
-                   ((const char *)key2) + sizeof (string_shared_count_t));
+    return strcmp (((const char *)key1) + sizeof (struct t_string_shared_header),
+                   ((const char *)key2) + sizeof (struct t_string_shared_header));
 }
 
 /*
@@ -4560,14 +6027,19 @@ string_shared_free_key (struct t_hashtable *hashtable, void *key)
  * Get a pointer to a shared string.
  *
  * A shared string is an entry in the hashtable "string_hashtable_shared", with:
- * - key: reference count (unsigned integer on 32 bits) + string
+ * - key: header (reference count and id, unsigned integers on 32 bits)
+ *   + string
  * - value: NULL pointer (not used)
  *
  * The initial reference count is set to 1 and is incremented each time this
  * function is called for a same string (string content, not the pointer).
  *
+ * The id is given when the string is added in the hashtable and is not
+ * reused by another string (until the 32-bit counter wraps), unlike the
+ * pointer which may be reused after the string is freed.
+ *
  * Return the pointer to the shared string (start of string in key, after the
- * reference count), NULL if error.
+ * header), NULL if error.
  * The string returned has exactly same content as string received in argument,
  * but the pointer to the string is different.
  *
@@ -4579,6 +6051,7 @@ const char *
 string_shared_get (const char *string)
 {
     struct t_hashtable_item *ptr_item;
+    struct t_string_shared_header *header;
     char *key;
     int length;
 
@@ -4607,12 +6080,14 @@ string_shared_get (const char *string)
         string_hashtable_shared->callback_free_key = &string_shared_free_key;
     }
 
-    length = sizeof (string_shared_count_t) + strlen (string) + 1;
+    length = sizeof (*header) + strlen (string) + 1;
     key = malloc (length);
     if (!key)
         return NULL;
-    *((string_shared_count_t *)key) = 1;
-    strcpy (key + sizeof (string_shared_count_t), string);
+    header = (struct t_string_shared_header *)key;
+    header->count = 1;
+    header->id = 0;
+    strcpy (key + sizeof (*header), string);
 
     ptr_item = hashtable_get_item (string_hashtable_shared, key, NULL);
     if (ptr_item)
@@ -4621,19 +6096,22 @@ string_shared_get (const char *string)
          * the string already exists in the hashtable, then just increase the
          * reference count on the string
          */
-        (*((string_shared_count_t *)(ptr_item->key)))++;
+        (((struct t_string_shared_header *)(ptr_item->key))->count)++;
         free (key);
     }
     else
     {
         /* add the shared string in the hashtable */
+        header->id = string_shared_next_id;
+        string_shared_next_id = (string_shared_next_id == UINT32_MAX) ?
+            1 : string_shared_next_id + 1;
         ptr_item = hashtable_set (string_hashtable_shared, key, NULL);
         if (!ptr_item)
             free (key);
     }
 
     return (ptr_item) ?
-        ((const char *)ptr_item->key) + sizeof (string_shared_count_t) : NULL;
+        ((const char *)ptr_item->key) + sizeof (*header) : NULL;
 }
 
 /*
@@ -4647,17 +6125,32 @@ string_shared_get (const char *string)
 void
 string_shared_free (const char *string)
 {
-    string_shared_count_t *ptr_count;
+    struct t_string_shared_header *header;
 
     if (!string)
         return;
 
-    ptr_count = (string_shared_count_t *)(string - sizeof (string_shared_count_t));
+    header = (struct t_string_shared_header *)(string - sizeof (*header));
+
+    (header->count)--;
+
+    if (header->count == 0)
+        hashtable_remove (string_hashtable_shared, header);
+}
+
+/*
+ * Get the id of a shared string.
+ *
+ * Return the id of the shared string, 0 if string is NULL.
+ */
 
-    (*ptr_count)--;
+string_shared_id_t
+string_shared_get_id (const char *string)
+{
+    if (!string)
+        return 0;
 
-    if (*ptr_count == 0)
-        hashtable_remove (string_hashtable_shared, ptr_count);
+    return ((struct t_string_shared_header *)(string - sizeof (struct t_string_shared_header)))->id;
 }
 
 /*
@@ -4948,6 +6441,15 @@ string_end (void)
         hashtable_free (string_hashtable_shared);
         string_hashtable_shared = NULL;
     }
+    while (string_highlight_first)
+    {
+        string_highlight_cache_free (string_highlight_first);
+    }
+    if (string_hashtable_highlight)
+    {
+        hashtable_free (string_hashtable_highlight);
+        string_hashtable_highlight = NULL;
+    }
     for (i = 0; i < STRING_NUM_CONCAT_BUFFERS; i++)
     {
         if (string_concat_buffer[i])
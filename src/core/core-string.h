@@ -30,6 +30,13 @@
 #define STR_CONCAT(separator, argz...) string_concat (separator, ##argz, NULL)
 
 typedef uint32_t string_shared_count_t;
+typedef uint32_t string_shared_id_t;
+
+struct t_string_shared_header
+{
+    string_shared_count_t count;       /* reference count                   */
+    string_shared_id_t id;             /* unique id of string (never 0)     */
+};
 
 typedef uint32_t string_dyn_size_t;
 struct t_string_dyn
@@ -39,6 +46,96 @@ struct t_string_dyn
     string_dyn_size_t size;            /* size of string (including '\0')   */
 };
 
+/*
+ * regex kept and executed many times (filters, highlights, triggers, IRC
+ * ignores): compiled with PCRE2 (with JIT if available) in addition to POSIX,
+ * if WeeChat is built with PCRE2
+ */
+
+struct t_string_regex_pcre2;
+
+struct t_string_regex
+{
+    regex_t regex;                     /* POSIX regex (always compiled)     */
+    struct t_string_regex_pcre2 *pcre2; /* PCRE2 regex (NULL if not used)   */
+};
+
+/* highlight words compiled to automatons (Aho-Corasick) */
+
+#define STRING_HIGHLIGHT_CACHE_SIZE 64
+
+enum t_string_highlight_case
+{
+    STRING_HIGHLIGHT_CASE_INSENSITIVE = 0,
+    STRING_HIGHLIGHT_CASE_SENSITIVE,
+    /* number of cases */
+    STRING_HIGHLIGHT_NUM_CASES,
+};
+
+struct t_string_highlight_word
+{
+    int length;                        /* length of word (number of chars)  */
+    int wildcard_start;                /* 1 if word starts with "*"         */
+    int wildcard_end;                  /* 1 if word ends with "*"           */
+    int next_word;                     /* next word ending on same state    */
+};
+
+struct t_string_highlight_automaton
+{
+    int num_states;                    /* number of states (0 if no words)  */
+    int num_classes;                   /* number of classes of bytes        */
+    unsigned char byte_class[256];     /* class of each byte (0 = other)    */
+    int *transitions;                  /* next state, by state and class    */
+    int *words;                        /* first word ending on each state   */
+    int *output;                       /* next state with words, following  */
+                                       /* the failure links                 */
+};
+
+struct t_string_highlight
+{
+    struct t_string_highlight_word *words; /* words to highlight            */
+    int num_words;                     /* number of words                   */
+    int max_length;                    /* max length of words (in chars)    */
+    char *word;                        /* single word (searched without     */
+                                       /* automaton), NULL if many words    */
+    int word_case;                     /* case of single word               */
+    struct t_string_highlight_automaton automaton[STRING_HIGHLIGHT_NUM_CASES];
+    char *key;                         /* key in cache (NULL if not cached) */
+    struct t_string_highlight *prev_highlight; /* link to prev. (more recent) */
+    struct t_string_highlight *next_highlight; /* link to next (less recent)  */
+};
+
+/* masks with wildcards compiled for function string_mask_match */
+
+#define STRING_MASK_FOLD_BUFFER_SIZE 256
+
+enum t_string_mask_type
+{
+    STRING_MASK_TYPE_ANY = 0,          /* only wildcards: "*"               */
+    STRING_MASK_TYPE_LITERAL,          /* no wildcard: "abc"                */
+    STRING_MASK_TYPE_PREFIX,           /* "abc*"                            */
+    STRING_MASK_TYPE_SUFFIX,           /* "*abc"                            */
+    STRING_MASK_TYPE_GENERAL,          /* other masks: "*abc*", "a*b", ...  */
+    /* number of mask types */
+    STRING_NUM_MASK_TYPES,
+};
+
+struct t_string_mask
+{
+    enum t_string_mask_type type;      /* type of mask                      */
+    int case_sensitive;                /* 1 if mask is case sensitive       */
+    int negative;                      /* 1 if mask is excluded ("!mask"),  */
+                                       /* used in a list of masks only      */
+    int wildcard_start;                /* 1 if mask starts with "*"         */
+    int wildcard_end;                  /* 1 if mask ends with "*"           */
+    char *mask;                        /* copy of mask (lower case if case  */
+                                       /* insensitive), wildcards replaced  */
+                                       /* by '\0'                           */
+    char **words;                      /* words between wildcards           */
+    int *length_words;                 /* length of words (in bytes)        */
+    int num_words;                     /* number of words                   */
+};
+
 struct t_hashtable;
 
 extern int string_asprintf (char **result, const char *fmt, ...);
@@ -76,6 +173,15 @@ extern int string_match (const char *string, const char *mask,
                          int case_sensitive);
 extern int string_match_list (const char *string, const char **masks,
                               int case_sensitive);
+extern struct t_string_mask *string_mask_compile (const char *mask,
+                                                  int case_sensitive);
+extern int string_mask_match (struct t_string_mask *mask, const char *string);
+extern void string_mask_free (struct t_string_mask *mask);
+extern struct t_string_mask **string_mask_list_compile (const char **masks,
+                                                        int case_sensitive);
+extern int string_mask_list_match (struct t_string_mask **masks,
+                                   const char *string);
+extern void string_mask_list_free (struct t_string_mask **masks);
 extern char *string_replace (const char *string, const char *search,
                              const char *replace);
 extern char *string_expand_home (const char *path);
@@ -93,11 +199,28 @@ extern int string_is_word_char_input (const char *string);
 extern char *string_mask_to_regex (const char *mask);
 extern const char *string_regex_flags (const char *regex, int default_flags,
                                        int *flags);
+extern char *string_regex_to_pcre2 (const char *regex, int flags,
+                                    int *positions);
 extern int string_regcomp (void *preg, const char *regex, int default_flags);
+extern int string_regex_compile (struct t_string_regex *regex,
+                                 const char *pattern, int default_flags);
+extern int string_regex_exec (struct t_string_regex *regex,
+                              const char *string, size_t nmatch,
+                              regmatch_t *pmatch, int eflags);
+extern void string_regex_free (struct t_string_regex *regex);
+extern struct t_string_regex *string_regex_new (const char *pattern,
+                                               int default_flags);
+extern int string_regex_match (struct t_string_regex *regex,
+                               const char *string);
+extern struct t_string_highlight *string_highlight_compile (const char *highlight_words);
+extern int string_highlight_match (struct t_string_highlight *highlight,
+                                   const char *string);
+extern void string_highlight_free (struct t_string_highlight *highlight);
+extern struct t_string_highlight *string_highlight_compile_option (const char *highlight_words);
 extern int string_has_highlight (const char *string,
                                  const char *highlight_words);
 extern int string_has_highlight_regex_compiled (const char *string,
-                                                regex_t *regex);
+                                                struct t_string_regex *regex);
 extern int string_has_highlight_regex (const char *string, const char *regex);
 extern char *string_replace_regex (const char *string, void *regex,
                                    const char *replace,
@@ -165,6 +288,7 @@ extern void string_get_priority_and_name (const char *string,
                                           int default_priority);
 extern const char *string_shared_get (const char *string);
 extern void string_shared_free (const char *string);
+extern string_shared_id_t string_shared_get_id (const char *string);
 extern char **string_dyn_alloc (int size_alloc);
 extern int string_dyn_copy (char **string, const char *new_string);
 extern int string_dyn_concat (char **string, const char *add, int bytes);
@@ -976,87 +976,61 @@ weeurl_set_proxy (CURL *curl, struct t_proxy *proxy)
 }
 
 /*
- * Download URL using options.
+ * Initialize an URL transfer: create the curl easy handle and set options.
  *
  * If output is not NULL, it must be a hashtable with keys and values of type
- * "string". The following keys may be added in the hashtable,
- * depending on the success or error of the URL transfer:
+ * "string", filled by function weeurl_transfer_free (see weeurl_download).
  *
- *   key           | description
- *   --------------|--------------------------------------------------------
- *   response_code | HTTP response code (as string)
- *   headers       | HTTP headers in response
- *   output        | stdout (set only if "file_out" was not set in options)
- *   error         | error message (set only in case of error)
- *
- * If timeout is 0, the function blocks until the end of the transfer.
- * If timeout (in milliseconds) is > 0, the function return an error in the
- * output hashtable if the timeout is reached while the transfer is still
- * active.
- *
- * If stop_download is not NULL, it is checked regularly, and as soon as the
- * pointed integer becomes different from 0 (set by the caller of this function),
- * the download is immediately stopped with an error.
+ * The transfer must always be freed by a call to weeurl_transfer_free, even
+ * if this function returns an error.
  *
  * Return:
  *   0: OK
  *   1: invalid URL
- *   2: error downloading URL
  *   3: not enough memory
  *   4: file error
- *   5: transfer stopped by the caller
- *   6: transfer timeout
  */
 
 int
-weeurl_download (const char *url, struct t_hashtable *options,
-                 long timeout, struct t_hashtable *output,
-                 int *stop_transfer)
+weeurl_transfer_init (struct t_url_transfer *transfer, const char *url,
+                      struct t_hashtable *options, struct t_hashtable *output)
 {
     CURL *curl;
-    CURLM *multi;
-    CURLMcode curl_mc;
-    struct t_url_file url_file[2];
     char *url_file_option[2] = { "file_in", "file_out" };
     char *url_file_mode[2] = { "rb", "wb" };
-    char url_error[4096], url_error_code[12];
-    char **string_headers, **string_output;
-    char str_response_code[32];
     CURLoption url_file_opt_func[2] = { CURLOPT_READFUNCTION, CURLOPT_WRITEFUNCTION };
     CURLoption url_file_opt_data[2] = { CURLOPT_READDATA, CURLOPT_WRITEDATA };
     void *url_file_opt_cb[2] = { &weeurl_read_stream, &weeurl_write_stream };
     struct t_proxy *ptr_proxy;
-    int rc, i, output_to_file, still_running;
-    long response_code;
-    struct timeval tv_now, tv_end;
-
-    rc = 0;
-
-    string_headers = NULL;
-    string_output = NULL;
-    url_error[0] = '\0';
-    url_error_code[0] = '\0';
+    int i, output_to_file;
 
+    transfer->curl = NULL;
     for (i = 0; i < 2; i++)
     {
-        url_file[i].filename = NULL;
-        url_file[i].stream = NULL;
+        transfer->url_file[i].filename = NULL;
+        transfer->url_file[i].stream = NULL;
     }
+    transfer->string_headers = NULL;
+    transfer->string_output = NULL;
+    transfer->error[0] = '\0';
+    transfer->error_code[0] = '\0';
+    transfer->output = output;
 
     if (!url || !url[0])
     {
-        snprintf (url_error, sizeof (url_error), "%s", _("invalid URL"));
-        rc = 1;
-        goto end;
+        snprintf (transfer->error, sizeof (transfer->error),
+                  "%s", _("invalid URL"));
+        return 1;
     }
 
     curl = curl_easy_init ();
     if (!curl)
     {
-        snprintf (url_error, sizeof (url_error), "%s", _("not enough memory"));
-        rc = 3;
-        goto end;
+        snprintf (transfer->error, sizeof (transfer->error),
+                  "%s", _("not enough memory"));
+        return 3;
     }
+    transfer->curl = curl;
 
     /* set default options */
     curl_easy_setopt (curl, CURLOPT_URL, url);
@@ -1074,11 +1048,11 @@ weeurl_download (const char *url, struct t_hashtable *options,
     /* set callback to retrieve HTTP headers */
     if (output)
     {
-        string_headers = string_dyn_alloc (1024);
-        if (string_headers)
+        transfer->string_headers = string_dyn_alloc (1024);
+        if (transfer->string_headers)
         {
             curl_easy_setopt (curl, CURLOPT_HEADERFUNCTION, &weeurl_write_string);
-            curl_easy_setopt (curl, CURLOPT_HEADERDATA, string_headers);
+            curl_easy_setopt (curl, CURLOPT_HEADERDATA, transfer->string_headers);
         }
     }
 
@@ -1088,22 +1062,22 @@ weeurl_download (const char *url, struct t_hashtable *options,
     {
         for (i = 0; i < 2; i++)
         {
-            url_file[i].filename = hashtable_get (options, url_file_option[i]);
-            if (url_file[i].filename)
+            transfer->url_file[i].filename = hashtable_get (options, url_file_option[i]);
+            if (transfer->url_file[i].filename)
             {
-                url_file[i].stream = fopen (url_file[i].filename, url_file_mode[i]);
-                if (!url_file[i].stream)
+                transfer->url_file[i].stream = fopen (transfer->url_file[i].filename,
+                                                      url_file_mode[i]);
+                if (!transfer->url_file[i].stream)
                 {
-                    snprintf (url_error, sizeof (url_error),
+                    snprintf (transfer->error, sizeof (transfer->error),
                               (i == 0) ?
                               _("file \"%s\" not found") :
                               _("cannot write file \"%s\""),
-                              url_file[i].filename);
-                    rc = 4;
-                    goto end;
+                              transfer->url_file[i].filename);
+                    return 4;
                 }
                 curl_easy_setopt (curl, url_file_opt_func[i], url_file_opt_cb[i]);
-                curl_easy_setopt (curl, url_file_opt_data[i], url_file[i].stream);
+                curl_easy_setopt (curl, url_file_opt_data[i], transfer->url_file[i].stream);
                 if (i == 1)
                     output_to_file = 1;
             }
@@ -1113,11 +1087,11 @@ weeurl_download (const char *url, struct t_hashtable *options,
     /* redirect stdout if no filename was given (via key "file_out") */
     if (output && !output_to_file)
     {
-        string_output = string_dyn_alloc (1024);
-        if (string_output)
+        transfer->string_output = string_dyn_alloc (1024);
+        if (transfer->string_output)
         {
             curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, &weeurl_write_string);
-            curl_easy_setopt (curl, CURLOPT_WRITEDATA, string_output);
+            curl_easy_setopt (curl, CURLOPT_WRITEDATA, transfer->string_output);
         }
     }
 
@@ -1125,7 +1099,128 @@ weeurl_download (const char *url, struct t_hashtable *options,
     hashtable_map (options, &weeurl_option_map_cb, curl);
 
     /* set error buffer */
-    curl_easy_setopt (curl, CURLOPT_ERRORBUFFER, url_error);
+    curl_easy_setopt (curl, CURLOPT_ERRORBUFFER, transfer->error);
+
+    return 0;
+}
+
+/*
+ * Set HTTP response code in output hashtable of a transfer (called when the
+ * transfer is done).
+ */
+
+void
+weeurl_transfer_done (struct t_url_transfer *transfer)
+{
+    long response_code;
+    char str_response_code[32];
+
+    if (!transfer->curl || !transfer->output)
+        return;
+
+    response_code = 0;
+    curl_easy_getinfo (transfer->curl, CURLINFO_RESPONSE_CODE, &response_code);
+    snprintf (str_response_code, sizeof (str_response_code),
+              "%ld", response_code);
+    hashtable_set (transfer->output, "response_code", str_response_code);
+}
+
+/*
+ * Free an URL transfer: destroy the curl easy handle (it must have been
+ * removed from any multi handle), close files and set keys "headers",
+ * "output", "error" and "error_code_curl" in output hashtable.
+ *
+ * The structure itself is not freed.
+ */
+
+void
+weeurl_transfer_free (struct t_url_transfer *transfer)
+{
+    int i;
+
+    if (transfer->curl)
+    {
+        curl_easy_cleanup (transfer->curl);
+        transfer->curl = NULL;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if (transfer->url_file[i].stream)
+        {
+            fclose (transfer->url_file[i].stream);
+            transfer->url_file[i].stream = NULL;
+        }
+    }
+    if (transfer->output)
+    {
+        if (transfer->string_headers)
+            hashtable_set (transfer->output, "headers", *(transfer->string_headers));
+        if (transfer->string_output)
+            hashtable_set (transfer->output, "output", *(transfer->string_output));
+        if (transfer->error[0])
+            hashtable_set (transfer->output, "error", transfer->error);
+        if (transfer->error_code[0])
+            hashtable_set (transfer->output, "error_code_curl", transfer->error_code);
+    }
+    if (transfer->string_headers)
+    {
+        string_dyn_free (transfer->string_headers, 1);
+        transfer->string_headers = NULL;
+    }
+    if (transfer->string_output)
+    {
+        string_dyn_free (transfer->string_output, 1);
+        transfer->string_output = NULL;
+    }
+}
+
+/*
+ * Download URL using options.
+ *
+ * If output is not NULL, it must be a hashtable with keys and values of type
+ * "string". The following keys may be added in the hashtable,
+ * depending on the success or error of the URL transfer:
+ *
+ *   key           | description
+ *   --------------|--------------------------------------------------------
+ *   response_code | HTTP response code (as string)
+ *   headers       | HTTP headers in response
+ *   output        | stdout (set only if "file_out" was not set in options)
+ *   error         | error message (set only in case of error)
+ *
+ * If timeout is 0, the function blocks until the end of the transfer.
+ * If timeout (in milliseconds) is > 0, the function return an error in the
+ * output hashtable if the timeout is reached while the transfer is still
+ * active.
+ *
+ * If stop_download is not NULL, it is checked regularly, and as soon as the
+ * pointed integer becomes different from 0 (set by the caller of this function),
+ * the download is immediately stopped with an error.
+ *
+ * Return:
+ *   0: OK
+ *   1: invalid URL
+ *   2: error downloading URL
+ *   3: not enough memory
+ *   4: file error
+ *   5: transfer stopped by the caller
+ *   6: transfer timeout
+ */
+
+int
+weeurl_download (const char *url, struct t_hashtable *options,
+                 long timeout, struct t_hashtable *output,
+                 int *stop_transfer)
+{
+    struct t_url_transfer transfer;
+    CURLM *multi;
+    CURLMcode curl_mc;
+    int rc, still_running;
+    struct timeval tv_now, tv_end;
+
+    rc = weeurl_transfer_init (&transfer, url, options, output);
+    if (rc != 0)
+        goto end;
 
     /* compute end time for transfer, according to the timeout */
     if (timeout > 0)
@@ -1141,7 +1236,7 @@ weeurl_download (const char *url, struct t_hashtable *options,
 
     /* start the transfer */
     multi = curl_multi_init ();
-    curl_multi_add_handle (multi, curl);
+    curl_multi_add_handle (multi, transfer.curl);
     while (1)
     {
         curl_mc = curl_multi_perform (multi, &still_running);
@@ -1153,10 +1248,11 @@ weeurl_download (const char *url, struct t_hashtable *options,
         {
             if (output)
             {
-                snprintf (url_error_code, sizeof (url_error_code), "%d", curl_mc);
-                if (!url_error[0])
+                snprintf (transfer.error_code, sizeof (transfer.error_code),
+                          "%d", curl_mc);
+                if (!transfer.error[0])
                 {
-                    snprintf (url_error, sizeof (url_error),
+                    snprintf (transfer.error, sizeof (transfer.error),
                               "%s", _("transfer error"));
                 }
             }
@@ -1168,7 +1264,7 @@ weeurl_download (const char *url, struct t_hashtable *options,
                  */
                 fprintf (stderr,
                          _("curl error %d (%s) (URL: \"%s\")\n"),
-                         curl_mc, url_error, url);
+                         curl_mc, transfer.error, url);
             }
             rc = 2;
             break;
@@ -1176,13 +1272,7 @@ weeurl_download (const char *url, struct t_hashtable *options,
         if (!still_running)
         {
             /* transfer OK */
-            if (output)
-            {
-                curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, &response_code);
-                snprintf (str_response_code, sizeof (str_response_code),
-                          "%ld", response_code);
-                hashtable_set (output, "response_code", str_response_code);
-            }
+            weeurl_transfer_done (&transfer);
             break;
         }
         if (stop_transfer && *stop_transfer)
@@ -1190,8 +1280,11 @@ weeurl_download (const char *url, struct t_hashtable *options,
             /* transfer stopped by the caller */
             if (output)
             {
-                if (!url_error[0])
-                    snprintf (url_error, sizeof (url_error), "transfer stopped");
+                if (!transfer.error[0])
+                {
+                    snprintf (transfer.error, sizeof (transfer.error),
+                              "transfer stopped");
+                }
             }
             else
             {
@@ -1214,9 +1307,9 @@ weeurl_download (const char *url, struct t_hashtable *options,
             {
                 if (output)
                 {
-                    if (!url_error[0])
+                    if (!transfer.error[0])
                     {
-                        snprintf (url_error, sizeof (url_error),
+                        snprintf (transfer.error, sizeof (transfer.error),
                                   URL_ERROR_TIMEOUT " (%.3fs)",
                                   ((float)timeout) / 1000);
                     }
@@ -1238,33 +1331,11 @@ weeurl_download (const char *url, struct t_hashtable *options,
     }
 
     /* cleanup */
-    curl_multi_remove_handle (multi, curl);
-    curl_easy_cleanup (curl);
+    curl_multi_remove_handle (multi, transfer.curl);
     curl_multi_cleanup (multi);
 
 end:
-    for (i = 0; i < 2; i++)
-    {
-        if (url_file[i].stream)
-            fclose (url_file[i].stream);
-    }
-    if (output)
-    {
-        if (string_headers)
-        {
-            hashtable_set (output, "headers", *string_headers);
-            string_dyn_free (string_headers, 1);
-        }
-        if (string_output)
-        {
-            hashtable_set (output, "output", *string_output);
-            string_dyn_free (string_output, 1);
-        }
-        if (url_error[0])
-            hashtable_set (output, "error", url_error);
-        if (url_error_code[0])
-            hashtable_set (output, "error_code_curl", url_error_code);
-    }
+    weeurl_transfer_free (&transfer);
     return rc;
 }
 
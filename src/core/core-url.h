@@ -58,10 +58,27 @@ struct t_url_file
     FILE *stream;                      /* file stream                       */
 };
 
+struct t_url_transfer
+{
+    void *curl;                        /* curl easy handle (CURL *)         */
+    struct t_url_file url_file[2];     /* files for input/output            */
+    char **string_headers;             /* HTTP headers received             */
+    char **string_output;              /* output (if not written in a file) */
+    char error[4096];                  /* error message (set by curl)       */
+    char error_code[12];               /* curl multi error code             */
+    struct t_hashtable *output;        /* output hashtable (may be NULL)    */
+};
+
 extern int url_debug;
 extern char *url_type_string[];
 extern struct t_url_option url_options[];
 
+extern int weeurl_transfer_init (struct t_url_transfer *transfer,
+                                 const char *url,
+                                 struct t_hashtable *options,
+                                 struct t_hashtable *output);
+extern void weeurl_transfer_done (struct t_url_transfer *transfer);
+extern void weeurl_transfer_free (struct t_url_transfer *transfer);
 extern int weeurl_download (const char *url, struct t_hashtable *options,
                             long timeout, struct t_hashtable *output,
                             int *stop_transfer);
@@ -30,10 +30,15 @@
 #endif
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <wchar.h>
 #include <wctype.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "weechat.h"
 #include "core-utf8.h"
 #include "core-config.h"
@@ -42,6 +47,41 @@
 
 int local_utf8 = 0;
 
+/* width of chars on screen (result of wcwidth) for the BMP (U+0000-U+FFFF) */
+signed char utf8_width_table[0x10000];
+int utf8_width_table_ready = 0;
+
+/* 1 if all printable ASCII chars (U+0020-U+007E) have a width of 1 */
+int utf8_ascii_printable_width_one = 0;
+
+
+/*
+ * Initialize table with width of chars in the BMP (computed with wcwidth,
+ * so with the locale that is set when this function is called).
+ */
+
+void
+utf8_init_width_table (void)
+{
+    int i;
+
+    for (i = 0; i < 0x10000; i++)
+    {
+        utf8_width_table[i] = (signed char)wcwidth ((wchar_t)i);
+    }
+
+    utf8_ascii_printable_width_one = 1;
+    for (i = 0x20; i < 0x7F; i++)
+    {
+        if (utf8_width_table[i] != 1)
+        {
+            utf8_ascii_printable_width_one = 0;
+            break;
+        }
+    }
+
+    utf8_width_table_ready = 1;
+}
 
 /*
  * Initialize UTF-8 in WeeChat.
@@ -51,6 +91,100 @@ void
 utf8_init (void)
 {
     local_utf8 = (string_strcasecmp (weechat_local_charset, "utf-8") == 0);
+    utf8_init_width_table ();
+}
+
+/*
+ * Get number of ASCII chars (< 0x80) at beginning of string, reading at
+ * most "bytes" bytes (the string must have at least "bytes" bytes before
+ * the final '\0').
+ *
+ * The string is checked 16 bytes at a time with SSE2 (if available),
+ * otherwise 8 bytes at a time.
+ *
+ * Return the number of ASCII chars.
+ */
+
+int
+utf8_ascii_length (const char *string, int bytes)
+{
+    int i;
+#ifdef __SSE2__
+    __m128i chunk;
+#else
+    uint64_t chunk;
+#endif /* __SSE2__ */
+
+    i = 0;
+
+#ifdef __SSE2__
+    while (i + 16 <= bytes)
+    {
+        chunk = _mm_loadu_si128 ((const __m128i *)(string + i));
+        if (_mm_movemask_epi8 (chunk))
+            break;
+        i += 16;
+    }
+#else
+    while (i + 8 <= bytes)
+    {
+        memcpy (&chunk, string + i, sizeof (chunk));
+        if (chunk & 0x8080808080808080ULL)
+            break;
+        i += 8;
+    }
+#endif /* __SSE2__ */
+
+    while ((i < bytes) && !((unsigned char)string[i] & 0x80))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/*
+ * Get number of printable ASCII chars (U+0020-U+007E) at beginning of
+ * string, reading at most "bytes" bytes (the string must have at least
+ * "bytes" bytes before the final '\0').
+ *
+ * The string is checked 16 bytes at a time with SSE2 (if available).
+ *
+ * Return the number of printable ASCII chars.
+ */
+
+int
+utf8_ascii_printable_length (const char *string, int bytes)
+{
+    int i;
+#ifdef __SSE2__
+    __m128i chunk, printable;
+#endif /* __SSE2__ */
+
+    i = 0;
+
+#ifdef __SSE2__
+    while (i + 16 <= bytes)
+    {
+        chunk = _mm_loadu_si128 ((const __m128i *)(string + i));
+        /* bytes >= 0x80 are negative (signed compare) */
+        printable = _mm_and_si128 (
+            _mm_cmpgt_epi8 (chunk, _mm_set1_epi8 (0x1F)),
+            _mm_cmplt_epi8 (chunk, _mm_set1_epi8 (0x7F)));
+        if (_mm_movemask_epi8 (printable) != 0xFFFF)
+            break;
+        i += 16;
+    }
+#endif /* __SSE2__ */
+
+    while ((i < bytes)
+           && ((unsigned char)string[i] >= 0x20)
+           && ((unsigned char)string[i] < 0x7F))
+    {
+        i++;
+    }
+
+    return i;
 }
 
 /*
@@ -88,13 +222,32 @@ utf8_has_8bits (const char *string)
 int
 utf8_is_valid (const char *string, int length, char **error)
 {
-    int code_point, current_char;
+    int code_point, current_char, ascii_length;
+    const char *end;
 
     current_char = 0;
 
+    /* a valid char has at most 4 bytes */
+    end = NULL;
+    if (string)
+    {
+        end = string + ((length <= 0) ?
+                        strlen (string) : strnlen (string, (size_t)length * 4));
+    }
+
     while (string && string[0]
            && ((length <= 0) || (current_char < length)))
     {
+        /* fast path: skip all ASCII chars at once */
+        if (!((unsigned char)(string[0]) & 0x80))
+        {
+            ascii_length = utf8_ascii_length (string, end - string);
+            if ((length > 0) && (ascii_length > length - current_char))
+                ascii_length = length - current_char;
+            string += ascii_length;
+            current_char += ascii_length;
+            continue;
+        }
         /*
          * UTF-8, 2 bytes, should be: 110vvvvv 10vvvvvv
          * and in range: U+0080 - U+07FF
@@ -149,11 +302,9 @@ utf8_is_valid (const char *string, int length, char **error)
                 goto invalid;
             string += 4;
         }
-        /* UTF-8, 1 byte, should be: 0vvvvvvv */
-        else if ((unsigned char)(string[0]) >= 0x80)
-            goto invalid;
+        /* not a valid first byte for UTF-8 (0vvvvvvv is handled above) */
         else
-            string++;
+            goto invalid;
         current_char++;
     }
     if (error)
@@ -548,6 +699,14 @@ utf8_char_size_screen (const char *string)
         return -1;
     }
 
+    /* use the precomputed width for the BMP */
+    if ((codepoint >= 0) && (codepoint < 0x10000))
+    {
+        if (!utf8_width_table_ready)
+            utf8_init_width_table ();
+        return utf8_width_table[codepoint];
+    }
+
     return wcwidth (codepoint);
 }
 
@@ -560,8 +719,8 @@ utf8_char_size_screen (const char *string)
 int
 utf8_strlen_screen (const char *string)
 {
-    int size_screen, size_screen_char;
-    const char *ptr_string;
+    int size_screen, size_screen_char, length;
+    const char *ptr_string, *end;
 
     if (!string)
         return 0;
@@ -569,10 +728,25 @@ utf8_strlen_screen (const char *string)
     if (!local_utf8)
         return utf8_strlen (string);
 
+    if (!utf8_width_table_ready)
+        utf8_init_width_table ();
+
     size_screen = 0;
     ptr_string = string;
+    end = string + strlen (string);
     while (ptr_string && ptr_string[0])
     {
+        /* fast path: all printable ASCII chars at once (width == 1) */
+        if (utf8_ascii_printable_width_one
+            && ((unsigned char)ptr_string[0] >= 0x20)
+            && ((unsigned char)ptr_string[0] < 0x7F))
+        {
+            length = utf8_ascii_printable_length (ptr_string,
+                                                  end - ptr_string);
+            size_screen += length;
+            ptr_string += length;
+            continue;
+        }
         size_screen_char = utf8_char_size_screen (ptr_string);
         /* count only chars that use at least one column */
         if (size_screen_char > 0)
@@ -23,8 +23,11 @@
 #define WEECHAT_UTF8_H
 
 extern int local_utf8;
+extern signed char utf8_width_table[];
 
 extern void utf8_init (void);
+extern int utf8_ascii_length (const char *string, int bytes);
+extern int utf8_ascii_printable_length (const char *string, int bytes);
 extern int utf8_has_8bits (const char *string);
 extern int utf8_is_valid (const char *string, int length, char **error);
 extern void utf8_normalize (char *string, char replacement);
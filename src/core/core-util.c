@@ -230,6 +230,36 @@ util_timeval_add (struct timeval *tv, long long interval)
         tv->tv_usec = usec;
 }
 
+/*
+ * Get current time using a monotonic clock (not affected by changes of the
+ * system clock), or the system clock if the monotonic clock is not available.
+ *
+ * Note: the time returned is not a date, it must be used only to measure
+ * durations or compare with other times returned by this function.
+ */
+
+void
+util_timeval_monotonic (struct timeval *tv)
+{
+#ifdef HAVE_CLOCK_MONOTONIC
+    struct timespec ts;
+#endif
+
+    if (!tv)
+        return;
+
+#ifdef HAVE_CLOCK_MONOTONIC
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+    {
+        tv->tv_sec = ts.tv_sec;
+        tv->tv_usec = ts.tv_nsec / 1000;
+        return;
+    }
+#endif
+
+    gettimeofday (tv, NULL);
+}
+
 /*
  * Convert microseconds to a string, using format: "H:MM:SS.mmmmmm"
  * where: H=hours, MM=minutes, SS=seconds, mmmmmm=microseconds
@@ -34,6 +34,7 @@ extern int util_parse_longlong (const char *string, int base, long long *result)
 extern int util_timeval_cmp (struct timeval *tv1, struct timeval *tv2);
 extern long long util_timeval_diff (struct timeval *tv1, struct timeval *tv2);
 extern void util_timeval_add (struct timeval *tv, long long interval);
+extern void util_timeval_monotonic (struct timeval *tv);
 
 /* time */
 extern char *util_get_microseconds_string (unsigned long long microseconds);
@@ -32,6 +32,7 @@
 #include "../core-hook.h"
 #include "../core-arraylist.h"
 #include "../core-config.h"
+#include "../core-hashtable.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
 #include "../core-list.h"
@@ -43,6 +44,12 @@
 #include "../../plugins/plugin.h"
 
 
+struct t_hashtable *hook_command_index = NULL;  /* hooks by command name    */
+struct t_arraylist *hook_command_index_sorted = NULL; /* hooks sorted by    */
+                                                      /* command name       */
+unsigned long long hook_command_sequence = 0; /* order of creation of hooks */
+
+
 /*
  * Return description of hook.
  *
@@ -56,7 +63,172 @@ hook_command_get_description (struct t_hook *hook)
 }
 
 /*
- * Search for a command hook in list.
+ * Compare two command hooks with same name: by priority (higher priority
+ * first), then by order of creation (same order as the list of command
+ * hooks).
+ */
+
+int
+hook_command_cmp_priority (struct t_hook *hook1, struct t_hook *hook2)
+{
+    if (hook1 == hook2)
+        return 0;
+
+    if (hook1->priority != hook2->priority)
+        return (hook1->priority > hook2->priority) ? -1 : 1;
+
+    return (HOOK_COMMAND(hook1, sequence) < HOOK_COMMAND(hook2, sequence)) ?
+        -1 : 1;
+}
+
+/*
+ * Compare two command hooks in an arraylist of the index with same command
+ * name.
+ */
+
+int
+hook_command_index_cmp_cb (void *data, struct t_arraylist *arraylist,
+                           void *pointer1, void *pointer2)
+{
+    /* make C compiler happy */
+    (void) data;
+    (void) arraylist;
+
+    return hook_command_cmp_priority ((struct t_hook *)pointer1,
+                                      (struct t_hook *)pointer2);
+}
+
+/*
+ * Compare two command hooks in the arraylist of hooks sorted by command
+ * name (same order as the list of command hooks).
+ */
+
+int
+hook_command_index_sorted_cmp_cb (void *data, struct t_arraylist *arraylist,
+                                  void *pointer1, void *pointer2)
+{
+    struct t_hook *hook1, *hook2;
+    int rc;
+
+    /* make C compiler happy */
+    (void) data;
+    (void) arraylist;
+
+    hook1 = (struct t_hook *)pointer1;
+    hook2 = (struct t_hook *)pointer2;
+
+    rc = string_strcmp (HOOK_COMMAND(hook1, command),
+                        HOOK_COMMAND(hook2, command));
+    if (rc != 0)
+        return rc;
+
+    return hook_command_cmp_priority (hook1, hook2);
+}
+
+/*
+ * Add a command hook in the index (callback called when the hook is added to
+ * the list of hooks).
+ *
+ * The index contains:
+ *   - a hashtable: command name -> arraylist with hooks having this name
+ *     (all plugins), sorted by priority
+ *   - an arraylist with all command hooks sorted by name, used to find
+ *     incomplete commands.
+ */
+
+void
+hook_command_add_cb (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+
+    if (!hook || !hook->hook_data || !HOOK_COMMAND(hook, command))
+        return;
+
+    if (!hook_command_index)
+    {
+        hook_command_index = hashtable_new (
+            256,
+            WEECHAT_HASHTABLE_STRING,
+            WEECHAT_HASHTABLE_POINTER,
+            NULL, NULL);
+        if (!hook_command_index)
+            return;
+    }
+    if (!hook_command_index_sorted)
+    {
+        hook_command_index_sorted = arraylist_new (
+            256, 1, 0,
+            &hook_command_index_sorted_cmp_cb, NULL,
+            NULL, NULL);
+        if (!hook_command_index_sorted)
+            return;
+    }
+
+    ptr_list = hashtable_get (hook_command_index,
+                              HOOK_COMMAND(hook, command));
+    if (!ptr_list)
+    {
+        ptr_list = arraylist_new (2, 1, 0,
+                                  &hook_command_index_cmp_cb, NULL,
+                                  NULL, NULL);
+        if (!ptr_list)
+            return;
+        hashtable_set (hook_command_index, HOOK_COMMAND(hook, command),
+                       ptr_list);
+    }
+    arraylist_add (ptr_list, hook);
+
+    arraylist_add (hook_command_index_sorted, hook);
+}
+
+/*
+ * Remove a command hook from the index.
+ */
+
+void
+hook_command_index_remove (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+    int index;
+
+    if (!HOOK_COMMAND(hook, command))
+        return;
+
+    ptr_list = hashtable_get (hook_command_index,
+                              HOOK_COMMAND(hook, command));
+    if (ptr_list)
+    {
+        (void) arraylist_search (ptr_list, hook, &index, NULL);
+        if (index >= 0)
+            arraylist_remove (ptr_list, index);
+        if (arraylist_size (ptr_list) == 0)
+        {
+            arraylist_free (ptr_list);
+            hashtable_remove (hook_command_index, HOOK_COMMAND(hook, command));
+            if (hook_command_index->items_count == 0)
+            {
+                hashtable_free (hook_command_index);
+                hook_command_index = NULL;
+            }
+        }
+    }
+
+    if (hook_command_index_sorted)
+    {
+        (void) arraylist_search (hook_command_index_sorted, hook, &index,
+                                 NULL);
+        if (index >= 0)
+            arraylist_remove (hook_command_index_sorted, index);
+        if (arraylist_size (hook_command_index_sorted) == 0)
+        {
+            arraylist_free (hook_command_index_sorted);
+            hook_command_index_sorted = NULL;
+        }
+    }
+}
+
+/*
+ * Search for a command hook.
  *
  * Return pointer to hook found, NULL if not found.
  */
@@ -64,17 +236,19 @@ hook_command_get_description (struct t_hook *hook)
 struct t_hook *
 hook_command_search (struct t_weechat_plugin *plugin, const char *command)
 {
+    struct t_arraylist *ptr_list;
     struct t_hook *ptr_hook;
+    int i, size;
 
-    if (!command)
+    if (!command || !hook_command_index)
         return NULL;
 
-    for (ptr_hook = weechat_hooks[HOOK_TYPE_COMMAND]; ptr_hook;
-         ptr_hook = ptr_hook->next_hook)
+    ptr_list = hashtable_get (hook_command_index, command);
+    size = (ptr_list) ? arraylist_size (ptr_list) : 0;
+    for (i = 0; i < size; i++)
     {
-        if (!ptr_hook->deleted
-            && (ptr_hook->plugin == plugin)
-            && (strcmp (HOOK_COMMAND(ptr_hook, command), command) == 0))
+        ptr_hook = (struct t_hook *)arraylist_get (ptr_list, i);
+        if (!ptr_hook->deleted && (ptr_hook->plugin == plugin))
             return ptr_hook;
     }
 
@@ -82,6 +256,64 @@ hook_command_search (struct t_weechat_plugin *plugin, const char *command)
     return NULL;
 }
 
+/*
+ * Search for incomplete commands: commands starting with "command" (but not
+ * equal to "command").
+ *
+ * Return the number of commands found; "hook_incomplete_command" is set to
+ * the last hook found.
+ */
+
+int
+hook_command_search_incomplete (const char *command, int length_command,
+                                struct t_hook **hook_incomplete_command)
+{
+    struct t_hook *ptr_hook;
+    int count, low, high, middle, size;
+
+    *hook_incomplete_command = NULL;
+
+    if (!hook_command_index_sorted)
+        return 0;
+
+    size = arraylist_size (hook_command_index_sorted);
+
+    /* search first hook with command name >= command */
+    low = 0;
+    high = size;
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2);
+        ptr_hook = (struct t_hook *)arraylist_get (hook_command_index_sorted,
+                                                   middle);
+        if (string_strcmp (HOOK_COMMAND(ptr_hook, command), command) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    /* commands starting with "command" are consecutive in the sorted list */
+    count = 0;
+    for (; low < size; low++)
+    {
+        ptr_hook = (struct t_hook *)arraylist_get (hook_command_index_sorted,
+                                                   low);
+        if (string_strncmp (command, HOOK_COMMAND(ptr_hook, command),
+                            length_command) != 0)
+        {
+            break;
+        }
+        if (!ptr_hook->deleted
+            && (strcmp (command, HOOK_COMMAND(ptr_hook, command)) != 0))
+        {
+            *hook_incomplete_command = ptr_hook;
+            count++;
+        }
+    }
+
+    return count;
+}
+
 /*
  * Build variables/arrays that will be used for completion of commands
  * arguments.
@@ -569,6 +801,7 @@ hook_command (struct t_weechat_plugin *plugin, const char *command,
     hook_command_build_completion (new_hook_command);
 
     new_hook_command->keep_spaces_right = 0;
+    new_hook_command->sequence = hook_command_sequence++;
 
     hook_add_to_list (new_hook);
 
@@ -593,14 +826,15 @@ int
 hook_command_exec (struct t_gui_buffer *buffer, int any_plugin,
                    struct t_weechat_plugin *plugin, const char *string)
 {
-    struct t_hook *ptr_hook, *next_hook;
+    struct t_hook *ptr_hook;
     struct t_hook *hook_plugin, *hook_other_plugin, *hook_other_plugin2;
     struct t_hook *hook_incomplete_command;
     struct t_hook_exec_cb hook_exec_cb;
+    struct t_arraylist *ptr_list;
     char **argv, **argv_eol, *command_name;
     const char *ptr_string, *pos;
     int argc, rc, length_command_name, allow_incomplete_commands;
-    int count_other_plugin, count_incomplete_commands, flags;
+    int count_other_plugin, count_incomplete_commands, flags, i, size;
 
     if (!buffer || !string || !string[0])
         return HOOK_COMMAND_EXEC_NOT_FOUND;
@@ -625,43 +859,39 @@ hook_command_exec (struct t_gui_buffer *buffer, int any_plugin,
     count_other_plugin = 0;
     allow_incomplete_commands = CONFIG_BOOLEAN(config_look_command_incomplete);
     count_incomplete_commands = 0;
-    ptr_hook = weechat_hooks[HOOK_TYPE_COMMAND];
-    while (ptr_hook)
-    {
-        next_hook = ptr_hook->next_hook;
 
-        if (!ptr_hook->deleted)
+    /* search hooks with this command name (sorted by priority) */
+    ptr_list = (hook_command_index) ?
+        hashtable_get (hook_command_index, command_name) : NULL;
+    size = (ptr_list) ? arraylist_size (ptr_list) : 0;
+    for (i = 0; i < size; i++)
+    {
+        ptr_hook = (struct t_hook *)arraylist_get (ptr_list, i);
+        if (ptr_hook->deleted)
+            continue;
+        if (ptr_hook->plugin == plugin)
         {
-            if (strcmp (command_name, HOOK_COMMAND(ptr_hook, command)) == 0)
-            {
-                if (ptr_hook->plugin == plugin)
-                {
-                    if (!hook_plugin)
-                        hook_plugin = ptr_hook;
-                }
-                else
-                {
-                    if (any_plugin)
-                    {
-                        if (!hook_other_plugin)
-                            hook_other_plugin = ptr_hook;
-                        else if (!hook_other_plugin2)
-                            hook_other_plugin2 = ptr_hook;
-                        count_other_plugin++;
-                    }
-                }
-            }
-            else if (allow_incomplete_commands
-                     && (string_strncmp (command_name,
-                                         HOOK_COMMAND(ptr_hook, command),
-                                         length_command_name) == 0))
+            if (!hook_plugin)
+                hook_plugin = ptr_hook;
+        }
+        else
+        {
+            if (any_plugin)
             {
-                hook_incomplete_command = ptr_hook;
-                count_incomplete_commands++;
+                if (!hook_other_plugin)
+                    hook_other_plugin = ptr_hook;
+                else if (!hook_other_plugin2)
+                    hook_other_plugin2 = ptr_hook;
+                count_other_plugin++;
             }
         }
+    }
 
-        ptr_hook = next_hook;
+    /* search incomplete commands (used only if no command was found) */
+    if (!hook_plugin && !hook_other_plugin && allow_incomplete_commands)
+    {
+        count_incomplete_commands = hook_command_search_incomplete (
+            command_name, length_command_name, &hook_incomplete_command);
     }
 
     rc = HOOK_COMMAND_EXEC_NOT_FOUND;
@@ -982,6 +1212,8 @@ hook_command_free_data (struct t_hook *hook)
     if (!hook || !hook->hook_data)
         return;
 
+    hook_command_index_remove (hook);
+
     if (HOOK_COMMAND(hook, command))
     {
         free (HOOK_COMMAND(hook, command));
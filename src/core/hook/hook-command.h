@@ -25,6 +25,8 @@
 struct t_weechat_plugin;
 struct t_infolist_item;
 struct t_gui_buffer;
+struct t_hashtable;
+struct t_arraylist;
 
 #define HOOK_COMMAND(hook, var) (((struct t_hook_command *)hook->hook_data)->var)
 
@@ -73,6 +75,7 @@ struct t_hook_command
     int keep_spaces_right;             /* if set to 1: don't strip trailing */
                                        /* spaces in args when the command   */
                                        /* is executed                       */
+    unsigned long long sequence;       /* order of creation of hook         */
 };
 
 struct t_hook_command_similar
@@ -82,7 +85,13 @@ struct t_hook_command_similar
                                        /* Levenshtein distance between cmds */
 };
 
+extern struct t_hashtable *hook_command_index;
+extern struct t_arraylist *hook_command_index_sorted;
+
 extern char *hook_command_get_description (struct t_hook *hook);
+extern struct t_hook *hook_command_search (struct t_weechat_plugin *plugin,
+                                           const char *command);
+extern void hook_command_add_cb (struct t_hook *hook);
 extern char *hook_command_format_args_description (const char *args_description);
 extern struct t_hook *hook_command (struct t_weechat_plugin *plugin,
                                     const char *command,
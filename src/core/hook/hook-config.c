@@ -88,6 +88,8 @@ hook_config (struct t_weechat_plugin *plugin, const char *option,
     new_hook_config->callback = callback;
     new_hook_config->option = strdup ((ptr_option) ? ptr_option :
                                       ((option) ? option : ""));
+    new_hook_config->option_mask = string_mask_compile (
+        new_hook_config->option, 0);
 
     hook_add_to_list (new_hook);
 
@@ -114,7 +116,8 @@ hook_config_exec (const char *option, const char *value)
         if (!ptr_hook->deleted
             && !ptr_hook->running
             && (!HOOK_CONFIG(ptr_hook, option)
-                || (string_match (option, HOOK_CONFIG(ptr_hook, option), 0))))
+                || string_mask_match (HOOK_CONFIG(ptr_hook, option_mask),
+                                      option)))
         {
             hook_callback_start (ptr_hook, &hook_exec_cb);
             (void) (HOOK_CONFIG(ptr_hook, callback))
@@ -146,6 +149,11 @@ hook_config_free_data (struct t_hook *hook)
         free (HOOK_CONFIG(hook, option));
         HOOK_CONFIG(hook, option) = NULL;
     }
+    if (HOOK_CONFIG(hook, option_mask))
+    {
+        string_mask_free (HOOK_CONFIG(hook, option_mask));
+        HOOK_CONFIG(hook, option_mask) = NULL;
+    }
 
     free (hook->hook_data);
     hook->hook_data = NULL;
@@ -170,6 +178,7 @@ hook_config_hdata_hook_config_cb (const void *pointer, void *data,
     {
         HDATA_VAR(struct t_hook_config, callback, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_config, option, STRING, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_config, option_mask, POINTER, 0, NULL, NULL);
     }
     return hdata;
 }
@@ -193,6 +202,8 @@ hook_config_add_to_infolist (struct t_infolist_item *item,
         return 0;
     if (!infolist_new_var_string (item, "option", HOOK_CONFIG(hook, option)))
         return 0;
+    if (!infolist_new_var_pointer (item, "option_mask", HOOK_CONFIG(hook, option_mask)))
+        return 0;
 
     return 1;
 }
@@ -210,4 +221,5 @@ hook_config_print_log (struct t_hook *hook)
     log_printf ("  config data:");
     log_printf ("    callback. . . . . . . : %p", HOOK_CONFIG(hook, callback));
     log_printf ("    option. . . . . . . . : '%s'", HOOK_CONFIG(hook, option));
+    log_printf ("    option_mask . . . . . : %p", HOOK_CONFIG(hook, option_mask));
 }
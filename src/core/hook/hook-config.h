@@ -24,6 +24,7 @@
 
 struct t_weechat_plugin;
 struct t_infolist_item;
+struct t_string_mask;
 
 #define HOOK_CONFIG(hook, var) (((struct t_hook_config *)hook->hook_data)->var)
 
@@ -35,6 +36,7 @@ struct t_hook_config
     t_hook_callback_config *callback;  /* config callback                   */
     char *option;                      /* config option for hook            */
                                        /* (NULL = hook for all options)     */
+    struct t_string_mask *option_mask; /* compiled mask for option          */
 };
 
 extern char *hook_config_get_description (struct t_hook *hook);
@@ -63,7 +63,7 @@ hook_connect_get_description (struct t_hook *hook)
 }
 
 /*
- * Hook a connection to a peer (using fork).
+ * Hook a connection to a peer (using a pool of threads or fork).
  *
  * Return pointer to new hook, NULL if error.
  */
@@ -117,6 +117,7 @@ hook_connect (struct t_weechat_plugin *plugin, const char *proxy,
     new_hook_connect->child_recv = -1;
     new_hook_connect->child_send = -1;
     new_hook_connect->child_pid = 0;
+    new_hook_connect->connect_job = NULL;
     new_hook_connect->hook_child_timer = NULL;
     new_hook_connect->hook_fd = NULL;
     new_hook_connect->handshake_hook_fd = NULL;
@@ -272,6 +273,11 @@ hook_connect_free_data (struct t_hook *hook)
         hook_schedule_clean_process (HOOK_CONNECT(hook, child_pid));
         HOOK_CONNECT(hook, child_pid) = 0;
     }
+    if (HOOK_CONNECT(hook, connect_job))
+    {
+        network_connect_job_cancel (HOOK_CONNECT(hook, connect_job));
+        HOOK_CONNECT(hook, connect_job) = NULL;
+    }
     if (HOOK_CONNECT(hook, child_read) != -1)
     {
         close (HOOK_CONNECT(hook, child_read));
@@ -347,6 +353,7 @@ hook_connect_hdata_hook_connect_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_connect, child_recv, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_connect, child_send, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_connect, child_pid, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_connect, connect_job, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_connect, hook_child_timer, POINTER, 0, NULL, "hook");
         HDATA_VAR(struct t_hook_connect, hook_fd, POINTER, 0, NULL, "hook");
         HDATA_VAR(struct t_hook_connect, handshake_hook_fd, POINTER, 0, NULL, "hook");
@@ -404,6 +411,8 @@ hook_connect_add_to_infolist (struct t_infolist_item *item,
         return 0;
     if (!infolist_new_var_integer (item, "child_pid", HOOK_CONNECT(hook, child_pid)))
         return 0;
+    if (!infolist_new_var_pointer (item, "connect_job", HOOK_CONNECT(hook, connect_job)))
+        return 0;
     if (!infolist_new_var_pointer (item, "hook_child_timer", HOOK_CONNECT(hook, hook_child_timer)))
         return 0;
     if (!infolist_new_var_pointer (item, "hook_fd", HOOK_CONNECT(hook, hook_fd)))
@@ -450,6 +459,7 @@ hook_connect_print_log (struct t_hook *hook)
     log_printf ("    child_recv. . . . . . : %d", HOOK_CONNECT(hook, child_recv));
     log_printf ("    child_send. . . . . . : %d", HOOK_CONNECT(hook, child_send));
     log_printf ("    child_pid . . . . . . : %d", HOOK_CONNECT(hook, child_pid));
+    log_printf ("    connect_job . . . . . : %p", HOOK_CONNECT(hook, connect_job));
     log_printf ("    hook_child_timer. . . : %p", HOOK_CONNECT(hook, hook_child_timer));
     log_printf ("    hook_fd . . . . . . . : %p", HOOK_CONNECT(hook, hook_fd));
     log_printf ("    handshake_hook_fd . . : %p", HOOK_CONNECT(hook, handshake_hook_fd));
@@ -27,11 +27,19 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <poll.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif /* HAVE_EPOLL */
 
 #include "../weechat.h"
+#include "../core-debug.h"
 #include "../core-hook.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
@@ -40,9 +48,29 @@
 #include "../../plugins/plugin.h"
 
 
+/* max number of events returned by one call to epoll_wait() */
+#define HOOK_FD_EPOLL_MAX_EVENTS 256
+
+/* delay between two checks of fd registered in epoll (in seconds) */
+#define HOOK_FD_CHECK_DELAY 1
+
 struct pollfd *hook_fd_pollfd = NULL;  /* file descriptors for poll()       */
 int hook_fd_pollfd_count = 0;          /* number of file descriptors        */
 
+struct t_hook **hook_fd_hooks = NULL;  /* fd hooks indexed by fd            */
+int hook_fd_hooks_size = 0;            /* size of array hook_fd_hooks       */
+
+#ifdef HAVE_EPOLL
+int hook_fd_epoll = -1;                /* epoll file descriptor             */
+struct epoll_event hook_fd_epoll_events[HOOK_FD_EPOLL_MAX_EVENTS];
+unsigned int hook_fd_epoll_last_id = 0; /* last id given to a registration */
+#endif /* HAVE_EPOLL */
+
+int hook_fd_count_epoll = 0;           /* number of fd registered in epoll  */
+int hook_fd_count_poll = 0;            /* number of fd checked with poll()  */
+int hook_fd_epoll_purge = 0;           /* 1 if epoll set must be rebuilt    */
+time_t hook_fd_last_check = 0;         /* last check of fd in epoll         */
+
 
 /*
  * Return description of hook.
@@ -67,7 +95,23 @@ hook_fd_get_description (struct t_hook *hook)
 }
 
 /*
- * Search for a fd hook in list.
+ * Return name of backend used to wait for activity on file descriptors:
+ * "epoll" or "poll".
+ */
+
+const char *
+hook_fd_get_backend (void)
+{
+#ifdef HAVE_EPOLL
+    if (hook_fd_epoll >= 0)
+        return "epoll";
+#endif /* HAVE_EPOLL */
+
+    return "poll";
+}
+
+/*
+ * Search for a fd hook.
  *
  * Return pointer to hook found, NULL if not found.
  */
@@ -75,21 +119,17 @@ hook_fd_get_description (struct t_hook *hook)
 struct t_hook *
 hook_fd_search (int fd)
 {
-    struct t_hook *ptr_hook;
-
-    for (ptr_hook = weechat_hooks[HOOK_TYPE_FD]; ptr_hook;
-         ptr_hook = ptr_hook->next_hook)
-    {
-        if (!ptr_hook->deleted && (HOOK_FD(ptr_hook, fd) == fd))
-            return ptr_hook;
-    }
+    if ((fd < 0) || (fd >= hook_fd_hooks_size))
+        return NULL;
 
-    /* fd hook not found */
-    return NULL;
+    return hook_fd_hooks[fd];
 }
 
 /*
  * Reallocate the "struct pollfd" array for poll().
+ *
+ * The array has one more slot than the number of fd hooks, for the epoll
+ * file descriptor itself.
  */
 
 void
@@ -98,10 +138,11 @@ hook_fd_realloc_pollfd (void)
     struct pollfd *ptr_pollfd;
     int count;
 
-    if (hooks_count[HOOK_TYPE_FD] == hook_fd_pollfd_count)
-        return;
+    count = (hooks_count[HOOK_TYPE_FD] > 0) ?
+        hooks_count[HOOK_TYPE_FD] + 1 : 0;
 
-    count = hooks_count[HOOK_TYPE_FD];
+    if (count == hook_fd_pollfd_count)
+        return;
 
     if (count == 0)
     {
@@ -123,6 +164,214 @@ hook_fd_realloc_pollfd (void)
     hook_fd_pollfd_count = count;
 }
 
+/*
+ * Add a fd hook in the array of hooks indexed by fd.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+hook_fd_index_add (struct t_hook *hook)
+{
+    struct t_hook **new_hooks;
+    int fd, new_size;
+
+    fd = HOOK_FD(hook, fd);
+
+    if (fd >= hook_fd_hooks_size)
+    {
+        new_size = (hook_fd_hooks_size < 64) ? 64 : hook_fd_hooks_size;
+        while (new_size <= fd)
+        {
+            new_size *= 2;
+        }
+        new_hooks = realloc (hook_fd_hooks, new_size * sizeof (*new_hooks));
+        if (!new_hooks)
+            return 0;
+        memset (new_hooks + hook_fd_hooks_size, 0,
+                (new_size - hook_fd_hooks_size) * sizeof (*new_hooks));
+        hook_fd_hooks = new_hooks;
+        hook_fd_hooks_size = new_size;
+    }
+
+    hook_fd_hooks[fd] = hook;
+
+    return 1;
+}
+
+/*
+ * Remove a fd hook from the array of hooks indexed by fd.
+ */
+
+void
+hook_fd_index_remove (struct t_hook *hook)
+{
+    int fd;
+
+    fd = HOOK_FD(hook, fd);
+
+    if ((fd >= 0) && (fd < hook_fd_hooks_size) && (hook_fd_hooks[fd] == hook))
+        hook_fd_hooks[fd] = NULL;
+}
+
+#ifdef HAVE_EPOLL
+/*
+ * Return epoll events for fd hook flags.
+ */
+
+uint32_t
+hook_fd_epoll_events_from_flags (int flags)
+{
+    uint32_t events;
+
+    events = 0;
+    if (flags & HOOK_FD_FLAG_READ)
+        events |= EPOLLIN;
+    if (flags & HOOK_FD_FLAG_WRITE)
+        events |= EPOLLOUT;
+
+    return events;
+}
+
+/*
+ * Add a fd hook in the epoll set.
+ *
+ * The event data contains the fd and the id of registration, so that an
+ * event received for a registration that outlived its hook (or for a fd
+ * number now used by another hook) is detected.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+hook_fd_epoll_add (struct t_hook *hook)
+{
+    struct epoll_event event;
+
+    memset (&event, 0, sizeof (event));
+    event.events = hook_fd_epoll_events_from_flags (HOOK_FD(hook, flags));
+    event.data.u64 = ((uint64_t)HOOK_FD(hook, epoll_id) << 32)
+        | (uint32_t)HOOK_FD(hook, fd);
+
+    return (epoll_ctl (hook_fd_epoll, EPOLL_CTL_ADD, HOOK_FD(hook, fd),
+                       &event) == 0) ? 1 : 0;
+}
+#endif /* HAVE_EPOLL */
+
+/*
+ * Register a fd hook in epoll (if available).
+ *
+ * If the fd can not be registered (epoll not available, invalid fd or fd not
+ * supported by epoll, like a regular file), it is checked with poll().
+ */
+
+void
+hook_fd_register (struct t_hook *hook)
+{
+#ifdef HAVE_EPOLL
+    if (hook_fd_epoll < 0)
+        hook_fd_epoll = epoll_create1 (EPOLL_CLOEXEC);
+
+    if (hook_fd_epoll >= 0)
+    {
+        HOOK_FD(hook, epoll_id) = ++hook_fd_epoll_last_id;
+        if (hook_fd_epoll_add (hook))
+        {
+            HOOK_FD(hook, registered) = 1;
+            hook_fd_count_epoll++;
+            return;
+        }
+    }
+#endif /* HAVE_EPOLL */
+
+    HOOK_FD(hook, registered) = 0;
+    hook_fd_count_poll++;
+}
+
+/*
+ * Unregister a fd hook from epoll.
+ *
+ * If the fd can not be removed from epoll (fd already closed or number
+ * reused by another file), the registration may still be alive in the kernel
+ * (the file can still be open in a dup or a child process), so the epoll set
+ * is rebuilt on next exec of fd hooks.
+ */
+
+void
+hook_fd_unregister (struct t_hook *hook)
+{
+    if (HOOK_FD(hook, registered))
+    {
+#ifdef HAVE_EPOLL
+        if ((hook_fd_epoll >= 0)
+            && (epoll_ctl (hook_fd_epoll, EPOLL_CTL_DEL, HOOK_FD(hook, fd),
+                           NULL) != 0))
+        {
+            hook_fd_epoll_purge = 1;
+        }
+#endif /* HAVE_EPOLL */
+        HOOK_FD(hook, registered) = 0;
+        hook_fd_count_epoll--;
+    }
+    else
+    {
+        hook_fd_count_poll--;
+    }
+}
+
+/*
+ * Move a fd hook registered in epoll to the fds checked with poll().
+ */
+
+void
+hook_fd_move_to_poll (struct t_hook *hook)
+{
+    if (!HOOK_FD(hook, registered))
+        return;
+
+    hook_fd_unregister (hook);
+    hook_fd_count_poll++;
+}
+
+#ifdef HAVE_EPOLL
+/*
+ * Rebuild the epoll set: the epoll fd is closed (which drops all
+ * registrations, including stale ones) and all fd hooks registered in epoll
+ * are added in a new epoll set.
+ *
+ * Fd hooks that can not be added in the new set are checked with poll().
+ */
+
+void
+hook_fd_epoll_rebuild (void)
+{
+    struct t_hook *ptr_hook;
+
+    hook_fd_epoll_purge = 0;
+
+    if (hook_fd_epoll >= 0)
+        close (hook_fd_epoll);
+    hook_fd_epoll = (weechat_hooks[HOOK_TYPE_FD]) ?
+        epoll_create1 (EPOLL_CLOEXEC) : -1;
+
+    for (ptr_hook = weechat_hooks[HOOK_TYPE_FD]; ptr_hook;
+         ptr_hook = ptr_hook->next_hook)
+    {
+        if (HOOK_FD(ptr_hook, registered)
+            && ((hook_fd_epoll < 0) || !hook_fd_epoll_add (ptr_hook)))
+        {
+            HOOK_FD(ptr_hook, registered) = 0;
+            hook_fd_count_epoll--;
+            hook_fd_count_poll++;
+        }
+    }
+}
+#endif /* HAVE_EPOLL */
+
 /*
  * Callback called when a fd hook is added in the list of hooks.
  */
@@ -130,9 +379,8 @@ hook_fd_realloc_pollfd (void)
 void
 hook_fd_add_cb (struct t_hook *hook)
 {
-    /* make C compiler happy */
-    (void) hook;
-
+    hook_fd_index_add (hook);
+    hook_fd_register (hook);
     hook_fd_realloc_pollfd ();
 }
 
@@ -147,6 +395,22 @@ hook_fd_remove_cb (struct t_hook *hook)
     (void) hook;
 
     hook_fd_realloc_pollfd ();
+
+#ifdef HAVE_EPOLL
+    if (!weechat_hooks[HOOK_TYPE_FD] && (hook_fd_epoll >= 0))
+    {
+        close (hook_fd_epoll);
+        hook_fd_epoll = -1;
+        hook_fd_epoll_purge = 0;
+    }
+#endif /* HAVE_EPOLL */
+
+    if (!weechat_hooks[HOOK_TYPE_FD] && hook_fd_hooks)
+    {
+        free (hook_fd_hooks);
+        hook_fd_hooks = NULL;
+        hook_fd_hooks_size = 0;
+    }
 }
 
 /*
@@ -186,6 +450,8 @@ hook_fd (struct t_weechat_plugin *plugin, int fd, int flag_read,
     new_hook_fd->fd = fd;
     new_hook_fd->flags = 0;
     new_hook_fd->error = 0;
+    new_hook_fd->registered = 0;
+    new_hook_fd->epoll_id = 0;
     if (flag_read)
         new_hook_fd->flags |= HOOK_FD_FLAG_READ;
     if (flag_write)
@@ -198,46 +464,239 @@ hook_fd (struct t_weechat_plugin *plugin, int fd, int flag_read,
     return new_hook;
 }
 
+/*
+ * Set flags of a fd hook (read, write, exception).
+ */
+
+void
+hook_fd_set_flags (struct t_hook *hook, int flags)
+{
+#ifdef HAVE_EPOLL
+    struct epoll_event event;
+#endif /* HAVE_EPOLL */
+
+    if (!hook || hook->deleted || (hook->type != HOOK_TYPE_FD)
+        || (HOOK_FD(hook, flags) == flags))
+    {
+        return;
+    }
+
+    HOOK_FD(hook, flags) = flags;
+
+#ifdef HAVE_EPOLL
+    if (HOOK_FD(hook, registered))
+    {
+        memset (&event, 0, sizeof (event));
+        event.events = hook_fd_epoll_events_from_flags (flags);
+        event.data.u64 = ((uint64_t)HOOK_FD(hook, epoll_id) << 32)
+            | (uint32_t)HOOK_FD(hook, fd);
+        if ((epoll_ctl (hook_fd_epoll, EPOLL_CTL_MOD, HOOK_FD(hook, fd),
+                        &event) != 0)
+            && hook_fd_check_bad_fd (hook))
+        {
+            hook_fd_move_to_poll (hook);
+        }
+    }
+#endif /* HAVE_EPOLL */
+}
+
+/*
+ * Check if the fd of a hook is a bad file descriptor (for example closed
+ * without removing the hook).
+ *
+ * An error is displayed the first time a bad file descriptor is found.
+ *
+ * Return:
+ *   1: bad file descriptor
+ *   0: file descriptor OK
+ */
+
+int
+hook_fd_check_bad_fd (struct t_hook *hook)
+{
+    if ((fcntl (HOOK_FD(hook, fd), F_GETFD) != -1) || (errno != EBADF))
+        return 0;
+
+    if (HOOK_FD(hook, error) == 0)
+    {
+        HOOK_FD(hook, error) = errno;
+        gui_chat_printf (NULL,
+                         _("%sBad file descriptor (%d) used in hook_fd"),
+                         gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
+                         HOOK_FD(hook, fd));
+    }
+
+    return 1;
+}
+
+/*
+ * Check file descriptors registered in epoll (at most once per
+ * HOOK_FD_CHECK_DELAY seconds, unless "force" is 1).
+ *
+ * A fd closed without removing the hook is removed from epoll by the kernel
+ * only if no other fd refers to the same file (dup, child process), so the
+ * hook would either never be called again without any error, or receive
+ * events for a fd that is not valid any more: such hooks are moved to the fd
+ * checked with poll(), which skips bad file descriptors.
+ */
+
+void
+hook_fd_check_registered (int force)
+{
+    struct t_hook *ptr_hook;
+    time_t now;
+
+    if (hook_fd_count_epoll == 0)
+        return;
+
+    now = time (NULL);
+    if (!force && (now - hook_fd_last_check < HOOK_FD_CHECK_DELAY)
+        && (now >= hook_fd_last_check))
+    {
+        return;
+    }
+    hook_fd_last_check = now;
+
+    for (ptr_hook = weechat_hooks[HOOK_TYPE_FD]; ptr_hook;
+         ptr_hook = ptr_hook->next_hook)
+    {
+        if (!ptr_hook->deleted && HOOK_FD(ptr_hook, registered)
+            && hook_fd_check_bad_fd (ptr_hook))
+        {
+            hook_fd_move_to_poll (ptr_hook);
+        }
+    }
+}
+
+/*
+ * Run callback of a fd hook (if the hook is not deleted or running).
+ */
+
+void
+hook_fd_run_callback (struct t_hook *ptr_hook)
+{
+    struct t_hook_exec_cb hook_exec_cb;
+
+    if (!ptr_hook || ptr_hook->deleted || ptr_hook->running)
+        return;
+
+    hook_callback_start (ptr_hook, &hook_exec_cb);
+    (void) (HOOK_FD(ptr_hook, callback)) (
+        ptr_hook->callback_pointer,
+        ptr_hook->callback_data,
+        HOOK_FD(ptr_hook, fd));
+    hook_callback_end (ptr_hook, &hook_exec_cb);
+}
+
+#ifdef HAVE_EPOLL
+/*
+ * Wait for events on fd registered in epoll and run callbacks for file
+ * descriptors with activity.
+ *
+ * An event that does not match the current registration of a hook (stale
+ * registration that outlived its hook) is ignored and the epoll set is
+ * rebuilt on next exec of fd hooks.
+ *
+ * Return the number of events received, -1 if error.
+ */
+
+int
+hook_fd_exec_epoll (int timeout)
+{
+    struct t_hook *ptr_hook;
+    int i, ready;
+
+    if (DEBUG_LOOP_ACTIVE)
+        debug_loop_mark (DEBUG_LOOP_PHASE_FD);
+    ready = epoll_wait (hook_fd_epoll, hook_fd_epoll_events,
+                        HOOK_FD_EPOLL_MAX_EVENTS, timeout);
+    if (DEBUG_LOOP_ACTIVE)
+        debug_loop_mark (DEBUG_LOOP_PHASE_WAIT);
+    if (ready <= 0)
+        return ready;
+
+    hook_exec_start ();
+
+    for (i = 0; i < ready; i++)
+    {
+        ptr_hook = hook_fd_search (
+            (int)(uint32_t)(hook_fd_epoll_events[i].data.u64 & 0xFFFFFFFF));
+        if (!ptr_hook || !HOOK_FD(ptr_hook, registered)
+            || (HOOK_FD(ptr_hook, epoll_id) !=
+                (unsigned int)(hook_fd_epoll_events[i].data.u64 >> 32)))
+        {
+            hook_fd_epoll_purge = 1;
+            continue;
+        }
+        hook_fd_run_callback (ptr_hook);
+    }
+
+    hook_exec_end ();
+
+    return ready;
+}
+#endif /* HAVE_EPOLL */
+
 /*
  * Execute fd hooks:
- *   - poll() on fie descriptors
+ *   - wait for activity on file descriptors (epoll_wait() if all fd are
+ *     registered in epoll, poll() otherwise)
  *   - call of hook fd callbacks if needed.
  */
 
 void
 hook_fd_exec (void)
 {
-    struct t_hook *ptr_hook, *next_hook;
-    struct t_hook_exec_cb hook_exec_cb;
-    int i, num_fd, timeout, ready, found;
+    struct t_hook *ptr_hook;
+    int i, num_fd, timeout, ready, epoll_ready;
 
     if (!weechat_hooks[HOOK_TYPE_FD])
         return;
 
-    /* build an array of "struct pollfd" for poll() */
+    timeout = hook_timer_get_time_to_next ();
+    if (hook_process_pending)
+        timeout = 0;
+
+    hook_fd_check_registered (0);
+
+#ifdef HAVE_EPOLL
+    if (hook_fd_epoll_purge)
+        hook_fd_epoll_rebuild ();
+
+    /* all fd are registered in epoll: no need to call poll() */
+    if ((hook_fd_epoll >= 0) && (hook_fd_count_poll == 0))
+    {
+        (void) hook_fd_exec_epoll (timeout);
+        return;
+    }
+#endif /* HAVE_EPOLL */
+
+    /*
+     * build an array of "struct pollfd" for poll(), with the epoll fd
+     * (if used) and the fd not registered in epoll
+     */
     num_fd = 0;
+    epoll_ready = 0;
+#ifdef HAVE_EPOLL
+    if ((hook_fd_epoll >= 0) && (hook_fd_count_epoll > 0)
+        && (num_fd < hook_fd_pollfd_count))
+    {
+        hook_fd_pollfd[num_fd].fd = hook_fd_epoll;
+        hook_fd_pollfd[num_fd].events = POLLIN;
+        hook_fd_pollfd[num_fd].revents = 0;
+        num_fd++;
+        epoll_ready = 1;
+    }
+#endif /* HAVE_EPOLL */
     for (ptr_hook = weechat_hooks[HOOK_TYPE_FD]; ptr_hook;
          ptr_hook = ptr_hook->next_hook)
     {
-        if (!ptr_hook->deleted)
+        if (!ptr_hook->deleted && !HOOK_FD(ptr_hook, registered))
         {
             /* skip invalid file descriptors */
-            if ((fcntl (HOOK_FD(ptr_hook,fd), F_GETFD) == -1)
-                && (errno == EBADF))
-            {
-                if (HOOK_FD(ptr_hook, error) == 0)
-                {
-                    HOOK_FD(ptr_hook, error) = errno;
-                    gui_chat_printf (NULL,
-                                     _("%sBad file descriptor (%d) used in "
-                                       "hook_fd"),
-                                     gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
-                                     HOOK_FD(ptr_hook, fd));
-                }
-            }
-            else
+            if (!hook_fd_check_bad_fd (ptr_hook))
             {
-                if (num_fd > hook_fd_pollfd_count)
+                if (num_fd >= hook_fd_pollfd_count)
                     break;
 
                 hook_fd_pollfd[num_fd].fd = HOOK_FD(ptr_hook, fd);
@@ -254,48 +713,28 @@ hook_fd_exec (void)
     }
 
     /* perform the poll() */
-    timeout = hook_timer_get_time_to_next ();
-    if (hook_process_pending)
-        timeout = 0;
+    if (DEBUG_LOOP_ACTIVE)
+        debug_loop_mark (DEBUG_LOOP_PHASE_FD);
     ready = poll (hook_fd_pollfd, num_fd, timeout);
+    if (DEBUG_LOOP_ACTIVE)
+        debug_loop_mark (DEBUG_LOOP_PHASE_WAIT);
     if (ready <= 0)
         return;
 
     /* execute callbacks for file descriptors with activity */
     hook_exec_start ();
 
-    ptr_hook = weechat_hooks[HOOK_TYPE_FD];
-    while (ptr_hook)
+    for (i = epoll_ready; i < num_fd; i++)
     {
-        next_hook = ptr_hook->next_hook;
-
-        if (!ptr_hook->deleted
-            && !ptr_hook->running)
-        {
-            found = 0;
-            for (i = 0; i < num_fd; i++)
-            {
-                if (hook_fd_pollfd[i].fd == HOOK_FD(ptr_hook, fd)
-                    && hook_fd_pollfd[i].revents)
-                {
-                    found = 1;
-                    break;
-                }
-            }
-            if (found)
-            {
-                hook_callback_start (ptr_hook, &hook_exec_cb);
-                (void) (HOOK_FD(ptr_hook, callback)) (
-                    ptr_hook->callback_pointer,
-                    ptr_hook->callback_data,
-                    HOOK_FD(ptr_hook, fd));
-                hook_callback_end (ptr_hook, &hook_exec_cb);
-            }
-        }
-
-        ptr_hook = next_hook;
+        if (hook_fd_pollfd[i].revents)
+            hook_fd_run_callback (hook_fd_search (hook_fd_pollfd[i].fd));
     }
 
+#ifdef HAVE_EPOLL
+    if (epoll_ready && hook_fd_pollfd[0].revents && (hook_fd_epoll >= 0))
+        (void) hook_fd_exec_epoll (0);
+#endif /* HAVE_EPOLL */
+
     hook_exec_end ();
 }
 
@@ -309,6 +748,9 @@ hook_fd_free_data (struct t_hook *hook)
     if (!hook || !hook->hook_data)
         return;
 
+    hook_fd_index_remove (hook);
+    hook_fd_unregister (hook);
+
     free (hook->hook_data);
     hook->hook_data = NULL;
 }
@@ -333,6 +775,8 @@ hook_fd_hdata_hook_fd_cb (const void *pointer, void *data, const char *hdata_nam
         HDATA_VAR(struct t_hook_fd, fd, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_fd, flags, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_fd, error, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_fd, registered, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_fd, epoll_id, INTEGER, 0, NULL, NULL);
     }
     return hdata;
 }
@@ -360,6 +804,10 @@ hook_fd_add_to_infolist (struct t_infolist_item *item,
         return 0;
     if (!infolist_new_var_integer (item, "error", HOOK_FD(hook, error)))
         return 0;
+    if (!infolist_new_var_integer (item, "registered", HOOK_FD(hook, registered)))
+        return 0;
+    if (!infolist_new_var_integer (item, "epoll_id", HOOK_FD(hook, epoll_id)))
+        return 0;
 
     return 1;
 }
@@ -379,4 +827,6 @@ hook_fd_print_log (struct t_hook *hook)
     log_printf ("    fd. . . . . . . . . . : %d", HOOK_FD(hook, fd));
     log_printf ("    flags . . . . . . . . : %d", HOOK_FD(hook, flags));
     log_printf ("    error . . . . . . . . : %d", HOOK_FD(hook, error));
+    log_printf ("    registered. . . . . . : %d", HOOK_FD(hook, registered));
+    log_printf ("    epoll_id. . . . . . . : %u", HOOK_FD(hook, epoll_id));
 }
@@ -41,9 +41,19 @@ struct t_hook_fd
     int flags;                         /* fd flags (read,write,..)          */
     int error;                         /* contains errno if error occurred  */
                                        /* with fd                           */
+    int registered;                    /* 1 if fd is registered in epoll,   */
+                                       /* 0 if fd is checked with poll()    */
+    unsigned int epoll_id;             /* id of registration in epoll (to   */
+                                       /* detect stale events)              */
 };
 
+extern int hook_fd_count_epoll;
+extern int hook_fd_count_poll;
+extern int hook_fd_epoll_purge;
+
 extern char *hook_fd_get_description (struct t_hook *hook);
+extern const char *hook_fd_get_backend (void);
+extern struct t_hook *hook_fd_search (int fd);
 extern void hook_fd_add_cb (struct t_hook *hook);
 extern void hook_fd_remove_cb (struct t_hook *hook);
 extern struct t_hook *hook_fd (struct t_weechat_plugin *plugin, int fd,
@@ -52,6 +62,9 @@ extern struct t_hook *hook_fd (struct t_weechat_plugin *plugin, int fd,
                                t_hook_callback_fd *callback,
                                const void *callback_pointer,
                                void *callback_data);
+extern void hook_fd_set_flags (struct t_hook *hook, int flags);
+extern int hook_fd_check_bad_fd (struct t_hook *hook);
+extern void hook_fd_check_registered (int force);
 extern void hook_fd_exec (void);
 extern void hook_fd_free_data (struct t_hook *hook);
 extern struct t_hdata *hook_fd_hdata_hook_fd_cb (const void *pointer,
@@ -65,7 +65,7 @@ hook_hsignal (struct t_weechat_plugin *plugin, const char *signal,
 {
     struct t_hook *new_hook;
     struct t_hook_hsignal *new_hook_hsignal;
-    int priority;
+    int i, priority;
     const char *ptr_signal;
 
     if (!signal || !signal[0] || !callback)
@@ -96,6 +96,24 @@ hook_hsignal (struct t_weechat_plugin *plugin, const char *signal,
         | WEECHAT_STRING_SPLIT_STRIP_RIGHT
         | WEECHAT_STRING_SPLIT_COLLAPSE_SEPS,
         0, &new_hook_hsignal->num_signals);
+    new_hook_hsignal->masks = NULL;
+    if (new_hook_hsignal->num_signals > 0)
+    {
+        new_hook_hsignal->masks = malloc (
+            new_hook_hsignal->num_signals * sizeof (*new_hook_hsignal->masks));
+        if (!new_hook_hsignal->masks)
+        {
+            string_free_split (new_hook_hsignal->signals);
+            free (new_hook_hsignal);
+            free (new_hook);
+            return NULL;
+        }
+        for (i = 0; i < new_hook_hsignal->num_signals; i++)
+        {
+            new_hook_hsignal->masks[i] = string_mask_compile (
+                new_hook_hsignal->signals[i], 0);
+        }
+    }
 
     hook_add_to_list (new_hook);
 
@@ -118,7 +136,7 @@ hook_hsignal_match (const char *signal, struct t_hook *hook)
 
     for (i = 0; i < HOOK_HSIGNAL(hook, num_signals); i++)
     {
-        if (string_match (signal, HOOK_HSIGNAL(hook, signals)[i], 0))
+        if (string_mask_match (HOOK_HSIGNAL(hook, masks)[i], signal))
             return 1;
     }
 
@@ -191,6 +209,8 @@ hook_hsignal_send (const char *signal, struct t_hashtable *hashtable)
 void
 hook_hsignal_free_data (struct t_hook *hook)
 {
+    int i;
+
     if (!hook || !hook->hook_data)
         return;
 
@@ -199,6 +219,15 @@ hook_hsignal_free_data (struct t_hook *hook)
         string_free_split (HOOK_HSIGNAL(hook, signals));
         HOOK_HSIGNAL(hook, signals) = NULL;
     }
+    if (HOOK_HSIGNAL(hook, masks))
+    {
+        for (i = 0; i < HOOK_HSIGNAL(hook, num_signals); i++)
+        {
+            string_mask_free (HOOK_HSIGNAL(hook, masks)[i]);
+        }
+        free (HOOK_HSIGNAL(hook, masks));
+        HOOK_HSIGNAL(hook, masks) = NULL;
+    }
     HOOK_HSIGNAL(hook, num_signals) = 0;
 
     free (hook->hook_data);
@@ -225,6 +254,7 @@ hook_hsignal_hdata_hook_hsignal_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_hsignal, callback, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_hsignal, signals, STRING, 0, "*,num_signals", NULL);
         HDATA_VAR(struct t_hook_hsignal, num_signals, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_hsignal, masks, POINTER, 0, "*,num_signals", NULL);
     }
     return hdata;
 }
@@ -277,6 +307,7 @@ hook_hsignal_print_log (struct t_hook *hook)
 
     log_printf ("  signal data:");
     log_printf ("    callback. . . . . . . : %p", HOOK_HSIGNAL(hook, callback));
+    log_printf ("    masks . . . . . . . . : %p", HOOK_HSIGNAL(hook, masks));
     log_printf ("    signals:");
     for (i = 0; i < HOOK_HSIGNAL(hook, num_signals); i++)
     {
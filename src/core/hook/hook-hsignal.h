@@ -24,6 +24,7 @@
 
 struct t_weechat_plugin;
 struct t_infolist_item;
+struct t_string_mask;
 
 #define HOOK_HSIGNAL(hook, var) (((struct t_hook_hsignal *)hook->hook_data)->var)
 
@@ -38,6 +39,7 @@ struct t_hook_hsignal
                                        /* begin or end with "*",            */
                                        /* "*" == any signal                 */
     int num_signals;                   /* number of signals                 */
+    struct t_string_mask **masks;      /* compiled masks (one by signal)    */
 };
 
 extern char *hook_hsignal_get_description (struct t_hook *hook);
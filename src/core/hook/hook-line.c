@@ -112,8 +112,12 @@ hook_line (struct t_weechat_plugin *plugin, const char *buffer_type,
         | WEECHAT_STRING_SPLIT_COLLAPSE_SEPS,
         0,
         &new_hook_line->num_buffers);
+    new_hook_line->buffer_masks = string_mask_list_compile (
+        (const char **)new_hook_line->buffers, 0);
     new_hook_line->tags_array = string_split_tags (tags,
                                                    &new_hook_line->tags_count);
+    new_hook_line->tags_compiled = gui_line_tags_compile (
+        new_hook_line->tags_count, new_hook_line->tags_array);
 
     hook_add_to_list (new_hook);
 
@@ -147,21 +151,19 @@ hook_line_exec (struct t_gui_line *line)
         if (!ptr_hook->deleted && !ptr_hook->running
             && ((HOOK_LINE(ptr_hook, buffer_type) == -1)
                 || ((int)(line->data->buffer->type) == (HOOK_LINE(ptr_hook, buffer_type))))
-            && string_match_list (line->data->buffer->full_name,
-                                  (const char **)HOOK_LINE(ptr_hook, buffers),
-                                  0)
+            && string_mask_list_match (HOOK_LINE(ptr_hook, buffer_masks),
+                                       line->data->buffer->full_name)
             && (!HOOK_LINE(ptr_hook, tags_array)
-                || gui_line_match_tags (line->data,
-                                        HOOK_LINE(ptr_hook, tags_count),
-                                        HOOK_LINE(ptr_hook, tags_array))))
+                || gui_line_match_tags_compiled (
+                    line->data, HOOK_LINE(ptr_hook, tags_compiled))))
         {
             /* create the hashtable that will be sent to callback */
             if (!hashtable)
             {
-                hashtable = hashtable_new (32,
-                                           WEECHAT_HASHTABLE_STRING,
-                                           WEECHAT_HASHTABLE_STRING,
-                                           NULL, NULL);
+                hashtable = hashtable_new_compact (32,
+                                                   WEECHAT_HASHTABLE_STRING,
+                                                   WEECHAT_HASHTABLE_STRING,
+                                                   NULL, NULL);
                 if (!hashtable)
                     break;
             }
@@ -226,11 +228,21 @@ hook_line_free_data (struct t_hook *hook)
         string_free_split (HOOK_LINE(hook, buffers));
         HOOK_LINE(hook, buffers) = NULL;
     }
+    if (HOOK_LINE(hook, buffer_masks))
+    {
+        string_mask_list_free (HOOK_LINE(hook, buffer_masks));
+        HOOK_LINE(hook, buffer_masks) = NULL;
+    }
     if (HOOK_LINE(hook, tags_array))
     {
         string_free_split_tags (HOOK_LINE(hook, tags_array));
         HOOK_LINE(hook, tags_array) = NULL;
     }
+    if (HOOK_LINE(hook, tags_compiled))
+    {
+        gui_line_tags_compiled_free (HOOK_LINE(hook, tags_compiled));
+        HOOK_LINE(hook, tags_compiled) = NULL;
+    }
 
     free (hook->hook_data);
     hook->hook_data = NULL;
@@ -257,8 +269,10 @@ hook_line_hdata_hook_line_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_line, buffer_type, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_line, buffers, STRING, 0, "*,num_buffers", NULL);
         HDATA_VAR(struct t_hook_line, num_buffers, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_line, buffer_masks, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_line, tags_count, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_line, tags_array, STRING, 0, "*,tags_count", NULL);
+        HDATA_VAR(struct t_hook_line, tags_compiled, POINTER, 0, NULL, NULL);
     }
     return hdata;
 }
@@ -286,6 +300,8 @@ hook_line_add_to_infolist (struct t_infolist_item *item,
         return 0;
     if (!infolist_new_var_integer (item, "num_buffers", HOOK_LINE(hook, num_buffers)))
         return 0;
+    if (!infolist_new_var_pointer (item, "buffer_masks", HOOK_LINE(hook, buffer_masks)))
+        return 0;
     if (!infolist_new_var_integer (item, "tags_count", HOOK_LINE(hook, tags_count)))
         return 0;
     if (!infolist_new_var_pointer (item, "tags_array", HOOK_LINE(hook, tags_array)))
@@ -317,6 +333,7 @@ hook_line_print_log (struct t_hook *hook)
         log_printf ("      buffers[%03d]. . . : '%s'",
                     i, HOOK_LINE(hook, buffers)[i]);
     }
+    log_printf ("    buffer_masks. . . . . : %p", HOOK_LINE(hook, buffer_masks));
     log_printf ("    tags_count. . . . . . : %d", HOOK_LINE(hook, tags_count));
     log_printf ("    tags_array. . . . . . : %p", HOOK_LINE(hook, tags_array));
     if (HOOK_LINE(hook, tags_array))
@@ -330,4 +347,5 @@ hook_line_print_log (struct t_hook *hook)
             }
         }
     }
+    log_printf ("    tags_compiled . . . . : %p", HOOK_LINE(hook, tags_compiled));
 }
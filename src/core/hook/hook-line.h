@@ -26,6 +26,8 @@ struct t_weechat_plugin;
 struct t_infolist_item;
 struct t_hashtable;
 struct t_gui_line;
+struct t_gui_line_tags_compiled;
+struct t_string_mask;
 
 #define HOOK_LINE(hook, var) (((struct t_hook_line *)hook->hook_data)->var)
 
@@ -41,8 +43,10 @@ struct t_hook_line
                                        /* hook is executed (see the         */
                                        /* function "buffer_match_list")     */
     int num_buffers;                   /* number of buffers in list         */
+    struct t_string_mask **buffer_masks; /* compiled buffer masks           */
     int tags_count;                    /* number of tags selected           */
     char ***tags_array;                /* tags selected (NULL = any)        */
+    struct t_gui_line_tags_compiled *tags_compiled; /* compiled tags        */
 };
 
 extern char *hook_line_get_description (struct t_hook *hook);
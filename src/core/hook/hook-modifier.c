@@ -29,6 +29,8 @@
 #include <string.h>
 
 #include "../weechat.h"
+#include "../core-arraylist.h"
+#include "../core-hashtable.h"
 #include "../core-hook.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
@@ -37,6 +39,13 @@
 #include "../../plugins/plugin.h"
 
 
+/* max number of hooks executed for a modifier without allocating memory */
+#define HOOK_MODIFIER_HOOKS_STATIC 16
+
+struct t_hashtable *hook_modifier_index = NULL; /* hooks by modifier name   */
+unsigned long long hook_modifier_sequence = 0; /* order of creation of hooks*/
+
+
 /*
  * Return description of hook.
  *
@@ -87,12 +96,182 @@ hook_modifier (struct t_weechat_plugin *plugin, const char *modifier,
     new_hook->hook_data = new_hook_modifier;
     new_hook_modifier->callback = callback;
     new_hook_modifier->modifier = strdup ((ptr_modifier) ? ptr_modifier : modifier);
+    new_hook_modifier->sequence = hook_modifier_sequence++;
 
     hook_add_to_list (new_hook);
 
     return new_hook;
 }
 
+/*
+ * Compare two modifier hooks in an arraylist of the index, using the same
+ * order as the list of modifier hooks: by priority (higher priority first),
+ * then by order of creation.
+ */
+
+int
+hook_modifier_index_cmp_cb (void *data, struct t_arraylist *arraylist,
+                            void *pointer1, void *pointer2)
+{
+    struct t_hook *hook1, *hook2;
+
+    /* make C compiler happy */
+    (void) data;
+    (void) arraylist;
+
+    hook1 = (struct t_hook *)pointer1;
+    hook2 = (struct t_hook *)pointer2;
+
+    if (hook1 == hook2)
+        return 0;
+
+    if (hook1->priority != hook2->priority)
+        return (hook1->priority > hook2->priority) ? -1 : 1;
+
+    return (HOOK_MODIFIER(hook1, sequence) < HOOK_MODIFIER(hook2, sequence)) ?
+        -1 : 1;
+}
+
+/*
+ * Hash a modifier name in the index: only ASCII chars are used (converted to
+ * lower case), so that names equal without case have the same hash.
+ */
+
+unsigned long long
+hook_modifier_index_hash_key_cb (struct t_hashtable *hashtable,
+                                 const void *key)
+{
+    unsigned long long hash;
+    const char *ptr_key;
+    char chr;
+
+    /* make C compiler happy */
+    (void) hashtable;
+
+    hash = 5381;
+    for (ptr_key = (const char *)key; ptr_key[0]; ptr_key++)
+    {
+        chr = ptr_key[0];
+        if ((unsigned char)chr & 0x80)
+            continue;
+        if ((chr >= 'A') && (chr <= 'Z'))
+            chr += ('a' - 'A');
+        hash ^= (hash << 5) + (hash >> 2) + (int)chr;
+    }
+
+    return hash;
+}
+
+/*
+ * Compare two modifier names in the index (case-insensitive).
+ */
+
+int
+hook_modifier_index_keycmp_cb (struct t_hashtable *hashtable,
+                               const void *key1, const void *key2)
+{
+    /* make C compiler happy */
+    (void) hashtable;
+
+    return string_strcasecmp ((const char *)key1, (const char *)key2);
+}
+
+/*
+ * Add a modifier hook in the index (callback called when the hook is added
+ * to the list of hooks).
+ */
+
+void
+hook_modifier_add_cb (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+
+    if (!hook || !hook->hook_data || !HOOK_MODIFIER(hook, modifier))
+        return;
+
+    if (!hook_modifier_index)
+    {
+        hook_modifier_index = hashtable_new (
+            32,
+            WEECHAT_HASHTABLE_STRING,
+            WEECHAT_HASHTABLE_POINTER,
+            &hook_modifier_index_hash_key_cb,
+            &hook_modifier_index_keycmp_cb);
+        if (!hook_modifier_index)
+            return;
+    }
+
+    ptr_list = hashtable_get (hook_modifier_index,
+                              HOOK_MODIFIER(hook, modifier));
+    if (!ptr_list)
+    {
+        ptr_list = arraylist_new (4, 1, 0,
+                                  &hook_modifier_index_cmp_cb, NULL,
+                                  NULL, NULL);
+        if (!ptr_list)
+            return;
+        hashtable_set (hook_modifier_index, HOOK_MODIFIER(hook, modifier),
+                       ptr_list);
+    }
+
+    arraylist_add (ptr_list, hook);
+}
+
+/*
+ * Remove a modifier hook from the index.
+ */
+
+void
+hook_modifier_index_remove (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+    int index;
+
+    if (!HOOK_MODIFIER(hook, modifier))
+        return;
+
+    ptr_list = hashtable_get (hook_modifier_index,
+                              HOOK_MODIFIER(hook, modifier));
+    if (!ptr_list)
+        return;
+
+    (void) arraylist_search (ptr_list, hook, &index, NULL);
+    if (index >= 0)
+        arraylist_remove (ptr_list, index);
+
+    if (arraylist_size (ptr_list) > 0)
+        return;
+
+    arraylist_free (ptr_list);
+    hashtable_remove (hook_modifier_index, HOOK_MODIFIER(hook, modifier));
+    if (hook_modifier_index->items_count == 0)
+    {
+        hashtable_free (hook_modifier_index);
+        hook_modifier_index = NULL;
+    }
+}
+
+/*
+ * Check if a modifier is hooked (at least one modifier hook exists for this
+ * name).
+ *
+ * This can be used before calling hook_modifier_exec, to not build the
+ * string and modifier data when no hook would use them.
+ *
+ * Return:
+ *   1: modifier is hooked
+ *   0: modifier is not hooked
+ */
+
+int
+hook_modifier_is_hooked (const char *modifier)
+{
+    if (!modifier || !modifier[0] || !hook_modifier_index)
+        return 0;
+
+    return (hashtable_get (hook_modifier_index, modifier)) ? 1 : 0;
+}
+
 /*
  * Execute a modifier hook.
  *
@@ -103,9 +282,12 @@ char *
 hook_modifier_exec (struct t_weechat_plugin *plugin, const char *modifier,
                     const char *modifier_data, const char *string)
 {
-    struct t_hook *ptr_hook, *next_hook;
+    struct t_hook *static_hooks[HOOK_MODIFIER_HOOKS_STATIC];
+    struct t_hook **hooks, *ptr_hook;
     struct t_hook_exec_cb hook_exec_cb;
+    struct t_arraylist *ptr_list;
     char *new_msg, *message_modified;
+    int i, num_hooks;
 
     /* make C compiler happy */
     (void) plugin;
@@ -113,51 +295,76 @@ hook_modifier_exec (struct t_weechat_plugin *plugin, const char *modifier,
     if (!modifier || !modifier[0] || !string)
         return NULL;
 
+    ptr_list = (hook_modifier_index) ?
+        hashtable_get (hook_modifier_index, modifier) : NULL;
+    num_hooks = (ptr_list) ? arraylist_size (ptr_list) : 0;
+
+    /* no hook for this modifier: return a copy of string */
+    if (num_hooks == 0)
+        return strdup (string);
+
+    /* copy hooks to run (the index can be changed by callbacks) */
+    if (num_hooks <= HOOK_MODIFIER_HOOKS_STATIC)
+    {
+        hooks = static_hooks;
+    }
+    else
+    {
+        hooks = malloc (num_hooks * sizeof (*hooks));
+        if (!hooks)
+            return NULL;
+    }
+    for (i = 0; i < num_hooks; i++)
+    {
+        hooks[i] = arraylist_get (ptr_list, i);
+    }
+
     new_msg = NULL;
     message_modified = strdup (string);
     if (!message_modified)
+    {
+        if (hooks != static_hooks)
+            free (hooks);
         return NULL;
+    }
 
     hook_exec_start ();
 
-    ptr_hook = weechat_hooks[HOOK_TYPE_MODIFIER];
-    while (ptr_hook)
+    for (i = 0; i < num_hooks; i++)
     {
-        next_hook = ptr_hook->next_hook;
-
-        if (!ptr_hook->deleted
-            && !ptr_hook->running
-            && (string_strcasecmp (HOOK_MODIFIER(ptr_hook, modifier),
-                                   modifier) == 0))
+        ptr_hook = hooks[i];
+
+        if (ptr_hook->deleted || ptr_hook->running)
+            continue;
+
+        hook_callback_start (ptr_hook, &hook_exec_cb);
+        new_msg = (HOOK_MODIFIER(ptr_hook, callback))
+            (ptr_hook->callback_pointer,
+             ptr_hook->callback_data,
+             modifier,
+             modifier_data,
+             message_modified);
+        hook_callback_end (ptr_hook, &hook_exec_cb);
+
+        /* empty string returned => message dropped */
+        if (new_msg && !new_msg[0])
         {
-            hook_callback_start (ptr_hook, &hook_exec_cb);
-            new_msg = (HOOK_MODIFIER(ptr_hook, callback))
-                (ptr_hook->callback_pointer,
-                 ptr_hook->callback_data,
-                 modifier,
-                 modifier_data,
-                 message_modified);
-            hook_callback_end (ptr_hook, &hook_exec_cb);
-
-            /* empty string returned => message dropped */
-            if (new_msg && !new_msg[0])
-            {
-                free (message_modified);
-                hook_exec_end ();
-                return new_msg;
-            }
-
-            /* new message => keep it as base for next modifier */
-            if (new_msg)
-            {
-                free (message_modified);
-                message_modified = new_msg;
-            }
+            free (message_modified);
+            message_modified = new_msg;
+            break;
         }
 
-        ptr_hook = next_hook;
+        /* new message => keep it as base for next modifier */
+        if (new_msg)
+        {
+            free (message_modified);
+            message_modified = new_msg;
+        }
     }
 
+    if (hooks != static_hooks)
+        free (hooks);
+
     hook_exec_end ();
 
     return message_modified;
@@ -173,6 +380,8 @@ hook_modifier_free_data (struct t_hook *hook)
     if (!hook || !hook->hook_data)
         return;
 
+    hook_modifier_index_remove (hook);
+
     if (HOOK_MODIFIER(hook, modifier))
     {
         free (HOOK_MODIFIER(hook, modifier));
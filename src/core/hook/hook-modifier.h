@@ -24,6 +24,7 @@
 
 struct t_weechat_plugin;
 struct t_infolist_item;
+struct t_hashtable;
 
 #define HOOK_MODIFIER(hook, var) (((struct t_hook_modifier *)hook->hook_data)->var)
 
@@ -36,14 +37,19 @@ struct t_hook_modifier
 {
     t_hook_callback_modifier *callback; /* modifier callback                */
     char *modifier;                     /* name of modifier                 */
+    unsigned long long sequence;        /* order of creation of hook        */
 };
 
+extern struct t_hashtable *hook_modifier_index;
+
 extern char *hook_modifier_get_description (struct t_hook *hook);
 extern struct t_hook *hook_modifier (struct t_weechat_plugin *plugin,
                                      const char *modifier,
                                      t_hook_callback_modifier *callback,
                                      const void *callback_pointer,
                                      void *callback_data);
+extern void hook_modifier_add_cb (struct t_hook *hook);
+extern int hook_modifier_is_hooked (const char *modifier);
 extern char *hook_modifier_exec (struct t_weechat_plugin *plugin,
                                  const char *modifier,
                                  const char *modifier_data,
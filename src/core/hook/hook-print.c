@@ -29,6 +29,8 @@
 #include <string.h>
 
 #include "../weechat.h"
+#include "../core-arraylist.h"
+#include "../core-hashtable.h"
 #include "../core-hook.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
@@ -40,6 +42,14 @@
 #include "../../plugins/plugin.h"
 
 
+/* max number of hooks executed for a line without allocating memory */
+#define HOOK_PRINT_HOOKS_STATIC 32
+
+struct t_hashtable *hook_print_index_buffer = NULL; /* hooks by buffer      */
+struct t_arraylist *hook_print_index_any = NULL;    /* hooks for any buffer */
+unsigned long long hook_print_sequence = 0;   /* order of creation of hooks */
+
+
 /*
  * Return description of hook.
  *
@@ -109,24 +119,156 @@ hook_print (struct t_weechat_plugin *plugin, struct t_gui_buffer *buffer,
     new_hook_print->buffer = buffer;
     new_hook_print->tags_array = string_split_tags (tags,
                                                     &new_hook_print->tags_count);
+    new_hook_print->tags_compiled = gui_line_tags_compile (
+        new_hook_print->tags_count, new_hook_print->tags_array);
     new_hook_print->message = (message) ? strdup (message) : NULL;
     new_hook_print->strip_colors = strip_colors;
+    new_hook_print->sequence = hook_print_sequence++;
 
     hook_add_to_list (new_hook);
 
     return new_hook;
 }
 
+/*
+ * Compare two print hooks in an arraylist of the index: by order of creation
+ * (same order as the list of print hooks, all print hooks have the same
+ * priority).
+ */
+
+int
+hook_print_index_cmp_cb (void *data, struct t_arraylist *arraylist,
+                         void *pointer1, void *pointer2)
+{
+    struct t_hook *hook1, *hook2;
+
+    /* make C compiler happy */
+    (void) data;
+    (void) arraylist;
+
+    hook1 = (struct t_hook *)pointer1;
+    hook2 = (struct t_hook *)pointer2;
+
+    if (HOOK_PRINT(hook1, sequence) == HOOK_PRINT(hook2, sequence))
+        return 0;
+
+    return (HOOK_PRINT(hook1, sequence) < HOOK_PRINT(hook2, sequence)) ?
+        -1 : 1;
+}
+
+/*
+ * Add a print hook in the index (callback called when the hook is added to
+ * the list of hooks): hooks on a buffer are stored in a hashtable with the
+ * buffer pointer as key, hooks on any buffer are stored in a separate list.
+ */
+
+void
+hook_print_add_cb (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+
+    if (!hook || !hook->hook_data)
+        return;
+
+    if (HOOK_PRINT(hook, buffer))
+    {
+        if (!hook_print_index_buffer)
+        {
+            hook_print_index_buffer = hashtable_new (
+                32,
+                WEECHAT_HASHTABLE_POINTER,
+                WEECHAT_HASHTABLE_POINTER,
+                NULL, NULL);
+            if (!hook_print_index_buffer)
+                return;
+        }
+        ptr_list = hashtable_get (hook_print_index_buffer,
+                                  HOOK_PRINT(hook, buffer));
+        if (!ptr_list)
+        {
+            ptr_list = arraylist_new (4, 1, 0,
+                                      &hook_print_index_cmp_cb, NULL,
+                                      NULL, NULL);
+            if (!ptr_list)
+                return;
+            hashtable_set (hook_print_index_buffer,
+                           HOOK_PRINT(hook, buffer), ptr_list);
+        }
+    }
+    else
+    {
+        if (!hook_print_index_any)
+        {
+            hook_print_index_any = arraylist_new (4, 1, 0,
+                                                  &hook_print_index_cmp_cb,
+                                                  NULL, NULL, NULL);
+            if (!hook_print_index_any)
+                return;
+        }
+        ptr_list = hook_print_index_any;
+    }
+
+    arraylist_add (ptr_list, hook);
+}
+
+/*
+ * Remove a print hook from the index.
+ */
+
+void
+hook_print_index_remove (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+    int index;
+
+    ptr_list = (HOOK_PRINT(hook, buffer)) ?
+        hashtable_get (hook_print_index_buffer, HOOK_PRINT(hook, buffer)) :
+        hook_print_index_any;
+    if (!ptr_list)
+        return;
+
+    (void) arraylist_search (ptr_list, hook, &index, NULL);
+    if (index >= 0)
+        arraylist_remove (ptr_list, index);
+
+    if (arraylist_size (ptr_list) > 0)
+        return;
+
+    arraylist_free (ptr_list);
+    if (HOOK_PRINT(hook, buffer))
+    {
+        hashtable_remove (hook_print_index_buffer, HOOK_PRINT(hook, buffer));
+        if (hook_print_index_buffer->items_count == 0)
+        {
+            hashtable_free (hook_print_index_buffer);
+            hook_print_index_buffer = NULL;
+        }
+    }
+    else
+    {
+        hook_print_index_any = NULL;
+    }
+}
+
 /*
  * Execute a print hook.
+ *
+ * Hooks are searched in the index (hooks on this buffer and hooks on any
+ * buffer), and colors are removed from prefix/message only if a hook needs
+ * it.
  */
 
 void
 hook_print_exec (struct t_gui_buffer *buffer, struct t_gui_line *line)
 {
-    struct t_hook *ptr_hook, *next_hook;
+    struct t_hook *static_hooks[HOOK_PRINT_HOOKS_STATIC];
+    struct t_hook **hooks, *ptr_hook, *hook_buffer, *hook_any;
     struct t_hook_exec_cb hook_exec_cb;
-    char *prefix_no_color, *message_no_color;
+    struct t_arraylist *list_buffer;
+    const char *prefix_no_color, *message_no_color;
+    char *prefix_decoded, *message_decoded;
+    int i, num_hooks, size_buffer, size_any, index_buffer, index_any;
+    int colors_decoded;
 
     if (!weechat_hooks[HOOK_TYPE_PRINT])
         return;
@@ -134,36 +276,95 @@ hook_print_exec (struct t_gui_buffer *buffer, struct t_gui_line *line)
     if (!line->data->message)
         return;
 
-    prefix_no_color = (line->data->prefix) ?
-        gui_color_decode (line->data->prefix, NULL) : NULL;
+    list_buffer = (hook_print_index_buffer) ?
+        hashtable_get (hook_print_index_buffer, buffer) : NULL;
+    size_buffer = (list_buffer) ? arraylist_size (list_buffer) : 0;
+    size_any = (hook_print_index_any) ?
+        arraylist_size (hook_print_index_any) : 0;
+    num_hooks = size_buffer + size_any;
 
-    message_no_color = gui_color_decode (line->data->message, NULL);
-    if (!message_no_color)
-    {
-        free (prefix_no_color);
+    /* no hook on this buffer */
+    if (num_hooks == 0)
         return;
+
+    /*
+     * build list of hooks to run (the index can be changed by callbacks),
+     * sorted by order of creation
+     */
+    if (num_hooks <= HOOK_PRINT_HOOKS_STATIC)
+    {
+        hooks = static_hooks;
+    }
+    else
+    {
+        hooks = malloc (num_hooks * sizeof (*hooks));
+        if (!hooks)
+            return;
+    }
+    index_buffer = 0;
+    index_any = 0;
+    for (i = 0; i < num_hooks; i++)
+    {
+        hook_buffer = (index_buffer < size_buffer) ?
+            arraylist_get (list_buffer, index_buffer) : NULL;
+        hook_any = (index_any < size_any) ?
+            arraylist_get (hook_print_index_any, index_any) : NULL;
+        if (hook_buffer
+            && (!hook_any
+                || (HOOK_PRINT(hook_buffer, sequence)
+                    < HOOK_PRINT(hook_any, sequence))))
+        {
+            hooks[i] = hook_buffer;
+            index_buffer++;
+        }
+        else
+        {
+            hooks[i] = hook_any;
+            index_any++;
+        }
     }
 
+    prefix_no_color = NULL;
+    message_no_color = NULL;
+    prefix_decoded = NULL;
+    message_decoded = NULL;
+    colors_decoded = 0;
+
     hook_exec_start ();
 
-    ptr_hook = weechat_hooks[HOOK_TYPE_PRINT];
-    while (ptr_hook)
+    for (i = 0; i < num_hooks; i++)
     {
-        next_hook = ptr_hook->next_hook;
-
-        if (!ptr_hook->deleted
-            && !ptr_hook->running
-            && (!HOOK_PRINT(ptr_hook, buffer)
-                || (buffer == HOOK_PRINT(ptr_hook, buffer)))
-            && (!HOOK_PRINT(ptr_hook, message)
-                || !HOOK_PRINT(ptr_hook, message)[0]
-                || string_strcasestr (prefix_no_color, HOOK_PRINT(ptr_hook, message))
-                || string_strcasestr (message_no_color, HOOK_PRINT(ptr_hook, message)))
+        ptr_hook = hooks[i];
+
+        if (ptr_hook->deleted || ptr_hook->running)
+            continue;
+
+        /* remove colors in prefix/message, only once and if needed */
+        if (!colors_decoded
+            && (HOOK_PRINT(ptr_hook, strip_colors)
+                || (HOOK_PRINT(ptr_hook, message)
+                    && HOOK_PRINT(ptr_hook, message)[0])))
+        {
+            prefix_no_color = gui_color_decode_borrow (line->data->prefix,
+                                                       NULL,
+                                                       &prefix_decoded);
+            message_no_color = gui_color_decode_borrow (line->data->message,
+                                                        NULL,
+                                                        &message_decoded);
+            colors_decoded = 1;
+        }
+
+        if ((!HOOK_PRINT(ptr_hook, message)
+             || !HOOK_PRINT(ptr_hook, message)[0]
+             || string_strcasestr (prefix_no_color, HOOK_PRINT(ptr_hook, message))
+             || string_strcasestr (message_no_color, HOOK_PRINT(ptr_hook, message)))
             && (!HOOK_PRINT(ptr_hook, tags_array)
-                || gui_line_match_tags (line->data,
-                                        HOOK_PRINT(ptr_hook, tags_count),
-                                        HOOK_PRINT(ptr_hook, tags_array))))
+                || gui_line_match_tags_compiled (
+                    line->data, HOOK_PRINT(ptr_hook, tags_compiled))))
         {
+            if (HOOK_PRINT(ptr_hook, strip_colors) && !message_no_color)
+                continue;
+
             /* run callback */
             hook_callback_start (ptr_hook, &hook_exec_cb);
             (void) (HOOK_PRINT(ptr_hook, callback))
@@ -179,12 +380,13 @@ hook_print_exec (struct t_gui_buffer *buffer, struct t_gui_line *line)
                  (HOOK_PRINT(ptr_hook, strip_colors)) ? message_no_color : line->data->message);
             hook_callback_end (ptr_hook, &hook_exec_cb);
         }
-
-        ptr_hook = next_hook;
     }
 
-    free (prefix_no_color);
-    free (message_no_color);
+    free (prefix_decoded);
+    free (message_decoded);
+
+    if (hooks != static_hooks)
+        free (hooks);
 
     hook_exec_end ();
 }
@@ -199,11 +401,18 @@ hook_print_free_data (struct t_hook *hook)
     if (!hook || !hook->hook_data)
         return;
 
+    hook_print_index_remove (hook);
+
     if (HOOK_PRINT(hook, tags_array))
     {
         string_free_split_tags (HOOK_PRINT(hook, tags_array));
         HOOK_PRINT(hook, tags_array) = NULL;
     }
+    if (HOOK_PRINT(hook, tags_compiled))
+    {
+        gui_line_tags_compiled_free (HOOK_PRINT(hook, tags_compiled));
+        HOOK_PRINT(hook, tags_compiled) = NULL;
+    }
     if (HOOK_PRINT(hook, message))
     {
         free (HOOK_PRINT(hook, message));
@@ -235,6 +444,7 @@ hook_print_hdata_hook_print_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_print, buffer, POINTER, 0, NULL, "buffer");
         HDATA_VAR(struct t_hook_print, tags_count, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_print, tags_array, STRING, 0, "*,tags_count", NULL);
+        HDATA_VAR(struct t_hook_print, tags_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_print, message, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_print, strip_colors, INTEGER, 0, NULL, NULL);
     }
@@ -301,6 +511,7 @@ hook_print_print_log (struct t_hook *hook)
             }
         }
     }
+    log_printf ("    tags_compiled . . . . : %p", HOOK_PRINT(hook, tags_compiled));
     log_printf ("    message . . . . . . . : '%s'", HOOK_PRINT(hook, message));
     log_printf ("    strip_colors. . . . . : %d", HOOK_PRINT(hook, strip_colors));
 }
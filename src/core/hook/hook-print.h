@@ -28,6 +28,9 @@ struct t_weechat_plugin;
 struct t_infolist_item;
 struct t_gui_buffer;
 struct t_gui_line;
+struct t_gui_line_tags_compiled;
+struct t_hashtable;
+struct t_arraylist;
 
 #define HOOK_PRINT(hook, var) (((struct t_hook_print *)hook->hook_data)->var)
 
@@ -44,10 +47,15 @@ struct t_hook_print
     struct t_gui_buffer *buffer;       /* buffer selected (NULL = all)      */
     int tags_count;                    /* number of tags selected           */
     char ***tags_array;                /* tags selected (NULL = any)        */
+    struct t_gui_line_tags_compiled *tags_compiled; /* compiled tags        */
     char *message;                     /* part of message (NULL/empty = all)*/
     int strip_colors;                  /* strip colors in msg for callback? */
+    unsigned long long sequence;       /* order of creation of hook         */
 };
 
+extern struct t_hashtable *hook_print_index_buffer;
+extern struct t_arraylist *hook_print_index_any;
+
 extern char *hook_print_get_description (struct t_hook *hook);
 extern struct t_hook *hook_print (struct t_weechat_plugin *plugin,
                                   struct t_gui_buffer *buffer,
@@ -56,6 +64,7 @@ extern struct t_hook *hook_print (struct t_weechat_plugin *plugin,
                                   t_hook_callback_print *callback,
                                   const void *callback_pointer,
                                   void *callback_data);
+extern void hook_print_add_cb (struct t_hook *hook);
 extern void hook_print_exec (struct t_gui_buffer *buffer,
                              struct t_gui_line *line);
 extern void hook_print_free_data (struct t_hook *hook);
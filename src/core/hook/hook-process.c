@@ -32,6 +32,9 @@
 #include <poll.h>
 #include <fcntl.h>
 #include <errno.h>
+#ifdef HAVE_POSIX_SPAWN
+#include <spawn.h>
+#endif
 
 #include "../weechat.h"
 #include "../core-hook.h"
@@ -50,6 +53,10 @@ int hook_process_pending = 0;          /* 1 if there are some process to    */
                                        /* run (via fork)                    */
 
 
+#ifdef HAVE_POSIX_SPAWN
+extern char **environ;
+#endif
+
 void hook_process_run (struct t_hook *hook_process);
 
 
@@ -204,6 +211,97 @@ hook_process (struct t_weechat_plugin *plugin,
                                    callback, callback_pointer, callback_data);
 }
 
+/*
+ * Build arguments to execute the command of a process hook (the first
+ * argument is the binary to execute).
+ *
+ * Note: result must be freed after use with function string_free_split().
+ */
+
+char **
+hook_process_get_exec_args (struct t_hook *hook_process)
+{
+    char **exec_args, *arg0, str_arg[64], **ptr_exec_arg;
+    const char *ptr_arg;
+    int i, num_args;
+
+    num_args = 0;
+    if (HOOK_PROCESS(hook_process, options))
+    {
+        /*
+         * count number of arguments given in the hashtable options,
+         * keys are: "arg1", "arg2", ...
+         */
+        while (1)
+        {
+            snprintf (str_arg, sizeof (str_arg), "arg%d", num_args + 1);
+            ptr_arg = hashtable_get (HOOK_PROCESS(hook_process, options),
+                                     str_arg);
+            if (!ptr_arg)
+                break;
+            num_args++;
+        }
+    }
+    if (num_args > 0)
+    {
+        /*
+         * if at least one argument was found in hashtable option, the
+         * "command" contains only path to binary (without arguments), and
+         * the arguments are in hashtable
+         */
+        exec_args = malloc ((num_args + 2) * sizeof (exec_args[0]));
+        if (exec_args)
+        {
+            exec_args[0] = strdup (HOOK_PROCESS(hook_process, command));
+            for (i = 1; i <= num_args; i++)
+            {
+                snprintf (str_arg, sizeof (str_arg), "arg%d", i);
+                ptr_arg = hashtable_get (HOOK_PROCESS(hook_process, options),
+                                         str_arg);
+                exec_args[i] = (ptr_arg) ? strdup (ptr_arg) : NULL;
+            }
+            exec_args[num_args + 1] = NULL;
+        }
+    }
+    else
+    {
+        /*
+         * if no arguments were found in hashtable, make an automatic split
+         * of command, like the shell does
+         */
+        exec_args = string_split_shell (HOOK_PROCESS(hook_process, command),
+                                        NULL);
+    }
+
+    if (!exec_args)
+        return NULL;
+
+    if (!exec_args[0])
+    {
+        string_free_split (exec_args);
+        return NULL;
+    }
+
+    arg0 = string_expand_home (exec_args[0]);
+    if (arg0)
+    {
+        free (exec_args[0]);
+        exec_args[0] = arg0;
+    }
+    if (weechat_debug_core >= 1)
+    {
+        log_printf ("hook_process, command='%s'",
+                    HOOK_PROCESS(hook_process, command));
+        for (ptr_exec_arg = exec_args, i = 0; *ptr_exec_arg;
+             ptr_exec_arg++, i++)
+        {
+            log_printf ("  args[%d] == '%s'", i, *ptr_exec_arg);
+        }
+    }
+
+    return exec_args;
+}
+
 /*
  * Child process for hook process: execute command and return string result
  * into pipe for WeeChat process.
@@ -212,9 +310,9 @@ hook_process (struct t_weechat_plugin *plugin,
 void
 hook_process_child (struct t_hook *hook_process)
 {
-    char **exec_args, *arg0, str_arg[64], **ptr_exec_arg;
-    const char *ptr_url, *ptr_arg;
-    int rc, i, num_args;
+    char **exec_args;
+    const char *ptr_url;
+    int rc;
     FILE *f;
 
     /* read stdin from parent, if a pipe was defined */
@@ -296,74 +394,9 @@ hook_process_child (struct t_hook *hook_process)
     else
     {
         /* launch command */
-        num_args = 0;
-        if (HOOK_PROCESS(hook_process, options))
-        {
-            /*
-             * count number of arguments given in the hashtable options,
-             * keys are: "arg1", "arg2", ...
-             */
-            while (1)
-            {
-                snprintf (str_arg, sizeof (str_arg), "arg%d", num_args + 1);
-                ptr_arg = hashtable_get (HOOK_PROCESS(hook_process, options),
-                                         str_arg);
-                if (!ptr_arg)
-                    break;
-                num_args++;
-            }
-        }
-        if (num_args > 0)
-        {
-            /*
-             * if at least one argument was found in hashtable option, the
-             * "command" contains only path to binary (without arguments), and
-             * the arguments are in hashtable
-             */
-            exec_args = malloc ((num_args + 2) * sizeof (exec_args[0]));
-            if (exec_args)
-            {
-                exec_args[0] = strdup (HOOK_PROCESS(hook_process, command));
-                for (i = 1; i <= num_args; i++)
-                {
-                    snprintf (str_arg, sizeof (str_arg), "arg%d", i);
-                    ptr_arg = hashtable_get (HOOK_PROCESS(hook_process, options),
-                                             str_arg);
-                    exec_args[i] = (ptr_arg) ? strdup (ptr_arg) : NULL;
-                }
-                exec_args[num_args + 1] = NULL;
-            }
-        }
-        else
-        {
-            /*
-             * if no arguments were found in hashtable, make an automatic split
-             * of command, like the shell does
-             */
-            exec_args = string_split_shell (HOOK_PROCESS(hook_process, command),
-                                            NULL);
-        }
-
+        exec_args = hook_process_get_exec_args (hook_process);
         if (exec_args)
-        {
-            arg0 = string_expand_home (exec_args[0]);
-            if (arg0)
-            {
-                free (exec_args[0]);
-                exec_args[0] = arg0;
-            }
-            if (weechat_debug_core >= 1)
-            {
-                log_printf ("hook_process, command='%s'",
-                            HOOK_PROCESS(hook_process, command));
-                for (ptr_exec_arg = exec_args, i = 0; *ptr_exec_arg;
-                     ptr_exec_arg++, i++)
-                {
-                    log_printf ("  args[%d] == '%s'", i, *ptr_exec_arg);
-                }
-            }
             execvp (exec_args[0], exec_args);
-        }
 
         /* should not be executed if execvp was OK */
         string_free_split (exec_args);
@@ -377,6 +410,109 @@ hook_process_child (struct t_hook *hook_process)
     _exit (rc);
 }
 
+#ifdef HAVE_POSIX_SPAWN
+/*
+ * Start the command of a process hook with posix_spawnp() (only for a
+ * command, not for "url:" and "func:" which must run in a fork of WeeChat).
+ *
+ * Unlike fork(), posix_spawnp() does not copy the memory of WeeChat
+ * (which can be large with a lot of lines in buffers), so it is much faster.
+ *
+ * Return PID of child process, -1 if the command could not be started with
+ * posix_spawnp() (then fork() must be used).
+ */
+
+pid_t
+hook_process_spawn (struct t_hook *hook_process)
+{
+    posix_spawn_file_actions_t file_actions;
+    posix_spawnattr_t attr;
+    char **exec_args;
+    int i, fd_std[3], rc;
+    pid_t pid;
+
+    if ((strncmp (HOOK_PROCESS(hook_process, command), "url:", 4) == 0)
+        || (strncmp (HOOK_PROCESS(hook_process, command), "func:", 5) == 0))
+    {
+        return -1;
+    }
+
+    exec_args = hook_process_get_exec_args (hook_process);
+    if (!exec_args)
+        return -1;
+
+    if (posix_spawn_file_actions_init (&file_actions) != 0)
+    {
+        string_free_split (exec_args);
+        return -1;
+    }
+    if (posix_spawnattr_init (&attr) != 0)
+    {
+        posix_spawn_file_actions_destroy (&file_actions);
+        string_free_split (exec_args);
+        return -1;
+    }
+
+    /*
+     * same redirections as in function hook_process_child: stdin/stdout/stderr
+     * are pipes with WeeChat, or "/dev/null" if there is no pipe
+     */
+    fd_std[HOOK_PROCESS_STDIN] = STDIN_FILENO;
+    fd_std[HOOK_PROCESS_STDOUT] = STDOUT_FILENO;
+    fd_std[HOOK_PROCESS_STDERR] = STDERR_FILENO;
+    rc = 0;
+    for (i = 0; i < 3; i++)
+    {
+        if (HOOK_PROCESS(hook_process, child_read[i]) >= 0)
+        {
+            /* close the end of pipe used by WeeChat */
+            rc |= posix_spawn_file_actions_addclose (
+                &file_actions,
+                (i == HOOK_PROCESS_STDIN) ?
+                HOOK_PROCESS(hook_process, child_write[i]) :
+                HOOK_PROCESS(hook_process, child_read[i]));
+            rc |= posix_spawn_file_actions_adddup2 (
+                &file_actions,
+                (i == HOOK_PROCESS_STDIN) ?
+                HOOK_PROCESS(hook_process, child_read[i]) :
+                HOOK_PROCESS(hook_process, child_write[i]),
+                fd_std[i]);
+        }
+        else
+        {
+            rc |= posix_spawn_file_actions_addopen (
+                &file_actions,
+                fd_std[i],
+                "/dev/null",
+                (i == HOOK_PROCESS_STDIN) ? O_RDONLY : O_WRONLY,
+                0);
+        }
+    }
+
+    /* same as setuid (getuid ()) in child after fork() */
+    rc |= posix_spawnattr_setflags (&attr, POSIX_SPAWN_RESETIDS);
+
+    if (rc == 0)
+    {
+        if (posix_spawnp (&pid, exec_args[0], &file_actions, &attr,
+                          exec_args, environ) != 0)
+        {
+            pid = -1;
+        }
+    }
+    else
+    {
+        pid = -1;
+    }
+
+    posix_spawnattr_destroy (&attr);
+    posix_spawn_file_actions_destroy (&file_actions);
+    string_free_split (exec_args);
+
+    return pid;
+}
+#endif /* HAVE_POSIX_SPAWN */
+
 /*
  * Send buffers (stdout/stderr) to callback.
  */
@@ -634,7 +770,8 @@ hook_process_timer_cb (const void *pointer, void *data, int remaining_calls)
 }
 
 /*
- * Execute process command in child, and read data in current process, with fd hook.
+ * Execute process command in child (started with posix_spawnp() if possible,
+ * otherwise with fork()), and read data in current process, with fd hook.
  */
 
 void
@@ -675,12 +812,22 @@ hook_process_run (struct t_hook *hook_process)
         HOOK_PROCESS(hook_process, child_write[i]) = pipes[i][1];
     }
 
+#ifdef HAVE_POSIX_SPAWN
+    /* start command without fork, if possible */
+    pid = hook_process_spawn (hook_process);
+#else
+    pid = -1;
+#endif /* HAVE_POSIX_SPAWN */
+
     /* flush stdout and stderr before forking */
-    fflush (stdout);
-    fflush (stderr);
+    if (pid < 0)
+    {
+        fflush (stdout);
+        fflush (stderr);
+        pid = fork ();
+    }
 
-    /* fork */
-    switch (pid = fork ())
+    switch (pid)
     {
         /* fork failed */
         case -1:
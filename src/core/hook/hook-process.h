@@ -72,6 +72,7 @@ extern struct t_hook *hook_process_hashtable (struct t_weechat_plugin *plugin,
                                               t_hook_callback_process *callback,
                                               const void *callback_pointer,
                                               void *callback_data);
+extern char **hook_process_get_exec_args (struct t_hook *hook_process);
 extern void hook_process_exec (void);
 extern void hook_process_free_data (struct t_hook *hook);
 extern struct t_hdata *hook_process_hdata_hook_process_cb (const void *pointer,
@@ -30,6 +30,8 @@
 
 #include "../weechat.h"
 #include "../core-hook.h"
+#include "../core-arraylist.h"
+#include "../core-hashtable.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
 #include "../core-log.h"
@@ -37,6 +39,14 @@
 #include "../../plugins/plugin.h"
 
 
+/* max number of hooks found in index without allocating memory */
+#define HOOK_SIGNAL_CANDIDATES_STATIC 64
+
+struct t_hashtable *hook_signal_index_exact = NULL; /* masks w/o wildcard   */
+struct t_hook_signal_trie *hook_signal_index_trie = NULL; /* other masks    */
+unsigned long long hook_signal_sequence = 0;  /* order of creation of hooks */
+
+
 /*
  * Return description of hook.
  *
@@ -64,7 +74,7 @@ hook_signal (struct t_weechat_plugin *plugin, const char *signal,
 {
     struct t_hook *new_hook;
     struct t_hook_signal *new_hook_signal;
-    int priority;
+    int i, priority;
     const char *ptr_signal;
 
     if (!signal || !signal[0] || !callback)
@@ -87,6 +97,7 @@ hook_signal (struct t_weechat_plugin *plugin, const char *signal,
 
     new_hook->hook_data = new_hook_signal;
     new_hook_signal->callback = callback;
+    new_hook_signal->sequence = hook_signal_sequence++;
     new_hook_signal->signals = string_split (
         (ptr_signal) ? ptr_signal : signal,
         ";",
@@ -95,6 +106,24 @@ hook_signal (struct t_weechat_plugin *plugin, const char *signal,
         | WEECHAT_STRING_SPLIT_STRIP_RIGHT
         | WEECHAT_STRING_SPLIT_COLLAPSE_SEPS,
         0, &new_hook_signal->num_signals);
+    new_hook_signal->masks = NULL;
+    if (new_hook_signal->num_signals > 0)
+    {
+        new_hook_signal->masks = malloc (
+            new_hook_signal->num_signals * sizeof (*new_hook_signal->masks));
+        if (!new_hook_signal->masks)
+        {
+            string_free_split (new_hook_signal->signals);
+            free (new_hook_signal);
+            free (new_hook);
+            return NULL;
+        }
+        for (i = 0; i < new_hook_signal->num_signals; i++)
+        {
+            new_hook_signal->masks[i] = string_mask_compile (
+                new_hook_signal->signals[i], 0);
+        }
+    }
 
     hook_add_to_list (new_hook);
 
@@ -117,13 +146,540 @@ hook_signal_match (const char *signal, struct t_hook *hook)
 
     for (i = 0; i < HOOK_SIGNAL(hook, num_signals); i++)
     {
-        if (string_match (signal, HOOK_SIGNAL(hook, signals)[i], 0))
+        if (string_mask_match (HOOK_SIGNAL(hook, masks)[i], signal))
             return 1;
     }
 
     return 0;
 }
 
+/*
+ * Compare two signal hooks, using the same order as the list of signal
+ * hooks: by priority (higher priority first), then by order of creation.
+ *
+ * Return:
+ *   < 0: hook1 is before hook2
+ *     0: hook1 == hook2
+ *   > 0: hook1 is after hook2
+ */
+
+int
+hook_signal_cmp_hooks (struct t_hook *hook1, struct t_hook *hook2)
+{
+    if (hook1 == hook2)
+        return 0;
+
+    if (hook1->priority != hook2->priority)
+        return (hook1->priority > hook2->priority) ? -1 : 1;
+
+    return (HOOK_SIGNAL(hook1, sequence) < HOOK_SIGNAL(hook2, sequence)) ?
+        -1 : 1;
+}
+
+/*
+ * Compare two signal hooks in an arraylist of the index.
+ */
+
+int
+hook_signal_index_cmp_cb (void *data, struct t_arraylist *arraylist,
+                          void *pointer1, void *pointer2)
+{
+    /* make C compiler happy */
+    (void) data;
+    (void) arraylist;
+
+    return hook_signal_cmp_hooks ((struct t_hook *)pointer1,
+                                  (struct t_hook *)pointer2);
+}
+
+/*
+ * Compare two candidates found in the index (callback for qsort).
+ */
+
+int
+hook_signal_candidate_cmp_cb (const void *candidate1, const void *candidate2)
+{
+    return hook_signal_cmp_hooks (
+        ((struct t_hook_signal_candidate *)candidate1)->hook,
+        ((struct t_hook_signal_candidate *)candidate2)->hook);
+}
+
+/*
+ * Hash a key in the hashtable of exact masks: keys are compared without
+ * case (ASCII chars only are stored in this hashtable).
+ */
+
+unsigned long long
+hook_signal_index_hash_key_cb (struct t_hashtable *hashtable, const void *key)
+{
+    unsigned long long hash;
+    const char *ptr_key;
+    char chr;
+
+    /* make C compiler happy */
+    (void) hashtable;
+
+    hash = 5381;
+    for (ptr_key = (const char *)key; ptr_key[0]; ptr_key++)
+    {
+        chr = ptr_key[0];
+        if ((chr >= 'A') && (chr <= 'Z'))
+            chr += ('a' - 'A');
+        hash ^= (hash << 5) + (hash >> 2) + (int)chr;
+    }
+
+    return hash;
+}
+
+/*
+ * Compare two keys in the hashtable of exact masks (case-insensitive).
+ */
+
+int
+hook_signal_index_keycmp_cb (struct t_hashtable *hashtable,
+                             const void *key1, const void *key2)
+{
+    /* make C compiler happy */
+    (void) hashtable;
+
+    return string_strcasecmp ((const char *)key1, (const char *)key2);
+}
+
+/*
+ * Create a new arraylist of hooks for the index.
+ *
+ * Return pointer to new arraylist, NULL if error.
+ */
+
+struct t_arraylist *
+hook_signal_index_list_new (void)
+{
+    return arraylist_new (4, 1, 0,
+                          &hook_signal_index_cmp_cb, NULL,
+                          NULL, NULL);
+}
+
+/*
+ * Remove a hook from an arraylist of the index.
+ */
+
+void
+hook_signal_index_list_remove (struct t_arraylist *list, struct t_hook *hook)
+{
+    int index;
+
+    if (!list)
+        return;
+
+    while (1)
+    {
+        (void) arraylist_search (list, hook, &index, NULL);
+        if (index < 0)
+            break;
+        arraylist_remove (list, index);
+    }
+}
+
+/*
+ * Search for a child node in the trie.
+ *
+ * Return pointer to child node, NULL if not found.
+ */
+
+struct t_hook_signal_trie *
+hook_signal_trie_search_child (struct t_hook_signal_trie *node, char chr)
+{
+    struct t_hook_signal_trie *ptr_child;
+
+    for (ptr_child = node->children; ptr_child;
+         ptr_child = ptr_child->next_sibling)
+    {
+        if (ptr_child->chr == chr)
+            return ptr_child;
+    }
+
+    return NULL;
+}
+
+/*
+ * Allocate a new node in the trie (and adds it as child of "parent" if not
+ * NULL).
+ *
+ * Return pointer to new node, NULL if error.
+ */
+
+struct t_hook_signal_trie *
+hook_signal_trie_new (struct t_hook_signal_trie *parent, char chr)
+{
+    struct t_hook_signal_trie *new_node;
+
+    new_node = malloc (sizeof (*new_node));
+    if (!new_node)
+        return NULL;
+
+    new_node->chr = chr;
+    new_node->hooks = NULL;
+    new_node->parent = parent;
+    new_node->children = NULL;
+    new_node->next_sibling = NULL;
+    if (parent)
+    {
+        new_node->next_sibling = parent->children;
+        parent->children = new_node;
+    }
+
+    return new_node;
+}
+
+/*
+ * Free a node of the trie if it has no hooks and no children, then its
+ * parents if they become empty.
+ */
+
+void
+hook_signal_trie_prune (struct t_hook_signal_trie *node)
+{
+    struct t_hook_signal_trie *parent, **ptr_link;
+
+    while (node && !node->children
+           && (!node->hooks || (arraylist_size (node->hooks) == 0)))
+    {
+        parent = node->parent;
+        if (parent)
+        {
+            for (ptr_link = &parent->children; *ptr_link;
+                 ptr_link = &((*ptr_link)->next_sibling))
+            {
+                if (*ptr_link == node)
+                {
+                    *ptr_link = node->next_sibling;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            hook_signal_index_trie = NULL;
+        }
+        arraylist_free (node->hooks);
+        free (node);
+        node = parent;
+    }
+}
+
+/*
+ * Return length of the literal prefix of a mask that can be stored in the
+ * trie: chars before the first wildcard or the first non-ASCII char.
+ */
+
+int
+hook_signal_mask_prefix_length (const char *mask)
+{
+    int length;
+
+    for (length = 0; mask[length]; length++)
+    {
+        if ((mask[length] == '*') || ((unsigned char)mask[length] & 0x80))
+            break;
+    }
+
+    return length;
+}
+
+/*
+ * Return the trie node for a literal prefix of given length (the node is
+ * created if "create" is 1).
+ *
+ * Return pointer to node, NULL if not found or error.
+ */
+
+struct t_hook_signal_trie *
+hook_signal_trie_get_node (const char *prefix, int length, int create)
+{
+    struct t_hook_signal_trie *ptr_node, *ptr_child;
+    char chr;
+    int i;
+
+    if (!hook_signal_index_trie)
+    {
+        if (!create)
+            return NULL;
+        hook_signal_index_trie = hook_signal_trie_new (NULL, '\0');
+        if (!hook_signal_index_trie)
+            return NULL;
+    }
+
+    ptr_node = hook_signal_index_trie;
+    for (i = 0; i < length; i++)
+    {
+        chr = prefix[i];
+        if ((chr >= 'A') && (chr <= 'Z'))
+            chr += ('a' - 'A');
+        ptr_child = hook_signal_trie_search_child (ptr_node, chr);
+        if (!ptr_child)
+        {
+            if (!create)
+                return NULL;
+            ptr_child = hook_signal_trie_new (ptr_node, chr);
+            if (!ptr_child)
+                return NULL;
+        }
+        ptr_node = ptr_child;
+    }
+
+    return ptr_node;
+}
+
+/*
+ * Add a signal hook in the index (callback called when the hook is added
+ * to the list of hooks).
+ */
+
+void
+hook_signal_add_cb (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+    struct t_hook_signal_trie *ptr_node;
+    const char *ptr_mask;
+    int i, length;
+
+    if (!hook || !hook->hook_data)
+        return;
+
+    for (i = 0; i < HOOK_SIGNAL(hook, num_signals); i++)
+    {
+        ptr_mask = HOOK_SIGNAL(hook, signals)[i];
+        length = hook_signal_mask_prefix_length (ptr_mask);
+        if (!ptr_mask[length])
+        {
+            /* mask without wildcard: add it in the hashtable */
+            if (!hook_signal_index_exact)
+            {
+                hook_signal_index_exact = hashtable_new (
+                    32,
+                    WEECHAT_HASHTABLE_STRING,
+                    WEECHAT_HASHTABLE_POINTER,
+                    &hook_signal_index_hash_key_cb,
+                    &hook_signal_index_keycmp_cb);
+                if (!hook_signal_index_exact)
+                    continue;
+            }
+            ptr_list = hashtable_get (hook_signal_index_exact, ptr_mask);
+            if (!ptr_list)
+            {
+                ptr_list = hook_signal_index_list_new ();
+                if (!ptr_list)
+                    continue;
+                hashtable_set (hook_signal_index_exact, ptr_mask, ptr_list);
+            }
+            arraylist_add (ptr_list, hook);
+        }
+        else
+        {
+            /* mask with wildcard or non-ASCII chars: add it in the trie */
+            ptr_node = hook_signal_trie_get_node (ptr_mask, length, 1);
+            if (!ptr_node)
+                continue;
+            if (!ptr_node->hooks)
+            {
+                ptr_node->hooks = hook_signal_index_list_new ();
+                if (!ptr_node->hooks)
+                {
+                    hook_signal_trie_prune (ptr_node);
+                    continue;
+                }
+            }
+            arraylist_add (ptr_node->hooks, hook);
+        }
+    }
+}
+
+/*
+ * Remove a signal hook from the index.
+ */
+
+void
+hook_signal_index_remove (struct t_hook *hook)
+{
+    struct t_arraylist *ptr_list;
+    struct t_hook_signal_trie *ptr_node;
+    const char *ptr_mask;
+    int i, length;
+
+    for (i = 0; i < HOOK_SIGNAL(hook, num_signals); i++)
+    {
+        ptr_mask = HOOK_SIGNAL(hook, signals)[i];
+        length = hook_signal_mask_prefix_length (ptr_mask);
+        if (!ptr_mask[length])
+        {
+            ptr_list = hashtable_get (hook_signal_index_exact, ptr_mask);
+            if (!ptr_list)
+                continue;
+            hook_signal_index_list_remove (ptr_list, hook);
+            if (arraylist_size (ptr_list) == 0)
+            {
+                arraylist_free (ptr_list);
+                hashtable_remove (hook_signal_index_exact, ptr_mask);
+                if (hook_signal_index_exact->items_count == 0)
+                {
+                    hashtable_free (hook_signal_index_exact);
+                    hook_signal_index_exact = NULL;
+                }
+            }
+        }
+        else
+        {
+            ptr_node = hook_signal_trie_get_node (ptr_mask, length, 0);
+            if (!ptr_node)
+                continue;
+            hook_signal_index_list_remove (ptr_node->hooks, hook);
+            hook_signal_trie_prune (ptr_node);
+        }
+    }
+}
+
+/*
+ * Add hooks of an arraylist of the index in the array of candidates
+ * (the array is reallocated on heap if needed).
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+hook_signal_candidates_add (struct t_hook_signal_candidate **candidates,
+                            int *num_candidates, int *size_candidates,
+                            struct t_hook_signal_candidate *static_candidates,
+                            struct t_arraylist *list, int exact)
+{
+    struct t_hook_signal_candidate *new_candidates;
+    int i, size, new_size;
+
+    size = arraylist_size (list);
+    if (size <= 0)
+        return 1;
+
+    if (*num_candidates + size > *size_candidates)
+    {
+        new_size = (*num_candidates + size) * 2;
+        if (*candidates == static_candidates)
+        {
+            new_candidates = malloc (new_size * sizeof (*new_candidates));
+            if (new_candidates)
+            {
+                memcpy (new_candidates, static_candidates,
+                        *num_candidates * sizeof (*new_candidates));
+            }
+        }
+        else
+        {
+            new_candidates = realloc (*candidates,
+                                      new_size * sizeof (*new_candidates));
+        }
+        if (!new_candidates)
+            return 0;
+        *candidates = new_candidates;
+        *size_candidates = new_size;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        (*candidates)[*num_candidates].hook = arraylist_get (list, i);
+        (*candidates)[*num_candidates].exact = exact;
+        (*num_candidates)++;
+    }
+
+    return 1;
+}
+
+/*
+ * Search for hooks that may match a signal in the index: hooks with an exact
+ * mask equal to the signal and hooks with a mask having a literal prefix
+ * matching the beginning of signal.
+ *
+ * The candidates are sorted like the list of signal hooks and each hook is
+ * present only once.
+ *
+ * Return:
+ *   1: OK
+ *   0: error (signal has non-ASCII chars or memory error): the caller must
+ *      fallback on the list of signal hooks
+ */
+
+int
+hook_signal_index_search (const char *signal,
+                          struct t_hook_signal_candidate **candidates,
+                          int *num_candidates, int *size_candidates,
+                          struct t_hook_signal_candidate *static_candidates)
+{
+    struct t_hook_signal_trie *ptr_node;
+    const char *ptr_signal;
+    char chr;
+    int i, j;
+
+    /*
+     * masks are compared without case by string_match, and the index
+     * handles only ASCII chars: use the list of hooks for other signals
+     */
+    for (ptr_signal = signal; ptr_signal[0]; ptr_signal++)
+    {
+        if ((unsigned char)ptr_signal[0] & 0x80)
+            return 0;
+    }
+
+    if (hook_signal_index_exact
+        && !hook_signal_candidates_add (
+            candidates, num_candidates, size_candidates, static_candidates,
+            hashtable_get (hook_signal_index_exact, signal), 1))
+    {
+        return 0;
+    }
+
+    ptr_node = hook_signal_index_trie;
+    ptr_signal = signal;
+    while (ptr_node)
+    {
+        if (!hook_signal_candidates_add (
+                candidates, num_candidates, size_candidates, static_candidates,
+                ptr_node->hooks, 0))
+        {
+            return 0;
+        }
+        if (!ptr_signal[0])
+            break;
+        chr = ptr_signal[0];
+        if ((chr >= 'A') && (chr <= 'Z'))
+            chr += ('a' - 'A');
+        ptr_node = hook_signal_trie_search_child (ptr_node, chr);
+        ptr_signal++;
+    }
+
+    if (*num_candidates > 1)
+    {
+        qsort (*candidates, *num_candidates, sizeof (**candidates),
+               &hook_signal_candidate_cmp_cb);
+        /* merge duplicate hooks (a hook can have multiple masks) */
+        j = 0;
+        for (i = 1; i < *num_candidates; i++)
+        {
+            if ((*candidates)[i].hook == (*candidates)[j].hook)
+            {
+                if ((*candidates)[i].exact)
+                    (*candidates)[j].exact = 1;
+            }
+            else
+            {
+                j++;
+                (*candidates)[j] = (*candidates)[i];
+            }
+        }
+        *num_candidates = j + 1;
+    }
+
+    return 1;
+}
+
 /*
  * Extract flags from signal and return flags and pointer to start of signal.
  */
@@ -176,17 +732,61 @@ hook_signal_extract_flags (const char *signal, const char **ptr_signal,
     free (str_flags);
 }
 
+/*
+ * Execute a signal hook callback.
+ *
+ * Return:
+ *   1: continue with next hooks
+ *   0: stop (signal eaten or error with flag "stop_on_error")
+ */
+
+int
+hook_signal_exec (struct t_hook *hook, const char *signal,
+                  const char *type_data, void *signal_data,
+                  int stop_on_error, int ignore_eat, int *rc)
+{
+    struct t_hook_exec_cb hook_exec_cb;
+
+    hook_callback_start (hook, &hook_exec_cb);
+    *rc = (HOOK_SIGNAL(hook, callback))
+        (hook->callback_pointer,
+         hook->callback_data,
+         signal,
+         type_data,
+         signal_data);
+    hook_callback_end (hook, &hook_exec_cb);
+
+    if (ignore_eat && (*rc == WEECHAT_RC_OK_EAT))
+        *rc = WEECHAT_RC_OK;
+
+    if ((*rc == WEECHAT_RC_OK_EAT)
+        || (stop_on_error && (*rc == WEECHAT_RC_ERROR)))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
 /*
  * Send a signal.
+ *
+ * Hooks matching the signal are searched in the index (see
+ * hook_signal_index_search); if the index can not be used, all signal hooks
+ * are checked with string_match.
+ *
+ * Note: hooks added by a callback while the signal is sent are not called
+ * for this signal.
  */
 
 int
 hook_signal_send (const char *signal, const char *type_data, void *signal_data)
 {
     struct t_hook *ptr_hook, *next_hook;
-    struct t_hook_exec_cb hook_exec_cb;
+    struct t_hook_signal_candidate static_candidates[HOOK_SIGNAL_CANDIDATES_STATIC];
+    struct t_hook_signal_candidate *candidates;
     const char *ptr_signal;
-    int rc, stop_on_error, ignore_eat;
+    int i, rc, stop_on_error, ignore_eat, num_candidates, size_candidates;
 
     rc = WEECHAT_RC_OK;
 
@@ -200,37 +800,56 @@ hook_signal_send (const char *signal, const char *type_data, void *signal_data)
 
     hook_exec_start ();
 
-    ptr_hook = weechat_hooks[HOOK_TYPE_SIGNAL];
-    while (ptr_hook)
-    {
-        next_hook = ptr_hook->next_hook;
+    candidates = static_candidates;
+    num_candidates = 0;
+    size_candidates = HOOK_SIGNAL_CANDIDATES_STATIC;
 
-        if (!ptr_hook->deleted
-            && !ptr_hook->running
-            && hook_signal_match (ptr_signal, ptr_hook))
+    if (hook_signal_index_search (ptr_signal, &candidates, &num_candidates,
+                                  &size_candidates, static_candidates))
+    {
+        for (i = 0; i < num_candidates; i++)
         {
-            hook_callback_start (ptr_hook, &hook_exec_cb);
-            rc = (HOOK_SIGNAL(ptr_hook, callback))
-                (ptr_hook->callback_pointer,
-                 ptr_hook->callback_data,
-                 ptr_signal,
-                 type_data,
-                 signal_data);
-            hook_callback_end (ptr_hook, &hook_exec_cb);
-
-            if (ignore_eat && (rc == WEECHAT_RC_OK_EAT))
-                rc = WEECHAT_RC_OK;
-
-            if ((rc == WEECHAT_RC_OK_EAT)
-                || (stop_on_error && (rc == WEECHAT_RC_ERROR)))
+            ptr_hook = candidates[i].hook;
+            if (!ptr_hook->deleted
+                && !ptr_hook->running
+                && (candidates[i].exact
+                    || hook_signal_match (ptr_signal, ptr_hook)))
             {
-                break;
+                if (!hook_signal_exec (ptr_hook, ptr_signal, type_data,
+                                       signal_data, stop_on_error, ignore_eat,
+                                       &rc))
+                {
+                    break;
+                }
             }
         }
+    }
+    else
+    {
+        ptr_hook = weechat_hooks[HOOK_TYPE_SIGNAL];
+        while (ptr_hook)
+        {
+            next_hook = ptr_hook->next_hook;
+
+            if (!ptr_hook->deleted
+                && !ptr_hook->running
+                && hook_signal_match (ptr_signal, ptr_hook))
+            {
+                if (!hook_signal_exec (ptr_hook, ptr_signal, type_data,
+                                       signal_data, stop_on_error, ignore_eat,
+                                       &rc))
+                {
+                    break;
+                }
+            }
 
-        ptr_hook = next_hook;
+            ptr_hook = next_hook;
+        }
     }
 
+    if (candidates != static_candidates)
+        free (candidates);
+
     hook_exec_end ();
 
     return rc;
@@ -243,14 +862,27 @@ hook_signal_send (const char *signal, const char *type_data, void *signal_data)
 void
 hook_signal_free_data (struct t_hook *hook)
 {
+    int i;
+
     if (!hook || !hook->hook_data)
         return;
 
+    hook_signal_index_remove (hook);
+
     if (HOOK_SIGNAL(hook, signals))
     {
         string_free_split (HOOK_SIGNAL(hook, signals));
         HOOK_SIGNAL(hook, signals) = NULL;
     }
+    if (HOOK_SIGNAL(hook, masks))
+    {
+        for (i = 0; i < HOOK_SIGNAL(hook, num_signals); i++)
+        {
+            string_mask_free (HOOK_SIGNAL(hook, masks)[i]);
+        }
+        free (HOOK_SIGNAL(hook, masks));
+        HOOK_SIGNAL(hook, masks) = NULL;
+    }
     HOOK_SIGNAL(hook, num_signals) = 0;
 
     free (hook->hook_data);
@@ -277,6 +909,7 @@ hook_signal_hdata_hook_signal_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_signal, callback, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_signal, signals, STRING, 0, "*,num_signals", NULL);
         HDATA_VAR(struct t_hook_signal, num_signals, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_signal, masks, POINTER, 0, "*,num_signals", NULL);
     }
     return hdata;
 }
@@ -329,6 +962,7 @@ hook_signal_print_log (struct t_hook *hook)
 
     log_printf ("  signal data:");
     log_printf ("    callback. . . . . . . : %p", HOOK_SIGNAL(hook, callback));
+    log_printf ("    masks . . . . . . . . : %p", HOOK_SIGNAL(hook, masks));
     log_printf ("    signals:");
     for (i = 0; i < HOOK_SIGNAL(hook, num_signals); i++)
     {
@@ -24,6 +24,8 @@
 
 struct t_weechat_plugin;
 struct t_infolist_item;
+struct t_string_mask;
+struct t_arraylist;
 
 #define HOOK_SIGNAL(hook, var) (((struct t_hook_signal *)hook->hook_data)->var)
 
@@ -38,14 +40,58 @@ struct t_hook_signal
                                        /* begin or end with "*",            */
                                        /* "*" == any signal                 */
     int num_signals;                   /* number of signals                 */
+    struct t_string_mask **masks;      /* compiled masks (one by signal)    */
+    unsigned long long sequence;       /* order of creation (used to sort   */
+                                       /* hooks found in the index)         */
 };
 
+/*
+ * Index of signal hooks, used to find quickly the hooks matching a signal
+ * sent, without calling string_match on every signal hook:
+ *   - masks without wildcard (and with only ASCII chars) are stored in a
+ *     hashtable (key: mask, case-insensitive)
+ *   - other masks are stored in a trie, in the node of their literal prefix
+ *     (chars before the first "*" or the first non-ASCII char, converted to
+ *     lower case), and they are checked with string_match on each signal
+ *     sent
+ *
+ * Example of trie with masks "*", "buffer_*", "buffer_line_*", "bar_*":
+ *
+ *   root ["*"]
+ *    `-- b
+ *        |-- a -- r -- _ ["bar_*"]
+ *        `-- u -- f -- f -- e -- r -- _ ["buffer_*"]
+ *                                     `-- l -- i -- n -- e -- _ ["buffer_line_*"]
+ */
+
+struct t_hook_signal_trie
+{
+    char chr;                          /* char (lower case) for this node   */
+    struct t_arraylist *hooks;         /* hooks with a mask starting with   */
+                                       /* the prefix of this node           */
+    struct t_hook_signal_trie *parent; /* parent node (NULL for root)       */
+    struct t_hook_signal_trie *children;     /* first child node            */
+    struct t_hook_signal_trie *next_sibling; /* next node with same parent  */
+};
+
+struct t_hook_signal_candidate
+{
+    struct t_hook *hook;               /* signal hook                       */
+    int exact;                         /* 1 if a mask without wildcard is   */
+                                       /* equal to the signal               */
+};
+
+extern struct t_hashtable *hook_signal_index_exact;
+extern struct t_hook_signal_trie *hook_signal_index_trie;
+
 extern char *hook_signal_get_description (struct t_hook *hook);
 extern struct t_hook *hook_signal (struct t_weechat_plugin *plugin,
                                    const char *signal,
                                    t_hook_callback_signal *callback,
                                    const void *callback_pointer,
                                    void *callback_data);
+extern int hook_signal_match (const char *signal, struct t_hook *hook);
+extern void hook_signal_add_cb (struct t_hook *hook);
 extern void hook_signal_extract_flags (const char *signal,
                                        const char **ptr_signal,
                                        int *stop_on_error,
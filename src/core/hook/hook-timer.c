@@ -27,9 +27,11 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
 
 #include "../weechat.h"
+#include "../core-debug.h"
 #include "../core-hook.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
@@ -39,8 +41,19 @@
 #include "../../plugins/plugin.h"
 
 
+/* max number of timers executed in one call without allocating memory */
+#define HOOK_TIMER_EXEC_STATIC 32
+
+/* difference between system and monotonic clocks considered as clock skew */
+#define HOOK_TIMER_CLOCK_SKEW (10 * 1000000LL)
+
 time_t hook_last_system_time = 0;      /* used to detect system clock skew  */
 
+struct t_hook **hook_timer_heap = NULL; /* timers sorted by next execution  */
+                                        /* (binary min-heap)                */
+int hook_timer_heap_size = 0;          /* number of timers in heap          */
+int hook_timer_heap_alloc = 0;         /* number of timers allocated        */
+
 
 /*
  * Return description of hook.
@@ -79,6 +92,189 @@ hook_timer_get_description (struct t_hook *hook)
     return strdup (str_desc);
 }
 
+/*
+ * Compare next execution of two timers in the heap.
+ *
+ * Return:
+ *   < 0: timer at index1 must be executed before timer at index2
+ *     0: same time for both timers
+ *   > 0: timer at index1 must be executed after timer at index2
+ */
+
+int
+hook_timer_heap_cmp (int index1, int index2)
+{
+    return util_timeval_cmp (
+        &HOOK_TIMER(hook_timer_heap[index1], next_exec_mono),
+        &HOOK_TIMER(hook_timer_heap[index2], next_exec_mono));
+}
+
+/*
+ * Swap two timers in the heap.
+ */
+
+void
+hook_timer_heap_swap (int index1, int index2)
+{
+    struct t_hook *ptr_hook;
+
+    ptr_hook = hook_timer_heap[index1];
+    hook_timer_heap[index1] = hook_timer_heap[index2];
+    hook_timer_heap[index2] = ptr_hook;
+    HOOK_TIMER(hook_timer_heap[index1], heap_index) = index1;
+    HOOK_TIMER(hook_timer_heap[index2], heap_index) = index2;
+}
+
+/*
+ * Move a timer up in the heap, until its parent is executed before it.
+ */
+
+void
+hook_timer_heap_sift_up (int index)
+{
+    int parent;
+
+    while (index > 0)
+    {
+        parent = (index - 1) / 2;
+        if (hook_timer_heap_cmp (parent, index) <= 0)
+            break;
+        hook_timer_heap_swap (parent, index);
+        index = parent;
+    }
+}
+
+/*
+ * Move a timer down in the heap, until its children are executed after it.
+ */
+
+void
+hook_timer_heap_sift_down (int index)
+{
+    int child, smallest;
+
+    while (1)
+    {
+        smallest = index;
+        child = (2 * index) + 1;
+        if ((child < hook_timer_heap_size)
+            && (hook_timer_heap_cmp (child, smallest) < 0))
+        {
+            smallest = child;
+        }
+        child++;
+        if ((child < hook_timer_heap_size)
+            && (hook_timer_heap_cmp (child, smallest) < 0))
+        {
+            smallest = child;
+        }
+        if (smallest == index)
+            break;
+        hook_timer_heap_swap (index, smallest);
+        index = smallest;
+    }
+}
+
+/*
+ * Add a timer in the heap.
+ *
+ * Return:
+ *   1: OK
+ *   0: error (not enough memory)
+ */
+
+int
+hook_timer_heap_add (struct t_hook *hook)
+{
+    struct t_hook **new_heap;
+    int new_alloc;
+
+    if (HOOK_TIMER(hook, heap_index) >= 0)
+        return 1;
+
+    if (hook_timer_heap_size >= hook_timer_heap_alloc)
+    {
+        new_alloc = (hook_timer_heap_alloc < 16) ?
+            16 : hook_timer_heap_alloc * 2;
+        new_heap = realloc (hook_timer_heap,
+                            new_alloc * sizeof (*hook_timer_heap));
+        if (!new_heap)
+            return 0;
+        hook_timer_heap = new_heap;
+        hook_timer_heap_alloc = new_alloc;
+    }
+
+    hook_timer_heap[hook_timer_heap_size] = hook;
+    HOOK_TIMER(hook, heap_index) = hook_timer_heap_size;
+    hook_timer_heap_size++;
+
+    hook_timer_heap_sift_up (hook_timer_heap_size - 1);
+
+    return 1;
+}
+
+/*
+ * Remove a timer from the heap.
+ */
+
+void
+hook_timer_heap_remove (struct t_hook *hook)
+{
+    int index;
+
+    index = HOOK_TIMER(hook, heap_index);
+    if ((index < 0) || (index >= hook_timer_heap_size)
+        || (hook_timer_heap[index] != hook))
+    {
+        return;
+    }
+
+    hook_timer_heap_size--;
+    if (index < hook_timer_heap_size)
+    {
+        hook_timer_heap_swap (index, hook_timer_heap_size);
+        hook_timer_heap_sift_up (index);
+        hook_timer_heap_sift_down (HOOK_TIMER(hook_timer_heap[index], heap_index));
+    }
+    hook_timer_heap[hook_timer_heap_size] = NULL;
+    HOOK_TIMER(hook, heap_index) = -1;
+
+    if (hook_timer_heap_size == 0)
+    {
+        free (hook_timer_heap);
+        hook_timer_heap = NULL;
+        hook_timer_heap_alloc = 0;
+    }
+}
+
+/*
+ * Update position of a timer in the heap (after a change of its next
+ * execution).
+ */
+
+void
+hook_timer_heap_update (struct t_hook *hook)
+{
+    int index;
+
+    index = HOOK_TIMER(hook, heap_index);
+    if ((index < 0) || (index >= hook_timer_heap_size))
+        return;
+
+    hook_timer_heap_sift_up (index);
+    hook_timer_heap_sift_down (HOOK_TIMER(hook, heap_index));
+}
+
+/*
+ * Callback called when a timer hook is added in the list of hooks.
+ */
+
+void
+hook_timer_add_cb (struct t_hook *hook)
+{
+    hook_timer_heap_add (hook);
+}
+
 /*
  * Initialize a timer hook.
  */
@@ -88,9 +284,13 @@ hook_timer_init (struct t_hook *hook)
 {
     time_t time_now;
     struct tm *local_time, gm_time;
+    struct timeval tv_now, tv_mono;
     int local_hour, gm_hour, diff_hour;
+    long long diff;
 
     gettimeofday (&HOOK_TIMER(hook, last_exec), NULL);
+    tv_now = HOOK_TIMER(hook, last_exec);
+    util_timeval_monotonic (&tv_mono);
     time_now = time (NULL);
     local_time = localtime (&time_now);
     local_hour = local_time->tm_hour;
@@ -133,6 +333,19 @@ hook_timer_init (struct t_hook *hook)
     /* add interval to next call date */
     util_timeval_add (&HOOK_TIMER(hook, next_exec),
                       ((long long)HOOK_TIMER(hook, interval)) * 1000);
+
+    /* same date of next call, with the monotonic clock */
+    diff = util_timeval_diff (&tv_now, &HOOK_TIMER(hook, next_exec));
+    diff += (((long long)tv_mono.tv_sec) * 1000000) + tv_mono.tv_usec;
+    HOOK_TIMER(hook, next_exec_mono).tv_sec = diff / 1000000;
+    HOOK_TIMER(hook, next_exec_mono).tv_usec = diff % 1000000;
+    if (HOOK_TIMER(hook, next_exec_mono).tv_usec < 0)
+    {
+        HOOK_TIMER(hook, next_exec_mono).tv_sec--;
+        HOOK_TIMER(hook, next_exec_mono).tv_usec += 1000000;
+    }
+
+    hook_timer_heap_update (hook);
 }
 
 /*
@@ -171,11 +384,19 @@ hook_timer (struct t_weechat_plugin *plugin, long interval, int align_second,
     new_hook_timer->interval = interval;
     new_hook_timer->align_second = align_second;
     new_hook_timer->remaining_calls = max_calls;
+    new_hook_timer->heap_index = -1;
 
     hook_timer_init (new_hook);
 
     hook_add_to_list (new_hook);
 
+    /* timer not in heap (not enough memory): it would never be executed */
+    if (new_hook_timer->heap_index < 0)
+    {
+        unhook (new_hook);
+        return NULL;
+    }
+
     return new_hook;
 }
 
@@ -183,6 +404,9 @@ hook_timer (struct t_weechat_plugin *plugin, long interval, int align_second,
  * Check if system clock is older than previous call to this function (that
  * means new time is lower than in past). If yes, adjust all timers to current
  * time.
+ *
+ * This is used only if the monotonic clock is not available: otherwise the
+ * clock skew is detected for each timer executed (see hook_timer_exec).
  */
 
 void
@@ -228,135 +452,208 @@ hook_timer_check_system_clock (void)
 int
 hook_timer_get_time_to_next (void)
 {
-    struct t_hook *ptr_hook;
-    int found, timeout;
-    struct timeval tv_now, tv_timeout;
-    long diff_usec;
+    struct timeval tv_now;
+    long long diff;
 
+#ifndef HAVE_CLOCK_MONOTONIC
     hook_timer_check_system_clock ();
-
-    found = 0;
-    tv_timeout.tv_sec = 0;
-    tv_timeout.tv_usec = 0;
-
-    for (ptr_hook = weechat_hooks[HOOK_TYPE_TIMER]; ptr_hook;
-         ptr_hook = ptr_hook->next_hook)
-    {
-        if (!ptr_hook->deleted
-            && (!found
-                || (util_timeval_cmp (&HOOK_TIMER(ptr_hook, next_exec),
-                                      &tv_timeout) < 0)))
-        {
-            found = 1;
-            tv_timeout.tv_sec = HOOK_TIMER(ptr_hook, next_exec).tv_sec;
-            tv_timeout.tv_usec = HOOK_TIMER(ptr_hook, next_exec).tv_usec;
-        }
-    }
+#endif /* HAVE_CLOCK_MONOTONIC */
 
     /* no timeout found, return 2 seconds by default */
-    if (!found)
-    {
-        tv_timeout.tv_sec = 2;
-        tv_timeout.tv_usec = 0;
-        goto end;
-    }
+    if (hook_timer_heap_size == 0)
+        return 2000;
 
-    gettimeofday (&tv_now, NULL);
+    util_timeval_monotonic (&tv_now);
 
-    /* next timeout is past date! */
-    if (util_timeval_cmp (&tv_timeout, &tv_now) < 0)
-    {
-        tv_timeout.tv_sec = 0;
-        tv_timeout.tv_usec = 0;
-        goto end;
-    }
-
-    tv_timeout.tv_sec = tv_timeout.tv_sec - tv_now.tv_sec;
-    diff_usec = tv_timeout.tv_usec - tv_now.tv_usec;
-    if (diff_usec >= 0)
-    {
-        tv_timeout.tv_usec = diff_usec;
-    }
-    else
-    {
-        tv_timeout.tv_sec--;
-        tv_timeout.tv_usec = 1000000 + diff_usec;
-    }
+    /* time until next timeout (next timeout may be a past date) */
+    diff = util_timeval_diff (
+        &tv_now, &HOOK_TIMER(hook_timer_heap[0], next_exec_mono)) / 1000;
 
+#ifndef HAVE_CLOCK_MONOTONIC
     /*
      * to detect clock skew, we ensure there's a call to timers every
      * 2 seconds max
      */
-    if (tv_timeout.tv_sec >= 2)
-    {
-        tv_timeout.tv_sec = 2;
-        tv_timeout.tv_usec = 0;
-    }
+    if (diff > 2000)
+        diff = 2000;
+#endif /* HAVE_CLOCK_MONOTONIC */
+
+    if (diff > INT_MAX)
+        diff = INT_MAX;
 
-end:
-    /* return a number of milliseconds */
-    timeout = (tv_timeout.tv_sec * 1000) + (tv_timeout.tv_usec / 1000);
-    return (timeout < 1) ? 1 : timeout;
+    return (diff < 1) ? 1 : (int)diff;
+}
+
+/*
+ * Display an error and remove a timer that can not be added again in the
+ * heap (not enough memory): it would never be executed.
+ */
+
+void
+hook_timer_heap_add_error (struct t_hook *hook)
+{
+    gui_chat_printf (NULL,
+                     _("%sNot enough memory (%s)"),
+                     gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
+                     "hook_timer");
+    unhook (hook);
 }
 
 /*
  * Execute timer hooks.
+ *
+ * Timers to execute are removed from the heap before calling callbacks, and
+ * added again after their execution (with the new date of next execution),
+ * so that each timer is executed at most once per call to this function.
  */
 
 void
 hook_timer_exec (void)
 {
-    struct t_hook *ptr_hook, *next_hook;
+    struct t_hook *static_timers[HOOK_TIMER_EXEC_STATIC];
+    struct t_hook **timers, **new_timers, *ptr_hook;
     struct t_hook_exec_cb hook_exec_cb;
-    struct timeval tv_time;
+    struct timeval tv_time, tv_mono, tv_exec_mono;
+    int i, num_timers, size_timers, clock_skew;
 
-    if (!weechat_hooks[HOOK_TYPE_TIMER])
+    if (hook_timer_heap_size == 0)
         return;
 
+#ifndef HAVE_CLOCK_MONOTONIC
     hook_timer_check_system_clock ();
+#endif /* HAVE_CLOCK_MONOTONIC */
+
+    util_timeval_monotonic (&tv_mono);
+
+    /* nothing to do if the first timer is in future */
+    if (util_timeval_cmp (&HOOK_TIMER(hook_timer_heap[0], next_exec_mono),
+                          &tv_mono) > 0)
+    {
+        return;
+    }
 
     gettimeofday (&tv_time, NULL);
 
+    /* remove timers to execute from heap */
+    timers = static_timers;
+    num_timers = 0;
+    size_timers = HOOK_TIMER_EXEC_STATIC;
+    while ((hook_timer_heap_size > 0)
+           && (util_timeval_cmp (
+                   &HOOK_TIMER(hook_timer_heap[0], next_exec_mono),
+                   &tv_mono) <= 0))
+    {
+        if (num_timers >= size_timers)
+        {
+            if (timers == static_timers)
+            {
+                new_timers = malloc (size_timers * 2 * sizeof (*new_timers));
+                if (new_timers)
+                    memcpy (new_timers, timers, num_timers * sizeof (*timers));
+            }
+            else
+            {
+                new_timers = realloc (timers,
+                                      size_timers * 2 * sizeof (*new_timers));
+            }
+            if (!new_timers)
+                break;
+            timers = new_timers;
+            size_timers *= 2;
+        }
+        ptr_hook = hook_timer_heap[0];
+        hook_timer_heap_remove (ptr_hook);
+        timers[num_timers++] = ptr_hook;
+    }
+
     hook_exec_start ();
 
-    ptr_hook = weechat_hooks[HOOK_TYPE_TIMER];
-    while (ptr_hook)
+    for (i = 0; i < num_timers; i++)
     {
-        next_hook = ptr_hook->next_hook;
+        ptr_hook = timers[i];
+
+        if (ptr_hook->deleted)
+            continue;
 
-        if (!ptr_hook->deleted
-            && !ptr_hook->running
-            && (util_timeval_cmp (&HOOK_TIMER(ptr_hook, next_exec),
-                                  &tv_time) <= 0))
+        if (ptr_hook->running)
         {
-            hook_callback_start (ptr_hook, &hook_exec_cb);
-            (void) (HOOK_TIMER(ptr_hook, callback))
-                (ptr_hook->callback_pointer,
-                 ptr_hook->callback_data,
-                 (HOOK_TIMER(ptr_hook, remaining_calls) > 0) ?
-                  HOOK_TIMER(ptr_hook, remaining_calls) - 1 : -1);
-            hook_callback_end (ptr_hook, &hook_exec_cb);
-            if (!ptr_hook->deleted)
+            if (!hook_timer_heap_add (ptr_hook))
+                hook_timer_heap_add_error (ptr_hook);
+            continue;
+        }
+
+        /*
+         * the system clock has changed if the delay since the scheduled
+         * date is not the same with the system and the monotonic clocks
+         */
+        clock_skew = (llabs (
+                          util_timeval_diff (&HOOK_TIMER(ptr_hook, next_exec),
+                                             &tv_time)
+                          - util_timeval_diff (&HOOK_TIMER(ptr_hook, next_exec_mono),
+                                               &tv_mono)) >= HOOK_TIMER_CLOCK_SKEW);
+
+        if (DEBUG_LOOP_ACTIVE)
+        {
+            /*
+             * read the clock again: callbacks of timers executed before this
+             * one may have taken some time
+             */
+            util_timeval_monotonic (&tv_exec_mono);
+            debug_loop_add_timer_lateness (
+                util_timeval_diff (&HOOK_TIMER(ptr_hook, next_exec_mono),
+                                   &tv_exec_mono));
+        }
+
+        hook_callback_start (ptr_hook, &hook_exec_cb);
+        (void) (HOOK_TIMER(ptr_hook, callback))
+            (ptr_hook->callback_pointer,
+             ptr_hook->callback_data,
+             (HOOK_TIMER(ptr_hook, remaining_calls) > 0) ?
+             HOOK_TIMER(ptr_hook, remaining_calls) - 1 : -1);
+        hook_callback_end (ptr_hook, &hook_exec_cb);
+
+        if (ptr_hook->deleted)
+            continue;
+
+        if (clock_skew)
+        {
+            if (weechat_debug_core >= 1)
             {
-                HOOK_TIMER(ptr_hook, last_exec).tv_sec = tv_time.tv_sec;
-                HOOK_TIMER(ptr_hook, last_exec).tv_usec = tv_time.tv_usec;
-
-                util_timeval_add (
-                    &HOOK_TIMER(ptr_hook, next_exec),
-                    ((long long)HOOK_TIMER(ptr_hook, interval)) * 1000);
-
-                if (HOOK_TIMER(ptr_hook, remaining_calls) > 0)
-                {
-                    HOOK_TIMER(ptr_hook, remaining_calls)--;
-                    if (HOOK_TIMER(ptr_hook, remaining_calls) == 0)
-                        unhook (ptr_hook);
-                }
+                gui_chat_printf (NULL,
+                                 _("System clock skew detected, "
+                                   "reinitializing timer"));
             }
+            hook_timer_init (ptr_hook);
+        }
+        else
+        {
+            util_timeval_add (
+                &HOOK_TIMER(ptr_hook, next_exec),
+                ((long long)HOOK_TIMER(ptr_hook, interval)) * 1000);
+            util_timeval_add (
+                &HOOK_TIMER(ptr_hook, next_exec_mono),
+                ((long long)HOOK_TIMER(ptr_hook, interval)) * 1000);
+        }
+        HOOK_TIMER(ptr_hook, last_exec).tv_sec = tv_time.tv_sec;
+        HOOK_TIMER(ptr_hook, last_exec).tv_usec = tv_time.tv_usec;
+
+        if (!hook_timer_heap_add (ptr_hook))
+        {
+            hook_timer_heap_add_error (ptr_hook);
+            continue;
         }
 
-        ptr_hook = next_hook;
+        if (HOOK_TIMER(ptr_hook, remaining_calls) > 0)
+        {
+            HOOK_TIMER(ptr_hook, remaining_calls)--;
+            if (HOOK_TIMER(ptr_hook, remaining_calls) == 0)
+                unhook (ptr_hook);
+        }
     }
 
+    if (timers != static_timers)
+        free (timers);
+
     hook_exec_end ();
 }
 
@@ -370,6 +667,8 @@ hook_timer_free_data (struct t_hook *hook)
     if (!hook || !hook->hook_data)
         return;
 
+    hook_timer_heap_remove (hook);
+
     free (hook->hook_data);
     hook->hook_data = NULL;
 }
@@ -472,4 +771,8 @@ hook_timer_print_log (struct t_hook *hook)
                 (long long)(HOOK_TIMER(hook, next_exec.tv_sec)));
     log_printf ("      tv_usec. . . .  . . : %ld",
                 (long)(HOOK_TIMER(hook, next_exec.tv_usec)));
+    log_printf ("    next_exec_mono. . . . : %lld.%06ld",
+                (long long)(HOOK_TIMER(hook, next_exec_mono.tv_sec)),
+                (long)(HOOK_TIMER(hook, next_exec_mono.tv_usec)));
+    log_printf ("    heap_index. . . . . . : %d", HOOK_TIMER(hook, heap_index));
 }
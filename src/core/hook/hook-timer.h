@@ -42,9 +42,15 @@ struct t_hook_timer
     int remaining_calls;               /* calls remaining (0 = unlimited)   */
     struct timeval last_exec;          /* last time hook was executed       */
     struct timeval next_exec;          /* next scheduled execution          */
+    struct timeval next_exec_mono;     /* next scheduled execution, with    */
+                                       /* monotonic clock (to sort timers)  */
+    int heap_index;                    /* index in heap of timers           */
+                                       /* (-1 if not in heap)               */
 };
 
 extern time_t hook_last_system_time;
+extern struct t_hook **hook_timer_heap;
+extern int hook_timer_heap_size;
 
 extern char *hook_timer_get_description (struct t_hook *hook);
 extern struct t_hook *hook_timer (struct t_weechat_plugin *plugin,
@@ -53,6 +59,8 @@ extern struct t_hook *hook_timer (struct t_weechat_plugin *plugin,
                                   t_hook_callback_timer *callback,
                                   const void *callback_pointer,
                                   void *callback_data);
+extern void hook_timer_heap_update (struct t_hook *hook);
+extern void hook_timer_add_cb (struct t_hook *hook);
 extern int hook_timer_get_time_to_next (void);
 extern void hook_timer_exec (void);
 extern void hook_timer_free_data (struct t_hook *hook);
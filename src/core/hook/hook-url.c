@@ -32,10 +32,11 @@
 #include <poll.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <pthread.h>
+#include <curl/curl.h>
 
 #include "../weechat.h"
 #include "../core-hook.h"
+#include "../core-config.h"
 #include "../core-hashtable.h"
 #include "../core-hdata.h"
 #include "../core-infolist.h"
@@ -46,6 +47,10 @@
 #include "../../plugins/plugin.h"
 
 
+CURLM *hook_url_multi = NULL;          /* multi handle for all transfers    */
+struct t_hook *hook_url_multi_timer = NULL; /* timer requested by curl      */
+
+
 /*
  * Return description of hook.
  *
@@ -58,9 +63,9 @@ hook_url_get_description (struct t_hook *hook)
     char str_desc[1024];
 
     snprintf (str_desc, sizeof (str_desc),
-              "URL: \"%s\", thread id: %d",
+              "URL: \"%s\", transfer: %s",
               HOOK_URL(hook, url),
-              0);
+              (HOOK_URL(hook, transfer)) ? "running" : "-");
 
     return strdup (str_desc);
 }
@@ -108,53 +113,231 @@ hook_url_run_callback (struct t_hook *hook)
 }
 
 /*
- * Thread cleanup function: mark thread as not running anymore.
+ * Remove the transfer of an URL hook from the multi handle and free it
+ * (output hashtable of hook is completed).
  */
 
 void
-hook_url_thread_cleanup (void *hook_pointer)
+hook_url_transfer_remove (struct t_hook *hook)
 {
-    struct t_hook *hook;
+    if (!HOOK_URL(hook, transfer))
+        return;
 
-    hook = (struct t_hook *)hook_pointer;
+    if (HOOK_URL(hook, transfer)->curl)
+        curl_multi_remove_handle (hook_url_multi, HOOK_URL(hook, transfer)->curl);
+    weeurl_transfer_free (HOOK_URL(hook, transfer));
+    free (HOOK_URL(hook, transfer));
+    HOOK_URL(hook, transfer) = NULL;
+}
 
-    HOOK_URL(hook, thread_running) = 0;
+/*
+ * Check transfers done in the multi handle: for each transfer done, the
+ * callback of the URL hook is called and the hook is removed.
+ */
+
+void
+hook_url_multi_check_done (void)
+{
+    CURLMsg *msg;
+    CURL *easy;
+    struct t_hook *ptr_hook;
+    const char *ptr_error;
+    int msgs_left;
+
+    while ((msg = curl_multi_info_read (hook_url_multi, &msgs_left)))
+    {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+
+        easy = msg->easy_handle;
+        ptr_hook = NULL;
+        curl_easy_getinfo (easy, CURLINFO_PRIVATE, (char **)&ptr_hook);
+        if (!ptr_hook || ptr_hook->deleted || !HOOK_URL(ptr_hook, transfer))
+        {
+            curl_multi_remove_handle (hook_url_multi, easy);
+            continue;
+        }
+
+        weeurl_transfer_done (HOOK_URL(ptr_hook, transfer));
+        hook_url_transfer_remove (ptr_hook);
+        hook_url_run_callback (ptr_hook);
+        ptr_error = hashtable_get (HOOK_URL(ptr_hook, output), "error");
+        if ((weechat_debug_core >= 1) && ptr_error && ptr_error[0])
+        {
+            gui_chat_printf (
+                NULL,
+                _("%sURL transfer error: %s (URL: \"%s\")"),
+                gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
+                ptr_error,
+                HOOK_URL(ptr_hook, url));
+        }
+        unhook (ptr_hook);
+    }
 }
 
 /*
- * URL transfer (in a separate thread).
+ * Callback for fd hook of a socket used by curl.
  */
 
-void *
-hook_url_transfer_thread (void *hook_pointer)
+int
+hook_url_multi_fd_cb (const void *pointer, void *data, int fd)
 {
-    struct t_hook *hook;
-    int url_rc;
-    char str_error_code[12];
+    int running;
+
+    /* make C compiler happy */
+    (void) pointer;
+    (void) data;
+
+    curl_multi_socket_action (hook_url_multi, fd, 0, &running);
+    hook_url_multi_check_done ();
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Callback for the timer requested by curl.
+ */
+
+int
+hook_url_multi_timer_cb (const void *pointer, void *data, int remaining_calls)
+{
+    int running;
 
-    hook = (struct t_hook *)hook_pointer;
+    /* make C compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) remaining_calls;
 
-    pthread_cleanup_push (&hook_url_thread_cleanup, hook);
+    /* the timer is removed after this call (max calls = 1) */
+    hook_url_multi_timer = NULL;
 
-    url_rc = weeurl_download (HOOK_URL(hook, url),
-                              HOOK_URL(hook, options),
-                              HOOK_URL(hook, timeout),
-                              HOOK_URL(hook, output),
-                              &(HOOK_URL(hook, stop_transfer)));
+    if (!hook_url_multi)
+        return WEECHAT_RC_OK;
 
-    if (url_rc != 0)
+    curl_multi_socket_action (hook_url_multi, CURL_SOCKET_TIMEOUT, 0,
+                              &running);
+    hook_url_multi_check_done ();
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Callback called by curl to add/change/remove the watch of a socket:
+ * a fd hook is created for each socket used by transfers.
+ */
+
+int
+hook_url_multi_socket_cb (CURL *easy, curl_socket_t sock, int what,
+                          void *userp, void *socketp)
+{
+    struct t_hook *ptr_hook_fd;
+    int flags;
+
+    /* make C compiler happy */
+    (void) easy;
+    (void) userp;
+
+    ptr_hook_fd = (struct t_hook *)socketp;
+
+    if (what == CURL_POLL_REMOVE)
     {
-        snprintf (str_error_code, sizeof (str_error_code), "%d", url_rc);
-        hashtable_set (HOOK_URL(hook, output), "error_code", str_error_code);
+        if (ptr_hook_fd)
+        {
+            unhook (ptr_hook_fd);
+            curl_multi_assign (hook_url_multi, sock, NULL);
+        }
+        return 0;
     }
 
-    pthread_cleanup_pop (1);
+    flags = 0;
+    if (what & CURL_POLL_IN)
+        flags |= HOOK_FD_FLAG_READ;
+    if (what & CURL_POLL_OUT)
+        flags |= HOOK_FD_FLAG_WRITE;
 
-    pthread_exit (NULL);
+    if (ptr_hook_fd)
+    {
+        hook_fd_set_flags (ptr_hook_fd, flags);
+    }
+    else
+    {
+        ptr_hook_fd = hook_fd (NULL, sock,
+                               (flags & HOOK_FD_FLAG_READ) ? 1 : 0,
+                               (flags & HOOK_FD_FLAG_WRITE) ? 1 : 0,
+                               0,
+                               &hook_url_multi_fd_cb, NULL, NULL);
+        curl_multi_assign (hook_url_multi, sock, ptr_hook_fd);
+    }
+
+    return 0;
 }
 
 /*
- * Check if thread is still alive.
+ * Callback called by curl to set the timer: the timer is a one-shot timer
+ * hook (or no timer at all if timeout is -1).
+ */
+
+int
+hook_url_multi_timer_set_cb (CURLM *multi, long timeout_ms, void *userp)
+{
+    /* make C compiler happy */
+    (void) multi;
+    (void) userp;
+
+    if (hook_url_multi_timer)
+    {
+        unhook (hook_url_multi_timer);
+        hook_url_multi_timer = NULL;
+    }
+
+    if (timeout_ms >= 0)
+    {
+        /*
+         * curl must not be called from this callback, so even a timeout
+         * of 0 is handled in the timer (executed in the next main loop)
+         */
+        hook_url_multi_timer = hook_timer (NULL,
+                                           (timeout_ms > 0) ? timeout_ms : 1,
+                                           0, 1,
+                                           &hook_url_multi_timer_cb,
+                                           NULL, NULL);
+    }
+
+    return 0;
+}
+
+/*
+ * Check if the curl multi handle is initialized, and initialize it if needed.
+ *
+ * Return:
+ *   1: multi handle OK
+ *   0: error
+ */
+
+int
+hook_url_multi_init (void)
+{
+    if (hook_url_multi)
+        return 1;
+
+    hook_url_multi = curl_multi_init ();
+    if (!hook_url_multi)
+        return 0;
+
+    curl_multi_setopt (hook_url_multi, CURLMOPT_SOCKETFUNCTION,
+                       &hook_url_multi_socket_cb);
+    curl_multi_setopt (hook_url_multi, CURLMOPT_TIMERFUNCTION,
+                       &hook_url_multi_timer_set_cb);
+
+    return 1;
+}
+
+/*
+ * Callback for timeout of an URL transfer.
+ *
+ * This timer is also used to run the callback of a transfer which could not
+ * be started (then transfer is NULL and the error is already set in output),
+ * so that the callback is never called by function hook_url itself.
  */
 
 int
@@ -170,11 +353,15 @@ hook_url_timer_cb (const void *pointer, void *data, int remaining_calls)
 
     hook = (struct t_hook *)pointer;
 
+    /* the timer is removed after this call (max calls = 1) */
+    HOOK_URL(hook, hook_timer) = NULL;
+
     if (hook->deleted)
         return WEECHAT_RC_OK;
 
-    if (!HOOK_URL(hook, thread_running))
+    if (!HOOK_URL(hook, transfer))
     {
+        /* transfer not started (error) */
         hook_url_run_callback (hook);
         ptr_error = hashtable_get (HOOK_URL(hook, output), "error");
         if ((weechat_debug_core >= 1) && ptr_error && ptr_error[0])
@@ -190,96 +377,102 @@ hook_url_timer_cb (const void *pointer, void *data, int remaining_calls)
         return WEECHAT_RC_OK;
     }
 
-    if (remaining_calls == 0)
+    hook_url_transfer_remove (hook);
+
+    if (!hashtable_has_key (HOOK_URL(hook, output), "error_code"))
     {
-        if (!hashtable_has_key (HOOK_URL(hook, output), "error_code"))
-        {
-            snprintf (str_error, sizeof (str_error),
-                      URL_ERROR_TIMEOUT " (%.3fs)",
-                      ((float)HOOK_URL(hook, timeout)) / 1000);
-            hashtable_set (HOOK_URL(hook, output), "error", str_error);
-            hashtable_set (HOOK_URL(hook, output), "error_code", "6");
-        }
-        hook_url_run_callback (hook);
-        if (weechat_debug_core >= 1)
-        {
-            gui_chat_printf (
-                NULL,
-                _("End of URL transfer '%s', timeout reached (%.3fs)"),
-                HOOK_URL(hook, url),
-                ((float)HOOK_URL(hook, timeout)) / 1000);
-        }
-        pthread_cancel (HOOK_URL(hook, thread_id));
-        usleep (1000);
-        unhook (hook);
+        snprintf (str_error, sizeof (str_error),
+                  URL_ERROR_TIMEOUT " (%.3fs)",
+                  ((float)HOOK_URL(hook, timeout)) / 1000);
+        hashtable_set (HOOK_URL(hook, output), "error", str_error);
+        hashtable_set (HOOK_URL(hook, output), "error_code", "6");
     }
+    hook_url_run_callback (hook);
+    if (weechat_debug_core >= 1)
+    {
+        gui_chat_printf (
+            NULL,
+            _("End of URL transfer '%s', timeout reached (%.3fs)"),
+            HOOK_URL(hook, url),
+            ((float)HOOK_URL(hook, timeout)) / 1000);
+    }
+    unhook (hook);
 
     return WEECHAT_RC_OK;
 }
 
 /*
- * Start transfer for an URL hook.
+ * Start transfer for an URL hook: the transfer is added in the curl multi
+ * handle, which is driven by the fd hooks and timer of WeeChat main loop.
  */
 
 void
 hook_url_transfer (struct t_hook *hook)
 {
-    int rc, timeout, max_calls;
-    long interval;
-    char str_error[1024], str_error_code_pthread[12];
+    struct t_url_transfer *transfer;
+    CURLMcode curl_mc;
+    int rc;
+    char str_error_code[12];
+
+    if (!hook_url_multi_init ())
+    {
+        hashtable_set (HOOK_URL(hook, output), "error", _("not enough memory"));
+        hashtable_set (HOOK_URL(hook, output), "error_code", "3");
+        goto error;
+    }
 
-    HOOK_URL(hook, thread_running) = 1;
+    transfer = malloc (sizeof (*transfer));
+    if (!transfer)
+    {
+        hashtable_set (HOOK_URL(hook, output), "error", _("not enough memory"));
+        hashtable_set (HOOK_URL(hook, output), "error_code", "3");
+        goto error;
+    }
 
-    /* create thread */
-    rc = pthread_create (&(HOOK_URL(hook, thread_id)), NULL,
-                         &hook_url_transfer_thread, hook);
+    rc = weeurl_transfer_init (transfer, HOOK_URL(hook, url),
+                               HOOK_URL(hook, options),
+                               HOOK_URL(hook, output));
+    HOOK_URL(hook, transfer) = transfer;
     if (rc != 0)
     {
-        snprintf (str_error, sizeof (str_error),
-                  "error calling pthread_create (%d)", rc);
-        snprintf (str_error_code_pthread, sizeof (str_error_code_pthread),
-                  "%d", rc);
-        hashtable_set (HOOK_URL(hook, output), "error", str_error);
-        hashtable_set (HOOK_URL(hook, output), "error_code", "100");
-        hashtable_set (HOOK_URL(hook, output), "error_code_pthread",
-                       str_error_code_pthread);
-        hook_url_run_callback (hook);
+        snprintf (str_error_code, sizeof (str_error_code), "%d", rc);
+        hashtable_set (HOOK_URL(hook, output), "error_code", str_error_code);
+        goto error;
+    }
 
-        if (weechat_debug_core >= 1)
-        {
-            gui_chat_printf (NULL,
-                             _("%sError running thread in hook_url: %s (URL: \"%s\")"),
-                             gui_chat_prefix[GUI_CHAT_PREFIX_ERROR],
-                             strerror (rc),
-                             HOOK_URL(hook, url));
-        }
-        unhook (hook);
-        return;
+    curl_easy_setopt (transfer->curl, CURLOPT_PRIVATE, hook);
+
+    /* max connections per host (reused by next transfers, keep-alive) */
+    curl_multi_setopt (
+        hook_url_multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+        (long)CONFIG_INTEGER(config_network_url_max_host_connections));
+
+    curl_mc = curl_multi_add_handle (hook_url_multi, transfer->curl);
+    if (curl_mc != CURLM_OK)
+    {
+        snprintf (transfer->error_code, sizeof (transfer->error_code),
+                  "%d", curl_mc);
+        snprintf (transfer->error, sizeof (transfer->error),
+                  "%s", _("transfer error"));
+        hashtable_set (HOOK_URL(hook, output), "error_code", "2");
+        goto error;
     }
 
-    /* main thread */
-    HOOK_URL(hook, thread_created) = 1;
-    timeout = HOOK_URL(hook, timeout);
-    interval = 100;
-    max_calls = 0;
-    if (timeout > 0)
+    if (HOOK_URL(hook, timeout) > 0)
     {
-        if (timeout <= 100)
-        {
-            interval = timeout + 50;
-            max_calls = 1;
-        }
-        else
-        {
-            interval = 100;
-            max_calls = timeout / 100;
-            if (timeout % 100 == 0)
-                max_calls++;
-            max_calls++;
-        }
+        HOOK_URL(hook, hook_timer) = hook_timer (hook->plugin,
+                                                 HOOK_URL(hook, timeout),
+                                                 0, 1,
+                                                 &hook_url_timer_cb,
+                                                 hook,
+                                                 NULL);
     }
-    HOOK_URL(hook, hook_timer) = hook_timer (hook->plugin,
-                                             interval, 0, max_calls,
+    return;
+
+error:
+    /* callback is called in the next main loop (see hook_url_timer_cb) */
+    hook_url_transfer_remove (hook);
+    HOOK_URL(hook, hook_timer) = hook_timer (hook->plugin, 1, 0, 1,
                                              &hook_url_timer_cb,
                                              hook,
                                              NULL);
@@ -325,10 +518,7 @@ hook_url (struct t_weechat_plugin *plugin,
     new_hook_url->url = strdup (url);
     new_hook_url->options = (options) ? hashtable_dup (options) : NULL;
     new_hook_url->timeout = timeout;
-    new_hook_url->stop_transfer = 0;
-    new_hook_url->thread_id = 0;
-    new_hook_url->thread_created = 0;
-    new_hook_url->thread_running = 0;
+    new_hook_url->transfer = NULL;
     new_hook_url->hook_timer = NULL;
     new_hook_url->output = hashtable_new (32,
                                           WEECHAT_HASHTABLE_STRING,
@@ -364,16 +554,13 @@ error:
 void
 hook_url_free_data (struct t_hook *hook)
 {
-    void *retval;
-
     if (!hook || !hook->hook_data)
         return;
 
     /* stop transfer if it's still active */
-    if (HOOK_URL(hook, thread_created) && HOOK_URL(hook, thread_running))
+    if (HOOK_URL(hook, transfer))
     {
-        HOOK_URL(hook, stop_transfer) = 1;
-        usleep (10000);
+        hook_url_transfer_remove (hook);
         if (!hashtable_has_key (HOOK_URL(hook, output), "error_code"))
         {
             hashtable_set (HOOK_URL(hook, output), "error", "transfer stopped");
@@ -404,13 +591,6 @@ hook_url_free_data (struct t_hook *hook)
         unhook (HOOK_URL(hook, hook_timer));
         HOOK_URL(hook, hook_timer) = NULL;
     }
-    if (HOOK_URL(hook, thread_running))
-    {
-        pthread_cancel (HOOK_URL(hook, thread_id));
-        HOOK_URL(hook, thread_running) = 0;
-    }
-    if (HOOK_URL(hook, thread_created))
-        pthread_join (HOOK_URL(hook, thread_id), &retval);
     if (HOOK_URL(hook, output))
     {
         hashtable_free (HOOK_URL(hook, output));
@@ -442,9 +622,7 @@ hook_url_hdata_hook_url_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_hook_url, url, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_url, options, HASHTABLE, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_url, timeout, LONG, 0, NULL, NULL);
-        HDATA_VAR(struct t_hook_url, thread_id, LONG, 0, NULL, NULL);
-        HDATA_VAR(struct t_hook_url, thread_created, INTEGER, 0, NULL, NULL);
-        HDATA_VAR(struct t_hook_url, thread_running, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_hook_url, transfer, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_hook_url, hook_timer, POINTER, 0, NULL, "hook");
         HDATA_VAR(struct t_hook_url, output, HASHTABLE, 0, NULL, NULL);
     }
@@ -474,11 +652,7 @@ hook_url_add_to_infolist (struct t_infolist_item *item,
         return 0;
     if (!infolist_new_var_integer (item, "timeout", (int)(HOOK_URL(hook, timeout))))
         return 0;
-    if (!infolist_new_var_integer (item, "stop_transfer", HOOK_URL(hook, stop_transfer)))
-        return 0;
-    if (!infolist_new_var_integer (item, "thread_created", (int)(HOOK_URL(hook, thread_created))))
-        return 0;
-    if (!infolist_new_var_integer (item, "thread_running", (int)(HOOK_URL(hook, thread_running))))
+    if (!infolist_new_var_pointer (item, "transfer", HOOK_URL(hook, transfer)))
         return 0;
     if (!infolist_new_var_pointer (item, "hook_timer", HOOK_URL(hook, hook_timer)))
         return 0;
@@ -506,12 +680,41 @@ hook_url_print_log (struct t_hook *hook)
                 hashtable_get_string (HOOK_URL(hook, options),
                                       "keys_values"));
     log_printf ("    timeout . . . . . . . : %ld", HOOK_URL(hook, timeout));
-    log_printf ("    stop_transfer . . . . : %d", HOOK_URL(hook, stop_transfer));
-    log_printf ("    thread_created. . . . : %d", (int)HOOK_URL(hook, thread_created));
-    log_printf ("    thread_running. . . . : %d", (int)HOOK_URL(hook, thread_running));
+    log_printf ("    transfer. . . . . . . : %p", HOOK_URL(hook, transfer));
     log_printf ("    hook_timer. . . . . . : %p", HOOK_URL(hook, hook_timer));
     log_printf ("    output. . . . . . . . : %p (hashtable: '%s')",
                 HOOK_URL(hook, output),
                 hashtable_get_string (HOOK_URL(hook, output),
                                       "keys_values"));
 }
+
+/*
+ * End URL hooks: stop all transfers and free the curl multi handle (called
+ * on exit, before the other hooks are removed, because the fd hooks and
+ * timer used by curl are removed when the multi handle is freed).
+ */
+
+void
+hook_url_end (void)
+{
+    struct t_hook *ptr_hook, *next_hook;
+
+    ptr_hook = weechat_hooks[HOOK_TYPE_URL];
+    while (ptr_hook)
+    {
+        next_hook = ptr_hook->next_hook;
+        unhook (ptr_hook);
+        ptr_hook = next_hook;
+    }
+
+    if (hook_url_multi)
+    {
+        curl_multi_cleanup (hook_url_multi);
+        hook_url_multi = NULL;
+    }
+    if (hook_url_multi_timer)
+    {
+        unhook (hook_url_multi_timer);
+        hook_url_multi_timer = NULL;
+    }
+}
@@ -22,11 +22,10 @@
 #ifndef WEECHAT_HOOK_URL_H
 #define WEECHAT_HOOK_URL_H
 
-#include <pthread.h>
-
 struct t_weechat_plugin;
 struct t_infolist_item;
 struct t_hashtable;
+struct t_url_transfer;
 
 #define HOOK_URL(hook, var) (((struct t_hook_url *)hook->hook_data)->var)
 
@@ -41,11 +40,8 @@ struct t_hook_url
     char *url;                         /* URL                               */
     struct t_hashtable *options;       /* URL options (see doc)             */
     long timeout;                      /* timeout (ms) (0 = no timeout)     */
-    int stop_transfer;                 /* 1 is used to stop transfer now    */
-    pthread_t thread_id;               /* thread id                         */
-    int thread_created;                /* thread created                    */
-    int thread_running;                /* 1 if thread is running            */
-    struct t_hook *hook_timer;         /* timer to check if thread has ended*/
+    struct t_url_transfer *transfer;   /* transfer (NULL if not running)    */
+    struct t_hook *hook_timer;         /* timer for timeout of transfer     */
     struct t_hashtable *output;        /* URL transfer output data          */
 };
 
@@ -64,5 +60,6 @@ extern struct t_hdata *hook_url_hdata_hook_url_cb (const void *pointer,
 extern int hook_url_add_to_infolist (struct t_infolist_item *item,
                                          struct t_hook *hook);
 extern void hook_url_print_log (struct t_hook *hook);
+extern void hook_url_end (void);
 
 #endif /* WEECHAT_HOOK_URL_H */
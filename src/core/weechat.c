@@ -476,8 +476,10 @@ weechat_end (void (*gui_end_cb)(int clean_exit))
     secure_config_free ();              /* free secured data options        */
     config_file_free_all ();            /* free all configuration files     */
     gui_key_end ();                     /* remove all keys                  */
+    hook_url_end ();                    /* end URL transfers                */
     unhook_all ();                      /* remove all hooks                 */
     hdata_end ();                       /* end hdata                        */
+    eval_end ();                        /* end eval                         */
     secure_end ();                      /* end secured data                 */
     theme_end ();                       /* end theme registry               */
     string_end ();                      /* end string                       */
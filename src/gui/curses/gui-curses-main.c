@@ -35,6 +35,7 @@
 #include "../../core/weechat.h"
 #include "../../core/core-command.h"
 #include "../../core/core-config.h"
+#include "../../core/core-debug.h"
 #include "../../core/core-hook.h"
 #include "../../core/core-log.h"
 #include "../../core/core-signal.h"
@@ -417,9 +418,15 @@ gui_main_loop (void)
 
     while (!weechat_quit)
     {
+        if (DEBUG_LOOP_ACTIVE)
+            debug_loop_start ();
+
         /* execute timer hooks */
         hook_timer_exec ();
 
+        if (DEBUG_LOOP_ACTIVE)
+            debug_loop_mark (DEBUG_LOOP_PHASE_TIMER);
+
         /* auto reset of color pairs */
         if (gui_color_pairs_auto_reset)
         {
@@ -449,14 +456,29 @@ gui_main_loop (void)
 
         gui_color_pairs_auto_reset_pending = 0;
 
+        if (DEBUG_LOOP_ACTIVE)
+            debug_loop_mark (DEBUG_LOOP_PHASE_REFRESH);
+
         /* execute fd hooks */
         hook_fd_exec ();
 
+        if (DEBUG_LOOP_ACTIVE)
+            debug_loop_mark (DEBUG_LOOP_PHASE_FD);
+
         /* run process (with fork) */
         hook_process_exec ();
 
+        if (DEBUG_LOOP_ACTIVE)
+            debug_loop_mark (DEBUG_LOOP_PHASE_PROCESS);
+
         /* handle signals received */
         signal_handle ();
+
+        if (DEBUG_LOOP_ACTIVE)
+        {
+            debug_loop_mark (DEBUG_LOOP_PHASE_SIGNAL);
+            debug_loop_end ();
+        }
     }
 
     /* remove keyboard hook */
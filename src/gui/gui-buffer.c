@@ -955,6 +955,7 @@ gui_buffer_new_props_with_id (long long id,
 
     /* highlight */
     new_buffer->highlight_words = NULL;
+    new_buffer->highlight_words_compiled = NULL;
     new_buffer->highlight_disable_regex = NULL;
     new_buffer->highlight_disable_regex_compiled = NULL;
     new_buffer->highlight_regex = NULL;
@@ -962,9 +963,11 @@ gui_buffer_new_props_with_id (long long id,
     new_buffer->highlight_tags_restrict = NULL;
     new_buffer->highlight_tags_restrict_count = 0;
     new_buffer->highlight_tags_restrict_array = NULL;
+    new_buffer->highlight_tags_restrict_compiled = NULL;
     new_buffer->highlight_tags = NULL;
     new_buffer->highlight_tags_count = 0;
     new_buffer->highlight_tags_array = NULL;
+    new_buffer->highlight_tags_compiled = NULL;
 
     /* hotlist */
     new_buffer->hotlist = NULL;
@@ -1914,6 +1917,10 @@ gui_buffer_set_highlight_words (struct t_gui_buffer *buffer,
     free (buffer->highlight_words);
     buffer->highlight_words = (new_highlight_words && new_highlight_words[0]) ?
         strdup (new_highlight_words) : NULL;
+
+    string_highlight_free (buffer->highlight_words_compiled);
+    buffer->highlight_words_compiled = string_highlight_compile_option (
+        buffer->highlight_words);
 }
 
 /*
@@ -2076,7 +2083,7 @@ gui_buffer_set_highlight_disable_regex (struct t_gui_buffer *buffer,
     }
     if (buffer->highlight_disable_regex_compiled)
     {
-        regfree (buffer->highlight_disable_regex_compiled);
+        string_regex_free (buffer->highlight_disable_regex_compiled);
         free (buffer->highlight_disable_regex_compiled);
         buffer->highlight_disable_regex_compiled = NULL;
     }
@@ -2091,9 +2098,9 @@ gui_buffer_set_highlight_disable_regex (struct t_gui_buffer *buffer,
             malloc (sizeof (*buffer->highlight_disable_regex_compiled));
         if (buffer->highlight_disable_regex_compiled)
         {
-            if (string_regcomp (buffer->highlight_disable_regex_compiled,
-                                buffer->highlight_disable_regex,
-                                REG_EXTENDED | REG_ICASE) != 0)
+            if (string_regex_compile (buffer->highlight_disable_regex_compiled,
+                                      buffer->highlight_disable_regex,
+                                      REG_EXTENDED | REG_ICASE) != 0)
             {
                 free (buffer->highlight_disable_regex_compiled);
                 buffer->highlight_disable_regex_compiled = NULL;
@@ -2122,7 +2129,7 @@ gui_buffer_set_highlight_regex (struct t_gui_buffer *buffer,
     }
     if (buffer->highlight_regex_compiled)
     {
-        regfree (buffer->highlight_regex_compiled);
+        string_regex_free (buffer->highlight_regex_compiled);
         free (buffer->highlight_regex_compiled);
         buffer->highlight_regex_compiled = NULL;
     }
@@ -2137,9 +2144,9 @@ gui_buffer_set_highlight_regex (struct t_gui_buffer *buffer,
             malloc (sizeof (*buffer->highlight_regex_compiled));
         if (buffer->highlight_regex_compiled)
         {
-            if (string_regcomp (buffer->highlight_regex_compiled,
-                                buffer->highlight_regex,
-                                REG_EXTENDED | REG_ICASE) != 0)
+            if (string_regex_compile (buffer->highlight_regex_compiled,
+                                      buffer->highlight_regex,
+                                      REG_EXTENDED | REG_ICASE) != 0)
             {
                 free (buffer->highlight_regex_compiled);
                 buffer->highlight_regex_compiled = NULL;
@@ -2171,6 +2178,11 @@ gui_buffer_set_highlight_tags_restrict (struct t_gui_buffer *buffer,
         string_free_split_tags (buffer->highlight_tags_restrict_array);
         buffer->highlight_tags_restrict_array = NULL;
     }
+    if (buffer->highlight_tags_restrict_compiled)
+    {
+        gui_line_tags_compiled_free (buffer->highlight_tags_restrict_compiled);
+        buffer->highlight_tags_restrict_compiled = NULL;
+    }
     buffer->highlight_tags_restrict_count = 0;
 
     if (!new_tags || !new_tags[0])
@@ -2183,6 +2195,9 @@ gui_buffer_set_highlight_tags_restrict (struct t_gui_buffer *buffer,
     buffer->highlight_tags_restrict_array = string_split_tags (
         buffer->highlight_tags_restrict,
         &buffer->highlight_tags_restrict_count);
+    buffer->highlight_tags_restrict_compiled = gui_line_tags_compile (
+        buffer->highlight_tags_restrict_count,
+        buffer->highlight_tags_restrict_array);
 }
 
 /*
@@ -2206,6 +2221,11 @@ gui_buffer_set_highlight_tags (struct t_gui_buffer *buffer,
         string_free_split_tags (buffer->highlight_tags_array);
         buffer->highlight_tags_array = NULL;
     }
+    if (buffer->highlight_tags_compiled)
+    {
+        gui_line_tags_compiled_free (buffer->highlight_tags_compiled);
+        buffer->highlight_tags_compiled = NULL;
+    }
     buffer->highlight_tags_count = 0;
 
     if (!new_tags || !new_tags[0])
@@ -2218,6 +2238,9 @@ gui_buffer_set_highlight_tags (struct t_gui_buffer *buffer,
     buffer->highlight_tags_array = string_split_tags (
         buffer->highlight_tags,
         &buffer->highlight_tags_count);
+    buffer->highlight_tags_compiled = gui_line_tags_compile (
+        buffer->highlight_tags_count,
+        buffer->highlight_tags_array);
 }
 
 /*
@@ -3793,7 +3816,7 @@ gui_buffer_close (struct t_gui_buffer *buffer)
 
     /* free all lines */
     gui_line_free_all (buffer);
-    free (buffer->own_lines);
+    gui_line_lines_free (buffer->own_lines);
     buffer->own_lines = NULL;
     free (buffer->mixed_lines);
     buffer->mixed_lines = NULL;
@@ -3843,11 +3866,13 @@ gui_buffer_close (struct t_gui_buffer *buffer)
     }
     free (buffer->highlight_words);
     buffer->highlight_words = NULL;
+    string_highlight_free (buffer->highlight_words_compiled);
+    buffer->highlight_words_compiled = NULL;
     free (buffer->highlight_disable_regex);
     buffer->highlight_disable_regex = NULL;
     if (buffer->highlight_disable_regex_compiled)
     {
-        regfree (buffer->highlight_disable_regex_compiled);
+        string_regex_free (buffer->highlight_disable_regex_compiled);
         free (buffer->highlight_disable_regex_compiled);
         buffer->highlight_disable_regex_compiled = NULL;
     }
@@ -3855,7 +3880,7 @@ gui_buffer_close (struct t_gui_buffer *buffer)
     buffer->highlight_regex = NULL;
     if (buffer->highlight_regex_compiled)
     {
-        regfree (buffer->highlight_regex_compiled);
+        string_regex_free (buffer->highlight_regex_compiled);
         free (buffer->highlight_regex_compiled);
         buffer->highlight_regex_compiled = NULL;
     }
@@ -3863,10 +3888,14 @@ gui_buffer_close (struct t_gui_buffer *buffer)
     buffer->highlight_tags_restrict = NULL;
     string_free_split_tags (buffer->highlight_tags_restrict_array);
     buffer->highlight_tags_restrict_array = NULL;
+    gui_line_tags_compiled_free (buffer->highlight_tags_restrict_compiled);
+    buffer->highlight_tags_restrict_compiled = NULL;
     free (buffer->highlight_tags);
     buffer->highlight_tags = NULL;
     string_free_split_tags (buffer->highlight_tags_array);
     buffer->highlight_tags_array = NULL;
+    gui_line_tags_compiled_free (buffer->highlight_tags_compiled);
+    buffer->highlight_tags_compiled = NULL;
     free (buffer->input_callback_data);
     buffer->input_callback_data = NULL;
     free (buffer->close_callback_data);
@@ -5376,6 +5405,7 @@ gui_buffer_hdata_buffer_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_gui_buffer, text_search_ptr_history, POINTER, 0, NULL, "history");
         HDATA_VAR(struct t_gui_buffer, text_search_input, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_words, STRING, 0, NULL, NULL);
+        HDATA_VAR(struct t_gui_buffer, highlight_words_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_disable_regex, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_disable_regex_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_regex, STRING, 0, NULL, NULL);
@@ -5383,9 +5413,11 @@ gui_buffer_hdata_buffer_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_gui_buffer, highlight_tags_restrict, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_tags_restrict_count, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_tags_restrict_array, POINTER, 0, "*,highlight_tags_restrict_count", NULL);
+        HDATA_VAR(struct t_gui_buffer, highlight_tags_restrict_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_tags, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_tags_count, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, highlight_tags_array, POINTER, 0, "*,highlight_tags_count", NULL);
+        HDATA_VAR(struct t_gui_buffer, highlight_tags_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, hotlist, POINTER, 0, NULL, "hotlist");
         HDATA_VAR(struct t_gui_buffer, hotlist_max_level_nicks, HASHTABLE, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_buffer, keys, POINTER, 0, NULL, "key");
@@ -5850,6 +5882,7 @@ gui_buffer_print_log (void)
         log_printf ("  text_search_ptr_history . . . . : %p", ptr_buffer->text_search_ptr_history);
         log_printf ("  text_search_input . . . . . . . : '%s'", ptr_buffer->text_search_input);
         log_printf ("  highlight_words . . . . . . . . : '%s'", ptr_buffer->highlight_words);
+        log_printf ("  highlight_words_compiled. . . . : %p", ptr_buffer->highlight_words_compiled);
         log_printf ("  highlight_disable_regex . . . . : '%s'", ptr_buffer->highlight_disable_regex);
         log_printf ("  highlight_disable_regex_compiled: %p", ptr_buffer->highlight_disable_regex_compiled);
         log_printf ("  highlight_regex . . . . . . . . : '%s'", ptr_buffer->highlight_regex);
@@ -5857,9 +5890,11 @@ gui_buffer_print_log (void)
         log_printf ("  highlight_tags_restrict . . . . : '%s'", ptr_buffer->highlight_tags_restrict);
         log_printf ("  highlight_tags_restrict_count . : %d", ptr_buffer->highlight_tags_restrict_count);
         log_printf ("  highlight_tags_restrict_array . : %p", ptr_buffer->highlight_tags_restrict_array);
+        log_printf ("  highlight_tags_restrict_compiled: %p", ptr_buffer->highlight_tags_restrict_compiled);
         log_printf ("  highlight_tags. . . . . . . . . : '%s'", ptr_buffer->highlight_tags);
         log_printf ("  highlight_tags_count. . . . . . : %d", ptr_buffer->highlight_tags_count);
         log_printf ("  highlight_tags_array. . . . . . : %p", ptr_buffer->highlight_tags_array);
+        log_printf ("  highlight_tags_compiled . . . . : %p", ptr_buffer->highlight_tags_compiled);
         log_printf ("  hotlist . . . . . . . . . . . . : %p", ptr_buffer->hotlist);
         log_printf ("  hotlist_removed . . . . . . . . : %p", ptr_buffer->hotlist_removed);
         log_printf ("  keys. . . . . . . . . . . . . . : %p", ptr_buffer->keys);
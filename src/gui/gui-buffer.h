@@ -26,9 +26,12 @@
 #include <regex.h>
 
 struct t_config_option;
+struct t_gui_line_tags_compiled;
 struct t_gui_window;
 struct t_hashtable;
 struct t_infolist;
+struct t_string_highlight;
+struct t_string_regex;
 
 enum t_gui_buffer_type
 {
@@ -239,16 +242,21 @@ struct t_gui_buffer
 
     /* highlight settings for buffer */
     char *highlight_words;             /* list of words to highlight        */
+    struct t_string_highlight *highlight_words_compiled; /* compiled words  */
     char *highlight_regex;             /* regex for highlight               */
-    regex_t *highlight_regex_compiled; /* compiled regex                    */
+    struct t_string_regex *highlight_regex_compiled; /* compiled regex      */
     char *highlight_disable_regex;     /* regex for disabling highlight     */
-    regex_t *highlight_disable_regex_compiled; /* compiled regex            */
+    struct t_string_regex *highlight_disable_regex_compiled; /* compiled regex */
     char *highlight_tags_restrict;     /* restrict highlight to these tags  */
     int highlight_tags_restrict_count; /* number of restricted tags         */
     char ***highlight_tags_restrict_array; /* array with restricted tags    */
+    struct t_gui_line_tags_compiled *highlight_tags_restrict_compiled;
+                                       /* compiled restricted tags          */
     char *highlight_tags;              /* force highlight on these tags     */
     int highlight_tags_count;          /* number of highlight tags          */
     char ***highlight_tags_array;      /* array with highlight tags         */
+    struct t_gui_line_tags_compiled *highlight_tags_compiled;
+                                       /* compiled highlight tags           */
 
     /* hotlist */
     struct t_gui_hotlist *hotlist;     /* hotlist entry for buffer          */
@@ -571,7 +571,8 @@ gui_chat_change_time_format (void)
         {
             if (ptr_line->data->date != 0)
             {
-                free (ptr_line->data->str_time);
+                gui_line_data_free_string (ptr_line->data,
+                                           ptr_line->data->str_time);
                 ptr_line->data->str_time = gui_chat_get_time_string (
                     ptr_line->data->date,
                     ptr_line->data->date_usec,
@@ -856,10 +857,10 @@ gui_chat_pipe_end (void)
         }
         else if (gui_chat_pipe_hsignal)
         {
-            hashtable = hashtable_new (32,
-                                       WEECHAT_HASHTABLE_STRING,
-                                       WEECHAT_HASHTABLE_STRING,
-                                       NULL, NULL);
+            hashtable = hashtable_new_compact (32,
+                                               WEECHAT_HASHTABLE_STRING,
+                                               WEECHAT_HASHTABLE_STRING,
+                                               NULL, NULL);
             if (hashtable)
             {
                 hashtable_set (hashtable, "command", gui_chat_pipe_command);
@@ -967,30 +968,33 @@ gui_chat_printf_datetime_tags_internal (struct t_gui_buffer *buffer,
         goto no_print;
 
     /* call modifier for message printed ("weechat_print") */
-    string_asprintf (&modifier_data,
-                     "0x%lx;%s",
-                     (unsigned long)buffer,
-                     (tags) ? tags : "");
-    if (display_time)
+    if (hook_modifier_is_hooked ("weechat_print"))
     {
-        string_asprintf (
-            &string,
-            "%s\t%s",
-            (new_line->data->prefix && new_line->data->prefix[0]) ?
-            new_line->data->prefix : " ",
-            (new_line->data->message) ? new_line->data->message : "");
-    }
-    else
-    {
-        string_asprintf (
-            &string,
-            "\t\t%s",
-            (new_line->data->message) ? new_line->data->message : "");
+        string_asprintf (&modifier_data,
+                         "0x%lx;%s",
+                         (unsigned long)buffer,
+                         (tags) ? tags : "");
+        if (display_time)
+        {
+            string_asprintf (
+                &string,
+                "%s\t%s",
+                (new_line->data->prefix && new_line->data->prefix[0]) ?
+                new_line->data->prefix : " ",
+                (new_line->data->message) ? new_line->data->message : "");
+        }
+        else
+        {
+            string_asprintf (
+                &string,
+                "\t\t%s",
+                (new_line->data->message) ? new_line->data->message : "");
+        }
+        new_string = hook_modifier_exec (NULL,
+                                         "weechat_print",
+                                         modifier_data,
+                                         string);
     }
-    new_string = hook_modifier_exec (NULL,
-                                     "weechat_print",
-                                     modifier_data,
-                                     string);
     if (new_string)
     {
         if (!new_string[0] && string[0])
@@ -1058,7 +1062,8 @@ gui_chat_printf_datetime_tags_internal (struct t_gui_buffer *buffer,
             }
             new_line->data->prefix_length = gui_chat_strlen_screen (
                 new_line->data->prefix);
-            free (new_line->data->message);
+            gui_line_data_free_string (new_line->data,
+                                       new_line->data->message);
             new_line->data->message = strdup (ptr_msg);
         }
     }
@@ -1078,7 +1083,7 @@ gui_chat_printf_datetime_tags_internal (struct t_gui_buffer *buffer,
             gui_chat_strlen_screen (prefix_color) : 0;
 
         message_color = gui_chat_pipe_convert_color (new_line->data->message);
-        free (new_line->data->message);
+        gui_line_data_free_string (new_line->data, new_line->data->message);
         new_line->data->message = message_color;
     }
 
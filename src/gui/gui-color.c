@@ -34,6 +34,11 @@
 #include <time.h>
 #include <ctype.h>
 #include <limits.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "../core/weechat.h"
 #include "../core/core-config.h"
@@ -771,6 +776,196 @@ gui_color_code_size (const char *string)
     return 0;
 }
 
+/*
+ * Get number of bytes at beginning of string before the first byte that
+ * can start a WeeChat color code, reading at most "bytes" bytes (the string
+ * must have at least "bytes" bytes before the final '\0').
+ *
+ * The string is checked 16 bytes at a time with SSE2 (if available),
+ * otherwise 8 bytes at a time.
+ *
+ * Return "bytes" if the string does not contain any color code.
+ */
+
+int
+gui_color_code_scan (const char *string, int bytes)
+{
+    int i;
+#ifdef __SSE2__
+    __m128i chunk, codes;
+#else
+    uint64_t chunk;
+#endif /* __SSE2__ */
+
+    i = 0;
+
+#ifdef __SSE2__
+    while (i + 16 <= bytes)
+    {
+        chunk = _mm_loadu_si128 ((const __m128i *)(string + i));
+        codes = _mm_and_si128 (
+            _mm_cmpgt_epi8 (chunk, _mm_set1_epi8 (GUI_COLOR_COLOR_CHAR - 1)),
+            _mm_cmplt_epi8 (chunk, _mm_set1_epi8 (GUI_COLOR_RESET_CHAR + 1)));
+        if (_mm_movemask_epi8 (codes))
+            break;
+        i += 16;
+    }
+#else
+    while (i + 8 <= bytes)
+    {
+        memcpy (&chunk, string + i, sizeof (chunk));
+        /* check if a byte is in range 0x19-0x1C (exclusive bounds) */
+        if (((0x0101010101010101ULL * (127 + GUI_COLOR_RESET_CHAR + 1)
+              - (chunk & 0x7F7F7F7F7F7F7F7FULL))
+             & ~chunk
+             & ((chunk & 0x7F7F7F7F7F7F7F7FULL)
+                + 0x0101010101010101ULL * (127 - (GUI_COLOR_COLOR_CHAR - 1)))
+             & 0x8080808080808080ULL))
+        {
+            break;
+        }
+        i += 8;
+    }
+#endif /* __SSE2__ */
+
+    while ((i < bytes)
+           && (((unsigned char)string[i] < GUI_COLOR_COLOR_CHAR)
+               || ((unsigned char)string[i] > GUI_COLOR_RESET_CHAR)))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/*
+ * Check if "string" contains WeeChat color codes.
+ *
+ * Return:
+ *   1: string has color codes
+ *   0: string has no color codes (or is NULL)
+ */
+
+int
+gui_color_has_codes (const char *string)
+{
+    int length;
+
+    if (!string)
+        return 0;
+
+    length = strlen (string);
+
+    return (gui_color_code_scan (string, length) < length) ? 1 : 0;
+}
+
+/*
+ * Append "length" bytes of "data" to the decoded string: in the dynamic
+ * string "out" if not NULL, otherwise in "buffer" (as much as possible,
+ * keeping room for the final '\0').
+ *
+ * The position in decoded string "*pos" is incremented by "length" in all
+ * cases.
+ */
+
+void
+gui_color_decode_append (char **out, char *buffer, int size, int *pos,
+                         const char *data, int length)
+{
+    int length_copy;
+
+    if (length <= 0)
+        return;
+
+    if (out)
+    {
+        string_dyn_concat (out, data, length);
+    }
+    else if (buffer && (*pos < size - 1))
+    {
+        length_copy = (length < size - 1 - *pos) ? length : size - 1 - *pos;
+        memcpy (buffer + *pos, data, length_copy);
+    }
+
+    *pos += length;
+}
+
+/*
+ * Remove WeeChat color codes from the "length" first bytes of string and
+ * optionally replace them by a string.
+ *
+ * Text between color codes is copied by blocks; the decoded string is
+ * written in the dynamic string "out" if not NULL, otherwise in "buffer".
+ *
+ * Return the length of decoded string.
+ */
+
+int
+gui_color_decode_internal (const char *string, int length,
+                           const char *replacement,
+                           char **out, char *buffer, int size)
+{
+    const char *ptr_string, *ptr_end, *ptr_code, *ptr_char;
+    int pos, length_replacement, length_char, i, boundary;
+
+    pos = 0;
+    length_replacement = (replacement) ? strlen (replacement) : 0;
+
+    ptr_string = string;
+    ptr_end = string + length;
+    while (ptr_string < ptr_end)
+    {
+        ptr_code = ptr_string + gui_color_code_scan (ptr_string,
+                                                     ptr_end - ptr_string);
+        if (ptr_code >= ptr_end)
+        {
+            gui_color_decode_append (out, buffer, size, &pos,
+                                     ptr_string, ptr_end - ptr_string);
+            break;
+        }
+
+        /*
+         * the color code is ignored if it is inside a UTF-8 char (invalid
+         * UTF-8): this can happen only if one of the 3 previous bytes is
+         * the first byte of a multi-bytes char, in which case the chars are
+         * read from the beginning of the text to find the boundaries
+         */
+        boundary = 1;
+        for (i = 1; (i <= 3) && (ptr_code - i >= ptr_string); i++)
+        {
+            if ((unsigned char)ptr_code[-i] >= 0xC0)
+            {
+                boundary = 0;
+                break;
+            }
+        }
+        if (!boundary)
+        {
+            ptr_char = ptr_string;
+            while (ptr_char < ptr_code)
+            {
+                length_char = utf8_char_size (ptr_char);
+                ptr_char += (length_char > 0) ? length_char : 1;
+            }
+            if (ptr_char > ptr_code)
+            {
+                gui_color_decode_append (out, buffer, size, &pos,
+                                         ptr_string, ptr_char - ptr_string);
+                ptr_string = ptr_char;
+                continue;
+            }
+        }
+
+        gui_color_decode_append (out, buffer, size, &pos,
+                                 ptr_string, ptr_code - ptr_string);
+        ptr_string = ptr_code + gui_color_code_size (ptr_code);
+        gui_color_decode_append (out, buffer, size, &pos,
+                                 replacement, length_replacement);
+    }
+
+    return pos;
+}
+
 /*
  * Remove WeeChat color codes from a message and optionally replaces them
  * by a string.
@@ -781,184 +976,86 @@ gui_color_code_size (const char *string)
 char *
 gui_color_decode (const char *string, const char *replacement)
 {
-    const unsigned char *ptr_string;
     char **out;
     int length;
 
     if (!string)
         return NULL;
 
-    out = string_dyn_alloc (strlen (string) + 1);
+    length = strlen (string);
+
+    /* fast path: no color codes, just duplicate the string */
+    if (gui_color_code_scan (string, length) == length)
+        return strdup (string);
+
+    out = string_dyn_alloc (length + 1);
     if (!out)
         return NULL;
 
-    ptr_string = (unsigned char *)string;
-    while (ptr_string && ptr_string[0])
-    {
-        switch (ptr_string[0])
-        {
-            case GUI_COLOR_COLOR_CHAR:
-                ptr_string++;
-                switch (ptr_string[0])
-                {
-                    case GUI_COLOR_FG_CHAR:
-                        ptr_string++;
-                        if (ptr_string[0] == GUI_COLOR_EXTENDED_CHAR)
-                        {
-                            ptr_string++;
-                            while (gui_color_attr_get_flag (ptr_string[0]) > 0)
-                            {
-                                ptr_string++;
-                            }
-                            if (ptr_string[0] && ptr_string[1] && ptr_string[2]
-                                && ptr_string[3] && ptr_string[4])
-                            {
-                                ptr_string += 5;
-                            }
-                        }
-                        else
-                        {
-                            while (gui_color_attr_get_flag (ptr_string[0]) > 0)
-                            {
-                                ptr_string++;
-                            }
-                            if (ptr_string[0] && ptr_string[1])
-                                ptr_string += 2;
-                        }
-                        break;
-                    case GUI_COLOR_BG_CHAR:
-                        ptr_string++;
-                        if (ptr_string[0] == GUI_COLOR_EXTENDED_CHAR)
-                        {
-                            ptr_string++;
-                            if (ptr_string[0] && ptr_string[1] && ptr_string[2]
-                                && ptr_string[3] && ptr_string[4])
-                            {
-                                ptr_string += 5;
-                            }
-                        }
-                        else
-                        {
-                            if (ptr_string[0] && ptr_string[1])
-                                ptr_string += 2;
-                        }
-                        break;
-                    case GUI_COLOR_FG_BG_CHAR:
-                        ptr_string++;
-                        if (ptr_string[0] == GUI_COLOR_EXTENDED_CHAR)
-                        {
-                            ptr_string++;
-                            while (gui_color_attr_get_flag (ptr_string[0]) > 0)
-                            {
-                                ptr_string++;
-                            }
-                            if (ptr_string[0] && ptr_string[1] && ptr_string[2]
-                                && ptr_string[3] && ptr_string[4])
-                            {
-                                ptr_string += 5;
-                            }
-                        }
-                        else
-                        {
-                            while (gui_color_attr_get_flag (ptr_string[0]) > 0)
-                            {
-                                ptr_string++;
-                            }
-                            if (ptr_string[0] && ptr_string[1])
-                                ptr_string += 2;
-                        }
-                        /*
-                         * note: the comma is an old separator not used any
-                         * more (since WeeChat 2.6), but we still use it here
-                         * so in case of/upgrade this will not break colors in
-                         * old messages
-                         */
-                        if ((ptr_string[0] == ',') || (ptr_string[0] == '~'))
-                        {
-                            if (ptr_string[1] == GUI_COLOR_EXTENDED_CHAR)
-                            {
-                                ptr_string += 2;
-                                if (ptr_string[0] && ptr_string[1]
-                                    && ptr_string[2] && ptr_string[3]
-                                    && ptr_string[4])
-                                {
-                                    ptr_string += 5;
-                                }
-                            }
-                            else
-                            {
-                                ptr_string++;
-                                if (ptr_string[0] && ptr_string[1])
-                                    ptr_string += 2;
-                            }
-                        }
-                        break;
-                    case GUI_COLOR_EXTENDED_CHAR:
-                        ptr_string++;
-                        if ((isdigit (ptr_string[0])) && (isdigit (ptr_string[1]))
-                            && (isdigit (ptr_string[2])) && (isdigit (ptr_string[3]))
-                            && (isdigit (ptr_string[4])))
-                        {
-                            ptr_string += 5;
-                        }
-                        break;
-                    case GUI_COLOR_EMPHASIS_CHAR:
-                        ptr_string++;
-                        break;
-                    case GUI_COLOR_BAR_CHAR:
-                        ptr_string++;
-                        switch (ptr_string[0])
-                        {
-                            case GUI_COLOR_BAR_FG_CHAR:
-                            case GUI_COLOR_BAR_BG_CHAR:
-                            case GUI_COLOR_BAR_DELIM_CHAR:
-                            case GUI_COLOR_BAR_START_INPUT_CHAR:
-                            case GUI_COLOR_BAR_START_INPUT_HIDDEN_CHAR:
-                            case GUI_COLOR_BAR_MOVE_CURSOR_CHAR:
-                            case GUI_COLOR_BAR_START_ITEM:
-                            case GUI_COLOR_BAR_START_LINE_ITEM:
-                            case GUI_COLOR_BAR_SPACER:
-                                ptr_string++;
-                                break;
-                        }
-                        break;
-                    case GUI_COLOR_RESET_CHAR:
-                        ptr_string++;
-                        break;
-                    default:
-                        if (isdigit (ptr_string[0]) && isdigit (ptr_string[1]))
-                            ptr_string += 2;
-                        break;
-                }
-                if (replacement && replacement[0])
-                    string_dyn_concat (out, replacement, -1);
-                break;
-            case GUI_COLOR_SET_ATTR_CHAR:
-            case GUI_COLOR_REMOVE_ATTR_CHAR:
-                ptr_string++;
-                if (ptr_string[0])
-                    ptr_string++;
-                if (replacement && replacement[0])
-                    string_dyn_concat (out, replacement, -1);
-                break;
-            case GUI_COLOR_RESET_CHAR:
-                ptr_string++;
-                if (replacement && replacement[0])
-                    string_dyn_concat (out, replacement, -1);
-                break;
-            default:
-                length = utf8_char_size ((char *)ptr_string);
-                if (length == 0)
-                    length = 1;
-                string_dyn_concat (out, (const char *)ptr_string, length);
-                ptr_string += length;
-                break;
-        }
-    }
+    gui_color_decode_internal (string, length, replacement, out, NULL, 0);
 
     return string_dyn_free (out, 0);
 }
 
+/*
+ * Remove WeeChat color codes from a message and optionally replaces them
+ * by a string, without allocating memory if the message has no color codes.
+ *
+ * If the message has color codes, the decoded string is allocated and
+ * stored in "*decoded" (it must be freed after use), otherwise "*decoded"
+ * is set to NULL and "string" is returned.
+ *
+ * Return pointer to the string without color codes (NULL if error).
+ */
+
+const char *
+gui_color_decode_borrow (const char *string, const char *replacement,
+                         char **decoded)
+{
+    if (!decoded)
+        return NULL;
+
+    *decoded = NULL;
+
+    if (!gui_color_has_codes (string))
+        return string;
+
+    *decoded = gui_color_decode (string, replacement);
+
+    return *decoded;
+}
+
+/*
+ * Remove WeeChat color codes from a message and optionally replaces them
+ * by a string, writing the result in "buffer" which has "size" bytes
+ * (including the final '\0').
+ *
+ * The decoded string is truncated if the buffer is too small (it is always
+ * terminated by '\0' if size is greater than 0).
+ *
+ * Return the length of decoded string (without the final '\0'), which can
+ * be greater than or equal to "size" if the string was truncated,
+ * -1 if error.
+ */
+
+int
+gui_color_decode_to_buffer (const char *string, const char *replacement,
+                            char *buffer, int size)
+{
+    int length;
+
+    if (!string || !buffer || (size < 0))
+        return -1;
+
+    length = gui_color_decode_internal (string, strlen (string), replacement,
+                                        NULL, buffer, size);
+
+    if (size > 0)
+        buffer[(length < size - 1) ? length : size - 1] = '\0';
+
+    return length;
+}
+
 /*
  * Convert ANSI color codes to WeeChat colors (or removes them).
  *
@@ -82,9 +82,8 @@ gui_filter_check_line (struct t_gui_line_data *line_data)
                                    0))
             {
                 if ((strcmp (ptr_filter->tags, "*") == 0)
-                    || (gui_line_match_tags (line_data,
-                                             ptr_filter->tags_count,
-                                             ptr_filter->tags_array)))
+                    || (gui_line_match_tags_compiled (
+                            line_data, ptr_filter->tags_compiled)))
                 {
                     /* check line with regex */
                     rc = 1;
@@ -365,7 +364,7 @@ gui_filter_new (int enabled, const char *name, const char *buffer_name,
                 const char *tags, const char *regex)
 {
     struct t_gui_filter *new_filter;
-    regex_t *regex1, *regex2;
+    struct t_string_regex *regex1, *regex2;
     char *regex_prefix, buf[512], str_error[1024];
     const char *ptr_start_regex, *pos_regex_message, *pos_tab;
     int rc;
@@ -415,11 +414,11 @@ gui_filter_new (int enabled, const char *name, const char *buffer_name,
             regex1 = malloc (sizeof (*regex1));
             if (regex1)
             {
-                rc = string_regcomp (regex1, regex_prefix,
-                                     REG_EXTENDED | REG_ICASE | REG_NOSUB);
+                rc = string_regex_compile (regex1, regex_prefix,
+                                           REG_EXTENDED | REG_ICASE | REG_NOSUB);
                 if (rc != 0)
                 {
-                    regerror (rc, regex1, buf, sizeof (buf));
+                    regerror (rc, &(regex1->regex), buf, sizeof (buf));
                     snprintf (str_error, sizeof (str_error),
                               /* TRANSLATORS: %s is the error returned by regerror */
                               _("invalid regular expression (%s)"),
@@ -437,11 +436,11 @@ gui_filter_new (int enabled, const char *name, const char *buffer_name,
             regex2 = malloc (sizeof (*regex2));
             if (regex2)
             {
-                rc = string_regcomp (regex2, pos_regex_message,
-                                     REG_EXTENDED | REG_ICASE | REG_NOSUB);
+                rc = string_regex_compile (regex2, pos_regex_message,
+                                           REG_EXTENDED | REG_ICASE | REG_NOSUB);
                 if (rc != 0)
                 {
-                    regerror (rc, regex2, buf, sizeof (buf));
+                    regerror (rc, &(regex2->regex), buf, sizeof (buf));
                     snprintf (str_error, sizeof (str_error),
                               /* TRANSLATORS: %s is the error returned by regerror */
                               _("invalid regular expression (%s)"),
@@ -450,7 +449,7 @@ gui_filter_new (int enabled, const char *name, const char *buffer_name,
                     free (regex_prefix);
                     if (regex1)
                     {
-                        regfree (regex1);
+                        string_regex_free (regex1);
                         free (regex1);
                     }
                     free (regex2);
@@ -482,6 +481,8 @@ gui_filter_new (int enabled, const char *name, const char *buffer_name,
         new_filter->tags = (tags) ? strdup (tags) : NULL;
         new_filter->tags_array = string_split_tags (new_filter->tags,
                                                     &new_filter->tags_count);
+        new_filter->tags_compiled = gui_line_tags_compile (
+            new_filter->tags_count, new_filter->tags_array);
         new_filter->regex = strdup (regex);
         new_filter->regex_prefix = regex1;
         new_filter->regex_message = regex2;
@@ -545,15 +546,16 @@ gui_filter_free (struct t_gui_filter *filter)
     string_free_split (filter->buffers);
     free (filter->tags);
     string_free_split_tags (filter->tags_array);
+    gui_line_tags_compiled_free (filter->tags_compiled);
     free (filter->regex);
     if (filter->regex_prefix)
     {
-        regfree (filter->regex_prefix);
+        string_regex_free (filter->regex_prefix);
         free (filter->regex_prefix);
     }
     if (filter->regex_message)
     {
-        regfree (filter->regex_message);
+        string_regex_free (filter->regex_message);
         free (filter->regex_message);
     }
 
@@ -603,6 +605,7 @@ gui_filter_hdata_filter_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_gui_filter, tags, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_filter, tags_count, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_filter, tags_array, POINTER, 0, "*,tags_count", NULL);
+        HDATA_VAR(struct t_gui_filter, tags_compiled, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_filter, regex, STRING, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_filter, regex_prefix, POINTER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_filter, regex_message, POINTER, 0, NULL, NULL);
@@ -697,6 +700,7 @@ gui_filter_print_log (void)
             log_printf ("  buffers[%03d] . . . . . : '%s'", i, ptr_filter->buffers[i]);
         }
         log_printf ("  tags . . . . . . . . . : '%s'", ptr_filter->tags);
+        log_printf ("  tags_compiled. . . . . : %p", ptr_filter->tags_compiled);
         log_printf ("  regex. . . . . . . . . : '%s'", ptr_filter->regex);
         log_printf ("  regex_prefix . . . . . : %p", ptr_filter->regex_prefix);
         log_printf ("  regex_message. . . . . : %p", ptr_filter->regex_message);
@@ -29,6 +29,8 @@
 /* filter structures */
 
 struct t_gui_line_data;
+struct t_gui_line_tags_compiled;
+struct t_string_regex;
 
 struct t_gui_filter
 {
@@ -40,9 +42,10 @@ struct t_gui_filter
     char *tags;                        /* tags                              */
     int tags_count;                    /* number of tags                    */
     char ***tags_array;                /* array of tags                     */
+    struct t_gui_line_tags_compiled *tags_compiled; /* compiled tags        */
     char *regex;                       /* regex                             */
-    regex_t *regex_prefix;             /* regex for line prefix             */
-    regex_t *regex_message;            /* regex for line message            */
+    struct t_string_regex *regex_prefix; /* regex for line prefix           */
+    struct t_string_regex *regex_message; /* regex for line message         */
     struct t_gui_filter *prev_filter;  /* link to previous filter           */
     struct t_gui_filter *next_filter;  /* link to next filter               */
 };
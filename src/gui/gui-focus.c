@@ -156,10 +156,10 @@ gui_focus_to_hashtable (struct t_gui_focus_info *focus_info, const char *key)
     char str_value[128], *str_time, *str_prefix, *str_tags, *str_message;
     const char *nick;
 
-    hashtable = hashtable_new (32,
-                               WEECHAT_HASHTABLE_STRING,
-                               WEECHAT_HASHTABLE_STRING,
-                               NULL, NULL);
+    hashtable = hashtable_new_compact (32,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
     if (!hashtable)
         return NULL;
 
@@ -75,6 +75,7 @@ gui_line_lines_alloc (void)
         new_lines->buffer_max_length_refresh = 0;
         new_lines->prefix_max_length = CONFIG_INTEGER(config_look_prefix_align_min);
         new_lines->prefix_max_length_refresh = 0;
+        new_lines->arena = NULL;
     }
 
     return new_lines;
@@ -90,6 +91,18 @@ gui_line_lines_free (struct t_gui_lines *lines)
     if (!lines)
         return;
 
+    if (lines->arena)
+    {
+        /*
+         * records still used (line moved to another buffer by a hook_line):
+         * the arena is freed with its last record
+         */
+        if (lines->arena->records > 0)
+            lines->arena->orphan = 1;
+        else
+            gui_line_arena_free (lines->arena);
+    }
+
     free (lines);
 }
 
@@ -133,6 +146,436 @@ gui_line_tags_free (struct t_gui_line_data *line_data)
     }
 }
 
+/*
+ * Free an arena with all its chunks.
+ */
+
+void
+gui_line_arena_free (struct t_gui_line_arena *arena)
+{
+    struct t_gui_line_arena_chunk *ptr_chunk, *ptr_next_chunk;
+
+    if (!arena)
+        return;
+
+    ptr_chunk = arena->chunks;
+    while (ptr_chunk)
+    {
+        ptr_next_chunk = ptr_chunk->next_chunk;
+        free (ptr_chunk);
+        ptr_chunk = ptr_next_chunk;
+    }
+
+    free (arena);
+}
+
+/*
+ * Add a new chunk in an arena, with room for at least "size" bytes (the
+ * chunk has at least the size of next chunk in arena).
+ *
+ * Return pointer to new chunk, NULL if error.
+ */
+
+struct t_gui_line_arena_chunk *
+gui_line_arena_chunk_new (struct t_gui_line_arena *arena, size_t size)
+{
+    struct t_gui_line_arena_chunk *new_chunk;
+    size_t size_header;
+
+    size_header = GUI_LINE_ARENA_ALIGN(sizeof (*new_chunk));
+    if (size_header + size < arena->chunk_size)
+        size = arena->chunk_size - size_header;
+
+    new_chunk = malloc (size_header + size);
+    if (!new_chunk)
+        return NULL;
+
+    new_chunk->arena = arena;
+    new_chunk->size = size_header + size;
+    new_chunk->used = size_header;
+    new_chunk->records = 0;
+
+    new_chunk->prev_chunk = arena->last_chunk;
+    new_chunk->next_chunk = NULL;
+    if (arena->last_chunk)
+        (arena->last_chunk)->next_chunk = new_chunk;
+    else
+        arena->chunks = new_chunk;
+    arena->last_chunk = new_chunk;
+
+    arena->num_chunks++;
+    arena->size += new_chunk->size;
+
+    return new_chunk;
+}
+
+/*
+ * Remove a chunk from its arena and free it.
+ */
+
+void
+gui_line_arena_chunk_free (struct t_gui_line_arena_chunk *chunk)
+{
+    struct t_gui_line_arena *arena;
+
+    arena = chunk->arena;
+
+    if (arena->current_chunk == chunk)
+        arena->current_chunk = NULL;
+
+    if (chunk->prev_chunk)
+        (chunk->prev_chunk)->next_chunk = chunk->next_chunk;
+    if (chunk->next_chunk)
+        (chunk->next_chunk)->prev_chunk = chunk->prev_chunk;
+    if (arena->chunks == chunk)
+        arena->chunks = chunk->next_chunk;
+    if (arena->last_chunk == chunk)
+        arena->last_chunk = chunk->prev_chunk;
+
+    arena->num_chunks--;
+    arena->size -= chunk->size;
+
+    free (chunk);
+}
+
+/*
+ * Allocate a record for line data with "size_tail" extra bytes for strings
+ * stored after the data.
+ *
+ * Records of formatted buffers are allocated in the arena of the buffer
+ * (lines are added at the end and removed from the beginning, so chunks
+ * are released as a whole); records of buffers with free content (where
+ * lines are often replaced) have their own allocation.
+ *
+ * Return pointer to new record, NULL if error.
+ */
+
+struct t_gui_line_record *
+gui_line_record_alloc (struct t_gui_buffer *buffer, size_t size_tail)
+{
+    struct t_gui_line_arena *arena;
+    struct t_gui_line_arena_chunk *ptr_chunk;
+    struct t_gui_line_record *new_record;
+    size_t size;
+
+    size = GUI_LINE_ARENA_ALIGN(sizeof (*new_record) + size_tail);
+
+    if ((buffer->type != GUI_BUFFER_TYPE_FORMATTED) || !buffer->own_lines)
+    {
+        new_record = malloc (size);
+        if (!new_record)
+            return NULL;
+        new_record->chunk = NULL;
+        new_record->size = size;
+        return new_record;
+    }
+
+    if (!buffer->own_lines->arena)
+    {
+        buffer->own_lines->arena = calloc (1, sizeof (*arena));
+        if (!buffer->own_lines->arena)
+            return NULL;
+        buffer->own_lines->arena->chunk_size = GUI_LINE_ARENA_CHUNK_SIZE_MIN;
+    }
+    arena = buffer->own_lines->arena;
+
+    if (size > GUI_LINE_ARENA_CHUNK_SIZE_MAX / 4)
+    {
+        /* big record: use a chunk for this record only */
+        ptr_chunk = gui_line_arena_chunk_new (arena, size);
+        if (!ptr_chunk)
+            return NULL;
+    }
+    else
+    {
+        ptr_chunk = arena->current_chunk;
+        if (!ptr_chunk || (ptr_chunk->used + size > ptr_chunk->size))
+        {
+            if (ptr_chunk && (ptr_chunk->records == 0))
+                gui_line_arena_chunk_free (ptr_chunk);
+            ptr_chunk = gui_line_arena_chunk_new (arena, size);
+            if (!ptr_chunk)
+                return NULL;
+            arena->current_chunk = ptr_chunk;
+            /* small buffers use small chunks, big buffers use bigger ones */
+            if (arena->chunk_size < GUI_LINE_ARENA_CHUNK_SIZE_MAX)
+                arena->chunk_size *= 2;
+        }
+    }
+
+    new_record = (struct t_gui_line_record *)((char *)ptr_chunk + ptr_chunk->used);
+    new_record->chunk = ptr_chunk;
+    new_record->size = size;
+
+    ptr_chunk->used += size;
+    ptr_chunk->records++;
+    arena->records++;
+
+    return new_record;
+}
+
+/*
+ * Return the record containing line data.
+ */
+
+struct t_gui_line_record *
+gui_line_record_get (struct t_gui_line_data *line_data)
+{
+    return (struct t_gui_line_record *)(
+        (char *)line_data - offsetof (struct t_gui_line_record, data));
+}
+
+/*
+ * Free the record containing line data.
+ *
+ * A chunk is freed when its last record is freed, except the current chunk
+ * of the arena which is reused.
+ */
+
+void
+gui_line_record_free (struct t_gui_line_data *line_data)
+{
+    struct t_gui_line_record *record;
+    struct t_gui_line_arena_chunk *ptr_chunk;
+    struct t_gui_line_arena *arena;
+
+    record = gui_line_record_get (line_data);
+    ptr_chunk = record->chunk;
+
+    if (!ptr_chunk)
+    {
+        free (record);
+        return;
+    }
+
+    arena = ptr_chunk->arena;
+
+    /* give back space if this is the last record allocated in chunk */
+    if ((char *)record + record->size == (char *)ptr_chunk + ptr_chunk->used)
+        ptr_chunk->used -= record->size;
+
+    ptr_chunk->records--;
+    arena->records--;
+
+    if (ptr_chunk->records == 0)
+    {
+        if ((ptr_chunk == arena->current_chunk) && !arena->orphan)
+            ptr_chunk->used = GUI_LINE_ARENA_ALIGN(sizeof (*ptr_chunk));
+        else
+            gui_line_arena_chunk_free (ptr_chunk);
+    }
+
+    if (arena->orphan && (arena->records == 0))
+        gui_line_arena_free (arena);
+}
+
+/*
+ * Create line data from a temporary line data: the data is copied in a
+ * new record, with tags array, message and time string stored after it.
+ *
+ * The tags and prefix of "line_data" are moved to the new line data (the
+ * tags array of "line_data" is freed).
+ *
+ * Return pointer to new line data, NULL if error (then "line_data" is left
+ * unchanged).
+ */
+
+struct t_gui_line_data *
+gui_line_data_new (struct t_gui_line_data *line_data)
+{
+    struct t_gui_line_record *new_record;
+    struct t_gui_line_data *new_data;
+    size_t size_tags, length_message, length_time;
+    char *ptr_tail;
+
+    size_tags = (line_data->tags_array) ?
+        (line_data->tags_count + 1) * sizeof (line_data->tags_array[0]) : 0;
+    length_message = (line_data->message) ? strlen (line_data->message) + 1 : 0;
+    length_time = (line_data->str_time) ? strlen (line_data->str_time) + 1 : 0;
+
+    new_record = gui_line_record_alloc (line_data->buffer,
+                                        size_tags + length_message + length_time);
+    if (!new_record)
+        return NULL;
+
+    new_data = &(new_record->data);
+    memcpy (new_data, line_data, sizeof (*new_data));
+
+    ptr_tail = (char *)(new_record + 1);
+    if (line_data->tags_array)
+    {
+        memcpy (ptr_tail, line_data->tags_array, size_tags);
+        new_data->tags_array = (char **)ptr_tail;
+        ptr_tail += size_tags;
+        free (line_data->tags_array);
+        line_data->tags_array = NULL;
+        line_data->tags_count = 0;
+    }
+    if (line_data->message)
+    {
+        memcpy (ptr_tail, line_data->message, length_message);
+        new_data->message = ptr_tail;
+        ptr_tail += length_message;
+    }
+    if (line_data->str_time)
+    {
+        memcpy (ptr_tail, line_data->str_time, length_time);
+        new_data->str_time = ptr_tail;
+    }
+
+    return new_data;
+}
+
+/*
+ * Check if a pointer is stored in the record of a line data (after the
+ * data itself).
+ *
+ * Return:
+ *   1: pointer is in the record
+ *   0: pointer is not in the record (it has its own allocation)
+ */
+
+int
+gui_line_data_is_inline (struct t_gui_line_data *line_data,
+                         const void *pointer)
+{
+    struct t_gui_line_record *record;
+
+    if (!line_data || !pointer)
+        return 0;
+
+    record = gui_line_record_get (line_data);
+
+    return (((const char *)pointer >= (const char *)(record + 1))
+            && ((const char *)pointer < (const char *)record + record->size)) ?
+        1 : 0;
+}
+
+/*
+ * Free a string of a line data (message or time string), unless it is
+ * stored in the record of the line data.
+ */
+
+void
+gui_line_data_free_string (struct t_gui_line_data *line_data, char *string)
+{
+    if (string && !gui_line_data_is_inline (line_data, string))
+        free (string);
+}
+
+/*
+ * Free tags of a line data (the array is freed only if it is not stored in
+ * the record of the line data).
+ */
+
+void
+gui_line_data_tags_free (struct t_gui_line_data *line_data)
+{
+    int i;
+
+    if (!line_data)
+        return;
+
+    if (line_data->tags_array
+        && gui_line_data_is_inline (line_data, line_data->tags_array))
+    {
+        for (i = 0; i < line_data->tags_count; i++)
+        {
+            string_shared_free (line_data->tags_array[i]);
+        }
+        line_data->tags_count = 0;
+        line_data->tags_array = NULL;
+    }
+    else
+    {
+        gui_line_tags_free (line_data);
+    }
+}
+
+/*
+ * Return the estimated size of a memory allocation, with the usual malloc
+ * overhead (header of one pointer, granularity of 16 bytes).
+ */
+
+unsigned long long
+gui_line_malloc_size (size_t size)
+{
+    size = (size + sizeof (void *) + 15) & ~((size_t)15);
+    return (size < 32) ? 32 : size;
+}
+
+/*
+ * Get memory used by line data of all buffers.
+ *
+ * Argument "size" is set with the size of all arena chunks and of records
+ * of buffers with free content; "size_unused" is set with the size not
+ * used yet in arena chunks; "size_unpacked" is set with the estimated
+ * size that data and strings of these records would use with one
+ * allocation each.
+ */
+
+void
+gui_line_arena_get_memory (int *records, int *chunks,
+                           unsigned long long *size,
+                           unsigned long long *size_unused,
+                           unsigned long long *size_unpacked)
+{
+    struct t_gui_buffer *ptr_buffer;
+    struct t_gui_line_arena_chunk *ptr_chunk;
+    struct t_gui_line *ptr_line;
+    struct t_gui_line_data *ptr_data;
+    struct t_gui_line_record *ptr_record;
+
+    *records = 0;
+    *chunks = 0;
+    *size = 0;
+    *size_unused = 0;
+    *size_unpacked = 0;
+
+    for (ptr_buffer = gui_buffers; ptr_buffer;
+         ptr_buffer = ptr_buffer->next_buffer)
+    {
+        if (!ptr_buffer->own_lines)
+            continue;
+        if (ptr_buffer->own_lines->arena)
+        {
+            *chunks += ptr_buffer->own_lines->arena->num_chunks;
+            *size += ptr_buffer->own_lines->arena->size
+                + sizeof (*(ptr_buffer->own_lines->arena));
+            for (ptr_chunk = ptr_buffer->own_lines->arena->chunks; ptr_chunk;
+                 ptr_chunk = ptr_chunk->next_chunk)
+            {
+                *size_unused += ptr_chunk->size - ptr_chunk->used;
+            }
+        }
+        for (ptr_line = ptr_buffer->own_lines->first_line; ptr_line;
+             ptr_line = ptr_line->next_line)
+        {
+            ptr_data = ptr_line->data;
+            ptr_record = gui_line_record_get (ptr_data);
+            (*records)++;
+            if (!ptr_record->chunk)
+                *size += gui_line_malloc_size (ptr_record->size);
+            *size_unpacked += gui_line_malloc_size (sizeof (*ptr_data));
+            if (gui_line_data_is_inline (ptr_data, ptr_data->tags_array))
+            {
+                *size_unpacked += gui_line_malloc_size (
+                    (ptr_data->tags_count + 1) * sizeof (ptr_data->tags_array[0]));
+            }
+            if (gui_line_data_is_inline (ptr_data, ptr_data->message))
+            {
+                *size_unpacked += gui_line_malloc_size (
+                    strlen (ptr_data->message) + 1);
+            }
+            if (gui_line_data_is_inline (ptr_data, ptr_data->str_time))
+            {
+                *size_unpacked += gui_line_malloc_size (
+                    strlen (ptr_data->str_time) + 1);
+            }
+        }
+    }
+}
+
 /*
  * Check if prefix on line is a nick and is the same as nick on previous/next
  * line (according to direction: if < 0, check if it's the same nick as
@@ -730,8 +1173,9 @@ gui_line_search_text (struct t_gui_buffer *buffer, struct t_gui_line *line)
  */
 
 int
-gui_line_match_regex (struct t_gui_line_data *line_data, regex_t *regex_prefix,
-                      regex_t *regex_message)
+gui_line_match_regex (struct t_gui_line_data *line_data,
+                      struct t_string_regex *regex_prefix,
+                      struct t_string_regex *regex_message)
 {
     char *prefix, *message;
     int match_prefix, match_message;
@@ -749,7 +1193,7 @@ gui_line_match_regex (struct t_gui_line_data *line_data, regex_t *regex_prefix,
     {
         prefix = gui_color_decode (line_data->prefix, NULL);
         if (!prefix
-            || (regex_prefix && (regexec (regex_prefix, prefix, 0, NULL, 0) != 0)))
+            || (regex_prefix && (string_regex_exec (regex_prefix, prefix, 0, NULL, 0) != 0)))
             match_prefix = 0;
     }
     else
@@ -762,7 +1206,7 @@ gui_line_match_regex (struct t_gui_line_data *line_data, regex_t *regex_prefix,
     {
         message = gui_color_decode (line_data->message, NULL);
         if (!message
-            || (regex_message && (regexec (regex_message, message, 0, NULL, 0) != 0)))
+            || (regex_message && (string_regex_exec (regex_message, message, 0, NULL, 0) != 0)))
             match_message = 0;
     }
     else
@@ -869,6 +1313,203 @@ gui_line_match_tags (struct t_gui_line_data *line_data,
     return 0;
 }
 
+/*
+ * Compile tags (as returned by function string_split_tags) to match them
+ * quickly against tags of lines.
+ *
+ * Tags of lines are shared strings: a tag without wildcard is first compared
+ * to tags of line by pointer, and the result of match of a tag against a
+ * tag of line is kept in a small cache indexed by the id of the shared
+ * string, so that masks are not matched again on each line.
+ *
+ * Return pointer to compiled tags, NULL if error or if tags_array is NULL.
+ *
+ * Note: result must be freed after use with function
+ * gui_line_tags_compiled_free.
+ */
+
+struct t_gui_line_tags_compiled *
+gui_line_tags_compile (int tags_count, char ***tags_array)
+{
+    struct t_gui_line_tags_compiled *new_tags;
+    struct t_gui_line_tag_compiled *ptr_tag;
+    const char *ptr_string;
+    int i, j, count;
+
+    if (!tags_array || (tags_count < 0))
+        return NULL;
+
+    new_tags = calloc (1, sizeof (*new_tags));
+    if (!new_tags)
+        return NULL;
+
+    if (tags_count == 0)
+        return new_tags;
+
+    new_tags->tags_count = calloc (tags_count, sizeof (*new_tags->tags_count));
+    new_tags->tags = calloc (tags_count, sizeof (*new_tags->tags));
+    if (!new_tags->tags_count || !new_tags->tags)
+        goto error;
+    new_tags->count = tags_count;
+
+    for (i = 0; i < tags_count; i++)
+    {
+        count = 0;
+        while (tags_array[i][count])
+        {
+            count++;
+        }
+        if (count == 0)
+            continue;
+        new_tags->tags[i] = calloc (count, sizeof (*new_tags->tags[i]));
+        if (!new_tags->tags[i])
+            goto error;
+        new_tags->tags_count[i] = count;
+        for (j = 0; j < count; j++)
+        {
+            ptr_tag = &(new_tags->tags[i][j]);
+            ptr_string = tags_array[i][j];
+            /* check if tag is negated (prefixed with a '!') */
+            if ((ptr_string[0] == '!') && ptr_string[1])
+            {
+                ptr_string++;
+                ptr_tag->negated = 1;
+            }
+            if (strcmp (ptr_string, "*") == 0)
+            {
+                ptr_tag->any = 1;
+                continue;
+            }
+            ptr_tag->tag = (char *)string_shared_get (ptr_string);
+            ptr_tag->mask = string_mask_compile (ptr_string, 0);
+            if (!ptr_tag->tag || !ptr_tag->mask)
+                goto error;
+        }
+    }
+
+    return new_tags;
+
+error:
+    gui_line_tags_compiled_free (new_tags);
+    return NULL;
+}
+
+/*
+ * Check if a compiled tag matches a tag of line (shared string).
+ *
+ * Return:
+ *   1: tag matches
+ *   0: tag does not match
+ */
+
+int
+gui_line_tag_compiled_match (struct t_gui_line_tag_compiled *tag,
+                             const char *line_tag)
+{
+    struct t_gui_line_tags_cache *ptr_cache;
+    unsigned int id;
+
+    /* same shared string: same tag */
+    if (line_tag == tag->tag)
+        return 1;
+
+    id = string_shared_get_id (line_tag);
+    ptr_cache = &(tag->cache[id % GUI_LINE_TAGS_CACHE_SIZE]);
+    if ((ptr_cache->tag != line_tag) || (ptr_cache->id != id))
+    {
+        ptr_cache->tag = line_tag;
+        ptr_cache->id = id;
+        ptr_cache->match = string_mask_match (tag->mask, line_tag);
+    }
+
+    return ptr_cache->match;
+}
+
+/*
+ * Check if tags of a line match compiled tags (same as function
+ * gui_line_match_tags, with compiled tags).
+ *
+ * Return:
+ *   1: line matches tags
+ *   0: line does not match tags
+ */
+
+int
+gui_line_match_tags_compiled (struct t_gui_line_data *line_data,
+                              struct t_gui_line_tags_compiled *tags)
+{
+    struct t_gui_line_tag_compiled *ptr_tag;
+    int i, j, k, match, tag_found;
+
+    if (!line_data || !tags)
+        return 0;
+
+    for (i = 0; i < tags->count; i++)
+    {
+        match = 1;
+        for (j = 0; j < tags->tags_count[i]; j++)
+        {
+            ptr_tag = &(tags->tags[i][j]);
+            tag_found = ptr_tag->any;
+            if (!tag_found)
+            {
+                for (k = 0; k < line_data->tags_count; k++)
+                {
+                    if (gui_line_tag_compiled_match (ptr_tag,
+                                                     line_data->tags_array[k]))
+                    {
+                        tag_found = 1;
+                        break;
+                    }
+                }
+            }
+            if (tag_found && ptr_tag->negated)
+                return 0;
+            if (!tag_found && !ptr_tag->negated)
+            {
+                match = 0;
+                break;
+            }
+        }
+        if (match)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Free compiled tags.
+ */
+
+void
+gui_line_tags_compiled_free (struct t_gui_line_tags_compiled *tags)
+{
+    int i, j;
+
+    if (!tags)
+        return;
+
+    if (tags->tags)
+    {
+        for (i = 0; i < tags->count; i++)
+        {
+            if (!tags->tags[i])
+                continue;
+            for (j = 0; j < tags->tags_count[i]; j++)
+            {
+                string_shared_free (tags->tags[i][j].tag);
+                string_mask_free (tags->tags[i][j].mask);
+            }
+            free (tags->tags[i]);
+        }
+        free (tags->tags);
+    }
+    free (tags->tags_count);
+
+    free (tags);
+}
+
 /*
  * Return pointer on tag starting with "tag", NULL if such tag is not found.
  */
@@ -925,12 +1566,13 @@ int
 gui_line_has_highlight (struct t_gui_line *line)
 {
     int rc, rc_regex, i, no_highlight, action, length;
-    char *msg_no_color, *ptr_msg_no_color, *highlight_words;
-    const char *ptr_nick;
+    const char *msg_no_color, *ptr_msg_no_color, *ptr_nick;
+    char *msg_decoded, *highlight_words;
     regmatch_t regex_match;
 
     /* remove color codes from line message */
-    msg_no_color = gui_color_decode (line->data->message, NULL);
+    msg_no_color = gui_color_decode_borrow (line->data->message, NULL,
+                                            &msg_decoded);
     if (!msg_no_color)
     {
         rc = 0;
@@ -1006,8 +1648,8 @@ gui_line_has_highlight (struct t_gui_line *line)
      */
     if (config_highlight_disable_regex)
     {
-        rc_regex = regexec (config_highlight_disable_regex,
-                            ptr_msg_no_color, 1, &regex_match, 0);
+        rc_regex = string_regex_exec (config_highlight_disable_regex,
+                                      ptr_msg_no_color, 1, &regex_match, 0);
         if ((rc_regex == 0) && (regex_match.rm_so >= 0) && (regex_match.rm_eo > 0))
         {
             rc = 0;
@@ -1021,8 +1663,8 @@ gui_line_has_highlight (struct t_gui_line *line)
      */
     if (line->data->buffer->highlight_disable_regex_compiled)
     {
-        rc_regex = regexec (line->data->buffer->highlight_disable_regex_compiled,
-                            ptr_msg_no_color, 1, &regex_match, 0);
+        rc_regex = string_regex_exec (line->data->buffer->highlight_disable_regex_compiled,
+                                      ptr_msg_no_color, 1, &regex_match, 0);
         if ((rc_regex == 0) && (regex_match.rm_so >= 0) && (regex_match.rm_eo > 0))
         {
             rc = 0;
@@ -1035,9 +1677,8 @@ gui_line_has_highlight (struct t_gui_line *line)
      * (with global option "weechat.look.highlight_tags")
      */
     if (config_highlight_tags
-        && gui_line_match_tags (line->data,
-                                config_num_highlight_tags,
-                                config_highlight_tags))
+        && gui_line_match_tags_compiled (line->data,
+                                         config_highlight_tags_compiled))
     {
         rc = 1;
         goto end;
@@ -1048,9 +1689,8 @@ gui_line_has_highlight (struct t_gui_line *line)
      * (with buffer property "highlight_tags")
      */
     if (line->data->buffer->highlight_tags
-        && gui_line_match_tags (line->data,
-                                line->data->buffer->highlight_tags_count,
-                                line->data->buffer->highlight_tags_array))
+        && gui_line_match_tags_compiled (
+            line->data, line->data->buffer->highlight_tags_compiled))
     {
         rc = 1;
         goto end;
@@ -1062,9 +1702,9 @@ gui_line_has_highlight (struct t_gui_line *line)
      */
     if (line->data->buffer->highlight_tags_restrict_count > 0)
     {
-        if (!gui_line_match_tags (line->data,
-                                  line->data->buffer->highlight_tags_restrict_count,
-                                  line->data->buffer->highlight_tags_restrict_array))
+        if (!gui_line_match_tags_compiled (
+                line->data,
+                line->data->buffer->highlight_tags_restrict_compiled))
         {
             rc = 0;
             goto end;
@@ -1075,21 +1715,37 @@ gui_line_has_highlight (struct t_gui_line *line)
      * there is highlight on line if one of buffer highlight words matches line
      * or one of global highlight words matches line
      */
-    highlight_words = gui_buffer_string_replace_local_var (line->data->buffer,
-                                                           line->data->buffer->highlight_words);
-    rc = string_has_highlight (ptr_msg_no_color,
-                               (highlight_words) ?
-                               highlight_words : line->data->buffer->highlight_words);
-    free (highlight_words);
+    if (line->data->buffer->highlight_words_compiled)
+    {
+        rc = string_highlight_match (
+            line->data->buffer->highlight_words_compiled, ptr_msg_no_color);
+    }
+    else
+    {
+        highlight_words = gui_buffer_string_replace_local_var (line->data->buffer,
+                                                               line->data->buffer->highlight_words);
+        rc = string_has_highlight (ptr_msg_no_color,
+                                   (highlight_words) ?
+                                   highlight_words : line->data->buffer->highlight_words);
+        free (highlight_words);
+    }
     if (rc)
         goto end;
 
-    highlight_words = gui_buffer_string_replace_local_var (line->data->buffer,
-                                                           CONFIG_STRING(config_look_highlight));
-    rc = string_has_highlight (ptr_msg_no_color,
-                               (highlight_words) ?
-                               highlight_words : CONFIG_STRING(config_look_highlight));
-    free (highlight_words);
+    if (config_highlight_words_compiled)
+    {
+        rc = string_highlight_match (config_highlight_words_compiled,
+                                     ptr_msg_no_color);
+    }
+    else
+    {
+        highlight_words = gui_buffer_string_replace_local_var (line->data->buffer,
+                                                               CONFIG_STRING(config_look_highlight));
+        rc = string_has_highlight (ptr_msg_no_color,
+                                   (highlight_words) ?
+                                   highlight_words : CONFIG_STRING(config_look_highlight));
+        free (highlight_words);
+    }
     if (rc)
         goto end;
 
@@ -1108,7 +1764,7 @@ gui_line_has_highlight (struct t_gui_line *line)
     }
 
 end:
-    free (msg_no_color);
+    free (msg_decoded);
 
     return rc;
 }
@@ -1271,11 +1927,11 @@ gui_line_add_to_list (struct t_gui_lines *lines,
 void
 gui_line_free_data (struct t_gui_line *line)
 {
-    free (line->data->str_time);
-    gui_line_tags_free (line->data);
+    gui_line_data_free_string (line->data, line->data->str_time);
+    gui_line_data_tags_free (line->data);
     string_shared_free (line->data->prefix);
-    free (line->data->message);
-    free (line->data);
+    gui_line_data_free_string (line->data, line->data->message);
+    gui_line_record_free (line->data);
 
     line->data = NULL;
 }
@@ -1593,8 +2249,9 @@ gui_line_new (struct t_gui_buffer *buffer, int y,
               const char *prefix, const char *message,
               int known_highlight, const char *known_str_time)
 {
-    struct t_gui_line *new_line;
-    struct t_gui_line_data *new_line_data;
+    struct t_gui_line *new_line, line_temp;
+    struct t_gui_line_data line_data;
+    char *str_time;
     int max_notify_level;
 
     if (!buffer)
@@ -1605,18 +2262,14 @@ gui_line_new (struct t_gui_buffer *buffer, int y,
     if (!new_line)
         return NULL;
 
-    /* create data for line */
-    new_line_data = malloc (sizeof (*new_line_data));
-    if (!new_line_data)
-    {
-        free (new_line);
-        return NULL;
-    }
-    new_line->data = new_line_data;
-
-    /* fill data in new line */
-    new_line->data->buffer = buffer;
-    new_line->data->message = (message) ? strdup (message) : strdup ("");
+    /*
+     * fill data in a temporary line, which is then copied with message and
+     * time in a single record (see function gui_line_data_new)
+     */
+    line_temp.data = &line_data;
+    line_data.buffer = buffer;
+    line_data.message = (message) ? (char *)message : (char *)"";
+    str_time = NULL;
 
     if (buffer->type == GUI_BUFFER_TYPE_FORMATTED)
     {
@@ -1627,48 +2280,62 @@ gui_line_new (struct t_gui_buffer *buffer, int y,
          * when searching a line id in a buffer, it is recommended to start
          * from the last line and loop to the first
          */
-        new_line->data->id = buffer->next_line_id;
+        line_data.id = buffer->next_line_id;
         buffer->next_line_id = (buffer->next_line_id == INT_MAX) ?
             0 : buffer->next_line_id + 1;
-        new_line->data->y = -1;
-        new_line->data->date = date;
-        new_line->data->date_usec = date_usec;
-        new_line->data->date_printed = date_printed;
-        new_line->data->date_usec_printed = date_usec_printed;
-        gui_line_tags_alloc (new_line->data, tags);
-        new_line->data->refresh_needed = 0;
-        new_line->data->prefix = (prefix) ?
+        line_data.y = -1;
+        line_data.date = date;
+        line_data.date_usec = date_usec;
+        line_data.date_printed = date_printed;
+        line_data.date_usec_printed = date_usec_printed;
+        gui_line_tags_alloc (&line_data, tags);
+        line_data.refresh_needed = 0;
+        line_data.prefix = (prefix) ?
             (char *)string_shared_get (prefix) : ((date != 0) ? (char *)string_shared_get ("") : NULL);
-        new_line->data->prefix_length = (prefix) ?
+        line_data.prefix_length = (prefix) ?
             gui_chat_strlen_screen (prefix) : 0;
-        max_notify_level = gui_line_get_max_notify_level (new_line);
-        gui_line_set_notify_level (new_line, max_notify_level);
+        max_notify_level = gui_line_get_max_notify_level (&line_temp);
+        gui_line_set_notify_level (&line_temp, max_notify_level);
         if (known_highlight >= 0)
-            new_line->data->highlight = known_highlight;
+            line_data.highlight = known_highlight;
         else
-            gui_line_set_highlight (new_line, max_notify_level);
-        if (new_line->data->highlight && (new_line->data->notify_level >= 0))
-            new_line->data->notify_level = GUI_HOTLIST_HIGHLIGHT;
-        new_line->data->str_time = (known_str_time) ?
-            strdup (known_str_time) :
-            gui_chat_get_time_string (date, date_usec,
-                                      new_line->data->highlight);
+            gui_line_set_highlight (&line_temp, max_notify_level);
+        if (line_data.highlight && (line_data.notify_level >= 0))
+            line_data.notify_level = GUI_HOTLIST_HIGHLIGHT;
+        if (!known_str_time)
+        {
+            str_time = gui_chat_get_time_string (date, date_usec,
+                                                 line_data.highlight);
+        }
+        line_data.str_time = (known_str_time) ?
+            (char *)known_str_time : str_time;
     }
     else
     {
-        new_line->data->id = y;
-        new_line->data->y = y;
-        new_line->data->date = date;
-        new_line->data->date_usec = date_usec;
-        new_line->data->date_printed = date_printed;
-        new_line->data->date_usec_printed = date_usec_printed;
-        new_line->data->str_time = NULL;
-        gui_line_tags_alloc (new_line->data, tags);
-        new_line->data->refresh_needed = 1;
-        new_line->data->prefix = NULL;
-        new_line->data->prefix_length = 0;
-        new_line->data->notify_level = 0;
-        new_line->data->highlight = 0;
+        line_data.id = y;
+        line_data.y = y;
+        line_data.date = date;
+        line_data.date_usec = date_usec;
+        line_data.date_printed = date_printed;
+        line_data.date_usec_printed = date_usec_printed;
+        line_data.str_time = NULL;
+        gui_line_tags_alloc (&line_data, tags);
+        line_data.refresh_needed = 1;
+        line_data.prefix = NULL;
+        line_data.prefix_length = 0;
+        line_data.notify_level = 0;
+        line_data.highlight = 0;
+    }
+    line_data.displayed = 0;
+
+    new_line->data = gui_line_data_new (&line_data);
+    free (str_time);
+    if (!new_line->data)
+    {
+        gui_line_tags_free (&line_data);
+        string_shared_free (line_data.prefix);
+        free (new_line);
+        return NULL;
     }
 
     /* set display flag (check if line is filtered or not) */
@@ -1781,7 +2448,7 @@ gui_line_hook_update (struct t_gui_line *line,
             && (value_longlong >= 0))
         {
             line->data->date = (time_t)value_longlong;
-            free (line->data->str_time);
+            gui_line_data_free_string (line->data, line->data->str_time);
             line->data->str_time = gui_chat_get_time_string (
                 line->data->date,
                 line->data->date_usec,
@@ -1796,7 +2463,7 @@ gui_line_hook_update (struct t_gui_line *line,
             && (value >= 0) && (value <= 999999))
         {
             line->data->date_usec = value;
-            free (line->data->str_time);
+            gui_line_data_free_string (line->data, line->data->str_time);
             line->data->str_time = gui_chat_get_time_string (
                 line->data->date,
                 line->data->date_usec,
@@ -1828,7 +2495,7 @@ gui_line_hook_update (struct t_gui_line *line,
     ptr_value2 = hashtable_get (hashtable2, "str_time");
     if (ptr_value2 && (!ptr_value || (strcmp (ptr_value, ptr_value2) != 0)))
     {
-        free (line->data->str_time);
+        gui_line_data_free_string (line->data, line->data->str_time);
         line->data->str_time = (ptr_value2) ? strdup (ptr_value2) : NULL;
     }
 
@@ -1837,7 +2504,7 @@ gui_line_hook_update (struct t_gui_line *line,
     if (ptr_value2 && (!ptr_value || (strcmp (ptr_value, ptr_value2) != 0)))
     {
         tags_updated = 1;
-        gui_line_tags_free (line->data);
+        gui_line_data_tags_free (line->data);
         gui_line_tags_alloc (line->data, ptr_value2);
     }
 
@@ -1864,7 +2531,7 @@ gui_line_hook_update (struct t_gui_line *line,
             if (pos_newline)
                 pos_newline[0] = '\0';
         }
-        free (line->data->message);
+        gui_line_data_free_string (line->data, line->data->message);
         line->data->message = (new_message) ? strdup (new_message) : NULL;
         free (new_message);
     }
@@ -2165,10 +2832,10 @@ gui_line_clear (struct t_gui_line *line)
     line->data->date_usec_printed = 0;
     if (line->data->str_time)
     {
-        free (line->data->str_time);
+        gui_line_data_free_string (line->data, line->data->str_time);
         line->data->str_time = NULL;
     }
-    gui_line_tags_free (line->data);
+    gui_line_data_tags_free (line->data);
     if (line->data->prefix)
     {
         string_shared_free (line->data->prefix);
@@ -2177,8 +2844,15 @@ gui_line_clear (struct t_gui_line *line)
     line->data->prefix_length = 0;
     line->data->notify_level = 0;
     line->data->highlight = 0;
-    free (line->data->message);
-    line->data->message = strdup ("");
+    if (gui_line_data_is_inline (line->data, line->data->message))
+    {
+        line->data->message[0] = '\0';
+    }
+    else
+    {
+        free (line->data->message);
+        line->data->message = strdup ("");
+    }
 }
 
 /*
@@ -2301,6 +2975,7 @@ gui_line_hdata_lines_cb (const void *pointer, void *data,
         HDATA_VAR(struct t_gui_lines, buffer_max_length_refresh, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_lines, prefix_max_length, INTEGER, 0, NULL, NULL);
         HDATA_VAR(struct t_gui_lines, prefix_max_length_refresh, INTEGER, 0, NULL, NULL);
+        HDATA_VAR(struct t_gui_lines, arena, POINTER, 0, NULL, NULL);
     }
     return hdata;
 }
@@ -2360,7 +3035,7 @@ gui_line_hdata_line_data_update_cb (void *data,
         if (value)
         {
             hdata_set (hdata, pointer, "date", value);
-            free (line_data->str_time);
+            gui_line_data_free_string (line_data, line_data->str_time);
             line_data->str_time = gui_chat_get_time_string (
                 line_data->date,
                 line_data->date_usec,
@@ -2376,7 +3051,7 @@ gui_line_hdata_line_data_update_cb (void *data,
         if (value)
         {
             hdata_set (hdata, pointer, "date_usec", value);
-            free (line_data->str_time);
+            gui_line_data_free_string (line_data, line_data->str_time);
             line_data->str_time = gui_chat_get_time_string (
                 line_data->date,
                 line_data->date_usec,
@@ -2409,7 +3084,7 @@ gui_line_hdata_line_data_update_cb (void *data,
     if (hashtable_has_key (hashtable, "tags_array"))
     {
         value = hashtable_get (hashtable, "tags_array");
-        gui_line_tags_free (line_data);
+        gui_line_data_tags_free (line_data);
         gui_line_tags_alloc (line_data, value);
         rc++;
     }
@@ -2436,6 +3111,9 @@ gui_line_hdata_line_data_update_cb (void *data,
             if (pos_newline)
                 pos_newline[0] = '\0';
         }
+        /* message stored in the line record must not be freed by hdata */
+        if (gui_line_data_is_inline (line_data, line_data->message))
+            line_data->message = NULL;
         hdata_set (hdata, pointer, "message", new_value);
         rc++;
         update_coords = 1;
@@ -2604,5 +3282,16 @@ gui_lines_print_log (struct t_gui_lines *lines)
         log_printf ("    buffer_max_length_refresh: %d", lines->buffer_max_length_refresh);
         log_printf ("    prefix_max_length. . . . : %d", lines->prefix_max_length);
         log_printf ("    prefix_max_length_refresh: %d", lines->prefix_max_length_refresh);
+        log_printf ("    arena. . . . . . . . . . : %p", lines->arena);
+        if (lines->arena)
+        {
+            log_printf ("      chunks . . . . . . . . : %p", lines->arena->chunks);
+            log_printf ("      last_chunk . . . . . . : %p", lines->arena->last_chunk);
+            log_printf ("      current_chunk. . . . . : %p", lines->arena->current_chunk);
+            log_printf ("      num_chunks . . . . . . : %d", lines->arena->num_chunks);
+            log_printf ("      size . . . . . . . . . : %lu", (unsigned long)lines->arena->size);
+            log_printf ("      records. . . . . . . . : %d", lines->arena->records);
+            log_printf ("      orphan . . . . . . . . : %d", lines->arena->orphan);
+        }
     }
 }
@@ -27,6 +27,25 @@
 
 struct t_infolist;
 
+/*
+ * data of lines in formatted buffers is allocated in chunks: the first chunk
+ * of a buffer has the min size, then each new chunk is twice bigger, up to
+ * the max size (records bigger than a quarter of the max size get their own
+ * chunk)
+ */
+#define GUI_LINE_ARENA_CHUNK_SIZE_MIN (4 * 1024)
+#define GUI_LINE_ARENA_CHUNK_SIZE_MAX (64 * 1024)
+
+/* alignment of chunks and records in the arena */
+#define GUI_LINE_ARENA_ALIGN(__size)                                    \
+    (((__size) + 7) & ~((size_t)7))
+
+/* number of results of match kept for each tag of compiled tags */
+#define GUI_LINE_TAGS_CACHE_SIZE 32
+
+struct t_string_mask;
+struct t_string_regex;
+
 /* line structures */
 
 struct t_gui_line_data
@@ -52,6 +71,38 @@ struct t_gui_line_data
     char *message;                     /* line content (after prefix)       */
 };
 
+struct t_gui_line_record
+{
+    struct t_gui_line_arena_chunk *chunk; /* chunk (NULL: own allocation)   */
+    size_t size;                       /* size of record (with tail)        */
+    struct t_gui_line_data data;       /* line data                         */
+    /* followed by: tags array, message and time string (the "tail") */
+};
+
+struct t_gui_line_arena_chunk
+{
+    struct t_gui_line_arena *arena;    /* arena containing this chunk       */
+    size_t size;                       /* size of chunk (with this header)  */
+    size_t used;                       /* bytes used (with this header)     */
+    int records;                       /* number of records in chunk        */
+    struct t_gui_line_arena_chunk *prev_chunk; /* link to previous chunk    */
+    struct t_gui_line_arena_chunk *next_chunk; /* link to next chunk        */
+};
+
+struct t_gui_line_arena
+{
+    struct t_gui_line_arena_chunk *chunks;      /* chunks (oldest first)    */
+    struct t_gui_line_arena_chunk *last_chunk;  /* last chunk               */
+    struct t_gui_line_arena_chunk *current_chunk; /* chunk for new records  */
+    int num_chunks;                    /* number of chunks                  */
+    size_t size;                       /* total size of chunks              */
+    size_t chunk_size;                 /* size of next chunk (doubled for   */
+                                       /* each chunk, up to max size)       */
+    int records;                       /* number of records in arena        */
+    int orphan;                        /* 1 if lines were freed: the arena  */
+                                       /* is freed with its last record     */
+};
+
 struct t_gui_line
 {
     struct t_gui_line_data *data;      /* pointer to line data              */
@@ -72,6 +123,33 @@ struct t_gui_lines
     int buffer_max_length_refresh;     /* refresh asked for buffer max len. */
     int prefix_max_length;             /* max length for prefix align       */
     int prefix_max_length_refresh;     /* refresh asked for prefix max len. */
+    struct t_gui_line_arena *arena;    /* arena with data of lines          */
+                                       /* (NULL for mixed lines)            */
+};
+
+struct t_gui_line_tags_cache
+{
+    const char *tag;                   /* tag of a line (shared string)     */
+    unsigned int id;                   /* id of the shared string           */
+    int match;                         /* 1 if tag matches, 0 otherwise     */
+};
+
+struct t_gui_line_tag_compiled
+{
+    int negated;                       /* 1 if tag is negated ("!tag")      */
+    int any;                           /* 1 if tag is "*"                   */
+    char *tag;                         /* tag without "!" (shared string)   */
+    struct t_string_mask *mask;        /* compiled mask (case insensitive)  */
+    struct t_gui_line_tags_cache cache[GUI_LINE_TAGS_CACHE_SIZE];
+                                       /* results of match by id of tag     */
+};
+
+struct t_gui_line_tags_compiled
+{
+    int count;                         /* number of lists of tags           */
+    int *tags_count;                   /* number of tags in each list       */
+    struct t_gui_line_tag_compiled **tags; /* tags: logical "and" in a list,*/
+                                       /* logical "or" between lists        */
 };
 
 /* line functions */
@@ -81,6 +159,25 @@ extern void gui_line_lines_free (struct t_gui_lines *lines);
 extern void gui_line_tags_alloc (struct t_gui_line_data *line_data,
                                  const char *tags);
 extern void gui_line_tags_free (struct t_gui_line_data *line_data);
+extern void gui_line_arena_free (struct t_gui_line_arena *arena);
+extern struct t_gui_line_arena_chunk *gui_line_arena_chunk_new (struct t_gui_line_arena *arena,
+                                                                size_t size);
+extern void gui_line_arena_chunk_free (struct t_gui_line_arena_chunk *chunk);
+extern struct t_gui_line_record *gui_line_record_alloc (struct t_gui_buffer *buffer,
+                                                        size_t size_tail);
+extern struct t_gui_line_record *gui_line_record_get (struct t_gui_line_data *line_data);
+extern void gui_line_record_free (struct t_gui_line_data *line_data);
+extern struct t_gui_line_data *gui_line_data_new (struct t_gui_line_data *line_data);
+extern int gui_line_data_is_inline (struct t_gui_line_data *line_data,
+                                    const void *pointer);
+extern void gui_line_data_free_string (struct t_gui_line_data *line_data,
+                                       char *string);
+extern void gui_line_data_tags_free (struct t_gui_line_data *line_data);
+extern unsigned long long gui_line_malloc_size (size_t size);
+extern void gui_line_arena_get_memory (int *records, int *chunks,
+                                       unsigned long long *size,
+                                       unsigned long long *size_unused,
+                                       unsigned long long *size_unpacked);
 extern void gui_line_get_prefix_for_display (struct t_gui_line *line,
                                              char **prefix, int *length,
                                              char **color, int *prefix_is_nick);
@@ -104,11 +201,18 @@ extern struct t_gui_line *gui_line_search_by_id (struct t_gui_buffer *buffer,
 extern int gui_line_search_text (struct t_gui_buffer *buffer,
                                  struct t_gui_line *line);
 extern int gui_line_match_regex (struct t_gui_line_data *line_data,
-                                 regex_t *regex_prefix,
-                                 regex_t *regex_message);
+                                 struct t_string_regex *regex_prefix,
+                                 struct t_string_regex *regex_message);
 extern int gui_line_has_tag_no_filter (struct t_gui_line_data *line_data);
 extern int gui_line_match_tags (struct t_gui_line_data *line_data,
                                 int tags_count, char ***tags_array);
+extern struct t_gui_line_tags_compiled *gui_line_tags_compile (int tags_count,
+                                                                char ***tags_array);
+extern int gui_line_tag_compiled_match (struct t_gui_line_tag_compiled *tag,
+                                        const char *line_tag);
+extern int gui_line_match_tags_compiled (struct t_gui_line_data *line_data,
+                                         struct t_gui_line_tags_compiled *tags);
+extern void gui_line_tags_compiled_free (struct t_gui_line_tags_compiled *tags);
 extern const char *gui_line_search_tag_starting_with (struct t_gui_line *line,
                                                       const char *tag);
 extern const char *gui_line_get_nick_tag (struct t_gui_line *line);
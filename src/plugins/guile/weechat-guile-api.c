@@ -5294,6 +5294,52 @@ weechat_guile_api_hdata_compare (SCM hdata, SCM pointer1, SCM pointer2,
     API_RETURN_INT(rc);
 }
 
+SCM
+weechat_guile_api_hdata_path_compile (SCM hdata, SCM path)
+{
+    const char *result;
+    SCM return_value;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (!scm_is_string (hdata) || !scm_is_string (path))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    result = API_PTR2STR(
+        weechat_hdata_path_compile (API_STR2PTR(API_SCM_TO_STRING(hdata)),
+                                    API_SCM_TO_STRING(path)));
+
+    API_RETURN_STRING(result);
+}
+
+SCM
+weechat_guile_api_hdata_path_get_value (SCM path, SCM pointer)
+{
+    char *result;
+    SCM return_value;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (!scm_is_string (path) || !scm_is_string (pointer))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    result = weechat_hdata_path_get_value (
+        API_STR2PTR(API_SCM_TO_STRING(path)),
+        API_STR2PTR(API_SCM_TO_STRING(pointer)));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+SCM
+weechat_guile_api_hdata_path_free (SCM path)
+{
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (!scm_is_string (path))
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    weechat_hdata_path_free (API_STR2PTR(API_SCM_TO_STRING(path)));
+
+    API_RETURN_OK;
+}
+
 SCM
 weechat_guile_api_hdata_update (SCM hdata, SCM pointer, SCM hashtable)
 {
@@ -5694,6 +5740,9 @@ weechat_guile_api_module_init (void *data)
     API_DEF_FUNC(hdata_time, 3);
     API_DEF_FUNC(hdata_hashtable, 3);
     API_DEF_FUNC(hdata_compare, 5);
+    API_DEF_FUNC(hdata_path_compile, 2);
+    API_DEF_FUNC(hdata_path_get_value, 2);
+    API_DEF_FUNC(hdata_path_free, 1);
     API_DEF_FUNC(hdata_update, 3);
     API_DEF_FUNC(hdata_get_string, 2);
     API_DEF_FUNC(upgrade_new, 3);
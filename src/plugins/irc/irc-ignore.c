@@ -130,22 +130,16 @@ struct t_irc_ignore *
 irc_ignore_new (const char *mask, const char *server, const char *channel)
 {
     struct t_irc_ignore *new_ignore;
-    regex_t *regex;
+    struct t_string_regex *regex;
 
     if (!mask || !mask[0])
         return NULL;
 
-    regex = malloc (sizeof (*regex));
+    regex = weechat_string_regex_new (mask,
+                                      REG_EXTENDED | REG_ICASE | REG_NOSUB);
     if (!regex)
         return NULL;
 
-    if (weechat_string_regcomp (regex, mask,
-                                REG_EXTENDED | REG_ICASE | REG_NOSUB) != 0)
-    {
-        free (regex);
-        return NULL;
-    }
-
     new_ignore = malloc (sizeof (*new_ignore));
     if (new_ignore)
     {
@@ -225,22 +219,19 @@ irc_ignore_check_host (struct t_irc_ignore *ignore,
 {
     const char *pos;
 
-    if (nick && (regexec (ignore->regex_mask, nick, 0, NULL, 0) == 0))
+    if (nick && weechat_string_regex_match (ignore->regex_mask, nick))
         return 1;
 
     if (host)
     {
-        if (regexec (ignore->regex_mask, host, 0, NULL, 0) == 0)
+        if (weechat_string_regex_match (ignore->regex_mask, host))
             return 1;
 
         if (!strchr (ignore->mask, '!'))
         {
             pos = strchr (host, '!');
-            if (pos && (regexec (ignore->regex_mask, pos + 1,
-                                 0, NULL, 0) == 0))
-            {
+            if (pos && weechat_string_regex_match (ignore->regex_mask, pos + 1))
                 return 1;
-            }
         }
     }
 
@@ -312,11 +303,7 @@ irc_ignore_free (struct t_irc_ignore *ignore)
 
     /* free data */
     free (ignore->mask);
-    if (ignore->regex_mask)
-    {
-        regfree (ignore->regex_mask);
-        free (ignore->regex_mask);
-    }
+    weechat_string_regex_free (ignore->regex_mask);
     free (ignore->server);
     free (ignore->channel);
 
@@ -31,7 +31,7 @@ struct t_irc_ignore
 {
     int number;                        /* ignore number                     */
     char *mask;                        /* nick / host mask                  */
-    regex_t *regex_mask;               /* regex for mask                    */
+    struct t_string_regex *regex_mask; /* regex for mask                    */
     char *server;                      /* server name ("*" == any server)   */
     char *channel;                     /* channel name ("*" == any channel) */
     struct t_irc_ignore *prev_ignore;  /* link to previous ignore           */
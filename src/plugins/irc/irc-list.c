@@ -126,6 +126,36 @@ irc_list_buffer_set_localvar_filter (struct t_gui_buffer *buffer,
                         (server->list->filter) ? server->list->filter : "*");
 }
 
+/*
+ * Compile a mask used to filter channels by name or topic.
+ *
+ * If mask has no "*" inside, the strings containing "mask" are matching.
+ * If mask has at least one "*" inside, it is compiled as-is (see the
+ * function weechat_string_mask_compile).
+ *
+ * Note: result must be freed with weechat_string_mask_free after use.
+ */
+
+struct t_string_mask *
+irc_list_compile_mask (const char *mask)
+{
+    struct t_string_mask *compiled_mask;
+    char *mask2;
+
+    if (!mask)
+        return NULL;
+
+    if (strchr (mask, '*'))
+        return weechat_string_mask_compile (mask, 0);
+
+    if (weechat_asprintf (&mask2, "*%s*", mask) < 0)
+        return NULL;
+    compiled_mask = weechat_string_mask_compile (mask2, 0);
+    free (mask2);
+
+    return compiled_mask;
+}
+
 /*
  * Set filter for list of channels.
  */
@@ -139,9 +169,31 @@ irc_list_set_filter (struct t_irc_server *server, const char *filter)
         server->list->filter = NULL;
     }
 
+    if (server->list->filter_mask)
+    {
+        weechat_string_mask_free (server->list->filter_mask);
+        server->list->filter_mask = NULL;
+    }
+
     server->list->filter = (filter && (strcmp (filter, "*") != 0)) ?
         strdup (filter) : NULL;
 
+    if (server->list->filter)
+    {
+        if ((strncmp (server->list->filter, "n:", 2) == 0)
+            || (strncmp (server->list->filter, "t:", 2) == 0))
+        {
+            server->list->filter_mask = irc_list_compile_mask (
+                server->list->filter + 2);
+        }
+        else if ((strncmp (server->list->filter, "c:", 2) != 0)
+                 && (strncmp (server->list->filter, "u:", 2) != 0))
+        {
+            server->list->filter_mask = irc_list_compile_mask (
+                server->list->filter);
+        }
+    }
+
     irc_list_buffer_set_localvar_filter (server->list->buffer, server);
 }
 
@@ -201,27 +253,6 @@ irc_list_add_channel_in_hashtable (struct t_hashtable *hashtable,
     weechat_hashtable_set (hashtable, "topic", channel->topic);
 }
 
-/*
- * Check if a string matches a mask.
- *
- * If mask has no "*" inside, it just checks if "mask" is inside the "string".
- * If mask has at least one "*" inside, the function weechat_string_match is
- * used.
- *
- * Return:
- *   1: string matches mask
- *   0: string does not match mask
- */
-
-int
-irc_list_string_match (const char *string, const char *mask)
-{
-    if (strchr (mask, '*'))
-        return weechat_string_match (string, mask, 0);
-    else
-        return (weechat_strcasestr (string, mask)) ? 1 : 0;
-}
-
 /*
  * Check if a channel matches filter.
  *
@@ -262,7 +293,8 @@ irc_list_channel_match_filter (struct t_irc_server *server,
     {
         /* filter by channel name */
         if (channel->name
-            && irc_list_string_match (channel->name, server->list->filter + 2))
+            && weechat_string_mask_match (server->list->filter_mask,
+                                          channel->name))
         {
             return 1;
         }
@@ -271,7 +303,8 @@ irc_list_channel_match_filter (struct t_irc_server *server,
     {
         /* filter by topic */
         if (channel->topic
-            && irc_list_string_match (channel->topic, server->list->filter + 2))
+            && weechat_string_mask_match (server->list->filter_mask,
+                                          channel->topic))
         {
             return 1;
         }
@@ -300,12 +333,14 @@ irc_list_channel_match_filter (struct t_irc_server *server,
     else
     {
         if (channel->name
-            && irc_list_string_match (channel->name, server->list->filter))
+            && weechat_string_mask_match (server->list->filter_mask,
+                                          channel->name))
         {
             return 1;
         }
         if (channel->topic
-            && irc_list_string_match (channel->topic, server->list->filter))
+            && weechat_string_mask_match (server->list->filter_mask,
+                                          channel->topic))
         {
             return 1;
         }
@@ -1176,6 +1211,7 @@ irc_list_alloc (void)
     list->filter_channels = NULL;
     list->name_max_length = 0;
     list->filter = NULL;
+    list->filter_mask = NULL;
     list->sort = NULL;
     list->sort_fields = NULL;
     list->sort_fields_count = 0;
@@ -1210,6 +1246,11 @@ irc_list_free_data (struct t_irc_server *server)
         free (server->list->filter);
         server->list->filter = NULL;
     }
+    if (server->list->filter_mask)
+    {
+        weechat_string_mask_free (server->list->filter_mask);
+        server->list->filter_mask = NULL;
+    }
     if (server->list->sort)
     {
         free (server->list->sort);
@@ -1289,6 +1330,7 @@ irc_list_hdata_list_cb (const void *pointer, void *data, const char *hdata_name)
         WEECHAT_HDATA_VAR(struct t_irc_list, filter_channels, POINTER, 0, NULL, NULL);
         WEECHAT_HDATA_VAR(struct t_irc_list, name_max_length, INTEGER, 0, NULL, NULL);
         WEECHAT_HDATA_VAR(struct t_irc_list, filter, STRING, 0, NULL, NULL);
+        WEECHAT_HDATA_VAR(struct t_irc_list, filter_mask, POINTER, 0, NULL, NULL);
         WEECHAT_HDATA_VAR(struct t_irc_list, sort, STRING, 0, NULL, NULL);
         WEECHAT_HDATA_VAR(struct t_irc_list, sort_fields, POINTER, 0, NULL, NULL);
         WEECHAT_HDATA_VAR(struct t_irc_list, sort_fields_count, INTEGER, 0, NULL, NULL);
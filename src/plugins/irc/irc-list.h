@@ -27,6 +27,7 @@
 #define IRC_LIST_MOUSE_HSIGNAL "irc_list_mouse"
 
 struct t_irc_server;
+struct t_string_mask;
 
 struct t_irc_list_channel
 {
@@ -43,12 +44,15 @@ struct t_irc_list
     struct t_arraylist *filter_channels; /* filtered channels               */
     int name_max_length;               /* max length for channel name       */
     char *filter;                      /* filter for channels               */
+    struct t_string_mask *filter_mask; /* compiled mask for filter on name  */
+                                       /* or topic (NULL for other filters) */
     char *sort;                        /* sort for channels                 */
     char **sort_fields;                /* sort fields                       */
     int sort_fields_count;             /* number of sort fields             */
     int selected_line;                 /* selected line                     */
 };
 
+extern struct t_string_mask *irc_list_compile_mask (const char *mask);
 extern void irc_list_buffer_set_title (struct t_irc_server *server);
 extern void irc_list_buffer_refresh (struct t_irc_server *server, int clear);
 extern int irc_list_window_scrolled_cb (const void *pointer, void *data,
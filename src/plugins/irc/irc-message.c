@@ -661,6 +661,8 @@ irc_message_is_empty (const char *message)
 /*
  * Encode/decode an IRC message using a charset.
  *
+ * Return NULL if the modifier is not hooked (no conversion).
+ *
  * Note: result must be freed after use.
  */
 
@@ -671,6 +673,10 @@ irc_message_convert_charset (const char *message, int pos_start,
     char *text, *msg_result;
     int length;
 
+    /* no charset conversion if the modifier is not hooked */
+    if (!weechat_hook_modifier_is_hooked (modifier))
+        return NULL;
+
     text = weechat_hook_modifier_exec (modifier, modifier_data,
                                        message + pos_start);
     if (!text)
@@ -3525,10 +3525,11 @@ irc_server_msgq_flush (void)
                     snprintf (str_modifier, sizeof (str_modifier),
                               "irc_in_%s",
                               (command) ? command : "unknown");
-                    new_msg = weechat_hook_modifier_exec (
-                        str_modifier,
-                        irc_recv_msgq->server->name,
-                        ptr_data);
+                    new_msg = (weechat_hook_modifier_is_hooked (str_modifier)) ?
+                        weechat_hook_modifier_exec (
+                            str_modifier,
+                            irc_recv_msgq->server->name,
+                            ptr_data) : NULL;
                     free (command);
 
                     /* no changes in new message */
@@ -3656,10 +3657,11 @@ irc_server_msgq_flush (void)
                             snprintf (str_modifier, sizeof (str_modifier),
                                       "irc_in2_%s",
                                       (command) ? command : "unknown");
-                            new_msg2 = weechat_hook_modifier_exec (
-                                str_modifier,
-                                irc_recv_msgq->server->name,
-                                ptr_msg2);
+                            new_msg2 = (weechat_hook_modifier_is_hooked (str_modifier)) ?
+                                weechat_hook_modifier_exec (
+                                    str_modifier,
+                                    irc_recv_msgq->server->name,
+                                    ptr_msg2) : NULL;
                             if (new_msg2 && (strcmp (ptr_msg2, new_msg2) == 0))
                             {
                                 free (new_msg2);
@@ -7331,6 +7333,7 @@ irc_server_print_log (void)
             weechat_log_printf ("    buffer. . . . . . . . . : %p", ptr_server->list->buffer);
             weechat_log_printf ("    channels. . . . . . . . : %p", ptr_server->list->channels);
             weechat_log_printf ("    filter_channels . . . . : %p", ptr_server->list->filter_channels);
+            weechat_log_printf ("    filter_mask . . . . . . : %p", ptr_server->list->filter_mask);
         }
         weechat_log_printf ("  last_away_check . . . . . : %lld", (long long)ptr_server->last_away_check);
         weechat_log_printf ("  last_data_purge . . . . . : %lld", (long long)ptr_server->last_data_purge);
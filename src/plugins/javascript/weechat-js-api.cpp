@@ -5231,6 +5231,50 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(rc);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", "ss", API_RETURN_EMPTY);
+
+    v8::String::Utf8Value hdata(args[0]);
+    v8::String::Utf8Value path(args[1]);
+
+    result = API_PTR2STR(
+        weechat_hdata_path_compile (
+            (struct t_hdata *)API_STR2PTR(*hdata),
+            *path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    char *result;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", "ss", API_RETURN_EMPTY);
+
+    v8::String::Utf8Value path(args[0]);
+    v8::String::Utf8Value pointer(args[1]);
+
+    result = weechat_hdata_path_get_value (
+        (struct t_hdata_path *)API_STR2PTR(*path),
+        API_STR2PTR(*pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    API_INIT_FUNC(1, "hdata_path_free", "s", API_RETURN_ERROR);
+
+    v8::String::Utf8Value path(args[0]);
+
+    weechat_hdata_path_free ((struct t_hdata_path *)API_STR2PTR(*path));
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     struct t_hashtable *hashtable;
@@ -5621,6 +5665,9 @@ WeechatJsV8::loadLibs()
     API_DEF_FUNC(hdata_time);
     API_DEF_FUNC(hdata_hashtable);
     API_DEF_FUNC(hdata_compare);
+    API_DEF_FUNC(hdata_path_compile);
+    API_DEF_FUNC(hdata_path_get_value);
+    API_DEF_FUNC(hdata_path_free);
     API_DEF_FUNC(hdata_update);
     API_DEF_FUNC(hdata_get_string);
     API_DEF_FUNC(upgrade_new);
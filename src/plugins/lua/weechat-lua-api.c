@@ -5625,6 +5625,57 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(rc);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    const char *hdata, *path;
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (lua_gettop (L) < 2)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    hdata = lua_tostring (L, -2);
+    path = lua_tostring (L, -1);
+
+    result = API_PTR2STR(weechat_hdata_path_compile (API_STR2PTR(hdata),
+                                                     path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    const char *path, *pointer;
+    char *result;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (lua_gettop (L) < 2)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    path = lua_tostring (L, -2);
+    pointer = lua_tostring (L, -1);
+
+    result = weechat_hdata_path_get_value (API_STR2PTR(path),
+                                           API_STR2PTR(pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    const char *path;
+
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (lua_gettop (L) < 1)
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    path = lua_tostring (L, -1);
+
+    weechat_hdata_path_free (API_STR2PTR(path));
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     const char *hdata, *pointer;
@@ -6006,6 +6057,9 @@ const struct luaL_Reg weechat_lua_api_funcs[] = {
     API_DEF_FUNC(hdata_time),
     API_DEF_FUNC(hdata_hashtable),
     API_DEF_FUNC(hdata_compare),
+    API_DEF_FUNC(hdata_path_compile),
+    API_DEF_FUNC(hdata_path_get_value),
+    API_DEF_FUNC(hdata_path_free),
     API_DEF_FUNC(hdata_update),
     API_DEF_FUNC(hdata_get_string),
     API_DEF_FUNC(upgrade_new),
@@ -5563,6 +5563,56 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(rc);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    char *hdata, *path;
+    const char *result;
+    dXSARGS;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (items < 2)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    hdata = SvPV_nolen (ST (0));
+    path = SvPV_nolen (ST (1));
+
+    result = API_PTR2STR(weechat_hdata_path_compile (API_STR2PTR(hdata),
+                                                     path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    char *path, *pointer, *result;
+    dXSARGS;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (items < 2)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    path = SvPV_nolen (ST (0));
+    pointer = SvPV_nolen (ST (1));
+
+    result = weechat_hdata_path_get_value (API_STR2PTR(path),
+                                           API_STR2PTR(pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    dXSARGS;
+
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (items < 1)
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    weechat_hdata_path_free (API_STR2PTR(SvPV_nolen (ST (0)))); /* path */
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     char *hdata, *pointer;
@@ -5959,6 +6009,9 @@ weechat_perl_api_init (pTHX)
     API_DEF_FUNC(hdata_time);
     API_DEF_FUNC(hdata_hashtable);
     API_DEF_FUNC(hdata_compare);
+    API_DEF_FUNC(hdata_path_compile);
+    API_DEF_FUNC(hdata_path_get_value);
+    API_DEF_FUNC(hdata_path_free);
     API_DEF_FUNC(hdata_update);
     API_DEF_FUNC(hdata_get_string);
     API_DEF_FUNC(upgrade_new);
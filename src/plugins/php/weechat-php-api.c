@@ -5737,6 +5737,63 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(result);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    zend_string *z_hdata, *z_path;
+    struct t_hdata *hdata;
+    char *path;
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (zend_parse_parameters (ZEND_NUM_ARGS(), "SS", &z_hdata,
+                               &z_path) == FAILURE)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    hdata = (struct t_hdata *)API_STR2PTR(ZSTR_VAL(z_hdata));
+    path = ZSTR_VAL(z_path);
+
+    result = API_PTR2STR(weechat_hdata_path_compile (hdata,
+                                                     (const char *)path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    zend_string *z_path, *z_pointer;
+    struct t_hdata_path *path;
+    void *pointer;
+    char *result;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (zend_parse_parameters (ZEND_NUM_ARGS(), "SS", &z_path,
+                               &z_pointer) == FAILURE)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    path = (struct t_hdata_path *)API_STR2PTR(ZSTR_VAL(z_path));
+    pointer = (void *)API_STR2PTR(ZSTR_VAL(z_pointer));
+
+    result = weechat_hdata_path_get_value (path, pointer);
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    zend_string *z_path;
+    struct t_hdata_path *path;
+
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (zend_parse_parameters (ZEND_NUM_ARGS(), "S", &z_path) == FAILURE)
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    path = (struct t_hdata_path *)API_STR2PTR(ZSTR_VAL(z_path));
+
+    weechat_hdata_path_free (path);
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     zend_string *z_hdata, *z_pointer;
@@ -263,6 +263,9 @@ PHP_FUNCTION(weechat_hdata_pointer);
 PHP_FUNCTION(weechat_hdata_time);
 PHP_FUNCTION(weechat_hdata_hashtable);
 PHP_FUNCTION(weechat_hdata_compare);
+PHP_FUNCTION(weechat_hdata_path_compile);
+PHP_FUNCTION(weechat_hdata_path_get_value);
+PHP_FUNCTION(weechat_hdata_path_free);
 PHP_FUNCTION(weechat_hdata_update);
 PHP_FUNCTION(weechat_hdata_get_string);
 PHP_FUNCTION(weechat_upgrade_new);
@@ -321,6 +321,9 @@ const zend_function_entry weechat_functions[] = {
     PHP_FE(weechat_hdata_time, arginfo_weechat_hdata_time)
     PHP_FE(weechat_hdata_hashtable, arginfo_weechat_hdata_hashtable)
     PHP_FE(weechat_hdata_compare, arginfo_weechat_hdata_compare)
+    PHP_FE(weechat_hdata_path_compile, arginfo_weechat_hdata_path_compile)
+    PHP_FE(weechat_hdata_path_get_value, arginfo_weechat_hdata_path_get_value)
+    PHP_FE(weechat_hdata_path_free, arginfo_weechat_hdata_path_free)
     PHP_FE(weechat_hdata_update, arginfo_weechat_hdata_update)
     PHP_FE(weechat_hdata_get_string, arginfo_weechat_hdata_get_string)
     PHP_FE(weechat_upgrade_new, arginfo_weechat_upgrade_new)
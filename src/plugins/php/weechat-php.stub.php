@@ -231,6 +231,9 @@ function weechat_hdata_pointer(string $p0, string $p1, string $p2): string {}
 function weechat_hdata_time(string $p0, string $p1, string $p2): int {}
 function weechat_hdata_hashtable(string $p0, string $p1, string $p2): void {}
 function weechat_hdata_compare(string $p0, string $p1, string $p2, string $p3, int $p4): int {}
+function weechat_hdata_path_compile(string $p0, string $p1): string {}
+function weechat_hdata_path_get_value(string $p0, string $p1): string {}
+function weechat_hdata_path_free(string $p0): int {}
 function weechat_hdata_update(string $p0, string $p1, array $p2): int {}
 function weechat_hdata_get_string(string $p0, string $p1): string {}
 function weechat_upgrade_new(string $p0, mixed $p1, string $p2): string {}
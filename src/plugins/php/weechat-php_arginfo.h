@@ -647,6 +647,12 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_weechat_hdata_compare, 0, 5, IS_
 	ZEND_ARG_TYPE_INFO(0, p4, IS_LONG, 0)
 ZEND_END_ARG_INFO()
 
+#define arginfo_weechat_hdata_path_compile arginfo_weechat_iconv_to_internal
+
+#define arginfo_weechat_hdata_path_get_value arginfo_weechat_iconv_to_internal
+
+#define arginfo_weechat_hdata_path_free arginfo_weechat_charset_set
+
 #define arginfo_weechat_hdata_update arginfo_weechat_command_options
 
 #define arginfo_weechat_hdata_get_string arginfo_weechat_iconv_to_internal
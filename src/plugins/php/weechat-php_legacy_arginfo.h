@@ -469,6 +469,12 @@ ZEND_END_ARG_INFO()
 
 #define arginfo_weechat_hdata_compare arginfo_weechat_print_datetime_tags
 
+#define arginfo_weechat_hdata_path_compile arginfo_weechat_iconv_to_internal
+
+#define arginfo_weechat_hdata_path_get_value arginfo_weechat_iconv_to_internal
+
+#define arginfo_weechat_hdata_path_free arginfo_weechat_plugin_get_name
+
 #define arginfo_weechat_hdata_update arginfo_weechat_ngettext
 
 #define arginfo_weechat_hdata_get_string arginfo_weechat_iconv_to_internal
@@ -34,6 +34,7 @@
 #include "../core/weechat.h"
 #include "../core/core-config.h"
 #include "../core/core-crypto.h"
+#include "../core/core-debug.h"
 #include "../core/core-hashtable.h"
 #include "../core/core-hook.h"
 #include "../core/core-infolist.h"
@@ -1046,6 +1047,23 @@ plugin_api_info_uptime_current_cb (const void *pointer, void *data,
         arguments);
 }
 
+/*
+ * Return WeeChat info "weechat_loop": stats of main loop.
+ */
+
+char *
+plugin_api_info_weechat_loop_cb (const void *pointer, void *data,
+                                 const char *info_name,
+                                 const char *arguments)
+{
+    /* make C compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) info_name;
+
+    return debug_loop_get_info (arguments);
+}
+
 /*
  * Return WeeChat info "totp_generate": generates a Time-based One-Time
  * Password (TOTP).
@@ -2287,6 +2305,16 @@ plugin_api_info_init (void)
                N_("\"days\" (number of days) or \"seconds\" (number of "
                   "seconds) (optional)"),
                &plugin_api_info_uptime_current_cb, NULL, NULL);
+    hook_info (NULL, "weechat_loop",
+               N_("stats of main loop, enabled with command "
+                  "\"/debug loop enable\" (times are in microseconds)"),
+               N_("name of stat (optional, all stats are returned by default "
+                  "with format \"name=value,name=value,...\"): \"enabled\", "
+                  "\"stall\", \"iterations\", \"stalls\" or "
+                  "\"<phase>_count\", \"<phase>_total\", \"<phase>_avg\", "
+                  "\"<phase>_max\" where phase is one of: timer, refresh, fd, "
+                  "process, signal, wait, iteration, timer_lateness"),
+               &plugin_api_info_weechat_loop_cb, NULL, NULL);
     hook_info (NULL, "totp_generate",
                N_("generate a Time-based One-Time Password (TOTP)"),
                N_("secret (in base32), timestamp (optional, current time by "
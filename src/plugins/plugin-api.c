@@ -98,6 +98,20 @@ plugin_api_ngettext (const char *single, const char *plural, int count)
     return NG_(single, plural, count);
 }
 
+/*
+ * Free a regex allocated with function string_regex_new.
+ */
+
+void
+plugin_api_string_regex_free (struct t_string_regex *regex)
+{
+    if (!regex)
+        return;
+
+    string_regex_free (regex);
+    free (regex);
+}
+
 /*
  * Compute hash of data using the given algorithm.
  *
@@ -769,6 +783,8 @@ plugin_api_init (void)
                 &hook_print_hdata_hook_print_cb, NULL, NULL);
     hook_hdata (NULL, "hook_process", N_("hook \"process\""),
                 &hook_process_hdata_hook_process_cb, NULL, NULL);
+    hook_hdata (NULL, "hook_profile", N_("profiling data of hook"),
+                &hook_hdata_hook_profile_cb, NULL, NULL);
     hook_hdata (NULL, "hook_signal", N_("hook \"signal\""),
                 &hook_signal_hdata_hook_signal_cb, NULL, NULL);
     hook_hdata (NULL, "hook_timer", N_("hook \"timer\""),
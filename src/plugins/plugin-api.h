@@ -32,6 +32,7 @@ extern const char *plugin_api_ngettext (const char *single, const char *plural,
                                         int count);
 
 /* crypto */
+extern void plugin_api_string_regex_free (struct t_string_regex *regex);
 extern int plugin_api_crypto_hash (const void *data, int data_size,
                                    const char *hash_algo,
                                    void *hash, int *hash_size);
@@ -630,6 +630,9 @@ plugin_load (const char *filename, int init_plugin, int argc, char **argv)
         new_plugin->strlen_screen = &gui_chat_strlen_screen;
         new_plugin->string_match = &string_match;
         new_plugin->string_match_list = &string_match_list;
+        new_plugin->string_mask_compile = &string_mask_compile;
+        new_plugin->string_mask_match = &string_mask_match;
+        new_plugin->string_mask_free = &string_mask_free;
         new_plugin->string_replace = &string_replace;
         new_plugin->string_expand_home = &string_expand_home;
         new_plugin->string_eval_path_home = &string_eval_path_home;
@@ -639,6 +642,9 @@ plugin_load (const char *filename, int init_plugin, int argc, char **argv)
         new_plugin->string_mask_to_regex = &string_mask_to_regex;
         new_plugin->string_regex_flags = &string_regex_flags;
         new_plugin->string_regcomp = &string_regcomp;
+        new_plugin->string_regex_new = &string_regex_new;
+        new_plugin->string_regex_match = &string_regex_match;
+        new_plugin->string_regex_free = &plugin_api_string_regex_free;
         new_plugin->string_has_highlight = &string_has_highlight;
         new_plugin->string_has_highlight_regex = &string_has_highlight_regex;
         new_plugin->string_replace_regex = &string_replace_regex;
@@ -832,6 +838,7 @@ plugin_load (const char *filename, int init_plugin, int argc, char **argv)
         new_plugin->hook_completion_list_add = &gui_completion_list_add;
         new_plugin->hook_modifier = &hook_modifier;
         new_plugin->hook_modifier_exec = &hook_modifier_exec;
+        new_plugin->hook_modifier_is_hooked = &hook_modifier_is_hooked;
         new_plugin->hook_info = &hook_info;
         new_plugin->hook_info_hashtable = &hook_info_hashtable;
         new_plugin->hook_infolist = &hook_infolist;
@@ -953,6 +960,10 @@ plugin_load (const char *filename, int init_plugin, int argc, char **argv)
         new_plugin->hdata_time = &hdata_time;
         new_plugin->hdata_hashtable = &hdata_hashtable;
         new_plugin->hdata_compare = &hdata_compare;
+        new_plugin->hdata_path_compile = &hdata_path_compile;
+        new_plugin->hdata_path_get_var = &hdata_path_get_var;
+        new_plugin->hdata_path_get_value = &hdata_path_get_value;
+        new_plugin->hdata_path_free = &hdata_path_free;
         new_plugin->hdata_set = &hdata_set;
         new_plugin->hdata_update = &hdata_update;
         new_plugin->hdata_get_string = &hdata_get_string;
@@ -5508,6 +5508,54 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(rc);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    char *hdata, *path;
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    hdata = NULL;
+    path = NULL;
+    if (!PyArg_ParseTuple (args, "ss", &hdata, &path))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    result = API_PTR2STR(weechat_hdata_path_compile (API_STR2PTR(hdata),
+                                                     path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    char *path, *pointer, *result;
+    PyObject *return_value;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    path = NULL;
+    pointer = NULL;
+    if (!PyArg_ParseTuple (args, "ss", &path, &pointer))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    result = weechat_hdata_path_get_value (API_STR2PTR(path),
+                                           API_STR2PTR(pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    char *path;
+
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    path = NULL;
+    if (!PyArg_ParseTuple (args, "s", &path))
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    weechat_hdata_path_free (API_STR2PTR(path));
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     char *hdata, *pointer;
@@ -5886,6 +5934,9 @@ PyMethodDef weechat_python_funcs[] =
     API_DEF_FUNC(hdata_time),
     API_DEF_FUNC(hdata_hashtable),
     API_DEF_FUNC(hdata_compare),
+    API_DEF_FUNC(hdata_path_compile),
+    API_DEF_FUNC(hdata_path_get_value),
+    API_DEF_FUNC(hdata_path_free),
     API_DEF_FUNC(hdata_update),
     API_DEF_FUNC(hdata_get_string),
     API_DEF_FUNC(upgrade_new),
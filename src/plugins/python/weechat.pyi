@@ -2833,6 +2833,38 @@ def hdata_compare(hdata: str, pointer1: str, pointer2: str, name: str, case_sens
     ...
 
 
+def hdata_path_compile(hdata: str, path: str) -> str:
+    """`hdata_path_compile in WeeChat plugin API reference <https://weechat.org/doc/weechat/api/#_hdata_path_compile>`_
+    ::
+
+        # example
+        path = weechat.hdata_path_compile(weechat.hdata_get("window"), "buffer.full_name")
+    """
+    ...
+
+
+def hdata_path_get_value(path: str, pointer: str) -> str:
+    """`hdata_path_get_value in WeeChat plugin API reference <https://weechat.org/doc/weechat/api/#_hdata_path_get_value>`_
+    ::
+
+        # example
+        path = weechat.hdata_path_compile(weechat.hdata_get("window"), "buffer.full_name")
+        weechat.prnt("", "buffer in window: %s" % weechat.hdata_path_get_value(path, weechat.current_window()))
+        weechat.hdata_path_free(path)
+    """
+    ...
+
+
+def hdata_path_free(path: str) -> int:
+    """`hdata_path_free in WeeChat plugin API reference <https://weechat.org/doc/weechat/api/#_hdata_path_free>`_
+    ::
+
+        # example
+        weechat.hdata_path_free(path)
+    """
+    ...
+
+
 def hdata_update(hdata: str, pointer: str, hashtable: Dict[str, str]) -> int:
     """`hdata_update in WeeChat plugin API reference <https://weechat.org/doc/weechat/api/#_hdata_update>`_
     ::
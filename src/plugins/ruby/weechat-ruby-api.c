@@ -6814,6 +6814,68 @@ weechat_ruby_api_hdata_compare (VALUE class, VALUE hdata,
     API_RETURN_INT(rc);
 }
 
+static VALUE
+weechat_ruby_api_hdata_path_compile (VALUE class, VALUE hdata, VALUE path)
+{
+    char *c_hdata, *c_path;
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (NIL_P (hdata) || NIL_P (path))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    Check_Type (hdata, T_STRING);
+    Check_Type (path, T_STRING);
+
+    c_hdata = StringValuePtr (hdata);
+    c_path = StringValuePtr (path);
+
+    result = API_PTR2STR(weechat_hdata_path_compile (API_STR2PTR(c_hdata),
+                                                     c_path));
+
+    API_RETURN_STRING(result);
+}
+
+static VALUE
+weechat_ruby_api_hdata_path_get_value (VALUE class, VALUE path, VALUE pointer)
+{
+    char *c_path, *c_pointer, *result;
+    VALUE return_value;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (NIL_P (path) || NIL_P (pointer))
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    Check_Type (path, T_STRING);
+    Check_Type (pointer, T_STRING);
+
+    c_path = StringValuePtr (path);
+    c_pointer = StringValuePtr (pointer);
+
+    result = weechat_hdata_path_get_value (API_STR2PTR(c_path),
+                                           API_STR2PTR(c_pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+static VALUE
+weechat_ruby_api_hdata_path_free (VALUE class, VALUE path)
+{
+    char *c_path;
+
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (NIL_P (path))
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    Check_Type (path, T_STRING);
+
+    c_path = StringValuePtr (path);
+
+    weechat_hdata_path_free (API_STR2PTR(c_path));
+
+    API_RETURN_OK;
+}
+
 static VALUE
 weechat_ruby_api_hdata_update (VALUE class, VALUE hdata, VALUE pointer,
                                VALUE hashtable)
@@ -7239,6 +7301,9 @@ weechat_ruby_api_init (VALUE ruby_mWeechat)
     API_DEF_FUNC(hdata_time, 3);
     API_DEF_FUNC(hdata_hashtable, 3);
     API_DEF_FUNC(hdata_compare, 5);
+    API_DEF_FUNC(hdata_path_compile, 2);
+    API_DEF_FUNC(hdata_path_get_value, 2);
+    API_DEF_FUNC(hdata_path_free, 1);
     API_DEF_FUNC(hdata_update, 3);
     API_DEF_FUNC(hdata_get_string, 2);
     API_DEF_FUNC(upgrade_new, 3);
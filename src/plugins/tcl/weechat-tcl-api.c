@@ -5548,6 +5548,52 @@ API_FUNC(hdata_compare)
     API_RETURN_INT(rc);
 }
 
+API_FUNC(hdata_path_compile)
+{
+    char *hdata, *path;
+    const char *result;
+
+    API_INIT_FUNC(1, "hdata_path_compile", API_RETURN_EMPTY);
+    if (objc < 3)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    hdata = Tcl_GetString (objv[1]);
+    path = Tcl_GetString (objv[2]);
+
+    result = API_PTR2STR(weechat_hdata_path_compile (API_STR2PTR(hdata),
+                                                     path));
+
+    API_RETURN_STRING(result);
+}
+
+API_FUNC(hdata_path_get_value)
+{
+    char *path, *pointer, *result;
+
+    API_INIT_FUNC(1, "hdata_path_get_value", API_RETURN_EMPTY);
+    if (objc < 3)
+        API_WRONG_ARGS(API_RETURN_EMPTY);
+
+    path = Tcl_GetString (objv[1]);
+    pointer = Tcl_GetString (objv[2]);
+
+    result = weechat_hdata_path_get_value (API_STR2PTR(path),
+                                           API_STR2PTR(pointer));
+
+    API_RETURN_STRING_FREE(result);
+}
+
+API_FUNC(hdata_path_free)
+{
+    API_INIT_FUNC(1, "hdata_path_free", API_RETURN_ERROR);
+    if (objc < 2)
+        API_WRONG_ARGS(API_RETURN_ERROR);
+
+    weechat_hdata_path_free (API_STR2PTR(Tcl_GetString (objv[1]))); /* path */
+
+    API_RETURN_OK;
+}
+
 API_FUNC(hdata_update)
 {
     char *hdata, *pointer;
@@ -5962,6 +6008,9 @@ void weechat_tcl_api_init (Tcl_Interp *interp)
     API_DEF_FUNC(hdata_time);
     API_DEF_FUNC(hdata_hashtable);
     API_DEF_FUNC(hdata_compare);
+    API_DEF_FUNC(hdata_path_compile);
+    API_DEF_FUNC(hdata_path_get_value);
+    API_DEF_FUNC(hdata_path_free);
     API_DEF_FUNC(hdata_update);
     API_DEF_FUNC(hdata_get_string);
     API_DEF_FUNC(upgrade_new);
@@ -289,7 +289,7 @@ trigger_callback_check_conditions (struct t_trigger *trigger,
 char *
 trigger_callback_regex_replace (struct t_trigger_context *context,
                                 const char *text,
-                                regex_t *regex,
+                                struct t_string_regex *regex,
                                 const char *replace)
 {
     char *value;
@@ -304,7 +304,7 @@ trigger_callback_regex_replace (struct t_trigger_context *context,
         WEECHAT_HASHTABLE_STRING,
         NULL, NULL);
 
-    weechat_hashtable_set (context->pointers, "regex", regex);
+    weechat_hashtable_set (context->pointers, "string_regex", regex);
     weechat_hashtable_set (hashtable_options_regex,
                            "regex_replace", replace);
 
@@ -486,7 +486,7 @@ trigger_callback_regex (struct t_trigger *trigger,
     }
     else
     {
-        weechat_hashtable_remove (context->pointers, "regex");
+        weechat_hashtable_remove (context->pointers, "string_regex");
     }
 }
 
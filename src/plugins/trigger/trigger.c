@@ -615,11 +615,7 @@ trigger_regex_free (int *regex_count, struct t_trigger_regex **regex)
         {
             free ((*regex)[i].variable);
             free ((*regex)[i].str_regex);
-            if ((*regex)[i].regex)
-            {
-                regfree ((*regex)[i].regex);
-                free ((*regex)[i].regex);
-            }
+            weechat_string_regex_free ((*regex)[i].regex);
             free ((*regex)[i].replace);
             free ((*regex)[i].replace_escaped);
         }
@@ -745,17 +741,10 @@ trigger_regex_split (const char *str_regex,
             str_regex_escaped = weechat_string_convert_escaped_chars ((*regex)[index].str_regex);
             if (!str_regex_escaped)
                 goto memory_error;
-            (*regex)[index].regex = malloc (sizeof (*(*regex)[index].regex));
+            (*regex)[index].regex = weechat_string_regex_new (
+                str_regex_escaped, REG_EXTENDED | REG_ICASE);
             if (!(*regex)[index].regex)
-                goto memory_error;
-            if (weechat_string_regcomp ((*regex)[index].regex,
-                                        str_regex_escaped,
-                                        REG_EXTENDED | REG_ICASE) != 0)
-            {
-                free ((*regex)[index].regex);
-                (*regex)[index].regex = NULL;
                 goto compile_error;
-            }
         }
 
         /* set replace */
@@ -95,7 +95,7 @@ struct t_trigger_regex
     enum t_trigger_regex_command command; /* regex command                  */
     char *variable;                    /* the hashtable key used            */
     char *str_regex;                   /* regex to search for replacement   */
-    regex_t *regex;                    /* compiled regex                    */
+    struct t_string_regex *regex;      /* compiled regex                    */
     char *replace;                     /* replacement text                  */
     char *replace_escaped;             /* repl. text (with chars escaped)   */
 };
@@ -60,8 +60,11 @@ struct t_gui_nick_group;
 struct t_gui_window;
 struct t_hashtable;
 struct t_hdata;
+struct t_hdata_path;
 struct t_infolist;
 struct t_infolist_item;
+struct t_string_mask;
+struct t_string_regex;
 struct t_theme;
 struct t_upgrade_file;
 struct t_weelist;
@@ -77,7 +80,7 @@ struct t_weelist_item;
  * please change the date with current one; for a second change at same
  * date, increment the 01, otherwise please keep 01.
  */
-#define WEECHAT_PLUGIN_API_VERSION "20260704-03"
+#define WEECHAT_PLUGIN_API_VERSION "20261016-06"
 
 /* macros for defining plugin infos */
 #define WEECHAT_PLUGIN_NAME(__name)                                     \
@@ -357,6 +360,10 @@ struct t_weechat_plugin
                          int case_sensitive);
     int (*string_match_list) (const char *string, const char **masks,
                               int case_sensitive);
+    struct t_string_mask *(*string_mask_compile) (const char *mask,
+                                                  int case_sensitive);
+    int (*string_mask_match) (struct t_string_mask *mask, const char *string);
+    void (*string_mask_free) (struct t_string_mask *mask);
     char *(*string_replace) (const char *string, const char *search,
                              const char *replace);
     char *(*string_expand_home) (const char *path);
@@ -372,6 +379,11 @@ struct t_weechat_plugin
     const char *(*string_regex_flags) (const char *regex, int default_flags,
                                        int *flags);
     int (*string_regcomp) (void *preg, const char *regex, int default_flags);
+    struct t_string_regex *(*string_regex_new) (const char *regex,
+                                                int default_flags);
+    int (*string_regex_match) (struct t_string_regex *regex,
+                               const char *string);
+    void (*string_regex_free) (struct t_string_regex *regex);
     int (*string_has_highlight) (const char *string,
                                  const char *highlight_words);
     int (*string_has_highlight_regex) (const char *string, const char *regex);
@@ -932,6 +944,7 @@ struct t_weechat_plugin
                                  const char *modifier,
                                  const char *modifier_data,
                                  const char *string);
+    int (*hook_modifier_is_hooked) (const char *modifier);
     struct t_hook *(*hook_info) (struct t_weechat_plugin *plugin,
                                  const char *info_name,
                                  const char *description,
@@ -1269,6 +1282,11 @@ struct t_weechat_plugin
     int (*hdata_compare) (struct t_hdata *hdata,
                           void *pointer1, void *pointer2, const char *name,
                           int case_sensitive);
+    struct t_hdata_path *(*hdata_path_compile) (struct t_hdata *hdata,
+                                                const char *path);
+    void *(*hdata_path_get_var) (struct t_hdata_path *path, void *pointer);
+    char *(*hdata_path_get_value) (struct t_hdata_path *path, void *pointer);
+    void (*hdata_path_free) (struct t_hdata_path *path);
     int (*hdata_set) (struct t_hdata *hdata, void *pointer, const char *name,
                       const char *value);
     int (*hdata_update) (struct t_hdata *hdata, void *pointer,
@@ -1371,6 +1389,12 @@ extern int weechat_plugin_end (struct t_weechat_plugin *plugin);
 #define weechat_string_match_list(__string, __masks, __case_sensitive)  \
     (weechat_plugin->string_match_list)(__string, __masks,              \
                                         __case_sensitive)
+#define weechat_string_mask_compile(__mask, __case_sensitive)           \
+    (weechat_plugin->string_mask_compile)(__mask, __case_sensitive)
+#define weechat_string_mask_match(__mask, __string)                     \
+    (weechat_plugin->string_mask_match)(__mask, __string)
+#define weechat_string_mask_free(__mask)                                \
+    (weechat_plugin->string_mask_free)(__mask)
 #define weechat_string_replace(__string, __search, __replace)           \
     (weechat_plugin->string_replace)(__string, __search, __replace)
 #define weechat_string_expand_home(__path)                              \
@@ -1392,6 +1416,12 @@ extern int weechat_plugin_end (struct t_weechat_plugin *plugin);
                                          __flags)
 #define weechat_string_regcomp(__preg, __regex, __default_flags)        \
     (weechat_plugin->string_regcomp)(__preg, __regex, __default_flags)
+#define weechat_string_regex_new(__regex, __default_flags)              \
+    (weechat_plugin->string_regex_new)(__regex, __default_flags)
+#define weechat_string_regex_match(__regex, __string)                   \
+    (weechat_plugin->string_regex_match)(__regex, __string)
+#define weechat_string_regex_free(__regex)                              \
+    (weechat_plugin->string_regex_free)(__regex)
 #define weechat_string_has_highlight(__string, __highlight_words)       \
     (weechat_plugin->string_has_highlight)(__string, __highlight_words)
 #define weechat_string_has_highlight_regex(__string, __regex)           \
@@ -2011,6 +2041,8 @@ extern int weechat_plugin_end (struct t_weechat_plugin *plugin);
                                    __string)                            \
     (weechat_plugin->hook_modifier_exec)(weechat_plugin, __modifier,    \
                                          __modifier_data, __string)
+#define weechat_hook_modifier_is_hooked(__modifier)                     \
+    (weechat_plugin->hook_modifier_is_hooked)(__modifier)
 #define weechat_hook_info(__info_name, __description,                   \
                           __args_description, __callback, __pointer,    \
                           __data)                                       \
@@ -2398,6 +2430,14 @@ extern int weechat_plugin_end (struct t_weechat_plugin *plugin);
                               __case_sensitive)                         \
     (weechat_plugin->hdata_compare)(__hdata, __pointer1, __pointer2,    \
                                     __name, __case_sensitive)
+#define weechat_hdata_path_compile(__hdata, __path)                     \
+    (weechat_plugin->hdata_path_compile)(__hdata, __path)
+#define weechat_hdata_path_get_var(__path, __pointer)                   \
+    (weechat_plugin->hdata_path_get_var)(__path, __pointer)
+#define weechat_hdata_path_get_value(__path, __pointer)                 \
+    (weechat_plugin->hdata_path_get_value)(__path, __pointer)
+#define weechat_hdata_path_free(__path)                                 \
+    (weechat_plugin->hdata_path_free)(__path)
 #define weechat_hdata_set(__hdata, __pointer, __name, __value)          \
     (weechat_plugin->hdata_set)(__hdata, __pointer, __name, __value)
 #define weechat_hdata_update(__hdata, __pointer, __hashtable)           \
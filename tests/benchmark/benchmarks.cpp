@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Run WeeChat benchmarks */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C"
+{
+#ifndef HAVE_CONFIG_H
+#define HAVE_CONFIG_H
+#endif
+#include "src/core/weechat.h"
+#include "src/core/core-dir.h"
+#include "src/core/core-string.h"
+#include "src/gui/gui-main.h"
+#include "src/gui/gui-chat.h"
+
+    extern void gui_main_init ();
+}
+
+#include "CppUTest/CommandLineTestRunner.h"
+
+#define LOCALE_BENCHMARKS "en_US.UTF-8"
+
+#define WEECHAT_BENCHMARKS_HOME "./tmp_weechat_benchmark"
+
+
+/*
+ * Callback for exec_on_files (to remove all files in WeeChat home directory).
+ */
+
+void
+exec_on_files_cb (void *data, const char *filename)
+{
+    /* make C++ compiler happy */
+    (void) data;
+
+    unlink (filename);
+}
+
+/*
+ * Initialize GUI for benchmarks.
+ */
+
+void
+benchmark_gui_init ()
+{
+    /*
+     * Call the function "gui_main_init" from Curses sources (all Curses
+     * calls are made with the fake ncurses library).
+     */
+    gui_main_init ();
+}
+
+/*
+ * Run benchmarks in WeeChat environment (without plugins).
+ */
+
+int
+main (int argc, char *argv[])
+{
+    int rc, weechat_argc;
+    char args[1024], **weechat_argv;
+
+    /* setup environment: English language, no specific timezone */
+    setenv ("LC_ALL", LOCALE_BENCHMARKS, 1);
+    setenv ("TZ", "", 1);
+
+    /* check if locale exists */
+    if (!setlocale (LC_ALL, ""))
+    {
+        fprintf (stderr,
+                 "ERROR: the locale %s must be installed to run WeeChat "
+                 "benchmarks.\n",
+                 LOCALE_BENCHMARKS);
+        return 1;
+    }
+
+    /* clean WeeChat home */
+    dir_exec_on_files (WEECHAT_BENCHMARKS_HOME, 1, 1, &exec_on_files_cb, NULL);
+
+    /* init WeeChat (no plugins are loaded) */
+    snprintf (args, sizeof (args),
+              "%s --dir %s -p", argv[0], WEECHAT_BENCHMARKS_HOME);
+    weechat_argv = string_split_shell (args, &weechat_argc);
+    weechat_init_gettext ();
+    weechat_init (weechat_argc, weechat_argv, &benchmark_gui_init);
+    if (weechat_argv)
+        string_free_split (weechat_argv);
+
+    /* run all benchmarks */
+    rc = CommandLineTestRunner::RunAllTests (argc, argv);
+
+    /* end WeeChat */
+    gui_chat_mute = GUI_CHAT_MUTE_ALL_BUFFERS;
+    weechat_end (&gui_main_end);
+
+    return rc;
+}
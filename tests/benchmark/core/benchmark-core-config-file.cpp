@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark configuration files functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "src/core/weechat.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-string.h"
+#include "src/core/core-util.h"
+#include "src/plugins/plugin.h"
+}
+
+TEST_GROUP(BenchmarkCoreConfigFile)
+{
+};
+
+/*
+ * Benchmark of write of a configuration file with a lot of options: first
+ * write, write with no changes and write with one option changed.
+ */
+
+TEST(BenchmarkCoreConfigFile, Write)
+{
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section;
+    struct t_config_option *ptr_option;
+    char name[128], *filename;
+    struct timeval time_start, time_end;
+    long long time_write, time_unchanged, time_changed;
+    int i;
+
+    ptr_config = config_file_new (NULL, "test_write_bench", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section = config_file_new_section (ptr_config, "server",
+                                           0, 0,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL);
+    CHECK(ptr_section);
+    ptr_option = NULL;
+    for (i = 0; i < 50000; i++)
+    {
+        snprintf (name, sizeof (name), "server%05d.option", i);
+        ptr_option = config_file_new_option (
+            ptr_config, ptr_section,
+            name, "string", "", NULL, 0, 0, "default value", NULL, 0,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL);
+        CHECK(ptr_option);
+    }
+
+    string_asprintf (&filename, "%s/test_write_bench.conf",
+                     weechat_config_dir);
+    unlink (filename);
+
+    gettimeofday (&time_start, NULL);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    gettimeofday (&time_end, NULL);
+    time_write = util_timeval_diff (&time_start, &time_end);
+
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 100; i++)
+    {
+        LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    }
+    gettimeofday (&time_end, NULL);
+    time_unchanged = util_timeval_diff (&time_start, &time_end) / 100;
+
+    config_file_option_set (ptr_option, "new value", 1);
+    gettimeofday (&time_start, NULL);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    gettimeofday (&time_end, NULL);
+    time_changed = util_timeval_diff (&time_start, &time_end);
+
+    printf ("\n>>> write of 50000 options: first write: %lld us, "
+            "unchanged: %lld us, one option changed: %lld us\n",
+            time_write, time_unchanged, time_changed);
+
+    config_file_free (ptr_config);
+    unlink (filename);
+    free (filename);
+}
+
+/*
+ * Benchmark of read of a configuration file with a lot of options (time
+ * measured by config_file_read).
+ */
+
+TEST(BenchmarkCoreConfigFile, Read)
+{
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section;
+    struct t_config_option *ptr_option;
+    char name[128], *filename;
+    int i;
+
+    ptr_config = config_file_new (NULL, "test_read_bench", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section = config_file_new_section (ptr_config, "server",
+                                           0, 0,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL);
+    CHECK(ptr_section);
+    ptr_option = NULL;
+    for (i = 0; i < 50000; i++)
+    {
+        snprintf (name, sizeof (name), "server%05d.option", i);
+        ptr_option = config_file_new_option (
+            ptr_config, ptr_section,
+            name, "string", "", NULL, 0, 0, "default value", NULL, 0,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL);
+        CHECK(ptr_option);
+        config_file_option_set (ptr_option, "value", 1);
+    }
+
+    string_asprintf (&filename, "%s/test_read_bench.conf",
+                     weechat_config_dir);
+    unlink (filename);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+
+    config_file_option_reset (ptr_option, 1);
+    LONGS_EQUAL(WEECHAT_CONFIG_READ_OK, config_file_read (ptr_config));
+    STRCMP_EQUAL("value", CONFIG_STRING(ptr_option));
+
+    printf ("\n>>> read of 50000 options: %d lines, %lld bytes, %lld us\n",
+            ptr_config->read_lines, ptr_config->read_size,
+            ptr_config->read_time);
+
+    config_file_free (ptr_config);
+    unlink (filename);
+    free (filename);
+}
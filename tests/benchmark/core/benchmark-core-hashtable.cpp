@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark hashtable functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include "src/core/core-hashtable.h"
+#include "src/core/core-util.h"
+#include "src/plugins/plugin.h"
+}
+
+#define BENCHMARK_HASHTABLE_MESSAGES 20000
+#define BENCHMARK_HASHTABLE_POINTERS 10000
+
+TEST_GROUP(BenchmarkCoreHashtable)
+{
+};
+
+/*
+ * Runs the "string -> string" benchmark: a short-lived hashtable per
+ * message (like hashtables sent to hook_line, hsignal or used for parsed
+ * IRC messages).
+ *
+ * Returns the time elapsed (in milliseconds).
+ */
+
+long long
+benchmark_hashtable_string (enum t_hashtable_backend backend)
+{
+    const char *keys[] = { "buffer", "buffer_name", "buffer_type", "y",
+                           "date", "date_usec", "date_printed", "str_time",
+                           "tags", "displayed", "notify_level", "highlight",
+                           "prefix", "message", "message_without_tags", NULL };
+    struct t_hashtable *hashtable;
+    struct timeval time_start, time_end;
+    int i, j, found;
+
+    found = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_HASHTABLE_MESSAGES; i++)
+    {
+        hashtable = (backend == HASHTABLE_BACKEND_COMPACT) ?
+            hashtable_new_compact (32,
+                                   WEECHAT_HASHTABLE_STRING,
+                                   WEECHAT_HASHTABLE_STRING,
+                                   NULL, NULL) :
+            hashtable_new (32,
+                           WEECHAT_HASHTABLE_STRING,
+                           WEECHAT_HASHTABLE_STRING,
+                           NULL, NULL);
+        for (j = 0; keys[j]; j++)
+        {
+            hashtable_set (hashtable, keys[j], "some value for the key");
+        }
+        for (j = 0; keys[j]; j++)
+        {
+            if (hashtable_get (hashtable, keys[j]))
+                found++;
+            if (hashtable_has_key (hashtable, "unknown"))
+                found++;
+        }
+        hashtable_free (hashtable);
+    }
+    gettimeofday (&time_end, NULL);
+
+    LONGS_EQUAL(BENCHMARK_HASHTABLE_MESSAGES * 15, found);
+
+    return util_timeval_diff (&time_start, &time_end) / 1000;
+}
+
+/*
+ * Runs the "pointer -> pointer" benchmark: a long-lived hashtable indexing
+ * pointers (like index of hooks or buffers by id).
+ *
+ * Returns the time elapsed (in milliseconds).
+ */
+
+long long
+benchmark_hashtable_pointer (enum t_hashtable_backend backend)
+{
+    struct t_hashtable *hashtable;
+    struct timeval time_start, time_end;
+    char *pointers;
+    int i, j, found;
+
+    pointers = (char *)malloc (BENCHMARK_HASHTABLE_POINTERS * 64);
+
+    found = 0;
+    gettimeofday (&time_start, NULL);
+    hashtable = (backend == HASHTABLE_BACKEND_COMPACT) ?
+        hashtable_new_compact (32,
+                               WEECHAT_HASHTABLE_POINTER,
+                               WEECHAT_HASHTABLE_POINTER,
+                               NULL, NULL) :
+        hashtable_new (32,
+                       WEECHAT_HASHTABLE_POINTER,
+                       WEECHAT_HASHTABLE_POINTER,
+                       NULL, NULL);
+    for (i = 0; i < BENCHMARK_HASHTABLE_POINTERS; i++)
+    {
+        hashtable_set (hashtable, pointers + (i * 64), pointers);
+    }
+    for (j = 0; j < 50; j++)
+    {
+        for (i = 0; i < BENCHMARK_HASHTABLE_POINTERS; i++)
+        {
+            if (hashtable_get (hashtable, pointers + (i * 64)))
+                found++;
+        }
+    }
+    for (i = 0; i < BENCHMARK_HASHTABLE_POINTERS; i++)
+    {
+        hashtable_remove (hashtable, pointers + (i * 64));
+    }
+    hashtable_free (hashtable);
+    gettimeofday (&time_end, NULL);
+
+    free (pointers);
+
+    LONGS_EQUAL(BENCHMARK_HASHTABLE_POINTERS * 50, found);
+
+    return util_timeval_diff (&time_start, &time_end) / 1000;
+}
+
+/*
+ * Benchmark of backends: chained vs compact.
+ */
+
+TEST(BenchmarkCoreHashtable, Backends)
+{
+    long long time_string[2], time_pointer[2];
+
+    time_string[0] = benchmark_hashtable_string (HASHTABLE_BACKEND_CHAINED);
+    time_string[1] = benchmark_hashtable_string (HASHTABLE_BACKEND_COMPACT);
+    time_pointer[0] = benchmark_hashtable_pointer (HASHTABLE_BACKEND_CHAINED);
+    time_pointer[1] = benchmark_hashtable_pointer (HASHTABLE_BACKEND_COMPACT);
+
+    printf ("\n");
+    printf (">>> Hashtable string/string (%d messages): "
+            "%lld ms chained, %lld ms compact\n",
+            BENCHMARK_HASHTABLE_MESSAGES, time_string[0], time_string[1]);
+    printf (">>> Hashtable pointer/pointer (%d pointers): "
+            "%lld ms chained, %lld ms compact\n",
+            BENCHMARK_HASHTABLE_POINTERS, time_pointer[0], time_pointer[1]);
+}
+
+/*
+ * Benchmark of hash functions (djb2 vs seeded) on short and long keys.
+ */
+
+TEST(BenchmarkCoreHashtable, HashFunctions)
+{
+    long long time_hash[4];
+    struct timeval time_start, time_end;
+    unsigned long long hash;
+    char key_long[257];
+    int i;
+
+    /* hash functions on short and long keys */
+    memset (key_long, 'a', sizeof (key_long) - 1);
+    key_long[sizeof (key_long) - 1] = '\0';
+    hash = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 1000000; i++)
+    {
+        hash += hashtable_hash_key_djb2 ("nickname");
+    }
+    gettimeofday (&time_end, NULL);
+    time_hash[0] = util_timeval_diff (&time_start, &time_end) / 1000;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 1000000; i++)
+    {
+        hash += hashtable_hash_key_string ("nickname");
+    }
+    gettimeofday (&time_end, NULL);
+    time_hash[1] = util_timeval_diff (&time_start, &time_end) / 1000;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 1000000; i++)
+    {
+        key_long[i % 256] = 'b';
+        hash += hashtable_hash_key_djb2 (key_long);
+        key_long[i % 256] = 'a';
+    }
+    gettimeofday (&time_end, NULL);
+    time_hash[2] = util_timeval_diff (&time_start, &time_end) / 1000;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 1000000; i++)
+    {
+        key_long[i % 256] = 'b';
+        hash += hashtable_hash_key_string (key_long);
+        key_long[i % 256] = 'a';
+    }
+    gettimeofday (&time_end, NULL);
+    time_hash[3] = util_timeval_diff (&time_start, &time_end) / 1000;
+    CHECK(hash != 0);
+
+    printf ("\n");
+    printf (">>> Hash of 1M keys of 8 bytes: %lld ms djb2, %lld ms seeded\n",
+            time_hash[0], time_hash[1]);
+    printf (">>> Hash of 1M keys of 256 bytes: %lld ms djb2, %lld ms seeded\n",
+            time_hash[2], time_hash[3]);
+}
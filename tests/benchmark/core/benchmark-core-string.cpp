@@ -0,0 +1,207 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark string functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <stdio.h>
+#include <string.h>
+#include <regex.h>
+#include <sys/time.h>
+#include "src/core/core-string.h"
+#include "src/core/core-util.h"
+}
+
+TEST_GROUP(BenchmarkCoreString)
+{
+};
+
+/*
+ * Benchmark of masks of hooks: string_match vs compiled masks
+ * (string_mask_match).
+ */
+
+TEST(BenchmarkCoreString, Mask)
+{
+    const char *masks[] = {
+        "buffer_switch",
+        "irc_server_*",
+        "*,irc_in2_privmsg",
+        "*;weechat*;*",
+        "irc.libera.#*",
+        "python.*.script*",
+        NULL,
+    };
+    const char *strings[] = {
+        "buffer_line_added",
+        "irc_server_connected",
+        "libera,irc_in2_privmsg",
+        "irc.libera.#weechat",
+        "python.script.script_loaded",
+        "core.weechat",
+        NULL,
+    };
+    struct t_string_mask *compiled_masks[6];
+    struct timeval time_start, time_end;
+    long long time_match, time_compiled;
+    int i, j, k, total_match, total_compiled;
+
+    for (i = 0; masks[i]; i++)
+    {
+        compiled_masks[i] = string_mask_compile (masks[i], 0);
+    }
+
+    total_match = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 20000; i++)
+    {
+        for (j = 0; strings[j]; j++)
+        {
+            for (k = 0; masks[k]; k++)
+            {
+                total_match += string_match (strings[j], masks[k], 0);
+            }
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_match = util_timeval_diff (&time_start, &time_end);
+
+    total_compiled = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 20000; i++)
+    {
+        for (j = 0; strings[j]; j++)
+        {
+            for (k = 0; masks[k]; k++)
+            {
+                total_compiled += string_mask_match (compiled_masks[k],
+                                                     strings[j]);
+            }
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_compiled = util_timeval_diff (&time_start, &time_end);
+
+    LONGS_EQUAL(20000 * 4, total_match);
+    LONGS_EQUAL(total_match, total_compiled);
+
+    printf ("\n>>> Mask (6 masks, 6 strings, 20000 times): "
+            "string_match: %lld ms, compiled masks: %lld ms\n",
+            time_match / 1000,
+            time_compiled / 1000);
+
+    for (i = 0; masks[i]; i++)
+    {
+        string_mask_free (compiled_masks[i]);
+    }
+}
+
+/*
+ * Benchmark of regular expressions of filters and triggers: regexec vs
+ * string_regex_exec (PCRE2 if enabled).
+ */
+
+TEST(BenchmarkCoreString, RegexExec)
+{
+    const char *regexes[] = {
+        /* filters */
+        "(?i)^(join|part|quit)",
+        "(?i)\\<(weechat|relay)\\>",
+        "[[:digit:]]{3,}",
+        /* triggers */
+        "(?i)(password=)([^ ]+)",
+        "https?://[^ ]+",
+        NULL,
+    };
+    const char *messages[] = {
+        "hello everyone, does anyone know how to configure the relay?",
+        "yes, see /help relay and the options relay.network.*",
+        "alice: you should try with the latest version of WeeChat",
+        "log in with password=secret on https://example.com/login",
+        "thanks bob, it works fine now! (ticket #12345)",
+        NULL,
+    };
+    struct t_string_regex regex[5];
+    regmatch_t regex_match[3];
+    struct timeval time_start, time_end;
+    long long time_posix, time_regexec;
+    int i, j, k, total_posix, total_regexec;
+
+    for (i = 0; regexes[i]; i++)
+    {
+        LONGS_EQUAL(0, string_regex_compile (&regex[i], regexes[i],
+                                             REG_EXTENDED));
+    }
+
+    total_posix = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 2000; i++)
+    {
+        for (j = 0; messages[j]; j++)
+        {
+            for (k = 0; regexes[k]; k++)
+            {
+                if (regexec (&regex[k].regex, messages[j],
+                             3, regex_match, 0) == 0)
+                {
+                    total_posix++;
+                }
+            }
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_posix = util_timeval_diff (&time_start, &time_end);
+
+    total_regexec = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < 2000; i++)
+    {
+        for (j = 0; messages[j]; j++)
+        {
+            for (k = 0; regexes[k]; k++)
+            {
+                if (string_regex_exec (&regex[k], messages[j],
+                                       3, regex_match, 0) == 0)
+                {
+                    total_regexec++;
+                }
+            }
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_regexec = util_timeval_diff (&time_start, &time_end);
+
+    LONGS_EQUAL(2000 * 6, total_posix);
+    LONGS_EQUAL(total_posix, total_regexec);
+
+    printf ("\n>>> Regex (5 regex, 5 messages, 2000 times): "
+            "regexec: %lld ms, string_regex_exec: %lld ms\n",
+            time_posix / 1000,
+            time_regexec / 1000);
+
+    for (i = 0; regexes[i]; i++)
+    {
+        string_regex_free (&regex[i]);
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark UTF-8 string functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <sys/time.h>
+#include "src/core/core-utf8.h"
+#include "src/core/core-config.h"
+#include "src/core/core-util.h"
+}
+
+#define BENCHMARK_UTF8_LOOPS 200000
+
+TEST_GROUP(BenchmarkCoreUtf8)
+{
+};
+
+/*
+ * Check if a string is UTF-8 valid, one char at a time (reference
+ * implementation, compared to utf8_is_valid).
+ */
+
+int
+benchmark_utf8_is_valid_ref (const char *string, int length, char **error)
+{
+    const unsigned char *ptr;
+    int current_char, size, code_point, i;
+
+    ptr = (const unsigned char *)string;
+    current_char = 0;
+    while (ptr && ptr[0] && ((length <= 0) || (current_char < length)))
+    {
+        if (ptr[0] < 0x80)
+            size = 1;
+        else if ((ptr[0] & 0xE0) == 0xC0)
+            size = 2;
+        else if ((ptr[0] & 0xF0) == 0xE0)
+            size = 3;
+        else if ((ptr[0] & 0xF8) == 0xF0)
+            size = 4;
+        else
+            goto invalid;
+        for (i = 1; i < size; i++)
+        {
+            if ((ptr[i] & 0xC0) != 0x80)
+                goto invalid;
+        }
+        code_point = utf8_char_int ((const char *)ptr);
+        if (((size == 2) && ((code_point < 0x80) || (code_point > 0x7FF)))
+            || ((size == 3) && ((code_point < 0x800) || (code_point > 0xFFFF)
+                                || ((code_point >= 0xD800) && (code_point <= 0xDFFF))))
+            || ((size == 4) && ((code_point < 0x10000) || (code_point > 0x1FFFFF))))
+        {
+            goto invalid;
+        }
+        ptr += size;
+        current_char++;
+    }
+    if (error)
+        *error = NULL;
+    return 1;
+
+invalid:
+    if (error)
+        *error = (char *)ptr;
+    return 0;
+}
+
+/*
+ * Get number of chars needed on screen to display the UTF-8 string, one
+ * char at a time with wcwidth (reference implementation, compared to
+ * utf8_strlen_screen).
+ */
+
+int
+benchmark_utf8_strlen_screen_ref (const char *string)
+{
+    const char *ptr;
+    int size_screen, width, code_point;
+
+    size_screen = 0;
+    for (ptr = string; ptr && ptr[0]; ptr = utf8_next_char (ptr))
+    {
+        if (ptr[0] == '\t')
+            width = CONFIG_INTEGER(config_look_tab_width);
+        else if ((unsigned char)ptr[0] < 32)
+            width = 1;
+        else
+        {
+            code_point = utf8_char_int (ptr);
+            width = ((code_point == 0x00AD) || (code_point == 0x200B)) ?
+                -1 : wcwidth ((wchar_t)code_point);
+        }
+        if (width > 0)
+            size_screen += width;
+    }
+    return size_screen;
+}
+
+/*
+ * Benchmark of utf8_is_valid and utf8_strlen_screen on ASCII and UTF-8
+ * strings, compared to the reference implementations.
+ */
+
+TEST(BenchmarkCoreUtf8, Strings)
+{
+    const char *lines[2] = {
+        "PRIVMSG #weechat :Hello, this is a message with only ASCII chars, "
+        "like most messages received from IRC servers; the end.",
+        "PRIVMSG #weechat :Bonjour, voici un message avec des caractères "
+        "accentués, des symboles \u2603 \u2614 et des idéogrammes \u4e2d\u6587.",
+    };
+    struct timeval time_start, time_end;
+    long long time_valid[2][2], time_screen[2][2];
+    int i, j, total;
+
+    total = 0;
+    for (i = 0; i < 2; i++)
+    {
+        gettimeofday (&time_start, NULL);
+        for (j = 0; j < BENCHMARK_UTF8_LOOPS; j++)
+        {
+            total += benchmark_utf8_is_valid_ref (lines[i], 0, NULL);
+        }
+        gettimeofday (&time_end, NULL);
+        time_valid[i][0] = util_timeval_diff (&time_start, &time_end);
+        gettimeofday (&time_start, NULL);
+        for (j = 0; j < BENCHMARK_UTF8_LOOPS; j++)
+        {
+            total += utf8_is_valid (lines[i], 0, NULL);
+        }
+        gettimeofday (&time_end, NULL);
+        time_valid[i][1] = util_timeval_diff (&time_start, &time_end);
+        gettimeofday (&time_start, NULL);
+        for (j = 0; j < BENCHMARK_UTF8_LOOPS; j++)
+        {
+            total += benchmark_utf8_strlen_screen_ref (lines[i]);
+        }
+        gettimeofday (&time_end, NULL);
+        time_screen[i][0] = util_timeval_diff (&time_start, &time_end);
+        gettimeofday (&time_start, NULL);
+        for (j = 0; j < BENCHMARK_UTF8_LOOPS; j++)
+        {
+            total += utf8_strlen_screen (lines[i]);
+        }
+        gettimeofday (&time_end, NULL);
+        time_screen[i][1] = util_timeval_diff (&time_start, &time_end);
+    }
+    CHECK(total > 0);
+
+    printf ("\n");
+    for (i = 0; i < 2; i++)
+    {
+        printf (">>> UTF-8 %s line (%d bytes, %d times): "
+                "utf8_is_valid: %lld ms (one char at a time: %lld ms), "
+                "utf8_strlen_screen: %lld ms (one char at a time: %lld ms)\n",
+                (i == 0) ? "ASCII" : "UTF-8",
+                (int)strlen (lines[i]),
+                BENCHMARK_UTF8_LOOPS,
+                time_valid[i][1] / 1000,
+                time_valid[i][0] / 1000,
+                time_screen[i][1] / 1000,
+                time_screen[i][0] / 1000);
+    }
+}
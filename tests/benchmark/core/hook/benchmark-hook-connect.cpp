@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark hook connect functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "src/core/weechat.h"
+#include "src/core/core-config.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-util.h"
+#include "src/plugins/plugin.h"
+}
+
+#define BENCHMARK_CONNECT_COUNT 50
+
+int benchmark_connect_done = 0;
+int benchmark_connect_ok = 0;
+
+TEST_GROUP(BenchmarkHookConnect)
+{
+};
+
+/*
+ * Callback for hook connect.
+ */
+
+int
+benchmark_connect_cb (const void *pointer, void *data, int status,
+                      int gnutls_rc, int sock, const char *error,
+                      const char *ip_address)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) gnutls_rc;
+    (void) error;
+    (void) ip_address;
+
+    benchmark_connect_done++;
+    if ((status == WEECHAT_HOOK_CONNECT_OK) && (sock >= 0))
+        benchmark_connect_ok++;
+    if (sock >= 0)
+        close (sock);
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Create a non-blocking socket listening on 127.0.0.1 (random port).
+ *
+ * Return the socket, -1 if error; port is set in *port.
+ */
+
+int
+benchmark_connect_listen (int *port)
+{
+    struct sockaddr_in addr;
+    socklen_t length;
+    int sock, flags;
+
+    sock = socket (AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+        return -1;
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    length = sizeof (addr);
+    if ((bind (sock, (struct sockaddr *)&addr, sizeof (addr)) < 0)
+        || (listen (sock, BENCHMARK_CONNECT_COUNT * 2) < 0)
+        || (getsockname (sock, (struct sockaddr *)&addr, &length) < 0))
+    {
+        close (sock);
+        return -1;
+    }
+    *port = ntohs (addr.sin_port);
+    flags = fcntl (sock, F_GETFL);
+    fcntl (sock, F_SETFL, flags | O_NONBLOCK);
+
+    return sock;
+}
+
+/*
+ * Connect BENCHMARK_CONNECT_COUNT times (mass reconnect) to 127.0.0.1 and
+ * wait for all connections.
+ *
+ * Return elapsed time in milliseconds.
+ */
+
+long long
+benchmark_connect_mass (int sock_listen, int port)
+{
+    struct timeval time_start, time_end;
+    int i, sock;
+
+    benchmark_connect_done = 0;
+    benchmark_connect_ok = 0;
+
+    gettimeofday (&time_start, NULL);
+
+    for (i = 0; i < BENCHMARK_CONNECT_COUNT; i++)
+    {
+        CHECK(hook_connect (NULL, NULL, "127.0.0.1", port,
+                            WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                            NULL, NULL, 0, NULL, NULL,
+                            &benchmark_connect_cb, NULL, NULL));
+    }
+
+    /* wait for all connections (max 10 seconds) */
+    for (i = 0;
+         (i < 10000) && (benchmark_connect_done < BENCHMARK_CONNECT_COUNT);
+         i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+        /* accept connections so that the listen queue is never full */
+        while ((sock = accept (sock_listen, NULL, NULL)) >= 0)
+            close (sock);
+        usleep (1000);
+    }
+
+    gettimeofday (&time_end, NULL);
+
+    return util_timeval_diff (&time_start, &time_end) / 1000;
+}
+
+/*
+ * Benchmark of mass reconnect: pool of threads vs one child process for
+ * each connection.
+ */
+
+TEST(BenchmarkHookConnect, MassReconnect)
+{
+    int sock_listen, port;
+    long long time_threads, time_fork;
+
+    sock_listen = benchmark_connect_listen (&port);
+    CHECK(sock_listen >= 0);
+
+    time_threads = benchmark_connect_mass (sock_listen, port);
+    LONGS_EQUAL(BENCHMARK_CONNECT_COUNT, benchmark_connect_ok);
+
+    config_file_option_set (config_network_connection_threads, "0", 1);
+    time_fork = benchmark_connect_mass (sock_listen, port);
+    LONGS_EQUAL(BENCHMARK_CONNECT_COUNT, benchmark_connect_ok);
+    config_file_option_reset (config_network_connection_threads, 1);
+
+    close (sock_listen);
+
+    printf ("\n");
+    printf (">>> Connect %d times: %lld ms with threads, %lld ms with fork\n",
+            BENCHMARK_CONNECT_COUNT, time_threads, time_fork);
+}
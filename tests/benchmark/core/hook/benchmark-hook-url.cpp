@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark hook url functions */
+
+#include "CppUTest/TestHarness.h"
+
+#include "tests/unit/tests-http-server.h"
+
+extern "C"
+{
+#include <string.h>
+#include <sys/time.h>
+#include "src/core/weechat.h"
+#include "src/core/core-config.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-hashtable.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-util.h"
+#include "src/plugins/plugin.h"
+}
+
+#define BENCHMARK_URL_COUNT 1000
+
+int benchmark_url_done = 0;
+int benchmark_url_ok = 0;
+
+TEST_GROUP(BenchmarkHookUrl)
+{
+};
+
+/*
+ * Callback for hook url.
+ */
+
+int
+benchmark_url_cb (const void *pointer, void *data, const char *url,
+                  struct t_hashtable *options, struct t_hashtable *output)
+{
+    const char *ptr_code;
+
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) url;
+    (void) options;
+
+    benchmark_url_done++;
+    ptr_code = (const char *)hashtable_get (output, "response_code");
+    if (ptr_code && (strcmp (ptr_code, "200") == 0))
+        benchmark_url_ok++;
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Benchmark of many URL transfers at once to the same host (connections are
+ * limited and reused).
+ */
+
+TEST(BenchmarkHookUrl, Transfer)
+{
+    struct timeval time_start, time_end;
+    char url[256];
+    long long diff;
+    int i;
+
+    CHECK(http_server_start ());
+
+    snprintf (url, sizeof (url),
+              "http://127.0.0.1:%d/test", http_server_port);
+
+    config_file_option_set (config_network_url_max_host_connections, "4", 1);
+    benchmark_url_done = 0;
+    benchmark_url_ok = 0;
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_URL_COUNT; i++)
+    {
+        CHECK(hook_url (NULL, url, NULL, 10000,
+                        &benchmark_url_cb, NULL, NULL));
+    }
+    /* run the main loop until all transfers are done (max 30 seconds) */
+    for (i = 0;
+         (i < 30000) && (benchmark_url_done < BENCHMARK_URL_COUNT);
+         i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+    }
+    gettimeofday (&time_end, NULL);
+    LONGS_EQUAL(BENCHMARK_URL_COUNT, benchmark_url_ok);
+    config_file_option_reset (config_network_url_max_host_connections, 1);
+
+    diff = util_timeval_diff (&time_start, &time_end);
+    printf ("\n");
+    printf (">>> URL transfers: %d transfers, %d connections, %lld ms, "
+            "%lld transfers/s\n",
+            BENCHMARK_URL_COUNT, http_server_connections,
+            diff / 1000,
+            (diff > 0) ? (BENCHMARK_URL_COUNT * 1000000LL) / diff : 0);
+
+    http_server_end ();
+}
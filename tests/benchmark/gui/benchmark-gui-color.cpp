@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark color functions */
+
+#include "CppUTest/TestHarness.h"
+
+extern "C"
+{
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "src/core/core-string.h"
+#include "src/core/core-utf8.h"
+#include "src/core/core-util.h"
+#include "src/gui/gui-color.h"
+}
+
+#define BENCHMARK_COLOR_LOOPS 200000
+
+TEST_GROUP(BenchmarkGuiColor)
+{
+};
+
+/*
+ * Removes color codes from a string, one char at a time (reference
+ * implementation, compared to gui_color_decode).
+ */
+
+char *
+benchmark_gui_color_decode_ref (const char *string, const char *replacement)
+{
+    const char *ptr_string;
+    char **out;
+    int size;
+
+    out = string_dyn_alloc (strlen (string) + 1);
+    ptr_string = string;
+    while (ptr_string[0])
+    {
+        size = gui_color_code_size (ptr_string);
+        if (size > 0)
+        {
+            ptr_string += size;
+            if (replacement && replacement[0])
+                string_dyn_concat (out, replacement, -1);
+        }
+        else
+        {
+            size = utf8_char_size (ptr_string);
+            if (size == 0)
+                size = 1;
+            string_dyn_concat (out, ptr_string, size);
+            ptr_string += size;
+        }
+    }
+
+    return string_dyn_free (out, 0);
+}
+
+/*
+ * Benchmark of removal of color codes in typical chat lines, compared to
+ * the reference implementation.
+ */
+
+TEST(BenchmarkGuiColor, Decode)
+{
+    char lines[6][512], buffer[512], *decoded;
+    const char *ptr_decoded;
+    struct timeval time_start, time_end;
+    long long time_ref, time_decode, time_borrow, time_buffer;
+    int i, j, total;
+
+    /* typical chat lines: most messages have no colors */
+    snprintf (lines[0], sizeof (lines[0]),
+              "%s", "hello, does anyone know how to set up a proxy for "
+              "the relay? I tried the doc but it does not work for me");
+    snprintf (lines[1], sizeof (lines[1]),
+              "%s", "yes, see /help relay and the option relay.network.proxy, "
+              "it's explained in the user's guide ☺");
+    snprintf (lines[2], sizeof (lines[2]),
+              "%s", "ok thanks, it works now!");
+    snprintf (lines[3], sizeof (lines[3]),
+              "%s" "alice" "%s" " (" "%s" "~alice@example.com" "%s" ") "
+              "has joined " "%s" "#weechat",
+              gui_color_get_custom ("lightcyan"),
+              gui_color_get_custom ("reset"),
+              gui_color_get_custom ("cyan"),
+              gui_color_get_custom ("reset"),
+              gui_color_get_custom ("*white"));
+    snprintf (lines[4], sizeof (lines[4]),
+              "%s" "bob" "%s" ": check " "%s" "https://weechat.org/" "%s"
+              " for the " "%s" "release notes" "%s",
+              gui_color_get_custom ("214"),
+              gui_color_get_custom ("reset"),
+              gui_color_get_custom ("underline"),
+              gui_color_get_custom ("-underline"),
+              gui_color_get_custom ("bold"),
+              gui_color_get_custom ("-bold"));
+    snprintf (lines[5], sizeof (lines[5]),
+              "%s", "こんにちは、元気で"
+              "すか？");
+
+    total = 0;
+
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_COLOR_LOOPS; i++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            decoded = benchmark_gui_color_decode_ref (lines[j], NULL);
+            total += decoded[0];
+            free (decoded);
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_ref = util_timeval_diff (&time_start, &time_end);
+
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_COLOR_LOOPS; i++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            decoded = gui_color_decode (lines[j], NULL);
+            total += decoded[0];
+            free (decoded);
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_decode = util_timeval_diff (&time_start, &time_end);
+
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_COLOR_LOOPS; i++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            ptr_decoded = gui_color_decode_borrow (lines[j], NULL, &decoded);
+            total += ptr_decoded[0];
+            free (decoded);
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_borrow = util_timeval_diff (&time_start, &time_end);
+
+    gettimeofday (&time_start, NULL);
+    for (i = 0; i < BENCHMARK_COLOR_LOOPS; i++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            total += gui_color_decode_to_buffer (lines[j], NULL,
+                                                 buffer, sizeof (buffer));
+        }
+    }
+    gettimeofday (&time_end, NULL);
+    time_buffer = util_timeval_diff (&time_start, &time_end);
+
+    CHECK(total > 0);
+
+    printf ("\n>>> Decode colors in 6 chat lines (%d times): "
+            "one char at a time: %lld ms, gui_color_decode: %lld ms, "
+            "gui_color_decode_borrow: %lld ms, "
+            "gui_color_decode_to_buffer: %lld ms\n",
+            BENCHMARK_COLOR_LOOPS,
+            time_ref / 1000,
+            time_decode / 1000,
+            time_borrow / 1000,
+            time_buffer / 1000);
+}
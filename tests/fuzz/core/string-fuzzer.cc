@@ -35,7 +35,7 @@ extern "C"
 #include "src/plugins/weechat-plugin.h"
 }
 
-regex_t global_regex;
+struct t_string_regex global_regex;
 
 extern "C" int
 LLVMFuzzerInitialize (int *argc, char ***argv)
@@ -47,7 +47,7 @@ LLVMFuzzerInitialize (int *argc, char ***argv)
     string_init ();
     config_weechat_init ();
 
-    regcomp (&global_regex, "a.*", 0);
+    string_regex_compile (&global_regex, "a.*", 0);
 
     return 0;
 }
@@ -165,7 +165,7 @@ LLVMFuzzerTestOneInput (const uint8_t *data, size_t size)
 
     free (string_replace (str, "a", "b"));
 
-    free (string_replace_regex (str, &global_regex, "b", '$', &callback_replace, NULL));
+    free (string_replace_regex (str, &global_regex.regex, "b", '$', &callback_replace, NULL));
 
     free (string_translate_chars (str, "abc", "def"));
 
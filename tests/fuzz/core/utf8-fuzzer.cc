@@ -59,7 +59,9 @@ LLVMFuzzerTestOneInput (const uint8_t *data, size_t size)
 
     utf8_has_8bits (str);
 
+    utf8_is_valid (str, 0, &error);
     utf8_is_valid (str, size, &error);
+    utf8_is_valid (str, size / 3, &error);
 
     str2 = strdup (str);
     utf8_normalize (str2, '?');
@@ -30,17 +30,48 @@ extern "C"
 #ifndef HAVE_CONFIG_H
 #define HAVE_CONFIG_H
 #endif
+#include <string.h>
 #include "src/core/weechat.h"
+#include "src/core/core-config.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-hook.h"
 #include "src/core/hook/hook-command.h"
+#include "src/gui/gui-buffer.h"
 #include "src/plugins/plugin.h"
 
 extern char *hook_command_remove_raw_markers (const char *string);
 }
 
+#define TEST_PLUGIN1 ((struct t_weechat_plugin *)0x1)
+#define TEST_PLUGIN2 ((struct t_weechat_plugin *)0x2)
+
+const char *test_hook_command_last = NULL;
+
 TEST_GROUP(HookCommand)
 {
 };
 
+/*
+ * Callback for command hooks: saves the callback pointer (a string).
+ */
+
+int
+test_hook_command_cb (const void *pointer, void *data,
+                      struct t_gui_buffer *buffer,
+                      int argc, char **argv, char **argv_eol)
+{
+    /* make C++ compiler happy */
+    (void) data;
+    (void) buffer;
+    (void) argc;
+    (void) argv;
+    (void) argv_eol;
+
+    test_hook_command_last = (const char *)pointer;
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_command_get_description
@@ -58,7 +89,33 @@ TEST(HookCommand, GetDescription)
 
 TEST(HookCommand, Search)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2;
+
+    POINTERS_EQUAL(NULL, hook_command_search (NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_command_search (NULL, "zz_test"));
+
+    hook1 = hook_command (NULL, "zz_test", "", "", "", "",
+                          &test_hook_command_cb, "core", NULL);
+    CHECK(hook1);
+    hook2 = hook_command (TEST_PLUGIN1, "zz_test", "", "", "", "",
+                          &test_hook_command_cb, "plugin1", NULL);
+    CHECK(hook2);
+
+    POINTERS_EQUAL(hook1, hook_command_search (NULL, "zz_test"));
+    POINTERS_EQUAL(hook2, hook_command_search (TEST_PLUGIN1, "zz_test"));
+    POINTERS_EQUAL(NULL, hook_command_search (TEST_PLUGIN2, "zz_test"));
+    POINTERS_EQUAL(NULL, hook_command_search (NULL, "ZZ_TEST"));
+    POINTERS_EQUAL(NULL, hook_command_search (NULL, "zz_tes"));
+
+    /* same command for same plugin: not allowed */
+    POINTERS_EQUAL(NULL, hook_command (NULL, "zz_test", "", "", "", "",
+                                       &test_hook_command_cb, "core", NULL));
+
+    unhook (hook1);
+    POINTERS_EQUAL(NULL, hook_command_search (NULL, "zz_test"));
+    POINTERS_EQUAL(hook2, hook_command_search (TEST_PLUGIN1, "zz_test"));
+    unhook (hook2);
+    POINTERS_EQUAL(NULL, hook_command_search (TEST_PLUGIN1, "zz_test"));
 }
 
 /*
@@ -158,7 +215,73 @@ TEST(HookCommand, Command)
 
 TEST(HookCommand, CommandExec)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2, *hook3, *hook4;
+
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (NULL, 1, NULL, "/zz_test_abc"));
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 1, NULL, NULL));
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 1, NULL, ""));
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_abc"));
+
+    hook1 = hook_command (NULL, "zz_test_abc", "", "", "", "",
+                          &test_hook_command_cb, "core", NULL);
+    hook2 = hook_command (TEST_PLUGIN1, "2000|zz_test_abc", "", "", "", "",
+                          &test_hook_command_cb, "plugin1", NULL);
+    hook3 = hook_command (TEST_PLUGIN1, "zz_test_xyz", "", "", "", "",
+                          &test_hook_command_cb, "plugin1", NULL);
+    hook4 = hook_command (TEST_PLUGIN2, "zz_test_xyz", "", "", "", "",
+                          &test_hook_command_cb, "plugin2", NULL);
+
+    /* command for current plugin */
+    test_hook_command_last = NULL;
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_OK,
+                hook_command_exec (gui_buffers, 0, NULL, "/zz_test_abc"));
+    STRCMP_EQUAL("core", test_hook_command_last);
+
+    /* command in another plugin with higher priority */
+    test_hook_command_last = NULL;
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_OK,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_abc"));
+    STRCMP_EQUAL("plugin1", test_hook_command_last);
+
+    /* command in current plugin, same priority in other plugin */
+    test_hook_command_last = NULL;
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_OK,
+                hook_command_exec (gui_buffers, 1, TEST_PLUGIN2,
+                                   "/zz_test_xyz arg"));
+    STRCMP_EQUAL("plugin2", test_hook_command_last);
+
+    /* command in two other plugins with same priority */
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_AMBIGUOUS_PLUGINS,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_xyz"));
+
+    /* command not found for current plugin */
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 0, NULL, "/zz_test_xyz"));
+
+    /* incomplete commands */
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_x"));
+    config_file_option_set (config_look_command_incomplete, "on", 1);
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_AMBIGUOUS_INCOMPLETE,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_"));
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_AMBIGUOUS_INCOMPLETE,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_x"));
+    unhook (hook4);
+    test_hook_command_last = NULL;
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_OK,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_x"));
+    STRCMP_EQUAL("plugin1", test_hook_command_last);
+    LONGS_EQUAL(HOOK_COMMAND_EXEC_NOT_FOUND,
+                hook_command_exec (gui_buffers, 1, NULL, "/zz_test_b"));
+    config_file_option_reset (config_look_command_incomplete, 1);
+
+    unhook (hook1);
+    unhook (hook2);
+    unhook (hook3);
 }
 
 /*
@@ -27,13 +27,170 @@
 
 extern "C"
 {
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include "src/core/weechat.h"
+#include "src/core/core-config.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-network.h"
+#include "src/plugins/plugin.h"
 }
 
+#define TEST_CONNECT_COUNT 10
+
+int test_connect_done = 0;
+int test_connect_ok = 0;
+
 TEST_GROUP(HookConnect)
 {
 };
 
+/*
+ * Callback for hook connect.
+ */
+
+int
+test_connect_cb (const void *pointer, void *data, int status, int gnutls_rc,
+                 int sock, const char *error, const char *ip_address)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) gnutls_rc;
+    (void) error;
+
+    test_connect_done++;
+    if ((status == WEECHAT_HOOK_CONNECT_OK) && (sock >= 0)
+        && ip_address && (strcmp (ip_address, "127.0.0.1") == 0))
+    {
+        test_connect_ok++;
+    }
+    if (sock >= 0)
+        close (sock);
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Create a socket listening on 127.0.0.1 (random port).
+ *
+ * Return the socket, -1 if error; port is set in *port.
+ */
+
+int
+test_connect_listen (int *port)
+{
+    struct sockaddr_in addr;
+    socklen_t length;
+    int sock;
+
+    sock = socket (AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+        return -1;
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    length = sizeof (addr);
+    if ((bind (sock, (struct sockaddr *)&addr, sizeof (addr)) < 0)
+        || (listen (sock, TEST_CONNECT_COUNT * 2) < 0)
+        || (getsockname (sock, (struct sockaddr *)&addr, &length) < 0))
+    {
+        close (sock);
+        return -1;
+    }
+    *port = ntohs (addr.sin_port);
+
+    return sock;
+}
+
+/*
+ * Create a socket listening on 127.0.0.1 (random port) with a full queue of
+ * pending connections: any new connection to this socket is blocked.
+ *
+ * Return the socket, -1 if error; port is set in *port and the socket of the
+ * connection filling the queue in *sock_client.
+ */
+
+int
+test_connect_listen_full (int *port, int *sock_client)
+{
+    struct sockaddr_in addr;
+    socklen_t length;
+    int sock;
+
+    sock = socket (AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+        return -1;
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    length = sizeof (addr);
+    if ((bind (sock, (struct sockaddr *)&addr, sizeof (addr)) < 0)
+        || (listen (sock, 0) < 0)
+        || (getsockname (sock, (struct sockaddr *)&addr, &length) < 0))
+    {
+        close (sock);
+        return -1;
+    }
+    *port = ntohs (addr.sin_port);
+
+    /* fill the queue of pending connections */
+    *sock_client = socket (AF_INET, SOCK_STREAM, 0);
+    if ((*sock_client < 0)
+        || (connect (*sock_client, (struct sockaddr *)&addr,
+                     sizeof (addr)) < 0))
+    {
+        if (*sock_client >= 0)
+            close (*sock_client);
+        close (sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+/*
+ * Connect TEST_CONNECT_COUNT times (mass reconnect) to 127.0.0.1 and wait
+ * for all connections.
+ */
+
+void
+test_connect_mass (int sock_listen, int port)
+{
+    struct t_hook *hooks[TEST_CONNECT_COUNT];
+    int i, sock;
+
+    test_connect_done = 0;
+    test_connect_ok = 0;
+
+    for (i = 0; i < TEST_CONNECT_COUNT; i++)
+    {
+        hooks[i] = hook_connect (NULL, NULL, "127.0.0.1", port,
+                                 WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                                 NULL, NULL, 0, NULL, NULL,
+                                 &test_connect_cb, NULL, NULL);
+        CHECK(hooks[i]);
+    }
+
+    /* wait for all connections (max 10 seconds) */
+    for (i = 0; (i < 10000) && (test_connect_done < TEST_CONNECT_COUNT); i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+        /* accept connections so that the listen queue is never full */
+        while ((sock = accept (sock_listen, NULL, NULL)) >= 0)
+            close (sock);
+        usleep (1000);
+    }
+}
+
 /*
  * Test functions:
  *   hook_connect_get_description
@@ -51,7 +208,121 @@ TEST(HookConnect, GetDescription)
 
 TEST(HookConnect, Connect)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    int sock_listen, port, flags;
+
+    /* invalid arguments */
+    POINTERS_EQUAL(NULL, hook_connect (NULL, NULL, NULL, 0, 0, 0,
+                                       NULL, NULL, 0, NULL, NULL,
+                                       NULL, NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_connect (NULL, NULL, "127.0.0.1", 0, 0, 0,
+                                       NULL, NULL, 0, NULL, NULL,
+                                       &test_connect_cb, NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_connect (NULL, NULL, "127.0.0.1", 6667, 0, 0,
+                                       NULL, NULL, 0, NULL, NULL,
+                                       NULL, NULL, NULL));
+
+    sock_listen = test_connect_listen (&port);
+    CHECK(sock_listen >= 0);
+    flags = fcntl (sock_listen, F_GETFL);
+    fcntl (sock_listen, F_SETFL, flags | O_NONBLOCK);
+
+    /* connect in a thread of the pool */
+    hook = hook_connect (NULL, NULL, "127.0.0.1", port,
+                         WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                         NULL, NULL, 0, NULL, NULL,
+                         &test_connect_cb, NULL, NULL);
+    CHECK(hook);
+    CHECK(HOOK_CONNECT(hook, connect_job));
+    LONGS_EQUAL(0, HOOK_CONNECT(hook, child_pid));
+    LONGS_EQUAL(-1, HOOK_CONNECT(hook, child_write));
+    CHECK(HOOK_CONNECT(hook, hook_fd));
+    CHECK(HOOK_CONNECT(hook, hook_child_timer));
+    unhook (hook);
+
+    /* mass reconnect with the pool of threads */
+    test_connect_mass (sock_listen, port);
+    LONGS_EQUAL(TEST_CONNECT_COUNT, test_connect_done);
+    LONGS_EQUAL(TEST_CONNECT_COUNT, test_connect_ok);
+
+    /* mass reconnect with a child process for each connection */
+    config_file_option_set (config_network_connection_threads, "0", 1);
+    hook = hook_connect (NULL, NULL, "127.0.0.1", port,
+                         WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                         NULL, NULL, 0, NULL, NULL,
+                         &test_connect_cb, NULL, NULL);
+    CHECK(hook);
+    POINTERS_EQUAL(NULL, HOOK_CONNECT(hook, connect_job));
+    CHECK(HOOK_CONNECT(hook, child_pid) > 0);
+    unhook (hook);
+    test_connect_mass (sock_listen, port);
+    LONGS_EQUAL(TEST_CONNECT_COUNT, test_connect_done);
+    LONGS_EQUAL(TEST_CONNECT_COUNT, test_connect_ok);
+    config_file_option_reset (config_network_connection_threads, 1);
+
+    close (sock_listen);
+}
+
+/*
+ * Test functions:
+ *   hook_connect (connection blocked in a thread of the pool)
+ */
+
+TEST(HookConnect, ConnectThreadBlocked)
+{
+    struct t_hook *hook1, *hook2;
+    int sock_listen, sock_client, port, i;
+
+    sock_listen = test_connect_listen_full (&port, &sock_client);
+    CHECK(sock_listen >= 0);
+
+    config_file_option_set (config_network_connection_threads, "1", 1);
+
+    /* connection blocked in the only thread of the pool */
+    hook1 = hook_connect (NULL, NULL, "127.0.0.1", port,
+                          WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                          NULL, NULL, 0, NULL, NULL,
+                          &test_connect_cb, NULL, NULL);
+    CHECK(hook1);
+    CHECK(HOOK_CONNECT(hook1, connect_job));
+    usleep (200000);
+    LONGS_EQUAL(1, network_connect_threads);
+    LONGS_EQUAL(0, network_connect_threads_idle);
+
+    /* thread busy for a short time: new connection is queued */
+    hook2 = hook_connect (NULL, NULL, "127.0.0.1", port,
+                          WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                          NULL, NULL, 0, NULL, NULL,
+                          &test_connect_cb, NULL, NULL);
+    CHECK(hook2);
+    CHECK(HOOK_CONNECT(hook2, connect_job));
+    unhook (hook2);
+
+    /* pool stuck: new connection is made with a child process */
+    network_connect_threads_last_activity.tv_sec -=
+        NETWORK_CONNECT_THREADS_STUCK_DELAY + 1;
+    hook2 = hook_connect (NULL, NULL, "127.0.0.1", port,
+                          WEECHAT_HOOK_CONNECT_IPV6_DISABLE, 0,
+                          NULL, NULL, 0, NULL, NULL,
+                          &test_connect_cb, NULL, NULL);
+    CHECK(hook2);
+    POINTERS_EQUAL(NULL, HOOK_CONNECT(hook2, connect_job));
+    CHECK(HOOK_CONNECT(hook2, child_pid) > 0);
+    unhook (hook2);
+
+    /* remove hook while connection is blocked: thread is available again */
+    unhook (hook1);
+    for (i = 0; (i < 2000) && (network_connect_threads_idle == 0); i++)
+    {
+        usleep (1000);
+    }
+    LONGS_EQUAL(1, network_connect_threads);
+    LONGS_EQUAL(1, network_connect_threads_idle);
+
+    config_file_option_reset (config_network_connection_threads, 1);
+
+    close (sock_client);
+    close (sock_listen);
 }
 
 /*
@@ -27,13 +27,39 @@
 
 extern "C"
 {
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
 #include "src/core/weechat.h"
+#include "src/core/core-hook.h"
+#include "src/plugins/plugin.h"
 }
 
+int test_hook_fd_calls = 0;
+int test_hook_fd_last_fd = -1;
+
 TEST_GROUP(HookFd)
 {
 };
 
+/*
+ * Callback for fd hooks.
+ */
+
+int
+test_hook_fd_cb (const void *pointer, void *data, int fd)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+
+    test_hook_fd_calls++;
+    test_hook_fd_last_fd = fd;
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_fd_get_description
@@ -44,6 +70,17 @@ TEST(HookFd, GetDescription)
     /* TODO: write tests */
 }
 
+/*
+ * Test functions:
+ *   hook_fd_get_backend
+ */
+
+TEST(HookFd, GetBackend)
+{
+    CHECK((strcmp (hook_fd_get_backend (), "epoll") == 0)
+          || (strcmp (hook_fd_get_backend (), "poll") == 0));
+}
+
 /*
  * Test functions:
  *   hook_fd_search
@@ -51,7 +88,22 @@ TEST(HookFd, GetDescription)
 
 TEST(HookFd, Search)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    int fds[2];
+
+    POINTERS_EQUAL(NULL, hook_fd_search (-1));
+    POINTERS_EQUAL(NULL, hook_fd_search (100000));
+
+    LONGS_EQUAL(0, pipe (fds));
+    POINTERS_EQUAL(NULL, hook_fd_search (fds[0]));
+    hook = hook_fd (NULL, fds[0], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook);
+    POINTERS_EQUAL(hook, hook_fd_search (fds[0]));
+    POINTERS_EQUAL(NULL, hook_fd_search (fds[1]));
+    unhook (hook);
+    POINTERS_EQUAL(NULL, hook_fd_search (fds[0]));
+    close (fds[0]);
+    close (fds[1]);
 }
 
 /*
@@ -91,7 +143,116 @@ TEST(HookFd, RemoveCb)
 
 TEST(HookFd, Fd)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    int fds[2], count_epoll, count_poll;
+
+    POINTERS_EQUAL(NULL, hook_fd (NULL, -1, 1, 0, 0,
+                                  &test_hook_fd_cb, NULL, NULL));
+
+    LONGS_EQUAL(0, pipe (fds));
+    POINTERS_EQUAL(NULL, hook_fd (NULL, fds[0], 1, 0, 0, NULL, NULL, NULL));
+
+    count_epoll = hook_fd_count_epoll;
+    count_poll = hook_fd_count_poll;
+
+    hook = hook_fd (NULL, fds[0], 1, 0, 1, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook);
+    LONGS_EQUAL(fds[0], HOOK_FD(hook, fd));
+    LONGS_EQUAL(HOOK_FD_FLAG_READ | HOOK_FD_FLAG_EXCEPTION,
+                HOOK_FD(hook, flags));
+    LONGS_EQUAL(0, HOOK_FD(hook, error));
+    if (strcmp (hook_fd_get_backend (), "epoll") == 0)
+    {
+        LONGS_EQUAL(1, HOOK_FD(hook, registered));
+        LONGS_EQUAL(count_epoll + 1, hook_fd_count_epoll);
+        LONGS_EQUAL(count_poll, hook_fd_count_poll);
+    }
+    else
+    {
+        LONGS_EQUAL(0, HOOK_FD(hook, registered));
+        LONGS_EQUAL(count_epoll, hook_fd_count_epoll);
+        LONGS_EQUAL(count_poll + 1, hook_fd_count_poll);
+    }
+
+    /* same fd hooked twice: not allowed */
+    POINTERS_EQUAL(NULL, hook_fd (NULL, fds[0], 1, 0, 0,
+                                  &test_hook_fd_cb, NULL, NULL));
+
+    unhook (hook);
+    LONGS_EQUAL(count_epoll, hook_fd_count_epoll);
+    LONGS_EQUAL(count_poll, hook_fd_count_poll);
+
+    close (fds[0]);
+    close (fds[1]);
+}
+
+/*
+ * Test functions:
+ *   hook_fd_set_flags
+ */
+
+TEST(HookFd, SetFlags)
+{
+    struct t_hook *hook;
+    int fds[2];
+
+    hook_fd_set_flags (NULL, HOOK_FD_FLAG_READ);
+
+    LONGS_EQUAL(0, pipe (fds));
+    hook = hook_fd (NULL, fds[1], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook);
+
+    /* read on write end of pipe: no activity */
+    test_hook_fd_calls = 0;
+    hook_process_pending = 1;
+    hook_fd_exec ();
+    LONGS_EQUAL(0, test_hook_fd_calls);
+
+    /* write on write end of pipe: callback is called */
+    hook_fd_set_flags (hook, HOOK_FD_FLAG_WRITE);
+    LONGS_EQUAL(HOOK_FD_FLAG_WRITE, HOOK_FD(hook, flags));
+    hook_fd_exec ();
+    LONGS_EQUAL(1, test_hook_fd_calls);
+    LONGS_EQUAL(fds[1], test_hook_fd_last_fd);
+    hook_process_pending = 0;
+
+    unhook (hook);
+    close (fds[0]);
+    close (fds[1]);
+}
+
+/*
+ * Test functions:
+ *   hook_fd_check_bad_fd
+ *   hook_fd_check_registered
+ */
+
+TEST(HookFd, CheckBadFd)
+{
+    struct t_hook *hook;
+    int fds[2];
+
+    LONGS_EQUAL(0, pipe (fds));
+    hook = hook_fd (NULL, fds[0], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook);
+
+    LONGS_EQUAL(0, hook_fd_check_bad_fd (hook));
+    hook_fd_check_registered (1);
+    LONGS_EQUAL(0, HOOK_FD(hook, error));
+
+    /* fd closed without removing the hook */
+    close (fds[0]);
+    LONGS_EQUAL(1, hook_fd_check_bad_fd (hook));
+    LONGS_EQUAL(EBADF, HOOK_FD(hook, error));
+    HOOK_FD(hook, error) = 0;
+    hook_fd_check_registered (1);
+    LONGS_EQUAL(EBADF, HOOK_FD(hook, error));
+
+    /* hook with bad fd is not registered in epoll any more */
+    LONGS_EQUAL(0, HOOK_FD(hook, registered));
+
+    unhook (hook);
+    close (fds[1]);
 }
 
 /*
@@ -101,7 +262,111 @@ TEST(HookFd, Fd)
 
 TEST(HookFd, Exec)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2;
+    char path[] = "/tmp/weechat-test-hook-fd-XXXXXX";
+    int fds[2], fd_file;
+
+    LONGS_EQUAL(0, pipe (fds));
+    fd_file = mkstemp (path);
+    CHECK(fd_file >= 0);
+
+    hook1 = hook_fd (NULL, fds[0], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook1);
+
+    /* a regular file is not supported by epoll: it is checked with poll() */
+    hook2 = hook_fd (NULL, fd_file, 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook2);
+    LONGS_EQUAL(0, HOOK_FD(hook2, registered));
+
+    /* regular file is always ready */
+    test_hook_fd_calls = 0;
+    test_hook_fd_last_fd = -1;
+    hook_process_pending = 1;
+    hook_fd_exec ();
+    LONGS_EQUAL(1, test_hook_fd_calls);
+    LONGS_EQUAL(fd_file, test_hook_fd_last_fd);
+
+    /* data in pipe: callback is called */
+    unhook (hook2);
+    LONGS_EQUAL(1, write (fds[1], "a", 1));
+    test_hook_fd_calls = 0;
+    test_hook_fd_last_fd = -1;
+    hook_fd_exec ();
+    LONGS_EQUAL(1, test_hook_fd_calls);
+    LONGS_EQUAL(fds[0], test_hook_fd_last_fd);
+    hook_process_pending = 0;
+
+    unhook (hook1);
+    close (fds[0]);
+    close (fds[1]);
+    close (fd_file);
+    unlink (path);
+}
+
+/*
+ * Test functions:
+ *   hook_fd_epoll_rebuild
+ *   hook_fd_exec_epoll
+ */
+
+TEST(HookFd, ExecEpollStale)
+{
+    struct t_hook *hook1, *hook2;
+    int fds[2], fds2[2], fd_dup;
+
+    if (strcmp (hook_fd_get_backend (), "epoll") != 0)
+        return;
+
+    LONGS_EQUAL(0, pipe (fds));
+    fd_dup = dup (fds[0]);
+    CHECK(fd_dup >= 0);
+
+    hook1 = hook_fd (NULL, fds[0], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook1);
+    LONGS_EQUAL(1, HOOK_FD(hook1, registered));
+
+    /*
+     * fd closed before removing the hook: the registration in epoll is kept
+     * by the kernel because the dup still refers to the same file
+     */
+    LONGS_EQUAL(1, write (fds[1], "a", 1));
+    close (fds[0]);
+    unhook (hook1);
+
+    /* new hook with the same fd number (the stale event must be ignored) */
+    LONGS_EQUAL(0, pipe (fds2));
+    if (fds2[0] != fds[0])
+    {
+        LONGS_EQUAL(fds[0], dup2 (fds2[0], fds[0]));
+        close (fds2[0]);
+        fds2[0] = fds[0];
+    }
+    hook2 = hook_fd (NULL, fds2[0], 1, 0, 0, &test_hook_fd_cb, NULL, NULL);
+    CHECK(hook2);
+
+    test_hook_fd_calls = 0;
+    hook_process_pending = 1;
+    hook_fd_exec ();
+    LONGS_EQUAL(0, test_hook_fd_calls);
+
+    /* the epoll set has been rebuilt: no more stale event */
+    hook_fd_exec ();
+    LONGS_EQUAL(0, hook_fd_epoll_purge);
+    LONGS_EQUAL(0, test_hook_fd_calls);
+    LONGS_EQUAL(1, HOOK_FD(hook2, registered));
+
+    /* data in new pipe: callback is called */
+    LONGS_EQUAL(1, write (fds2[1], "b", 1));
+    hook_fd_exec ();
+    LONGS_EQUAL(1, test_hook_fd_calls);
+    LONGS_EQUAL(fds2[0], test_hook_fd_last_fd);
+    hook_process_pending = 0;
+
+    unhook (hook2);
+    close (fds2[0]);
+    close (fds2[1]);
+    close (fd_dup);
+    close (fds[1]);
 }
 
 /*
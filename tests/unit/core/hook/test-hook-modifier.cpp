@@ -161,6 +161,30 @@ error:
     return NULL;
 }
 
+/*
+ * Modifier callback: appends the callback pointer (a string) to the string,
+ * or drops the string if modifier data is "drop".
+ */
+
+char *
+test_modifier_append_cb (const void *pointer, void *data,
+                         const char *modifier, const char *modifier_data,
+                         const char *string)
+{
+    char *new_string;
+
+    /* make C++ compiler happy */
+    (void) data;
+    (void) modifier;
+
+    if (modifier_data && (strcmp (modifier_data, "drop") == 0))
+        return strdup ("");
+
+    string_asprintf (&new_string, "%s%s", string, (const char *)pointer);
+
+    return new_string;
+}
+
 /*
  * Test functions:
  *   hook_modifier
@@ -265,7 +289,64 @@ TEST(HookModifier, Modifier)
 
 TEST(HookModifier, Exec)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2, *hook3;
+    char *str;
+
+    POINTERS_EQUAL(NULL, hook_modifier_exec (NULL, NULL, NULL, "abc"));
+    POINTERS_EQUAL(NULL, hook_modifier_exec (NULL, "", NULL, "abc"));
+    POINTERS_EQUAL(NULL, hook_modifier_exec (NULL, "test_mod", NULL, NULL));
+
+    /* modifier not hooked: copy of string */
+    WEE_TEST_STR("abc", hook_modifier_exec (NULL, "test_mod", NULL, "abc"));
+
+    /* hooks are called by priority, then by order of creation */
+    hook1 = hook_modifier (NULL, "test_mod", &test_modifier_append_cb,
+                           "1", NULL);
+    hook2 = hook_modifier (NULL, "2000|TEST_MOD", &test_modifier_append_cb,
+                           "2", NULL);
+    hook3 = hook_modifier (NULL, "test_mod", &test_modifier_append_cb,
+                           "3", NULL);
+    WEE_TEST_STR("abc213", hook_modifier_exec (NULL, "test_mod", NULL, "abc"));
+    WEE_TEST_STR("abc213", hook_modifier_exec (NULL, "Test_Mod", NULL, "abc"));
+    WEE_TEST_STR("abc", hook_modifier_exec (NULL, "test_mod2", NULL, "abc"));
+
+    /* message dropped by a modifier */
+    str = hook_modifier_exec (NULL, "test_mod", "drop", "abc");
+    STRCMP_EQUAL("", str);
+    free (str);
+
+    unhook (hook2);
+    WEE_TEST_STR("abc13", hook_modifier_exec (NULL, "test_mod", NULL, "abc"));
+    unhook (hook1);
+    unhook (hook3);
+    WEE_TEST_STR("abc", hook_modifier_exec (NULL, "test_mod", NULL, "abc"));
+}
+
+/*
+ * Test functions:
+ *   hook_modifier_is_hooked
+ */
+
+TEST(HookModifier, IsHooked)
+{
+    struct t_hook *hook1, *hook2;
+
+    LONGS_EQUAL(0, hook_modifier_is_hooked (NULL));
+    LONGS_EQUAL(0, hook_modifier_is_hooked (""));
+    LONGS_EQUAL(0, hook_modifier_is_hooked ("test_mod"));
+
+    hook1 = hook_modifier (NULL, "test_mod", &test_modifier_append_cb,
+                           "1", NULL);
+    LONGS_EQUAL(1, hook_modifier_is_hooked ("test_mod"));
+    LONGS_EQUAL(1, hook_modifier_is_hooked ("TEST_MOD"));
+    LONGS_EQUAL(0, hook_modifier_is_hooked ("test_mod2"));
+
+    hook2 = hook_modifier (NULL, "test_mod", &test_modifier_append_cb,
+                           "2", NULL);
+    unhook (hook1);
+    LONGS_EQUAL(1, hook_modifier_is_hooked ("test_mod"));
+    unhook (hook2);
+    LONGS_EQUAL(0, hook_modifier_is_hooked ("test_mod"));
 }
 
 /*
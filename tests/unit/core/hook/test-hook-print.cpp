@@ -27,13 +27,60 @@
 
 extern "C"
 {
+#include <string.h>
 #include "src/core/weechat.h"
+#include "src/core/core-arraylist.h"
+#include "src/core/core-hashtable.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-string.h"
+#include "src/gui/gui-buffer.h"
+#include "src/gui/gui-chat.h"
+#include "src/gui/gui-color.h"
+#include "src/plugins/plugin.h"
 }
 
+char **test_hook_print_result = NULL;
+
 TEST_GROUP(HookPrint)
 {
 };
 
+/*
+ * Callback for print hooks: adds "id:message" in result (id is the callback
+ * pointer).
+ */
+
+int
+test_hook_print_cb (const void *pointer, void *data,
+                    struct t_gui_buffer *buffer,
+                    time_t date, int date_usec,
+                    int tags_count, const char **tags,
+                    int displayed, int highlight,
+                    const char *prefix, const char *message)
+{
+    /* make C++ compiler happy */
+    (void) data;
+    (void) buffer;
+    (void) date;
+    (void) date_usec;
+    (void) tags_count;
+    (void) tags;
+    (void) displayed;
+    (void) highlight;
+    (void) prefix;
+
+    if (test_hook_print_result)
+    {
+        if ((*test_hook_print_result)[0])
+            string_dyn_concat (test_hook_print_result, ",", -1);
+        string_dyn_concat (test_hook_print_result, (const char *)pointer, -1);
+        string_dyn_concat (test_hook_print_result, ":", -1);
+        string_dyn_concat (test_hook_print_result, message, -1);
+    }
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_print_get_description
@@ -51,7 +98,44 @@ TEST(HookPrint, GetDescription)
 
 TEST(HookPrint, Print)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2;
+    struct t_arraylist *ptr_list;
+    int size;
+
+    ptr_list = (struct t_arraylist *)hashtable_get (hook_print_index_buffer,
+                                                    gui_buffers);
+    size = (ptr_list) ? arraylist_size (ptr_list) : 0;
+
+    POINTERS_EQUAL(NULL, hook_print (NULL, NULL, NULL, NULL, 0,
+                                     NULL, NULL, NULL));
+
+    hook1 = hook_print (NULL, gui_buffers, "tag1,tag2", "msg", 1,
+                        &test_hook_print_cb, "1", NULL);
+    CHECK(hook1);
+    POINTERS_EQUAL(gui_buffers, HOOK_PRINT(hook1, buffer));
+    LONGS_EQUAL(2, HOOK_PRINT(hook1, tags_count));
+    STRCMP_EQUAL("msg", HOOK_PRINT(hook1, message));
+    LONGS_EQUAL(1, HOOK_PRINT(hook1, strip_colors));
+    ptr_list = (struct t_arraylist *)hashtable_get (hook_print_index_buffer,
+                                                    gui_buffers);
+    CHECK(ptr_list);
+    LONGS_EQUAL(size + 1, arraylist_size (ptr_list));
+    POINTERS_EQUAL(hook1, arraylist_get (ptr_list, size));
+
+    hook2 = hook_print (NULL, NULL, NULL, NULL, 0,
+                        &test_hook_print_cb, "2", NULL);
+    CHECK(hook2);
+    CHECK(hook_print_index_any);
+    CHECK(HOOK_PRINT(hook2, sequence) > HOOK_PRINT(hook1, sequence));
+    POINTERS_EQUAL(hook2,
+                   arraylist_get (hook_print_index_any,
+                                  arraylist_size (hook_print_index_any) - 1));
+
+    unhook (hook1);
+    ptr_list = (struct t_arraylist *)hashtable_get (hook_print_index_buffer,
+                                                    gui_buffers);
+    LONGS_EQUAL(size, (ptr_list) ? arraylist_size (ptr_list) : 0);
+    unhook (hook2);
 }
 
 /*
@@ -61,7 +145,46 @@ TEST(HookPrint, Print)
 
 TEST(HookPrint, Exec)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2, *hook3, *hook4, *hook5;
+
+    test_hook_print_result = string_dyn_alloc (256);
+
+    hook1 = hook_print (NULL, NULL, NULL, NULL, 1,
+                        &test_hook_print_cb, "1", NULL);
+    hook2 = hook_print (NULL, gui_buffers, NULL, "test", 0,
+                        &test_hook_print_cb, "2", NULL);
+    hook3 = hook_print (NULL, (struct t_gui_buffer *)0x1, NULL, NULL, 1,
+                        &test_hook_print_cb, "3", NULL);
+    hook4 = hook_print (NULL, NULL, "tag_test", NULL, 1,
+                        &test_hook_print_cb, "4", NULL);
+    hook5 = hook_print (NULL, gui_buffers, NULL, "xyz", 1,
+                        &test_hook_print_cb, "5", NULL);
+
+    /* hooks are called in order of creation, colors are stripped if asked */
+    gui_chat_printf (gui_buffers, "%stest message",
+                     gui_color_get_custom ("red"));
+    STRCMP_EQUAL("1:test message,2:\x19" "F03test message",
+                 *test_hook_print_result);
+
+    /* tags */
+    string_dyn_copy (test_hook_print_result, NULL);
+    gui_chat_printf_date_tags (gui_buffers, 0, "tag_test", "%stest",
+                               gui_color_get_custom ("red"));
+    STRCMP_EQUAL("1:test,2:\x19" "F03test,4:test", *test_hook_print_result);
+
+    /* callback not called after unhook */
+    unhook (hook1);
+    unhook (hook2);
+    string_dyn_copy (test_hook_print_result, NULL);
+    gui_chat_printf (gui_buffers, "test message");
+    STRCMP_EQUAL("", *test_hook_print_result);
+
+    unhook (hook3);
+    unhook (hook4);
+    unhook (hook5);
+
+    string_dyn_free (test_hook_print_result, 1);
+    test_hook_print_result = NULL;
 }
 
 /*
@@ -27,13 +27,46 @@
 
 extern "C"
 {
+#include <stdlib.h>
+#include <string.h>
 #include "src/core/weechat.h"
+#include "src/core/core-hashtable.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-string.h"
+#include "src/plugins/plugin.h"
 }
 
+int test_process_rc;
+char **test_process_out = NULL;
+char **test_process_err = NULL;
+
 TEST_GROUP(HookProcess)
 {
 };
 
+/*
+ * Callback for process hooks used in tests.
+ */
+
+int
+test_process_cb (const void *pointer, void *data, const char *command,
+                 int return_code, const char *out, const char *err)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) command;
+
+    if (out && test_process_out)
+        string_dyn_concat (test_process_out, out, -1);
+    if (err && test_process_err)
+        string_dyn_concat (test_process_err, err, -1);
+    if (return_code != WEECHAT_HOOK_PROCESS_RUNNING)
+        test_process_rc = return_code;
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_process_get_description
@@ -74,6 +107,66 @@ TEST(HookProcess, Child)
     /* TODO: write tests */
 }
 
+/*
+ * Test functions:
+ *   hook_process_get_exec_args
+ */
+
+TEST(HookProcess, GetExecArgs)
+{
+    struct t_hook hook;
+    struct t_hook_process hook_process;
+    char **args, path[1024];
+
+    memset (&hook, 0, sizeof (hook));
+    memset (&hook_process, 0, sizeof (hook_process));
+    hook.type = HOOK_TYPE_PROCESS;
+    hook.hook_data = &hook_process;
+
+    /* arguments split like the shell does */
+    hook_process.command = (char *)"ls -l '/tmp/some dir'";
+    args = hook_process_get_exec_args (&hook);
+    CHECK(args);
+    STRCMP_EQUAL("ls", args[0]);
+    STRCMP_EQUAL("-l", args[1]);
+    STRCMP_EQUAL("/tmp/some dir", args[2]);
+    POINTERS_EQUAL(NULL, args[3]);
+    string_free_split (args);
+
+    /* arguments in options */
+    hook_process.options = hashtable_new (32,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          NULL, NULL);
+    CHECK(hook_process.options);
+    hashtable_set (hook_process.options, "arg1", "-c");
+    hashtable_set (hook_process.options, "arg2", "echo 'a b'");
+    hook_process.command = (char *)"sh";
+    args = hook_process_get_exec_args (&hook);
+    CHECK(args);
+    STRCMP_EQUAL("sh", args[0]);
+    STRCMP_EQUAL("-c", args[1]);
+    STRCMP_EQUAL("echo 'a b'", args[2]);
+    POINTERS_EQUAL(NULL, args[3]);
+    string_free_split (args);
+    hashtable_free (hook_process.options);
+    hook_process.options = NULL;
+
+    /* home directory in binary */
+    hook_process.command = (char *)"~/bin/test arg";
+    args = hook_process_get_exec_args (&hook);
+    CHECK(args);
+    snprintf (path, sizeof (path), "%s/bin/test", getenv ("HOME"));
+    STRCMP_EQUAL(path, args[0]);
+    STRCMP_EQUAL("arg", args[1]);
+    POINTERS_EQUAL(NULL, args[2]);
+    string_free_split (args);
+
+    /* empty command */
+    hook_process.command = (char *)"";
+    POINTERS_EQUAL(NULL, hook_process_get_exec_args (&hook));
+}
+
 /*
  * Test functions:
  *   hook_process_send_buffers
@@ -151,7 +244,60 @@ TEST(HookProcess, TimerCb)
 
 TEST(HookProcess, Run)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    int i;
+
+    test_process_rc = WEECHAT_HOOK_PROCESS_RUNNING;
+    test_process_out = string_dyn_alloc (64);
+    test_process_err = string_dyn_alloc (64);
+
+    hook = hook_process (NULL,
+                         "sh -c 'echo hello; echo error >&2; exit 3'",
+                         10000,
+                         &test_process_cb, NULL, NULL);
+    CHECK(hook);
+    CHECK(HOOK_PROCESS(hook, child_pid) > 0);
+    CHECK(HOOK_PROCESS(hook, hook_fd[HOOK_PROCESS_STDOUT]));
+    CHECK(HOOK_PROCESS(hook, hook_fd[HOOK_PROCESS_STDERR]));
+    CHECK(HOOK_PROCESS(hook, hook_timer));
+
+    /* read output of child until it ends (max 10 seconds) */
+    for (i = 0; (i < 1000)
+             && (test_process_rc == WEECHAT_HOOK_PROCESS_RUNNING); i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+        usleep (10000);
+    }
+
+    LONGS_EQUAL(3, test_process_rc);
+    STRCMP_EQUAL("hello\n", *test_process_out);
+    STRCMP_EQUAL("error\n", *test_process_err);
+
+    /* command not found (fallback to fork) */
+    test_process_rc = WEECHAT_HOOK_PROCESS_RUNNING;
+    string_dyn_copy (test_process_out, NULL);
+    string_dyn_copy (test_process_err, NULL);
+    hook = hook_process (NULL, "/nonexistent/command", 10000,
+                         &test_process_cb, NULL, NULL);
+    CHECK(hook);
+    CHECK(HOOK_PROCESS(hook, child_pid) > 0);
+    for (i = 0; (i < 1000)
+             && (test_process_rc == WEECHAT_HOOK_PROCESS_RUNNING); i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+        usleep (10000);
+    }
+    LONGS_EQUAL(EXIT_FAILURE, test_process_rc);
+    STRCMP_EQUAL("", *test_process_out);
+    STRCMP_EQUAL("Error with command '/nonexistent/command'\n",
+                 *test_process_err);
+
+    string_dyn_free (test_process_out, 1);
+    test_process_out = NULL;
+    string_dyn_free (test_process_err, 1);
+    test_process_err = NULL;
 }
 
 /*
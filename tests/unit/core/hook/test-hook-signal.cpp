@@ -27,14 +27,42 @@
 
 extern "C"
 {
+#include <string.h>
 #include "src/core/weechat.h"
+#include "src/core/core-hook.h"
 #include "src/core/hook/hook-signal.h"
+#include "src/plugins/plugin.h"
 }
 
+char test_hook_signal_calls[1024];
+
 TEST_GROUP(HookSignal)
 {
 };
 
+/*
+ * Callback for signal hooks: adds the name of hook (callback pointer) in the
+ * calls, and returns the code in callback data (integer, or WEECHAT_RC_OK if
+ * NULL).
+ */
+
+int
+test_hook_signal_cb (const void *pointer, void *data,
+                     const char *signal, const char *type_data,
+                     void *signal_data)
+{
+    /* make C++ compiler happy */
+    (void) signal;
+    (void) type_data;
+    (void) signal_data;
+
+    if (test_hook_signal_calls[0])
+        strcat (test_hook_signal_calls, ",");
+    strcat (test_hook_signal_calls, (const char *)pointer);
+
+    return (data) ? *((int *)data) : WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_signal_get_description
@@ -62,7 +90,25 @@ TEST(HookSignal, Signal)
 
 TEST(HookSignal, Match)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+
+    hook = hook_signal (NULL, "test_exact;test_prefix_*;*_suffix;a*b",
+                        &test_hook_signal_cb, "h", NULL);
+    CHECK(hook);
+
+    LONGS_EQUAL(0, hook_signal_match ("", hook));
+    LONGS_EQUAL(0, hook_signal_match ("test", hook));
+    LONGS_EQUAL(0, hook_signal_match ("test_exact2", hook));
+    LONGS_EQUAL(0, hook_signal_match ("ab_", hook));
+    LONGS_EQUAL(1, hook_signal_match ("test_exact", hook));
+    LONGS_EQUAL(1, hook_signal_match ("TEST_EXACT", hook));
+    LONGS_EQUAL(1, hook_signal_match ("test_prefix_", hook));
+    LONGS_EQUAL(1, hook_signal_match ("test_prefix_abc", hook));
+    LONGS_EQUAL(1, hook_signal_match ("abc_suffix", hook));
+    LONGS_EQUAL(1, hook_signal_match ("ab", hook));
+    LONGS_EQUAL(1, hook_signal_match ("a_xyz_b", hook));
+
+    unhook (hook);
 }
 
 /*
@@ -149,7 +195,106 @@ TEST(HookSignal, ExtractFlags)
 
 TEST(HookSignal, Send)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2, *hook3, *hook4, *hook5, *hook6;
+    int rc_eat, rc_error;
+
+    rc_eat = WEECHAT_RC_OK_EAT;
+    rc_error = WEECHAT_RC_ERROR;
+
+    hook1 = hook_signal (NULL, "test_signal_a", &test_hook_signal_cb,
+                         "h1", NULL);
+    hook2 = hook_signal (NULL, "2000|test_signal_*", &test_hook_signal_cb,
+                         "h2", NULL);
+    hook3 = hook_signal (NULL, "test_*;*_b;test_signal_b",
+                         &test_hook_signal_cb, "h3", NULL);
+    hook4 = hook_signal (NULL, "500|*", &test_hook_signal_cb, "h4", NULL);
+    hook5 = hook_signal (NULL, "TEST_SIGNAL_A", &test_hook_signal_cb,
+                         "h5", NULL);
+    hook6 = hook_signal (NULL, "test_sig*_c", &test_hook_signal_cb,
+                         "h6", NULL);
+    CHECK(hook1);
+    CHECK(hook2);
+    CHECK(hook3);
+    CHECK(hook4);
+    CHECK(hook5);
+    CHECK(hook6);
+
+    /* hooks are called by priority, then by order of creation */
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_a", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h2,h1,h3,h5,h4", test_hook_signal_calls);
+
+    /* hook with multiple masks matching is called once */
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_b", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h2,h3,h4", test_hook_signal_calls);
+
+    /* masks are case-insensitive */
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("Test_Signal_C", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h2,h3,h6,h4", test_hook_signal_calls);
+
+    /* signal with non-ASCII chars (no index used) */
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_\u00e9",
+                                  WEECHAT_HOOK_SIGNAL_STRING, NULL));
+    STRCMP_EQUAL("h2,h3,h4", test_hook_signal_calls);
+
+    /* signal eaten by a hook */
+    hook3->callback_data = &rc_eat;
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK_EAT,
+                hook_signal_send ("test_signal_a", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h2,h1,h3", test_hook_signal_calls);
+
+    /* signal eaten by a hook, with flag "ignore_eat" */
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("[flags:ignore_eat]test_signal_a",
+                                  WEECHAT_HOOK_SIGNAL_STRING, NULL));
+    STRCMP_EQUAL("h2,h1,h3,h5,h4", test_hook_signal_calls);
+
+    /* error in a hook, without/with flag "stop_on_error" */
+    hook3->callback_data = &rc_error;
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_a", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h2,h1,h3,h5,h4", test_hook_signal_calls);
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_ERROR,
+                hook_signal_send ("[flags:stop_on_error]test_signal_a",
+                                  WEECHAT_HOOK_SIGNAL_STRING, NULL));
+    STRCMP_EQUAL("h2,h1,h3", test_hook_signal_calls);
+    hook3->callback_data = NULL;
+
+    /* unhooked hooks are removed from the index */
+    unhook (hook1);
+    unhook (hook2);
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_a", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("h3,h5,h4", test_hook_signal_calls);
+
+    unhook (hook3);
+    unhook (hook4);
+    unhook (hook5);
+    unhook (hook6);
+
+    test_hook_signal_calls[0] = '\0';
+    LONGS_EQUAL(WEECHAT_RC_OK,
+                hook_signal_send ("test_signal_a", WEECHAT_HOOK_SIGNAL_STRING,
+                                  NULL));
+    STRCMP_EQUAL("", test_hook_signal_calls);
 }
 
 /*
@@ -27,13 +27,57 @@
 
 extern "C"
 {
+#include <string.h>
+#include <unistd.h>
 #include "src/core/weechat.h"
+#include "src/core/core-debug.h"
+#include "src/core/core-hook.h"
+#include "src/core/core-util.h"
+#include "src/plugins/plugin.h"
 }
 
+int test_hook_timer_calls = 0;
+
 TEST_GROUP(HookTimer)
 {
+    /*
+     * Check that each timer in the heap is executed after its parent.
+     */
+
+    void check_heap ()
+    {
+        int i;
+
+        for (i = 0; i < hook_timer_heap_size; i++)
+        {
+            LONGS_EQUAL(i, HOOK_TIMER(hook_timer_heap[i], heap_index));
+            if (i > 0)
+            {
+                CHECK(util_timeval_cmp (
+                          &HOOK_TIMER(hook_timer_heap[(i - 1) / 2], next_exec_mono),
+                          &HOOK_TIMER(hook_timer_heap[i], next_exec_mono)) <= 0);
+            }
+        }
+    }
 };
 
+/*
+ * Callback for timer hooks.
+ */
+
+int
+test_hook_timer_cb (const void *pointer, void *data, int remaining_calls)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) remaining_calls;
+
+    test_hook_timer_calls++;
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_timer_get_description
@@ -61,7 +105,34 @@ TEST(HookTimer, Init)
 
 TEST(HookTimer, Timer)
 {
-    /* TODO: write tests */
+    struct t_hook *hooks[8];
+    int i, size;
+    long intervals[8] = { 50000, 10000, 80000, 20000, 70000, 30000, 60000,
+                          40000 };
+
+    size = hook_timer_heap_size;
+
+    POINTERS_EQUAL(NULL, hook_timer (NULL, 0, 0, 0,
+                                     &test_hook_timer_cb, NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_timer (NULL, 1000, 0, 0, NULL, NULL, NULL));
+    LONGS_EQUAL(size, hook_timer_heap_size);
+
+    for (i = 0; i < 8; i++)
+    {
+        hooks[i] = hook_timer (NULL, intervals[i], 0, 0,
+                               &test_hook_timer_cb, NULL, NULL);
+        CHECK(hooks[i]);
+        CHECK(HOOK_TIMER(hooks[i], heap_index) >= 0);
+        check_heap ();
+    }
+    LONGS_EQUAL(size + 8, hook_timer_heap_size);
+
+    for (i = 0; i < 8; i++)
+    {
+        unhook (hooks[i]);
+        check_heap ();
+    }
+    LONGS_EQUAL(size, hook_timer_heap_size);
 }
 
 /*
@@ -91,7 +162,93 @@ TEST(HookTimer, GetTimeToNext)
 
 TEST(HookTimer, Exec)
 {
-    /* TODO: write tests */
+    struct t_hook *hook1, *hook2;
+
+    hook1 = hook_timer (NULL, 60000, 0, 2, &test_hook_timer_cb, NULL, NULL);
+    hook2 = hook_timer (NULL, 120000, 0, 0, &test_hook_timer_cb, NULL, NULL);
+    CHECK(hook1);
+    CHECK(hook2);
+
+    /* timers not executed (in future) */
+    test_hook_timer_calls = 0;
+    hook_timer_exec ();
+    LONGS_EQUAL(0, test_hook_timer_calls);
+
+    /* first timer is now in the past: executed once */
+    util_timeval_monotonic (&HOOK_TIMER(hook1, next_exec_mono));
+    HOOK_TIMER(hook1, next_exec_mono).tv_sec -= 1;
+    hook_timer_heap_update (hook1);
+    check_heap ();
+    hook_timer_exec ();
+    LONGS_EQUAL(1, test_hook_timer_calls);
+    LONGS_EQUAL(1, HOOK_TIMER(hook1, remaining_calls));
+    CHECK(HOOK_TIMER(hook1, heap_index) >= 0);
+    check_heap ();
+
+    /* timer is not executed again (next execution in 60 seconds) */
+    hook_timer_exec ();
+    LONGS_EQUAL(1, test_hook_timer_calls);
+
+    unhook (hook1);
+    unhook (hook2);
+    check_heap ();
+}
+
+/*
+ * Callback for timer hooks, taking 50 milliseconds.
+ */
+
+int
+test_hook_timer_slow_cb (const void *pointer, void *data, int remaining_calls)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) remaining_calls;
+
+    test_hook_timer_calls++;
+    usleep (50000);
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Test functions:
+ *   hook_timer_exec (lateness of timers)
+ */
+
+TEST(HookTimer, ExecLateness)
+{
+    struct t_hook *hook1, *hook2;
+    struct timeval tv_mono;
+
+    hook1 = hook_timer (NULL, 60000, 0, 1, &test_hook_timer_slow_cb,
+                        NULL, NULL);
+    hook2 = hook_timer (NULL, 60000, 0, 1, &test_hook_timer_slow_cb,
+                        NULL, NULL);
+    CHECK(hook1);
+    CHECK(hook2);
+
+    /* execute other timers already scheduled */
+    hook_timer_exec ();
+
+    /* both timers are scheduled now */
+    util_timeval_monotonic (&tv_mono);
+    HOOK_TIMER(hook1, next_exec_mono) = tv_mono;
+    HOOK_TIMER(hook2, next_exec_mono) = tv_mono;
+    hook_timer_heap_update (hook1);
+    hook_timer_heap_update (hook2);
+
+    /* the second timer is late because of the callback of the first one */
+    debug_loop_reset ();
+    debug_loop_enabled = 1;
+    test_hook_timer_calls = 0;
+    hook_timer_exec ();
+    debug_loop_enabled = 0;
+    LONGS_EQUAL(2, test_hook_timer_calls);
+    CHECK(debug_loop_stats[DEBUG_LOOP_STAT_TIMER_LATENESS].count >= 2);
+    CHECK(debug_loop_stats[DEBUG_LOOP_STAT_TIMER_LATENESS].time_max >= 50000);
+    debug_loop_reset ();
 }
 
 /*
@@ -24,16 +24,76 @@
 #include "CppUTest/TestHarness.h"
 
 #include "tests.h"
+#include "tests-http-server.h"
 
 extern "C"
 {
+#include <string.h>
 #include "src/core/weechat.h"
+#include "src/core/core-config.h"
+#include "src/core/core-config-file.h"
+#include "src/core/core-hashtable.h"
+#include "src/core/core-hook.h"
+#include "src/plugins/plugin.h"
 }
 
+#define TEST_URL_COUNT 20
+
+int test_url_done = 0;
+int test_url_ok = 0;
+char test_url_error_code[32];
+
 TEST_GROUP(HookUrl)
 {
 };
 
+/*
+ * Callback for hook url.
+ */
+
+int
+test_url_cb (const void *pointer, void *data, const char *url,
+             struct t_hashtable *options, struct t_hashtable *output)
+{
+    const char *ptr_code, *ptr_output, *ptr_error_code;
+
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) url;
+    (void) options;
+
+    test_url_done++;
+    ptr_code = (const char *)hashtable_get (output, "response_code");
+    ptr_output = (const char *)hashtable_get (output, "output");
+    ptr_error_code = (const char *)hashtable_get (output, "error_code");
+    snprintf (test_url_error_code, sizeof (test_url_error_code),
+              "%s", (ptr_error_code) ? ptr_error_code : "");
+    if (ptr_code && (strcmp (ptr_code, "200") == 0)
+        && ptr_output && (strcmp (ptr_output, "hello") == 0))
+    {
+        test_url_ok++;
+    }
+
+    return WEECHAT_RC_OK;
+}
+
+/*
+ * Run the main loop until count URL transfers are done (max 10 seconds).
+ */
+
+void
+test_url_wait (int count)
+{
+    int i;
+
+    for (i = 0; (i < 10000) && (test_url_done < count); i++)
+    {
+        hook_fd_exec ();
+        hook_timer_exec ();
+    }
+}
+
 /*
  * Test functions:
  *   hook_url_get_description
@@ -66,20 +126,25 @@ TEST(HookUrl, RunCallback)
 
 /*
  * Test functions:
- *   hook_url_thread_cleanup
+ *   hook_url_transfer_remove
  */
 
-TEST(HookUrl, ThreadCleanup)
+TEST(HookUrl, TransferRemove)
 {
     /* TODO: write tests */
 }
 
 /*
  * Test functions:
- *   hook_url_transfer_thread
+ *   hook_url_multi_check_done
+ *   hook_url_multi_fd_cb
+ *   hook_url_multi_timer_cb
+ *   hook_url_multi_socket_cb
+ *   hook_url_multi_timer_set_cb
+ *   hook_url_multi_init
  */
 
-TEST(HookUrl, TransferThread)
+TEST(HookUrl, Multi)
 {
     /* TODO: write tests */
 }
@@ -91,7 +156,26 @@ TEST(HookUrl, TransferThread)
 
 TEST(HookUrl, TimerCb)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    char url[256];
+
+    CHECK(http_server_start ());
+
+    /* timeout reached */
+    test_url_done = 0;
+    test_url_ok = 0;
+    snprintf (url, sizeof (url),
+              "http://127.0.0.1:%d/slow", http_server_port);
+    hook = hook_url (NULL, url, NULL, 100, &test_url_cb, NULL, NULL);
+    CHECK(hook);
+    CHECK(HOOK_URL(hook, transfer));
+    CHECK(HOOK_URL(hook, hook_timer));
+    test_url_wait (1);
+    LONGS_EQUAL(1, test_url_done);
+    LONGS_EQUAL(0, test_url_ok);
+    STRCMP_EQUAL("6", test_url_error_code);
+
+    http_server_end ();
 }
 
 /*
@@ -101,7 +185,41 @@ TEST(HookUrl, TimerCb)
 
 TEST(HookUrl, Transfer)
 {
-    /* TODO: write tests */
+    struct t_hook *hook;
+    char url[256];
+    int i;
+
+    CHECK(http_server_start ());
+
+    snprintf (url, sizeof (url),
+              "http://127.0.0.1:%d/test", http_server_port);
+
+    /* single transfer */
+    test_url_done = 0;
+    test_url_ok = 0;
+    hook = hook_url (NULL, url, NULL, 10000, &test_url_cb, NULL, NULL);
+    CHECK(hook);
+    CHECK(HOOK_URL(hook, transfer));
+    test_url_wait (1);
+    LONGS_EQUAL(1, test_url_done);
+    LONGS_EQUAL(1, test_url_ok);
+    STRCMP_EQUAL("", test_url_error_code);
+
+    /* many transfers at once: connections are limited and reused */
+    config_file_option_set (config_network_url_max_host_connections, "4", 1);
+    test_url_done = 0;
+    test_url_ok = 0;
+    for (i = 0; i < TEST_URL_COUNT; i++)
+    {
+        CHECK(hook_url (NULL, url, NULL, 10000, &test_url_cb, NULL, NULL));
+    }
+    test_url_wait (TEST_URL_COUNT);
+    LONGS_EQUAL(TEST_URL_COUNT, test_url_done);
+    LONGS_EQUAL(TEST_URL_COUNT, test_url_ok);
+    CHECK(http_server_connections <= 4);
+    config_file_option_reset (config_network_url_max_host_connections, 1);
+
+    http_server_end ();
 }
 
 /*
@@ -111,7 +229,35 @@ TEST(HookUrl, Transfer)
 
 TEST(HookUrl, Url)
 {
-    /* TODO: write tests */
+    struct t_hashtable *options;
+    struct t_hook *hook;
+
+    POINTERS_EQUAL(NULL, hook_url (NULL, NULL, NULL, 0,
+                                   &test_url_cb, NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_url (NULL, "", NULL, 0,
+                                   &test_url_cb, NULL, NULL));
+    POINTERS_EQUAL(NULL, hook_url (NULL, "http://127.0.0.1/", NULL, 0,
+                                   NULL, NULL, NULL));
+
+    /* error on file: callback is called in the next main loop */
+    options = hashtable_new (32,
+                             WEECHAT_HASHTABLE_STRING,
+                             WEECHAT_HASHTABLE_STRING,
+                             NULL, NULL);
+    CHECK(options);
+    hashtable_set (options, "file_in", "/nonexistent/file");
+    test_url_done = 0;
+    test_url_ok = 0;
+    hook = hook_url (NULL, "http://127.0.0.1/", options, 0,
+                     &test_url_cb, NULL, NULL);
+    CHECK(hook);
+    POINTERS_EQUAL(NULL, HOOK_URL(hook, transfer));
+    LONGS_EQUAL(0, test_url_done);
+    test_url_wait (1);
+    LONGS_EQUAL(1, test_url_done);
+    LONGS_EQUAL(0, test_url_ok);
+    STRCMP_EQUAL("4", test_url_error_code);
+    hashtable_free (options);
 }
 
 /*
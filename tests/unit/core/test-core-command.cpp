@@ -35,6 +35,7 @@ extern "C"
 #include "src/core/weechat.h"
 #include "src/core/core-command.h"
 #include "src/core/core-debug.h"
+#include "src/core/core-hook.h"
 #include "src/core/core-input.h"
 #include "src/core/core-string.h"
 #include "src/core/core-url.h"
@@ -739,6 +740,12 @@ TEST(CoreCommand, Debug)
     WEE_CHECK_MSG_REGEX_CORE("TERM=.*COLORS:.*COLOR_PAIRS:.*");
     WEE_CHECK_MSG_REGEX_CORE("WeeChat colors");
 
+    /* /debug config */
+    WEE_CMD_CORE("/debug config");
+    WEE_CHECK_MSG_REGEX_CORE("configuration files \\(last read");
+    WEE_CHECK_MSG_REGEX_CORE(" weechat\\.conf$");
+    WEE_CHECK_MSG_REGEX_CORE(" \\(total\\)$");
+
     /* /debug cursor */
     LONGS_EQUAL(0, gui_cursor_debug);
     WEE_CMD_CORE("/debug cursor");
@@ -784,6 +791,26 @@ TEST(CoreCommand, Debug)
     WEE_CMD_CORE("/debug hooks irc timer");
     WEE_CHECK_MSG_REGEX_CORE("hooks \\([0-9]+\\):");
 
+    /* /debug hooks profile */
+    WEE_CMD_CORE_ERROR_GENERIC("/debug hooks profile xxx");
+    LONGS_EQUAL(0, hook_profile_enabled);
+    WEE_CMD_CORE("/debug hooks profile enable");
+    LONGS_EQUAL(1, hook_profile_enabled);
+    WEE_CHECK_MSG_CORE("", "Profiling of hooks enabled");
+    WEE_CMD_CORE("/debug hooks profile");
+    WEE_CHECK_MSG_CORE("", "hooks profile (enabled, sort: total, "
+                       "times in microseconds):");
+    WEE_CMD_CORE("/debug hooks profile max");
+    WEE_CHECK_MSG_CORE("", "hooks profile (enabled, sort: max, "
+                       "times in microseconds):");
+    WEE_CMD_CORE("/debug hooks profile disable");
+    LONGS_EQUAL(0, hook_profile_enabled);
+    WEE_CHECK_MSG_CORE("", "Profiling of hooks disabled");
+    WEE_CMD_CORE("/debug hooks profile reset");
+    WEE_CHECK_MSG_CORE("", "Profiling data of hooks reset");
+    WEE_CMD_CORE("/debug hooks profile");
+    WEE_CHECK_MSG_CORE("", "  (no data)");
+
     /* /debug infolists */
     WEE_CMD_CORE("/debug infolists");
     WEE_CHECK_MSG_REGEX_CORE("[0-9]+ infolists in memory");
@@ -798,6 +825,32 @@ TEST(CoreCommand, Debug)
     WEE_CMD_CORE("/debug libs");
     WEE_CHECK_MSG_CORE("", "Libs:");
 
+    /* /debug loop */
+    WEE_CMD_CORE_ERROR_GENERIC("/debug loop xxx");
+    WEE_CMD_CORE_MIN_ARGS("/debug loop stall", "/debug loop stall");
+    WEE_CMD_CORE_ERROR_GENERIC("/debug loop stall xxx");
+    LONGS_EQUAL(0, debug_loop_enabled);
+    WEE_CMD_CORE("/debug loop enable");
+    LONGS_EQUAL(1, debug_loop_enabled);
+    WEE_CHECK_MSG_CORE("", "Debug enabled for main loop");
+    WEE_CMD_CORE("/debug loop");
+    WEE_CHECK_MSG_REGEX_CORE("main loop \\(enabled, stall threshold: -, "
+                             "iterations: [0-9]+, stalls: 0, "
+                             "times in microseconds\\):");
+    WEE_CMD_CORE("/debug loop disable");
+    LONGS_EQUAL(0, debug_loop_enabled);
+    WEE_CHECK_MSG_CORE("", "Debug disabled for main loop");
+    WEE_CMD_CORE("/debug loop reset");
+    WEE_CHECK_MSG_CORE("", "Main loop stats reset");
+    CHECK(debug_loop_stall == 0);
+    WEE_CMD_CORE("/debug loop stall 250ms");
+    CHECK(debug_loop_stall == 250000);
+    WEE_CHECK_MSG_CORE("", "Debug enabled for main loop stalls "
+                       "(threshold: 0:00:00.250000)");
+    WEE_CMD_CORE("/debug loop stall 0");
+    CHECK(debug_loop_stall == 0);
+    WEE_CHECK_MSG_CORE("", "Debug disabled for main loop stalls");
+
     /* /debug memory */
     WEE_CMD_CORE("/debug memory");
     WEE_CHECK_MSG_REGEX_CORE("Memory usage");
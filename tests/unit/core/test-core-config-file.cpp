@@ -27,18 +27,27 @@
 
 extern "C"
 {
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include "src/core/core-arraylist.h"
 #include "src/core/core-config-file.h"
 #include "src/core/core-config.h"
 #include "src/core/core-secure-config.h"
+#include "src/core/core-string.h"
+#include "src/core/weechat.h"
 #include "src/gui/gui-color.h"
 #include "src/plugins/plugin.h"
 #include "src/plugins/plugin-config.h"
 
 extern struct t_config_file *config_file_find_pos (const char *name);
 extern char *config_file_option_full_name (struct t_config_option *option);
+extern int config_file_write_internal (struct t_config_file *config_file,
+                                       int default_options);
 extern int config_file_string_boolean_is_valid (const char *text);
+extern char *config_file_load (int fd, size_t *size);
 extern const char *config_file_option_escape (const char *name);
 }
 
@@ -57,6 +66,43 @@ struct t_config_option *ptr_option_enum_child = NULL;
 
 TEST_GROUP(CoreConfigFile)
 {
+    static int write_section_cb (const void *pointer, void *data,
+                                 struct t_config_file *config_file,
+                                 const char *section_name)
+    {
+        struct t_config_section *ptr_section;
+        struct t_config_option *ptr_option;
+
+        (void) data;
+
+        (*((int *)pointer))++;
+
+        if (!config_file_write_line (config_file, section_name, NULL))
+            return WEECHAT_CONFIG_WRITE_ERROR;
+        ptr_section = config_file_search_section (config_file, section_name);
+        for (ptr_option = ptr_section->options; ptr_option;
+             ptr_option = ptr_option->next_option)
+        {
+            if (!config_file_write_option (config_file, ptr_option))
+                return WEECHAT_CONFIG_WRITE_ERROR;
+        }
+        return WEECHAT_CONFIG_WRITE_OK;
+    }
+
+    static int write_section_lines_cb (const void *pointer, void *data,
+                                       struct t_config_file *config_file,
+                                       const char *section_name)
+    {
+        (void) data;
+
+        (*((int *)pointer))++;
+
+        if (!config_file_write_line (config_file, section_name, NULL))
+            return WEECHAT_CONFIG_WRITE_ERROR;
+        if (!config_file_write_line (config_file, "line", "%s", "\"value\""))
+            return WEECHAT_CONFIG_WRITE_ERROR;
+        return WEECHAT_CONFIG_WRITE_OK;
+    }
 };
 
 TEST_GROUP(CoreConfigFileWithNewOptions)
@@ -1195,7 +1241,84 @@ TEST(CoreConfigFile, OptionUnset)
 
 TEST(CoreConfigFile, OptionRename)
 {
-    /* TODO: write tests */
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section;
+    struct t_config_option *ptr_option1, *ptr_option2, *ptr_option3;
+
+    ptr_config = config_file_new (NULL, "test_rename", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section = config_file_new_section (ptr_config, "section1",
+                                           0, 0,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL);
+    CHECK(ptr_section);
+    ptr_option2 = config_file_new_option (
+        ptr_config, ptr_section,
+        "option_b", "integer", "", NULL, 0, 100, "2", NULL, 0,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL);
+    ptr_option1 = config_file_new_option (
+        ptr_config, ptr_section,
+        "option_a", "integer", "", NULL, 0, 100, "1", NULL, 0,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL);
+    ptr_option3 = config_file_new_option (
+        ptr_config, ptr_section,
+        "option_c", "integer", "", NULL, 0, 100, "3", NULL, 0,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL);
+    CHECK(ptr_option1);
+    CHECK(ptr_option2);
+    CHECK(ptr_option3);
+
+    /* options are sorted by name */
+    POINTERS_EQUAL(ptr_option1, ptr_section->options);
+    POINTERS_EQUAL(ptr_option2, ptr_option1->next_option);
+    POINTERS_EQUAL(ptr_option3, ptr_option2->next_option);
+    POINTERS_EQUAL(ptr_option3, ptr_section->last_option);
+
+    /* invalid arguments or name already used: no rename */
+    config_file_option_rename (NULL, NULL);
+    config_file_option_rename (ptr_option1, NULL);
+    config_file_option_rename (ptr_option1, "");
+    config_file_option_rename (ptr_option1, "option_b");
+    STRCMP_EQUAL("option_a", ptr_option1->name);
+    POINTERS_EQUAL(ptr_option2,
+                   config_file_search_option (ptr_config, ptr_section,
+                                              "option_b"));
+
+    /* rename option: it is moved in list and in index */
+    config_file_option_rename (ptr_option1, "option_z");
+    STRCMP_EQUAL("option_z", ptr_option1->name);
+    POINTERS_EQUAL(NULL,
+                   config_file_search_option (ptr_config, ptr_section,
+                                              "option_a"));
+    POINTERS_EQUAL(ptr_option1,
+                   config_file_search_option (ptr_config, ptr_section,
+                                              "option_z"));
+    POINTERS_EQUAL(ptr_option1,
+                   config_file_search_option (ptr_config, NULL, "option_z"));
+    POINTERS_EQUAL(ptr_option2, ptr_section->options);
+    POINTERS_EQUAL(ptr_option3, ptr_option2->next_option);
+    POINTERS_EQUAL(ptr_option1, ptr_option3->next_option);
+    POINTERS_EQUAL(ptr_option1, ptr_section->last_option);
+
+    /* free option: it is removed from index */
+    config_file_option_free (ptr_option3, 0);
+    POINTERS_EQUAL(NULL,
+                   config_file_search_option (ptr_config, ptr_section,
+                                              "option_c"));
+    POINTERS_EQUAL(ptr_option2,
+                   config_file_search_option (ptr_config, ptr_section,
+                                              "option_b"));
+
+    config_file_free (ptr_config);
 }
 
 /*
@@ -1585,7 +1708,108 @@ TEST(CoreConfigFile, WriteLine)
 
 TEST(CoreConfigFile, WriteInternal)
 {
-    /* TODO: write tests */
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section1, *ptr_section2;
+    struct t_config_option *ptr_option;
+    char *filename;
+    int count_cb, count_lines_cb;
+
+    count_cb = 0;
+    count_lines_cb = 0;
+
+    ptr_config = config_file_new (NULL, "test_write", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section1 = config_file_new_section (ptr_config, "section1",
+                                            0, 0,
+                                            NULL, NULL, NULL,
+                                            &write_section_cb, &count_cb, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL);
+    CHECK(ptr_section1);
+    ptr_option = config_file_new_option (
+        ptr_config, ptr_section1,
+        "option1", "integer", "", NULL, 0, 100, "1", NULL, 0,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL,
+        NULL, NULL, NULL);
+    CHECK(ptr_option);
+
+    string_asprintf (&filename, "%s/test_write.conf", weechat_config_dir);
+    unlink (filename);
+
+    /* first write */
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(0, access (filename, F_OK));
+    LONGS_EQUAL(1, count_cb);
+    LONGS_EQUAL(ptr_config->generation, ptr_config->generation_written);
+    LONGS_EQUAL(ptr_section1->generation, ptr_section1->generation_written);
+
+    /* nothing changed: file not written */
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(1, count_cb);
+
+    /* option changed: file written */
+    LONGS_EQUAL(WEECHAT_CONFIG_OPTION_SET_OK_CHANGED,
+                config_file_option_set (ptr_option, "2", 1));
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(2, count_cb);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(2, count_cb);
+
+    /* file removed from disk: file written */
+    unlink (filename);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(0, access (filename, F_OK));
+    LONGS_EQUAL(3, count_cb);
+
+    /* write of default options: next write is done */
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK,
+                config_file_write_internal (ptr_config, 1));
+    LONGS_EQUAL(-1, ptr_config->generation_written);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(4, count_cb);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(4, count_cb);
+
+    /* new option: file written */
+    CHECK(config_file_new_option (
+              ptr_config, ptr_section1,
+              "option2", "integer", "", NULL, 0, 100, "1", NULL, 0,
+              NULL, NULL, NULL,
+              NULL, NULL, NULL,
+              NULL, NULL, NULL));
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(5, count_cb);
+
+    /* section written with other lines than options: always written */
+    ptr_section2 = config_file_new_section (ptr_config, "section2",
+                                            0, 0,
+                                            NULL, NULL, NULL,
+                                            &write_section_lines_cb,
+                                            &count_lines_cb, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL);
+    CHECK(ptr_section2);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(6, count_cb);
+    LONGS_EQUAL(1, count_lines_cb);
+    LONGS_EQUAL(-1, ptr_section2->generation_written);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(7, count_cb);
+    LONGS_EQUAL(2, count_lines_cb);
+
+    /* section removed: file written, then not written */
+    config_file_section_free (ptr_section2);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(8, count_cb);
+    LONGS_EQUAL(WEECHAT_CONFIG_WRITE_OK, config_file_write (ptr_config));
+    LONGS_EQUAL(8, count_cb);
+
+    config_file_free (ptr_config);
+    unlink (filename);
+    free (filename);
 }
 
 /*
@@ -1598,6 +1822,64 @@ TEST(CoreConfigFile, Write)
     /* TODO: write tests */
 }
 
+/*
+ * Test functions:
+ *   config_file_load
+ */
+
+TEST(CoreConfigFile, Load)
+{
+    char *filename, *content;
+    size_t size;
+    int fd, fd_pipe[2];
+    FILE *file;
+
+    POINTERS_EQUAL(NULL, config_file_load (-1, NULL));
+    POINTERS_EQUAL(NULL, config_file_load (-1, &size));
+
+    /* regular file */
+    string_asprintf (&filename, "%s/test_load.conf", weechat_config_dir);
+    file = fopen (filename, "w");
+    CHECK(file);
+    fputs ("[section]\noption = value\n", file);
+    fclose (file);
+    fd = open (filename, O_RDONLY);
+    CHECK(fd >= 0);
+    content = config_file_load (fd, &size);
+    CHECK(content);
+    LONGS_EQUAL(25, size);
+    STRCMP_EQUAL("[section]\noption = value\n", content);
+
+    /* file truncated after load: content is not changed */
+    LONGS_EQUAL(0, truncate (filename, 0));
+    STRCMP_EQUAL("[section]\noption = value\n", content);
+    close (fd);
+    free (content);
+
+    /* empty file */
+    file = fopen (filename, "w");
+    CHECK(file);
+    fclose (file);
+    fd = open (filename, O_RDONLY);
+    CHECK(fd >= 0);
+    POINTERS_EQUAL(NULL, config_file_load (fd, &size));
+    close (fd);
+    LONGS_EQUAL(0, size);
+    unlink (filename);
+    free (filename);
+
+    /* pipe */
+    LONGS_EQUAL(0, pipe (fd_pipe));
+    LONGS_EQUAL(14, write (fd_pipe[1], "option = value", 14));
+    close (fd_pipe[1]);
+    content = config_file_load (fd_pipe[0], &size);
+    close (fd_pipe[0]);
+    CHECK(content);
+    LONGS_EQUAL(14, size);
+    STRCMP_EQUAL("option = value", content);
+    free (content);
+}
+
 /*
  * Test functions:
  *   config_file_read
@@ -1605,7 +1887,90 @@ TEST(CoreConfigFile, Write)
 
 TEST(CoreConfigFile, Read)
 {
-    /* TODO: write tests */
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section;
+    struct t_config_option *ptr_option[6];
+    char *filename, name[32];
+    const char *content;
+    int i;
+    FILE *file;
+
+    ptr_config = config_file_new (NULL, "test_read", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section = config_file_new_section (ptr_config, "section",
+                                           0, 0,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL,
+                                           NULL, NULL, NULL);
+    CHECK(ptr_section);
+    for (i = 0; i < 6; i++)
+    {
+        snprintf (name, sizeof (name), "option%d", i + 1);
+        ptr_option[i] = config_file_new_option (
+            ptr_config, ptr_section,
+            name, "string", "", NULL, 0, 0, "default", NULL, 1,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL,
+            NULL, NULL, NULL);
+        CHECK(ptr_option[i]);
+    }
+
+    content =
+        "#\n"
+        "# test_read.conf\n"
+        "#\n"
+        "\n"
+        "config_version = 1\r\n"
+        "\n"
+        "[unknown]\n"
+        "option1 = \"ignored\"\n"
+        "\n"
+        "[section]\n"
+        "  option1 = \"value with spaces\"   \n"
+        "option2   =   'single quotes'\r\n"
+        "option3 = unquoted  \n"
+        "option4 = null\n"
+        "\\option5 = \"\"\n"
+        "unknown = \"value\"\n"
+        "option6 = \"last line\"";
+
+    string_asprintf (&filename, "%s/test_read.conf", weechat_config_dir);
+    file = fopen (filename, "w");
+    CHECK(file);
+    fputs (content, file);
+    fclose (file);
+
+    LONGS_EQUAL(WEECHAT_CONFIG_READ_OK, config_file_read (ptr_config));
+
+    STRCMP_EQUAL("value with spaces", CONFIG_STRING(ptr_option[0]));
+    STRCMP_EQUAL("single quotes", CONFIG_STRING(ptr_option[1]));
+    STRCMP_EQUAL("unquoted", CONFIG_STRING(ptr_option[2]));
+    POINTERS_EQUAL(NULL, ptr_option[3]->value);
+    STRCMP_EQUAL("", CONFIG_STRING(ptr_option[4]));
+    STRCMP_EQUAL("last line", CONFIG_STRING(ptr_option[5]));
+
+    LONGS_EQUAL(1, ptr_config->version_read);
+    LONGS_EQUAL(1, ptr_config->read_count);
+    LONGS_EQUAL(17, ptr_config->read_lines);
+    LONGS_EQUAL((long long)strlen (content), ptr_config->read_size);
+    CHECK(ptr_config->read_time >= 0);
+
+    /* reload: options not in file are reset */
+    file = fopen (filename, "w");
+    CHECK(file);
+    fputs ("[section]\noption1 = \"new value\"\n", file);
+    fclose (file);
+    LONGS_EQUAL(WEECHAT_CONFIG_READ_OK, config_file_reload (ptr_config));
+    STRCMP_EQUAL("new value", CONFIG_STRING(ptr_option[0]));
+    STRCMP_EQUAL("default", CONFIG_STRING(ptr_option[1]));
+    LONGS_EQUAL(2, ptr_config->read_count);
+    LONGS_EQUAL(2, ptr_config->read_lines);
+
+    config_file_free (ptr_config);
+    unlink (filename);
+    free (filename);
 }
 
 /*
@@ -1656,7 +2021,50 @@ TEST(CoreConfigFile, SectionFreeOptions)
 
 TEST(CoreConfigFile, SectionFree)
 {
-    /* TODO: write tests */
+    struct t_config_file *ptr_config;
+    struct t_config_section *ptr_section1, *ptr_section2;
+
+    ptr_config = config_file_new (NULL, "test_section_free", NULL, NULL, NULL);
+    CHECK(ptr_config);
+    ptr_section1 = config_file_new_section (ptr_config, "section1",
+                                            0, 0,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL);
+    ptr_section2 = config_file_new_section (ptr_config, "section2",
+                                            0, 0,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL);
+    CHECK(ptr_section1);
+    CHECK(ptr_section2);
+    POINTERS_EQUAL(ptr_section1,
+                   config_file_search_section (ptr_config, "section1"));
+
+    config_file_section_free (ptr_section1);
+    POINTERS_EQUAL(NULL,
+                   config_file_search_section (ptr_config, "section1"));
+    POINTERS_EQUAL(ptr_section2,
+                   config_file_search_section (ptr_config, "section2"));
+    POINTERS_EQUAL(ptr_section2, ptr_config->sections);
+
+    /* section can be created again with same name */
+    ptr_section1 = config_file_new_section (ptr_config, "section1",
+                                            0, 0,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL,
+                                            NULL, NULL, NULL);
+    CHECK(ptr_section1);
+    POINTERS_EQUAL(ptr_section1,
+                   config_file_search_section (ptr_config, "section1"));
+
+    config_file_free (ptr_config);
 }
 
 /*
@@ -40,9 +40,22 @@ extern "C"
 #include "src/gui/gui-line.h"
 #include "src/gui/gui-color.h"
 #include "src/plugins/plugin.h"
+
+extern char *eval_replace_vars (const char *expr,
+                                struct t_eval_context *eval_context);
+extern char *eval_expression_condition (const char *expr,
+                                        struct t_eval_context *eval_context);
+extern char *eval_replace_vars_cached (const char *expr,
+                                       struct t_eval_context *eval_context);
+extern char *eval_expression_condition_cached (const char *expr,
+                                               struct t_eval_context *eval_context);
 }
 
+/* expression is evaluated twice: the second time, it is in cache */
 #define WEE_CHECK_EVAL(__result, __expr)                                \
+    value = eval_expression (__expr, pointers, extra_vars, options);    \
+    STRCMP_EQUAL(__result, value);                                      \
+    free (value);                                                       \
     value = eval_expression (__expr, pointers, extra_vars, options);    \
     STRCMP_EQUAL(__result, value);                                      \
     free (value);
@@ -1153,6 +1166,7 @@ TEST(CoreEval, EvalReplaceRegex)
     struct t_hashtable *pointers, *extra_vars, *options;
     char *value;
     regex_t regex;
+    struct t_string_regex *string_regex;
 
     pointers = hashtable_new (32,
                               WEECHAT_HASHTABLE_STRING,
@@ -1236,6 +1250,20 @@ TEST(CoreEval, EvalReplaceRegex)
     WEE_CHECK_EVAL("password=*** password=***",
                    "password=abc password=def");
     regfree (&regex);
+    hashtable_remove (pointers, "regex");
+
+    /* hide passwords (regex compiled with string_regex_new) */
+    string_regex = string_regex_new ("(password=)([^ ]+)",
+                                     REG_EXTENDED | REG_ICASE);
+    CHECK(string_regex);
+    hashtable_set (pointers, "string_regex", string_regex);
+    hashtable_remove (options, "regex");
+    hashtable_set (options, "regex_replace", "${re:1}${hide:*,${re:2}}");
+    WEE_CHECK_EVAL("password=*** password=***",
+                   "password=abc password=def");
+    string_regex_free (string_regex);
+    free (string_regex);
+    hashtable_remove (pointers, "string_regex");
 
     /* regex groups */
     hashtable_remove (pointers, "regex");
@@ -1266,3 +1294,132 @@ TEST(CoreEval, EvalReplaceRegex)
     hashtable_free (extra_vars);
     hashtable_free (options);
 }
+
+/*
+ * Test functions:
+ *   eval_compiled_get
+ *   eval_compiled_free
+ *   eval_end
+ */
+
+TEST(CoreEval, EvalCache)
+{
+    struct t_hashtable *extra_vars, *options;
+    struct t_eval_compiled *ptr_compiled;
+    char *value, str_expr[64];
+    int i;
+
+    extra_vars = hashtable_new (32,
+                                WEECHAT_HASHTABLE_STRING,
+                                WEECHAT_HASHTABLE_STRING,
+                                NULL, NULL);
+    CHECK(extra_vars);
+    hashtable_set (extra_vars, "test", "value");
+
+    options = hashtable_new (32,
+                             WEECHAT_HASHTABLE_STRING,
+                             WEECHAT_HASHTABLE_STRING,
+                             NULL, NULL);
+    CHECK(options);
+
+    eval_end ();
+    POINTERS_EQUAL(NULL, eval_hashtable_compiled);
+    POINTERS_EQUAL(NULL, eval_compiled_first);
+    POINTERS_EQUAL(NULL, eval_compiled_last);
+
+    /* expression */
+    value = eval_expression ("a${test}b", NULL, extra_vars, NULL);
+    STRCMP_EQUAL("avalueb", value);
+    free (value);
+    LONGS_EQUAL(1, eval_hashtable_compiled->items_count);
+    CHECK(hashtable_has_key (eval_hashtable_compiled,
+                             "r${\001}\001a${test}b"));
+    CHECK(eval_compiled_first);
+    POINTERS_EQUAL(eval_compiled_first, eval_compiled_last);
+    LONGS_EQUAL(EVAL_NODE_REPLACE, eval_compiled_first->node->type);
+    LONGS_EQUAL(3, eval_compiled_first->node->count);
+    LONGS_EQUAL(EVAL_NODE_TEXT,
+                eval_compiled_first->node->children[0]->type);
+    LONGS_EQUAL(EVAL_NODE_VARIABLE,
+                eval_compiled_first->node->children[1]->type);
+    STRCMP_EQUAL("test", eval_compiled_first->node->children[1]->text);
+    LONGS_EQUAL(EVAL_NODE_TEXT,
+                eval_compiled_first->node->children[2]->type);
+
+    /* same expression: compiled expression is reused */
+    ptr_compiled = eval_compiled_first;
+    value = eval_expression ("a${test}b", NULL, extra_vars, NULL);
+    STRCMP_EQUAL("avalueb", value);
+    free (value);
+    LONGS_EQUAL(1, eval_hashtable_compiled->items_count);
+    POINTERS_EQUAL(ptr_compiled, eval_compiled_first);
+
+    /* condition */
+    hashtable_set (options, "type", "condition");
+    value = eval_expression ("${test} == value && 1", NULL, extra_vars,
+                             options);
+    STRCMP_EQUAL("1", value);
+    free (value);
+    LONGS_EQUAL(2, eval_hashtable_compiled->items_count);
+    CHECK(hashtable_has_key (eval_hashtable_compiled,
+                             "c${\001}\001${test} == value && 1"));
+    LONGS_EQUAL(EVAL_NODE_LOGICAL_OP, eval_compiled_first->node->type);
+    LONGS_EQUAL(EVAL_LOGICAL_OP_AND, eval_compiled_first->node->op);
+    LONGS_EQUAL(EVAL_NODE_COMPARISON,
+                eval_compiled_first->node->children[0]->type);
+    POINTERS_EQUAL(ptr_compiled, eval_compiled_last);
+
+    /* custom prefix/suffix */
+    hashtable_remove (options, "type");
+    hashtable_set (options, "prefix", "%(");
+    hashtable_set (options, "suffix", ")");
+    value = eval_expression ("a${test}b", NULL, extra_vars, options);
+    STRCMP_EQUAL("a${test}b", value);
+    free (value);
+    LONGS_EQUAL(3, eval_hashtable_compiled->items_count);
+    CHECK(hashtable_has_key (eval_hashtable_compiled,
+                             "r%(\001)\001a${test}b"));
+    hashtable_remove (options, "prefix");
+    hashtable_remove (options, "suffix");
+
+    /* use of first expression: it becomes the most recently used */
+    value = eval_expression ("a${test}b", NULL, extra_vars, NULL);
+    free (value);
+    POINTERS_EQUAL(ptr_compiled, eval_compiled_first);
+    POINTERS_EQUAL(NULL, ptr_compiled->prev_compiled);
+
+    /* fill the cache: least recently used expressions are removed */
+    for (i = 0; i < EVAL_CACHE_MAX_SIZE; i++)
+    {
+        snprintf (str_expr, sizeof (str_expr), "${test}%d", i);
+        value = eval_expression (str_expr, NULL, extra_vars, NULL);
+        free (value);
+        if (i == EVAL_CACHE_MAX_SIZE - 4)
+        {
+            CHECK(hashtable_has_key (eval_hashtable_compiled,
+                                     "r${\001}\001a${test}b"));
+            value = eval_expression ("a${test}b", NULL, extra_vars, NULL);
+            free (value);
+        }
+    }
+    LONGS_EQUAL(EVAL_CACHE_MAX_SIZE, eval_hashtable_compiled->items_count);
+    CHECK(hashtable_has_key (eval_hashtable_compiled,
+                             "r${\001}\001a${test}b"));
+    CHECK(!hashtable_has_key (eval_hashtable_compiled,
+                              "c${\001}\001${test} == value && 1"));
+    CHECK(!hashtable_has_key (eval_hashtable_compiled,
+                              "r${\001}\001${test}0"));
+    CHECK(!hashtable_has_key (eval_hashtable_compiled,
+                              "r%(\001)\001a${test}b"));
+    CHECK(hashtable_has_key (eval_hashtable_compiled,
+                             "r${\001}\001${test}1"));
+    STRCMP_EQUAL("r${\001}\001${test}1", eval_compiled_last->key);
+
+    eval_end ();
+    POINTERS_EQUAL(NULL, eval_hashtable_compiled);
+    POINTERS_EQUAL(NULL, eval_compiled_first);
+    POINTERS_EQUAL(NULL, eval_compiled_last);
+
+    hashtable_free (extra_vars);
+    hashtable_free (options);
+}
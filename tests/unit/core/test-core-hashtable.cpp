@@ -40,7 +40,9 @@ extern "C"
 #define HASHTABLE_TEST_KEY_LONG_HASH 11232856562070989738ULL
 #define HASHTABLE_TEST_VALUE         "this is a value"
 
+
 char *test_map_string = NULL;
+int test_map_count = 0;
 
 TEST_GROUP(CoreHashtable)
 {
@@ -79,6 +81,201 @@ TEST(CoreHashtable, HashDbj2)
     CHECK(hash == HASHTABLE_TEST_KEY_LONG_HASH);
 }
 
+/*
+ * Test functions:
+ *   hashtable_init_seed
+ *   hashtable_hash_key_string
+ */
+
+TEST(CoreHashtable, HashString)
+{
+    unsigned long long hash, hashes[64], seed;
+    char string[64];
+    int i, j;
+
+    /* the seed is set on first hashtable created */
+    CHECK(hashtable_seed != 0);
+
+    LONGS_EQUAL(0, hashtable_hash_key_string (NULL));
+
+    hash = hashtable_hash_key_string (HASHTABLE_TEST_KEY);
+    CHECK(hash == hashtable_hash_key_string (HASHTABLE_TEST_KEY));
+    CHECK(hash != hashtable_hash_key_string (HASHTABLE_TEST_KEY_LONG));
+
+    /* all lengths (with all code paths) give different hashes */
+    for (i = 0; i < 63; i++)
+    {
+        string[i] = 'a' + (i % 26);
+        string[i + 1] = '\0';
+        hashes[i] = hashtable_hash_key_string (string);
+        CHECK(hashes[i] == hashtable_hash_key_string (string));
+        for (j = 0; j < i; j++)
+        {
+            CHECK(hashes[i] != hashes[j]);
+        }
+    }
+    hash = hashtable_hash_key_string ("");
+    for (i = 0; i < 63; i++)
+    {
+        CHECK(hash != hashes[i]);
+    }
+
+    /* each byte has an effect on the hash */
+    snprintf (string, sizeof (string), "%s", HASHTABLE_TEST_KEY_LONG);
+    hash = hashtable_hash_key_string (string);
+    for (i = 0; string[i]; i++)
+    {
+        string[i]++;
+        CHECK(hash != hashtable_hash_key_string (string));
+        string[i]--;
+    }
+    CHECK(hash == hashtable_hash_key_string (string));
+
+    /* the hash depends on the seed */
+    seed = hashtable_seed;
+    hashtable_seed = seed + 1;
+    CHECK(hash != hashtable_hash_key_string (string));
+    hashtable_seed = seed;
+    CHECK(hash == hashtable_hash_key_string (string));
+}
+
+/*
+ * Test functions:
+ *   hashtable_hash_key_integer
+ *   hashtable_hash_key_default_cb
+ */
+
+TEST(CoreHashtable, HashInteger)
+{
+    struct t_hashtable *hashtable;
+    unsigned long long hash, seed;
+    int i, value_int, low_bits[8];
+    long long value_longlong;
+
+    hash = hashtable_hash_key_integer (0);
+    CHECK(hash == hashtable_hash_key_integer (0));
+    CHECK(hash != hashtable_hash_key_integer (1));
+
+    /* aligned pointers must use all buckets */
+    memset (low_bits, 0, sizeof (low_bits));
+    for (i = 0; i < 64; i++)
+    {
+        low_bits[hashtable_hash_key_integer (0x1000 + (i * 64)) & 7]++;
+    }
+    for (i = 0; i < 8; i++)
+    {
+        CHECK(low_bits[i] > 0);
+    }
+
+    /* the hash depends on the seed */
+    seed = hashtable_seed;
+    hashtable_seed = seed + 1;
+    CHECK(hash != hashtable_hash_key_integer (0));
+    hashtable_seed = seed;
+
+    /* default callback */
+    hashtable = hashtable_new (8,
+                               WEECHAT_HASHTABLE_INTEGER,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    value_int = 123;
+    CHECK(hashtable_hash_key_integer (123)
+          == hashtable->callback_hash_key (hashtable, &value_int));
+    LONGS_EQUAL(0, hashtable->callback_hash_key (hashtable, NULL));
+    hashtable_free (hashtable);
+
+    hashtable = hashtable_new (8,
+                               WEECHAT_HASHTABLE_LONGLONG,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    value_longlong = 123456789012LL;
+    CHECK(hashtable_hash_key_integer (123456789012ULL)
+          == hashtable->callback_hash_key (hashtable, &value_longlong));
+    hashtable_free (hashtable);
+
+    hashtable = hashtable_new (8,
+                               WEECHAT_HASHTABLE_POINTER,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    CHECK(hashtable_hash_key_integer (0x1234)
+          == hashtable->callback_hash_key (hashtable, (void *)0x1234));
+    hashtable_free (hashtable);
+
+    hashtable = hashtable_new (8,
+                               WEECHAT_HASHTABLE_STRING,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    CHECK(hashtable_hash_key_string (HASHTABLE_TEST_KEY)
+          == hashtable->callback_hash_key (hashtable, HASHTABLE_TEST_KEY));
+    hashtable_free (hashtable);
+}
+
+/*
+ * Test functions:
+ *   hashtable_set_with_size (hash stored in item)
+ *   hashtable_get_item
+ *   hashtable_rehash
+ */
+
+TEST(CoreHashtable, HashStored)
+{
+    struct t_hashtable *hashtable;
+    struct t_hashtable_item *ptr_item;
+    char key[32];
+    int i, length, max_length;
+
+    hashtable = hashtable_new (8,
+                               WEECHAT_HASHTABLE_STRING,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    ptr_item = hashtable_set (hashtable, HASHTABLE_TEST_KEY, "value");
+    CHECK(hashtable_hash_key_string (HASHTABLE_TEST_KEY) == ptr_item->hash);
+
+    /* the hash is used to find the item (keys are compared only if equal) */
+    ptr_item->hash++;
+    POINTERS_EQUAL(NULL, hashtable_get_item (hashtable, HASHTABLE_TEST_KEY, NULL));
+    ptr_item->hash--;
+    POINTERS_EQUAL(ptr_item,
+                   hashtable_get_item (hashtable, HASHTABLE_TEST_KEY, NULL));
+
+    /*
+     * add many similar keys (like nicks received from the network): the
+     * hash stored is kept on rehash and the chains remain short
+     */
+    for (i = 0; i < 10000; i++)
+    {
+        snprintf (key, sizeof (key), "nick%d", i);
+        hashtable_set (hashtable, key, "value");
+    }
+    LONGS_EQUAL(10001, hashtable->items_count);
+    max_length = 0;
+    for (i = 0; i < hashtable->size; i++)
+    {
+        length = 0;
+        for (ptr_item = hashtable->htable[i]; ptr_item;
+             ptr_item = ptr_item->next_item)
+        {
+            CHECK(hashtable_hash_key_string ((const char *)ptr_item->key)
+                  == ptr_item->hash);
+            LONGS_EQUAL(i, (int)(ptr_item->hash % hashtable->size));
+            length++;
+        }
+        if (length > max_length)
+            max_length = length;
+    }
+    CHECK(max_length <= 12);
+
+    /* same hash stored in compact entries */
+    hashtable_free (hashtable);
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+    ptr_item = hashtable_set (hashtable, HASHTABLE_TEST_KEY, "value");
+    CHECK(hashtable_hash_key_string (HASHTABLE_TEST_KEY) == ptr_item->hash);
+    hashtable_free (hashtable);
+}
+
 /*
  * Test callback hashing a key.
  *
@@ -94,6 +291,21 @@ test_hashtable_hash_key_cb (struct t_hashtable *hashtable, const void *key)
     return hashtable_hash_key_djb2 ((const char *)key) + 1;
 }
 
+/*
+ * Test callback hashing a key with djb2 (not seeded, so that the position
+ * of keys in hashtable is always the same).
+ */
+
+unsigned long long
+test_hashtable_hash_key_djb2_cb (struct t_hashtable *hashtable,
+                                 const void *key)
+{
+    /* make C++ compiler happy */
+    (void) hashtable;
+
+    return hashtable_hash_key_djb2 ((const char *)key);
+}
+
 /*
  * Test callback comparing two keys.
  *
@@ -343,8 +555,8 @@ TEST(CoreHashtable, SetGetRemove)
     hashtable_free (hashtable2);
 
     /*
-     * create a hashtable with size 8, and add 6 items,
-     * to check if many items with same hashed key work fine,
+     * create a hashtable with size 8 (keys hashed with djb2), and add 6
+     * items, to check if many items with same hashed key work fine,
      * the expected htable inside hashtable is:
      *   +-----+
      *   |   0 |
@@ -367,7 +579,7 @@ TEST(CoreHashtable, SetGetRemove)
     hashtable = hashtable_new (8,
                                WEECHAT_HASHTABLE_STRING,
                                WEECHAT_HASHTABLE_STRING,
-                               NULL,
+                               &test_hashtable_hash_key_djb2_cb,
                                NULL);
     LONGS_EQUAL(8, hashtable->size);
     LONGS_EQUAL(0, hashtable->items_count);
@@ -1191,6 +1403,380 @@ TEST(CoreHashtable, Infolist)
     STRCMP_EQUAL("last item", infolist_string (infolist, "test_value_00005"));
 }
 
+/*
+ * Test functions:
+ *   hashtable_new_compact
+ */
+
+TEST(CoreHashtable, NewCompact)
+{
+    struct t_hashtable *hashtable;
+
+    POINTERS_EQUAL(NULL,
+                   hashtable_new_compact (-1,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          NULL, NULL));
+    POINTERS_EQUAL(NULL,
+                   hashtable_new_compact (32,
+                                          "xxxxx",  /* invalid */
+                                          "yyyyy",  /* invalid */
+                                          NULL, NULL));
+    POINTERS_EQUAL(NULL,
+                   hashtable_new_compact (32,
+                                          WEECHAT_HASHTABLE_BUFFER,
+                                          WEECHAT_HASHTABLE_STRING,
+                                          NULL, NULL));
+
+    /* size is rounded up to a power of 2 (min 8) */
+    hashtable = hashtable_new_compact (1,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+    CHECK(hashtable);
+    LONGS_EQUAL(HASHTABLE_BACKEND_COMPACT, hashtable->backend);
+    LONGS_EQUAL(8, hashtable->size);
+    LONGS_EQUAL(5, hashtable->entries_size);
+    hashtable_free (hashtable);
+
+    hashtable = hashtable_new_compact (33,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_INTEGER,
+                                       &test_hashtable_hash_key_cb,
+                                       &test_hashtable_keycmp_cb);
+    CHECK(hashtable);
+    LONGS_EQUAL(64, hashtable->size);
+    LONGS_EQUAL(42, hashtable->entries_size);
+    POINTERS_EQUAL(NULL, hashtable->htable);
+    CHECK(hashtable->indices);
+    CHECK(hashtable->entries);
+    LONGS_EQUAL(0, hashtable->entries_count);
+    LONGS_EQUAL(0, hashtable->items_count);
+    LONGS_EQUAL(HASHTABLE_STRING, hashtable->type_keys);
+    LONGS_EQUAL(HASHTABLE_INTEGER, hashtable->type_values);
+    POINTERS_EQUAL(&test_hashtable_hash_key_cb, hashtable->callback_hash_key);
+    POINTERS_EQUAL(&test_hashtable_keycmp_cb, hashtable->callback_keycmp);
+    hashtable_free (hashtable);
+
+    /* hashtable_new always uses the chained backend */
+    hashtable = hashtable_new (32,
+                               WEECHAT_HASHTABLE_STRING,
+                               WEECHAT_HASHTABLE_STRING,
+                               NULL, NULL);
+    LONGS_EQUAL(HASHTABLE_BACKEND_CHAINED, hashtable->backend);
+    POINTERS_EQUAL(NULL, hashtable->entries);
+    hashtable_free (hashtable);
+}
+
+/*
+ * Test functions:
+ *   hashtable_compact_search
+ *   hashtable_compact_set_key
+ *   hashtable_compact_set
+ *   hashtable_compact_remove_entry
+ *   hashtable_set_with_size (compact)
+ *   hashtable_get_item (compact)
+ *   hashtable_remove (compact)
+ *   hashtable_remove_all (compact)
+ */
+
+TEST(CoreHashtable, CompactSetGetRemove)
+{
+    struct t_hashtable *hashtable, *hashtable2;
+    struct t_hashtable_item *ptr_item;
+    unsigned long long slot;
+    int i, value_int;
+    long long value_longlong;
+    char key[32], value[32];
+
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+
+    /* small key: stored inside the entry */
+    ptr_item = hashtable_set (hashtable, "weechat", "the first item");
+    CHECK(ptr_item);
+    POINTERS_EQUAL(&hashtable->entries[0], ptr_item);
+    POINTERS_EQUAL(hashtable->entries[0].key_inline.data, ptr_item->key);
+    LONGS_EQUAL(8, ptr_item->key_size);
+    LONGS_EQUAL(HASHTABLE_ENTRY_KEY_INLINE, hashtable->entries[0].flags);
+    STRCMP_EQUAL("the first item", (const char *)ptr_item->value);
+    LONGS_EQUAL(15, ptr_item->value_size);
+
+    /* long key: allocated */
+    ptr_item = hashtable_set (hashtable, HASHTABLE_TEST_KEY_LONG, "item2");
+    CHECK(ptr_item);
+    CHECK(ptr_item->key != hashtable->entries[1].key_inline.data);
+    STRCMP_EQUAL(HASHTABLE_TEST_KEY_LONG, (const char *)ptr_item->key);
+    LONGS_EQUAL(27, ptr_item->key_size);
+    LONGS_EQUAL(0, hashtable->entries[1].flags);
+    LONGS_EQUAL(2, hashtable->items_count);
+    LONGS_EQUAL(2, hashtable->entries_count);
+
+    /* replace value */
+    ptr_item = hashtable_set (hashtable, "weechat", "new value");
+    POINTERS_EQUAL(&hashtable->entries[0], ptr_item);
+    LONGS_EQUAL(2, hashtable->items_count);
+    STRCMP_EQUAL("new value", (const char *)hashtable_get (hashtable, "weechat"));
+    STRCMP_EQUAL("item2",
+                 (const char *)hashtable_get (hashtable, HASHTABLE_TEST_KEY_LONG));
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, "xxx"));
+    LONGS_EQUAL(1, hashtable_has_key (hashtable, "weechat"));
+    LONGS_EQUAL(0, hashtable_has_key (hashtable, "xxx"));
+
+    /* get item and its slot */
+    ptr_item = hashtable_get_item (hashtable, "weechat", &slot);
+    POINTERS_EQUAL(&hashtable->entries[0], ptr_item);
+    LONGS_EQUAL(0, hashtable->indices[slot]);
+
+    /* remove: the entry stays in array, marked as removed */
+    hashtable_remove (hashtable, "weechat");
+    LONGS_EQUAL(1, hashtable->items_count);
+    LONGS_EQUAL(2, hashtable->entries_count);
+    LONGS_EQUAL(HASHTABLE_ENTRY_REMOVED, hashtable->entries[0].flags);
+    POINTERS_EQUAL(NULL, hashtable->entries[0].key);
+    LONGS_EQUAL(-2, hashtable->indices[slot]);
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, "weechat"));
+    hashtable_remove (hashtable, "weechat");
+    LONGS_EQUAL(1, hashtable->items_count);
+
+    /* add again: new entry at the end */
+    hashtable_set (hashtable, "weechat", "again");
+    LONGS_EQUAL(2, hashtable->items_count);
+    LONGS_EQUAL(3, hashtable->entries_count);
+    STRCMP_EQUAL("again", (const char *)hashtable_get (hashtable, "weechat"));
+    STRCMP_EQUAL(HASHTABLE_TEST_KEY_LONG ",weechat",
+                 hashtable_get_string (hashtable, "keys"));
+
+    /* grow: removed entries are dropped, order of creation is kept */
+    for (i = 0; i < 100; i++)
+    {
+        snprintf (key, sizeof (key), "key%d", i);
+        snprintf (value, sizeof (value), "value%d", i);
+        hashtable_set (hashtable, key, value);
+    }
+    LONGS_EQUAL(102, hashtable->items_count);
+    LONGS_EQUAL(102, hashtable->entries_count);
+    LONGS_EQUAL(256, hashtable->size);
+    STRCMP_EQUAL(HASHTABLE_TEST_KEY_LONG, (const char *)hashtable->entries[0].key);
+    STRCMP_EQUAL("weechat", (const char *)hashtable->entries[1].key);
+    POINTERS_EQUAL(hashtable->entries[1].key_inline.data,
+                   hashtable->entries[1].key);
+    for (i = 0; i < 100; i++)
+    {
+        snprintf (key, sizeof (key), "key%d", i);
+        snprintf (value, sizeof (value), "value%d", i);
+        STRCMP_EQUAL(value, (const char *)hashtable_get (hashtable, key));
+        STRCMP_EQUAL(key, (const char *)hashtable->entries[i + 2].key);
+    }
+
+    /* duplicate */
+    hashtable2 = hashtable_dup (hashtable);
+    CHECK(hashtable2);
+    LONGS_EQUAL(HASHTABLE_BACKEND_COMPACT, hashtable2->backend);
+    LONGS_EQUAL(102, hashtable2->items_count);
+    STRCMP_EQUAL(hashtable_get_string (hashtable, "keys_values"),
+                 hashtable_get_string (hashtable2, "keys_values"));
+    hashtable_free (hashtable2);
+
+    /* shrink */
+    for (i = 0; i < 95; i++)
+    {
+        snprintf (key, sizeof (key), "key%d", i);
+        hashtable_remove (hashtable, key);
+    }
+    LONGS_EQUAL(7, hashtable->items_count);
+    LONGS_EQUAL(21, hashtable->entries_count);
+    LONGS_EQUAL(64, hashtable->size);
+    STRCMP_EQUAL(HASHTABLE_TEST_KEY_LONG ",weechat,key95,key96,key97,key98,key99",
+                 hashtable_get_string (hashtable, "keys"));
+    STRCMP_EQUAL(HASHTABLE_TEST_KEY_LONG
+                 ",key95,key96,key97,key98,key99,weechat",
+                 hashtable_get_string (hashtable, "keys_sorted"));
+
+    /* remove all: size is kept */
+    hashtable_remove_all (hashtable);
+    LONGS_EQUAL(0, hashtable->items_count);
+    LONGS_EQUAL(0, hashtable->entries_count);
+    LONGS_EQUAL(64, hashtable->size);
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, "weechat"));
+    for (i = 0; i < hashtable->size; i++)
+    {
+        LONGS_EQUAL(-1, hashtable->indices[i]);
+    }
+    hashtable_set (hashtable, "weechat", "value");
+    STRCMP_EQUAL("value", (const char *)hashtable_get (hashtable, "weechat"));
+
+    hashtable_free (hashtable);
+
+    /* integer -> long long */
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_INTEGER,
+                                       WEECHAT_HASHTABLE_LONGLONG,
+                                       NULL, NULL);
+    for (i = 0; i < 1000; i++)
+    {
+        value_longlong = (long long)i * 1000000000LL;
+        hashtable_set (hashtable, &i, &value_longlong);
+    }
+    LONGS_EQUAL(1000, hashtable->items_count);
+    value_int = 500;
+    CHECK(*((long long *)hashtable_get (hashtable, &value_int))
+          == 500000000000LL);
+    LONGS_EQUAL(HASHTABLE_ENTRY_KEY_INLINE, hashtable->entries[500].flags);
+    hashtable_free (hashtable);
+
+    /* pointer -> pointer */
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_POINTER,
+                                       WEECHAT_HASHTABLE_POINTER,
+                                       NULL, NULL);
+    for (i = 1; i <= 1000; i++)
+    {
+        hashtable_set (hashtable, (void *)(8 * (unsigned long)i),
+                       (void *)(unsigned long)i);
+    }
+    LONGS_EQUAL(1000, hashtable->items_count);
+    POINTERS_EQUAL((void *)500,
+                   hashtable_get (hashtable, (void *)(8 * 500UL)));
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, (void *)(8 * 1001UL)));
+    LONGS_EQUAL(0, hashtable->entries[0].flags);
+    hashtable_free (hashtable);
+}
+
+/*
+ * Test callback removing and adding items while the hashtable is mapped.
+ */
+
+void
+test_hashtable_compact_map_cb (void *data,
+                               struct t_hashtable *hashtable,
+                               const void *key, const void *value)
+{
+    char str_key[32];
+
+    /* make C++ compiler happy */
+    (void) data;
+    (void) value;
+
+    test_map_count++;
+
+    if (strcmp ((const char *)key, "key1") == 0)
+    {
+        /* remove an item already visited and one not visited yet */
+        hashtable_remove (hashtable, "key0");
+        hashtable_remove (hashtable, "key2");
+    }
+    else if (strcmp ((const char *)key, "key3") == 0)
+    {
+        /* add items: the arrays must grow, entries keep their index */
+        for (int i = 100; i < 150; i++)
+        {
+            snprintf (str_key, sizeof (str_key), "key%d", i);
+            hashtable_set (hashtable, str_key, "new");
+        }
+    }
+}
+
+/*
+ * Test functions:
+ *   hashtable_map (compact)
+ *   hashtable_compact_rebuild
+ */
+
+TEST(CoreHashtable, CompactMap)
+{
+    struct t_hashtable *hashtable;
+    char key[32];
+    int i;
+
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+    for (i = 0; i < 5; i++)
+    {
+        snprintf (key, sizeof (key), "key%d", i);
+        hashtable_set (hashtable, key, "value");
+    }
+
+    test_map_count = 0;
+    hashtable_map (hashtable, &test_hashtable_compact_map_cb, NULL);
+
+    /* key0, key1, key3, key4 + 50 new items (key2 removed before visit) */
+    LONGS_EQUAL(54, test_map_count);
+    LONGS_EQUAL(0, hashtable->iterating);
+    LONGS_EQUAL(53, hashtable->items_count);
+
+    /* removed entries were kept during the map, they are dropped now */
+    LONGS_EQUAL(55, hashtable->entries_count);
+    STRCMP_EQUAL("key1", (const char *)hashtable->entries[1].key);
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, "key0"));
+    POINTERS_EQUAL(NULL, hashtable_get (hashtable, "key2"));
+    STRCMP_EQUAL("value", (const char *)hashtable_get (hashtable, "key4"));
+    STRCMP_EQUAL("new", (const char *)hashtable_get (hashtable, "key149"));
+    hashtable_free (hashtable);
+}
+
+/*
+ * Test functions:
+ *   hashtable_compact_set_key (with callback to free keys)
+ *   hashtable_add_to_infolist (compact)
+ *   hashtable_map_string (compact)
+ */
+
+TEST(CoreHashtable, CompactFreeKey)
+{
+    struct t_hashtable *hashtable;
+    struct t_infolist *infolist;
+    struct t_infolist_item *infolist_item;
+
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+    hashtable->callback_free_key = &test_hashtable_free_key;
+
+    /* keys are never stored inline if there is a callback to free them */
+    hashtable_set (hashtable, "weechat", "the first item");
+    LONGS_EQUAL(0, hashtable->entries[0].flags);
+    CHECK(hashtable->entries[0].key != hashtable->entries[0].key_inline.data);
+    free (hashtable->entries[0].key);
+    hashtable_free (hashtable);
+
+    /* infolist with entries in order of creation */
+    hashtable = hashtable_new_compact (8,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       WEECHAT_HASHTABLE_STRING,
+                                       NULL, NULL);
+    hashtable_set (hashtable, "weechat", "the first item");
+    hashtable_set (hashtable, "light", "item2");
+    hashtable_set (hashtable, "fast", "item3");
+    hashtable_remove (hashtable, "light");
+
+    test_map_string = (char *)malloc (1024);
+    test_map_string[0] = '\0';
+    hashtable_map_string (hashtable, &test_hashtable_map_string_cb, NULL);
+    STRCMP_EQUAL("weechat:the first item;fast:item3", test_map_string);
+    free (test_map_string);
+    test_map_string = NULL;
+
+    infolist = infolist_new (NULL);
+    infolist_item = infolist_new_item (infolist);
+    LONGS_EQUAL(1, hashtable_add_to_infolist (hashtable, infolist_item, "test"));
+    infolist_reset_item_cursor (infolist);
+    infolist_next (infolist);
+    STRCMP_EQUAL("weechat", infolist_string (infolist, "test_name_00000"));
+    STRCMP_EQUAL("the first item", infolist_string (infolist, "test_value_00000"));
+    STRCMP_EQUAL("fast", infolist_string (infolist, "test_name_00001"));
+    STRCMP_EQUAL("item3", infolist_string (infolist, "test_value_00001"));
+    POINTERS_EQUAL(NULL, infolist_string (infolist, "test_name_00002"));
+    infolist_free (infolist);
+
+    hashtable_free (hashtable);
+}
+
 /*
  * Test functions:
  *   hashtable_print_log
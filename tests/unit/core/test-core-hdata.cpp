@@ -25,6 +25,8 @@
 
 extern "C"
 {
+#include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
@@ -2374,6 +2376,244 @@ TEST(CoreHdataWithList, Compare)
     gui_buffer_close (test_buffer);
 }
 
+/*
+ * Test functions:
+ *   hdata_path_compile
+ *   hdata_path_free
+ */
+
+TEST(CoreHdataWithList, PathCompile)
+{
+    struct t_hdata_path *path;
+
+    POINTERS_EQUAL(NULL, hdata_path_compile (NULL, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_compile (ptr_hdata, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_compile (NULL, "test_int"));
+    POINTERS_EQUAL(NULL, hdata_path_compile (ptr_hdata, ""));
+
+    /* variable not found */
+    POINTERS_EQUAL(NULL, hdata_path_compile (ptr_hdata, "zzz"));
+    POINTERS_EQUAL(NULL, hdata_path_compile (ptr_hdata, "next_item.zzz"));
+    POINTERS_EQUAL(NULL, hdata_path_compile (ptr_hdata, "next_item."));
+
+    /* one variable */
+    path = hdata_path_compile (ptr_hdata, "test_int");
+    CHECK(path);
+    STRCMP_EQUAL("test_int", path->path);
+    LONGS_EQUAL(1, path->vars_count);
+    LONGS_EQUAL(offsetof (struct t_test_item, test_int),
+                path->vars[0].offset);
+    LONGS_EQUAL(WEECHAT_HDATA_INTEGER, path->vars[0].type);
+    LONGS_EQUAL(0, path->vars[0].array);
+    POINTERS_EQUAL(NULL, path->hashtable_key);
+    hdata_path_free (path);
+
+    /* item of array */
+    path = hdata_path_compile (ptr_hdata, "2|test_ptr_3_int");
+    CHECK(path);
+    LONGS_EQUAL(1, path->vars_count);
+    LONGS_EQUAL(1, path->vars[0].array);
+    LONGS_EQUAL(1, path->vars[0].array_pointer);
+    LONGS_EQUAL(2, path->vars[0].index);
+    hdata_path_free (path);
+
+    /* pointers with hdata */
+    path = hdata_path_compile (ptr_hdata, "next_item.prev_item.test_string");
+    CHECK(path);
+    LONGS_EQUAL(3, path->vars_count);
+    LONGS_EQUAL(offsetof (struct t_test_item, next_item),
+                path->vars[0].offset);
+    LONGS_EQUAL(WEECHAT_HDATA_POINTER, path->vars[0].type);
+    LONGS_EQUAL(offsetof (struct t_test_item, prev_item),
+                path->vars[1].offset);
+    LONGS_EQUAL(WEECHAT_HDATA_POINTER, path->vars[1].type);
+    LONGS_EQUAL(offsetof (struct t_test_item, test_string),
+                path->vars[2].offset);
+    LONGS_EQUAL(WEECHAT_HDATA_STRING, path->vars[2].type);
+    hdata_path_free (path);
+
+    /* pointer without hdata, or not a pointer: remaining path is ignored */
+    path = hdata_path_compile (ptr_hdata, "test_pointer.zzz");
+    CHECK(path);
+    LONGS_EQUAL(1, path->vars_count);
+    hdata_path_free (path);
+    path = hdata_path_compile (ptr_hdata, "test_int.zzz");
+    CHECK(path);
+    LONGS_EQUAL(1, path->vars_count);
+    hdata_path_free (path);
+
+    /* hashtable with key or property */
+    path = hdata_path_compile (ptr_hdata, "next_item.test_hashtable.key.2");
+    CHECK(path);
+    LONGS_EQUAL(2, path->vars_count);
+    STRCMP_EQUAL("key.2", path->hashtable_key);
+    LONGS_EQUAL(0, path->hashtable_property);
+    hdata_path_free (path);
+    path = hdata_path_compile (ptr_hdata, "test_hashtable.keys()");
+    CHECK(path);
+    LONGS_EQUAL(1, path->vars_count);
+    STRCMP_EQUAL("keys", path->hashtable_key);
+    LONGS_EQUAL(1, path->hashtable_property);
+    hdata_path_free (path);
+
+    hdata_path_free (NULL);
+}
+
+/*
+ * Test functions:
+ *   hdata_path_get_var
+ */
+
+TEST(CoreHdataWithList, PathGetVar)
+{
+    struct t_hdata_path *path;
+
+    POINTERS_EQUAL(NULL, hdata_path_get_var (NULL, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_get_var (NULL, ptr_item1));
+
+    path = hdata_path_compile (ptr_hdata, "test_int");
+    CHECK(path);
+    POINTERS_EQUAL(NULL, hdata_path_get_var (path, NULL));
+    POINTERS_EQUAL(&(ptr_item1->test_int),
+                   hdata_path_get_var (path, ptr_item1));
+    POINTERS_EQUAL(&(ptr_item2->test_int),
+                   hdata_path_get_var (path, ptr_item2));
+    hdata_path_free (path);
+
+    path = hdata_path_compile (ptr_hdata, "next_item.1|test_ptr_3_int");
+    CHECK(path);
+    POINTERS_EQUAL(&(ptr_item2->test_ptr_3_int[1]),
+                   hdata_path_get_var (path, ptr_item1));
+    POINTERS_EQUAL(NULL, hdata_path_get_var (path, ptr_item2));
+    hdata_path_free (path);
+
+    path = hdata_path_compile (ptr_hdata, "1|test_array_2_long_fixed_size");
+    CHECK(path);
+    POINTERS_EQUAL(&(ptr_item1->test_array_2_long_fixed_size[1]),
+                   hdata_path_get_var (path, ptr_item1));
+    hdata_path_free (path);
+}
+
+/*
+ * Test functions:
+ *   hdata_path_get_value
+ */
+
+TEST(CoreHdataWithList, PathGetValue)
+{
+    struct t_hdata_path *path;
+    char *value, str_pointer[64];
+
+#define WEE_CHECK_PATH_VALUE(__result, __path, __pointer)               \
+    path = hdata_path_compile (ptr_hdata, __path);                      \
+    CHECK(path);                                                        \
+    value = hdata_path_get_value (path, __pointer);                     \
+    STRCMP_EQUAL(__result, value);                                      \
+    free (value);                                                       \
+    hdata_path_free (path);
+
+    POINTERS_EQUAL(NULL, hdata_path_get_value (NULL, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_get_value (NULL, ptr_item1));
+
+    /* NULL pointer */
+    WEE_CHECK_PATH_VALUE("", "test_int", NULL);
+    WEE_CHECK_PATH_VALUE("", "next_item.test_int", ptr_item2);
+
+    /* char */
+    WEE_CHECK_PATH_VALUE("A", "test_char", ptr_item1);
+    WEE_CHECK_PATH_VALUE("B", "1|test_array_2_char_fixed_size", ptr_item1);
+    WEE_CHECK_PATH_VALUE("C", "1|test_ptr_2_char", ptr_item1);
+
+    /* integer */
+    WEE_CHECK_PATH_VALUE("123", "test_int", ptr_item1);
+    WEE_CHECK_PATH_VALUE("456", "next_item.test_int", ptr_item1);
+    WEE_CHECK_PATH_VALUE("123", "next_item.prev_item.test_int", ptr_item1);
+    WEE_CHECK_PATH_VALUE("222", "1|test_array_2_int_fixed_size", ptr_item1);
+    WEE_CHECK_PATH_VALUE("3", "2|test_ptr_3_int", ptr_item1);
+    WEE_CHECK_PATH_VALUE("123", "test_int.zzz", ptr_item1);
+
+    /* long */
+    WEE_CHECK_PATH_VALUE("123456789", "test_long", ptr_item1);
+    WEE_CHECK_PATH_VALUE("234567", "1|test_ptr_2_long", ptr_item1);
+
+    /* long long */
+    WEE_CHECK_PATH_VALUE("123456789123456", "test_longlong", ptr_item1);
+    WEE_CHECK_PATH_VALUE("222", "1|test_array_2_longlong_fixed_size",
+                         ptr_item1);
+
+    /* string */
+    WEE_CHECK_PATH_VALUE("item1", "test_string", ptr_item1);
+    WEE_CHECK_PATH_VALUE("item2", "next_item.test_string", ptr_item1);
+    WEE_CHECK_PATH_VALUE(NULL, "test_string_null", ptr_item1);
+    WEE_CHECK_PATH_VALUE("item1_shared", "test_shared_string", ptr_item1);
+    WEE_CHECK_PATH_VALUE(NULL, "0|test_array_2_words_fixed_size", ptr_item1);
+    WEE_CHECK_PATH_VALUE("b", "1|test_ptr_words", ptr_item1);
+    WEE_CHECK_PATH_VALUE("ccc", "2|test_ptr_words_dyn_shared", ptr_item1);
+
+    /* pointer */
+    WEE_CHECK_PATH_VALUE("0x123", "test_pointer", ptr_item1);
+    WEE_CHECK_PATH_VALUE("0x123", "test_pointer.zzz", ptr_item1);
+    WEE_CHECK_PATH_VALUE("0x445566", "1|test_array_2_pointer_fixed_size",
+                         ptr_item1);
+    WEE_CHECK_PATH_VALUE("0x789", "2|test_ptr_3_pointer", ptr_item1);
+    snprintf (str_pointer, sizeof (str_pointer),
+              "0x%lx", (unsigned long)ptr_item2);
+    WEE_CHECK_PATH_VALUE(str_pointer, "next_item", ptr_item1);
+    WEE_CHECK_PATH_VALUE("0x0", "next_item.next_item", ptr_item1);
+
+    /* time */
+    WEE_CHECK_PATH_VALUE("123456", "test_time", ptr_item1);
+    WEE_CHECK_PATH_VALUE("5678", "1|test_ptr_2_time", ptr_item1);
+
+    /* hashtable */
+    snprintf (str_pointer, sizeof (str_pointer),
+              "0x%lx", (unsigned long)ptr_item1->test_hashtable);
+    WEE_CHECK_PATH_VALUE(str_pointer, "test_hashtable", ptr_item1);
+    WEE_CHECK_PATH_VALUE("value1", "test_hashtable.key1", ptr_item1);
+    WEE_CHECK_PATH_VALUE(NULL, "test_hashtable.zzz", ptr_item1);
+    WEE_CHECK_PATH_VALUE("value2", "next_item.test_hashtable.key2",
+                         ptr_item1);
+    WEE_CHECK_PATH_VALUE("key1", "test_hashtable.keys()", ptr_item1);
+    WEE_CHECK_PATH_VALUE("value1.2", "1|test_ptr_2_hashtable.key1.2",
+                         ptr_item1);
+
+    /* other */
+    WEE_CHECK_PATH_VALUE(NULL, "test_other", ptr_item1);
+
+#undef WEE_CHECK_PATH_VALUE
+}
+
+/*
+ * Test functions:
+ *   hdata_path_get_cached
+ */
+
+TEST(CoreHdataWithList, PathGetCached)
+{
+    struct t_hdata_path *path, *path2;
+
+    POINTERS_EQUAL(NULL, hdata_path_get_cached (NULL, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_get_cached (ptr_hdata, NULL));
+    POINTERS_EQUAL(NULL, hdata_path_get_cached (NULL, "test_int"));
+    POINTERS_EQUAL(NULL, hdata_path_get_cached (ptr_hdata, "zzz"));
+
+    path = hdata_path_get_cached (ptr_hdata, "next_item.test_int");
+    CHECK(path);
+    CHECK(ptr_hdata->hash_path);
+    LONGS_EQUAL(1, ptr_hdata->hash_path->items_count);
+    POINTERS_EQUAL(path,
+                   hdata_path_get_cached (ptr_hdata, "next_item.test_int"));
+    LONGS_EQUAL(1, ptr_hdata->hash_path->items_count);
+
+    /* new variable in a hdata: the path is compiled again */
+    hdata_new_var (ptr_hdata, "test_new_var", 0, WEECHAT_HDATA_INTEGER, 0,
+                   NULL, NULL);
+    path2 = hdata_path_get_cached (ptr_hdata, "next_item.test_int");
+    CHECK(path2);
+    LONGS_EQUAL(hdata_generation, path2->generation);
+    LONGS_EQUAL(1, ptr_hdata->hash_path->items_count);
+}
+
 /*
  * Test functions:
  *   hdata_set
@@ -25,12 +25,35 @@
 
 extern "C"
 {
+#include <string.h>
+#include "src/core/core-hdata.h"
+#include "src/core/core-hook.h"
+#include "src/plugins/plugin.h"
 }
 
 TEST_GROUP(CoreHook)
 {
 };
 
+/*
+ * Dummy signal callback used in tests.
+ */
+
+int
+test_core_hook_signal_cb (const void *pointer, void *data,
+                          const char *signal, const char *type_data,
+                          void *signal_data)
+{
+    /* make C++ compiler happy */
+    (void) pointer;
+    (void) data;
+    (void) signal;
+    (void) type_data;
+    (void) signal_data;
+
+    return WEECHAT_RC_OK;
+}
+
 /*
  * Test functions:
  *   hook_init
@@ -138,7 +161,29 @@ TEST(CoreHook, ExecEnd)
 
 TEST(CoreHook, CallbackStart)
 {
-    /* TODO: write tests */
+    struct t_hook hook;
+    struct t_hook_exec_cb hook_exec_cb;
+
+    memset (&hook, 0, sizeof (hook));
+    hook_init_data (&hook, NULL, HOOK_TYPE_SIGNAL, 1000, NULL, NULL);
+
+    /* profiling disabled: start time is not measured */
+    hook_callback_start (&hook, &hook_exec_cb);
+    LONGS_EQUAL(1, hook.running);
+    LONGS_EQUAL(0, hook_exec_cb.start_time.tv_sec);
+    LONGS_EQUAL(0, hook_exec_cb.start_time.tv_usec);
+    hook_callback_end (&hook, &hook_exec_cb);
+    LONGS_EQUAL(0, hook.running);
+
+    /* profiling enabled: start time is measured */
+    hook_profile_enabled = 1;
+    hook_callback_start (&hook, &hook_exec_cb);
+    LONGS_EQUAL(1, hook.running);
+    CHECK((hook_exec_cb.start_time.tv_sec > 0)
+          || (hook_exec_cb.start_time.tv_usec > 0));
+    hook_callback_end (&hook, &hook_exec_cb);
+    LONGS_EQUAL(0, hook.running);
+    hook_profile_enabled = 0;
 }
 
 /*
@@ -148,7 +193,83 @@ TEST(CoreHook, CallbackStart)
 
 TEST(CoreHook, CallbackEnd)
 {
-    /* TODO: write tests */
+    struct t_hook hook;
+    struct t_hook_exec_cb hook_exec_cb;
+    int i;
+
+    memset (&hook, 0, sizeof (hook));
+    hook_init_data (&hook, NULL, HOOK_TYPE_SIGNAL, 1000, NULL, NULL);
+    POINTERS_EQUAL(NULL, hook.profile);
+
+    /* profiling disabled: no data allocated */
+    hook_callback_start (&hook, &hook_exec_cb);
+    hook_callback_end (&hook, &hook_exec_cb);
+    POINTERS_EQUAL(NULL, hook.profile);
+
+    /* profiling enabled: data allocated and recorded */
+    hook_profile_enabled = 1;
+    hook_callback_start (&hook, &hook_exec_cb);
+    hook_callback_end (&hook, &hook_exec_cb);
+    CHECK(hook.profile);
+    LONGS_EQUAL(1, hook.profile->calls);
+    CHECK(hook.profile->time_total >= 0);
+    CHECK(hook.profile->time_max >= hook.profile->time_last[0]);
+    LONGS_EQUAL(1, hook.profile->time_last_index);
+
+    /* fake a start time in the past: 2 seconds */
+    hook_callback_start (&hook, &hook_exec_cb);
+    hook_exec_cb.start_time.tv_sec -= 2;
+    hook_callback_end (&hook, &hook_exec_cb);
+    LONGS_EQUAL(2, hook.profile->calls);
+    CHECK(hook.profile->time_total >= 2000000);
+    CHECK(hook.profile->time_max >= 2000000);
+    CHECK(hook.profile->time_last[1] >= 2000000);
+    LONGS_EQUAL(2, hook.profile->time_last_index);
+
+    /* last times are stored in a circular array */
+    for (i = 0; i < HOOK_PROFILE_NUM_LAST - 1; i++)
+    {
+        hook_callback_start (&hook, &hook_exec_cb);
+        hook_callback_end (&hook, &hook_exec_cb);
+    }
+    LONGS_EQUAL(HOOK_PROFILE_NUM_LAST + 1, hook.profile->calls);
+    LONGS_EQUAL(1, hook.profile->time_last_index);
+    CHECK(hook.profile->time_last[0] < 2000000);
+    CHECK(hook.profile->time_last[1] >= 2000000);
+    CHECK(hook.profile->time_max >= 2000000);
+
+    hook_profile_enabled = 0;
+
+    free (hook.profile);
+}
+
+/*
+ * Test functions:
+ *   hook_profile_reset
+ */
+
+TEST(CoreHook, ProfileReset)
+{
+    struct t_hook *ptr_hook;
+    struct t_hook_exec_cb hook_exec_cb;
+
+    ptr_hook = hook_signal (NULL, "test_profile_reset",
+                            &test_core_hook_signal_cb, NULL, NULL);
+    CHECK(ptr_hook);
+    POINTERS_EQUAL(NULL, ptr_hook->profile);
+
+    hook_profile_enabled = 1;
+    hook_callback_start (ptr_hook, &hook_exec_cb);
+    hook_callback_end (ptr_hook, &hook_exec_cb);
+    hook_profile_enabled = 0;
+    CHECK(ptr_hook->profile);
+    LONGS_EQUAL(1, ptr_hook->profile->calls);
+
+    hook_profile_reset ();
+
+    POINTERS_EQUAL(NULL, ptr_hook->profile);
+
+    unhook (ptr_hook);
 }
 
 /*
@@ -221,6 +342,55 @@ TEST(CoreHook, UnhookAll)
     /* TODO: write tests */
 }
 
+/*
+ * Test functions:
+ *   hook_hdata_hook_cb
+ *   hook_hdata_hook_profile_cb
+ */
+
+TEST(CoreHook, HdataHookProfileCb)
+{
+    struct t_hdata *hdata_hook, *hdata_profile;
+    struct t_hook *ptr_hook;
+    struct t_hook_exec_cb hook_exec_cb;
+    void *ptr_profile;
+
+    hdata_hook = hook_hdata_get (NULL, "hook");
+    CHECK(hdata_hook);
+    hdata_profile = hook_hdata_get (NULL, "hook_profile");
+    CHECK(hdata_profile);
+    STRCMP_EQUAL("hook_profile",
+                 hdata_get_var_hdata (hdata_hook, "profile"));
+
+    ptr_hook = hook_signal (NULL, "test_hdata_profile",
+                            &test_core_hook_signal_cb, NULL, NULL);
+    CHECK(ptr_hook);
+
+    hook_profile_enabled = 1;
+    hook_callback_start (ptr_hook, &hook_exec_cb);
+    hook_exec_cb.start_time.tv_sec -= 2;
+    hook_callback_end (ptr_hook, &hook_exec_cb);
+    hook_profile_enabled = 0;
+
+    ptr_profile = hdata_pointer (hdata_hook, ptr_hook, "profile");
+    POINTERS_EQUAL(ptr_hook->profile, ptr_profile);
+    LONGS_EQUAL(1, hdata_longlong (hdata_profile, ptr_profile, "calls"));
+    CHECK(hdata_longlong (hdata_profile, ptr_profile, "time_total")
+          >= 2000000);
+    CHECK(hdata_longlong (hdata_profile, ptr_profile, "time_max")
+          >= 2000000);
+    LONGS_EQUAL(HOOK_PROFILE_NUM_LAST,
+                hdata_get_var_array_size (hdata_profile, ptr_profile,
+                                          "time_last"));
+    CHECK(hdata_longlong (hdata_profile, ptr_profile, "0|time_last")
+          >= 2000000);
+    LONGS_EQUAL(0, hdata_longlong (hdata_profile, ptr_profile, "1|time_last"));
+    LONGS_EQUAL(1, hdata_integer (hdata_profile, ptr_profile,
+                                  "time_last_index"));
+
+    unhook (ptr_hook);
+}
+
 /*
  * Test functions:
  *   hook_add_to_infolist_pointer
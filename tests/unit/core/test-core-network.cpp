@@ -25,9 +25,14 @@
 
 extern "C"
 {
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
 #include "src/core/core-network.h"
 
 extern int network_is_ip_address (const char *address);
+extern int network_socket (int domain, int type, int protocol);
+extern int network_pipe (int fds[2]);
 }
 
 TEST_GROUP(CoreNetwork)
@@ -203,6 +208,28 @@ TEST(CoreNetwork, PassProxy)
     /* TODO: write tests */
 }
 
+/*
+ * Test functions:
+ *   network_socket
+ *   network_pipe
+ */
+
+TEST(CoreNetwork, SocketPipe)
+{
+    int sock, fds[2];
+
+    sock = network_socket (AF_INET, SOCK_STREAM, 0);
+    CHECK(sock >= 0);
+    CHECK(fcntl (sock, F_GETFD) & FD_CLOEXEC);
+    close (sock);
+
+    LONGS_EQUAL(0, network_pipe (fds));
+    CHECK(fcntl (fds[0], F_GETFD) & FD_CLOEXEC);
+    CHECK(fcntl (fds[1], F_GETFD) & FD_CLOEXEC);
+    close (fds[0]);
+    close (fds[1]);
+}
+
 /*
  * Test functions:
  *   network_connect
@@ -27,6 +27,9 @@
 
 extern "C"
 {
+extern struct t_hashtable *string_hashtable_highlight;
+extern struct t_string_highlight *string_highlight_first;
+extern struct t_string_highlight *string_highlight_last;
 #ifndef HAVE_CONFIG_H
 #define HAVE_CONFIG_H
 #endif
@@ -39,6 +42,7 @@ extern "C"
 #include "src/core/core-config.h"
 #include "src/core/core-string.h"
 #include "src/core/core-hashtable.h"
+#include "src/core/core-utf8.h"
 #include "src/gui/gui-color.h"
 #include "src/plugins/plugin.h"
 }
@@ -51,6 +55,21 @@ extern "C"
 #define WEE_IS_WORD_CHAR(__result, __str)                               \
     LONGS_EQUAL(__result, string_is_word_char_highlight (__str));       \
     LONGS_EQUAL(__result, string_is_word_char_input (__str));
+#define WEE_MATCH(__result, __string, __mask, __case_sensitive)       \
+    LONGS_EQUAL(__result,                                               \
+                string_match (__string, __mask, __case_sensitive));     \
+    mask = string_mask_compile (__mask, __case_sensitive);              \
+    LONGS_EQUAL(__result, string_mask_match (mask, __string));          \
+    string_mask_free (mask);
+
+#define WEE_MATCH_LIST(__result, __string, __masks, __case_sensitive)  \
+    LONGS_EQUAL(__result,                                               \
+                string_match_list (__string, __masks,                   \
+                                   __case_sensitive));                  \
+    masks = string_mask_list_compile (__masks, __case_sensitive);       \
+    LONGS_EQUAL(__result, string_mask_list_match (masks, __string));    \
+    string_mask_list_free (masks);
+
 #define WEE_HAS_HL_STR(__result, __str, __words)                        \
     LONGS_EQUAL(__result, string_has_highlight (__str, __words));
 
@@ -58,12 +77,22 @@ extern "C"
     LONGS_EQUAL(__result_hl,                                            \
                 string_has_highlight_regex (__str, __regex));           \
     LONGS_EQUAL(__result_regex,                                         \
-                string_regcomp (&regex, __regex, REG_ICASE));           \
+                string_regex_compile (&regex, __regex, REG_ICASE));     \
     LONGS_EQUAL(__result_hl,                                            \
                 string_has_highlight_regex_compiled (__str,             \
                                                      &regex));          \
     if (__result_regex == 0)                                            \
-        regfree(&regex);
+        string_regex_free (&regex);
+
+#define WEE_REGEX_TO_PCRE2(__result, __positions, __regex, __flags)    \
+    positions = -1;                                                     \
+    str = string_regex_to_pcre2 (__regex, __flags, &positions);        \
+    STRCMP_EQUAL(__result, str);                                        \
+    if (str)                                                            \
+    {                                                                   \
+        LONGS_EQUAL(__positions, positions);                            \
+    }                                                                   \
+    free (str);
 
 #define WEE_REPLACE_REGEX(__result_regex, __result_replace, __str,      \
                           __regex, __replace, __ref_char, __callback)   \
@@ -75,7 +104,7 @@ extern "C"
     STRCMP_EQUAL(__result_replace, result);                             \
     free (result);                                                      \
     if (__result_regex == 0)                                            \
-        regfree(&regex);
+        regfree (&regex);
 
 #define WEE_REPLACE_CB(__result_replace, __result_errors,               \
                        __str, __prefix, __suffix, __allow_escape,       \
@@ -854,72 +883,84 @@ TEST(CoreString, Search)
 /*
  * Test functions:
  *   string_match
+ *   string_mask_compile
+ *   string_mask_match
+ *   string_mask_free
  */
 
 TEST(CoreString, Match)
 {
-    LONGS_EQUAL(0, string_match (NULL, NULL, 0));
-    LONGS_EQUAL(0, string_match (NULL, "test", 0));
-    LONGS_EQUAL(0, string_match ("test", NULL, 0));
-    LONGS_EQUAL(0, string_match ("", "", 0));
-    LONGS_EQUAL(0, string_match ("", "test", 0));
-    LONGS_EQUAL(0, string_match ("test", "", 0));
-    LONGS_EQUAL(0, string_match ("test", "def", 0));
-    LONGS_EQUAL(0, string_match ("test", "def", 1));
-    LONGS_EQUAL(0, string_match ("test", "def*", 0));
-    LONGS_EQUAL(0, string_match ("test", "def*", 1));
-    LONGS_EQUAL(0, string_match ("test", "*def", 0));
-    LONGS_EQUAL(0, string_match ("test", "*def", 1));
-    LONGS_EQUAL(0, string_match ("test", "*def*", 0));
-    LONGS_EQUAL(0, string_match ("test", "*def*", 1));
-    LONGS_EQUAL(0, string_match ("test", "def", 0));
-    LONGS_EQUAL(0, string_match ("test", "def", 1));
-    LONGS_EQUAL(0, string_match ("test", "es", 0));
-    LONGS_EQUAL(0, string_match ("test", "es", 1));
-    LONGS_EQUAL(0, string_match ("test", "es*", 0));
-    LONGS_EQUAL(0, string_match ("test", "es*", 1));
-    LONGS_EQUAL(0, string_match ("test", "*es", 0));
-    LONGS_EQUAL(0, string_match ("test", "*es", 1));
-    LONGS_EQUAL(1, string_match ("test", "*es*", 0));
-    LONGS_EQUAL(1, string_match ("test", "**es**", 0));
-    LONGS_EQUAL(1, string_match ("test", "*es*", 1));
-    LONGS_EQUAL(1, string_match ("test", "*ES*", 0));
-    LONGS_EQUAL(0, string_match ("test", "*ES*", 1));
-    LONGS_EQUAL(1, string_match ("TEST", "*es*", 0));
-    LONGS_EQUAL(0, string_match ("TEST", "*es*", 1));
-    LONGS_EQUAL(0, string_match ("aaba", "*aa", 0));
-    LONGS_EQUAL(0, string_match ("aaba", "*aa", 1));
-    LONGS_EQUAL(1, string_match ("abaa", "*aa", 0));
-    LONGS_EQUAL(1, string_match ("abaa", "*aa", 1));
-    LONGS_EQUAL(1, string_match ("aabaa", "*aa", 0));
-    LONGS_EQUAL(1, string_match ("aabaa", "*aa", 1));
-    LONGS_EQUAL(1, string_match ("aabaabaabaa", "*aa", 0));
-    LONGS_EQUAL(1, string_match ("aabaabaabaa", "*aa", 1));
-    LONGS_EQUAL(0, string_match ("abaa", "aa*", 0));
-    LONGS_EQUAL(0, string_match ("abaa", "aa*", 1));
-    LONGS_EQUAL(1, string_match ("aaba", "aa*", 0));
-    LONGS_EQUAL(1, string_match ("aaba", "aa*", 1));
-    LONGS_EQUAL(1, string_match ("aabaa", "aa*", 0));
-    LONGS_EQUAL(1, string_match ("aabaa", "aa*", 1));
-    LONGS_EQUAL(1, string_match ("aabaabaabaa", "aa*", 0));
-    LONGS_EQUAL(1, string_match ("aabaabaabaa", "aa*", 1));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script.color*", 0));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script.color*", 1));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script.COLOR*", 0));
-    LONGS_EQUAL(0, string_match ("script.color.description", "*script.COLOR*", 1));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script*color*", 0));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script*color*", 1));
-    LONGS_EQUAL(1, string_match ("script.color.description", "*script*COLOR*", 0));
-    LONGS_EQUAL(0, string_match ("script.color.description", "*script*COLOR*", 1));
-    LONGS_EQUAL(1, string_match ("script.script.script", "scr*scr*scr*", 0));
-    LONGS_EQUAL(1, string_match ("script.script.script", "SCR*SCR*SCR*", 0));
-    LONGS_EQUAL(0, string_match ("script.script.script", "SCR*SCR*SCR*", 1));
-    LONGS_EQUAL(0, string_match ("script.script.script", "scr*scr*scr*scr*", 0));
+    struct t_string_mask *mask;
+
+    WEE_MATCH(0, NULL, NULL, 0);
+    WEE_MATCH(0, NULL, "test", 0);
+    WEE_MATCH(0, "test", NULL, 0);
+    WEE_MATCH(0, "", "", 0);
+    WEE_MATCH(0, "", "test", 0);
+    WEE_MATCH(0, "test", "", 0);
+    WEE_MATCH(0, "test", "def", 0);
+    WEE_MATCH(0, "test", "def", 1);
+    WEE_MATCH(0, "test", "def*", 0);
+    WEE_MATCH(0, "test", "def*", 1);
+    WEE_MATCH(0, "test", "*def", 0);
+    WEE_MATCH(0, "test", "*def", 1);
+    WEE_MATCH(0, "test", "*def*", 0);
+    WEE_MATCH(0, "test", "*def*", 1);
+    WEE_MATCH(0, "test", "def", 0);
+    WEE_MATCH(0, "test", "def", 1);
+    WEE_MATCH(0, "test", "es", 0);
+    WEE_MATCH(0, "test", "es", 1);
+    WEE_MATCH(0, "test", "es*", 0);
+    WEE_MATCH(0, "test", "es*", 1);
+    WEE_MATCH(0, "test", "*es", 0);
+    WEE_MATCH(0, "test", "*es", 1);
+    WEE_MATCH(1, "test", "*es*", 0);
+    WEE_MATCH(1, "test", "**es**", 0);
+    WEE_MATCH(1, "test", "*es*", 1);
+    WEE_MATCH(1, "test", "*ES*", 0);
+    WEE_MATCH(0, "test", "*ES*", 1);
+    WEE_MATCH(1, "TEST", "*es*", 0);
+    WEE_MATCH(0, "TEST", "*es*", 1);
+    WEE_MATCH(0, "aaba", "*aa", 0);
+    WEE_MATCH(0, "aaba", "*aa", 1);
+    WEE_MATCH(1, "abaa", "*aa", 0);
+    WEE_MATCH(1, "abaa", "*aa", 1);
+    WEE_MATCH(1, "aabaa", "*aa", 0);
+    WEE_MATCH(1, "aabaa", "*aa", 1);
+    WEE_MATCH(1, "aabaabaabaa", "*aa", 0);
+    WEE_MATCH(1, "aabaabaabaa", "*aa", 1);
+    WEE_MATCH(1, "bbb", "*bb", 0);
+    WEE_MATCH(1, "bbb", "*bb", 1);
+    WEE_MATCH(1, "abababc", "*abc", 1);
+    WEE_MATCH(1, "xaaay", "*aa*y", 1);
+    WEE_MATCH(0, "abaa", "aa*", 0);
+    WEE_MATCH(0, "abaa", "aa*", 1);
+    WEE_MATCH(1, "aaba", "aa*", 0);
+    WEE_MATCH(1, "aaba", "aa*", 1);
+    WEE_MATCH(1, "aabaa", "aa*", 0);
+    WEE_MATCH(1, "aabaa", "aa*", 1);
+    WEE_MATCH(1, "aabaabaabaa", "aa*", 0);
+    WEE_MATCH(1, "aabaabaabaa", "aa*", 1);
+    WEE_MATCH(1, "script.color.description", "*script.color*", 0);
+    WEE_MATCH(1, "script.color.description", "*script.color*", 1);
+    WEE_MATCH(1, "script.color.description", "*script.COLOR*", 0);
+    WEE_MATCH(0, "script.color.description", "*script.COLOR*", 1);
+    WEE_MATCH(1, "script.color.description", "*script*color*", 0);
+    WEE_MATCH(1, "script.color.description", "*script*color*", 1);
+    WEE_MATCH(1, "script.color.description", "*script*COLOR*", 0);
+    WEE_MATCH(0, "script.color.description", "*script*COLOR*", 1);
+    WEE_MATCH(1, "script.script.script", "scr*scr*scr*", 0);
+    WEE_MATCH(1, "script.script.script", "SCR*SCR*SCR*", 0);
+    WEE_MATCH(0, "script.script.script", "SCR*SCR*SCR*", 1);
+    WEE_MATCH(0, "script.script.script", "scr*scr*scr*scr*", 0);
 }
 
 /*
  * Test functions:
  *   string_match_list
+ *   string_mask_list_compile
+ *   string_mask_list_match
+ *   string_mask_list_free
  */
 
 TEST(CoreString, MatchList)
@@ -930,52 +971,160 @@ TEST(CoreString, MatchList)
     const char *masks_two[3] = { "toto", "abc", NULL };
     const char *masks_negative[3] = { "*", "!abc", NULL };
     const char *masks_negative_star[3] = { "*", "!abc*", NULL };
+    struct t_string_mask **masks;
+
+    WEE_MATCH_LIST(0, NULL, NULL, 0);
+    WEE_MATCH_LIST(0, NULL, masks_one, 0);
+
+    WEE_MATCH_LIST(0, "", NULL, 0);
+    WEE_MATCH_LIST(0, "", masks_none, 0);
+    WEE_MATCH_LIST(0, "", masks_one_empty, 0);
+    WEE_MATCH_LIST(0, "", masks_none, 0);
+    WEE_MATCH_LIST(0, "", masks_one_empty, 0);
+
+    WEE_MATCH_LIST(0, "toto", NULL, 0);
+    WEE_MATCH_LIST(0, "toto", masks_none, 0);
+    WEE_MATCH_LIST(0, "toto", masks_one_empty, 0);
+    WEE_MATCH_LIST(0, "toto", masks_none, 0);
+    WEE_MATCH_LIST(0, "toto", masks_one_empty, 0);
+
+    WEE_MATCH_LIST(0, "test", masks_one, 0);
+    WEE_MATCH_LIST(0, "to", masks_one, 0);
+    WEE_MATCH_LIST(1, "toto", masks_one, 0);
+    WEE_MATCH_LIST(1, "TOTO", masks_one, 0);
+    WEE_MATCH_LIST(0, "TOTO", masks_one, 1);
+
+    WEE_MATCH_LIST(0, "test", masks_two, 0);
+    WEE_MATCH_LIST(1, "toto", masks_two, 0);
+    WEE_MATCH_LIST(1, "abc", masks_two, 0);
+    WEE_MATCH_LIST(0, "def", masks_two, 0);
+
+    WEE_MATCH_LIST(1, "test", masks_negative, 0);
+    WEE_MATCH_LIST(1, "toto", masks_negative, 0);
+    WEE_MATCH_LIST(0, "abc", masks_negative, 0);
+    WEE_MATCH_LIST(0, "ABC", masks_negative, 0);
+    WEE_MATCH_LIST(1, "ABC", masks_negative, 1);
+    WEE_MATCH_LIST(1, "abcdef", masks_negative, 0);
+    WEE_MATCH_LIST(1, "ABCDEF", masks_negative, 0);
+    WEE_MATCH_LIST(1, "ABCDEF", masks_negative, 1);
+    WEE_MATCH_LIST(1, "def", masks_negative, 0);
+
+    WEE_MATCH_LIST(1, "test", masks_negative_star, 0);
+    WEE_MATCH_LIST(1, "toto", masks_negative_star, 0);
+    WEE_MATCH_LIST(0, "abc", masks_negative_star, 0);
+    WEE_MATCH_LIST(0, "ABC", masks_negative_star, 0);
+    WEE_MATCH_LIST(1, "ABC", masks_negative_star, 1);
+    WEE_MATCH_LIST(0, "abcdef", masks_negative_star, 0);
+    WEE_MATCH_LIST(0, "ABCDEF", masks_negative_star, 0);
+    WEE_MATCH_LIST(1, "ABCDEF", masks_negative_star, 1);
+    WEE_MATCH_LIST(1, "def", masks_negative_star, 0);
+}
 
-    LONGS_EQUAL(0, string_match_list (NULL, NULL, 0));
-    LONGS_EQUAL(0, string_match_list (NULL, masks_one, 0));
-
-    LONGS_EQUAL(0, string_match_list ("", NULL, 0));
-    LONGS_EQUAL(0, string_match_list ("", masks_none, 0));
-    LONGS_EQUAL(0, string_match_list ("", masks_one_empty, 0));
-    LONGS_EQUAL(0, string_match_list ("", masks_none, 0));
-    LONGS_EQUAL(0, string_match_list ("", masks_one_empty, 0));
-
-    LONGS_EQUAL(0, string_match_list ("toto", NULL, 0));
-    LONGS_EQUAL(0, string_match_list ("toto", masks_none, 0));
-    LONGS_EQUAL(0, string_match_list ("toto", masks_one_empty, 0));
-    LONGS_EQUAL(0, string_match_list ("toto", masks_none, 0));
-    LONGS_EQUAL(0, string_match_list ("toto", masks_one_empty, 0));
-
-    LONGS_EQUAL(0, string_match_list ("test", masks_one, 0));
-    LONGS_EQUAL(0, string_match_list ("to", masks_one, 0));
-    LONGS_EQUAL(1, string_match_list ("toto", masks_one, 0));
-    LONGS_EQUAL(1, string_match_list ("TOTO", masks_one, 0));
-    LONGS_EQUAL(0, string_match_list ("TOTO", masks_one, 1));
-
-    LONGS_EQUAL(0, string_match_list ("test", masks_two, 0));
-    LONGS_EQUAL(1, string_match_list ("toto", masks_two, 0));
-    LONGS_EQUAL(1, string_match_list ("abc", masks_two, 0));
-    LONGS_EQUAL(0, string_match_list ("def", masks_two, 0));
-
-    LONGS_EQUAL(1, string_match_list ("test", masks_negative, 0));
-    LONGS_EQUAL(1, string_match_list ("toto", masks_negative, 0));
-    LONGS_EQUAL(0, string_match_list ("abc", masks_negative, 0));
-    LONGS_EQUAL(0, string_match_list ("ABC", masks_negative, 0));
-    LONGS_EQUAL(1, string_match_list ("ABC", masks_negative, 1));
-    LONGS_EQUAL(1, string_match_list ("abcdef", masks_negative, 0));
-    LONGS_EQUAL(1, string_match_list ("ABCDEF", masks_negative, 0));
-    LONGS_EQUAL(1, string_match_list ("ABCDEF", masks_negative, 1));
-    LONGS_EQUAL(1, string_match_list ("def", masks_negative, 0));
-
-    LONGS_EQUAL(1, string_match_list ("test", masks_negative_star, 0));
-    LONGS_EQUAL(1, string_match_list ("toto", masks_negative_star, 0));
-    LONGS_EQUAL(0, string_match_list ("abc", masks_negative_star, 0));
-    LONGS_EQUAL(0, string_match_list ("ABC", masks_negative_star, 0));
-    LONGS_EQUAL(1, string_match_list ("ABC", masks_negative_star, 1));
-    LONGS_EQUAL(0, string_match_list ("abcdef", masks_negative_star, 0));
-    LONGS_EQUAL(0, string_match_list ("ABCDEF", masks_negative_star, 0));
-    LONGS_EQUAL(1, string_match_list ("ABCDEF", masks_negative_star, 1));
-    LONGS_EQUAL(1, string_match_list ("def", masks_negative_star, 0));
+/*
+ * Test functions:
+ *   string_mask_compile
+ *   string_mask_match
+ */
+
+TEST(CoreString, MaskCompiled)
+{
+    const char *chars[] = { "a", "b", "A", "B", "*", "é", "É", "." };
+    struct t_string_mask *mask;
+    char str_mask[64], string[512];
+    int i, j, length, num_chars, case_sensitive;
+
+    POINTERS_EQUAL(NULL, string_mask_compile (NULL, 0));
+    POINTERS_EQUAL(NULL, string_mask_compile ("", 0));
+    LONGS_EQUAL(0, string_mask_match (NULL, "test"));
+    string_mask_free (NULL);
+
+    /* type of masks */
+    mask = string_mask_compile ("***", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_ANY, mask->type);
+    LONGS_EQUAL(0, mask->num_words);
+    LONGS_EQUAL(1, string_mask_match (mask, ""));
+    LONGS_EQUAL(0, string_mask_match (mask, NULL));
+    string_mask_free (mask);
+    mask = string_mask_compile ("Test", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_LITERAL, mask->type);
+    LONGS_EQUAL(1, mask->num_words);
+    STRCMP_EQUAL("test", mask->words[0]);
+    LONGS_EQUAL(4, mask->length_words[0]);
+    string_mask_free (mask);
+    mask = string_mask_compile ("Test", 1);
+    LONGS_EQUAL(STRING_MASK_TYPE_LITERAL, mask->type);
+    STRCMP_EQUAL("Test", mask->words[0]);
+    string_mask_free (mask);
+    mask = string_mask_compile ("test**", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_PREFIX, mask->type);
+    STRCMP_EQUAL("test", mask->words[0]);
+    string_mask_free (mask);
+    mask = string_mask_compile ("*test", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_SUFFIX, mask->type);
+    STRCMP_EQUAL("test", mask->words[0]);
+    string_mask_free (mask);
+    mask = string_mask_compile ("*test*", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_GENERAL, mask->type);
+    LONGS_EQUAL(1, mask->num_words);
+    string_mask_free (mask);
+    mask = string_mask_compile ("a**b*c", 0);
+    LONGS_EQUAL(STRING_MASK_TYPE_GENERAL, mask->type);
+    LONGS_EQUAL(0, mask->wildcard_start);
+    LONGS_EQUAL(0, mask->wildcard_end);
+    LONGS_EQUAL(3, mask->num_words);
+    STRCMP_EQUAL("a", mask->words[0]);
+    STRCMP_EQUAL("b", mask->words[1]);
+    STRCMP_EQUAL("c", mask->words[2]);
+    POINTERS_EQUAL(NULL, mask->words[3]);
+    LONGS_EQUAL(1, string_mask_match (mask, "abc"));
+    LONGS_EQUAL(1, string_mask_match (mask, "aXbYc"));
+    LONGS_EQUAL(0, string_mask_match (mask, "ac"));
+    LONGS_EQUAL(0, string_mask_match (mask, "abcd"));
+    string_mask_free (mask);
+
+    /* case insensitive with non-ASCII chars */
+    mask = string_mask_compile ("*ÉTÉ*", 0);
+    LONGS_EQUAL(1, string_mask_match (mask, "un été chaud"));
+    LONGS_EQUAL(1, string_mask_match (mask, "UN ÉTÉ CHAUD"));
+    LONGS_EQUAL(0, string_mask_match (mask, "un ete chaud"));
+    string_mask_free (mask);
+
+    /* string longer than the internal buffer */
+    memset (string, 'A', sizeof (string) - 1);
+    string[sizeof (string) - 1] = '\0';
+    string[sizeof (string) - 2] = 'Z';
+    mask = string_mask_compile ("a*z", 0);
+    LONGS_EQUAL(1, string_mask_match (mask, string));
+    string_mask_free (mask);
+    mask = string_mask_compile ("a*z", 1);
+    LONGS_EQUAL(0, string_mask_match (mask, string));
+    string_mask_free (mask);
+
+    /* compare with string_match on random strings and masks */
+    num_chars = sizeof (chars) / sizeof (chars[0]);
+    srand (42);
+    for (i = 0; i < 20000; i++)
+    {
+        str_mask[0] = '\0';
+        length = 1 + (rand () % 6);
+        for (j = 0; j < length; j++)
+        {
+            strcat (str_mask, chars[rand () % num_chars]);
+        }
+        string[0] = '\0';
+        length = rand () % 9;
+        for (j = 0; j < length; j++)
+        {
+            strcat (string, chars[rand () % num_chars]);
+        }
+        for (case_sensitive = 0; case_sensitive <= 1; case_sensitive++)
+        {
+            mask = string_mask_compile (str_mask, case_sensitive);
+            LONGS_EQUAL(string_match (string, str_mask, case_sensitive),
+                        string_mask_match (mask, string));
+            string_mask_free (mask);
+        }
+    }
 }
 
 /*
@@ -1360,6 +1509,221 @@ TEST(CoreString, Regex)
     regfree (&regex);
 }
 
+/*
+ * Test functions:
+ *   string_regex_to_pcre2
+ */
+
+TEST(CoreString, RegexToPcre2)
+{
+    char *str;
+    int positions;
+
+    /* invalid or basic regex: not converted */
+    POINTERS_EQUAL(NULL, string_regex_to_pcre2 (NULL, REG_EXTENDED, NULL));
+    POINTERS_EQUAL(NULL, string_regex_to_pcre2 ("abc", 0, NULL));
+    POINTERS_EQUAL(NULL, string_regex_to_pcre2 ("abc", REG_ICASE, NULL));
+
+    /* same syntax in POSIX and PCRE2 */
+    WEE_REGEX_TO_PCRE2("", 1, "", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("abc", 1, "abc", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("^a.b*c+d?$", 1, "^a.b*c+d?$", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("a\\.b\\*c\\(d\\)", 1, "a\\.b\\*c\\(d\\)",
+                       REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("\\w+\\s\\W\\S\\b\\B", 1, "\\w+\\s\\W\\S\\b\\B",
+                       REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("a{2}b{2,}c{2,3}", 1, "a{2}b{2,}c{2,3}",
+                       REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(ab)c\\1", 1, "(ab)c\\1", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[[:alpha:]_-]", 1, "[[:alpha:]_-]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("a\\-b\\ c", 1, "a\\-b\\ c", REG_EXTENDED);
+
+    /* GNU extensions */
+    WEE_REGEX_TO_PCRE2("\\b(?=\\w)word\\b(?<=\\w)", 1, "\\<word\\>",
+                       REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("\\Aword\\z", 1, "\\`word\\'", REG_EXTENDED);
+
+    /* brackets */
+    WEE_REGEX_TO_PCRE2("[a\\\\b]", 1, "[a\\b]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[a\\[b]", 1, "[a[b]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[\\]a]", 1, "[]a]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[^\\]a]", 1, "[^]a]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[^a]", 1, "[^a]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("[^\\na]", 1, "[^a]", REG_EXTENDED | REG_NEWLINE);
+    WEE_REGEX_TO_PCRE2("[a]", 1, "[a]", REG_EXTENDED | REG_NEWLINE);
+
+    /* literal "{" */
+    WEE_REGEX_TO_PCRE2("a\\{", 1, "a{", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("\\{x}", 1, "{x}", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("a\\{2,b}", 1, "a{2,b}", REG_EXTENDED);
+
+    /* match positions may be different with PCRE2 */
+    WEE_REGEX_TO_PCRE2("a|b", 0, "a|b", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(a|ab)(c|bcd)", 0, "(a|ab)(c|bcd)", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(ab)*", 0, "(ab)*", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(ab)+c", 0, "(ab)+c", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(ab){2}", 0, "(ab){2}", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2("(ab)\\*", 1, "(ab)\\*", REG_EXTENDED);
+
+    /* constructs with a different meaning in PCRE2: not converted */
+    WEE_REGEX_TO_PCRE2(NULL, 0, "a*?", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "a+*", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "a{2}+", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "a{,3}", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "(?:ab)", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "[[=a=]]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "[[.a.]]", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "\\d+", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "\\n", REG_EXTENDED);
+
+    /* invalid regex: not converted */
+    WEE_REGEX_TO_PCRE2(NULL, 0, "[abc", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "[[:alpha:", REG_EXTENDED);
+    WEE_REGEX_TO_PCRE2(NULL, 0, "abc\\", REG_EXTENDED);
+}
+
+/*
+ * Test functions:
+ *   string_regex_compile
+ *   string_regex_exec
+ *   string_regex_free
+ */
+
+TEST(CoreString, RegexExec)
+{
+    const char *regexes[] = {
+        "test",
+        "(?i)TEST",
+        "^test",
+        "test$",
+        "\\<test\\>",
+        "(te)(st)?",
+        "(t|te)(st|s)",
+        "(ab)*c",
+        "[^a]b",
+        "(?n)^b",
+        "(?n)a.b",
+        "(?s)te(st)",
+        "(?-e)te\\(st\\)",
+        "[[:digit:]]+ [[:alpha:]]+",
+        "élé(ment)",
+        NULL,
+    };
+    const char *strings[] = {
+        "",
+        "test",
+        "a TEST",
+        "testing",
+        "this is a test",
+        "abababc",
+        "ab\nb",
+        "a\nb",
+        "42 élément",
+        "\xff test \xfe",
+        NULL,
+    };
+    struct t_string_regex regex;
+    regmatch_t regex_match[4], regex_match_ref[4];
+    int i, j, k, eflags, rc, rc_ref;
+
+    LONGS_EQUAL(-1, string_regex_compile (NULL, "test", 0));
+    LONGS_EQUAL(-1, string_regex_compile (&regex, NULL, 0));
+    POINTERS_EQUAL(NULL, regex.pcre2);
+    LONGS_EQUAL(REG_NOMATCH, string_regex_exec (NULL, "test", 0, NULL, 0));
+    string_regex_free (NULL);
+
+    CHECK(string_regex_compile (&regex, "[abc", REG_EXTENDED) != 0);
+    POINTERS_EQUAL(NULL, regex.pcre2);
+
+    LONGS_EQUAL(0, string_regex_compile (&regex, "test", REG_EXTENDED));
+#ifdef HAVE_PCRE2
+    CHECK(regex.pcre2);
+#else
+    POINTERS_EQUAL(NULL, regex.pcre2);
+#endif
+    LONGS_EQUAL(REG_NOMATCH, string_regex_exec (&regex, NULL, 0, NULL, 0));
+    LONGS_EQUAL(0, string_regex_exec (&regex, "a test", 0, NULL, 0));
+    LONGS_EQUAL(0, string_regex_exec (&regex, "a test", 1, regex_match, 0));
+    LONGS_EQUAL(2, regex_match[0].rm_so);
+    LONGS_EQUAL(6, regex_match[0].rm_eo);
+    LONGS_EQUAL(REG_NOMATCH, string_regex_exec (&regex, "tes", 0, NULL, 0));
+    string_regex_free (&regex);
+    POINTERS_EQUAL(NULL, regex.pcre2);
+
+    /* basic regex: never compiled with PCRE2 */
+    LONGS_EQUAL(0, string_regex_compile (&regex, "te\\(st\\)", 0));
+    POINTERS_EQUAL(NULL, regex.pcre2);
+    LONGS_EQUAL(0, string_regex_exec (&regex, "a test", 0, NULL, 0));
+    string_regex_free (&regex);
+
+    /* same result as regexec (including match positions) */
+    for (i = 0; regexes[i]; i++)
+    {
+        LONGS_EQUAL(0, string_regex_compile (&regex, regexes[i], REG_EXTENDED));
+        for (j = 0; strings[j]; j++)
+        {
+            for (eflags = 0; eflags <= (REG_NOTBOL | REG_NOTEOL); eflags++)
+            {
+                rc_ref = regexec (&regex.regex, strings[j], 0, NULL, eflags);
+                rc = string_regex_exec (&regex, strings[j], 0, NULL, eflags);
+                LONGS_EQUAL(rc_ref, rc);
+                memset (regex_match_ref, 0, sizeof (regex_match_ref));
+                memset (regex_match, 0, sizeof (regex_match));
+                rc_ref = regexec (&regex.regex, strings[j], 4,
+                                  regex_match_ref, eflags);
+                rc = string_regex_exec (&regex, strings[j], 4, regex_match,
+                                        eflags);
+                LONGS_EQUAL(rc_ref, rc);
+                if (rc == 0)
+                {
+                    for (k = 0; k < 4; k++)
+                    {
+                        LONGS_EQUAL(regex_match_ref[k].rm_so,
+                                    regex_match[k].rm_so);
+                        LONGS_EQUAL(regex_match_ref[k].rm_eo,
+                                    regex_match[k].rm_eo);
+                    }
+                }
+            }
+        }
+        string_regex_free (&regex);
+    }
+}
+
+/*
+ * Test functions:
+ *   string_regex_new
+ *   string_regex_match
+ */
+
+TEST(CoreString, RegexNewMatch)
+{
+    struct t_string_regex *regex;
+
+    POINTERS_EQUAL(NULL, string_regex_new (NULL, 0));
+    POINTERS_EQUAL(NULL, string_regex_new ("[abc", REG_EXTENDED));
+    LONGS_EQUAL(0, string_regex_match (NULL, "test"));
+
+    regex = string_regex_new ("^irc", REG_EXTENDED | REG_ICASE | REG_NOSUB);
+    CHECK(regex);
+    LONGS_EQUAL(0, string_regex_match (regex, NULL));
+    LONGS_EQUAL(0, string_regex_match (regex, ""));
+    LONGS_EQUAL(0, string_regex_match (regex, "abcdef"));
+    LONGS_EQUAL(0, string_regex_match (regex, "test irc"));
+    LONGS_EQUAL(1, string_regex_match (regex, "irc"));
+    LONGS_EQUAL(1, string_regex_match (regex, "IRC server"));
+    string_regex_free (regex);
+    free (regex);
+
+    /* flags at beginning of regex */
+    regex = string_regex_new ("(?-i)^irc", REG_EXTENDED | REG_ICASE);
+    CHECK(regex);
+    LONGS_EQUAL(1, string_regex_match (regex, "irc"));
+    LONGS_EQUAL(0, string_regex_match (regex, "IRC"));
+    string_regex_free (regex);
+    free (regex);
+}
+
 /*
  * Test functions:
  *   string_has_highlight
@@ -1369,7 +1733,7 @@ TEST(CoreString, Regex)
 
 TEST(CoreString, Highlight)
 {
-    regex_t regex;
+    struct t_string_regex regex;
 
     /* check highlight with a string */
     WEE_HAS_HL_STR(0, NULL, NULL);
@@ -1389,6 +1753,27 @@ TEST(CoreString, Highlight)
     WEE_HAS_HL_STR(1, "test\u00A0:here", "test");  /* unbreakable space */
     WEE_HAS_HL_STR(1, "this is a test here", "test");
     WEE_HAS_HL_STR(1, "this is a test here", "abc,test");
+    WEE_HAS_HL_STR(1, "this is a TEST here", "abc,test");
+    WEE_HAS_HL_STR(1, "this is a test here", "abc,TeSt");
+    WEE_HAS_HL_STR(0, "this is a TEST here", "abc,(?-i)test");
+    WEE_HAS_HL_STR(1, "this is a test here", "abc,(?-i)test");
+    WEE_HAS_HL_STR(1, "this is a TEST here", "(?-i)abc,test");
+    WEE_HAS_HL_STR(0, "testing", "test");
+    WEE_HAS_HL_STR(1, "testing", "test*");
+    WEE_HAS_HL_STR(0, "testing", "*test");
+    WEE_HAS_HL_STR(1, "unittest", "*test");
+    WEE_HAS_HL_STR(1, "unittesting", "*test*");
+    WEE_HAS_HL_STR(0, "test", "*,**,***");
+    WEE_HAS_HL_STR(1, "été", "ÉTÉ");
+    WEE_HAS_HL_STR(1, "l'ÉTÉ arrive", "été");
+    WEE_HAS_HL_STR(0, "l'ÉTÉ arrive", "(?-i)été");
+    WEE_HAS_HL_STR(1, "ask alice", "alice,ali,lic,ice");
+    WEE_HAS_HL_STR(1, "ask ali", "alice,ali,lic,ice");
+    WEE_HAS_HL_STR(0, "ask alic", "alice,ali,lic,ice");
+    WEE_HAS_HL_STR(1, "ask alic", "alice,ali,*lic,ice");
+    WEE_HAS_HL_STR(1, "nicknick nick", "nick");
+    WEE_HAS_HL_STR(1, "abab", "*ab");
+    WEE_HAS_HL_STR(1, "aXaXa", "*aXa");
 
     /*
      * check highlight with a regex, each call of macro
@@ -1409,6 +1794,179 @@ TEST(CoreString, Highlight)
     WEE_HAS_HL_REGEX(0, 0, "test here", "teste.*");
 }
 
+/*
+ * Checks if a string has a highlight, one word at a time (reference
+ * implementation used to check the result of string_has_highlight).
+ */
+
+int
+test_string_has_highlight_ref (const char *string, const char *highlight_words)
+{
+    const char *match, *match_pre, *match_post, *msg_pos;
+    char **words, *word;
+    int i, num_words, rc, length, startswith, endswith, wildcard_start;
+    int wildcard_end;
+
+    words = string_split (highlight_words, ",", NULL, 0, 0, &num_words);
+    rc = 0;
+    for (i = 0; (i < num_words) && !rc; i++)
+    {
+        word = words[i];
+        length = strlen (word);
+        wildcard_start = (word[0] == '*');
+        if (wildcard_start)
+        {
+            word++;
+            length--;
+        }
+        wildcard_end = ((length > 0) && (word[length - 1] == '*'));
+        if (wildcard_end)
+            word[--length] = '\0';
+        if (length <= 0)
+            continue;
+        msg_pos = string;
+        while (1)
+        {
+            match = string_strcasestr (msg_pos, word);
+            if (!match)
+                break;
+            match_pre = utf8_prev_char (string, match);
+            if (!match_pre)
+                match_pre = match - 1;
+            match_post = match + length;
+            startswith = ((match == string)
+                          || (!string_is_word_char_highlight (match_pre)));
+            endswith = ((!match_post[0])
+                        || (!string_is_word_char_highlight (match_post)));
+            if ((wildcard_start && wildcard_end)
+                || (!wildcard_start && !wildcard_end && startswith && endswith)
+                || (wildcard_start && endswith)
+                || (wildcard_end && startswith))
+            {
+                rc = 1;
+                break;
+            }
+            msg_pos = utf8_next_char (match);
+        }
+    }
+    string_free_split (words);
+
+    return rc;
+}
+
+/*
+ * Test functions:
+ *   string_highlight_compile
+ *   string_highlight_match
+ *   string_highlight_free
+ */
+
+TEST(CoreString, HighlightCompiled)
+{
+    struct t_string_highlight *highlight;
+    const char *chars[] = { "a", "b", "A", "B", "é", "É", " ", ",", "-", "*",
+                            NULL };
+    char words[256], string[256];
+    int i, j, num_chars;
+
+    POINTERS_EQUAL(NULL, string_highlight_compile (NULL));
+    LONGS_EQUAL(0, string_highlight_match (NULL, "test"));
+    string_highlight_free (NULL);
+
+    highlight = string_highlight_compile ("");
+    CHECK(highlight);
+    LONGS_EQUAL(0, highlight->num_words);
+    LONGS_EQUAL(0, string_highlight_match (highlight, "test"));
+    string_highlight_free (highlight);
+
+    highlight = string_highlight_compile ("nick,*nick,(?-i)Nick,nickname*,*,");
+    CHECK(highlight);
+    LONGS_EQUAL(4, highlight->num_words);
+    LONGS_EQUAL(8, highlight->max_length);
+    /* "nick", "nickname": 8 states + initial state */
+    LONGS_EQUAL(9, highlight->automaton[STRING_HIGHLIGHT_CASE_INSENSITIVE].num_states);
+    LONGS_EQUAL(5, highlight->automaton[STRING_HIGHLIGHT_CASE_SENSITIVE].num_states);
+    LONGS_EQUAL(0, string_highlight_match (highlight, NULL));
+    LONGS_EQUAL(0, string_highlight_match (highlight, ""));
+    LONGS_EQUAL(0, string_highlight_match (highlight, "nicks"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "nick"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "hi NICK!"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "mynick: hello"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "nicknames"));
+    string_highlight_free (highlight);
+
+    /* single word: no automaton */
+    highlight = string_highlight_compile ("(?-i)*Nick");
+    CHECK(highlight);
+    LONGS_EQUAL(1, highlight->num_words);
+    STRCMP_EQUAL("Nick", highlight->word);
+    LONGS_EQUAL(STRING_HIGHLIGHT_CASE_SENSITIVE, highlight->word_case);
+    LONGS_EQUAL(0, highlight->automaton[STRING_HIGHLIGHT_CASE_INSENSITIVE].num_states);
+    LONGS_EQUAL(0, highlight->automaton[STRING_HIGHLIGHT_CASE_SENSITIVE].num_states);
+    LONGS_EQUAL(0, string_highlight_match (highlight, "nick"));
+    LONGS_EQUAL(0, string_highlight_match (highlight, "Nicks"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "myNick: hello"));
+    string_highlight_free (highlight);
+    highlight = string_highlight_compile ("ÉTÉ");
+    CHECK(highlight);
+    STRCMP_EQUAL("été", highlight->word);
+    LONGS_EQUAL(0, string_highlight_match (highlight, "étés"));
+    LONGS_EQUAL(1, string_highlight_match (highlight, "bel Été !"));
+    string_highlight_free (highlight);
+
+    /* words set in an option: not compiled if they contain local variables */
+    POINTERS_EQUAL(NULL, string_highlight_compile_option (NULL));
+    POINTERS_EQUAL(NULL, string_highlight_compile_option (""));
+    POINTERS_EQUAL(NULL, string_highlight_compile_option ("test,$nick"));
+    highlight = string_highlight_compile_option ("test,nick");
+    CHECK(highlight);
+    LONGS_EQUAL(2, highlight->num_words);
+    string_highlight_free (highlight);
+
+    /* compiled words are cached */
+    WEE_HAS_HL_STR(1, "test", "test,cache");
+    CHECK(string_hashtable_highlight);
+    CHECK(hashtable_has_key (string_hashtable_highlight, "test,cache"));
+    STRCMP_EQUAL("test,cache", string_highlight_first->key);
+
+    /* least recently used words are removed when cache is full */
+    for (i = 0; i < STRING_HIGHLIGHT_CACHE_SIZE; i++)
+    {
+        snprintf (words, sizeof (words), "test,word%d", i);
+        WEE_HAS_HL_STR(1, "test", words);
+        /* "test,cache" is used again: it is kept in cache */
+        WEE_HAS_HL_STR(1, "test", "test,cache");
+    }
+    LONGS_EQUAL(STRING_HIGHLIGHT_CACHE_SIZE,
+                string_hashtable_highlight->items_count);
+    CHECK(hashtable_has_key (string_hashtable_highlight, "test,cache"));
+    CHECK(!hashtable_has_key (string_hashtable_highlight, "test,word0"));
+    CHECK(hashtable_has_key (string_hashtable_highlight, "test,word63"));
+    STRCMP_EQUAL("test,cache", string_highlight_first->key);
+    STRCMP_EQUAL("test,word1", string_highlight_last->key);
+
+    /* compare with reference implementation on random strings and words */
+    for (num_chars = 0; chars[num_chars]; num_chars++)
+    {
+    }
+    srand (42);
+    for (i = 0; i < 2000; i++)
+    {
+        words[0] = '\0';
+        for (j = 0; j < 12; j++)
+        {
+            strcat (words, chars[rand () % num_chars]);
+        }
+        string[0] = '\0';
+        for (j = 0; j < 24; j++)
+        {
+            strcat (string, chars[rand () % num_chars]);
+        }
+        LONGS_EQUAL(test_string_has_highlight_ref (string, words),
+                    string_has_highlight (string, words));
+    }
+}
+
 /*
  * Test callback for function string_replace_with_callback.
  *
@@ -3038,11 +3596,13 @@ TEST(CoreString, GetPriorityAndName)
  * Test functions:
  *   string_shared_get
  *   string_shared_free
+ *   string_shared_get_id
  */
 
 TEST(CoreString, Shared)
 {
     const char *str1, *str2, *str3;
+    string_shared_id_t id;
     int count;
 
     count = (string_hashtable_shared) ?
@@ -3052,12 +3612,14 @@ TEST(CoreString, Shared)
 
     str1 = string_shared_get ("this is a test");
     CHECK(str1);
+    CHECK(string_shared_get_id (str1) > 0);
 
     LONGS_EQUAL(count + 1, string_hashtable_shared->items_count);
 
     str2 = string_shared_get ("this is a test");
     CHECK(str2);
     POINTERS_EQUAL(str1, str2);
+    LONGS_EQUAL(string_shared_get_id (str1), string_shared_get_id (str2));
 
     LONGS_EQUAL(count + 1, string_hashtable_shared->items_count);
 
@@ -3065,6 +3627,8 @@ TEST(CoreString, Shared)
     CHECK(str3);
     CHECK(str1 != str3);
     CHECK(str2 != str3);
+    CHECK(string_shared_get_id (str3) > 0);
+    CHECK(string_shared_get_id (str1) != string_shared_get_id (str3));
 
     LONGS_EQUAL(count + 2, string_hashtable_shared->items_count);
 
@@ -3079,6 +3643,16 @@ TEST(CoreString, Shared)
 
     /* test free of NULL */
     string_shared_free (NULL);
+
+    /* id is not reused by a new string */
+    str1 = string_shared_get ("this is a test");
+    id = string_shared_get_id (str1);
+    string_shared_free (str1);
+    str1 = string_shared_get ("this is a test");
+    CHECK(string_shared_get_id (str1) != id);
+    string_shared_free (str1);
+
+    LONGS_EQUAL(0, string_shared_get_id (NULL));
 }
 
 /*
@@ -28,7 +28,9 @@
 extern "C"
 {
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
 #include <wctype.h>
 #include "src/core/core-utf8.h"
 #include "src/core/core-config.h"
@@ -619,6 +621,174 @@ TEST(CoreUtf8, Size)
     config_file_option_reset (config_look_tab_width, 1);
 }
 
+/*
+ * Check if a string is UTF-8 valid, one char at a time (reference
+ * implementation, used to check the result of utf8_is_valid).
+ */
+
+int
+test_utf8_is_valid_ref (const char *string, int length, char **error)
+{
+    const unsigned char *ptr;
+    int current_char, size, code_point, i;
+
+    ptr = (const unsigned char *)string;
+    current_char = 0;
+    while (ptr && ptr[0] && ((length <= 0) || (current_char < length)))
+    {
+        if (ptr[0] < 0x80)
+            size = 1;
+        else if ((ptr[0] & 0xE0) == 0xC0)
+            size = 2;
+        else if ((ptr[0] & 0xF0) == 0xE0)
+            size = 3;
+        else if ((ptr[0] & 0xF8) == 0xF0)
+            size = 4;
+        else
+            goto invalid;
+        for (i = 1; i < size; i++)
+        {
+            if ((ptr[i] & 0xC0) != 0x80)
+                goto invalid;
+        }
+        code_point = utf8_char_int ((const char *)ptr);
+        if (((size == 2) && ((code_point < 0x80) || (code_point > 0x7FF)))
+            || ((size == 3) && ((code_point < 0x800) || (code_point > 0xFFFF)
+                                || ((code_point >= 0xD800) && (code_point <= 0xDFFF))))
+            || ((size == 4) && ((code_point < 0x10000) || (code_point > 0x1FFFFF))))
+        {
+            goto invalid;
+        }
+        ptr += size;
+        current_char++;
+    }
+    if (error)
+        *error = NULL;
+    return 1;
+
+invalid:
+    if (error)
+        *error = (char *)ptr;
+    return 0;
+}
+
+/*
+ * Get number of chars needed on screen to display the UTF-8 string, one
+ * char at a time with wcwidth (reference implementation, used to check
+ * the result of utf8_strlen_screen).
+ */
+
+int
+test_utf8_strlen_screen_ref (const char *string)
+{
+    const char *ptr;
+    int size_screen, width, code_point;
+
+    size_screen = 0;
+    for (ptr = string; ptr && ptr[0]; ptr = utf8_next_char (ptr))
+    {
+        if (ptr[0] == '\t')
+            width = CONFIG_INTEGER(config_look_tab_width);
+        else if ((unsigned char)ptr[0] < 32)
+            width = 1;
+        else
+        {
+            code_point = utf8_char_int (ptr);
+            width = ((code_point == 0x00AD) || (code_point == 0x200B)) ?
+                -1 : wcwidth ((wchar_t)code_point);
+        }
+        if (width > 0)
+            size_screen += width;
+    }
+    return size_screen;
+}
+
+/*
+ * Test functions:
+ *   utf8_init_width_table
+ *   utf8_ascii_length
+ *   utf8_ascii_printable_length
+ *   utf8_is_valid (fast path for ASCII chars)
+ *   utf8_char_size_screen (width table)
+ *   utf8_strlen_screen (fast path for ASCII chars)
+ */
+
+TEST(CoreUtf8, FastPath)
+{
+    char string[256], *error, *error_ref;
+    const char *chars[] = { "a", "Z", " ", "~", "\t", "\x01", "\x1f",
+                            UNICODE_DELETE, UNICODE_NEXT_LINE,
+                            UNICODE_SOFT_HYPHEN, UNICODE_ZERO_WIDTH_SPACE,
+                            UNICODE_SNOWMAN, UNICODE_CJK_YELLOW,
+                            UNICODE_HAN_CHAR, "\xc3\xab", "\xeb", "\xff",
+                            "\xc3", "\xe2\x82", "\xed\xa0\x80",
+                            "\xf8\x88\x80\x80", NULL };
+    int i, j, count, length, code_point, valid, valid_ref;
+
+    /* ASCII runs */
+    LONGS_EQUAL(0, utf8_ascii_length ("", 0));
+    LONGS_EQUAL(3, utf8_ascii_length ("abc", 3));
+    LONGS_EQUAL(2, utf8_ascii_length ("ab\xc3\xab", 4));
+    LONGS_EQUAL(40, utf8_ascii_length ("0123456789012345678901234567890123456789",
+                                       40));
+    LONGS_EQUAL(33, utf8_ascii_length ("012345678901234567890123456789012"
+                                       UNICODE_SNOWMAN "abc", 39));
+    LONGS_EQUAL(0, utf8_ascii_printable_length ("\t", 1));
+    LONGS_EQUAL(3, utf8_ascii_printable_length ("abc", 3));
+    LONGS_EQUAL(20, utf8_ascii_printable_length ("01234567890123456789"
+                                                 "\x01" "abc", 24));
+    LONGS_EQUAL(17, utf8_ascii_printable_length ("01234567890123456"
+                                                 UNICODE_DELETE "abc", 21));
+
+    /* width table: same result as wcwidth for all chars of the BMP */
+    for (code_point = 0x20; code_point < 0x10000; code_point++)
+    {
+        if ((code_point == 0x00AD) || (code_point == 0x200B))
+            continue;
+        if (utf8_width_table[code_point] != wcwidth ((wchar_t)code_point))
+        {
+            snprintf (string, sizeof (string),
+                      "width of U+%04X: %d (wcwidth: %d)",
+                      code_point, utf8_width_table[code_point],
+                      wcwidth ((wchar_t)code_point));
+            FAIL(string);
+        }
+        utf8_int_string (code_point, string);
+        LONGS_EQUAL(wcwidth ((wchar_t)code_point),
+                    utf8_char_size_screen (string));
+    }
+
+    /* strings with all lengths and chars at all positions */
+    srand (1234);
+    for (i = 0; i < 5000; i++)
+    {
+        string[0] = '\0';
+        length = rand () % 40;
+        for (j = 0; j < length; j++)
+        {
+            count = rand () % 100;
+            if (count < 70)
+                strcat (string, "x");
+            else
+            {
+                count = rand () % (int)(sizeof (chars) / sizeof (chars[0]) - 1);
+                strcat (string, chars[count]);
+            }
+        }
+        valid = utf8_is_valid (string, -1, &error);
+        valid_ref = test_utf8_is_valid_ref (string, -1, &error_ref);
+        LONGS_EQUAL(valid_ref, valid);
+        POINTERS_EQUAL(error_ref, error);
+        count = rand () % 40;
+        valid = utf8_is_valid (string, count, &error);
+        valid_ref = test_utf8_is_valid_ref (string, count, &error_ref);
+        LONGS_EQUAL(valid_ref, valid);
+        POINTERS_EQUAL(error_ref, error);
+        LONGS_EQUAL(test_utf8_strlen_screen_ref (string),
+                    utf8_strlen_screen (string));
+    }
+}
+
 /*
  * Test functions:
  *   utf8_strndup
@@ -183,6 +183,7 @@ TEST(CoreUtil, ParseNumber)
  *   util_timeval_cmp
  *   util_timeval_diff
  *   util_timeval_add
+ *   util_timeval_monotonic
  */
 
 TEST(CoreUtil, Timeval)
@@ -227,6 +228,13 @@ TEST(CoreUtil, Timeval)
     util_timeval_add (&tv, 999000);
     LONGS_EQUAL(123461, tv.tv_sec);
     LONGS_EQUAL(21000, tv.tv_usec);
+
+    /* monotonic clock */
+    util_timeval_monotonic (NULL);
+    util_timeval_monotonic (&tv1);
+    util_timeval_monotonic (&tv2);
+    CHECK(util_timeval_cmp (&tv1, &tv2) <= 0);
+    CHECK(util_timeval_diff (&tv1, &tv2) >= 0);
 }
 
 /*
@@ -31,6 +31,7 @@ extern "C"
 #include "src/core/core-hook.h"
 #include "src/core/core-input.h"
 #include "src/core/core-list.h"
+#include "src/core/core-string.h"
 #include "src/gui/gui-buffer.h"
 #include "src/gui/gui-completion.h"
 #include "src/gui/gui-hotlist.h"
@@ -1167,10 +1168,16 @@ TEST(GuiBuffer, Set)
 
     /* highlight_words, highlight_words_add, highlight_words_del */
     STRCMP_EQUAL(NULL, buffer->highlight_words);
+    POINTERS_EQUAL(NULL, buffer->highlight_words_compiled);
     gui_buffer_set (buffer, "highlight_words", "test1,test2");
     STRCMP_EQUAL("test1,test2", buffer->highlight_words);
+    CHECK(buffer->highlight_words_compiled);
+    LONGS_EQUAL(2, buffer->highlight_words_compiled->num_words);
+    gui_buffer_set (buffer, "highlight_words", "test,$nick");
+    POINTERS_EQUAL(NULL, buffer->highlight_words_compiled);
     gui_buffer_set (buffer, "highlight_words", "");
     STRCMP_EQUAL(NULL, buffer->highlight_words);
+    POINTERS_EQUAL(NULL, buffer->highlight_words_compiled);
     gui_buffer_set (buffer, "highlight_words_add", "test1");
     STRCMP_EQUAL("test1", buffer->highlight_words);
     gui_buffer_set (buffer, "highlight_words_add", "test2");
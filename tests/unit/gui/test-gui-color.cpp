@@ -25,8 +25,12 @@
 
 extern "C"
 {
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "src/core/core-config.h"
 #include "src/core/core-string.h"
+#include "src/core/core-utf8.h"
 #include "src/gui/gui-color.h"
 }
 
@@ -561,6 +565,236 @@ TEST(GuiColor, Decode)
     WEE_CHECK_DECODE("test_[color]option_weechat.color.chat_host", string, "[color]");
 }
 
+/*
+ * Removes color codes from a string, one char at a time (reference
+ * implementation used to check the result of gui_color_decode).
+ */
+
+char *
+test_gui_color_decode_ref (const char *string, const char *replacement)
+{
+    const char *ptr_string;
+    char **out;
+    int size;
+
+    out = string_dyn_alloc (strlen (string) + 1);
+    ptr_string = string;
+    while (ptr_string[0])
+    {
+        size = gui_color_code_size (ptr_string);
+        if (size > 0)
+        {
+            ptr_string += size;
+            if (replacement && replacement[0])
+                string_dyn_concat (out, replacement, -1);
+        }
+        else
+        {
+            size = utf8_char_size (ptr_string);
+            if (size == 0)
+                size = 1;
+            string_dyn_concat (out, ptr_string, size);
+            ptr_string += size;
+        }
+    }
+
+    return string_dyn_free (out, 0);
+}
+
+/*
+ * Test functions:
+ *   gui_color_code_scan
+ *   gui_color_has_codes
+ */
+
+TEST(GuiColor, CodeScan)
+{
+    char string[128];
+    int i, j;
+
+    LONGS_EQUAL(0, gui_color_code_scan ("", 0));
+    LONGS_EQUAL(4, gui_color_code_scan ("test", 4));
+    LONGS_EQUAL(2, gui_color_code_scan ("test", 2));
+    LONGS_EQUAL(0, gui_color_code_scan ("\x19" "F01test", 7));
+    LONGS_EQUAL(4, gui_color_code_scan ("test\x1A" "\x01", 6));
+    LONGS_EQUAL(4, gui_color_code_scan ("test\x1B" "\x01", 6));
+    LONGS_EQUAL(4, gui_color_code_scan ("test\x1C", 5));
+    LONGS_EQUAL(4, gui_color_code_scan ("test\x1C", 4));
+
+    /* bytes around the color chars are not color codes */
+    LONGS_EQUAL(6, gui_color_code_scan ("\x18" "\x1D" "\x7F" "\x80" "\xC3" "\xFF", 6));
+
+    /* color code at each position of a long string */
+    for (i = 0; i < 100; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            memset (string, 'a', 100);
+            string[100] = '\0';
+            string[i] = GUI_COLOR_COLOR_CHAR + j;
+            LONGS_EQUAL(i, gui_color_code_scan (string, 100));
+            LONGS_EQUAL((i < 50) ? i : 50, gui_color_code_scan (string, 50));
+        }
+        memset (string, '\xE9', 100);
+        string[100] = '\0';
+        string[i] = GUI_COLOR_RESET_CHAR;
+        LONGS_EQUAL(i, gui_color_code_scan (string, 100));
+    }
+
+    LONGS_EQUAL(0, gui_color_has_codes (NULL));
+    LONGS_EQUAL(0, gui_color_has_codes (""));
+    LONGS_EQUAL(0, gui_color_has_codes ("test string"));
+    LONGS_EQUAL(0, gui_color_has_codes ("test é☃"));
+    LONGS_EQUAL(1, gui_color_has_codes ("test\x1C"));
+    LONGS_EQUAL(1, gui_color_has_codes (gui_color_get_custom ("red")));
+}
+
+/*
+ * Test functions:
+ *   gui_color_decode (compared to reference implementation)
+ */
+
+TEST(GuiColor, DecodeFastPath)
+{
+    const char *strings[] = {
+        "",
+        "test",
+        "\x19",
+        "\x19" "F",
+        "\x19" "F0",
+        "\x19" "F05" "test\x1C",
+        "\x1A",
+        "\x1A" "\x01" "bold" "\x1B" "\x01",
+        "é" "\x19" "F05" "é",
+        "☃" "\x1C" "中" "\x1C" "\U0001F600" "\x1C",
+        /* color codes inside invalid UTF-8 chars are ignored */
+        "\xC3" "\x19" "F05",
+        "ab" "\xE2" "\x19" "F05",
+        "ab" "\xF0" "x" "\x1C" "y" "\x1C",
+        "\xC3" "\xA9" "\x1C" "test",
+        NULL,
+    };
+    char string[64], *decoded, *decoded_ref;
+    int i, j;
+
+    for (i = 0; strings[i]; i++)
+    {
+        decoded = gui_color_decode (strings[i], NULL);
+        decoded_ref = test_gui_color_decode_ref (strings[i], NULL);
+        STRCMP_EQUAL(decoded_ref, decoded);
+        free (decoded);
+        free (decoded_ref);
+        decoded = gui_color_decode (strings[i], "[c]");
+        decoded_ref = test_gui_color_decode_ref (strings[i], "[c]");
+        STRCMP_EQUAL(decoded_ref, decoded);
+        free (decoded);
+        free (decoded_ref);
+    }
+
+    /* random strings with many color chars and UTF-8 chars */
+    srand (42);
+    for (i = 0; i < 10000; i++)
+    {
+        for (j = 0; j < (int)sizeof (string) - 1; j++)
+        {
+            switch (rand () % 4)
+            {
+                case 0:
+                    string[j] = GUI_COLOR_COLOR_CHAR + (rand () % 4);
+                    break;
+                case 1:
+                    string[j] = 0x80 + (rand () % 0x80);
+                    break;
+                default:
+                    string[j] = 0x20 + (rand () % 0x5F);
+                    break;
+            }
+        }
+        string[sizeof (string) - 1] = '\0';
+        decoded = gui_color_decode (string, "*");
+        decoded_ref = test_gui_color_decode_ref (string, "*");
+        STRCMP_EQUAL(decoded_ref, decoded);
+        free (decoded);
+        free (decoded_ref);
+    }
+}
+
+/*
+ * Test functions:
+ *   gui_color_decode_borrow
+ */
+
+TEST(GuiColor, DecodeBorrow)
+{
+    const char *string = "test string", *result;
+    char string_color[256], *decoded;
+
+    decoded = (char *)0x1;
+    POINTERS_EQUAL(NULL, gui_color_decode_borrow (NULL, NULL, &decoded));
+    POINTERS_EQUAL(NULL, decoded);
+    POINTERS_EQUAL(NULL, gui_color_decode_borrow (string, NULL, NULL));
+
+    /* no color codes: string is returned */
+    decoded = (char *)0x1;
+    POINTERS_EQUAL(string, gui_color_decode_borrow (string, NULL, &decoded));
+    POINTERS_EQUAL(NULL, decoded);
+    POINTERS_EQUAL(string, gui_color_decode_borrow (string, "?", &decoded));
+    POINTERS_EQUAL(NULL, decoded);
+
+    /* color codes: decoded string is allocated */
+    snprintf (string_color, sizeof (string_color),
+              "%s" "test" "%s" "string",
+              gui_color_get_custom ("red"),
+              gui_color_get_custom ("reset"));
+    result = gui_color_decode_borrow (string_color, NULL, &decoded);
+    STRCMP_EQUAL("teststring", result);
+    POINTERS_EQUAL(decoded, result);
+    free (decoded);
+    result = gui_color_decode_borrow (string_color, "_", &decoded);
+    STRCMP_EQUAL("_test_string", result);
+    POINTERS_EQUAL(decoded, result);
+    free (decoded);
+}
+
+/*
+ * Test functions:
+ *   gui_color_decode_to_buffer
+ */
+
+TEST(GuiColor, DecodeToBuffer)
+{
+    char string[256], buffer[16];
+
+    LONGS_EQUAL(-1, gui_color_decode_to_buffer (NULL, NULL, buffer, 16));
+    LONGS_EQUAL(-1, gui_color_decode_to_buffer ("test", NULL, NULL, 16));
+    LONGS_EQUAL(-1, gui_color_decode_to_buffer ("test", NULL, buffer, -1));
+
+    LONGS_EQUAL(0, gui_color_decode_to_buffer ("", NULL, buffer, 16));
+    STRCMP_EQUAL("", buffer);
+    LONGS_EQUAL(4, gui_color_decode_to_buffer ("test", NULL, buffer, 16));
+    STRCMP_EQUAL("test", buffer);
+
+    snprintf (string, sizeof (string),
+              "%s" "test" "%s" "string",
+              gui_color_get_custom ("red"),
+              gui_color_get_custom ("reset"));
+    LONGS_EQUAL(10, gui_color_decode_to_buffer (string, NULL, buffer, 16));
+    STRCMP_EQUAL("teststring", buffer);
+    LONGS_EQUAL(14, gui_color_decode_to_buffer (string, "[]", buffer, 16));
+    STRCMP_EQUAL("[]test[]string", buffer);
+
+    /* buffer too small: string is truncated */
+    LONGS_EQUAL(10, gui_color_decode_to_buffer (string, NULL, buffer, 5));
+    STRCMP_EQUAL("test", buffer);
+    LONGS_EQUAL(18, gui_color_decode_to_buffer (string, "[--]", buffer, 16));
+    STRCMP_EQUAL("[--]test[--]str", buffer);
+    LONGS_EQUAL(10, gui_color_decode_to_buffer (string, NULL, buffer, 1));
+    STRCMP_EQUAL("", buffer);
+    buffer[0] = 'x';
+    LONGS_EQUAL(10, gui_color_decode_to_buffer (string, NULL, buffer, 0));
+    BYTES_EQUAL('x', buffer[0]);
+}
+
 /*
  * Test functions:
  *   gui_color_decode_ansi
@@ -68,6 +68,14 @@ extern "C"
     tags_array = string_split_tags (__tags, &tags_count);               \
     LONGS_EQUAL(__result, gui_line_match_tags (&line_data, tags_count,  \
                                                tags_array));            \
+    tags_compiled = gui_line_tags_compile (tags_count, tags_array);     \
+    LONGS_EQUAL(__result,                                               \
+                gui_line_match_tags_compiled (&line_data,               \
+                                              tags_compiled));          \
+    LONGS_EQUAL(__result,                                               \
+                gui_line_match_tags_compiled (&line_data,               \
+                                              tags_compiled));          \
+    gui_line_tags_compiled_free (tags_compiled);                        \
     gui_line_tags_free (&line_data);                                    \
     string_free_split_tags (tags_array);
 
@@ -101,6 +109,7 @@ TEST(GuiLine, LinesAlloc)
     LONGS_EQUAL(0, lines->buffer_max_length_refresh);
     LONGS_EQUAL(0, lines->prefix_max_length);
     LONGS_EQUAL(0, lines->prefix_max_length_refresh);
+    POINTERS_EQUAL(NULL, lines->arena);
 
     gui_line_lines_free (lines);
 
@@ -166,6 +175,202 @@ TEST(GuiLine, TagsAlloc)
     gui_line_tags_free (NULL);
 }
 
+/*
+ * Test functions:
+ *   gui_line_arena_free
+ *   gui_line_arena_chunk_new
+ *   gui_line_arena_chunk_free
+ *   gui_line_record_alloc
+ *   gui_line_record_get
+ *   gui_line_record_free
+ *   gui_line_data_new
+ *   gui_line_data_is_inline
+ *   gui_line_data_free_string
+ *   gui_line_data_tags_free
+ */
+
+TEST(GuiLine, Arena)
+{
+    struct t_gui_buffer *buffer;
+    struct t_gui_line *line1, *line2, *line3;
+    struct t_gui_line_arena *arena;
+    struct t_gui_line_arena_chunk *chunk1;
+    struct t_gui_line_record *record;
+    char big_message[GUI_LINE_ARENA_CHUNK_SIZE_MAX];
+    size_t used;
+    int i;
+
+    buffer = gui_buffer_new_user ("test_arena", GUI_BUFFER_TYPE_FORMATTED);
+    CHECK(buffer);
+    POINTERS_EQUAL(NULL, buffer->own_lines->arena);
+
+    /* data, tags, message and time are in a record of the arena */
+    line1 = gui_line_new (buffer, -1, 1700000000, 0, 1700000000, 0,
+                          "tag1,tag2", "prefix", "message1", -1, NULL);
+    CHECK(line1);
+    arena = buffer->own_lines->arena;
+    CHECK(arena);
+    LONGS_EQUAL(1, arena->num_chunks);
+    LONGS_EQUAL(1, arena->records);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MIN, arena->size);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MIN * 2, arena->chunk_size);
+    chunk1 = arena->chunks;
+    POINTERS_EQUAL(chunk1, arena->current_chunk);
+    record = gui_line_record_get (line1->data);
+    POINTERS_EQUAL(chunk1, record->chunk);
+    LONGS_EQUAL(0, record->size % 8);
+    STRCMP_EQUAL("message1", line1->data->message);
+    LONGS_EQUAL(2, line1->data->tags_count);
+    STRCMP_EQUAL("tag1", line1->data->tags_array[0]);
+    STRCMP_EQUAL("tag2", line1->data->tags_array[1]);
+    POINTERS_EQUAL(NULL, line1->data->tags_array[2]);
+    CHECK(line1->data->str_time);
+    LONGS_EQUAL(1, gui_line_data_is_inline (line1->data, line1->data->message));
+    LONGS_EQUAL(1, gui_line_data_is_inline (line1->data, line1->data->str_time));
+    LONGS_EQUAL(1, gui_line_data_is_inline (line1->data, line1->data->tags_array));
+    LONGS_EQUAL(0, gui_line_data_is_inline (line1->data, line1->data->prefix));
+    LONGS_EQUAL(0, gui_line_data_is_inline (line1->data, line1->data));
+    LONGS_EQUAL(0, gui_line_data_is_inline (line1->data, NULL));
+    LONGS_EQUAL(0, gui_line_data_is_inline (NULL, line1->data->message));
+    gui_line_add (line1, 1);
+
+    /* replace message and tags: new values have their own allocation */
+    gui_line_data_free_string (line1->data, line1->data->message);
+    line1->data->message = strdup ("new message");
+    LONGS_EQUAL(0, gui_line_data_is_inline (line1->data, line1->data->message));
+    gui_line_data_tags_free (line1->data);
+    LONGS_EQUAL(0, line1->data->tags_count);
+    POINTERS_EQUAL(NULL, line1->data->tags_array);
+    gui_line_tags_alloc (line1->data, "tag3");
+    LONGS_EQUAL(0, gui_line_data_is_inline (line1->data, line1->data->tags_array));
+
+    /* the last record allocated in a chunk gives back its space when freed */
+    used = chunk1->used;
+    line2 = gui_line_new (buffer, -1, 0, 0, 0, 0, NULL, NULL, "message2",
+                          -1, NULL);
+    CHECK(line2);
+    CHECK(chunk1->used > used);
+    LONGS_EQUAL(2, arena->records);
+    gui_line_free_data (line2);
+    free (line2);
+    LONGS_EQUAL(used, chunk1->used);
+    LONGS_EQUAL(1, arena->records);
+
+    /* big record: in a dedicated chunk, freed with the record */
+    memset (big_message, 'a', sizeof (big_message) - 1);
+    big_message[sizeof (big_message) - 1] = '\0';
+    line3 = gui_line_new (buffer, -1, 0, 0, 0, 0, NULL, NULL, big_message,
+                          -1, NULL);
+    CHECK(line3);
+    LONGS_EQUAL(2, arena->num_chunks);
+    POINTERS_EQUAL(chunk1, arena->current_chunk);
+    STRCMP_EQUAL(big_message, line3->data->message);
+    gui_line_add (line3, 1);
+    gui_line_free (buffer, line3);
+    LONGS_EQUAL(1, arena->num_chunks);
+    LONGS_EQUAL(1, arena->records);
+
+    /* old lines are released with their chunk */
+    for (i = 0; i < 2000; i++)
+    {
+        gui_line_add (
+            gui_line_new (buffer, -1, 0, 0, 0, 0, "tag", NULL,
+                          "this is a test message", -1, NULL),
+            1);
+    }
+    CHECK(arena->num_chunks > 2);
+    LONGS_EQUAL(2001, arena->records);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MIN * 2, arena->chunks->next_chunk->size);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MAX, arena->chunk_size);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MAX, arena->last_chunk->size);
+    while (buffer->own_lines->first_line
+           && (gui_line_record_get (buffer->own_lines->first_line->data)->chunk == chunk1))
+    {
+        gui_line_free (buffer, buffer->own_lines->first_line);
+    }
+    CHECK(arena->chunks != chunk1);
+    LONGS_EQUAL(buffer->own_lines->lines_count, arena->records);
+
+    /* clear buffer: only the current chunk is kept (empty) */
+    gui_line_free_all (buffer);
+    LONGS_EQUAL(0, arena->records);
+    LONGS_EQUAL(1, arena->num_chunks);
+    POINTERS_EQUAL(arena->chunks, arena->current_chunk);
+    LONGS_EQUAL(GUI_LINE_ARENA_ALIGN(sizeof (struct t_gui_line_arena_chunk)),
+                arena->current_chunk->used);
+    LONGS_EQUAL(GUI_LINE_ARENA_CHUNK_SIZE_MAX, arena->size);
+
+    /* buffer closed while a line is still used: arena freed with the line */
+    line1 = gui_line_new (buffer, -1, 0, 0, 0, 0, NULL, NULL, "orphan",
+                          -1, NULL);
+    CHECK(line1);
+    gui_buffer_close (buffer);
+    LONGS_EQUAL(1, arena->orphan);
+    LONGS_EQUAL(1, arena->records);
+    STRCMP_EQUAL("orphan", line1->data->message);
+    gui_line_free_data (line1);
+    free (line1);
+
+    /* buffer with free content: one allocation per record */
+    buffer = gui_buffer_new_user ("test_arena_free", GUI_BUFFER_TYPE_FREE);
+    CHECK(buffer);
+    line1 = gui_line_new (buffer, 0, 0, 0, 0, 0, "tag1", NULL, "message",
+                          -1, NULL);
+    CHECK(line1);
+    POINTERS_EQUAL(NULL, buffer->own_lines->arena);
+    POINTERS_EQUAL(NULL, gui_line_record_get (line1->data)->chunk);
+    LONGS_EQUAL(1, gui_line_data_is_inline (line1->data, line1->data->message));
+    gui_line_add_y (line1);
+    gui_line_clear (line1);
+    STRCMP_EQUAL("", line1->data->message);
+    LONGS_EQUAL(1, gui_line_data_is_inline (line1->data, line1->data->message));
+    POINTERS_EQUAL(NULL, line1->data->tags_array);
+    gui_buffer_close (buffer);
+}
+
+/*
+ * Test functions:
+ *   gui_line_malloc_size
+ *   gui_line_arena_get_memory
+ */
+
+TEST(GuiLine, ArenaGetMemory)
+{
+    struct t_gui_buffer *buffer;
+    int i, records, chunks, records2, chunks2;
+    unsigned long long size, size_unused, size_unpacked;
+    unsigned long long size2, size_unused2, size_unpacked2;
+
+    LONGS_EQUAL(32, gui_line_malloc_size (0));
+    LONGS_EQUAL(32, gui_line_malloc_size (24));
+    LONGS_EQUAL(48, gui_line_malloc_size (25));
+    LONGS_EQUAL(112, gui_line_malloc_size (100));
+
+    gui_line_arena_get_memory (&records, &chunks, &size, &size_unused,
+                               &size_unpacked);
+
+    buffer = gui_buffer_new_user ("test_arena_memory",
+                                  GUI_BUFFER_TYPE_FORMATTED);
+    CHECK(buffer);
+    for (i = 0; i < 4000; i++)
+    {
+        gui_line_add (
+            gui_line_new (buffer, -1, 1700000000 + i, 0, 1700000000 + i, 0,
+                          "irc_privmsg,notify_message,nick_test,log1",
+                          "test", "this is a test message", -1, NULL),
+            1);
+    }
+
+    gui_line_arena_get_memory (&records2, &chunks2, &size2, &size_unused2,
+                               &size_unpacked2);
+    LONGS_EQUAL(records + 4000, records2);
+    LONGS_EQUAL(chunks + buffer->own_lines->arena->num_chunks, chunks2);
+    CHECK(size2 - size < size_unpacked2 - size_unpacked);
+    CHECK(size_unused2 - size_unused < GUI_LINE_ARENA_CHUNK_SIZE_MAX);
+
+    gui_buffer_close (buffer);
+}
+
 /*
  * Test functions:
  *   gui_line_prefix_is_same_nick
@@ -460,6 +665,7 @@ TEST(GuiLine, HasTagNoFilter)
 TEST(GuiLine, MatchTags)
 {
     struct t_gui_line_data line_data;
+    struct t_gui_line_tags_compiled *tags_compiled;
     char ***tags_array;
     int tags_count;
 
@@ -491,6 +697,82 @@ TEST(GuiLine, MatchTags)
     WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "nick_test,irc_quit");
     WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "!irc_quit,!irc_302,!irc_notice");
     WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "!irc_quit+!irc_302+!irc_notice");
+
+    /* tags with wildcard or different case */
+    WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "irc_*");
+    WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "*_test");
+    WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "IRC_JOIN");
+    WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "irc_quit,NICK_*");
+    WEE_LINE_MATCH_TAGS(1, "irc_join,nick_test", "irc_*+!nick_xxx");
+    WEE_LINE_MATCH_TAGS(0, "irc_join,nick_test", "irc_*+!nick_*");
+    WEE_LINE_MATCH_TAGS(0, "irc_join,nick_test", "!*_join");
+    WEE_LINE_MATCH_TAGS(0, "irc_join,nick_test", "irc_join+host_*");
+}
+
+/*
+ * Test functions:
+ *   gui_line_tags_compile
+ *   gui_line_tag_compiled_match
+ *   gui_line_match_tags_compiled
+ *   gui_line_tags_compiled_free
+ */
+
+TEST(GuiLine, MatchTagsCompiled)
+{
+    struct t_gui_line_data line_data;
+    struct t_gui_line_tags_compiled *tags_compiled;
+    struct t_gui_line_tag_compiled *ptr_tag;
+    struct t_gui_line_tags_cache *ptr_cache;
+    char ***tags_array;
+    int tags_count;
+
+    POINTERS_EQUAL(NULL, gui_line_tags_compile (0, NULL));
+    LONGS_EQUAL(0, gui_line_match_tags_compiled (NULL, NULL));
+    gui_line_tags_compiled_free (NULL);
+
+    tags_array = string_split_tags ("irc_join+!nick_*,*", &tags_count);
+    tags_compiled = gui_line_tags_compile (tags_count, tags_array);
+    CHECK(tags_compiled);
+    LONGS_EQUAL(2, tags_compiled->count);
+    LONGS_EQUAL(2, tags_compiled->tags_count[0]);
+    LONGS_EQUAL(1, tags_compiled->tags_count[1]);
+
+    /* tag without wildcard: same shared string as the tag of lines */
+    ptr_tag = &(tags_compiled->tags[0][0]);
+    LONGS_EQUAL(0, ptr_tag->negated);
+    LONGS_EQUAL(0, ptr_tag->any);
+    STRCMP_EQUAL("irc_join", ptr_tag->tag);
+    CHECK(ptr_tag->mask);
+    gui_line_tags_alloc (&line_data, "irc_join,nick_test");
+    POINTERS_EQUAL(line_data.tags_array[0], ptr_tag->tag);
+
+    /* negated tag with wildcard */
+    ptr_tag = &(tags_compiled->tags[0][1]);
+    LONGS_EQUAL(1, ptr_tag->negated);
+    LONGS_EQUAL(0, ptr_tag->any);
+    STRCMP_EQUAL("nick_*", ptr_tag->tag);
+
+    /* any tag */
+    LONGS_EQUAL(1, tags_compiled->tags[1][0].any);
+    POINTERS_EQUAL(NULL, tags_compiled->tags[1][0].tag);
+
+    /* result of match is kept by id of shared string */
+    LONGS_EQUAL(1, gui_line_tag_compiled_match (ptr_tag,
+                                                line_data.tags_array[1]));
+    ptr_cache = &(ptr_tag->cache[string_shared_get_id (line_data.tags_array[1])
+                                 % GUI_LINE_TAGS_CACHE_SIZE]);
+    POINTERS_EQUAL(line_data.tags_array[1], ptr_cache->tag);
+    LONGS_EQUAL(string_shared_get_id (line_data.tags_array[1]), ptr_cache->id);
+    LONGS_EQUAL(1, ptr_cache->match);
+    LONGS_EQUAL(0, gui_line_tag_compiled_match (ptr_tag,
+                                                line_data.tags_array[0]));
+
+    /* a negated tag found excludes the line, even with "*" in next list */
+    LONGS_EQUAL(0, gui_line_match_tags_compiled (&line_data, tags_compiled));
+
+    gui_line_tags_free (&line_data);
+    gui_line_tags_compiled_free (tags_compiled);
+    string_free_split_tags (tags_array);
 }
 
 /*
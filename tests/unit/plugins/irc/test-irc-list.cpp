@@ -27,6 +27,7 @@
 
 extern "C"
 {
+#include "src/core/core-string.h"
 #include "src/plugins/irc/irc-list.h"
 }
 
@@ -96,12 +97,37 @@ TEST(IrcList, AddChannelInHashtable)
 
 /*
  * Test functions:
- *   irc_list_string_match
+ *   irc_list_compile_mask
  */
 
-TEST(IrcList, StringMatch)
+TEST(IrcList, CompileMask)
 {
-    /* TODO: write tests */
+    struct t_string_mask *mask;
+
+    POINTERS_EQUAL(NULL, irc_list_compile_mask (NULL));
+
+    /* mask without "*": the string must contain the mask */
+    mask = irc_list_compile_mask ("weechat");
+    CHECK(mask);
+    LONGS_EQUAL(1, string_mask_match (mask, "#weechat"));
+    LONGS_EQUAL(1, string_mask_match (mask, "#WeeChat-fr"));
+    LONGS_EQUAL(0, string_mask_match (mask, "#irc"));
+    string_mask_free (mask);
+
+    /* mask with "*" */
+    mask = irc_list_compile_mask ("#weechat*");
+    CHECK(mask);
+    LONGS_EQUAL(1, string_mask_match (mask, "#weechat"));
+    LONGS_EQUAL(1, string_mask_match (mask, "#WeeChat-fr"));
+    LONGS_EQUAL(0, string_mask_match (mask, "##weechat"));
+    string_mask_free (mask);
+
+    /* empty mask: any string is matching */
+    mask = irc_list_compile_mask ("");
+    CHECK(mask);
+    LONGS_EQUAL(1, string_mask_match (mask, ""));
+    LONGS_EQUAL(1, string_mask_match (mask, "#weechat"));
+    string_mask_free (mask);
 }
 
 /*
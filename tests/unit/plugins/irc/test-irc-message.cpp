@@ -926,6 +926,11 @@ TEST(IrcMessage, ConvertCharset)
     free (str);
 
     unhook (hook);
+
+    /* modifier not hooked */
+    STRCMP_EQUAL(NULL,
+                 irc_message_convert_charset ("PRIVMSG #channel :this is a test",
+                                              18, "convert_irc_charset", NULL));
 }
 
 /*
@@ -35,6 +35,7 @@ extern "C"
 #include "src/core/weechat.h"
 #include "src/core/core-config.h"
 #include "src/core/core-config-file.h"
+#include "src/core/core-debug.h"
 #include "src/core/core-hashtable.h"
 #include "src/core/core-hook.h"
 #include "src/core/core-infolist.h"
@@ -632,6 +633,85 @@ TEST(PluginApiInfo, Uptime)
     CHECK(seconds >= 0);
 }
 
+/*
+ * Test functions:
+ *   plugin_api_info_weechat_loop_cb
+ */
+
+TEST(PluginApiInfo, WeechatLoopCb)
+{
+    char *str;
+    int i;
+
+    debug_loop_reset ();
+
+    STRCMP_EQUAL(NULL, hook_info_get (NULL, "weechat_loop", "invalid"));
+    STRCMP_EQUAL(NULL, hook_info_get (NULL, "weechat_loop", "timer"));
+
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "enabled"));
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "iterations"));
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "timer_count"));
+
+    str = hook_info_get (NULL, "weechat_loop", NULL);
+    STRNCMP_EQUAL("enabled=0,stall=0,iterations=0,stalls=0,timer_count=0,",
+                  str, 54);
+    CHECK(strstr (str, ",timer_lateness_max=0"));
+    free (str);
+
+    /* measure 3 iterations of main loop */
+    debug_loop_enabled = 1;
+    for (i = 0; i < 3; i++)
+    {
+        debug_loop_start ();
+        debug_loop_mark (DEBUG_LOOP_PHASE_TIMER);
+        debug_loop_mark (DEBUG_LOOP_PHASE_REFRESH);
+        debug_loop_mark (DEBUG_LOOP_PHASE_FD);
+        debug_loop_mark (DEBUG_LOOP_PHASE_WAIT);
+        debug_loop_mark (DEBUG_LOOP_PHASE_FD);
+        debug_loop_mark (DEBUG_LOOP_PHASE_PROCESS);
+        debug_loop_mark (DEBUG_LOOP_PHASE_SIGNAL);
+        debug_loop_end ();
+    }
+    debug_loop_add_timer_lateness (2500);
+    debug_loop_enabled = 0;
+
+    /* ignored: iteration not started */
+    debug_loop_mark (DEBUG_LOOP_PHASE_TIMER);
+    debug_loop_end ();
+
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "iterations"));
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "stalls"));
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "timer_count"));
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "fd_count"));
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "wait_count"));
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "iteration_count"));
+    WEE_TEST_STR("1", hook_info_get (NULL, "weechat_loop",
+                                     "timer_lateness_count"));
+    WEE_TEST_STR("2500", hook_info_get (NULL, "weechat_loop",
+                                        "timer_lateness_total"));
+    WEE_TEST_STR("2500", hook_info_get (NULL, "weechat_loop",
+                                        "timer_lateness_avg"));
+    WEE_TEST_STR("2500", hook_info_get (NULL, "weechat_loop",
+                                        "timer_lateness_max"));
+    LONGS_EQUAL(3, debug_loop_stats[DEBUG_LOOP_PHASE_SIGNAL].count);
+    LONGS_EQUAL(1, debug_loop_stats[DEBUG_LOOP_STAT_TIMER_LATENESS].histogram[2]);
+
+    /* stall detection: any iteration is a stall with threshold of 1us */
+    debug_loop_stall = 1;
+    debug_loop_start ();
+    usleep (10);
+    debug_loop_mark (DEBUG_LOOP_PHASE_TIMER);
+    debug_loop_end ();
+    debug_loop_stall = 0;
+    WEE_TEST_STR("3", hook_info_get (NULL, "weechat_loop", "iterations"));
+    WEE_TEST_STR("1", hook_info_get (NULL, "weechat_loop", "stalls"));
+
+    debug_loop_reset ();
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "iterations"));
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "stalls"));
+    WEE_TEST_STR("0", hook_info_get (NULL, "weechat_loop", "timer_count"));
+}
+
 /*
  * Test functions:
  *   plugin_api_info_totp_generate_cb
@@ -1015,6 +1015,15 @@ def test_hdata():
     check(weechat.hdata_compare(hdata_buffer, buffer, buffer2, "name", 0) > 0)
     check(weechat.hdata_compare(hdata_buffer, buffer2, buffer, "name", 0) < 0)
     check(weechat.hdata_compare(hdata_buffer, buffer, buffer, "name", 0) == 0)
+    # hdata_path_compile / hdata_path_get_value / hdata_path_free
+    path = weechat.hdata_path_compile(hdata_buffer, "own_lines.first_line.data.prefix")
+    check(path != "")
+    check(weechat.hdata_path_get_value(path, buffer2) == "prefix1")
+    weechat.hdata_path_free(path)
+    path = weechat.hdata_path_compile(hdata_buffer, "local_variables.name")
+    check(weechat.hdata_path_get_value(path, buffer2) == "test")
+    weechat.hdata_path_free(path)
+    check(weechat.hdata_path_compile(hdata_buffer, "invalid") == "")
     # hdata_update
     check(weechat.hdata_time(hdata_line_data, line1_data, "date") == 2146383600)
     check(weechat.hdata_string(hdata_line_data, line1_data, "prefix") == "prefix1")
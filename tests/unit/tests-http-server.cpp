@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Sébastien Helleu <flashcode@flashtux.org>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of WeeChat, the extensible chat client.
+ *
+ * WeeChat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * WeeChat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with WeeChat.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Minimal HTTP server used in tests and benchmarks */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "tests-http-server.h"
+
+#define HTTP_SERVER_MAX_CLIENTS 64
+
+int http_server_sock = -1;
+int http_server_port = 0;
+int http_server_stop = 0;
+int http_server_connections = 0;
+pthread_t http_server_thread;
+
+
+/*
+ * Minimal HTTP/1.1 server (in a thread), with keep-alive: each request on
+ * path "/slow" is never answered, other requests receive "hello".
+ */
+
+void *
+http_server_run (void *arg)
+{
+    struct pollfd fds[HTTP_SERVER_MAX_CLIENTS + 1];
+    char buffer[4096], *requests[HTTP_SERVER_MAX_CLIENTS + 1];
+    const char *response, *ptr_end;
+    int i, num_fds, sock, num_read, num_written;
+
+    /* make C++ compiler happy */
+    (void) arg;
+
+    response = "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello";
+
+    memset (requests, 0, sizeof (requests));
+    fds[0].fd = http_server_sock;
+    fds[0].events = POLLIN;
+    num_fds = 1;
+
+    while (!http_server_stop)
+    {
+        if (poll (fds, num_fds, 50) <= 0)
+            continue;
+        if ((fds[0].revents & POLLIN) && (num_fds <= HTTP_SERVER_MAX_CLIENTS))
+        {
+            sock = accept (http_server_sock, NULL, NULL);
+            if (sock >= 0)
+            {
+                http_server_connections++;
+                fds[num_fds].fd = sock;
+                fds[num_fds].events = POLLIN;
+                fds[num_fds].revents = 0;
+                requests[num_fds] = strdup ("");
+                num_fds++;
+            }
+        }
+        for (i = 1; i < num_fds; i++)
+        {
+            if (!fds[i].revents)
+                continue;
+            num_read = read (fds[i].fd, buffer, sizeof (buffer) - 1);
+            if (num_read <= 0)
+            {
+                /* connection closed by client */
+                close (fds[i].fd);
+                free (requests[i]);
+                fds[i] = fds[num_fds - 1];
+                requests[i] = requests[num_fds - 1];
+                num_fds--;
+                i--;
+                continue;
+            }
+            buffer[num_read] = '\0';
+            requests[i] = (char *)realloc (
+                requests[i], strlen (requests[i]) + num_read + 1);
+            strcat (requests[i], buffer);
+            /* answer all complete requests received */
+            while ((ptr_end = strstr (requests[i], "\r\n\r\n")))
+            {
+                if (strncmp (requests[i], "GET /slow ", 10) != 0)
+                {
+                    num_written = write (fds[i].fd, response,
+                                         strlen (response));
+                    (void) num_written;
+                }
+                memmove (requests[i], ptr_end + 4, strlen (ptr_end + 4) + 1);
+            }
+        }
+    }
+
+    for (i = 1; i < num_fds; i++)
+    {
+        close (fds[i].fd);
+        free (requests[i]);
+    }
+
+    return NULL;
+}
+
+/*
+ * Start the HTTP server.
+ *
+ * Return:
+ *   1: OK
+ *   0: error
+ */
+
+int
+http_server_start ()
+{
+    struct sockaddr_in addr;
+    socklen_t length;
+
+    http_server_sock = socket (AF_INET, SOCK_STREAM, 0);
+    if (http_server_sock < 0)
+        return 0;
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    length = sizeof (addr);
+    if ((bind (http_server_sock, (struct sockaddr *)&addr,
+               sizeof (addr)) < 0)
+        || (listen (http_server_sock, 64) < 0)
+        || (getsockname (http_server_sock, (struct sockaddr *)&addr,
+                         &length) < 0))
+    {
+        close (http_server_sock);
+        http_server_sock = -1;
+        return 0;
+    }
+    http_server_port = ntohs (addr.sin_port);
+    http_server_stop = 0;
+    http_server_connections = 0;
+
+    if (pthread_create (&http_server_thread, NULL,
+                        &http_server_run, NULL) != 0)
+    {
+        close (http_server_sock);
+        http_server_sock = -1;
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Stop the HTTP server.
+ */
+
+void
+http_server_end ()
+{
+    http_server_stop = 1;
+    pthread_join (http_server_thread, NULL);
+    close (http_server_sock);
+    http_server_sock = -1;
+}